@@ -3,6 +3,8 @@
 
 #pragma once
 
+#include "nx_tzdb_file.h"
+
 #include "nx_tzdb/africa.h"
 #include "nx_tzdb/america.h"
 #include "nx_tzdb/america_argentina.h"
@@ -0,0 +1,16 @@
+#pragma once
+
+#include <cstdint>
+
+namespace NxTzdb {
+
+// A file of a generated directory table. Its bytes start at offset in the directory's data array
+// and are zstd compressed, unless compressed_size is equal to size.
+struct File {
+    const char* name;
+    uint32_t offset;
+    uint32_t compressed_size;
+    uint32_t size;
+};
+
+} // namespace NxTzdb
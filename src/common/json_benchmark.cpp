@@ -0,0 +1,134 @@
+#include "json_benchmark.h"
+#include "json.h"
+#include "json_stream.h"
+#include <chrono>
+
+namespace
+{
+constexpr std::chrono::milliseconds MeasureTime(200);
+
+const char * SampleDocument = R"({
+   "Core" : {
+      "ShowConsole" : true,
+      "modules" : {
+         "cpu" : "cpu\\nxemu-cpu.dll",
+         "loader" : "loader\\nxemu-loader.dll",
+         "operating_system" : "operating_system\\nxemu-os.dll",
+         "video" : "video\\nxemu-video.dll"
+      }
+   },
+   "nxemu-os" : {
+      "audio" : {
+         "mode" : "Stereo",
+         "volume" : 100
+      }
+   },
+   "nxemu-video" : {
+      "renderer" : {
+         "backend" : "Vulkan",
+         "resolution_setup" : "Res1X",
+         "speed_limit" : 100,
+         "use_async_shaders" : true
+      }
+   }
+}
+)";
+
+class CountingHandler :
+    public JsonSaxHandler
+{
+public:
+    bool Null() override { return Count(); }
+    bool Bool(bool) override { return Count(); }
+    bool Number(std::string_view, JsonValueType) override { return Count(); }
+    bool String(std::string_view, bool) override { return Count(); }
+    bool StartObject() override { return Count(); }
+    bool Key(std::string_view, bool) override { return true; }
+    bool EndObject(uint32_t) override { return true; }
+    bool StartArray() override { return Count(); }
+    bool EndArray(uint32_t) override { return true; }
+
+    uint64_t values = 0;
+
+private:
+    bool Count()
+    {
+        values += 1;
+        return true;
+    }
+};
+
+template <typename Function>
+double Measure(size_t bytes, Function && function)
+{
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    std::chrono::steady_clock::duration elapsed;
+    uint64_t processed = 0;
+    do
+    {
+        function();
+        processed += bytes;
+        elapsed = std::chrono::steady_clock::now() - start;
+    } while (elapsed < MeasureTime);
+    return (double)processed / std::chrono::duration<double>(elapsed).count() / (1024.0 * 1024.0);
+}
+} // namespace
+
+std::vector<JsonBenchmarkResult> RunJsonBenchmark(const std::string & document, size_t targetSize)
+{
+    JsonDocument source;
+    if (!source.Parse(std::string_view(document)))
+    {
+        source.Parse(std::string_view(SampleDocument));
+    }
+
+    std::string large;
+    JsonStreamWriter scaled(large);
+    scaled.StartObject();
+    scaled.Key("copies");
+    scaled.StartArray();
+    do
+    {
+        scaled.Value(source.Root());
+    } while (large.size() < targetSize);
+    scaled.EndArray();
+    scaled.EndObject();
+    scaled.Finish();
+
+    const char * begin = large.data();
+    const char * end = large.data() + large.size();
+    std::vector<JsonBenchmarkResult> results;
+
+    results.push_back({"parse JsonReader", Measure(large.size(), [&]() {
+                           JsonValue root;
+                           JsonReader().Parse(begin, end, root);
+                       })});
+    JsonDocument parsed;
+    results.push_back({"parse JsonDocument", Measure(large.size(), [&]() {
+                           parsed.Parse(begin, end);
+                       })});
+    JsonStreamReader reader;
+    CountingHandler handler;
+    results.push_back({"parse JsonStreamReader", Measure(large.size(), [&]() {
+                           reader.Parse(begin, end, handler);
+                       })});
+
+    JsonValue value = parsed.Root().ToJsonValue();
+    results.push_back({"write JsonStyledWriter", Measure(large.size(), [&]() {
+                           JsonStyledWriter().write(value);
+                       })});
+    std::string out;
+    results.push_back({"write JsonStreamWriter", Measure(large.size(), [&]() {
+                           out.clear();
+                           JsonStreamWriter writer(out);
+                           writer.Value(value);
+                           writer.Finish();
+                       })});
+    results.push_back({"write JsonStreamWriter from JsonDocument", Measure(large.size(), [&]() {
+                           out.clear();
+                           JsonStreamWriter writer(out);
+                           writer.Value(parsed.Root());
+                           writer.Finish();
+                       })});
+    return results;
+}
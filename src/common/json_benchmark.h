@@ -0,0 +1,15 @@
+#pragma once
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+struct JsonBenchmarkResult
+{
+    std::string name;
+    double megabytesPerSecond;
+};
+
+// Scales the document up to at least targetSize bytes by repeating it inside an array, then
+// measures each parser and writer over the result. A built in sample is used when the document
+// does not parse.
+std::vector<JsonBenchmarkResult> RunJsonBenchmark(const std::string & document, size_t targetSize = 0x800000);
@@ -0,0 +1,1252 @@
+#include "json_stream.h"
+#include <algorithm>
+#include <assert.h>
+#include <charconv>
+#include <cmath>
+#include <string.h>
+
+namespace
+{
+bool IsDigit(char c)
+{
+    return c >= '0' && c <= '9';
+}
+
+void AppendUtf8(std::string & out, uint32_t codepoint)
+{
+    if (codepoint < 0x80)
+    {
+        out += (char)codepoint;
+    }
+    else if (codepoint < 0x800)
+    {
+        out += (char)(0xC0 | (codepoint >> 6));
+        out += (char)(0x80 | (codepoint & 0x3F));
+    }
+    else if (codepoint < 0x10000)
+    {
+        out += (char)(0xE0 | (codepoint >> 12));
+        out += (char)(0x80 | ((codepoint >> 6) & 0x3F));
+        out += (char)(0x80 | (codepoint & 0x3F));
+    }
+    else
+    {
+        out += (char)(0xF0 | (codepoint >> 18));
+        out += (char)(0x80 | ((codepoint >> 12) & 0x3F));
+        out += (char)(0x80 | ((codepoint >> 6) & 0x3F));
+        out += (char)(0x80 | (codepoint & 0x3F));
+    }
+}
+
+bool DecodeHex4(const char * text, const char * end, uint32_t & value)
+{
+    if (end - text < 4)
+    {
+        return false;
+    }
+    value = 0;
+    for (int i = 0; i < 4; i++)
+    {
+        char c = text[i];
+        value <<= 4;
+        if (c >= '0' && c <= '9')
+        {
+            value |= c - '0';
+        }
+        else if (c >= 'a' && c <= 'f')
+        {
+            value |= c - 'a' + 10;
+        }
+        else if (c >= 'A' && c <= 'F')
+        {
+            value |= c - 'A' + 10;
+        }
+        else
+        {
+            return false;
+        }
+    }
+    return true;
+}
+} // namespace
+
+bool JsonStreamReader::Parse(const char * begin, const char * end, JsonSaxHandler & handler)
+{
+    m_begin = begin;
+    m_end = end;
+    m_current = begin;
+    m_errorMessage = nullptr;
+    m_errorOffset = 0;
+    m_containerIsArray.clear();
+    m_containerCount.clear();
+
+    std::string_view text;
+    bool escaped = false;
+    bool expectValue = true;
+    for (;;)
+    {
+        if (!SkipSpaces())
+        {
+            return false;
+        }
+        if (expectValue)
+        {
+            if (m_current == m_end)
+            {
+                return Fail("Expected a value", m_current);
+            }
+            const char * valueStart = m_current;
+            bool ok = true;
+            switch (*m_current)
+            {
+            case '{':
+            case '[':
+            {
+                const bool isArray = *m_current == '[';
+                m_current += 1;
+                if (!(isArray ? handler.StartArray() : handler.StartObject()))
+                {
+                    return Fail("Stopped by handler", valueStart);
+                }
+                if (!SkipSpaces())
+                {
+                    return false;
+                }
+                if (m_current != m_end && *m_current == (isArray ? ']' : '}'))
+                {
+                    m_current += 1;
+                    ok = isArray ? handler.EndArray(0) : handler.EndObject(0);
+                    break;
+                }
+                m_containerIsArray.push_back(isArray);
+                m_containerCount.push_back(0);
+                if (!isArray)
+                {
+                    if (m_current == m_end || *m_current != '"')
+                    {
+                        return Fail("Missing '}' or object member name", m_current);
+                    }
+                    if (!ReadString(text, escaped) || !SkipSpaces())
+                    {
+                        return false;
+                    }
+                    if (m_current == m_end || *m_current != ':')
+                    {
+                        return Fail("Missing ':' after object member name", m_current);
+                    }
+                    m_current += 1;
+                    if (!handler.Key(text, escaped))
+                    {
+                        return Fail("Stopped by handler", valueStart);
+                    }
+                }
+                continue;
+            }
+            case '"':
+                if (!ReadString(text, escaped))
+                {
+                    return false;
+                }
+                ok = handler.String(text, escaped);
+                break;
+            case 't':
+                if (!Match("true", 4))
+                {
+                    return Fail("Syntax error: value, object or array expected", valueStart);
+                }
+                ok = handler.Bool(true);
+                break;
+            case 'f':
+                if (!Match("false", 5))
+                {
+                    return Fail("Syntax error: value, object or array expected", valueStart);
+                }
+                ok = handler.Bool(false);
+                break;
+            case 'n':
+                if (!Match("null", 4))
+                {
+                    return Fail("Syntax error: value, object or array expected", valueStart);
+                }
+                ok = handler.Null();
+                break;
+            default:
+            {
+                JsonValueType type;
+                if (!ReadNumber(text, type))
+                {
+                    return false;
+                }
+                ok = handler.Number(text, type);
+                break;
+            }
+            }
+            if (!ok)
+            {
+                return Fail("Stopped by handler", valueStart);
+            }
+            expectValue = false;
+            continue;
+        }
+
+        if (m_containerIsArray.empty())
+        {
+            if (m_current != m_end)
+            {
+                return Fail("Extra non-whitespace after JSON value", m_current);
+            }
+            return true;
+        }
+        if (m_current == m_end)
+        {
+            return Fail(m_containerIsArray.back() ? "Missing ']'" : "Missing '}'", m_current);
+        }
+
+        const bool isArray = m_containerIsArray.back();
+        m_containerCount.back() += 1;
+        const char * separator = m_current;
+        const char c = *m_current++;
+        if (c == ',')
+        {
+            if (!isArray)
+            {
+                if (!SkipSpaces())
+                {
+                    return false;
+                }
+                if (m_current == m_end || *m_current != '"')
+                {
+                    return Fail("Missing object member name", m_current);
+                }
+                if (!ReadString(text, escaped) || !SkipSpaces())
+                {
+                    return false;
+                }
+                if (m_current == m_end || *m_current != ':')
+                {
+                    return Fail("Missing ':' after object member name", m_current);
+                }
+                m_current += 1;
+                if (!handler.Key(text, escaped))
+                {
+                    return Fail("Stopped by handler", separator);
+                }
+            }
+            expectValue = true;
+            continue;
+        }
+        if (c != (isArray ? ']' : '}'))
+        {
+            return Fail(isArray ? "Missing ',' or ']' in array declaration" : "Missing ',' or '}' in object declaration", separator);
+        }
+        const uint32_t count = m_containerCount.back();
+        m_containerIsArray.pop_back();
+        m_containerCount.pop_back();
+        if (!(isArray ? handler.EndArray(count) : handler.EndObject(count)))
+        {
+            return Fail("Stopped by handler", separator);
+        }
+    }
+}
+
+const char * JsonStreamReader::ErrorMessage() const
+{
+    return m_errorMessage != nullptr ? m_errorMessage : "";
+}
+
+size_t JsonStreamReader::ErrorOffset() const
+{
+    return m_errorOffset;
+}
+
+bool JsonStreamReader::Fail(const char * message, const char * at)
+{
+    m_errorMessage = message;
+    m_errorOffset = (size_t)(at - m_begin);
+    return false;
+}
+
+bool JsonStreamReader::SkipSpaces()
+{
+    while (m_current != m_end)
+    {
+        const char c = *m_current;
+        if (c == ' ' || c == '\t' || c == '\r' || c == '\n')
+        {
+            m_current += 1;
+            continue;
+        }
+        if (c != '/')
+        {
+            break;
+        }
+
+        const char * commentStart = m_current;
+        if (m_end - m_current >= 2 && m_current[1] == '/')
+        {
+            while (m_current != m_end && *m_current != '\n')
+            {
+                m_current += 1;
+            }
+        }
+        else if (m_end - m_current >= 2 && m_current[1] == '*')
+        {
+            const char * close = nullptr;
+            for (const char * search = m_current + 2; search + 1 < m_end; search++)
+            {
+                if (search[0] == '*' && search[1] == '/')
+                {
+                    close = search;
+                    break;
+                }
+            }
+            if (close == nullptr)
+            {
+                return Fail("Unterminated comment", commentStart);
+            }
+            m_current = close + 2;
+        }
+        else
+        {
+            return Fail("Syntax error: value, object or array expected", commentStart);
+        }
+    }
+    return true;
+}
+
+bool JsonStreamReader::ReadString(std::string_view & raw, bool & escaped)
+{
+    const char * start = m_current;
+    m_current += 1;
+    const char * contentStart = m_current;
+    escaped = false;
+    while (m_current != m_end)
+    {
+        const char c = *m_current;
+        if (c == '"')
+        {
+            raw = std::string_view(contentStart, (size_t)(m_current - contentStart));
+            m_current += 1;
+            return true;
+        }
+        if (c == '\\')
+        {
+            escaped = true;
+            m_current += 1;
+            if (m_current == m_end)
+            {
+                break;
+            }
+        }
+        m_current += 1;
+    }
+    return Fail("Missing '\"' at the end of a string", start);
+}
+
+bool JsonStreamReader::ReadNumber(std::string_view & text, JsonValueType & type)
+{
+    const char * start = m_current;
+    type = JsonValueType::Int;
+    if (m_current != m_end && *m_current == '-')
+    {
+        m_current += 1;
+    }
+    const char * digits = m_current;
+    while (m_current != m_end && IsDigit(*m_current))
+    {
+        m_current += 1;
+    }
+    if (m_current == digits)
+    {
+        return Fail("Syntax error: value, object or array expected", start);
+    }
+    if (m_current != m_end && *m_current == '.')
+    {
+        type = JsonValueType::Real;
+        m_current += 1;
+        digits = m_current;
+        while (m_current != m_end && IsDigit(*m_current))
+        {
+            m_current += 1;
+        }
+        if (m_current == digits)
+        {
+            return Fail("Missing digits after the decimal point", start);
+        }
+    }
+    if (m_current != m_end && (*m_current == 'e' || *m_current == 'E'))
+    {
+        type = JsonValueType::Real;
+        m_current += 1;
+        if (m_current != m_end && (*m_current == '+' || *m_current == '-'))
+        {
+            m_current += 1;
+        }
+        digits = m_current;
+        while (m_current != m_end && IsDigit(*m_current))
+        {
+            m_current += 1;
+        }
+        if (m_current == digits)
+        {
+            return Fail("Missing digits in the exponent", start);
+        }
+    }
+    text = std::string_view(start, (size_t)(m_current - start));
+    return true;
+}
+
+bool JsonStreamReader::Match(const char * literal, size_t length)
+{
+    if ((size_t)(m_end - m_current) < length || memcmp(m_current, literal, length) != 0)
+    {
+        return false;
+    }
+    m_current += length;
+    return true;
+}
+
+void JsonUnescape(std::string_view raw, std::string & out)
+{
+    const char * current = raw.data();
+    const char * end = raw.data() + raw.size();
+    while (current != end)
+    {
+        const char * run = current;
+        while (current != end && *current != '\\')
+        {
+            current++;
+        }
+        out.append(run, current);
+        if (current == end)
+        {
+            break;
+        }
+        current++;
+        if (current == end)
+        {
+            break;
+        }
+        const char escape = *current++;
+        switch (escape)
+        {
+        case '"': out += '"'; break;
+        case '/': out += '/'; break;
+        case '\\': out += '\\'; break;
+        case 'b': out += '\b'; break;
+        case 'f': out += '\f'; break;
+        case 'n': out += '\n'; break;
+        case 'r': out += '\r'; break;
+        case 't': out += '\t'; break;
+        case 'u':
+        {
+            uint32_t codepoint;
+            if (!DecodeHex4(current, end, codepoint))
+            {
+                break;
+            }
+            current += 4;
+            uint32_t low;
+            if (codepoint >= 0xD800 && codepoint <= 0xDBFF && end - current >= 6 && current[0] == '\\' && current[1] == 'u' &&
+                DecodeHex4(current + 2, end, low) && low >= 0xDC00 && low <= 0xDFFF)
+            {
+                codepoint = 0x10000 + ((codepoint & 0x3FF) << 10) + (low & 0x3FF);
+                current += 6;
+            }
+            AppendUtf8(out, codepoint);
+            break;
+        }
+        default:
+            out += escape;
+            break;
+        }
+    }
+}
+
+JsonArena::JsonArena(size_t blockSize) :
+    m_blockSize(blockSize),
+    m_blockUsed(0),
+    m_currentBlock(0)
+{
+}
+
+void * JsonArena::Allocate(size_t size, size_t alignment)
+{
+    // Blocks come from new[], so their base is aligned for every node type
+    for (;;)
+    {
+        if (m_currentBlock < m_blocks.size())
+        {
+            Block & block = m_blocks[m_currentBlock];
+            size_t offset = (m_blockUsed + alignment - 1) & ~(alignment - 1);
+            if (offset + size <= block.size)
+            {
+                m_blockUsed = offset + size;
+                return block.data.get() + offset;
+            }
+            m_currentBlock += 1;
+            m_blockUsed = 0;
+            continue;
+        }
+        size_t blockSize = size > m_blockSize ? size : m_blockSize;
+        m_blocks.push_back({std::make_unique<uint8_t[]>(blockSize), blockSize});
+    }
+}
+
+void JsonArena::Reset()
+{
+    m_currentBlock = 0;
+    m_blockUsed = 0;
+}
+
+JsonNode::JsonNode() :
+    m_type(JsonValueType::Null),
+    m_count(0)
+{
+    m_value.UInt = 0;
+}
+
+JsonValueType JsonNode::Type() const
+{
+    return m_type;
+}
+
+bool JsonNode::isNull() const
+{
+    return m_type == JsonValueType::Null;
+}
+
+bool JsonNode::isBool() const
+{
+    return m_type == JsonValueType::Boolean;
+}
+
+bool JsonNode::isDouble() const
+{
+    return m_type == JsonValueType::Int || m_type == JsonValueType::UnsignedInt || m_type == JsonValueType::Real;
+}
+
+bool JsonNode::isInt() const
+{
+    switch (m_type)
+    {
+    case JsonValueType::Int:
+        return m_value.Int >= JsonValue::MinInt && m_value.Int <= JsonValue::MaxInt;
+    case JsonValueType::UnsignedInt:
+        return m_value.UInt <= (uint64_t)JsonValue::MaxInt;
+    case JsonValueType::Real:
+        return m_value.Real >= JsonValue::MinInt && m_value.Real <= JsonValue::MaxInt && std::trunc(m_value.Real) == m_value.Real;
+    default:
+        break;
+    }
+    return false;
+}
+
+bool JsonNode::isString() const
+{
+    return m_type == JsonValueType::String;
+}
+
+bool JsonNode::isArray() const
+{
+    return m_type == JsonValueType::Array;
+}
+
+bool JsonNode::isObject() const
+{
+    return m_type == JsonValueType::Object;
+}
+
+bool JsonNode::asBool() const
+{
+    switch (m_type)
+    {
+    case JsonValueType::Boolean: return m_value.Bool;
+    case JsonValueType::Int: return m_value.Int != 0;
+    case JsonValueType::UnsignedInt: return m_value.UInt != 0;
+    case JsonValueType::Real: return m_value.Real != 0.0 && !std::isnan(m_value.Real);
+    default: return false;
+    }
+}
+
+int64_t JsonNode::asInt64() const
+{
+    switch (m_type)
+    {
+    case JsonValueType::Int: return m_value.Int;
+    case JsonValueType::UnsignedInt: return (int64_t)m_value.UInt;
+    case JsonValueType::Real: return (int64_t)m_value.Real;
+    case JsonValueType::Boolean: return m_value.Bool ? 1 : 0;
+    default: return 0;
+    }
+}
+
+uint64_t JsonNode::asUInt64() const
+{
+    switch (m_type)
+    {
+    case JsonValueType::Int: return (uint64_t)m_value.Int;
+    case JsonValueType::UnsignedInt: return m_value.UInt;
+    case JsonValueType::Real: return (uint64_t)m_value.Real;
+    case JsonValueType::Boolean: return m_value.Bool ? 1 : 0;
+    default: return 0;
+    }
+}
+
+double JsonNode::asDouble() const
+{
+    switch (m_type)
+    {
+    case JsonValueType::Int: return (double)m_value.Int;
+    case JsonValueType::UnsignedInt: return (double)m_value.UInt;
+    case JsonValueType::Real: return m_value.Real;
+    case JsonValueType::Boolean: return m_value.Bool ? 1.0 : 0.0;
+    default: return 0.0;
+    }
+}
+
+std::string_view JsonNode::asStringView() const
+{
+    return m_type == JsonValueType::String ? m_text : std::string_view();
+}
+
+std::string JsonNode::asString() const
+{
+    return std::string(asStringView());
+}
+
+std::string_view JsonNode::NumberText() const
+{
+    return isDouble() ? m_text : std::string_view();
+}
+
+uint32_t JsonNode::size() const
+{
+    return m_type == JsonValueType::Array || m_type == JsonValueType::Object ? m_count : 0;
+}
+
+bool JsonNode::empty() const
+{
+    return size() == 0;
+}
+
+std::string_view JsonNode::Key() const
+{
+    return m_key;
+}
+
+const JsonNode * JsonNode::begin() const
+{
+    return size() != 0 ? m_value.Children : nullptr;
+}
+
+const JsonNode * JsonNode::end() const
+{
+    return size() != 0 ? m_value.Children + m_count : nullptr;
+}
+
+const JsonNode * JsonNode::Find(std::string_view key) const
+{
+    if (m_type != JsonValueType::Object)
+    {
+        return nullptr;
+    }
+    for (const JsonNode & child : *this)
+    {
+        if (child.m_key == key)
+        {
+            return &child;
+        }
+    }
+    return nullptr;
+}
+
+const JsonNode & JsonNode::operator[](std::string_view key) const
+{
+    const JsonNode * node = Find(key);
+    return node != nullptr ? *node : NullSingleton();
+}
+
+const JsonNode & JsonNode::operator[](const char * key) const
+{
+    return (*this)[std::string_view(key)];
+}
+
+const JsonNode & JsonNode::operator[](uint32_t index) const
+{
+    return index < size() ? m_value.Children[index] : NullSingleton();
+}
+
+JsonValue JsonNode::ToJsonValue() const
+{
+    switch (m_type)
+    {
+    case JsonValueType::Boolean: return JsonValue(m_value.Bool);
+    case JsonValueType::Int: return JsonValue(m_value.Int);
+    case JsonValueType::UnsignedInt: return JsonValue(m_value.UInt);
+    case JsonValueType::Real: return JsonValue(m_value.Real);
+    case JsonValueType::String: return JsonValue(m_text.data(), m_text.data() + m_text.size());
+    case JsonValueType::Array:
+    {
+        JsonValue value(JsonValueType::Array);
+        for (const JsonNode & child : *this)
+        {
+            value.Append(child.ToJsonValue());
+        }
+        return value;
+    }
+    case JsonValueType::Object:
+    {
+        JsonValue value(JsonValueType::Object);
+        for (const JsonNode & child : *this)
+        {
+            value.ResolveReference(child.m_key.data(), child.m_key.data() + child.m_key.size()) = child.ToJsonValue();
+        }
+        return value;
+    }
+    default:
+        return JsonValue();
+    }
+}
+
+const JsonNode & JsonNode::NullSingleton()
+{
+    static const JsonNode nullNode;
+    return nullNode;
+}
+
+class JsonDocument::Builder :
+    public JsonSaxHandler
+{
+public:
+    Builder(JsonArena & arena, JsonNode & root) :
+        m_arena(arena),
+        m_root(root)
+    {
+    }
+
+    bool Null() override
+    {
+        Push(JsonValueType::Null);
+        return true;
+    }
+
+    bool Bool(bool value) override
+    {
+        Push(JsonValueType::Boolean).m_value.Bool = value;
+        return true;
+    }
+
+    bool Number(std::string_view text, JsonValueType type) override
+    {
+        JsonNode & node = Push(type);
+        node.m_text = text;
+        const char * first = text.data();
+        const char * last = text.data() + text.size();
+        if (type == JsonValueType::Int)
+        {
+            if (std::from_chars(first, last, node.m_value.Int).ec == std::errc())
+            {
+                return true;
+            }
+            if (text[0] != '-' && std::from_chars(first, last, node.m_value.UInt).ec == std::errc())
+            {
+                node.m_type = JsonValueType::UnsignedInt;
+                return true;
+            }
+            node.m_type = JsonValueType::Real;
+        }
+        if (std::from_chars(first, last, node.m_value.Real).ec != std::errc())
+        {
+            node.m_value.Real = text[0] == '-' ? -HUGE_VAL : HUGE_VAL;
+        }
+        return true;
+    }
+
+    bool String(std::string_view raw, bool escaped) override
+    {
+        Push(JsonValueType::String).m_text = escaped ? Unescape(raw) : raw;
+        return true;
+    }
+
+    bool StartObject() override
+    {
+        Push(JsonValueType::Object);
+        m_starts.push_back(m_pending.size());
+        return true;
+    }
+
+    bool Key(std::string_view raw, bool escaped) override
+    {
+        m_key = escaped ? Unescape(raw) : raw;
+        return true;
+    }
+
+    bool EndObject(uint32_t memberCount) override
+    {
+        return End(memberCount);
+    }
+
+    bool StartArray() override
+    {
+        Push(JsonValueType::Array);
+        m_starts.push_back(m_pending.size());
+        return true;
+    }
+
+    bool EndArray(uint32_t elementCount) override
+    {
+        return End(elementCount);
+    }
+
+private:
+    JsonNode & Push(JsonValueType type)
+    {
+        JsonNode & node = m_starts.empty() ? m_root : m_pending.emplace_back();
+        node = JsonNode();
+        node.m_type = type;
+        node.m_key = m_key;
+        m_key = std::string_view();
+        return node;
+    }
+
+    bool End(uint32_t count)
+    {
+        const size_t start = m_starts.back();
+        m_starts.pop_back();
+        assert(m_pending.size() - start == count);
+
+        JsonNode * children = nullptr;
+        if (count != 0)
+        {
+            children = (JsonNode *)m_arena.Allocate(sizeof(JsonNode) * count, alignof(JsonNode));
+            std::uninitialized_copy(m_pending.begin() + start, m_pending.end(), children);
+        }
+        m_pending.resize(start);
+
+        JsonNode & container = m_starts.empty() ? m_root : m_pending.back();
+        container.m_count = count;
+        container.m_value.Children = children;
+        return true;
+    }
+
+    std::string_view Unescape(std::string_view raw)
+    {
+        m_scratch.clear();
+        JsonUnescape(raw, m_scratch);
+        char * text = (char *)m_arena.Allocate(m_scratch.size(), 1);
+        memcpy(text, m_scratch.data(), m_scratch.size());
+        return std::string_view(text, m_scratch.size());
+    }
+
+    JsonArena & m_arena;
+    JsonNode & m_root;
+    std::vector<JsonNode> m_pending;
+    std::vector<size_t> m_starts;
+    std::string_view m_key;
+    std::string m_scratch;
+};
+
+JsonDocument::JsonDocument()
+{
+}
+
+bool JsonDocument::Parse(const char * begin, const char * end)
+{
+    m_arena.Reset();
+    m_root = JsonNode();
+    Builder builder(m_arena, m_root);
+    if (!m_reader.Parse(begin, end, builder))
+    {
+        m_root = JsonNode();
+        return false;
+    }
+    return true;
+}
+
+bool JsonDocument::Parse(std::string_view text)
+{
+    m_text.assign(text.data(), text.size());
+    return Parse(m_text.data(), m_text.data() + m_text.size());
+}
+
+const JsonNode & JsonDocument::Root() const
+{
+    return m_root;
+}
+
+const char * JsonDocument::ErrorMessage() const
+{
+    return m_reader.ErrorMessage();
+}
+
+size_t JsonDocument::ErrorOffset() const
+{
+    return m_reader.ErrorOffset();
+}
+
+JsonStreamWriter::JsonStreamWriter(std::string & out, bool styled) :
+    m_out(out),
+    m_styled(styled),
+    m_afterKey(false)
+{
+}
+
+void JsonStreamWriter::StartObject()
+{
+    BeforeValue();
+    m_out += '{';
+    m_levels.push_back({false, true, true, 0, 0});
+}
+
+void JsonStreamWriter::EndObject()
+{
+    assert(!m_levels.empty() && !m_levels.back().isArray);
+    const bool empty = m_levels.back().empty;
+    m_levels.pop_back();
+    if (!empty)
+    {
+        NewLine();
+    }
+    m_out += '}';
+}
+
+void JsonStreamWriter::StartArray()
+{
+    BeforeValue();
+    m_out += '[';
+    m_levels.push_back({true, true, false, m_out.size(), m_elementStarts.size()});
+}
+
+void JsonStreamWriter::EndArray()
+{
+    // JsonStyledWriter's right margin, it measures the line as "[ " + ", " * (n - 1) + " ]"
+    static constexpr size_t rightMargin = 74;
+
+    assert(!m_levels.empty() && m_levels.back().isArray);
+    if (m_styled && !m_levels.back().empty && !m_levels.back().multiline)
+    {
+        const Level & level = m_levels.back();
+        size_t count = m_elementStarts.size() - level.firstElement;
+        size_t lineLength = m_out.size() - level.start + 3;
+        if (count * 3 >= rightMargin || lineLength >= rightMargin)
+        {
+            BreakArray(m_levels.size() - 1);
+        }
+    }
+    const Level level = m_levels.back();
+    m_elementStarts.resize(level.firstElement);
+    m_levels.pop_back();
+    if (level.empty)
+    {
+        m_out += ']';
+    }
+    else if (level.multiline)
+    {
+        NewLine();
+        m_out += ']';
+    }
+    else
+    {
+        m_out += m_styled ? " ]" : "]";
+    }
+}
+
+void JsonStreamWriter::Key(std::string_view key)
+{
+    assert(!m_levels.empty() && !m_levels.back().isArray && !m_afterKey);
+    Level & level = m_levels.back();
+    if (level.empty)
+    {
+        ContainerNotEmpty();
+    }
+    else
+    {
+        m_out += ',';
+    }
+    level.empty = false;
+    NewLine();
+    WriteQuoted(key);
+    m_out += m_styled ? " : " : ":";
+    m_afterKey = true;
+}
+
+void JsonStreamWriter::Null()
+{
+    BeforeValue();
+    m_out += "null";
+}
+
+void JsonStreamWriter::Bool(bool value)
+{
+    BeforeValue();
+    m_out += value ? "true" : "false";
+}
+
+void JsonStreamWriter::Int(int64_t value)
+{
+    BeforeValue();
+    char buffer[24];
+    std::to_chars_result result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+    m_out.append(buffer, result.ptr);
+}
+
+void JsonStreamWriter::UInt(uint64_t value)
+{
+    BeforeValue();
+    char buffer[24];
+    std::to_chars_result result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+    m_out.append(buffer, result.ptr);
+}
+
+void JsonStreamWriter::Double(double value)
+{
+    BeforeValue();
+    if (!std::isfinite(value))
+    {
+        m_out += std::isnan(value) ? "null" : value < 0 ? "-1e+9999" : "1e+9999";
+        return;
+    }
+    char buffer[32];
+    std::to_chars_result result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+    std::string_view text(buffer, (size_t)(result.ptr - buffer));
+    m_out += text;
+    // Keep the value a real when it is read back, as JsonStyledWriter does
+    if (text.find_first_of(".e") == std::string_view::npos)
+    {
+        m_out += ".0";
+    }
+}
+
+void JsonStreamWriter::String(std::string_view value)
+{
+    BeforeValue();
+    WriteQuoted(value);
+}
+
+void JsonStreamWriter::Value(const JsonNode & node)
+{
+    switch (node.Type())
+    {
+    case JsonValueType::Null: Null(); break;
+    case JsonValueType::Boolean: Bool(node.asBool()); break;
+    case JsonValueType::Int: Int(node.asInt64()); break;
+    case JsonValueType::UnsignedInt: UInt(node.asUInt64()); break;
+    case JsonValueType::Real: Double(node.asDouble()); break;
+    case JsonValueType::String: String(node.asStringView()); break;
+    case JsonValueType::Array:
+        StartArray();
+        for (const JsonNode & child : node)
+        {
+            Value(child);
+        }
+        EndArray();
+        break;
+    case JsonValueType::Object:
+        StartObject();
+        for (const JsonNode & child : node)
+        {
+            Key(child.Key());
+            Value(child);
+        }
+        EndObject();
+        break;
+    }
+}
+
+void JsonStreamWriter::Value(const JsonValue & value)
+{
+    switch (value.Type())
+    {
+    case JsonValueType::Null: Null(); break;
+    case JsonValueType::Boolean: Bool(value.asBool()); break;
+    case JsonValueType::Int: Int(value.asInt64()); break;
+    case JsonValueType::UnsignedInt: UInt(value.asUInt64()); break;
+    case JsonValueType::Real: Double(value.asDouble()); break;
+    case JsonValueType::String:
+    {
+        const char * begin = nullptr;
+        const char * end = nullptr;
+        value.GetString(&begin, &end);
+        String(std::string_view(begin, (size_t)(end - begin)));
+        break;
+    }
+    case JsonValueType::Array:
+        StartArray();
+        for (uint32_t i = 0, n = value.size(); i < n; i++)
+        {
+            Value(value[i]);
+        }
+        EndArray();
+        break;
+    case JsonValueType::Object:
+        StartObject();
+        for (const std::string & name : value.GetMemberNames())
+        {
+            Key(name);
+            Value(value[name]);
+        }
+        EndObject();
+        break;
+    }
+}
+
+void JsonStreamWriter::Finish()
+{
+    if (m_styled)
+    {
+        m_out += '\n';
+    }
+}
+
+void JsonStreamWriter::BeforeValue()
+{
+    if (m_afterKey)
+    {
+        m_afterKey = false;
+        return;
+    }
+    if (m_levels.empty())
+    {
+        return;
+    }
+    Level & level = m_levels.back();
+    assert(level.isArray);
+    if (level.empty)
+    {
+        ContainerNotEmpty();
+    }
+    else
+    {
+        m_out += ',';
+    }
+    if (level.multiline)
+    {
+        NewLine();
+    }
+    else if (m_styled)
+    {
+        m_out += ' ';
+        m_elementStarts.push_back(m_out.size());
+    }
+    level.empty = false;
+}
+
+void JsonStreamWriter::ContainerNotEmpty()
+{
+    // A non empty container puts every element of the array holding it on its own line. Only its
+    // opening bracket has been written so far, which is moved along with the array's other elements.
+    if (!m_styled || m_levels.size() < 2)
+    {
+        return;
+    }
+    const size_t parent = m_levels.size() - 2;
+    if (!m_levels[parent].isArray || m_levels[parent].multiline)
+    {
+        return;
+    }
+    BreakArray(parent);
+    Level & level = m_levels.back();
+    level.start = m_out.size();
+    level.firstElement = m_elementStarts.size();
+}
+
+void JsonStreamWriter::BreakArray(size_t index)
+{
+    Level & level = m_levels[index];
+    const size_t first = level.firstElement;
+    const size_t count = m_elementStarts.size() - first;
+    std::string elements(m_out, level.start);
+    m_out.resize(level.start);
+    for (size_t i = 0; i < count; i++)
+    {
+        size_t begin = m_elementStarts[first + i] - level.start;
+        // Elements are separated by ", " while the array is on a single line
+        size_t end = i + 1 < count ? m_elementStarts[first + i + 1] - level.start - 2 : elements.size();
+        if (i != 0)
+        {
+            m_out += ',';
+        }
+        m_out += '\n';
+        m_out.append((index + 1) * 3, ' ');
+        m_out.append(elements, begin, end - begin);
+    }
+    m_elementStarts.resize(first);
+    level.multiline = true;
+}
+
+void JsonStreamWriter::NewLine()
+{
+    if (m_styled)
+    {
+        m_out += '\n';
+        m_out.append(m_levels.size() * 3, ' ');
+    }
+}
+
+void JsonStreamWriter::WriteQuoted(std::string_view value)
+{
+    static const char hex[] = "0123456789abcdef";
+
+    m_out += '"';
+    const char * current = value.data();
+    const char * end = value.data() + value.size();
+    while (current != end)
+    {
+        const char * run = current;
+        while (current != end && (uint8_t)*current >= 0x20 && *current != '"' && *current != '\\')
+        {
+            current++;
+        }
+        m_out.append(run, current);
+        if (current == end)
+        {
+            break;
+        }
+        const char c = *current++;
+        switch (c)
+        {
+        case '"': m_out += "\\\""; break;
+        case '\\': m_out += "\\\\"; break;
+        case '\b': m_out += "\\b"; break;
+        case '\f': m_out += "\\f"; break;
+        case '\n': m_out += "\\n"; break;
+        case '\r': m_out += "\\r"; break;
+        case '\t': m_out += "\\t"; break;
+        default:
+            m_out += "\\u00";
+            m_out += hex[(uint8_t)c >> 4];
+            m_out += hex[(uint8_t)c & 0xF];
+            break;
+        }
+    }
+    m_out += '"';
+}
+
+void JsonMergePatch(JsonValue & target, const JsonNode & patch)
+{
+    if (!patch.isObject())
+    {
+        target = patch.ToJsonValue();
+        return;
+    }
+    if (!target.isObject())
+    {
+        target = JsonValue(JsonValueType::Object);
+    }
+    for (const JsonNode & member : patch)
+    {
+        std::string key(member.Key());
+        if (member.isNull())
+        {
+            target.removeMember(key.c_str());
+            continue;
+        }
+        JsonValue & child = target.ResolveReference(key.data(), key.data() + key.size());
+        JsonMergePatch(child, member);
+        if (child.isObject() && child.empty())
+        {
+            target.removeMember(key.c_str());
+        }
+    }
+}
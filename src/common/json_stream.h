@@ -0,0 +1,270 @@
+#pragma once
+#include "json.h"
+#include <map>
+#include <memory>
+#include <stdint.h>
+#include <string.h>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Receives the events of JsonStreamReader. Strings and keys are passed as the raw text between
+// the quotes, escaped is set when it still contains escape sequences (see JsonUnescape). Return
+// false from any event to stop parsing.
+class JsonSaxHandler
+{
+public:
+    virtual ~JsonSaxHandler() = default;
+
+    virtual bool Null() = 0;
+    virtual bool Bool(bool value) = 0;
+    virtual bool Number(std::string_view text, JsonValueType type) = 0;
+    virtual bool String(std::string_view raw, bool escaped) = 0;
+    virtual bool StartObject() = 0;
+    virtual bool Key(std::string_view raw, bool escaped) = 0;
+    virtual bool EndObject(uint32_t memberCount) = 0;
+    virtual bool StartArray() = 0;
+    virtual bool EndArray(uint32_t elementCount) = 0;
+};
+
+// Single pass, non recursive parser that does not allocate per value. Accepts the same input as
+// JsonReader, including // and /* */ comments.
+class JsonStreamReader
+{
+public:
+    bool Parse(const char * begin, const char * end, JsonSaxHandler & handler);
+
+    const char * ErrorMessage() const;
+    size_t ErrorOffset() const;
+
+private:
+    bool Fail(const char * message, const char * at);
+    bool SkipSpaces();
+    bool ReadString(std::string_view & raw, bool & escaped);
+    bool ReadNumber(std::string_view & text, JsonValueType & type);
+    bool Match(const char * literal, size_t length);
+
+    const char * m_begin = nullptr;
+    const char * m_end = nullptr;
+    const char * m_current = nullptr;
+    const char * m_errorMessage = nullptr;
+    size_t m_errorOffset = 0;
+    // One entry per open container, true for arrays, with the number of values seen so far
+    std::vector<bool> m_containerIsArray;
+    std::vector<uint32_t> m_containerCount;
+};
+
+// Decodes the escape sequences of a raw JSON string, appending UTF-8 to out.
+void JsonUnescape(std::string_view raw, std::string & out);
+
+// Bump allocator for parsed nodes, everything is released at once with Reset or on destruction.
+class JsonArena
+{
+public:
+    explicit JsonArena(size_t blockSize = 0x10000);
+    JsonArena(const JsonArena &) = delete;
+    JsonArena & operator=(const JsonArena &) = delete;
+
+    void * Allocate(size_t size, size_t alignment);
+    void Reset();
+
+private:
+    struct Block
+    {
+        std::unique_ptr<uint8_t[]> data;
+        size_t size;
+    };
+
+    // Blocks are kept across Reset and filled again in order
+    std::vector<Block> m_blocks;
+    size_t m_blockSize;
+    size_t m_blockUsed;
+    size_t m_currentBlock;
+};
+
+// Read only value of a JsonDocument. Strings are views into the parsed text, or into the arena
+// when they had to be unescaped, and live as long as the document.
+class JsonNode
+{
+    friend class JsonDocument;
+
+public:
+    JsonNode();
+
+    JsonValueType Type() const;
+    bool isNull() const;
+    bool isBool() const;
+    bool isDouble() const;
+    bool isInt() const;
+    bool isString() const;
+    bool isArray() const;
+    bool isObject() const;
+
+    bool asBool() const;
+    int64_t asInt64() const;
+    uint64_t asUInt64() const;
+    double asDouble() const;
+    std::string_view asStringView() const;
+    std::string asString() const;
+    // Source text of a number, written back unchanged by JsonStreamWriter
+    std::string_view NumberText() const;
+
+    uint32_t size() const;
+    bool empty() const;
+    std::string_view Key() const;
+    const JsonNode * begin() const;
+    const JsonNode * end() const;
+
+    const JsonNode * Find(std::string_view key) const;
+    const JsonNode & operator[](std::string_view key) const;
+    const JsonNode & operator[](const char * key) const;
+    const JsonNode & operator[](uint32_t index) const;
+
+    JsonValue ToJsonValue() const;
+
+private:
+    static const JsonNode & NullSingleton();
+
+    JsonValueType m_type;
+    uint32_t m_count;
+    std::string_view m_key;
+    std::string_view m_text;
+    union
+    {
+        bool Bool;
+        int64_t Int;
+        uint64_t UInt;
+        double Real;
+        const JsonNode * Children;
+    } m_value;
+};
+
+// Parses a whole document into arena allocated nodes, each container's children are stored
+// contiguously so indexing is direct and lookups scan a single block of memory.
+class JsonDocument
+{
+public:
+    JsonDocument();
+
+    // The text must outlive the document
+    bool Parse(const char * begin, const char * end);
+    // Takes a copy of the text
+    bool Parse(std::string_view text);
+
+    const JsonNode & Root() const;
+    const char * ErrorMessage() const;
+    size_t ErrorOffset() const;
+
+private:
+    class Builder;
+
+    JsonArena m_arena;
+    std::string m_text;
+    JsonNode m_root;
+    JsonStreamReader m_reader;
+};
+
+// Writes JSON straight into a string as values are produced. The styled layout matches
+// JsonStyledWriter: objects one member per line with a three space indent, arrays on a single line
+// unless they hold a non empty container or would reach the right margin, in which case every
+// element goes on its own line.
+class JsonStreamWriter
+{
+public:
+    explicit JsonStreamWriter(std::string & out, bool styled = true);
+
+    void StartObject();
+    void EndObject();
+    void StartArray();
+    void EndArray();
+    void Key(std::string_view key);
+
+    void Null();
+    void Bool(bool value);
+    void Int(int64_t value);
+    void UInt(uint64_t value);
+    void Double(double value);
+    void String(std::string_view value);
+    void Value(const JsonNode & node);
+    void Value(const JsonValue & value);
+
+    // Adds the trailing new line JsonStyledWriter ends its documents with
+    void Finish();
+
+private:
+    struct Level
+    {
+        bool isArray;
+        bool empty;
+        bool multiline;
+        // Arrays only: offset just past the '[' and the first of their entries in m_elementStarts
+        size_t start;
+        size_t firstElement;
+    };
+
+    void BeforeValue();
+    void ContainerNotEmpty();
+    void BreakArray(size_t index);
+    void NewLine();
+    void WriteQuoted(std::string_view value);
+
+    std::string & m_out;
+    std::vector<Level> m_levels;
+    // Offset of each element written so far in arrays that are still on a single line
+    std::vector<size_t> m_elementStarts;
+    bool m_styled;
+    bool m_afterKey;
+};
+
+// Applies patch to target as a JSON merge patch (RFC 7386): object members are merged
+// recursively, null removes a member and any other value replaces it. Objects left empty by the
+// patch are removed as well.
+void JsonMergePatch(JsonValue & target, const JsonNode & patch);
+
+// Builds the merge patch a module saves its settings with. Every json_section / json_key in
+// settings is written, taking its value from sections when it has one and null otherwise, so keys
+// set back to their default are removed while keys owned by other modules are left alone.
+template <typename Setting, size_t Count>
+std::string JsonSettingsPatch(const Setting (&settings)[Count], const std::map<std::string, JsonValue> & sections)
+{
+    std::string patch;
+    JsonStreamWriter writer(patch);
+    writer.StartObject();
+    for (size_t i = 0; i < Count; i++)
+    {
+        const char * json_section = settings[i].json_section;
+        bool written = false;
+        for (size_t j = 0; j < i && !written; j++)
+        {
+            written = strcmp(settings[j].json_section, json_section) == 0;
+        }
+        if (written)
+        {
+            continue;
+        }
+        writer.Key(json_section);
+        writer.StartObject();
+        std::map<std::string, JsonValue>::const_iterator section = sections.find(json_section);
+        for (size_t j = i; j < Count; j++)
+        {
+            if (strcmp(settings[j].json_section, json_section) != 0)
+            {
+                continue;
+            }
+            writer.Key(settings[j].json_key);
+            const JsonValue * value = section != sections.end() && section->second.isObject() ? section->second.Find(settings[j].json_key) : nullptr;
+            if (value != nullptr)
+            {
+                writer.Value(*value);
+            }
+            else
+            {
+                writer.Null();
+            }
+        }
+        writer.EndObject();
+    }
+    writer.EndObject();
+    writer.Finish();
+    return patch;
+}
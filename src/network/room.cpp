@@ -3,6 +3,7 @@
 
 #include <algorithm>
 #include <atomic>
+#include <cstring>
 #include <iomanip>
 #include <mutex>
 #include <random>
@@ -10,10 +11,12 @@
 #include <shared_mutex>
 #include <sstream>
 #include <thread>
+#include <unordered_map>
 #include "yuzu_common/logging/log.h"
 #include "enet/enet.h"
 #include "network/packet.h"
 #include "network/room.h"
+#include "network/room_event_loop.h"
 #include "network/verify_user.h"
 
 namespace Network {
@@ -44,6 +47,25 @@ public:
     MemberList members;                     ///< Information about the members of this room
     mutable std::shared_mutex member_mutex; ///< Mutex for locking the members list
 
+    /// Peer of each member keyed by its fake ip, used to route unicast packets. Guarded by
+    /// member_mutex.
+    std::unordered_map<u32, ENetPeer*> fake_ip_index;
+
+    /// Set when packets were queued for sending since the last flush of the server host.
+    bool flush_pending = false;
+
+    /// Maximum number of already received events handled before the outgoing queue is flushed.
+    static constexpr std::size_t MaxEventsPerFlush = 64;
+
+    /// Shared event loop servicing this room, or nullptr when the room runs its own thread.
+    RoomEventLoop* event_loop = nullptr;
+
+    std::atomic<u64> bytes_received{};   ///< Total bytes received by the host
+    std::atomic<u64> bytes_sent{};       ///< Total bytes sent by the host
+    std::atomic<u64> packets_received{}; ///< Total datagrams received by the host
+    std::atomic<u64> packets_sent{};     ///< Total datagrams sent by the host
+    std::atomic<u64> packets_dropped{};  ///< Relayed packets that could not be delivered
+
     UsernameBanList username_ban_list; ///< List of banned usernames
     IPBanList ip_ban_list;             ///< List of banned IP addresses
     mutable std::mutex ban_list_mutex; ///< Mutex for the ban lists
@@ -60,6 +82,25 @@ public:
     void ServerLoop();
     void StartLoop();
 
+    /**
+     * Waits up to timeout_ms for an event, then handles it and the events that already arrived
+     * with it and flushes the replies.
+     * @return true if the event limit was reached and more events may already be pending.
+     */
+    bool ProcessEvents(u32 timeout_ms);
+
+    /// Moves the host's 32 bit traffic counters into the room's 64 bit totals.
+    void AccumulateHostCounters();
+
+    /// Dispatches a single event received from the server host.
+    void HandleEvent(ENetEvent& event);
+
+    /// Key used for fake_ip_index.
+    static u32 FakeIPKey(const IPv4Address& address);
+
+    /// Removes a member from the member list and the fake ip index. member_mutex must be held.
+    void RemoveMember(MemberList::iterator member);
+
     /**
      * Parses and answers a room join request from a client.
      * Validates the uniqueness of the username and assigns the MAC address
@@ -217,6 +258,17 @@ public:
      */
     void HandleLdnPacket(const ENetEvent* event);
 
+    /**
+     * Forwards a proxy or LDN packet to its destination without copying it. The destination ip and
+     * broadcast flag are read in place from the packet and the received ENetPacket is queued to
+     * the destination peers directly; ServerLoop frees it once no peer references it.
+     * @param event The ENet event containing the data
+     * @param remote_ip_offset Offset of the destination fake ip in the packet
+     * @param broadcast_offset Offset of the broadcast flag in the packet
+     */
+    void RelayPacket(const ENetEvent* event, std::size_t remote_ip_offset,
+                     std::size_t broadcast_offset);
+
     /**
      * Extracts a chat entry from a received ENet packet and adds it to the chat queue.
      * @param event The ENet event that was received.
@@ -239,50 +291,7 @@ public:
 // RoomImpl
 void Room::RoomImpl::ServerLoop() {
     while (state != State::Closed) {
-        ENetEvent event;
-        if (enet_host_service(server, &event, 5) > 0) {
-            switch (event.type) {
-            case ENET_EVENT_TYPE_RECEIVE:
-                switch (event.packet->data[0]) {
-                case IdJoinRequest:
-                    HandleJoinRequest(&event);
-                    break;
-                case IdSetGameInfo:
-                    HandleGameInfoPacket(&event);
-                    break;
-                case IdProxyPacket:
-                    HandleProxyPacket(&event);
-                    break;
-                case IdLdnPacket:
-                    HandleLdnPacket(&event);
-                    break;
-                case IdChatMessage:
-                    HandleChatPacket(&event);
-                    break;
-                // Moderation
-                case IdModKick:
-                    HandleModKickPacket(&event);
-                    break;
-                case IdModBan:
-                    HandleModBanPacket(&event);
-                    break;
-                case IdModUnban:
-                    HandleModUnbanPacket(&event);
-                    break;
-                case IdModGetBanList:
-                    HandleModGetBanListPacket(&event);
-                    break;
-                }
-                enet_packet_destroy(event.packet);
-                break;
-            case ENET_EVENT_TYPE_DISCONNECT:
-                HandleClientDisconnection(event.peer);
-                break;
-            case ENET_EVENT_TYPE_NONE:
-            case ENET_EVENT_TYPE_CONNECT:
-                break;
-            }
-        }
+        ProcessEvents(5);
     }
     // Close the connection to all members:
     SendCloseMessage();
@@ -292,6 +301,96 @@ void Room::RoomImpl::StartLoop() {
     room_thread = std::make_unique<std::thread>(&Room::RoomImpl::ServerLoop, this);
 }
 
+bool Room::RoomImpl::ProcessEvents(u32 timeout_ms) {
+    ENetEvent event;
+    std::size_t handled_events = 0;
+    if (enet_host_service(server, &event, timeout_ms) > 0) {
+        // Handle whatever else has already arrived before flushing, so a burst of relayed
+        // packets goes out in one flush instead of one per packet.
+        do {
+            HandleEvent(event);
+        } while (++handled_events < MaxEventsPerFlush &&
+                 enet_host_check_events(server, &event) > 0);
+
+        if (flush_pending) {
+            flush_pending = false;
+            enet_host_flush(server);
+        }
+    }
+    AccumulateHostCounters();
+    return handled_events == MaxEventsPerFlush;
+}
+
+void Room::RoomImpl::AccumulateHostCounters() {
+    bytes_received.fetch_add(server->totalReceivedData, std::memory_order_relaxed);
+    bytes_sent.fetch_add(server->totalSentData, std::memory_order_relaxed);
+    packets_received.fetch_add(server->totalReceivedPackets, std::memory_order_relaxed);
+    packets_sent.fetch_add(server->totalSentPackets, std::memory_order_relaxed);
+    server->totalReceivedData = 0;
+    server->totalSentData = 0;
+    server->totalReceivedPackets = 0;
+    server->totalSentPackets = 0;
+}
+
+void Room::RoomImpl::HandleEvent(ENetEvent& event) {
+    switch (event.type) {
+    case ENET_EVENT_TYPE_RECEIVE:
+        switch (event.packet->data[0]) {
+        case IdJoinRequest:
+            HandleJoinRequest(&event);
+            break;
+        case IdSetGameInfo:
+            HandleGameInfoPacket(&event);
+            break;
+        case IdProxyPacket:
+            HandleProxyPacket(&event);
+            break;
+        case IdLdnPacket:
+            HandleLdnPacket(&event);
+            break;
+        case IdChatMessage:
+            HandleChatPacket(&event);
+            break;
+        // Moderation
+        case IdModKick:
+            HandleModKickPacket(&event);
+            break;
+        case IdModBan:
+            HandleModBanPacket(&event);
+            break;
+        case IdModUnban:
+            HandleModUnbanPacket(&event);
+            break;
+        case IdModGetBanList:
+            HandleModGetBanListPacket(&event);
+            break;
+        }
+        // Relayed packets are still referenced by the peers they were queued to, ENet frees them
+        // once they have been sent.
+        if (event.packet->referenceCount == 0) {
+            enet_packet_destroy(event.packet);
+        }
+        break;
+    case ENET_EVENT_TYPE_DISCONNECT:
+        HandleClientDisconnection(event.peer);
+        break;
+    case ENET_EVENT_TYPE_NONE:
+    case ENET_EVENT_TYPE_CONNECT:
+        break;
+    }
+}
+
+u32 Room::RoomImpl::FakeIPKey(const IPv4Address& address) {
+    u32 key;
+    std::memcpy(&key, address.data(), sizeof(key));
+    return key;
+}
+
+void Room::RoomImpl::RemoveMember(MemberList::iterator member) {
+    fake_ip_index.erase(FakeIPKey(member->fake_ip));
+    members.erase(member);
+}
+
 void Room::RoomImpl::HandleJoinRequest(const ENetEvent* event) {
     {
         std::lock_guard lock(member_mutex);
@@ -386,6 +485,7 @@ void Room::RoomImpl::HandleJoinRequest(const ENetEvent* event) {
 
     {
         std::lock_guard lock(member_mutex);
+        fake_ip_index[FakeIPKey(member.fake_ip)] = member.peer;
         members.push_back(std::move(member));
     }
 
@@ -432,7 +532,7 @@ void Room::RoomImpl::HandleModKickPacket(const ENetEvent* event) {
         ip = ip_raw.data();
 
         enet_peer_disconnect(target_member->peer, 0);
-        members.erase(target_member);
+        RemoveMember(target_member);
     }
 
     // Announce the change to all clients.
@@ -475,7 +575,7 @@ void Room::RoomImpl::HandleModBanPacket(const ENetEvent* event) {
         ip = ip_raw.data();
 
         enet_peer_disconnect(target_member->peer, 0);
-        members.erase(target_member);
+        RemoveMember(target_member);
     }
 
     {
@@ -561,9 +661,8 @@ bool Room::RoomImpl::IsValidNickname(const std::string& nickname) const {
 
 bool Room::RoomImpl::IsValidFakeIPAddress(const IPv4Address& address) const {
     // An IP address is valid if it is not already taken by anybody else in the room.
-    std::lock_guard lock(member_mutex);
-    return std::all_of(members.begin(), members.end(),
-                       [&address](const auto& member) { return member.fake_ip != address; });
+    std::shared_lock lock(member_mutex);
+    return !fake_ip_index.contains(FakeIPKey(address));
 }
 
 bool Room::RoomImpl::HasModPermission(const ENetPeer* client) const {
@@ -813,115 +912,60 @@ IPv4Address Room::RoomImpl::GenerateFakeIPAddress() {
 }
 
 void Room::RoomImpl::HandleProxyPacket(const ENetEvent* event) {
-    Packet in_packet;
-    in_packet.Append(event->packet->data, event->packet->dataLength);
-    in_packet.IgnoreBytes(sizeof(u8)); // Message type
-
-    in_packet.IgnoreBytes(sizeof(u8));          // Domain
-    in_packet.IgnoreBytes(sizeof(IPv4Address)); // IP
-    in_packet.IgnoreBytes(sizeof(u16));         // Port
-
-    in_packet.IgnoreBytes(sizeof(u8)); // Domain
-    IPv4Address remote_ip;
-    in_packet.Read(remote_ip);          // IP
-    in_packet.IgnoreBytes(sizeof(u16)); // Port
-
-    in_packet.IgnoreBytes(sizeof(u8)); // Protocol
-
-    bool broadcast;
-    in_packet.Read(broadcast); // Broadcast
-
-    Packet out_packet;
-    out_packet.Append(event->packet->data, event->packet->dataLength);
-    ENetPacket* enet_packet = enet_packet_create(out_packet.GetData(), out_packet.GetDataSize(),
-                                                 ENET_PACKET_FLAG_RELIABLE);
-
-    const auto& destination_address = remote_ip;
-    if (broadcast) { // Send the data to everyone except the sender
-        std::lock_guard lock(member_mutex);
-        bool sent_packet = false;
-        for (const auto& member : members) {
-            if (member.peer != event->peer) {
-                sent_packet = true;
-                enet_peer_send(member.peer, 0, enet_packet);
-            }
-        }
-
-        if (!sent_packet) {
-            enet_packet_destroy(enet_packet);
-        }
-    } else { // Send the data only to the destination client
-        std::lock_guard lock(member_mutex);
-        auto member = std::find_if(members.begin(), members.end(),
-                                   [destination_address](const Member& member_entry) -> bool {
-                                       return member_entry.fake_ip == destination_address;
-                                   });
-        if (member != members.end()) {
-            enet_peer_send(member->peer, 0, enet_packet);
-        } else {
-            LOG_ERROR(Network,
-                      "Attempting to send to unknown IP address: "
-                      "{}.{}.{}.{}",
-                      destination_address[0], destination_address[1], destination_address[2],
-                      destination_address[3]);
-            enet_packet_destroy(enet_packet);
-        }
-    }
-    enet_host_flush(server);
+    // Message type, then the source domain, ip and port, then the destination domain.
+    constexpr std::size_t RemoteIPOffset =
+        sizeof(u8) + sizeof(u8) + sizeof(IPv4Address) + sizeof(u16) + sizeof(u8);
+    // Destination ip and port, then the protocol.
+    constexpr std::size_t BroadcastOffset =
+        RemoteIPOffset + sizeof(IPv4Address) + sizeof(u16) + sizeof(u8);
+    RelayPacket(event, RemoteIPOffset, BroadcastOffset);
 }
 
 void Room::RoomImpl::HandleLdnPacket(const ENetEvent* event) {
-    Packet in_packet;
-    in_packet.Append(event->packet->data, event->packet->dataLength);
-
-    in_packet.IgnoreBytes(sizeof(u8)); // Message type
-
-    in_packet.IgnoreBytes(sizeof(u8));          // LAN packet type
-    in_packet.IgnoreBytes(sizeof(IPv4Address)); // Local IP
+    // Message type, then the LAN packet type and the local ip.
+    constexpr std::size_t RemoteIPOffset = sizeof(u8) + sizeof(u8) + sizeof(IPv4Address);
+    constexpr std::size_t BroadcastOffset = RemoteIPOffset + sizeof(IPv4Address);
+    RelayPacket(event, RemoteIPOffset, BroadcastOffset);
+}
 
-    IPv4Address remote_ip;
-    in_packet.Read(remote_ip); // Remote IP
+void Room::RoomImpl::RelayPacket(const ENetEvent* event, std::size_t remote_ip_offset,
+                                 std::size_t broadcast_offset) {
+    ENetPacket* enet_packet = event->packet;
+    if (enet_packet->dataLength <= broadcast_offset) {
+        LOG_ERROR(Network, "Dropping truncated packet of {} bytes", enet_packet->dataLength);
+        packets_dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
 
-    bool broadcast;
-    in_packet.Read(broadcast); // Broadcast
+    IPv4Address destination_address;
+    std::memcpy(destination_address.data(), enet_packet->data + remote_ip_offset,
+                sizeof(IPv4Address));
+    const bool broadcast = enet_packet->data[broadcast_offset] != 0;
 
-    Packet out_packet;
-    out_packet.Append(event->packet->data, event->packet->dataLength);
-    ENetPacket* enet_packet = enet_packet_create(out_packet.GetData(), out_packet.GetDataSize(),
-                                                 ENET_PACKET_FLAG_RELIABLE);
+    // Relayed data is always delivered reliably, whatever way it reached the room.
+    enet_packet->flags = ENET_PACKET_FLAG_RELIABLE;
 
-    const auto& destination_address = remote_ip;
+    std::shared_lock lock(member_mutex);
     if (broadcast) { // Send the data to everyone except the sender
-        std::lock_guard lock(member_mutex);
-        bool sent_packet = false;
         for (const auto& member : members) {
             if (member.peer != event->peer) {
-                sent_packet = true;
                 enet_peer_send(member.peer, 0, enet_packet);
             }
         }
-
-        if (!sent_packet) {
-            enet_packet_destroy(enet_packet);
-        }
-    } else {
-        std::lock_guard lock(member_mutex);
-        auto member = std::find_if(members.begin(), members.end(),
-                                   [destination_address](const Member& member_entry) -> bool {
-                                       return member_entry.fake_ip == destination_address;
-                                   });
-        if (member != members.end()) {
-            enet_peer_send(member->peer, 0, enet_packet);
-        } else {
+    } else { // Send the data only to the destination client
+        const auto destination = fake_ip_index.find(FakeIPKey(destination_address));
+        if (destination == fake_ip_index.end()) {
             LOG_ERROR(Network,
                       "Attempting to send to unknown IP address: "
                       "{}.{}.{}.{}",
                       destination_address[0], destination_address[1], destination_address[2],
                       destination_address[3]);
-            enet_packet_destroy(enet_packet);
+            packets_dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
         }
+        enet_peer_send(destination->second, 0, enet_packet);
     }
-    enet_host_flush(server);
+    flush_pending = true;
 }
 
 void Room::RoomImpl::HandleChatPacket(const ENetEvent* event) {
@@ -1026,7 +1070,7 @@ void Room::RoomImpl::HandleClientDisconnection(ENetPeer* client) {
             enet_address_get_host_ip(&member->peer->address, ip_raw.data(), sizeof(ip_raw) - 1);
             ip = ip_raw.data();
 
-            members.erase(member);
+            RemoveMember(member);
         }
     }
 
@@ -1075,7 +1119,15 @@ bool Room::Create(const std::string& name, const std::string& description,
     room_impl->username_ban_list = ban_list.first;
     room_impl->ip_ban_list = ban_list.second;
 
-    room_impl->StartLoop();
+    if (room_impl->event_loop == nullptr) {
+        room_impl->StartLoop();
+    } else if (!room_impl->event_loop->AddRoom(*this)) {
+        LOG_ERROR(Network, "Room event loop has no capacity left for room {}", name);
+        room_impl->state = State::Closed;
+        enet_host_destroy(room_impl->server);
+        room_impl->server = nullptr;
+        return false;
+    }
     return true;
 }
 
@@ -1097,6 +1149,26 @@ Room::BanList Room::GetBanList() const {
     return {room_impl->username_ban_list, room_impl->ip_ban_list};
 }
 
+void Room::SetBanList(const BanList& ban_list) {
+    std::lock_guard lock(room_impl->ban_list_mutex);
+    room_impl->username_ban_list = ban_list.first;
+    room_impl->ip_ban_list = ban_list.second;
+}
+
+RoomMetrics Room::GetMetrics() const {
+    RoomMetrics metrics;
+    {
+        std::shared_lock lock(room_impl->member_mutex);
+        metrics.members = static_cast<u32>(room_impl->members.size());
+    }
+    metrics.bytes_received = room_impl->bytes_received.load(std::memory_order_relaxed);
+    metrics.bytes_sent = room_impl->bytes_sent.load(std::memory_order_relaxed);
+    metrics.packets_received = room_impl->packets_received.load(std::memory_order_relaxed);
+    metrics.packets_sent = room_impl->packets_sent.load(std::memory_order_relaxed);
+    metrics.packets_dropped = room_impl->packets_dropped.load(std::memory_order_relaxed);
+    return metrics;
+}
+
 std::vector<Member> Room::GetRoomMemberList() const {
     std::vector<Member> member_list;
     std::lock_guard lock(room_impl->member_mutex);
@@ -1117,6 +1189,19 @@ bool Room::HasPassword() const {
     return !room_impl->password.empty();
 }
 
+void Room::SetEventLoop(RoomEventLoop* event_loop) {
+    room_impl->event_loop = event_loop;
+}
+
+void Room::ServiceEvents() {
+    while (room_impl->state != State::Closed && room_impl->ProcessEvents(0)) {
+    }
+}
+
+ENetHost* Room::GetHost() const {
+    return room_impl->server;
+}
+
 void Room::SetVerifyUID(const std::string& uid) {
     std::lock_guard lock(room_impl->verify_uid_mutex);
     room_impl->verify_uid = uid;
@@ -1124,8 +1209,14 @@ void Room::SetVerifyUID(const std::string& uid) {
 
 void Room::Destroy() {
     room_impl->state = State::Closed;
-    room_impl->room_thread->join();
-    room_impl->room_thread.reset();
+    if (room_impl->event_loop == nullptr) {
+        room_impl->room_thread->join();
+        room_impl->room_thread.reset();
+    } else {
+        // Once removed the loop no longer touches the room, so it can be closed from here.
+        room_impl->event_loop->RemoveRoom(*this);
+        room_impl->SendCloseMessage();
+    }
 
     if (room_impl->server) {
         enet_host_destroy(room_impl->server);
@@ -1135,6 +1226,7 @@ void Room::Destroy() {
     {
         std::lock_guard lock(room_impl->member_mutex);
         room_impl->members.clear();
+        room_impl->fake_ip_index.clear();
     }
     room_impl->room_information.member_slots = 0;
     room_impl->room_information.name.clear();
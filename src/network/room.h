@@ -12,8 +12,12 @@
 #include "yuzu_common/socket_types.h"
 #include "network/verify_user.h"
 
+typedef struct _ENetHost ENetHost;
+
 namespace Network {
 
+class RoomEventLoop;
+
 using AnnounceMultiplayerRoom::GameInfo;
 using AnnounceMultiplayerRoom::Member;
 using AnnounceMultiplayerRoom::RoomInformation;
@@ -72,6 +76,16 @@ enum StatusMessageTypes : u8 {
     IdAddressUnbanned, ///< A username / ip address is unbanned from the room
 };
 
+/// Traffic counters of a room.
+struct RoomMetrics {
+    u32 members{};          ///< Number of members currently in the room.
+    u64 bytes_received{};   ///< Bytes received by the room's host, including protocol overhead.
+    u64 bytes_sent{};       ///< Bytes sent by the room's host, including protocol overhead.
+    u64 packets_received{}; ///< Datagrams received by the room's host.
+    u64 packets_sent{};     ///< Datagrams sent by the room's host.
+    u64 packets_dropped{};  ///< Relayed packets that were truncated or had no known destination.
+};
+
 /// This is what a server [person creating a server] would use.
 class Room final {
 public:
@@ -125,6 +139,12 @@ public:
                 std::unique_ptr<VerifyUser::Backend> verify_backend = nullptr,
                 const BanList& ban_list = {}, bool enable_yuzu_mods = false);
 
+    /**
+     * Services this room from a shared event loop instead of a dedicated thread. Must be called
+     * before Create.
+     */
+    void SetEventLoop(RoomEventLoop* event_loop);
+
     /**
      * Sets the verification GUID of the room.
      */
@@ -135,12 +155,32 @@ public:
      */
     BanList GetBanList() const;
 
+    /**
+     * Replaces the ban list of the room. Members that are already in the room are not affected,
+     * the new list applies to the next join requests.
+     */
+    void SetBanList(const BanList& ban_list);
+
+    /**
+     * Gets the traffic counters of the room.
+     */
+    RoomMetrics GetMetrics() const;
+
     /**
      * Destroys the socket
      */
     void Destroy();
 
 private:
+    friend class RoomEventLoop;
+
+    /// Handles the events already pending on the room's host without blocking. Called by the
+    /// event loop the room was added to.
+    void ServiceEvents();
+
+    /// Returns the ENet host of the room, nullptr while the room is closed.
+    ENetHost* GetHost() const;
+
     class RoomImpl;
     std::unique_ptr<RoomImpl> room_impl;
 };
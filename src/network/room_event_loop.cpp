@@ -0,0 +1,109 @@
+// SPDX-FileCopyrightText: Copyright 2024 yuzu Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <algorithm>
+#include "yuzu_common/thread.h"
+#include "enet/enet.h"
+#include "network/room.h"
+#include "network/room_event_loop.h"
+
+namespace Network {
+
+namespace {
+/// Upper bound on how long a thread blocks without incoming data. ENet still has to be serviced
+/// regularly to resend unacknowledged packets and to time out peers.
+constexpr enet_uint32 WaitTimeoutMs = 50;
+} // namespace
+
+RoomEventLoop::RoomEventLoop(std::size_t num_threads) {
+    num_threads = std::max<std::size_t>(num_threads, 1);
+    workers.reserve(num_threads);
+    for (std::size_t i = 0; i < num_threads; i++) {
+        auto worker = std::make_unique<Worker>();
+        worker->thread = std::jthread(
+            [this, &worker = *worker](std::stop_token stop_token) { WorkerLoop(worker, stop_token); });
+        workers.push_back(std::move(worker));
+    }
+}
+
+RoomEventLoop::~RoomEventLoop() {
+    for (auto& worker : workers) {
+        worker->thread.request_stop();
+    }
+    for (auto& worker : workers) {
+        worker->thread.join();
+    }
+}
+
+bool RoomEventLoop::AddRoom(Room& room) {
+    Worker* target = nullptr;
+    std::size_t target_rooms = MaxRoomsPerThread;
+    for (auto& worker : workers) {
+        std::scoped_lock lock{worker->mutex};
+        if (worker->rooms.size() < target_rooms) {
+            target = worker.get();
+            target_rooms = worker->rooms.size();
+        }
+    }
+    if (target == nullptr) {
+        return false;
+    }
+
+    std::scoped_lock lock{target->mutex};
+    target->rooms.push_back(&room);
+    target->cv.notify_all();
+    return true;
+}
+
+void RoomEventLoop::RemoveRoom(Room& room) {
+    for (auto& worker : workers) {
+        std::unique_lock lock{worker->mutex};
+        const auto it = std::ranges::find(worker->rooms, &room);
+        if (it == worker->rooms.end()) {
+            continue;
+        }
+        worker->rooms.erase(it);
+
+        // The thread may still be blocked on the room's socket, wait for it to wake up before the
+        // caller destroys the host.
+        worker->cv.wait(lock, [&worker] { return !worker->waiting; });
+        return;
+    }
+}
+
+void RoomEventLoop::WorkerLoop(Worker& worker, std::stop_token stop_token) {
+    Common::SetCurrentThreadName("RoomEventLoop");
+
+    while (!stop_token.stop_requested()) {
+        ENetSocketSet read_set;
+        ENET_SOCKETSET_EMPTY(read_set);
+        ENetSocket max_socket = 0;
+        {
+            std::unique_lock lock{worker.mutex};
+            Common::CondvarWait(worker.cv, lock, stop_token,
+                                [&worker] { return !worker.rooms.empty(); });
+            if (stop_token.stop_requested()) {
+                break;
+            }
+            for (const Room* room : worker.rooms) {
+                const ENetSocket socket = room->GetHost()->socket;
+                ENET_SOCKETSET_ADD(read_set, socket);
+                max_socket = std::max(max_socket, socket);
+            }
+            worker.waiting = true;
+        }
+
+        enet_socketset_select(max_socket, &read_set, nullptr, WaitTimeoutMs);
+
+        // Every room is serviced on each wake, not only the ones with data, so their ENet hosts
+        // also get to resend and time out peers.
+        std::scoped_lock lock{worker.mutex};
+        worker.waiting = false;
+        for (Room* room : worker.rooms) {
+            room->ServiceEvents();
+        }
+        worker.cv.notify_all();
+    }
+}
+
+} // namespace Network
@@ -0,0 +1,63 @@
+// SPDX-FileCopyrightText: Copyright 2024 yuzu Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "yuzu_common/common_types.h"
+#include "yuzu_common/polyfill_thread.h"
+
+namespace Network {
+
+class Room;
+
+/**
+ * Services many rooms from a small, fixed set of threads. Each thread blocks on the sockets of
+ * its rooms and wakes as soon as any of them receives data, instead of every room polling its
+ * host from a thread of its own.
+ */
+class RoomEventLoop final {
+public:
+    /// Maximum number of rooms a single thread waits on, bounded by the size of a socket set.
+    static constexpr std::size_t MaxRoomsPerThread = 64;
+
+    explicit RoomEventLoop(std::size_t num_threads);
+    ~RoomEventLoop();
+
+    RoomEventLoop(const RoomEventLoop&) = delete;
+    RoomEventLoop& operator=(const RoomEventLoop&) = delete;
+
+    /**
+     * Starts servicing an open room on the least loaded thread.
+     * @return false if every thread already services MaxRoomsPerThread rooms.
+     */
+    bool AddRoom(Room& room);
+
+    /**
+     * Stops servicing a room. When this returns the loop no longer references the room or its
+     * host.
+     */
+    void RemoveRoom(Room& room);
+
+    std::size_t NumThreads() const {
+        return workers.size();
+    }
+
+private:
+    struct Worker {
+        std::mutex mutex;
+        std::condition_variable_any cv;
+        std::vector<Room*> rooms;
+        bool waiting = false; ///< Whether the thread is blocked on a snapshot of the rooms' sockets
+        std::jthread thread;
+    };
+
+    void WorkerLoop(Worker& worker, std::stop_token stop_token);
+
+    std::vector<std::unique_ptr<Worker>> workers;
+};
+
+} // namespace Network
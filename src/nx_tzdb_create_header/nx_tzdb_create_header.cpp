@@ -1,3 +1,4 @@
+#include <cstdint>
 #include <fstream>
 #include <iomanip>
 #include <iostream>
@@ -6,6 +7,7 @@
 #include <vector>
 #include <common/path.h>
 #include <common/std_string.h>
+#include <zstd.h>
 
 bool processTimezoneFiles(const Path & zonePath, const std::string & headerName, const Path & outputDir, const Path & templatePath)
 {
@@ -25,35 +27,43 @@ bool processTimezoneFiles(const Path & zonePath, const std::string & headerName,
         return false;
     }
 
+    // Every file of the directory is packed into a single array, compressed with zstd unless that
+    // does not make it smaller, and indexed by a table of offsets so nothing is built at startup.
     std::ostringstream fileData;
+    std::ostringstream fileTable;
+    uint32_t dataOffset = 0;
     for (const auto & zoneFile : fileList)
     {
-        fileData << "{\"" << zoneFile.GetNameExtension() << "\",\n{";
-
         std::ifstream input(zoneFile, std::ios::binary);
         if (!input)
         {
             std::cerr << "Failed to open file: " << zoneFile << std::endl;
             continue;
         }
+        std::vector<uint8_t> contents((std::istreambuf_iterator<char>(input)), std::istreambuf_iterator<char>());
 
-        char byte;
-        int byteCount = 0;
-        while (input.get(byte))
+        std::vector<uint8_t> compressed(ZSTD_compressBound(contents.size()));
+        size_t compressedSize = ZSTD_compress(compressed.data(), compressed.size(), contents.data(), contents.size(), ZSTD_maxCLevel());
+        if (ZSTD_isError(compressedSize) || compressedSize >= contents.size())
+        {
+            compressed = contents;
+        }
+        else
         {
-            if (byteCount > 0 && byteCount % 19 == 0)
-            {
-                fileData << "\n";
-            }
-            else if (byteCount > 0)
-            {
-                fileData << " ";
-            }
+            compressed.resize(compressedSize);
+        }
 
-            fileData << "0x" << std::hex << std::setw(2) << std::setfill('0') << static_cast<int>(static_cast<unsigned char>(byte)) << ",";
-            byteCount++;
+        fileTable << "{\"" << zoneFile.GetNameExtension() << "\", " << std::dec << dataOffset << ", " << compressed.size() << ", " << contents.size() << "},\n";
+        for (size_t i = 0; i < compressed.size(); i++)
+        {
+            fileData << "0x" << std::hex << std::setw(2) << std::setfill('0') << static_cast<int>(compressed[i]) << ",";
+            fileData << ((dataOffset + i + 1) % 19 == 0 ? "\n" : " ");
         }
-        fileData << (byteCount > 0 && byteCount % 19 == 0 ? "\n}},\n" : " }},\n");
+        dataOffset += (uint32_t)compressed.size();
+    }
+    if (dataOffset == 0)
+    {
+        fileData << "0x00,";
     }
 
     std::ifstream templateFile(templatePath);
@@ -65,6 +75,7 @@ bool processTimezoneFiles(const Path & zonePath, const std::string & headerName,
 
     stdstr templateContent(std::string((std::istreambuf_iterator<char>(templateFile)), std::istreambuf_iterator<char>()));
     templateContent.Replace("@FILE_DATA@", fileData.str());
+    templateContent.Replace("@FILE_LIST@", fileTable.str());
     templateContent.Replace("@DIRECTORY_NAME@", headerName.c_str());
     Path outputFile(outputDir, stdstr_f("%s.h",headerName.c_str()).c_str());
     outputFile.AppendDirectory("nx_tzdb");
@@ -0,0 +1,305 @@
+#include "dma_bench.h"
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <nxemu-module-spec/base.h>
+#include <nxemu-module-spec/cpu.h>
+#include <nxemu-module-spec/operating_system.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+#include <yuzu_video_core/control/channel_state.h>
+#include <yuzu_video_core/dma_pusher.h>
+#include <yuzu_video_core/engines/maxwell_3d.h>
+#include <yuzu_video_core/engines/puller.h>
+#include <yuzu_video_core/frontend/emu_window.h>
+#include <yuzu_video_core/frontend/graphics_context.h>
+#include <yuzu_video_core/gpu.h>
+#include <yuzu_video_core/host1x/host1x.h>
+#include <yuzu_video_core/memory_manager.h>
+#include <yuzu_video_core/renderer_null/renderer_null.h>
+
+namespace
+{
+using Tegra::Engines::Maxwell3D;
+
+constexpr GPUVAddr PushbufferGpuAddress = 0x100000000ull;
+constexpr uint32_t ConstBufferSize = 0x10000;
+constexpr uint32_t ConstBufferWords = 64;
+constexpr uint32_t ViewportWords = 6;
+constexpr uint64_t GuestPageSize = 0x1000;
+
+// Guest memory is a single allocation, process virtual addresses are offsets into it
+class BenchDeviceMemory :
+    public IDeviceMemory
+{
+public:
+    explicit BenchDeviceMemory(size_t size) :
+        m_backing(size)
+    {
+    }
+
+    const uint8_t * BackingBasePointer() const
+    {
+        return m_backing.data();
+    }
+
+    uint8_t * Data(void)
+    {
+        return m_backing.data();
+    }
+
+    size_t Size(void) const
+    {
+        return m_backing.size();
+    }
+
+private:
+    std::vector<uint8_t> m_backing;
+};
+
+class BenchProcessMemory :
+    public IMemory
+{
+public:
+    explicit BenchProcessMemory(BenchDeviceMemory & deviceMemory) :
+        m_deviceMemory(deviceMemory)
+    {
+    }
+
+    void RasterizerMarkRegionCached(uint64_t /*vaddr*/, uint64_t /*size*/, bool /*cached*/)
+    {
+    }
+
+    uint8_t * GetPointerSilent(uint64_t vaddr)
+    {
+        return vaddr < m_deviceMemory.Size() ? m_deviceMemory.Data() + vaddr : nullptr;
+    }
+
+    uint8_t Read8(uint64_t addr)
+    {
+        return Read<uint8_t>(addr);
+    }
+
+    uint16_t Read16(uint64_t addr)
+    {
+        return Read<uint16_t>(addr);
+    }
+
+    uint32_t Read32(uint64_t addr)
+    {
+        return Read<uint32_t>(addr);
+    }
+
+    uint64_t Read64(uint64_t addr)
+    {
+        return Read<uint64_t>(addr);
+    }
+
+    bool WriteExclusive8(uint64_t /*addr*/, uint8_t /*data*/, uint8_t /*expected*/)
+    {
+        return false;
+    }
+
+    bool WriteExclusive16(uint64_t /*addr*/, uint16_t /*data*/, uint16_t /*expected*/)
+    {
+        return false;
+    }
+
+    bool WriteExclusive32(uint64_t /*addr*/, uint32_t /*data*/, uint32_t /*expected*/)
+    {
+        return false;
+    }
+
+    bool WriteExclusive64(uint64_t /*addr*/, uint64_t /*data*/, uint64_t /*expected*/)
+    {
+        return false;
+    }
+
+private:
+    template <typename T>
+    T Read(uint64_t addr)
+    {
+        T value = 0;
+        if (addr + sizeof(T) <= m_deviceMemory.Size())
+        {
+            memcpy(&value, m_deviceMemory.Data() + addr, sizeof(T));
+        }
+        return value;
+    }
+
+    BenchDeviceMemory & m_deviceMemory;
+};
+
+// The DMA path never reaches the other modules, the stream has no semaphores or queries
+class BenchSystem :
+    public ISwitchSystem
+{
+public:
+    void StartEmulation(void)
+    {
+    }
+
+    ISystemloader & Systemloader(void)
+    {
+        abort();
+    }
+
+    IOperatingSystem & OperatingSystem(void)
+    {
+        abort();
+    }
+
+    IVideo & Video(void)
+    {
+        abort();
+    }
+
+    ICpu & Cpu(void)
+    {
+        abort();
+    }
+};
+
+class BenchWindow :
+    public Core::Frontend::EmuWindow
+{
+public:
+    std::unique_ptr<Core::Frontend::GraphicsContext> CreateSharedContext() const
+    {
+        return std::make_unique<Core::Frontend::GraphicsContext>();
+    }
+
+    bool IsShown() const
+    {
+        return false;
+    }
+};
+
+void AppendMethod(std::vector<uint32_t> & words, uint32_t method, Tegra::SubmissionMode mode, const std::vector<uint32_t> & arguments)
+{
+    Tegra::CommandHeader header{};
+    header.method.Assign(method);
+    header.subchannel.Assign(0);
+    header.method_count.Assign((uint32_t)arguments.size());
+    header.mode.Assign(mode);
+    words.push_back(header.argument);
+    words.insert(words.end(), arguments.begin(), arguments.end());
+}
+
+std::vector<uint32_t> BuildSegment(GPUVAddr constBufferAddress)
+{
+    std::vector<uint32_t> data(ConstBufferWords);
+    for (uint32_t i = 0; i < ConstBufferWords; i++)
+    {
+        data[i] = 0x3F800000 + i;
+    }
+    const uint32_t one = 0x3F800000;
+
+    std::vector<uint32_t> words;
+    AppendMethod(words, MAXWELL3D_REG_INDEX(const_buffer), Tegra::SubmissionMode::Increasing,
+                 {ConstBufferSize, (uint32_t)(constBufferAddress >> 32), (uint32_t)constBufferAddress, 0});
+    AppendMethod(words, MAXWELL3D_REG_INDEX(bind_groups[0].raw_config), Tegra::SubmissionMode::Increasing, {1});
+    AppendMethod(words, MAXWELL3D_REG_INDEX(const_buffer.buffer), Tegra::SubmissionMode::NonIncreasing, data);
+    AppendMethod(words, MAXWELL3D_REG_INDEX(viewport_transform), Tegra::SubmissionMode::Increasing, std::vector<uint32_t>(ViewportWords, one));
+    return words;
+}
+
+Tegra::CommandListHeader MakeListHeader(GPUVAddr address, size_t words)
+{
+    Tegra::CommandListHeader header{};
+    header.addr.Assign(address);
+    header.size.Assign(words);
+    return header;
+}
+
+// Returns the words processed per second of one pass over every command list
+double RunPass(Tegra::DmaPusher & pusher, GPUVAddr firstSegment, size_t segmentWords, const DmaBenchConfig & config)
+{
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    GPUVAddr address = firstSegment;
+    for (uint32_t list = 0; list < config.commandLists; list++)
+    {
+        Tegra::CommandList commandList(config.segmentsPerList);
+        for (uint32_t segment = 0; segment < config.segmentsPerList; segment++)
+        {
+            commandList.command_lists[segment] = MakeListHeader(address, segmentWords);
+            address += segmentWords * sizeof(uint32_t);
+        }
+        pusher.Push(std::move(commandList));
+        pusher.DispatchCalls();
+    }
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    const uint64_t words = (uint64_t)config.commandLists * config.segmentsPerList * segmentWords;
+    return seconds > 0.0 ? words / seconds : 0.0;
+}
+} // namespace
+
+void RunDmaBenchmark(const DmaBenchConfig & config)
+{
+    if (config.commandLists == 0 || config.segmentsPerList == 0 || config.runs == 0)
+    {
+        std::cerr << "DMA benchmark needs command lists, segments and runs" << std::endl;
+        return;
+    }
+
+    const GPUVAddr constBufferAddress = PushbufferGpuAddress;
+    const GPUVAddr bindSegmentAddress = constBufferAddress + ConstBufferSize;
+    const GPUVAddr firstSegment = bindSegmentAddress + GuestPageSize;
+    const std::vector<uint32_t> segment = BuildSegment(constBufferAddress);
+    const uint64_t segments = (uint64_t)config.commandLists * config.segmentsPerList;
+    const uint64_t streamSize = segments * segment.size() * sizeof(uint32_t);
+    const uint64_t memorySize = (firstSegment - PushbufferGpuAddress + streamSize + GuestPageSize - 1) & ~(GuestPageSize - 1);
+
+    BenchDeviceMemory deviceMemory(memorySize);
+    BenchProcessMemory processMemory(deviceMemory);
+
+    // Lay out the stream in guest memory: the bound constant buffer, the engine bind, then every segment
+    std::vector<uint32_t> bindSegment;
+    AppendMethod(bindSegment, (uint32_t)Tegra::BufferMethods::BindObject, Tegra::SubmissionMode::Increasing, {(uint32_t)Tegra::EngineID::MAXWELL_B});
+    memcpy(deviceMemory.Data() + (bindSegmentAddress - PushbufferGpuAddress), bindSegment.data(), bindSegment.size() * sizeof(uint32_t));
+    for (uint64_t i = 0; i < segments; i++)
+    {
+        uint8_t * dest = deviceMemory.Data() + (firstSegment - PushbufferGpuAddress) + i * segment.size() * sizeof(uint32_t);
+        memcpy(dest, segment.data(), segment.size() * sizeof(uint32_t));
+    }
+
+    Tegra::Host1x::Host1x host1x(deviceMemory);
+    Core::Asid asid = host1x.MemoryManager().RegisterProcess(&processMemory);
+    BenchSystem system;
+    BenchWindow window;
+    Tegra::GPU gpu(system, host1x, false, false);
+    gpu.BindRenderer(std::make_unique<Null::RendererNull>(window, gpu, window.CreateSharedContext()));
+
+    std::shared_ptr<Tegra::MemoryManager> gmmu = std::make_shared<Tegra::MemoryManager>(host1x.MemoryManager());
+    gpu.InitAddressSpace(*gmmu);
+    const DAddr deviceAddress = host1x.MemoryManager().Allocate(memorySize);
+    host1x.MemoryManager().Map(deviceAddress, 0, memorySize, asid);
+    gmmu->Map(PushbufferGpuAddress, deviceAddress, memorySize, Tegra::PTEKind::PITCH, false);
+
+    std::shared_ptr<Tegra::Control::ChannelState> channel = gpu.AllocateChannel();
+    channel->memory_manager = gmmu;
+    gpu.InitChannel(*channel, 0);
+    gpu.BindChannel(channel->bind_id);
+
+    Tegra::DmaPusher & pusher = *channel->dma_pusher;
+    Tegra::CommandList bindList(1);
+    bindList.command_lists[0] = MakeListHeader(bindSegmentAddress, bindSegment.size());
+    pusher.Push(std::move(bindList));
+    pusher.DispatchCalls();
+
+    double bestPrefetch = 0.0, bestCopy = 0.0;
+    for (uint32_t run = 0; run < config.runs; run++)
+    {
+        pusher.SetPrefetchEnabled(true);
+        bestPrefetch = std::max(bestPrefetch, RunPass(pusher, firstSegment, segment.size(), config));
+        pusher.SetPrefetchEnabled(false);
+        bestCopy = std::max(bestCopy, RunPass(pusher, firstSegment, segment.size(), config));
+    }
+    pusher.SetPrefetchEnabled(true);
+
+    std::cout << "DMA benchmark: " << config.commandLists << " lists of " << config.segmentsPerList << " segments, " << segment.size()
+              << " words each, best of " << config.runs << " runs: prefetch " << (uint64_t)(bestPrefetch / 1000000.0) << " Mwords/s, copy "
+              << (uint64_t)(bestCopy / 1000000.0) << " Mwords/s" << std::endl;
+}
@@ -0,0 +1,15 @@
+#pragma once
+#include <stdint.h>
+
+struct DmaBenchConfig
+{
+    uint32_t commandLists;
+    uint32_t segmentsPerList;
+    uint32_t runs;
+};
+
+// Pushes a synthetic command stream through a headless GPU with a null rasterizer: every segment
+// binds a constant buffer, uploads 64 words to it and writes a viewport, which is the bulk of the
+// traffic the Puller and Maxwell3D see from games. Each run is done with prefetching on and off
+// and the best words per second of either is reported, so rasterizer work is not part of it.
+void RunDmaBenchmark(const DmaBenchConfig & config);
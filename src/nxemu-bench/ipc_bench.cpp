@@ -0,0 +1,186 @@
+#include "ipc_bench.h"
+#include <algorithm>
+#include <chrono>
+#include <core/hle/service/handler_table.h>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <stdlib.h>
+#include <string.h>
+
+namespace
+{
+// Enough lookups per pass that the clock resolution does not matter
+constexpr uint64_t MinLookupsPerPass = 4000000;
+
+struct BenchHandler
+{
+    uint32_t command;
+};
+
+struct PortTrace
+{
+    Service::HandlerMap<BenchHandler> handlers;
+    Service::HandlerTable<BenchHandler> table;
+};
+
+struct TraceRequest
+{
+    const PortTrace * port;
+    uint32_t command;
+};
+
+typedef std::map<std::string, PortTrace> PortTraces;
+
+// Returns the value following key up to the next comma or the end of the line
+bool FindField(const std::string & line, const char * key, std::string & value)
+{
+    size_t start = line.find(key);
+    if (start == std::string::npos)
+    {
+        return false;
+    }
+    start += strlen(key);
+    const size_t end = line.find(',', start);
+    value = line.substr(start, end == std::string::npos ? std::string::npos : end - start);
+    return true;
+}
+
+void ParseHandlers(const std::string & line, PortTraces & ports)
+{
+    std::string port, commands;
+    if (!FindField(line, "handlers: port=", port))
+    {
+        return;
+    }
+    const size_t start = line.find("commands=");
+    if (start == std::string::npos)
+    {
+        return;
+    }
+    commands = line.substr(start + strlen("commands="));
+
+    // A service registering more handlers logs the whole set again
+    PortTrace & trace = ports[port];
+    trace.handlers.clear();
+    for (size_t pos = 0; pos < commands.size();)
+    {
+        size_t end = commands.find(',', pos);
+        if (end == std::string::npos)
+        {
+            end = commands.size();
+        }
+        if (end > pos)
+        {
+            const uint32_t command = (uint32_t)strtoul(commands.substr(pos, end - pos).c_str(), nullptr, 10);
+            trace.handlers.emplace(command, BenchHandler{command});
+        }
+        pos = end + 1;
+    }
+}
+
+bool LoadTrace(const std::string & path, PortTraces & ports, std::vector<std::pair<std::string, uint32_t>> & requests)
+{
+    std::ifstream file(path);
+    if (!file.is_open())
+    {
+        return false;
+    }
+    std::string line;
+    while (std::getline(file, line))
+    {
+        if (line.find("handlers: port=") != std::string::npos)
+        {
+            ParseHandlers(line, ports);
+            continue;
+        }
+        // TIPC requests are looked up in their own handlers, which the trace does not list
+        std::string port, command;
+        if (line.find("function '") == std::string::npos || line.find("tipc function '") != std::string::npos ||
+            !FindField(line, "port=", port) || !FindField(line, "command=", command))
+        {
+            continue;
+        }
+        requests.emplace_back(port, (uint32_t)strtoul(command.c_str(), nullptr, 10));
+    }
+    return true;
+}
+
+bool IsServicePort(const std::string & port, const std::string & service)
+{
+    // Services such as nvdrv register one port per client type, nvdrv:a, nvdrv:s and so on
+    return port == service || (port.size() > service.size() && port.compare(0, service.size(), service) == 0 && port[service.size()] == ':');
+}
+
+// Returns the requests per second of looking up every request, through the table when useTable is set
+double RunPass(const std::vector<TraceRequest> & requests, bool useTable, uint64_t & found)
+{
+    const Service::HandlerTable<BenchHandler> noTable;
+    const uint64_t rounds = std::max<uint64_t>(MinLookupsPerPass / requests.size(), 1);
+
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (uint64_t round = 0; round < rounds; round++)
+    {
+        for (const TraceRequest & request : requests)
+        {
+            const BenchHandler * handler = Service::FindHandler(request.port->handlers, useTable ? request.port->table : noTable, request.command);
+            found += handler != nullptr && handler->command == request.command ? 1 : 0;
+        }
+    }
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return seconds > 0.0 ? (rounds * requests.size()) / seconds : 0.0;
+}
+} // namespace
+
+void RunIpcBenchmark(const IpcBenchConfig & config)
+{
+    if (config.runs == 0)
+    {
+        std::cerr << "IPC benchmark needs at least one run" << std::endl;
+        return;
+    }
+
+    PortTraces ports;
+    std::vector<std::pair<std::string, uint32_t>> trace;
+    if (!LoadTrace(config.tracePath, ports, trace))
+    {
+        std::cerr << "Failed to open trace " << config.tracePath << std::endl;
+        return;
+    }
+    for (PortTraces::iterator itr = ports.begin(); itr != ports.end(); itr++)
+    {
+        Service::BuildHandlerTable(itr->second.handlers, itr->second.table);
+    }
+
+    for (const std::string & service : config.services)
+    {
+        std::vector<TraceRequest> requests;
+        bool indexed = false;
+        for (const std::pair<std::string, uint32_t> & request : trace)
+        {
+            PortTraces::const_iterator port = ports.find(request.first);
+            if (port == ports.end() || !IsServicePort(request.first, service))
+            {
+                continue;
+            }
+            requests.push_back({&port->second, request.second});
+            indexed = indexed || !port->second.table.empty();
+        }
+        if (requests.empty())
+        {
+            std::cout << service << ": no requests in trace" << std::endl;
+            continue;
+        }
+
+        double bestTable = 0.0, bestMap = 0.0;
+        uint64_t found = 0;
+        for (uint32_t run = 0; run < config.runs; run++)
+        {
+            bestTable = std::max(bestTable, RunPass(requests, true, found));
+            bestMap = std::max(bestMap, RunPass(requests, false, found));
+        }
+        std::cout << service << ": " << requests.size() << " requests, best of " << config.runs << " runs: "
+                  << (indexed ? "handler table " : "handler table (not built) ") << (uint64_t)(bestTable / 1000000.0)
+                  << " Mreq/s, sorted map " << (uint64_t)(bestMap / 1000000.0) << " Mreq/s (" << found << " found)" << std::endl;
+    }
+}
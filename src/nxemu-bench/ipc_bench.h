@@ -0,0 +1,17 @@
+#pragma once
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+struct IpcBenchConfig
+{
+    std::string tracePath;
+    std::vector<std::string> services;
+    uint32_t runs;
+};
+
+// Replays the service requests of a trace log through the handler lookup nxemu-os dispatches
+// with, once indexing the handler table and once searching the sorted map. Traces are the
+// Service:Trace log of a debug build, which lists the commands each port registers and the
+// command of every request. Reports the best requests per second of either for each service.
+void RunIpcBenchmark(const IpcBenchConfig & config);
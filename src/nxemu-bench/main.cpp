@@ -0,0 +1,98 @@
+#include "dma_bench.h"
+#include "ipc_bench.h"
+#include "shader_bench.h"
+#include "texture_bench.h"
+#include <iostream>
+#include <stdlib.h>
+#include <string>
+#include <vector>
+#include <yuzu_common/logging/backend.h>
+
+namespace
+{
+uint32_t ArgumentOr(int argc, char ** argv, int index, uint32_t defaultValue)
+{
+    return argc > index ? (uint32_t)strtoul(argv[index], nullptr, 10) : defaultValue;
+}
+
+std::vector<std::string> SplitList(const std::string & list)
+{
+    std::vector<std::string> items;
+    for (size_t pos = 0; pos <= list.size();)
+    {
+        size_t end = list.find(',', pos);
+        if (end == std::string::npos)
+        {
+            end = list.size();
+        }
+        if (end > pos)
+        {
+            items.push_back(list.substr(pos, end - pos));
+        }
+        pos = end + 1;
+    }
+    return items;
+}
+
+void PrintUsage(void)
+{
+    std::cout << "Usage: nxemu-bench <benchmark> [arguments]" << std::endl;
+    std::cout << "  dma [command lists] [segments per list] [runs]" << std::endl;
+    std::cout << "  ipc <trace log> [services, comma separated] [runs]" << std::endl;
+    std::cout << "  shader <pipeline cache or directory of them> [runs]" << std::endl;
+    std::cout << "  texture [draws] [runs] [bind sequence]" << std::endl;
+}
+} // namespace
+
+int main(int argc, char ** argv)
+{
+    if (argc < 2)
+    {
+        PrintUsage();
+        return 1;
+    }
+
+    Common::Log::Initialize();
+    Common::Log::Start();
+
+    const std::string benchmark = argv[1];
+    int result = 0;
+    if (benchmark == "dma")
+    {
+        DmaBenchConfig config;
+        config.commandLists = ArgumentOr(argc, argv, 2, 1024);
+        config.segmentsPerList = ArgumentOr(argc, argv, 3, 64);
+        config.runs = ArgumentOr(argc, argv, 4, 5);
+        RunDmaBenchmark(config);
+    }
+    else if (benchmark == "ipc" && argc > 2)
+    {
+        IpcBenchConfig config;
+        config.tracePath = argv[2];
+        config.services = SplitList(argc > 3 ? argv[3] : "fsp-srv,hid,nvdrv");
+        config.runs = ArgumentOr(argc, argv, 4, 5);
+        RunIpcBenchmark(config);
+    }
+    else if (benchmark == "shader" && argc > 2)
+    {
+        ShaderBenchConfig config;
+        config.corpusPath = argv[2];
+        config.runs = ArgumentOr(argc, argv, 3, 3);
+        RunShaderBenchmark(config);
+    }
+    else if (benchmark == "texture")
+    {
+        TextureBenchConfig config;
+        config.draws = ArgumentOr(argc, argv, 2, 4096);
+        config.runs = ArgumentOr(argc, argv, 3, 5);
+        config.sequencePath = argc > 4 ? argv[4] : "";
+        RunTextureBenchmark(config);
+    }
+    else
+    {
+        PrintUsage();
+        result = 1;
+    }
+    Common::Log::Stop();
+    return result;
+}
@@ -0,0 +1,195 @@
+#include "shader_bench.h"
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <latch>
+#include <vector>
+#include <yuzu_common/thread_worker.h>
+#include <yuzu_shader_recompiler/exception.h>
+#include <yuzu_shader_recompiler/frontend/maxwell/translate_program.h>
+#include <yuzu_video_core/renderer_vulkan/vk_pipeline_cache.h>
+#include <yuzu_video_core/shader_environment.h>
+
+namespace
+{
+using Maxwell = Tegra::Engines::Maxwell3D::Regs;
+
+struct PipelineShaders
+{
+    std::vector<VideoCommon::FileEnvironment> envs;
+};
+
+struct ShaderCorpus
+{
+    std::vector<PipelineShaders> pipelines;
+    uint64_t stages = 0;
+    uint64_t computePipelines = 0;
+};
+
+void LoadCacheFile(const std::filesystem::path & path, ShaderCorpus & corpus)
+{
+    // LoadPipelines deletes a cache it cannot read, so it is handed a copy of the corpus file
+    std::ifstream header(path, std::ios::binary);
+    std::array<char, 8> magic{};
+    uint32_t version = 0;
+    if (!header.read(magic.data(), magic.size()).read((char *)&version, sizeof(version)))
+    {
+        return;
+    }
+    header.close();
+
+    std::error_code ec;
+    const std::filesystem::path copy = std::filesystem::temp_directory_path(ec) / "nxemu-bench-pipelines.bin";
+    if (ec || !std::filesystem::copy_file(path, copy, std::filesystem::copy_options::overwrite_existing, ec))
+    {
+        std::cerr << "Failed to copy " << path.string() << std::endl;
+        return;
+    }
+
+    std::stop_source stop;
+    VideoCommon::LoadPipelines(
+        stop.get_token(), copy, version,
+        [&](std::ifstream & file, VideoCommon::FileEnvironment)
+        {
+            Vulkan::ComputePipelineCacheKey key;
+            file.read((char *)&key, sizeof(key));
+            corpus.computePipelines += 1;
+        },
+        [&](std::ifstream & file, std::vector<VideoCommon::FileEnvironment> envs)
+        {
+            Vulkan::GraphicsPipelineCacheKey key;
+            file.read((char *)&key, sizeof(key));
+            corpus.stages += envs.size();
+            corpus.pipelines.push_back({std::move(envs)});
+        });
+    std::filesystem::remove(copy, ec);
+}
+
+bool LoadCorpus(const std::filesystem::path & path, ShaderCorpus & corpus)
+{
+    std::error_code ec;
+    if (std::filesystem::is_regular_file(path, ec))
+    {
+        LoadCacheFile(path, corpus);
+        return true;
+    }
+    if (!std::filesystem::is_directory(path, ec))
+    {
+        return false;
+    }
+    for (const std::filesystem::directory_entry & entry : std::filesystem::recursive_directory_iterator(path, ec))
+    {
+        if (entry.is_regular_file(ec) && entry.path().extension() == ".bin")
+        {
+            LoadCacheFile(entry.path(), corpus);
+        }
+    }
+    return true;
+}
+
+// Returns false when the recompiler cannot translate the stage
+bool TranslateStage(Shader::Environment & env, Vulkan::ShaderPools & pools, const Shader::HostTranslateInfo & hostInfo)
+{
+    try
+    {
+        const uint32_t cfgOffset = (uint32_t)(env.StartAddress() + sizeof(Shader::ProgramHeader));
+        Shader::Maxwell::Flow::CFG cfg(env, pools.flow_block, cfgOffset, env.ShaderStage() == Shader::Stage::VertexA);
+        Shader::IR::Program program = Shader::Maxwell::TranslateProgram(pools.inst, pools.block, env, cfg, hostInfo);
+        return true;
+    }
+    catch (const Shader::Exception &)
+    {
+        return false;
+    }
+}
+
+double RunSerialPass(ShaderCorpus & corpus, const Shader::HostTranslateInfo & hostInfo, uint64_t & failed)
+{
+    Vulkan::ShaderPools pools;
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (PipelineShaders & pipeline : corpus.pipelines)
+    {
+        for (VideoCommon::FileEnvironment & env : pipeline.envs)
+        {
+            failed += TranslateStage(env, pools, hostInfo) ? 0 : 1;
+        }
+        pools.ReleaseContents();
+    }
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// The first stage is translated on this thread while the workers translate the others, each on
+// pools of its own, as PipelineCache::CreateGraphicsPipeline does
+double RunConcurrentPass(ShaderCorpus & corpus, Common::ThreadWorker & workers, const Shader::HostTranslateInfo & hostInfo, uint64_t & failed)
+{
+    std::array<Vulkan::ShaderPools, Maxwell::MaxShaderProgram> pools;
+    std::array<bool, Maxwell::MaxShaderProgram> translated{};
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (PipelineShaders & pipeline : corpus.pipelines)
+    {
+        const size_t stages = std::min<size_t>(pipeline.envs.size(), Maxwell::MaxShaderProgram);
+        std::latch done((std::ptrdiff_t)stages - 1);
+        for (size_t stage = 1; stage < stages; stage++)
+        {
+            workers.QueueWork([&, stage]
+                              {
+                                  translated[stage] = TranslateStage(pipeline.envs[stage], pools[stage], hostInfo);
+                                  done.count_down();
+                              });
+        }
+        translated[0] = TranslateStage(pipeline.envs[0], pools[0], hostInfo);
+        done.wait();
+        for (size_t stage = 0; stage < stages; stage++)
+        {
+            failed += translated[stage] ? 0 : 1;
+            pools[stage].ReleaseContents();
+        }
+    }
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+} // namespace
+
+void RunShaderBenchmark(const ShaderBenchConfig & config)
+{
+    if (config.runs == 0)
+    {
+        std::cerr << "Shader benchmark needs at least one run" << std::endl;
+        return;
+    }
+
+    ShaderCorpus corpus;
+    if (!LoadCorpus(config.corpusPath, corpus))
+    {
+        std::cerr << "Failed to open shader corpus " << config.corpusPath << std::endl;
+        return;
+    }
+    if (corpus.pipelines.empty())
+    {
+        std::cerr << "Shader corpus has no graphics pipelines" << std::endl;
+        return;
+    }
+
+    const Shader::HostTranslateInfo hostInfo{};
+    Common::ThreadWorker workers(Maxwell::MaxShaderProgram - 1, "BenchTranslator");
+    double bestSerial = 0.0, bestConcurrent = 0.0;
+    uint64_t serialFailed = 0, concurrentFailed = 0;
+    for (uint32_t run = 0; run < config.runs; run++)
+    {
+        serialFailed = 0;
+        concurrentFailed = 0;
+        const double serial = RunSerialPass(corpus, hostInfo, serialFailed);
+        const double concurrent = RunConcurrentPass(corpus, workers, hostInfo, concurrentFailed);
+        bestSerial = run == 0 ? serial : std::min(bestSerial, serial);
+        bestConcurrent = run == 0 ? concurrent : std::min(bestConcurrent, concurrent);
+    }
+
+    const double pipelines = (double)corpus.pipelines.size();
+    std::cout << "Shader benchmark: " << corpus.pipelines.size() << " graphics pipelines, " << corpus.stages << " stages (" << serialFailed << " failed to translate, "
+              << corpus.computePipelines << " compute pipelines skipped), best of " << config.runs << " runs" << std::endl;
+    std::cout << "  one after another: " << (uint64_t)(bestSerial * 1000.0) << " ms, " << (uint64_t)(pipelines / bestSerial) << " pipelines/s" << std::endl;
+    std::cout << "  concurrent stages: " << (uint64_t)(bestConcurrent * 1000.0) << " ms, " << (uint64_t)(pipelines / bestConcurrent) << " pipelines/s ("
+              << concurrentFailed << " failed)" << std::endl;
+}
@@ -0,0 +1,15 @@
+#pragma once
+#include <stdint.h>
+#include <string>
+
+struct ShaderBenchConfig
+{
+    std::string corpusPath;
+    uint32_t runs;
+};
+
+// Translates the Maxwell shaders of every graphics pipeline in a corpus of Vulkan disk pipeline
+// caches, a single cache file or a directory of them. Each run translates the stages of every
+// pipeline one after another and then concurrently the way the pipeline cache builds them, and
+// the best wall time of either is reported. Only translation is timed, not SPIR-V emission.
+void RunShaderBenchmark(const ShaderBenchConfig & config);
@@ -0,0 +1,314 @@
+#include "texture_bench.h"
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <unordered_map>
+#include <vector>
+#include <yuzu_video_core/texture_cache/texture_cache_base.h>
+
+namespace
+{
+using Tegra::Texture::TICEntry;
+using Tegra::Texture::TSCEntry;
+
+// Enough lookups per pass that the clock resolution does not matter
+constexpr uint64_t MinLookupsPerPass = 4000000;
+
+// Working set of the generated sequence, about what a 3D scene binds in a frame
+constexpr uint32_t GeneratedTextures = 1024;
+constexpr uint32_t GeneratedSamplers = 48;
+constexpr uint32_t GeneratedTexturesPerDraw = 6;
+constexpr uint32_t GeneratedSamplersPerDraw = 2;
+constexpr uint64_t GeneratedTextureSize = 0x40000;
+constexpr uint64_t GeneratedGpuBase = 0x200000000ull;
+constexpr uint64_t GeneratedCpuBase = 0x80000000ull;
+
+// Page size of the texture cache page tables, TextureCache::YUZU_PAGEBITS
+constexpr uint64_t TexturePageBits = 20;
+
+enum class LookupType : uint8_t
+{
+    Tic,
+    Tsc,
+    GpuPage,
+    CpuPage,
+};
+
+struct Lookup
+{
+    LookupType type;
+    uint32_t index;
+};
+
+// Keys are stored once, the lookups refer to them by index
+struct BindSequence
+{
+    std::vector<TICEntry> tics;
+    std::vector<TSCEntry> tscs;
+    std::vector<uint64_t> gpuPages;
+    std::vector<uint64_t> cpuPages;
+    std::vector<Lookup> lookups;
+    uint64_t draws = 0;
+};
+
+template <typename Map>
+uint32_t KeyIndex(Map & indices, std::vector<typename Map::key_type> & keys, const typename Map::key_type & key)
+{
+    const auto [itr, inserted] = indices.try_emplace(key, (uint32_t)keys.size());
+    if (inserted)
+    {
+        keys.push_back(key);
+    }
+    return itr->second;
+}
+
+class SequenceBuilder
+{
+public:
+    explicit SequenceBuilder(BindSequence & sequence) :
+        m_sequence(sequence)
+    {
+    }
+
+    void Draw(void)
+    {
+        m_sequence.draws += 1;
+    }
+
+    void Tic(const TICEntry & tic)
+    {
+        m_sequence.lookups.push_back({LookupType::Tic, KeyIndex(m_tics, m_sequence.tics, tic)});
+    }
+
+    void Tsc(const TSCEntry & tsc)
+    {
+        m_sequence.lookups.push_back({LookupType::Tsc, KeyIndex(m_tscs, m_sequence.tscs, tsc)});
+    }
+
+    void GpuPage(uint64_t page)
+    {
+        m_sequence.lookups.push_back({LookupType::GpuPage, KeyIndex(m_gpuPages, m_sequence.gpuPages, page)});
+    }
+
+    void CpuPage(uint64_t page)
+    {
+        m_sequence.lookups.push_back({LookupType::CpuPage, KeyIndex(m_cpuPages, m_sequence.cpuPages, page)});
+    }
+
+private:
+    BindSequence & m_sequence;
+    std::unordered_map<TICEntry, uint32_t> m_tics;
+    std::unordered_map<TSCEntry, uint32_t> m_tscs;
+    std::unordered_map<uint64_t, uint32_t> m_gpuPages;
+    std::unordered_map<uint64_t, uint32_t> m_cpuPages;
+};
+
+template <typename Entry>
+bool ParseEntry(std::istringstream & stream, Entry & entry)
+{
+    entry = {};
+    for (uint64_t & word : entry.raw)
+    {
+        if (!(stream >> std::hex >> word))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool LoadSequence(const std::string & path, BindSequence & sequence)
+{
+    std::ifstream file(path);
+    if (!file.is_open())
+    {
+        return false;
+    }
+    SequenceBuilder builder(sequence);
+    std::string line;
+    while (std::getline(file, line))
+    {
+        std::istringstream stream(line);
+        std::string type;
+        stream >> type;
+        if (type == "draw")
+        {
+            builder.Draw();
+        }
+        else if (type == "tic")
+        {
+            TICEntry tic;
+            if (ParseEntry(stream, tic))
+            {
+                builder.Tic(tic);
+            }
+        }
+        else if (type == "tsc")
+        {
+            TSCEntry tsc;
+            if (ParseEntry(stream, tsc))
+            {
+                builder.Tsc(tsc);
+            }
+        }
+        else if (type == "gpu" || type == "cpu")
+        {
+            uint64_t page = 0;
+            if (stream >> std::hex >> page)
+            {
+                type == "gpu" ? builder.GpuPage(page) : builder.CpuPage(page);
+            }
+        }
+    }
+    return true;
+}
+
+// Most draws rebind the textures of the previous few materials, now and then a new one is used
+void GenerateSequence(uint32_t draws, BindSequence & sequence)
+{
+    std::mt19937 random(0x5EED);
+    std::geometric_distribution<uint32_t> reuse(0.05);
+    SequenceBuilder builder(sequence);
+
+    uint32_t material = 0;
+    for (uint32_t draw = 0; draw < draws; draw++)
+    {
+        builder.Draw();
+        material = (material + reuse(random)) % GeneratedTextures;
+        for (uint32_t slot = 0; slot < GeneratedTexturesPerDraw; slot++)
+        {
+            const uint32_t texture = (material + slot) % GeneratedTextures;
+            const uint64_t gpuAddress = GeneratedGpuBase + texture * GeneratedTextureSize;
+            TICEntry tic{};
+            tic.address_low = (uint32_t)gpuAddress;
+            tic.address_high.Assign((uint32_t)(gpuAddress >> 32));
+            builder.Tic(tic);
+            builder.GpuPage(gpuAddress >> TexturePageBits);
+            builder.CpuPage((GeneratedCpuBase + texture * GeneratedTextureSize) >> TexturePageBits);
+        }
+        for (uint32_t slot = 0; slot < GeneratedSamplersPerDraw; slot++)
+        {
+            TSCEntry tsc{};
+            tsc.raw[0] = (material + slot) % GeneratedSamplers;
+            builder.Tsc(tsc);
+        }
+    }
+}
+
+template <typename TicMap, typename TscMap, typename GpuMap, typename CpuMap>
+struct LookupMaps
+{
+    TicMap tics;
+    TscMap tscs;
+    GpuMap gpuPages;
+    CpuMap cpuPages;
+};
+
+typedef LookupMaps<tsl::robin_map<TICEntry, VideoCommon::ImageViewId>, tsl::robin_map<TSCEntry, VideoCommon::SamplerId>, VideoCommon::TextureCacheGPUMap,
+                   VideoCommon::TextureCacheCPUMap>
+    FlatMaps;
+
+typedef LookupMaps<std::unordered_map<TICEntry, VideoCommon::ImageViewId>, std::unordered_map<TSCEntry, VideoCommon::SamplerId>,
+                   std::unordered_map<uint64_t, VideoCommon::TextureCachePageImages>, std::unordered_map<uint64_t, VideoCommon::TextureCachePageMaps>>
+    NodeMaps;
+
+// Fills the maps the way the cache would after the first frame, every key seen has an entry
+template <typename Maps>
+void FillMaps(const BindSequence & sequence, Maps & maps)
+{
+    for (uint32_t i = 0; i < sequence.tics.size(); i++)
+    {
+        maps.tics.emplace(sequence.tics[i], VideoCommon::ImageViewId{i});
+    }
+    for (uint32_t i = 0; i < sequence.tscs.size(); i++)
+    {
+        maps.tscs.emplace(sequence.tscs[i], VideoCommon::SamplerId{i});
+    }
+    for (uint32_t i = 0; i < sequence.gpuPages.size(); i++)
+    {
+        maps.gpuPages[sequence.gpuPages[i]].push_back(VideoCommon::ImageId{i});
+    }
+    for (uint32_t i = 0; i < sequence.cpuPages.size(); i++)
+    {
+        maps.cpuPages[sequence.cpuPages[i]].push_back(VideoCommon::ImageMapId{i});
+    }
+}
+
+// Returns the seconds one replay of rounds times the sequence takes
+template <typename Maps>
+double RunPass(const BindSequence & sequence, const Maps & maps, uint64_t rounds, uint64_t & hits)
+{
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (uint64_t round = 0; round < rounds; round++)
+    {
+        for (const Lookup & lookup : sequence.lookups)
+        {
+            switch (lookup.type)
+            {
+            case LookupType::Tic: hits += maps.tics.find(sequence.tics[lookup.index]) != maps.tics.end() ? 1 : 0; break;
+            case LookupType::Tsc: hits += maps.tscs.find(sequence.tscs[lookup.index]) != maps.tscs.end() ? 1 : 0; break;
+            case LookupType::GpuPage: hits += maps.gpuPages.find(sequence.gpuPages[lookup.index]) != maps.gpuPages.end() ? 1 : 0; break;
+            case LookupType::CpuPage: hits += maps.cpuPages.find(sequence.cpuPages[lookup.index]) != maps.cpuPages.end() ? 1 : 0; break;
+            }
+        }
+    }
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+} // namespace
+
+void RunTextureBenchmark(const TextureBenchConfig & config)
+{
+    if (config.runs == 0)
+    {
+        std::cerr << "Texture benchmark needs at least one run" << std::endl;
+        return;
+    }
+
+    BindSequence sequence;
+    if (!config.sequencePath.empty())
+    {
+        if (!LoadSequence(config.sequencePath, sequence))
+        {
+            std::cerr << "Failed to open bind sequence " << config.sequencePath << std::endl;
+            return;
+        }
+    }
+    else
+    {
+        GenerateSequence(config.draws, sequence);
+    }
+    if (sequence.lookups.empty())
+    {
+        std::cerr << "Bind sequence has no lookups" << std::endl;
+        return;
+    }
+
+    FlatMaps flatMaps;
+    NodeMaps nodeMaps;
+    FillMaps(sequence, flatMaps);
+    FillMaps(sequence, nodeMaps);
+
+    const uint64_t rounds = std::max<uint64_t>(MinLookupsPerPass / sequence.lookups.size(), 1);
+    double bestFlat = 0.0, bestNode = 0.0;
+    uint64_t hits = 0;
+    for (uint32_t run = 0; run < config.runs; run++)
+    {
+        const double flatSeconds = RunPass(sequence, flatMaps, rounds, hits);
+        const double nodeSeconds = RunPass(sequence, nodeMaps, rounds, hits);
+        bestFlat = bestFlat == 0.0 ? flatSeconds : std::min(bestFlat, flatSeconds);
+        bestNode = bestNode == 0.0 ? nodeSeconds : std::min(bestNode, nodeSeconds);
+    }
+
+    const double lookups = (double)rounds * sequence.lookups.size();
+    const double draws = (double)rounds * std::max<uint64_t>(sequence.draws, 1);
+    std::cout << "Texture benchmark: " << sequence.draws << " draws, " << sequence.lookups.size() << " lookups (" << sequence.tics.size() << " TIC, "
+              << sequence.tscs.size() << " TSC, " << sequence.gpuPages.size() << " GPU pages, " << sequence.cpuPages.size() << " CPU pages), best of "
+              << config.runs << " runs" << std::endl;
+    std::cout << "  open addressing: " << (uint64_t)(lookups / bestFlat / 1000000.0) << " Mlookups/s, " << (uint64_t)(bestFlat * 1e9 / draws) << " ns per draw"
+              << std::endl;
+    std::cout << "  std::unordered_map: " << (uint64_t)(lookups / bestNode / 1000000.0) << " Mlookups/s, " << (uint64_t)(bestNode * 1e9 / draws)
+              << " ns per draw (" << hits << " hits)" << std::endl;
+}
@@ -0,0 +1,24 @@
+#pragma once
+#include <stdint.h>
+#include <string>
+
+struct TextureBenchConfig
+{
+    std::string sequencePath;
+    uint32_t draws;
+    uint32_t runs;
+};
+
+// Replays a bind sequence through the maps the texture cache looks up on every draw: the TIC and
+// TSC maps and the GPU and CPU page tables. Each run replays it against the open-addressing maps
+// the cache uses and against std::unordered_map copies of them, and reports the best lookups per
+// second and nanoseconds per draw of either.
+//
+// A sequence file has one lookup per line, "draw" starts the next draw:
+//   tic <raw0> <raw1> <raw2> <raw3>     TIC entry, four 64-bit hex words
+//   tsc <raw0> <raw1> <raw2> <raw3>     TSC entry, four 64-bit hex words
+//   gpu <page>                          GPU page table page, hex
+//   cpu <page>                          CPU page table page, hex
+// Without a file a sequence of the given number of draws is generated, binding textures and
+// samplers from a fixed working set with the reuse between draws of a typical frame.
+void RunTextureBenchmark(const TextureBenchConfig & config);
@@ -1,19 +1,69 @@
 #include "app_init.h"
+#include "machine/startup_trace.h"
 #include "machine/switch_system.h"
 #include "notification.h"
 #include "settings/core_settings.h"
 #include "settings/settings.h"
+#include <common/file.h>
+#include <common/json.h>
+#include <common/json_benchmark.h>
+#include <common/json_stream.h>
+#include <common/path.h>
+#include <memory>
 
 extern "C" int __stdcall AllocConsole();
 
+namespace
+{
+void RunConfigJsonBenchmark(void)
+{
+    std::string document;
+    File configFile;
+    if (configFile.Open(SettingsStore::GetInstance().GetConfigFile(), IFile::modeRead))
+    {
+        uint32_t fileLen = (uint32_t)configFile.GetLength();
+        std::unique_ptr<char[]> data = std::make_unique<char[]>(fileLen);
+        if (fileLen > 0 && configFile.Read(data.get(), fileLen) == fileLen)
+        {
+            document.assign(data.get(), fileLen);
+        }
+    }
+
+    // The core has no log of its own, so results are written next to the config like the startup trace
+    JsonValue results(JsonValueType::Array);
+    for (const JsonBenchmarkResult & result : RunJsonBenchmark(document))
+    {
+        JsonValue entry(JsonValueType::Object);
+        entry["name"] = JsonValue(result.name);
+        entry["megabytesPerSecond"] = JsonValue(result.megabytesPerSecond);
+        results.Append(std::move(entry));
+    }
+    JsonValue json(JsonValueType::Object);
+    json["configBytes"] = JsonValue((uint32_t)document.size());
+    json["results"] = results;
+
+    std::string jsonStr;
+    JsonStreamWriter writer(jsonStr);
+    writer.Value(json);
+    writer.Finish();
+    File resultFile;
+    if (resultFile.Open(Path(coreSettings.configDir, "json_benchmark.json"), IFile::modeWrite | IFile::modeCreate))
+    {
+        resultFile.Write(jsonStr.c_str(), (uint32_t)jsonStr.length());
+    }
+}
+} // namespace
+
 bool AppInit(INotification * notification)
 {
     g_notify = notification;
+    StartupTrace::Phase tracePhase("app.init");
     if (!SettingsStore::GetInstance().Initialize())
     {
         return false;
     }
     LoadCoreSetting();
+    StartupTrace::Install();
     if (coreSettings.showConsole)
     {
         if (AllocConsole())
@@ -24,6 +74,10 @@ bool AppInit(INotification * notification)
             freopen_s(&fp, "CONIN$", "r", stdin);
         }
     }
+    if (coreSettings.jsonBenchmark)
+    {
+        RunConfigJsonBenchmark();
+    }
 
     if (notification)
     {
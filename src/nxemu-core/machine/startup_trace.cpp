@@ -0,0 +1,148 @@
+#include "startup_trace.h"
+#include "settings/core_settings.h"
+#include "settings/identifiers.h"
+#include "settings/settings.h"
+#include <common/file.h>
+#include <common/json.h>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+struct TraceEntry
+{
+    std::string name;
+    std::thread::id threadId;
+    double startMs;
+    double durationMs;
+};
+
+// Captured during static initialization of the executable, which is as close to process launch
+// as we can get without platform specific calls.
+const std::chrono::steady_clock::time_point g_processStart = std::chrono::steady_clock::now();
+
+std::mutex g_traceMutex;
+std::vector<TraceEntry> g_traceEntries;
+std::chrono::steady_clock::time_point g_romLoadStart;
+bool g_traceFinished = false;
+
+double MillisecondsSinceLaunch(std::chrono::steady_clock::time_point time)
+{
+    return std::chrono::duration<double, std::milli>(time - g_processStart).count();
+}
+} // namespace
+
+StartupTrace::Phase::Phase(const char * name) :
+    m_name(name),
+    m_start(std::chrono::steady_clock::now())
+{
+}
+
+StartupTrace::Phase::~Phase()
+{
+    Record(m_name, m_start, std::chrono::steady_clock::now());
+}
+
+void StartupTrace::Install(void)
+{
+    SettingsStore & settings = SettingsStore::GetInstance();
+    settings.RegisterCallback(NXCoreSetting::RomLoading, RomLoadingChanged, nullptr);
+    settings.RegisterCallback(NXCoreSetting::DisplayedFrames, DisplayedFramesChanged, nullptr);
+}
+
+void StartupTrace::Record(const char * name, std::chrono::steady_clock::time_point start, std::chrono::steady_clock::time_point end)
+{
+    std::lock_guard<std::mutex> lock(g_traceMutex);
+    if (g_traceFinished)
+    {
+        return;
+    }
+    g_traceEntries.push_back({name, std::this_thread::get_id(), MillisecondsSinceLaunch(start), std::chrono::duration<double, std::milli>(end - start).count()});
+}
+
+void StartupTrace::RomLoadingChanged(const char * /*setting*/, void * /*userData*/)
+{
+    if (SettingsStore::GetInstance().GetBool(NXCoreSetting::RomLoading))
+    {
+        std::lock_guard<std::mutex> lock(g_traceMutex);
+        g_romLoadStart = std::chrono::steady_clock::now();
+    }
+    else
+    {
+        std::chrono::steady_clock::time_point romLoadStart;
+        {
+            std::lock_guard<std::mutex> lock(g_traceMutex);
+            romLoadStart = g_romLoadStart;
+        }
+        Record("rom.load", romLoadStart, std::chrono::steady_clock::now());
+    }
+}
+
+void StartupTrace::DisplayedFramesChanged(const char * /*setting*/, void * /*userData*/)
+{
+    if (SettingsStore::GetInstance().GetBool(NXCoreSetting::DisplayedFrames))
+    {
+        FirstFramePresented();
+    }
+}
+
+void StartupTrace::FirstFramePresented(void)
+{
+    std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+
+    std::lock_guard<std::mutex> lock(g_traceMutex);
+    if (g_traceFinished)
+    {
+        return;
+    }
+    g_traceFinished = true;
+
+    if (!coreSettings.startupTrace)
+    {
+        return;
+    }
+
+    double totalMs = MillisecondsSinceLaunch(now);
+    double romToFrameMs = g_romLoadStart.time_since_epoch().count() != 0 ? std::chrono::duration<double, std::milli>(now - g_romLoadStart).count() : totalMs;
+    bool withinTarget = coreSettings.startupTargetMs == 0 || romToFrameMs <= coreSettings.startupTargetMs;
+
+    // Threads are numbered in order of first appearance so the trace shows which phases overlapped.
+    std::vector<std::thread::id> threads;
+    JsonValue phases(JsonValueType::Array);
+    for (const TraceEntry & entry : g_traceEntries)
+    {
+        uint32_t threadIndex = 0;
+        while (threadIndex < threads.size() && threads[threadIndex] != entry.threadId)
+        {
+            threadIndex++;
+        }
+        if (threadIndex == threads.size())
+        {
+            threads.push_back(entry.threadId);
+        }
+
+        JsonValue phase(JsonValueType::Object);
+        phase["name"] = JsonValue(entry.name);
+        phase["thread"] = JsonValue(threadIndex);
+        phase["startMs"] = JsonValue(entry.startMs);
+        phase["durationMs"] = JsonValue(entry.durationMs);
+        phases.Append(std::move(phase));
+    }
+
+    JsonValue json(JsonValueType::Object);
+    json["phases"] = phases;
+    json["firstFrameMs"] = JsonValue(totalMs);
+    json["romLoadToFirstFrameMs"] = JsonValue(romToFrameMs);
+    json["targetMs"] = JsonValue(coreSettings.startupTargetMs);
+    json["withinTarget"] = JsonValue(withinTarget);
+
+    std::string jsonStr = JsonStyledWriter().write(json);
+    Path tracePath(coreSettings.configDir, "startup_trace.json");
+    File traceFile;
+    if (traceFile.Open(tracePath, IFile::modeWrite | IFile::modeCreate))
+    {
+        traceFile.Write(jsonStr.c_str(), (uint32_t)jsonStr.length());
+    }
+}
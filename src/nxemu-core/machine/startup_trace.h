@@ -0,0 +1,35 @@
+#pragma once
+#include <chrono>
+#include <stdint.h>
+
+// Records how long each part of start up takes, from process launch until the first frame is
+// presented. The trace is written to startup_trace.json in the config directory when the core
+// "StartupTrace" setting is enabled, and compared against "StartupTargetMs" when one is set so
+// regressions in start up time can be picked up by automated runs.
+class StartupTrace
+{
+public:
+    class Phase
+    {
+    public:
+        explicit Phase(const char * name);
+        ~Phase();
+
+    private:
+        Phase(const Phase &) = delete;
+        Phase & operator=(const Phase &) = delete;
+
+        const char * m_name;
+        std::chrono::steady_clock::time_point m_start;
+    };
+
+    static void Install(void);
+    static void Record(const char * name, std::chrono::steady_clock::time_point start, std::chrono::steady_clock::time_point end);
+
+private:
+    StartupTrace() = delete;
+
+    static void RomLoadingChanged(const char * setting, void * userData);
+    static void DisplayedFramesChanged(const char * setting, void * userData);
+    static void FirstFramePresented(void);
+};
@@ -1,4 +1,5 @@
 #include "switch_system.h"
+#include "startup_trace.h"
 #include "notification.h"
 #include "settings/core_settings.h"
 #include "settings/identifiers.h"
@@ -9,6 +10,7 @@ std::unique_ptr<SwitchSystem> SwitchSystem::m_instance;
 bool SwitchSystem::Create(IRenderWindow & window)
 {
     ShutDown();
+    StartupTrace::Phase tracePhase("system.create");
     m_instance.reset(new SwitchSystem());
     if (m_instance == nullptr)
     {
@@ -55,6 +57,7 @@ void SwitchSystem::StartEmulation(void)
     SettingsStore & settings = SettingsStore::GetInstance();
     settings.SetBool(NXCoreSetting::EmulationRunning, true);
     m_emulationRunning = true;
+    StartupTrace::Phase tracePhase("emulation.start");
     m_modules.StartEmulation();
 }
 
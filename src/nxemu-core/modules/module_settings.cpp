@@ -1,9 +1,13 @@
 #include "module_settings.h"
 #include "settings/settings.h"
+#include <common/json_stream.h>
 
 const char * ModuleSettings::GetString(const char * setting) const
 {
-    return SettingsStore::GetInstance().GetString(setting);
+    // Copied per thread so the caller's pointer stays valid while other threads change settings
+    thread_local std::string value;
+    value = SettingsStore::GetInstance().GetString(setting);
+    return value.c_str();
 }
 
 bool ModuleSettings::GetBool(const char * setting) const
@@ -48,9 +52,9 @@ void ModuleSettings::SetDefaultString(const char * setting, const char * value)
 
 const char * ModuleSettings::GetSectionSettings(const char * section) const
 {
-    JsonValue json = SettingsStore::GetInstance().GetSettings(section);
-    m_sectionSetting = json.isNull() ? "" : JsonStyledWriter().write(json);
-    return m_sectionSetting.c_str();
+    thread_local std::string sectionSetting;
+    sectionSetting = SettingsStore::GetInstance().GetSettingsText(section);
+    return sectionSetting.c_str();
 }
 
 void ModuleSettings::SetSectionSettings(const char * section, const std::string & json)
@@ -58,17 +62,34 @@ void ModuleSettings::SetSectionSettings(const char * section, const std::string
     JsonValue root;
     if (!json.empty())
     {
-        JsonReader reader;
-        if (!reader.Parse(json.data(), json.data() + json.size(), root))
+        JsonDocument document;
+        if (!document.Parse(json.data(), json.data() + json.size()))
         {
             return;
         }
+        root = document.Root().ToJsonValue();
     }
     SettingsStore& settings = SettingsStore::GetInstance();
     settings.SetSettings(section, root);
     settings.Save();
 }
 
+void ModuleSettings::PatchSectionSettings(const char * section, const std::string & patch)
+{
+    if (patch.empty())
+    {
+        return;
+    }
+    JsonDocument document;
+    if (!document.Parse(patch.data(), patch.data() + patch.size()))
+    {
+        return;
+    }
+    SettingsStore & settings = SettingsStore::GetInstance();
+    settings.PatchSettings(section, document.Root());
+    settings.Save();
+}
+
 void ModuleSettings::RegisterCallback(const char* setting, SettingChangeCallback callback, void * userData)
 {
     SettingsStore::GetInstance().RegisterCallback(setting, callback, userData);
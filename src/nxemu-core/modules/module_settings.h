@@ -1,6 +1,7 @@
 #pragma once
 
 #include "module_base.h"
+#include <string>
 
 class ModuleSettings :
     public IModuleSettings
@@ -20,10 +21,8 @@ public:
 
     const char * GetSectionSettings(const char * section) const override;
     void SetSectionSettings(const char * section, const std::string & json) override;
+    void PatchSectionSettings(const char * section, const std::string & patch) override;
 
     void RegisterCallback(const char * setting, SettingChangeCallback callback, void * userData) override;
     void UnregisterCallback(const char * setting, SettingChangeCallback callback, void * userData) override;
-
-private:
-    mutable std::string m_sectionSetting;
 };
\ No newline at end of file
@@ -1,6 +1,8 @@
 #include "modules.h"
+#include "machine/startup_trace.h"
 #include "notification.h"
 #include "settings/core_settings.h"
+#include <future>
 
 Modules::Modules() :
     m_loaderModule(nullptr),
@@ -8,6 +10,7 @@ Modules::Modules() :
     m_videoModule(nullptr),
     m_operatingsystemModule(nullptr)
 {
+    StartupTrace::Phase tracePhase("modules.load");
     CreateModules();
 }
 
@@ -66,22 +69,35 @@ bool Modules::Initialize(IRenderWindow & RenderWindow, ISwitchSystem & System)
         return false;
     }
 
-    if (!m_systemLoader->Initialize())
+    // The loader only builds its file system factories and the video module only needs the OS
+    // device memory, which exists once the OS is created, so both initialize alongside the CPU
+    // module and OS initialization (settings, logging, core timing and input devices) instead of
+    // waiting for them. The kernel and services are only brought up later, when the application
+    // process is created.
+    std::future<bool> loaderInit = std::async(std::launch::async, [this]()
     {
-        g_notify->BreakPoint(__FILE__, __LINE__);
-        return false;
-    }
-    if (!m_cpu->Initialize())
+        StartupTrace::Phase tracePhase("loader.initialize");
+        return m_systemLoader->Initialize();
+    });
+    std::future<bool> videoInit = std::async(std::launch::async, [this]()
     {
-        g_notify->BreakPoint(__FILE__, __LINE__);
-        return false;
+        StartupTrace::Phase tracePhase("video.initialize");
+        return m_video->Initialize();
+    });
+
+    bool cpuInitialized, osInitialized;
+    {
+        StartupTrace::Phase tracePhase("cpu.initialize");
+        cpuInitialized = m_cpu->Initialize();
     }
-    if (!m_video->Initialize())
     {
-        g_notify->BreakPoint(__FILE__, __LINE__);
-        return false;
+        StartupTrace::Phase tracePhase("os.initialize");
+        osInitialized = m_operatingsystem->Initialize();
     }
-    if (!m_operatingsystem->Initialize())
+    bool loaderInitialized = loaderInit.get();
+    bool videoInitialized = videoInit.get();
+
+    if (!loaderInitialized || !cpuInitialized || !videoInitialized || !osInitialized)
     {
         g_notify->BreakPoint(__FILE__, __LINE__);
         return false;
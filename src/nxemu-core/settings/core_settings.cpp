@@ -81,6 +81,12 @@ void LoadCoreSetting(void)
 
     JsonValue settingValue = jsonSettings["ShowConsole"];
     coreSettings.showConsole = settingValue.isBool() ? settingValue.asBool() : false;
+    settingValue = jsonSettings["StartupTrace"];
+    coreSettings.startupTrace = settingValue.isBool() ? settingValue.asBool() : false;
+    settingValue = jsonSettings["StartupTargetMs"];
+    coreSettings.startupTargetMs = settingValue.isInt() && settingValue.asInt64() > 0 ? (uint32_t)settingValue.asInt64() : 0;
+    settingValue = jsonSettings["JsonBenchmark"];
+    coreSettings.jsonBenchmark = settingValue.isBool() ? settingValue.asBool() : false;
 
     const JsonValue * modules = jsonSettings.Find("modules");
     if (modules != nullptr && modules->isObject())
@@ -163,6 +169,18 @@ void SaveCoreSetting(void)
     {
         json["ModuleDirectory-x64"] = JsonValue(coreSettings.moduleDirValue);
     }
+    if (coreSettings.startupTrace)
+    {
+        json["StartupTrace"] = JsonValue(true);
+    }
+    if (coreSettings.startupTargetMs != 0)
+    {
+        json["StartupTargetMs"] = JsonValue(coreSettings.startupTargetMs);
+    }
+    if (coreSettings.jsonBenchmark)
+    {
+        json["JsonBenchmark"] = JsonValue(true);
+    }
 
     SettingsStore& settings = SettingsStore::GetInstance();
     settings.SetSettings("Core", json);
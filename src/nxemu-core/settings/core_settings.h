@@ -1,10 +1,14 @@
 #pragma once
 #include "common/path.h"
+#include <stdint.h>
 #include <string>
 
 struct CoreSettings
 {
     bool showConsole;
+    bool startupTrace;
+    uint32_t startupTargetMs;
+    bool jsonBenchmark;
     Path configDir;
     Path moduleDir;
     std::string moduleDirValue;
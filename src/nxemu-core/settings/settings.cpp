@@ -1,6 +1,7 @@
 #include "settings.h"
 #include <common/file.h>
 #include <common/json.h>
+#include <common/json_stream.h>
 #include <common/path.h>
 
 std::unique_ptr<SettingsStore> SettingsStore::s_instance;
@@ -14,7 +15,9 @@ SettingsStore::SettingsStore()
 
 bool SettingsStore::Initialize()
 {
+    std::lock_guard<std::recursive_mutex> lock(m_cs);
     m_details = JsonValue();
+    m_sectionText.clear();
     for (size_t i = 0; i < 100; i++)
     {
         File configFile;
@@ -34,12 +37,12 @@ bool SettingsStore::Initialize()
             break;
         }
 
-        JsonReader reader;
-        JsonValue root;
-        if (!reader.Parse(data.get(), data.get() + Size, root))
+        JsonDocument document;
+        if (!document.Parse(data.get(), data.get() + Size))
         {
             return false;
         }
+        JsonValue root = document.Root().ToJsonValue();
         const JsonValue * value = root.Find("ConfigFile");
         if (value == nullptr)
         {
@@ -63,6 +66,7 @@ const char * SettingsStore::GetConfigFile(void) const
 
 void SettingsStore::SetChanged(const char * setting, bool changed)
 {
+    std::lock_guard<std::recursive_mutex> lock(m_cs);
     if (setting == nullptr)
     {
         return;
@@ -72,6 +76,7 @@ void SettingsStore::SetChanged(const char * setting, bool changed)
 
 JsonValue SettingsStore::GetSettings(const char * section) const
 {
+    std::lock_guard<std::recursive_mutex> lock(m_cs);
     const JsonValue * value = m_details.Find(section);
     if (value != nullptr)
     {
@@ -82,6 +87,8 @@ JsonValue SettingsStore::GetSettings(const char * section) const
 
 void SettingsStore::SetSettings(const char * section, JsonValue & json)
 {
+    std::lock_guard<std::recursive_mutex> lock(m_cs);
+    m_sectionText.erase(section);
     if (json.isNull())
     {
         m_details.removeMember(section);
@@ -92,18 +99,56 @@ void SettingsStore::SetSettings(const char * section, JsonValue & json)
     }
 }
 
-const char * SettingsStore::GetDefaultString(const char * setting) const
+std::string SettingsStore::GetSettingsText(const char * section)
 {
+    std::lock_guard<std::recursive_mutex> lock(m_cs);
+    SettingsMapString::iterator itr = m_sectionText.find(section);
+    if (itr != m_sectionText.end())
+    {
+        return itr->second;
+    }
+    std::string text;
+    const JsonValue * value = m_details.Find(section);
+    if (value != nullptr && !value->isNull())
+    {
+        JsonStreamWriter writer(text);
+        writer.Value(*value);
+        writer.Finish();
+    }
+    return m_sectionText.emplace(section, std::move(text)).first->second;
+}
+
+void SettingsStore::PatchSettings(const char * section, const JsonNode & patch)
+{
+    std::lock_guard<std::recursive_mutex> lock(m_cs);
+    m_sectionText.erase(section);
+    if (patch.isNull())
+    {
+        m_details.removeMember(section);
+        return;
+    }
+    JsonValue & value = m_details[section];
+    JsonMergePatch(value, patch);
+    if (value.isNull() || (value.isObject() && value.size() == 0))
+    {
+        m_details.removeMember(section);
+    }
+}
+
+std::string SettingsStore::GetDefaultString(const char * setting) const
+{
+    std::lock_guard<std::recursive_mutex> lock(m_cs);
     SettingsMapString::const_iterator itr = m_settingsDefaultString.find(setting);
     if (itr == m_settingsDefaultString.end())
     {
         return "";
     }
-    return itr->second.c_str();
+    return itr->second;
 }
 
 bool SettingsStore::GetDefaultBool(const char * setting) const
 {
+    std::lock_guard<std::recursive_mutex> lock(m_cs);
     SettingsMapBool::const_iterator itr = m_settingsDefaultBool.find(setting);
     if (itr == m_settingsDefaultBool.end())
     {
@@ -114,6 +159,7 @@ bool SettingsStore::GetDefaultBool(const char * setting) const
 
 int32_t SettingsStore::GetDefaultInt(const char* setting) const
 {
+    std::lock_guard<std::recursive_mutex> lock(m_cs);
     SettingsMapInt::const_iterator itr = m_settingsDefaultInt.find(setting);
     if (itr == m_settingsDefaultInt.end())
     {
@@ -122,18 +168,20 @@ int32_t SettingsStore::GetDefaultInt(const char* setting) const
     return itr->second;
 }
 
-const char * SettingsStore::GetString(const char * setting) const
+std::string SettingsStore::GetString(const char * setting) const
 {
+    std::lock_guard<std::recursive_mutex> lock(m_cs);
     SettingsMapString::const_iterator itr = m_settingsString.find(setting);
     if (itr == m_settingsString.end())
     {
         return GetDefaultString(setting);
     }
-    return itr->second.c_str();
+    return itr->second;
 }
 
 bool SettingsStore::GetBool(const char * setting) const
 {
+    std::lock_guard<std::recursive_mutex> lock(m_cs);
     SettingsMapBool::const_iterator itr = m_settingsBool.find(setting);
     if (itr == m_settingsBool.end())
     {
@@ -144,6 +192,7 @@ bool SettingsStore::GetBool(const char * setting) const
 
 bool SettingsStore::GetChanged(const char * setting) const
 {
+    std::lock_guard<std::recursive_mutex> lock(m_cs);
     SettingsMapBool::const_iterator itr = m_settingsChanged.find(setting);
     if (itr == m_settingsChanged.end())
     {
@@ -154,6 +203,7 @@ bool SettingsStore::GetChanged(const char * setting) const
 
 int32_t SettingsStore::GetInt(const char* setting) const
 {
+    std::lock_guard<std::recursive_mutex> lock(m_cs);
     SettingsMapInt::const_iterator itr = m_settingsInt.find(setting);
     if (itr == m_settingsInt.end())
     {
@@ -168,16 +218,19 @@ void SettingsStore::SetDefaultString(const char * setting, const char * value)
     {
         return;
     }
+    std::lock_guard<std::recursive_mutex> lock(m_cs);
     m_settingsDefaultString[setting] = value;
 }
 
 void SettingsStore::SetDefaultBool(const char * setting, bool value)
 {
+    std::lock_guard<std::recursive_mutex> lock(m_cs);
     m_settingsDefaultBool[setting] = value;
 }
 
 void SettingsStore::SetDefaultInt(const char * setting, int32_t value)
 {
+    std::lock_guard<std::recursive_mutex> lock(m_cs);
     m_settingsDefaultInt[setting] = value;
 }
 
@@ -188,12 +241,15 @@ void SettingsStore::SetString(const char * setting, const char * value)
         return;
     }
 
-    SettingsMapString::const_iterator it = m_settingsString.find(setting);
-    if (it != m_settingsString.end() && it->second.compare(value) == 0)
     {
-        return;
+        std::lock_guard<std::recursive_mutex> lock(m_cs);
+        SettingsMapString::const_iterator it = m_settingsString.find(setting);
+        if (it != m_settingsString.end() && it->second.compare(value) == 0)
+        {
+            return;
+        }
+        m_settingsString[setting] = value;
     }
-    m_settingsString[setting] = value;
     NotifyChange(setting);
 }
 
@@ -204,12 +260,15 @@ void SettingsStore::SetBool(const char * setting, bool value)
         return;
     }
 
-    SettingsMapBool::const_iterator it = m_settingsBool.find(setting);
-    if (it != m_settingsBool.end() && it->second == value)
     {
-        return;
+        std::lock_guard<std::recursive_mutex> lock(m_cs);
+        SettingsMapBool::const_iterator it = m_settingsBool.find(setting);
+        if (it != m_settingsBool.end() && it->second == value)
+        {
+            return;
+        }
+        m_settingsBool[setting] = value;
     }
-    m_settingsBool[setting] = value;
     NotifyChange(setting);
 }
 
@@ -220,18 +279,25 @@ void SettingsStore::SetInt(const char * setting, int32_t value)
         return;
     }
 
-    SettingsMapInt::const_iterator it = m_settingsInt.find(setting);
-    if (it != m_settingsInt.end() && it->second == value)
     {
-        return;
+        std::lock_guard<std::recursive_mutex> lock(m_cs);
+        SettingsMapInt::const_iterator it = m_settingsInt.find(setting);
+        if (it != m_settingsInt.end() && it->second == value)
+        {
+            return;
+        }
+        m_settingsInt[setting] = value;
     }
-    m_settingsInt[setting] = value;
     NotifyChange(setting);
 }
 
 void SettingsStore::Save(void)
 {
-    std::string jsonStr = JsonStyledWriter().write(m_details);
+    std::lock_guard<std::recursive_mutex> lock(m_cs);
+    std::string jsonStr;
+    JsonStreamWriter writer(jsonStr);
+    writer.Value(m_details);
+    writer.Finish();
     Path(m_configPath).DirectoryCreate();
     File configFile;
     if (!configFile.Open(m_configPath.c_str(), IFile::modeWrite | IFile::modeCreate))
@@ -249,6 +315,7 @@ void SettingsStore::RegisterCallback(const std::string & setting, SettingChangeC
     }
 
     CallbackInfo info = { callback, userData };
+    std::lock_guard<std::recursive_mutex> lock(m_cs);
     m_notification[setting].emplace_back(info);
 }
 
@@ -272,13 +339,20 @@ void SettingsStore::NotifyChange(const char * setting)
     {
         return;
     }
-    NotificationMap::const_iterator itr = m_notification.find(setting);
-    if (itr != m_notification.end())
+    // Callbacks run without the lock held, they are free to read settings or wait on threads
+    // that do.
+    NotificationCallbacks callbacks;
     {
-        const NotificationCallbacks & callbacks = itr->second;
-        for (NotificationCallbacks::const_iterator callItr = callbacks.begin(); callItr != callbacks.end(); callItr++)
+        std::lock_guard<std::recursive_mutex> lock(m_cs);
+        NotificationMap::const_iterator itr = m_notification.find(setting);
+        if (itr == m_notification.end())
         {
-            callItr->callback(setting, callItr->userData);
+            return;
         }
+        callbacks = itr->second;
+    }
+    for (NotificationCallbacks::const_iterator callItr = callbacks.begin(); callItr != callbacks.end(); callItr++)
+    {
+        callItr->callback(setting, callItr->userData);
     }
 }
\ No newline at end of file
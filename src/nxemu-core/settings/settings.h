@@ -1,8 +1,10 @@
 #pragma once
 #include <nxemu-module-spec/base.h>
 #include <common/json.h>
+#include <common/json_stream.h>
 #include <functional>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <unordered_map>
 
@@ -28,11 +30,13 @@ public:
 
     JsonValue GetSettings(const char * section) const;
     void SetSettings(const char * section, JsonValue & json);
+    std::string GetSettingsText(const char * section);
+    void PatchSettings(const char * section, const JsonNode & patch);
 
-    const char * GetDefaultString(const char * setting) const;
+    std::string GetDefaultString(const char * setting) const;
     bool GetDefaultBool(const char * setting) const;
     int GetDefaultInt(const char * setting) const;
-    const char * GetString(const char * setting) const;
+    std::string GetString(const char * setting) const;
     bool GetBool(const char* setting) const;
     bool GetChanged(const char * setting) const;
     int32_t GetInt(const char* setting) const;
@@ -62,8 +66,13 @@ private:
     SettingsMapInt m_settingsDefaultInt;
     SettingsMapBool m_settingsChanged;
     NotificationMap m_notification;
+    // Modules initialize on their own threads, so every access to the store takes this lock.
+    // Values are handed out as copies so nothing points into the maps once it is released.
+    mutable std::recursive_mutex m_cs;
 
     static std::unique_ptr<SettingsStore> s_instance;
     std::string m_configPath;
     JsonValue m_details;
+    // Styled text of each section handed out to modules, dropped when the section changes
+    SettingsMapString m_sectionText;
 };
@@ -0,0 +1,104 @@
+#include <algorithm>
+#include <cstring>
+
+#include "yuzu_common/logging/log.h"
+#include "yuzu_common/yuzu_assert.h"
+#include "core/crypto/aes_util.h"
+#include "core/crypto/crypto_backend.h"
+
+namespace Core::Crypto {
+
+namespace {
+
+void CalculateNintendoTweak(u8* out, std::size_t sector_id) {
+    for (std::size_t i = AESBlockSize; i-- > 0;) {
+        out[i] = static_cast<u8>(sector_id & 0xFF);
+        sector_id >>= 8;
+    }
+}
+
+} // namespace
+
+template <typename Key, std::size_t KeySize>
+AESCipher<Key, KeySize>::AESCipher(Key key, Mode mode_)
+    : data_key{std::make_unique<AESKeySchedule>()}, mode{mode_} {
+    ExpandAES128Key(key.data(), *data_key);
+    if constexpr (KeySize == 0x20) {
+        ASSERT_MSG(mode == Mode::XTS, "256-bit keys are only supported in XTS mode");
+        tweak_key = std::make_unique<AESKeySchedule>();
+        ExpandAES128Key(key.data() + 0x10, *tweak_key);
+    } else {
+        ASSERT_MSG(mode != Mode::XTS, "XTS mode requires a 256-bit key");
+    }
+}
+
+template <typename Key, std::size_t KeySize>
+AESCipher<Key, KeySize>::~AESCipher() = default;
+
+template <typename Key, std::size_t KeySize>
+void AESCipher<Key, KeySize>::SetIV(std::span<const u8> data) {
+    ASSERT_MSG(data.size() == iv.size(), "IV must be 16 bytes");
+    std::memcpy(iv.data(), data.data(), iv.size());
+}
+
+template <typename Key, std::size_t KeySize>
+void AESCipher<Key, KeySize>::Transcode(const u8* src, std::size_t size, u8* dest, Op op) const {
+    const AESKernels& kernels = GetAESKernels();
+    const std::size_t num_blocks = size / AESBlockSize;
+    const std::size_t tail = size % AESBlockSize;
+
+    switch (mode) {
+    case Mode::CTR: {
+        // Encryption and decryption are the same keystream xor.
+        AESBlock counter = iv;
+        kernels.ctr(*data_key, counter.data(), src, dest, num_blocks);
+        if (tail != 0) {
+            AESBlock block{};
+            std::memcpy(block.data(), src + num_blocks * AESBlockSize, tail);
+            kernels.ctr(*data_key, counter.data(), block.data(), block.data(), 1);
+            std::memcpy(dest + num_blocks * AESBlockSize, block.data(), tail);
+        }
+        break;
+    }
+    case Mode::ECB:
+        if (tail != 0) {
+            LOG_ERROR(Crypto, "ECB transcode of {:#X} bytes is not a multiple of the block size",
+                      size);
+        }
+        if (op == Op::Encrypt) {
+            kernels.encrypt_ecb(*data_key, src, dest, num_blocks);
+        } else {
+            kernels.decrypt_ecb(*data_key, src, dest, num_blocks);
+        }
+        break;
+    default:
+        UNREACHABLE_MSG("XTS must be transcoded with XTSTranscode");
+    }
+}
+
+template <typename Key, std::size_t KeySize>
+void AESCipher<Key, KeySize>::XTSTranscode(const u8* src, std::size_t size, u8* dest,
+                                           std::size_t sector_id, std::size_t sector_size, Op op) {
+    ASSERT_MSG(mode == Mode::XTS, "XTSTranscode called on a cipher not in XTS mode");
+    ASSERT_MSG(tweak_key != nullptr, "XTSTranscode requires a 256-bit key");
+    ASSERT_MSG(sector_size % AESBlockSize == 0 && size % sector_size == 0,
+               "XTS transcode must cover whole sectors of whole blocks");
+
+    const AESKernels& kernels = GetAESKernels();
+    for (std::size_t offset = 0; offset < size; offset += sector_size, ++sector_id) {
+        AESBlock tweak;
+        CalculateNintendoTweak(tweak.data(), sector_id);
+        kernels.encrypt_ecb(*tweak_key, tweak.data(), tweak.data(), 1);
+        kernels.xts(*data_key, tweak.data(), src + offset, dest + offset,
+                    sector_size / AESBlockSize, op == Op::Decrypt);
+    }
+}
+
+const char* GetAESBackendName() {
+    return GetAESKernels().name;
+}
+
+template class AESCipher<Key128>;
+template class AESCipher<Key256>;
+
+} // namespace Core::Crypto
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <array>
+#include <memory>
+#include <span>
+#include <type_traits>
+#include "yuzu_common/common_types.h"
+
+namespace Core::Crypto {
+
+struct AESKeySchedule;
+
+using Key128 = std::array<u8, 0x10>;
+using Key256 = std::array<u8, 0x20>;
+
+enum class Mode {
+    CTR,
+    ECB,
+    XTS,
+};
+
+enum class Op {
+    Encrypt,
+    Decrypt,
+};
+
+/**
+ * AES-128 in the modes used by Switch content. A Key128 cipher runs CTR or ECB, a Key256 cipher
+ * runs XTS with the first half of the key encrypting data and the second half encrypting the
+ * sector tweak. The block transforms use AES-NI or the ARMv8 crypto extension when present.
+ */
+template <typename Key, std::size_t KeySize = sizeof(Key)>
+class AESCipher {
+    static_assert(std::is_same_v<Key, std::array<u8, KeySize>>, "Key must be std::array of u8.");
+    static_assert(KeySize == 0x10 || KeySize == 0x20, "KeySize must be 128 or 256.");
+
+public:
+    AESCipher(Key key, Mode mode);
+    ~AESCipher();
+
+    void SetIV(std::span<const u8> data);
+
+    template <typename Source, typename Dest>
+    void Transcode(const Source* src, std::size_t size, Dest* dest, Op op) const {
+        static_assert(std::is_trivially_copyable_v<Source> && std::is_trivially_copyable_v<Dest>,
+                      "Transcode source and destination types must be trivially copyable.");
+        Transcode(reinterpret_cast<const u8*>(src), size, reinterpret_cast<u8*>(dest), op);
+    }
+
+    /// CTR transcodes from the current IV, the IV itself is left unchanged.
+    void Transcode(const u8* src, std::size_t size, u8* dest, Op op) const;
+
+    template <typename Source, typename Dest>
+    void XTSTranscode(const Source* src, std::size_t size, Dest* dest, std::size_t sector_id,
+                      std::size_t sector_size, Op op) {
+        static_assert(std::is_trivially_copyable_v<Source> && std::is_trivially_copyable_v<Dest>,
+                      "XTSTranscode source and destination types must be trivially copyable.");
+        XTSTranscode(reinterpret_cast<const u8*>(src), size, reinterpret_cast<u8*>(dest),
+                     sector_id, sector_size, op);
+    }
+
+    /// Transcodes whole sectors, sector_id is the number of the first one and is written big
+    /// endian into the tweak as Nintendo does.
+    void XTSTranscode(const u8* src, std::size_t size, u8* dest, std::size_t sector_id,
+                      std::size_t sector_size, Op op);
+
+private:
+    std::unique_ptr<AESKeySchedule> data_key;
+    std::unique_ptr<AESKeySchedule> tweak_key;
+    Mode mode;
+    std::array<u8, 0x10> iv{};
+};
+
+/// Name of the AES backend selected for the host CPU.
+const char* GetAESBackendName();
+
+} // namespace Core::Crypto
@@ -0,0 +1,294 @@
+#include "core/crypto/crypto_backend.h"
+
+#ifdef CRYPTO_ARCH_ARM64
+
+#ifdef _MSC_VER
+#include <arm64_neon.h>
+#define CRYPTO_TARGET_ARM
+#else
+#include <arm_neon.h>
+#define CRYPTO_TARGET_ARM __attribute__((target("+crypto")))
+#endif
+
+namespace Core::Crypto {
+
+namespace {
+
+/// Blocks processed together to keep the AES units pipelined.
+constexpr std::size_t AESInterleave = 4;
+
+struct Arm64RoundKeys {
+    std::array<uint8x16_t, AES128Rounds + 1> keys;
+
+    explicit Arm64RoundKeys(const std::array<AESBlock, AES128Rounds + 1>& schedule) {
+        for (std::size_t i = 0; i <= AES128Rounds; ++i) {
+            keys[i] = vld1q_u8(schedule[i].data());
+        }
+    }
+};
+
+// AESE/AESD apply the round key before SubBytes/ShiftRows, so the last key is a plain xor.
+CRYPTO_TARGET_ARM uint8x16_t EncryptBlock(const Arm64RoundKeys& rk, uint8x16_t block) {
+    for (std::size_t i = 0; i < AES128Rounds - 1; ++i) {
+        block = vaesmcq_u8(vaeseq_u8(block, rk.keys[i]));
+    }
+    block = vaeseq_u8(block, rk.keys[AES128Rounds - 1]);
+    return veorq_u8(block, rk.keys[AES128Rounds]);
+}
+
+CRYPTO_TARGET_ARM uint8x16_t DecryptBlock(const Arm64RoundKeys& rk, uint8x16_t block) {
+    for (std::size_t i = 0; i < AES128Rounds - 1; ++i) {
+        block = vaesimcq_u8(vaesdq_u8(block, rk.keys[i]));
+    }
+    block = vaesdq_u8(block, rk.keys[AES128Rounds - 1]);
+    return veorq_u8(block, rk.keys[AES128Rounds]);
+}
+
+CRYPTO_TARGET_ARM void EncryptBlocks4(const Arm64RoundKeys& rk, uint8x16_t* blocks) {
+    for (std::size_t i = 0; i < AES128Rounds - 1; ++i) {
+        for (std::size_t j = 0; j < AESInterleave; ++j) {
+            blocks[j] = vaesmcq_u8(vaeseq_u8(blocks[j], rk.keys[i]));
+        }
+    }
+    for (std::size_t j = 0; j < AESInterleave; ++j) {
+        blocks[j] = veorq_u8(vaeseq_u8(blocks[j], rk.keys[AES128Rounds - 1]),
+                             rk.keys[AES128Rounds]);
+    }
+}
+
+CRYPTO_TARGET_ARM void DecryptBlocks4(const Arm64RoundKeys& rk, uint8x16_t* blocks) {
+    for (std::size_t i = 0; i < AES128Rounds - 1; ++i) {
+        for (std::size_t j = 0; j < AESInterleave; ++j) {
+            blocks[j] = vaesimcq_u8(vaesdq_u8(blocks[j], rk.keys[i]));
+        }
+    }
+    for (std::size_t j = 0; j < AESInterleave; ++j) {
+        blocks[j] = veorq_u8(vaesdq_u8(blocks[j], rk.keys[AES128Rounds - 1]),
+                             rk.keys[AES128Rounds]);
+    }
+}
+
+CRYPTO_TARGET_ARM void Arm64EncryptECB(const AESKeySchedule& ks, const u8* in, u8* out,
+                                       std::size_t num_blocks) {
+    const Arm64RoundKeys rk(ks.enc);
+    std::size_t i = 0;
+    for (; i + AESInterleave <= num_blocks; i += AESInterleave) {
+        uint8x16_t blocks[AESInterleave];
+        for (std::size_t j = 0; j < AESInterleave; ++j) {
+            blocks[j] = vld1q_u8(in + (i + j) * AESBlockSize);
+        }
+        EncryptBlocks4(rk, blocks);
+        for (std::size_t j = 0; j < AESInterleave; ++j) {
+            vst1q_u8(out + (i + j) * AESBlockSize, blocks[j]);
+        }
+    }
+    for (; i < num_blocks; ++i) {
+        vst1q_u8(out + i * AESBlockSize, EncryptBlock(rk, vld1q_u8(in + i * AESBlockSize)));
+    }
+}
+
+CRYPTO_TARGET_ARM void Arm64DecryptECB(const AESKeySchedule& ks, const u8* in, u8* out,
+                                       std::size_t num_blocks) {
+    const Arm64RoundKeys rk(ks.dec);
+    std::size_t i = 0;
+    for (; i + AESInterleave <= num_blocks; i += AESInterleave) {
+        uint8x16_t blocks[AESInterleave];
+        for (std::size_t j = 0; j < AESInterleave; ++j) {
+            blocks[j] = vld1q_u8(in + (i + j) * AESBlockSize);
+        }
+        DecryptBlocks4(rk, blocks);
+        for (std::size_t j = 0; j < AESInterleave; ++j) {
+            vst1q_u8(out + (i + j) * AESBlockSize, blocks[j]);
+        }
+    }
+    for (; i < num_blocks; ++i) {
+        vst1q_u8(out + i * AESBlockSize, DecryptBlock(rk, vld1q_u8(in + i * AESBlockSize)));
+    }
+}
+
+struct Arm64Counter {
+    // Big endian 128-bit counter split in two native 64-bit halves.
+    u64 hi;
+    u64 lo;
+};
+
+CRYPTO_TARGET_ARM uint8x16_t NextCounterBlock(Arm64Counter& counter) {
+    const uint64x2_t halves = vcombine_u64(vcreate_u64(counter.hi), vcreate_u64(counter.lo));
+    const uint8x16_t value = vrev64q_u8(vreinterpretq_u8_u64(halves));
+    if (++counter.lo == 0) {
+        ++counter.hi;
+    }
+    return value;
+}
+
+CRYPTO_TARGET_ARM void Arm64CTR(const AESKeySchedule& ks, u8* counter_bytes, const u8* in, u8* out,
+                                std::size_t num_blocks) {
+    const Arm64RoundKeys rk(ks.enc);
+
+    Arm64Counter counter{};
+    for (std::size_t i = 0; i < 8; ++i) {
+        counter.hi = (counter.hi << 8) | counter_bytes[i];
+        counter.lo = (counter.lo << 8) | counter_bytes[8 + i];
+    }
+
+    std::size_t i = 0;
+    for (; i + AESInterleave <= num_blocks; i += AESInterleave) {
+        uint8x16_t blocks[AESInterleave];
+        for (std::size_t j = 0; j < AESInterleave; ++j) {
+            blocks[j] = NextCounterBlock(counter);
+        }
+        EncryptBlocks4(rk, blocks);
+        for (std::size_t j = 0; j < AESInterleave; ++j) {
+            const std::size_t offset = (i + j) * AESBlockSize;
+            vst1q_u8(out + offset, veorq_u8(blocks[j], vld1q_u8(in + offset)));
+        }
+    }
+    for (; i < num_blocks; ++i) {
+        const uint8x16_t keystream = EncryptBlock(rk, NextCounterBlock(counter));
+        vst1q_u8(out + i * AESBlockSize, veorq_u8(keystream, vld1q_u8(in + i * AESBlockSize)));
+    }
+
+    for (std::size_t j = 0; j < 8; ++j) {
+        counter_bytes[7 - j] = static_cast<u8>(counter.hi >> (j * 8));
+        counter_bytes[15 - j] = static_cast<u8>(counter.lo >> (j * 8));
+    }
+}
+
+CRYPTO_TARGET_ARM uint8x16_t MultiplyTweak(uint8x16_t tweak) {
+    // Shift each 64-bit half left by one, moving bit 63 into bit 64 and folding bit 127 back in
+    // as the reduction polynomial.
+    const uint64x2_t halves = vreinterpretq_u64_u8(tweak);
+    const int64x2_t signs = vshrq_n_s64(vreinterpretq_s64_u64(halves), 63);
+    const uint64x2_t polynomial = vcombine_u64(vcreate_u64(0x87), vcreate_u64(1));
+    const uint64x2_t carries = vandq_u64(vreinterpretq_u64_s64(vextq_s64(signs, signs, 1)),
+                                         polynomial);
+    return vreinterpretq_u8_u64(veorq_u64(vshlq_n_u64(halves, 1), carries));
+}
+
+CRYPTO_TARGET_ARM void Arm64XTS(const AESKeySchedule& ks, u8* tweak_bytes, const u8* in, u8* out,
+                                std::size_t num_blocks, bool decrypt) {
+    const Arm64RoundKeys rk(decrypt ? ks.dec : ks.enc);
+    uint8x16_t tweak = vld1q_u8(tweak_bytes);
+
+    std::size_t i = 0;
+    for (; i + AESInterleave <= num_blocks; i += AESInterleave) {
+        uint8x16_t tweaks[AESInterleave];
+        uint8x16_t blocks[AESInterleave];
+        for (std::size_t j = 0; j < AESInterleave; ++j) {
+            tweaks[j] = tweak;
+            blocks[j] = veorq_u8(vld1q_u8(in + (i + j) * AESBlockSize), tweak);
+            tweak = MultiplyTweak(tweak);
+        }
+        if (decrypt) {
+            DecryptBlocks4(rk, blocks);
+        } else {
+            EncryptBlocks4(rk, blocks);
+        }
+        for (std::size_t j = 0; j < AESInterleave; ++j) {
+            vst1q_u8(out + (i + j) * AESBlockSize, veorq_u8(blocks[j], tweaks[j]));
+        }
+    }
+    for (; i < num_blocks; ++i) {
+        const uint8x16_t block = veorq_u8(vld1q_u8(in + i * AESBlockSize), tweak);
+        const uint8x16_t result = decrypt ? DecryptBlock(rk, block) : EncryptBlock(rk, block);
+        vst1q_u8(out + i * AESBlockSize, veorq_u8(result, tweak));
+        tweak = MultiplyTweak(tweak);
+    }
+
+    vst1q_u8(tweak_bytes, tweak);
+}
+
+struct SHA256Arm64State {
+    uint32x4_t abcd;
+    uint32x4_t efgh;
+};
+
+/// Runs the 64 rounds of one block for each of the Streams states, the streams are independent
+/// so their SHA256H chains overlap in the pipeline.
+template <std::size_t Streams>
+CRYPTO_TARGET_ARM void SHA256Arm64Compress(SHA256Arm64State* states, const u8* const* data) {
+    SHA256Arm64State saved[Streams];
+    uint32x4_t w[Streams][4];
+    for (std::size_t s = 0; s < Streams; ++s) {
+        saved[s] = states[s];
+        for (std::size_t g = 0; g < 4; ++g) {
+            w[s][g] = vreinterpretq_u32_u8(vrev32q_u8(vld1q_u8(data[s] + g * 16)));
+        }
+    }
+
+    for (std::size_t g = 0; g < 16; ++g) {
+        const uint32x4_t k = vld1q_u32(SHA256RoundConstants.data() + g * 4);
+        for (std::size_t s = 0; s < Streams; ++s) {
+            uint32x4_t* ws = w[s];
+            const uint32x4_t wk = vaddq_u32(ws[g & 3], k);
+            if (g < 12) {
+                // Schedule W[g+4] while the rounds of W[g] run.
+                ws[g & 3] = vsha256su1q_u32(vsha256su0q_u32(ws[g & 3], ws[(g + 1) & 3]),
+                                            ws[(g + 2) & 3], ws[(g + 3) & 3]);
+            }
+            const uint32x4_t abcd = states[s].abcd;
+            states[s].abcd = vsha256hq_u32(abcd, states[s].efgh, wk);
+            states[s].efgh = vsha256h2q_u32(states[s].efgh, abcd, wk);
+        }
+    }
+
+    for (std::size_t s = 0; s < Streams; ++s) {
+        states[s].abcd = vaddq_u32(states[s].abcd, saved[s].abcd);
+        states[s].efgh = vaddq_u32(states[s].efgh, saved[s].efgh);
+    }
+}
+
+CRYPTO_TARGET_ARM void Arm64SHA256Blocks(u32* state, const u8* data, std::size_t num_blocks) {
+    SHA256Arm64State arm_state{vld1q_u32(state), vld1q_u32(state + 4)};
+    for (std::size_t i = 0; i < num_blocks; ++i, data += SHA256BlockSize) {
+        SHA256Arm64Compress<1>(&arm_state, &data);
+    }
+    vst1q_u32(state, arm_state.abcd);
+    vst1q_u32(state + 4, arm_state.efgh);
+}
+
+CRYPTO_TARGET_ARM void Arm64SHA256BlocksX2(u32* state_a, const u8* data_a, u32* state_b,
+                                           const u8* data_b, std::size_t num_blocks) {
+    SHA256Arm64State arm_states[2]{
+        {vld1q_u32(state_a), vld1q_u32(state_a + 4)},
+        {vld1q_u32(state_b), vld1q_u32(state_b + 4)},
+    };
+    const u8* data[2]{data_a, data_b};
+    for (std::size_t i = 0; i < num_blocks; ++i) {
+        SHA256Arm64Compress<2>(arm_states, data);
+        data[0] += SHA256BlockSize;
+        data[1] += SHA256BlockSize;
+    }
+    vst1q_u32(state_a, arm_states[0].abcd);
+    vst1q_u32(state_a + 4, arm_states[0].efgh);
+    vst1q_u32(state_b, arm_states[1].abcd);
+    vst1q_u32(state_b + 4, arm_states[1].efgh);
+}
+
+constexpr SHA256Kernels Arm64SHA256{
+    .name = "ARMv8 SHA2",
+    .blocks = Arm64SHA256Blocks,
+    .blocks_x2 = Arm64SHA256BlocksX2,
+};
+
+constexpr AESKernels Arm64AES{
+    .name = "ARMv8 AES",
+    .encrypt_ecb = Arm64EncryptECB,
+    .decrypt_ecb = Arm64DecryptECB,
+    .ctr = Arm64CTR,
+    .xts = Arm64XTS,
+};
+
+} // namespace
+
+const SHA256Kernels& GetArm64SHA256Kernels() {
+    return Arm64SHA256;
+}
+
+const AESKernels& GetArm64AESKernels() {
+    return Arm64AES;
+}
+
+} // namespace Core::Crypto
+
+#endif
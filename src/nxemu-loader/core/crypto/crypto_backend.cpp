@@ -0,0 +1,522 @@
+#include <cstring>
+
+#if defined(_M_X64) || defined(__x86_64__)
+#ifdef _MSC_VER
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#elif defined(_M_ARM64) || defined(__aarch64__)
+#ifdef _WIN32
+#include <windows.h>
+#elif defined(__linux__)
+#include <sys/auxv.h>
+#include <asm/hwcap.h>
+#endif
+#endif
+
+#include "yuzu_common/logging/log.h"
+#include "core/crypto/crypto_backend.h"
+
+namespace Core::Crypto {
+
+namespace {
+
+constexpr u8 GFMultiply(u8 a, u8 b) {
+    u8 result = 0;
+    while (b != 0) {
+        if (b & 1) {
+            result ^= a;
+        }
+        a = static_cast<u8>((a << 1) ^ ((a & 0x80) ? 0x1B : 0));
+        b >>= 1;
+    }
+    return result;
+}
+
+constexpr std::array<u8, 256> MakeSBox() {
+    // Powers of the generator 3 give the multiplicative inverse as exp[255 - log[x]].
+    std::array<u8, 256> exp{};
+    std::array<u8, 256> log{};
+    u8 power = 1;
+    for (u32 i = 0; i < 255; ++i) {
+        exp[i] = power;
+        log[power] = static_cast<u8>(i);
+        power = GFMultiply(power, 3);
+    }
+
+    std::array<u8, 256> sbox{};
+    for (u32 x = 0; x < 256; ++x) {
+        const u8 inverse = x == 0 ? 0 : exp[(255 - log[x]) % 255];
+        u8 value = inverse;
+        for (u32 shift = 1; shift < 5; ++shift) {
+            value ^= static_cast<u8>((inverse << shift) | (inverse >> (8 - shift)));
+        }
+        sbox[x] = static_cast<u8>(value ^ 0x63);
+    }
+    return sbox;
+}
+
+constexpr std::array<u8, 256> MakeInverseSBox(const std::array<u8, 256>& sbox) {
+    std::array<u8, 256> inverse{};
+    for (u32 x = 0; x < 256; ++x) {
+        inverse[sbox[x]] = static_cast<u8>(x);
+    }
+    return inverse;
+}
+
+constexpr std::array<u8, 256> SBox = MakeSBox();
+constexpr std::array<u8, 256> InverseSBox = MakeInverseSBox(SBox);
+static_assert(SBox[0x00] == 0x63 && SBox[0x53] == 0xED, "AES S-box generated incorrectly");
+
+void MixColumns(u8* state) {
+    for (std::size_t c = 0; c < 4; ++c) {
+        u8* col = state + c * 4;
+        const u8 a0 = col[0], a1 = col[1], a2 = col[2], a3 = col[3];
+        col[0] = GFMultiply(a0, 2) ^ GFMultiply(a1, 3) ^ a2 ^ a3;
+        col[1] = a0 ^ GFMultiply(a1, 2) ^ GFMultiply(a2, 3) ^ a3;
+        col[2] = a0 ^ a1 ^ GFMultiply(a2, 2) ^ GFMultiply(a3, 3);
+        col[3] = GFMultiply(a0, 3) ^ a1 ^ a2 ^ GFMultiply(a3, 2);
+    }
+}
+
+void InverseMixColumns(u8* state) {
+    for (std::size_t c = 0; c < 4; ++c) {
+        u8* col = state + c * 4;
+        const u8 a0 = col[0], a1 = col[1], a2 = col[2], a3 = col[3];
+        col[0] = GFMultiply(a0, 14) ^ GFMultiply(a1, 11) ^ GFMultiply(a2, 13) ^ GFMultiply(a3, 9);
+        col[1] = GFMultiply(a0, 9) ^ GFMultiply(a1, 14) ^ GFMultiply(a2, 11) ^ GFMultiply(a3, 13);
+        col[2] = GFMultiply(a0, 13) ^ GFMultiply(a1, 9) ^ GFMultiply(a2, 14) ^ GFMultiply(a3, 11);
+        col[3] = GFMultiply(a0, 11) ^ GFMultiply(a1, 13) ^ GFMultiply(a2, 9) ^ GFMultiply(a3, 14);
+    }
+}
+
+void XorBlock(u8* state, const u8* key) {
+    for (std::size_t i = 0; i < AESBlockSize; ++i) {
+        state[i] ^= key[i];
+    }
+}
+
+void PortableEncryptBlock(const AESKeySchedule& ks, const u8* in, u8* out) {
+    AESBlock state;
+    std::memcpy(state.data(), in, AESBlockSize);
+    XorBlock(state.data(), ks.enc[0].data());
+
+    for (std::size_t round = 1; round <= AES128Rounds; ++round) {
+        // SubBytes and ShiftRows, the state is stored column-major.
+        AESBlock shifted;
+        for (std::size_t c = 0; c < 4; ++c) {
+            for (std::size_t r = 0; r < 4; ++r) {
+                shifted[c * 4 + r] = SBox[state[((c + r) % 4) * 4 + r]];
+            }
+        }
+        state = shifted;
+        if (round != AES128Rounds) {
+            MixColumns(state.data());
+        }
+        XorBlock(state.data(), ks.enc[round].data());
+    }
+    std::memcpy(out, state.data(), AESBlockSize);
+}
+
+void PortableDecryptBlock(const AESKeySchedule& ks, const u8* in, u8* out) {
+    AESBlock state;
+    std::memcpy(state.data(), in, AESBlockSize);
+    XorBlock(state.data(), ks.dec[0].data());
+
+    for (std::size_t round = 1; round <= AES128Rounds; ++round) {
+        AESBlock shifted;
+        for (std::size_t c = 0; c < 4; ++c) {
+            for (std::size_t r = 0; r < 4; ++r) {
+                shifted[((c + r) % 4) * 4 + r] = InverseSBox[state[c * 4 + r]];
+            }
+        }
+        state = shifted;
+        if (round != AES128Rounds) {
+            InverseMixColumns(state.data());
+        }
+        XorBlock(state.data(), ks.dec[round].data());
+    }
+    std::memcpy(out, state.data(), AESBlockSize);
+}
+
+void PortableEncryptECB(const AESKeySchedule& ks, const u8* in, u8* out, std::size_t num_blocks) {
+    for (std::size_t i = 0; i < num_blocks; ++i) {
+        PortableEncryptBlock(ks, in + i * AESBlockSize, out + i * AESBlockSize);
+    }
+}
+
+void PortableDecryptECB(const AESKeySchedule& ks, const u8* in, u8* out, std::size_t num_blocks) {
+    for (std::size_t i = 0; i < num_blocks; ++i) {
+        PortableDecryptBlock(ks, in + i * AESBlockSize, out + i * AESBlockSize);
+    }
+}
+
+void IncrementCounter(u8* counter) {
+    for (std::size_t i = AESBlockSize; i-- > 0;) {
+        if (++counter[i] != 0) {
+            break;
+        }
+    }
+}
+
+void PortableCTR(const AESKeySchedule& ks, u8* counter, const u8* in, u8* out,
+                 std::size_t num_blocks) {
+    AESBlock keystream;
+    for (std::size_t i = 0; i < num_blocks; ++i) {
+        PortableEncryptBlock(ks, counter, keystream.data());
+        for (std::size_t j = 0; j < AESBlockSize; ++j) {
+            out[i * AESBlockSize + j] = in[i * AESBlockSize + j] ^ keystream[j];
+        }
+        IncrementCounter(counter);
+    }
+}
+
+void PortableXTS(const AESKeySchedule& ks, u8* tweak, const u8* in, u8* out,
+                 std::size_t num_blocks, bool decrypt) {
+    AESBlock block;
+    for (std::size_t i = 0; i < num_blocks; ++i) {
+        std::memcpy(block.data(), in + i * AESBlockSize, AESBlockSize);
+        XorBlock(block.data(), tweak);
+        if (decrypt) {
+            PortableDecryptBlock(ks, block.data(), block.data());
+        } else {
+            PortableEncryptBlock(ks, block.data(), block.data());
+        }
+        XorBlock(block.data(), tweak);
+        std::memcpy(out + i * AESBlockSize, block.data(), AESBlockSize);
+        XTSMultiplyTweak(tweak);
+    }
+}
+
+constexpr u32 RotateRight(u32 value, u32 shift) {
+    return (value >> shift) | (value << (32 - shift));
+}
+
+void PortableSHA256Blocks(u32* state, const u8* data, std::size_t num_blocks) {
+    for (std::size_t block = 0; block < num_blocks; ++block, data += SHA256BlockSize) {
+        std::array<u32, 64> w;
+        for (std::size_t i = 0; i < 16; ++i) {
+            w[i] = (u32{data[i * 4]} << 24) | (u32{data[i * 4 + 1]} << 16) |
+                   (u32{data[i * 4 + 2]} << 8) | u32{data[i * 4 + 3]};
+        }
+        for (std::size_t i = 16; i < 64; ++i) {
+            const u32 s0 = RotateRight(w[i - 15], 7) ^ RotateRight(w[i - 15], 18) ^ (w[i - 15] >> 3);
+            const u32 s1 = RotateRight(w[i - 2], 17) ^ RotateRight(w[i - 2], 19) ^ (w[i - 2] >> 10);
+            w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+        }
+
+        u32 a = state[0], b = state[1], c = state[2], d = state[3];
+        u32 e = state[4], f = state[5], g = state[6], h = state[7];
+        for (std::size_t i = 0; i < 64; ++i) {
+            const u32 s1 = RotateRight(e, 6) ^ RotateRight(e, 11) ^ RotateRight(e, 25);
+            const u32 ch = (e & f) ^ (~e & g);
+            const u32 t1 = h + s1 + ch + SHA256RoundConstants[i] + w[i];
+            const u32 s0 = RotateRight(a, 2) ^ RotateRight(a, 13) ^ RotateRight(a, 22);
+            const u32 maj = (a & b) ^ (a & c) ^ (b & c);
+            const u32 t2 = s0 + maj;
+            h = g;
+            g = f;
+            f = e;
+            e = d + t1;
+            d = c;
+            c = b;
+            b = a;
+            a = t1 + t2;
+        }
+        state[0] += a;
+        state[1] += b;
+        state[2] += c;
+        state[3] += d;
+        state[4] += e;
+        state[5] += f;
+        state[6] += g;
+        state[7] += h;
+    }
+}
+
+void PortableSHA256BlocksX2(u32* state_a, const u8* data_a, u32* state_b, const u8* data_b,
+                            std::size_t num_blocks) {
+    PortableSHA256Blocks(state_a, data_a, num_blocks);
+    PortableSHA256Blocks(state_b, data_b, num_blocks);
+}
+
+constexpr SHA256Kernels PortableSHA256{
+    .name = "portable",
+    .blocks = PortableSHA256Blocks,
+    .blocks_x2 = PortableSHA256BlocksX2,
+};
+
+constexpr AESKernels PortableAES{
+    .name = "portable",
+    .encrypt_ecb = PortableEncryptECB,
+    .decrypt_ecb = PortableDecryptECB,
+    .ctr = PortableCTR,
+    .xts = PortableXTS,
+};
+
+constexpr std::size_t SelfTestBlocks = 8;
+
+template <std::size_t Size>
+std::array<u8, Size> MakeSelfTestInput(u32 seed) {
+    std::array<u8, Size> data;
+    for (u8& value : data) {
+        seed = seed * 1664525 + 1013904223;
+        value = static_cast<u8>(seed >> 24);
+    }
+    return data;
+}
+
+// Checks an accelerated backend against the FIPS 180-2 "abc" digest, then against the portable
+// kernels on a few blocks so the multi-block and interleaved paths are covered too.
+bool SHA256SelfTest(const SHA256Kernels& kernels) {
+    constexpr std::array<u32, 8> initial_state{
+        0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+        0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19,
+    };
+    constexpr std::array<u32, 8> abc_digest{
+        0xba7816bf, 0x8f01cfea, 0x414140de, 0x5dae2223,
+        0xb00361a3, 0x96177a9c, 0xb410ff61, 0xf20015ad,
+    };
+    std::array<u8, SHA256BlockSize> abc_block{'a', 'b', 'c', 0x80};
+    abc_block[SHA256BlockSize - 1] = 24;
+    std::array<u32, 8> state{initial_state};
+    kernels.blocks(state.data(), abc_block.data(), 1);
+    if (state != abc_digest) {
+        return false;
+    }
+
+    const auto data_a = MakeSelfTestInput<SHA256BlockSize * SelfTestBlocks>(0x5A5A0001);
+    const auto data_b = MakeSelfTestInput<SHA256BlockSize * SelfTestBlocks>(0x5A5A0002);
+    std::array<u32, 8> expected_a{initial_state};
+    std::array<u32, 8> expected_b{initial_state};
+    PortableSHA256Blocks(expected_a.data(), data_a.data(), SelfTestBlocks);
+    PortableSHA256Blocks(expected_b.data(), data_b.data(), SelfTestBlocks);
+
+    std::array<u32, 8> state_a{initial_state};
+    std::array<u32, 8> state_b{initial_state};
+    kernels.blocks(state_a.data(), data_a.data(), SelfTestBlocks);
+    if (state_a != expected_a) {
+        return false;
+    }
+    state_a = initial_state;
+    kernels.blocks_x2(state_a.data(), data_a.data(), state_b.data(), data_b.data(),
+                      SelfTestBlocks);
+    return state_a == expected_a && state_b == expected_b;
+}
+
+// Checks an accelerated backend against the FIPS-197 appendix C.1 vector, then every mode
+// against the portable kernels, with a counter that carries across bytes.
+bool AESSelfTest(const AESKernels& kernels) {
+    constexpr AESBlock key{0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07,
+                           0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f};
+    constexpr AESBlock plaintext{0x00, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77,
+                                 0x88, 0x99, 0xaa, 0xbb, 0xcc, 0xdd, 0xee, 0xff};
+    constexpr AESBlock ciphertext{0x69, 0xc4, 0xe0, 0xd8, 0x6a, 0x7b, 0x04, 0x30,
+                                  0xd8, 0xcd, 0xb7, 0x80, 0x70, 0xb4, 0xc5, 0x5a};
+    AESKeySchedule ks;
+    ExpandAES128Key(key.data(), ks);
+    AESBlock block;
+    kernels.encrypt_ecb(ks, plaintext.data(), block.data(), 1);
+    if (block != ciphertext) {
+        return false;
+    }
+    kernels.decrypt_ecb(ks, ciphertext.data(), block.data(), 1);
+    if (block != plaintext) {
+        return false;
+    }
+
+    constexpr std::size_t size = AESBlockSize * SelfTestBlocks;
+    const auto input = MakeSelfTestInput<size>(0xA5A50001);
+    std::array<u8, size> expected;
+    std::array<u8, size> actual;
+
+    PortableEncryptECB(ks, input.data(), expected.data(), SelfTestBlocks);
+    kernels.encrypt_ecb(ks, input.data(), actual.data(), SelfTestBlocks);
+    if (actual != expected) {
+        return false;
+    }
+    PortableDecryptECB(ks, input.data(), expected.data(), SelfTestBlocks);
+    kernels.decrypt_ecb(ks, input.data(), actual.data(), SelfTestBlocks);
+    if (actual != expected) {
+        return false;
+    }
+
+    AESBlock expected_counter{};
+    expected_counter.fill(0xff);
+    expected_counter[0] = 0x01;
+    expected_counter[AESBlockSize - 1] = 0xfc;
+    AESBlock counter{expected_counter};
+    PortableCTR(ks, expected_counter.data(), input.data(), expected.data(), SelfTestBlocks);
+    kernels.ctr(ks, counter.data(), input.data(), actual.data(), SelfTestBlocks);
+    if (actual != expected || counter != expected_counter) {
+        return false;
+    }
+
+    for (const bool decrypt : {false, true}) {
+        AESBlock expected_tweak{0x80, 0x7f, 0x01, 0xfe, 0x33, 0xcc, 0x55, 0xaa,
+                                0x00, 0xff, 0x10, 0xef, 0x42, 0x24, 0x99, 0x80};
+        AESBlock tweak{expected_tweak};
+        PortableXTS(ks, expected_tweak.data(), input.data(), expected.data(), SelfTestBlocks,
+                    decrypt);
+        kernels.xts(ks, tweak.data(), input.data(), actual.data(), SelfTestBlocks, decrypt);
+        if (actual != expected || tweak != expected_tweak) {
+            return false;
+        }
+    }
+    return true;
+}
+
+const SHA256Kernels& DetectSHA256Kernels() {
+    [[maybe_unused]] const CPUCryptoFeatures& features = GetCPUCryptoFeatures();
+#ifdef CRYPTO_ARCH_X64
+    if (features.x64_sha) {
+        return GetX64SHA256Kernels();
+    }
+#elif defined(CRYPTO_ARCH_ARM64)
+    if (features.arm64_sha2) {
+        return GetArm64SHA256Kernels();
+    }
+#endif
+    return PortableSHA256;
+}
+
+const AESKernels& DetectAESKernels() {
+    [[maybe_unused]] const CPUCryptoFeatures& features = GetCPUCryptoFeatures();
+#ifdef CRYPTO_ARCH_X64
+    if (features.x64_aes) {
+        return GetX64AESKernels();
+    }
+#elif defined(CRYPTO_ARCH_ARM64)
+    if (features.arm64_aes) {
+        return GetArm64AESKernels();
+    }
+#endif
+    return PortableAES;
+}
+
+CPUCryptoFeatures DetectCPUCryptoFeatures() {
+    CPUCryptoFeatures features{};
+#ifdef CRYPTO_ARCH_X64
+    const auto cpuid = [](u32 leaf, u32 subleaf, std::array<u32, 4>& regs) {
+#ifdef _MSC_VER
+        int info[4];
+        __cpuidex(info, static_cast<int>(leaf), static_cast<int>(subleaf));
+        for (std::size_t i = 0; i < 4; ++i) {
+            regs[i] = static_cast<u32>(info[i]);
+        }
+#else
+        __cpuid_count(leaf, subleaf, regs[0], regs[1], regs[2], regs[3]);
+#endif
+    };
+
+    std::array<u32, 4> regs{};
+    cpuid(0, 0, regs);
+    const u32 max_leaf = regs[0];
+
+    cpuid(1, 0, regs);
+    const bool ssse3 = (regs[2] & (1U << 9)) != 0;
+    const bool sse41 = (regs[2] & (1U << 19)) != 0;
+    const bool aes = (regs[2] & (1U << 25)) != 0;
+    features.x64_aes = aes && sse41;
+    if (max_leaf >= 7) {
+        cpuid(7, 0, regs);
+        features.x64_sha = (regs[1] & (1U << 29)) != 0 && ssse3 && sse41;
+    }
+#elif defined(CRYPTO_ARCH_ARM64)
+#ifdef _WIN32
+    const bool crypto = IsProcessorFeaturePresent(PF_ARM_V8_CRYPTO_INSTRUCTIONS_AVAILABLE) != 0;
+    features.arm64_aes = crypto;
+    features.arm64_sha2 = crypto;
+#elif defined(__linux__)
+    const unsigned long hwcap = getauxval(AT_HWCAP);
+    features.arm64_aes = (hwcap & HWCAP_AES) != 0;
+    features.arm64_sha2 = (hwcap & HWCAP_SHA2) != 0;
+#elif defined(__APPLE__)
+    features.arm64_aes = true;
+    features.arm64_sha2 = true;
+#endif
+#endif
+    return features;
+}
+
+} // namespace
+
+void ExpandAES128Key(const u8* key, AESKeySchedule& out) {
+    constexpr std::array<u8, AES128Rounds> round_constants{0x01, 0x02, 0x04, 0x08, 0x10,
+                                                           0x20, 0x40, 0x80, 0x1B, 0x36};
+
+    std::memcpy(out.enc[0].data(), key, AESBlockSize);
+    for (std::size_t round = 1; round <= AES128Rounds; ++round) {
+        const AESBlock& prev = out.enc[round - 1];
+        AESBlock& next = out.enc[round];
+
+        // RotWord, SubWord and the round constant applied to the last word of the previous key.
+        std::array<u8, 4> temp{SBox[prev[13]], SBox[prev[14]], SBox[prev[15]], SBox[prev[12]]};
+        temp[0] ^= round_constants[round - 1];
+        for (std::size_t i = 0; i < AESBlockSize; ++i) {
+            next[i] = prev[i] ^ (i < 4 ? temp[i] : next[i - 4]);
+        }
+    }
+
+    out.dec[0] = out.enc[AES128Rounds];
+    for (std::size_t round = 1; round < AES128Rounds; ++round) {
+        out.dec[round] = out.enc[AES128Rounds - round];
+        InverseMixColumns(out.dec[round].data());
+    }
+    out.dec[AES128Rounds] = out.enc[0];
+}
+
+void XTSMultiplyTweak(u8* tweak) {
+    // The tweak is a little endian 128-bit value, reduced by x^128 + x^7 + x^2 + x + 1.
+    u8 carry = 0;
+    for (std::size_t i = 0; i < AESBlockSize; ++i) {
+        const u8 next_carry = tweak[i] >> 7;
+        tweak[i] = static_cast<u8>((tweak[i] << 1) | carry);
+        carry = next_carry;
+    }
+    if (carry != 0) {
+        tweak[0] ^= 0x87;
+    }
+}
+
+const CPUCryptoFeatures& GetCPUCryptoFeatures() {
+    static const CPUCryptoFeatures features = DetectCPUCryptoFeatures();
+    return features;
+}
+
+const SHA256Kernels& GetPortableSHA256Kernels() {
+    return PortableSHA256;
+}
+
+const AESKernels& GetPortableAESKernels() {
+    return PortableAES;
+}
+
+const SHA256Kernels& GetSHA256Kernels() {
+    static const SHA256Kernels& kernels = []() -> const SHA256Kernels& {
+        const SHA256Kernels& detected = DetectSHA256Kernels();
+        if (&detected != &PortableSHA256 && !SHA256SelfTest(detected)) {
+            LOG_ERROR(Crypto, "{} SHA-256 failed its self-test, using the portable kernels",
+                      detected.name);
+            return PortableSHA256;
+        }
+        return detected;
+    }();
+    return kernels;
+}
+
+const AESKernels& GetAESKernels() {
+    static const AESKernels& kernels = []() -> const AESKernels& {
+        const AESKernels& detected = DetectAESKernels();
+        if (&detected != &PortableAES && !AESSelfTest(detected)) {
+            LOG_ERROR(Crypto, "{} AES failed its self-test, using the portable kernels",
+                      detected.name);
+            return PortableAES;
+        }
+        return detected;
+    }();
+    return kernels;
+}
+
+} // namespace Core::Crypto
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include "yuzu_common/common_types.h"
+
+#if defined(_M_X64) || defined(__x86_64__)
+#define CRYPTO_ARCH_X64 1
+#elif defined(_M_ARM64) || defined(__aarch64__)
+#define CRYPTO_ARCH_ARM64 1
+#endif
+
+namespace Core::Crypto {
+
+constexpr std::size_t AESBlockSize = 0x10;
+constexpr std::size_t AES128Rounds = 10;
+constexpr std::size_t SHA256BlockSize = 0x40;
+
+using AESBlock = std::array<u8, AESBlockSize>;
+
+inline constexpr std::array<u32, 64> SHA256RoundConstants{
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2,
+};
+
+/// Expanded AES-128 key. The decryption schedule is the one of the equivalent inverse cipher
+/// (round keys reversed, InvMixColumns applied to the inner ones), which is the layout both AES-NI
+/// and the ARMv8 crypto extension expect.
+struct AESKeySchedule {
+    std::array<AESBlock, AES128Rounds + 1> enc;
+    std::array<AESBlock, AES128Rounds + 1> dec;
+};
+
+void ExpandAES128Key(const u8* key, AESKeySchedule& out);
+
+/// Multiplies an XTS tweak by the primitive element of GF(2^128).
+void XTSMultiplyTweak(u8* tweak);
+
+struct SHA256Kernels {
+    const char* name;
+    /// Compresses num_blocks consecutive 64 byte blocks into state.
+    void (*blocks)(u32* state, const u8* data, std::size_t num_blocks);
+    /// Compresses two independent streams of num_blocks blocks, interleaving them where the
+    /// backend can hide the latency of one stream behind the other.
+    void (*blocks_x2)(u32* state_a, const u8* data_a, u32* state_b, const u8* data_b,
+                      std::size_t num_blocks);
+};
+
+struct AESKernels {
+    const char* name;
+    void (*encrypt_ecb)(const AESKeySchedule& ks, const u8* in, u8* out, std::size_t num_blocks);
+    void (*decrypt_ecb)(const AESKeySchedule& ks, const u8* in, u8* out, std::size_t num_blocks);
+    /// Big endian 128-bit counter mode, counter is advanced by num_blocks.
+    void (*ctr)(const AESKeySchedule& ks, u8* counter, const u8* in, u8* out,
+                std::size_t num_blocks);
+    /// Transcodes num_blocks of one XTS sector, tweak holds the encrypted sector tweak and is
+    /// advanced by num_blocks.
+    void (*xts)(const AESKeySchedule& ks, u8* tweak, const u8* in, u8* out, std::size_t num_blocks,
+                bool decrypt);
+};
+
+struct CPUCryptoFeatures {
+    bool x64_aes;
+    bool x64_sha;
+    bool arm64_aes;
+    bool arm64_sha2;
+};
+
+const CPUCryptoFeatures& GetCPUCryptoFeatures();
+
+const SHA256Kernels& GetPortableSHA256Kernels();
+const AESKernels& GetPortableAESKernels();
+
+/// Returns the kernels selected for the host CPU, detected once on first use. An accelerated
+/// backend that fails its known-answer self-test is replaced by the portable kernels.
+const SHA256Kernels& GetSHA256Kernels();
+const AESKernels& GetAESKernels();
+
+#ifdef CRYPTO_ARCH_X64
+const SHA256Kernels& GetX64SHA256Kernels();
+const AESKernels& GetX64AESKernels();
+#endif
+
+#ifdef CRYPTO_ARCH_ARM64
+const SHA256Kernels& GetArm64SHA256Kernels();
+const AESKernels& GetArm64AESKernels();
+#endif
+
+} // namespace Core::Crypto
@@ -0,0 +1,196 @@
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+#include "yuzu_common/logging/log.h"
+#include "core/crypto/crypto_backend.h"
+#include "core/crypto/crypto_benchmark.h"
+
+namespace Core::Crypto {
+
+namespace {
+
+/// Block size of the hash trees in NCA sections, used to shape the multi-buffer run.
+constexpr std::size_t HashTreeBlockSize = 0x4000;
+/// Sector size of the XTS encrypted NCA header.
+constexpr std::size_t XTSSectorSize = 0x200;
+/// Prefix of the buffer compared between the portable and the selected backend.
+constexpr std::size_t ReferenceSize = 0x10000;
+constexpr std::size_t ChunkSize = 0x100000;
+constexpr std::chrono::milliseconds MeasureTime{200};
+
+struct BenchmarkKeys {
+    AESKeySchedule data;
+    AESKeySchedule tweak;
+
+    BenchmarkKeys() {
+        std::array<u8, 0x10> key;
+        for (std::size_t i = 0; i < key.size(); ++i) {
+            key[i] = static_cast<u8>(i * 0x11);
+        }
+        ExpandAES128Key(key.data(), data);
+        std::reverse(key.begin(), key.end());
+        ExpandAES128Key(key.data(), tweak);
+    }
+};
+
+const BenchmarkKeys& GetBenchmarkKeys() {
+    static const BenchmarkKeys keys;
+    return keys;
+}
+
+constexpr std::array<u32, 8> InitialState{
+    0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19,
+};
+
+void RunSHA256(const SHA256Kernels& sha, const AESKernels&, const u8* in, u8* out,
+               std::size_t size) {
+    std::array<u32, 8> state{InitialState};
+    sha.blocks(state.data(), in, size / SHA256BlockSize);
+    std::memcpy(out, state.data(), sizeof(state));
+}
+
+void RunSHA256Multi(const SHA256Kernels& sha, const AESKernels&, const u8* in, u8* out,
+                    std::size_t size) {
+    const std::size_t num_blocks = HashTreeBlockSize / SHA256BlockSize;
+    for (std::size_t offset = 0; offset + HashTreeBlockSize * 2 <= size;
+         offset += HashTreeBlockSize * 2) {
+        std::array<u32, 8> state_a{InitialState};
+        std::array<u32, 8> state_b{InitialState};
+        sha.blocks_x2(state_a.data(), in + offset, state_b.data(), in + offset + HashTreeBlockSize,
+                      num_blocks);
+        std::memcpy(out + offset / HashTreeBlockSize * sizeof(state_a), state_a.data(),
+                    sizeof(state_a));
+        std::memcpy(out + offset / HashTreeBlockSize * sizeof(state_a) + sizeof(state_a),
+                    state_b.data(), sizeof(state_b));
+    }
+}
+
+void RunAESECB(const SHA256Kernels&, const AESKernels& aes, const u8* in, u8* out,
+               std::size_t size) {
+    aes.decrypt_ecb(GetBenchmarkKeys().data, in, out, size / AESBlockSize);
+}
+
+void RunAESCTR(const SHA256Kernels&, const AESKernels& aes, const u8* in, u8* out,
+               std::size_t size) {
+    AESBlock counter{};
+    aes.ctr(GetBenchmarkKeys().data, counter.data(), in, out, size / AESBlockSize);
+}
+
+void RunAESXTS(const SHA256Kernels&, const AESKernels& aes, const u8* in, u8* out,
+               std::size_t size) {
+    const BenchmarkKeys& keys = GetBenchmarkKeys();
+    for (std::size_t offset = 0; offset + XTSSectorSize <= size; offset += XTSSectorSize) {
+        AESBlock tweak{};
+        const std::size_t sector = offset / XTSSectorSize;
+        for (std::size_t i = 0; i < sizeof(sector); ++i) {
+            tweak[AESBlockSize - 1 - i] = static_cast<u8>(sector >> (i * 8));
+        }
+        aes.encrypt_ecb(keys.tweak, tweak.data(), tweak.data(), 1);
+        aes.xts(keys.data, tweak.data(), in + offset, out + offset, XTSSectorSize / AESBlockSize,
+                true);
+    }
+}
+
+struct Primitive {
+    const char* name;
+    bool uses_aes;
+    void (*run)(const SHA256Kernels& sha, const AESKernels& aes, const u8* in, u8* out,
+                std::size_t size);
+};
+
+constexpr std::array<Primitive, 5> Primitives{{
+    {"SHA-256", false, RunSHA256},
+    {"SHA-256 multi-buffer", false, RunSHA256Multi},
+    {"AES-128-ECB decrypt", true, RunAESECB},
+    {"AES-128-CTR", true, RunAESCTR},
+    {"AES-128-XTS decrypt", true, RunAESXTS},
+}};
+
+double MeasureThroughput(const Primitive& primitive, const SHA256Kernels& sha,
+                         const AESKernels& aes, const std::vector<u8>& in, std::vector<u8>& out) {
+    const std::size_t chunk = std::min(ChunkSize, in.size());
+    const auto start = std::chrono::steady_clock::now();
+    std::chrono::steady_clock::duration elapsed{};
+    std::size_t processed = 0;
+    std::size_t offset = 0;
+    do {
+        if (offset + chunk > in.size()) {
+            offset = 0;
+        }
+        primitive.run(sha, aes, in.data() + offset, out.data() + offset, chunk);
+        processed += chunk;
+        offset += chunk;
+        elapsed = std::chrono::steady_clock::now() - start;
+    } while (elapsed < MeasureTime);
+
+    const double seconds = std::chrono::duration<double>(elapsed).count();
+    return static_cast<double>(processed) / seconds / 1e9;
+}
+
+} // namespace
+
+std::vector<CryptoBenchmarkResult> RunCryptoBenchmark(std::size_t buffer_size) {
+    buffer_size = std::max(buffer_size, ReferenceSize) & ~(HashTreeBlockSize * 2 - 1);
+
+    std::vector<u8> input(buffer_size);
+    u32 seed = 0x12345678;
+    for (u8& value : input) {
+        seed = seed * 1664525 + 1013904223;
+        value = static_cast<u8>(seed >> 24);
+    }
+    std::vector<u8> output(buffer_size);
+
+    const SHA256Kernels& portable_sha = GetPortableSHA256Kernels();
+    const AESKernels& portable_aes = GetPortableAESKernels();
+    const SHA256Kernels& selected_sha = GetSHA256Kernels();
+    const AESKernels& selected_aes = GetAESKernels();
+
+    std::vector<CryptoBenchmarkResult> results;
+    for (const Primitive& primitive : Primitives) {
+        const bool accelerated =
+            primitive.uses_aes ? &selected_aes != &portable_aes : &selected_sha != &portable_sha;
+
+        bool matches = true;
+        if (accelerated) {
+            std::vector<u8> reference(ReferenceSize);
+            std::vector<u8> candidate(ReferenceSize);
+            primitive.run(portable_sha, portable_aes, input.data(), reference.data(),
+                          ReferenceSize);
+            primitive.run(selected_sha, selected_aes, input.data(), candidate.data(),
+                          ReferenceSize);
+            matches = reference == candidate;
+        }
+
+        results.push_back({
+            .primitive = primitive.name,
+            .backend = primitive.uses_aes ? portable_aes.name : portable_sha.name,
+            .gigabytes_per_second =
+                MeasureThroughput(primitive, portable_sha, portable_aes, input, output),
+            .matches_reference = true,
+        });
+        if (accelerated) {
+            results.push_back({
+                .primitive = primitive.name,
+                .backend = primitive.uses_aes ? selected_aes.name : selected_sha.name,
+                .gigabytes_per_second =
+                    MeasureThroughput(primitive, selected_sha, selected_aes, input, output),
+                .matches_reference = matches,
+            });
+        }
+    }
+    return results;
+}
+
+void LogCryptoBenchmark() {
+    for (const CryptoBenchmarkResult& result : RunCryptoBenchmark()) {
+        if (!result.matches_reference) {
+            LOG_ERROR(Crypto, "{} ({}) output does not match the portable implementation",
+                      result.primitive, result.backend);
+        }
+        LOG_INFO(Crypto, "{} ({}): {:.2f} GB/s", result.primitive, result.backend,
+                 result.gigabytes_per_second);
+    }
+}
+
+} // namespace Core::Crypto
@@ -0,0 +1,22 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+namespace Core::Crypto {
+
+struct CryptoBenchmarkResult {
+    std::string primitive;
+    std::string backend;
+    double gigabytes_per_second;
+    /// Whether the output matched the portable implementation on the same input.
+    bool matches_reference;
+};
+
+/// Measures every primitive with the portable and the selected backend over buffer_size bytes.
+std::vector<CryptoBenchmarkResult> RunCryptoBenchmark(std::size_t buffer_size = 0x2000000);
+
+/// Runs the benchmark and writes its results to the log.
+void LogCryptoBenchmark();
+
+} // namespace Core::Crypto
@@ -0,0 +1,326 @@
+#include "core/crypto/crypto_backend.h"
+
+#ifdef CRYPTO_ARCH_X64
+
+#include <immintrin.h>
+
+// MSVC exposes every intrinsic unconditionally, GCC and Clang need the ISA enabled per function
+// so the rest of the module keeps its baseline target.
+#ifdef _MSC_VER
+#define CRYPTO_TARGET_AES
+#define CRYPTO_TARGET_SHA
+#else
+#define CRYPTO_TARGET_AES __attribute__((target("sse4.1,aes")))
+#define CRYPTO_TARGET_SHA __attribute__((target("ssse3,sse4.1,sha")))
+#endif
+
+namespace Core::Crypto {
+
+namespace {
+
+/// Blocks processed together to keep the AES units pipelined.
+constexpr std::size_t AESInterleave = 4;
+
+struct X64RoundKeys {
+    std::array<__m128i, AES128Rounds + 1> keys;
+
+    explicit X64RoundKeys(const std::array<AESBlock, AES128Rounds + 1>& schedule) {
+        for (std::size_t i = 0; i <= AES128Rounds; ++i) {
+            keys[i] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(schedule[i].data()));
+        }
+    }
+};
+
+CRYPTO_TARGET_AES __m128i EncryptBlock(const X64RoundKeys& rk, __m128i block) {
+    block = _mm_xor_si128(block, rk.keys[0]);
+    for (std::size_t i = 1; i < AES128Rounds; ++i) {
+        block = _mm_aesenc_si128(block, rk.keys[i]);
+    }
+    return _mm_aesenclast_si128(block, rk.keys[AES128Rounds]);
+}
+
+CRYPTO_TARGET_AES __m128i DecryptBlock(const X64RoundKeys& rk, __m128i block) {
+    block = _mm_xor_si128(block, rk.keys[0]);
+    for (std::size_t i = 1; i < AES128Rounds; ++i) {
+        block = _mm_aesdec_si128(block, rk.keys[i]);
+    }
+    return _mm_aesdeclast_si128(block, rk.keys[AES128Rounds]);
+}
+
+CRYPTO_TARGET_AES void EncryptBlocks4(const X64RoundKeys& rk, __m128i* blocks) {
+    for (std::size_t j = 0; j < AESInterleave; ++j) {
+        blocks[j] = _mm_xor_si128(blocks[j], rk.keys[0]);
+    }
+    for (std::size_t i = 1; i < AES128Rounds; ++i) {
+        for (std::size_t j = 0; j < AESInterleave; ++j) {
+            blocks[j] = _mm_aesenc_si128(blocks[j], rk.keys[i]);
+        }
+    }
+    for (std::size_t j = 0; j < AESInterleave; ++j) {
+        blocks[j] = _mm_aesenclast_si128(blocks[j], rk.keys[AES128Rounds]);
+    }
+}
+
+CRYPTO_TARGET_AES void DecryptBlocks4(const X64RoundKeys& rk, __m128i* blocks) {
+    for (std::size_t j = 0; j < AESInterleave; ++j) {
+        blocks[j] = _mm_xor_si128(blocks[j], rk.keys[0]);
+    }
+    for (std::size_t i = 1; i < AES128Rounds; ++i) {
+        for (std::size_t j = 0; j < AESInterleave; ++j) {
+            blocks[j] = _mm_aesdec_si128(blocks[j], rk.keys[i]);
+        }
+    }
+    for (std::size_t j = 0; j < AESInterleave; ++j) {
+        blocks[j] = _mm_aesdeclast_si128(blocks[j], rk.keys[AES128Rounds]);
+    }
+}
+
+CRYPTO_TARGET_AES void X64EncryptECB(const AESKeySchedule& ks, const u8* in, u8* out,
+                                     std::size_t num_blocks) {
+    const X64RoundKeys rk(ks.enc);
+    const auto* src = reinterpret_cast<const __m128i*>(in);
+    auto* dst = reinterpret_cast<__m128i*>(out);
+
+    std::size_t i = 0;
+    for (; i + AESInterleave <= num_blocks; i += AESInterleave) {
+        __m128i blocks[AESInterleave];
+        for (std::size_t j = 0; j < AESInterleave; ++j) {
+            blocks[j] = _mm_loadu_si128(src + i + j);
+        }
+        EncryptBlocks4(rk, blocks);
+        for (std::size_t j = 0; j < AESInterleave; ++j) {
+            _mm_storeu_si128(dst + i + j, blocks[j]);
+        }
+    }
+    for (; i < num_blocks; ++i) {
+        _mm_storeu_si128(dst + i, EncryptBlock(rk, _mm_loadu_si128(src + i)));
+    }
+}
+
+CRYPTO_TARGET_AES void X64DecryptECB(const AESKeySchedule& ks, const u8* in, u8* out,
+                                     std::size_t num_blocks) {
+    const X64RoundKeys rk(ks.dec);
+    const auto* src = reinterpret_cast<const __m128i*>(in);
+    auto* dst = reinterpret_cast<__m128i*>(out);
+
+    std::size_t i = 0;
+    for (; i + AESInterleave <= num_blocks; i += AESInterleave) {
+        __m128i blocks[AESInterleave];
+        for (std::size_t j = 0; j < AESInterleave; ++j) {
+            blocks[j] = _mm_loadu_si128(src + i + j);
+        }
+        DecryptBlocks4(rk, blocks);
+        for (std::size_t j = 0; j < AESInterleave; ++j) {
+            _mm_storeu_si128(dst + i + j, blocks[j]);
+        }
+    }
+    for (; i < num_blocks; ++i) {
+        _mm_storeu_si128(dst + i, DecryptBlock(rk, _mm_loadu_si128(src + i)));
+    }
+}
+
+struct X64Counter {
+    // Big endian 128-bit counter split in two native 64-bit halves.
+    u64 hi;
+    u64 lo;
+};
+
+CRYPTO_TARGET_AES __m128i NextCounterBlock(X64Counter& counter) {
+    const __m128i byte_swap = _mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+    const __m128i value = _mm_shuffle_epi8(
+        _mm_set_epi64x(static_cast<s64>(counter.hi), static_cast<s64>(counter.lo)), byte_swap);
+    if (++counter.lo == 0) {
+        ++counter.hi;
+    }
+    return value;
+}
+
+CRYPTO_TARGET_AES void X64CTR(const AESKeySchedule& ks, u8* counter_bytes, const u8* in, u8* out,
+                              std::size_t num_blocks) {
+    const X64RoundKeys rk(ks.enc);
+    const auto* src = reinterpret_cast<const __m128i*>(in);
+    auto* dst = reinterpret_cast<__m128i*>(out);
+
+    X64Counter counter{};
+    for (std::size_t i = 0; i < 8; ++i) {
+        counter.hi = (counter.hi << 8) | counter_bytes[i];
+        counter.lo = (counter.lo << 8) | counter_bytes[8 + i];
+    }
+
+    std::size_t i = 0;
+    for (; i + AESInterleave <= num_blocks; i += AESInterleave) {
+        __m128i blocks[AESInterleave];
+        for (std::size_t j = 0; j < AESInterleave; ++j) {
+            blocks[j] = NextCounterBlock(counter);
+        }
+        EncryptBlocks4(rk, blocks);
+        for (std::size_t j = 0; j < AESInterleave; ++j) {
+            _mm_storeu_si128(dst + i + j, _mm_xor_si128(blocks[j], _mm_loadu_si128(src + i + j)));
+        }
+    }
+    for (; i < num_blocks; ++i) {
+        const __m128i keystream = EncryptBlock(rk, NextCounterBlock(counter));
+        _mm_storeu_si128(dst + i, _mm_xor_si128(keystream, _mm_loadu_si128(src + i)));
+    }
+
+    for (std::size_t j = 0; j < 8; ++j) {
+        counter_bytes[7 - j] = static_cast<u8>(counter.hi >> (j * 8));
+        counter_bytes[15 - j] = static_cast<u8>(counter.lo >> (j * 8));
+    }
+}
+
+CRYPTO_TARGET_AES __m128i MultiplyTweak(__m128i tweak) {
+    // Shift each 64-bit half left by one, moving bit 63 into bit 64 and folding bit 127 back in
+    // as the reduction polynomial.
+    const __m128i carries = _mm_srai_epi32(_mm_shuffle_epi32(tweak, 0x13), 31);
+    const __m128i polynomial = _mm_set_epi32(0, 1, 0, 0x87);
+    return _mm_xor_si128(_mm_slli_epi64(tweak, 1), _mm_and_si128(carries, polynomial));
+}
+
+CRYPTO_TARGET_AES void X64XTS(const AESKeySchedule& ks, u8* tweak_bytes, const u8* in, u8* out,
+                              std::size_t num_blocks, bool decrypt) {
+    const X64RoundKeys rk(decrypt ? ks.dec : ks.enc);
+    const auto* src = reinterpret_cast<const __m128i*>(in);
+    auto* dst = reinterpret_cast<__m128i*>(out);
+    __m128i tweak = _mm_loadu_si128(reinterpret_cast<const __m128i*>(tweak_bytes));
+
+    std::size_t i = 0;
+    for (; i + AESInterleave <= num_blocks; i += AESInterleave) {
+        __m128i tweaks[AESInterleave];
+        __m128i blocks[AESInterleave];
+        for (std::size_t j = 0; j < AESInterleave; ++j) {
+            tweaks[j] = tweak;
+            blocks[j] = _mm_xor_si128(_mm_loadu_si128(src + i + j), tweak);
+            tweak = MultiplyTweak(tweak);
+        }
+        if (decrypt) {
+            DecryptBlocks4(rk, blocks);
+        } else {
+            EncryptBlocks4(rk, blocks);
+        }
+        for (std::size_t j = 0; j < AESInterleave; ++j) {
+            _mm_storeu_si128(dst + i + j, _mm_xor_si128(blocks[j], tweaks[j]));
+        }
+    }
+    for (; i < num_blocks; ++i) {
+        const __m128i block = _mm_xor_si128(_mm_loadu_si128(src + i), tweak);
+        const __m128i result = decrypt ? DecryptBlock(rk, block) : EncryptBlock(rk, block);
+        _mm_storeu_si128(dst + i, _mm_xor_si128(result, tweak));
+        tweak = MultiplyTweak(tweak);
+    }
+
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(tweak_bytes), tweak);
+}
+
+struct SHA256X64State {
+    __m128i abef;
+    __m128i cdgh;
+};
+
+CRYPTO_TARGET_SHA SHA256X64State LoadSHA256State(const u32* state) {
+    // SHA-NI keeps the working variables as ABEF and CDGH.
+    const __m128i abcd = _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(state)),
+                                           0xB1);
+    const __m128i efgh =
+        _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(state + 4)), 0x1B);
+    return {
+        .abef = _mm_alignr_epi8(abcd, efgh, 8),
+        .cdgh = _mm_blend_epi16(efgh, abcd, 0xF0),
+    };
+}
+
+CRYPTO_TARGET_SHA void StoreSHA256State(const SHA256X64State& in, u32* state) {
+    const __m128i feba = _mm_shuffle_epi32(in.abef, 0x1B);
+    const __m128i dchg = _mm_shuffle_epi32(in.cdgh, 0xB1);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(state), _mm_blend_epi16(feba, dchg, 0xF0));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(state + 4), _mm_alignr_epi8(dchg, feba, 8));
+}
+
+/// Runs the 64 rounds of one block for each of the Streams states, the streams are independent
+/// so their sha256rnds2 chains overlap in the pipeline.
+template <std::size_t Streams>
+CRYPTO_TARGET_SHA void SHA256X64Compress(SHA256X64State* states, const u8* const* data) {
+    const __m128i byte_swap = _mm_set_epi64x(0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL);
+
+    SHA256X64State saved[Streams];
+    __m128i w[Streams][4];
+    for (std::size_t s = 0; s < Streams; ++s) {
+        saved[s] = states[s];
+        for (std::size_t g = 0; g < 4; ++g) {
+            w[s][g] = _mm_shuffle_epi8(
+                _mm_loadu_si128(reinterpret_cast<const __m128i*>(data[s] + g * 16)), byte_swap);
+        }
+    }
+
+    for (std::size_t g = 0; g < 16; ++g) {
+        const __m128i k =
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(SHA256RoundConstants.data() + g * 4));
+        for (std::size_t s = 0; s < Streams; ++s) {
+            __m128i* ws = w[s];
+            if (g >= 4) {
+                // W[g] = msg2(msg1(W[g-4], W[g-3]) + W[g-2..g-1] >> 1 word, W[g-1])
+                __m128i next = _mm_sha256msg1_epu32(ws[g & 3], ws[(g + 1) & 3]);
+                next = _mm_add_epi32(next, _mm_alignr_epi8(ws[(g + 3) & 3], ws[(g + 2) & 3], 4));
+                ws[g & 3] = _mm_sha256msg2_epu32(next, ws[(g + 3) & 3]);
+            }
+            __m128i msg = _mm_add_epi32(ws[g & 3], k);
+            states[s].cdgh = _mm_sha256rnds2_epu32(states[s].cdgh, states[s].abef, msg);
+            msg = _mm_shuffle_epi32(msg, 0x0E);
+            states[s].abef = _mm_sha256rnds2_epu32(states[s].abef, states[s].cdgh, msg);
+        }
+    }
+
+    for (std::size_t s = 0; s < Streams; ++s) {
+        states[s].abef = _mm_add_epi32(states[s].abef, saved[s].abef);
+        states[s].cdgh = _mm_add_epi32(states[s].cdgh, saved[s].cdgh);
+    }
+}
+
+CRYPTO_TARGET_SHA void X64SHA256Blocks(u32* state, const u8* data, std::size_t num_blocks) {
+    SHA256X64State x64_state = LoadSHA256State(state);
+    for (std::size_t i = 0; i < num_blocks; ++i, data += SHA256BlockSize) {
+        SHA256X64Compress<1>(&x64_state, &data);
+    }
+    StoreSHA256State(x64_state, state);
+}
+
+CRYPTO_TARGET_SHA void X64SHA256BlocksX2(u32* state_a, const u8* data_a, u32* state_b,
+                                         const u8* data_b, std::size_t num_blocks) {
+    SHA256X64State x64_states[2]{LoadSHA256State(state_a), LoadSHA256State(state_b)};
+    const u8* data[2]{data_a, data_b};
+    for (std::size_t i = 0; i < num_blocks; ++i) {
+        SHA256X64Compress<2>(x64_states, data);
+        data[0] += SHA256BlockSize;
+        data[1] += SHA256BlockSize;
+    }
+    StoreSHA256State(x64_states[0], state_a);
+    StoreSHA256State(x64_states[1], state_b);
+}
+
+constexpr SHA256Kernels X64SHA256{
+    .name = "SHA-NI",
+    .blocks = X64SHA256Blocks,
+    .blocks_x2 = X64SHA256BlocksX2,
+};
+
+constexpr AESKernels X64AES{
+    .name = "AES-NI",
+    .encrypt_ecb = X64EncryptECB,
+    .decrypt_ecb = X64DecryptECB,
+    .ctr = X64CTR,
+    .xts = X64XTS,
+};
+
+} // namespace
+
+const SHA256Kernels& GetX64SHA256Kernels() {
+    return X64SHA256;
+}
+
+const AESKernels& GetX64AESKernels() {
+    return X64AES;
+}
+
+} // namespace Core::Crypto
+
+#endif
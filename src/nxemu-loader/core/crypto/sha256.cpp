@@ -0,0 +1,134 @@
+#include <algorithm>
+#include <cstring>
+
+#include "yuzu_common/yuzu_assert.h"
+#include "core/crypto/crypto_backend.h"
+#include "core/crypto/sha256.h"
+
+namespace Core::Crypto {
+
+namespace {
+
+constexpr std::array<u32, 8> SHA256InitialState{
+    0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19,
+};
+
+SHA256Hash StateToHash(const std::array<u32, 8>& state) {
+    SHA256Hash hash;
+    for (std::size_t i = 0; i < state.size(); ++i) {
+        hash[i * 4] = static_cast<u8>(state[i] >> 24);
+        hash[i * 4 + 1] = static_cast<u8>(state[i] >> 16);
+        hash[i * 4 + 2] = static_cast<u8>(state[i] >> 8);
+        hash[i * 4 + 3] = static_cast<u8>(state[i]);
+    }
+    return hash;
+}
+
+/// Writes the final block(s) of a message of total_size bytes whose last tail_size bytes are at
+/// tail, returning the number of blocks written to out.
+std::size_t BuildFinalBlocks(const u8* tail, std::size_t tail_size, u64 total_size,
+                             std::array<u8, SHA256BlockSize * 2>& out) {
+    const std::size_t num_blocks = tail_size + 9 > SHA256BlockSize ? 2 : 1;
+    std::memset(out.data(), 0, num_blocks * SHA256BlockSize);
+    std::memcpy(out.data(), tail, tail_size);
+    out[tail_size] = 0x80;
+
+    const u64 total_bits = total_size * 8;
+    u8* length = out.data() + num_blocks * SHA256BlockSize - 8;
+    for (std::size_t i = 0; i < 8; ++i) {
+        length[i] = static_cast<u8>(total_bits >> (56 - i * 8));
+    }
+    return num_blocks;
+}
+
+} // namespace
+
+SHA256Context::SHA256Context() : state{SHA256InitialState} {}
+
+void SHA256Context::Update(std::span<const u8> data) {
+    const SHA256Kernels& kernels = GetSHA256Kernels();
+    total_size += data.size();
+
+    if (buffered != 0) {
+        const std::size_t fill = std::min(data.size(), buffer.size() - buffered);
+        std::memcpy(buffer.data() + buffered, data.data(), fill);
+        buffered += fill;
+        data = data.subspan(fill);
+        if (buffered < buffer.size()) {
+            return;
+        }
+        kernels.blocks(state.data(), buffer.data(), 1);
+        buffered = 0;
+    }
+
+    const std::size_t num_blocks = data.size() / SHA256BlockSize;
+    if (num_blocks != 0) {
+        kernels.blocks(state.data(), data.data(), num_blocks);
+        data = data.subspan(num_blocks * SHA256BlockSize);
+    }
+
+    std::memcpy(buffer.data(), data.data(), data.size());
+    buffered = data.size();
+}
+
+SHA256Hash SHA256Context::Finalize() {
+    std::array<u8, SHA256BlockSize * 2> final_blocks;
+    const std::size_t num_blocks =
+        BuildFinalBlocks(buffer.data(), buffered, total_size, final_blocks);
+    GetSHA256Kernels().blocks(state.data(), final_blocks.data(), num_blocks);
+
+    const SHA256Hash hash = StateToHash(state);
+    *this = SHA256Context{};
+    return hash;
+}
+
+SHA256Hash CalculateSHA256(std::span<const u8> data) {
+    SHA256Context context;
+    context.Update(data);
+    return context.Finalize();
+}
+
+void CalculateSHA256Multi(std::span<const std::span<const u8>> inputs, std::span<SHA256Hash> out) {
+    ASSERT(out.size() >= inputs.size());
+    const SHA256Kernels& kernels = GetSHA256Kernels();
+
+    std::size_t i = 0;
+    for (; i + 1 < inputs.size(); i += 2) {
+        const std::span<const u8> a = inputs[i];
+        const std::span<const u8> b = inputs[i + 1];
+        if (a.size() != b.size()) {
+            out[i] = CalculateSHA256(a);
+            out[i + 1] = CalculateSHA256(b);
+            continue;
+        }
+
+        std::array<u32, 8> state_a{SHA256InitialState};
+        std::array<u32, 8> state_b{SHA256InitialState};
+        const std::size_t full_blocks = a.size() / SHA256BlockSize;
+        if (full_blocks != 0) {
+            kernels.blocks_x2(state_a.data(), a.data(), state_b.data(), b.data(), full_blocks);
+        }
+
+        // Equal sizes pad to the same number of final blocks, so the tails interleave as well.
+        const std::size_t tail_offset = full_blocks * SHA256BlockSize;
+        std::array<u8, SHA256BlockSize * 2> final_a;
+        std::array<u8, SHA256BlockSize * 2> final_b;
+        const std::size_t final_blocks =
+            BuildFinalBlocks(a.data() + tail_offset, a.size() - tail_offset, a.size(), final_a);
+        BuildFinalBlocks(b.data() + tail_offset, b.size() - tail_offset, b.size(), final_b);
+        kernels.blocks_x2(state_a.data(), final_a.data(), state_b.data(), final_b.data(),
+                          final_blocks);
+
+        out[i] = StateToHash(state_a);
+        out[i + 1] = StateToHash(state_b);
+    }
+    if (i < inputs.size()) {
+        out[i] = CalculateSHA256(inputs[i]);
+    }
+}
+
+const char* GetSHA256BackendName() {
+    return GetSHA256Kernels().name;
+}
+
+} // namespace Core::Crypto
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <array>
+#include <span>
+#include "yuzu_common/common_types.h"
+
+namespace Core::Crypto {
+
+using SHA256Hash = std::array<u8, 0x20>;
+
+/// Incremental SHA-256, compressing full blocks with the fastest kernel the host CPU supports.
+class SHA256Context {
+public:
+    SHA256Context();
+
+    void Update(std::span<const u8> data);
+    SHA256Hash Finalize();
+
+private:
+    std::array<u32, 8> state;
+    std::array<u8, 0x40> buffer;
+    std::size_t buffered{};
+    u64 total_size{};
+};
+
+SHA256Hash CalculateSHA256(std::span<const u8> data);
+
+/**
+ * Hashes several independent buffers, such as the blocks of one hash tree layer. Buffers of equal
+ * size are hashed in pairs so backends that can interleave two streams hide the latency of the
+ * compression rounds.
+ */
+void CalculateSHA256Multi(std::span<const std::span<const u8>> inputs, std::span<SHA256Hash> out);
+
+/// Name of the SHA-256 backend selected for the host CPU.
+const char* GetSHA256BackendName();
+
+} // namespace Core::Crypto
@@ -3,6 +3,7 @@
 
 #include "core/file_sys/filesystem.h"
 #include "core/file_sys/vfs/vfs.h"
+#include "core/file_sys/vfs/vfs_buffered.h"
 #include "core/file_sys/savedata_factory.h"
 #include "core/file_sys/registered_cache.h"
 #include "core/file_sys/bis_factory.h"
@@ -15,7 +16,8 @@
 
 namespace FileSys {
 
-FileSystemController::FileSystemController(Systemloader & loader_) : loader{ loader_ } {}
+FileSystemController::FileSystemController(Systemloader & loader_) :
+    loader{ loader_ }, save_flusher{ std::make_unique<FileSys::BufferedSaveFlusher>() } {}
 
 FileSystemController::~FileSystemController() = default;
 
@@ -104,6 +106,28 @@ FileSys::RegisteredCache * FileSystemController::SystemNANDContents() const
     return bis_factory->GetSystemNANDContents();
 }
 
+VirtualDir FileSystemController::GetModificationLoadRoot(u64 title_id) const
+{
+    LOG_TRACE(Service_FS, "Opening mod load root for tid={:016X}", title_id);
+
+    if (bis_factory == nullptr)
+    {
+        return nullptr;
+    }
+    return bis_factory->GetModificationLoadRoot(title_id);
+}
+
+VirtualDir FileSystemController::GetSDMCModificationLoadRoot(u64 title_id) const
+{
+    LOG_TRACE(Service_FS, "Opening SDMC mod load root for tid={:016X}", title_id);
+
+    if (sdmc_factory == nullptr)
+    {
+        return nullptr;
+    }
+    return sdmc_factory->GetSDMCModificationLoadRoot(title_id);
+}
+
 void FileSystemController::CreateFactories(FileSys::VfsFilesystem & vfs, bool overwrite) {
     if (overwrite) {
         bis_factory = nullptr;
@@ -150,7 +174,7 @@ std::shared_ptr<FileSys::SaveDataFactory> FileSystemController::CreateSaveDataFa
     auto vfs = loader.GetFilesystem();
     const auto nand_directory =
         vfs->OpenDirectory(Common::FS::GetYuzuPathString(YuzuPath::NANDDir), rw_mode);
-    return std::make_shared<FileSys::SaveDataFactory>(loader, program_id,
+    return std::make_shared<FileSys::SaveDataFactory>(loader, *save_flusher, program_id,
         std::move(nand_directory));
 }
 
@@ -6,11 +6,13 @@
 #include <memory>
 #include <mutex>
 #include <yuzu_common/common_types.h>
+#include "core/file_sys/vfs/vfs_types.h"
 #include <nxemu-module-spec/system_loader.h>
 
 class Systemloader;
 
 namespace FileSys {
+class BufferedSaveFlusher;
 class RomFSFactory;
 class SaveDataFactory;
 class SDMCFactory;
@@ -31,6 +33,8 @@ public:
     bool RegisterProcess(ProcessId process_id, ProgramId program_id, std::shared_ptr<FileSys::RomFSFactory>&& romfs_factory);
 
     FileSys::RegisteredCache * SystemNANDContents() const;
+    VirtualDir GetModificationLoadRoot(u64 title_id) const;
+    VirtualDir GetSDMCModificationLoadRoot(u64 title_id) const;
 
     void CreateFactories(FileSys::VfsFilesystem & vfs, bool overwrite = true);
 
@@ -47,6 +51,9 @@ private:
 
     Systemloader & loader;
 
+    // Declared ahead of the registrations so it outlives every save data factory using it.
+    std::unique_ptr<FileSys::BufferedSaveFlusher> save_flusher;
+
     struct Registration {
         ProgramId program_id;
         std::shared_ptr<FileSys::RomFSFactory> romfs_factory;
@@ -1,10 +1,23 @@
 // SPDX-FileCopyrightText: Copyright 2018 yuzu Emulator Project
 // SPDX-License-Identifier: GPL-2.0-or-later
 
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
 #include <cstring>
+#include <deque>
+#include <future>
+#include <mutex>
 #include <span>
 #include <string_view>
+#include <thread>
+#include <tuple>
 #include "yuzu_common/alignment.h"
+#include "yuzu_common/cityhash.h"
+#include "yuzu_common/fs/file.h"
+#include "yuzu_common/fs/fs.h"
+#include "yuzu_common/logging/log.h"
+#include "yuzu_common/polyfill_thread.h"
 #include "yuzu_common/yuzu_assert.h"
 #include "core/file_sys/fsmitm_romfsbuild.h"
 #include "core/file_sys/ips_layer.h"
@@ -18,6 +31,11 @@ constexpr u64 FS_MAX_PATH = 0x301;
 constexpr u32 ROMFS_ENTRY_EMPTY = 0xFFFFFFFF;
 constexpr u32 ROMFS_FILEPARTITION_OFS = 0x200;
 
+constexpr std::size_t MAX_TRAVERSAL_THREADS = 8;
+
+constexpr u32 BUILD_CACHE_MAGIC = 0x43424652; // RFBC
+constexpr u32 BUILD_CACHE_VERSION = 1;
+
 // Types for building a RomFS.
 struct RomFSHeader {
     u64 header_size;
@@ -78,6 +96,245 @@ struct RomFSBuildFileContext {
     VirtualFile source;
 };
 
+// Layout of a persisted build: a RomFSBuildCacheHeader, the metadata tables, then one
+// RomFSBuildCacheFile followed by its path for every file in the file partition.
+struct RomFSBuildCacheHeader {
+    u32 magic;
+    u32 version;
+    u64 key;
+    u64 num_files;
+    u64 num_dirs;
+    u64 metadata_size;
+    RomFSHeader romfs_header;
+};
+
+struct RomFSBuildCacheFile {
+    u64 offset;
+    u64 size;
+    u64 path_size;
+};
+
+static VirtualFile ApplyExtPatches(VirtualFile source, const VirtualDir& ext_dir,
+                                   std::string_view name) {
+    if (ext_dir != nullptr) {
+        if (const auto ips = ext_dir->GetFile(std::string(name) + ".ips")) {
+            if (auto patched = PatchIPS(source, ips)) {
+                return patched;
+            }
+        }
+    }
+    return source;
+}
+
+// Opens the directories of a build on first use. The files of a cached build share it, so the
+// directories are only opened once one of them is read.
+class RomFSBuildSources {
+public:
+    explicit RomFSBuildSources(RomFSDirectoryOpener open_) : open{std::move(open_)} {}
+
+    const VirtualDir& Base() {
+        Open();
+        return base;
+    }
+
+    const VirtualDir& Ext() {
+        Open();
+        return ext;
+    }
+
+private:
+    void Open() {
+        std::call_once(open_once, [this] {
+            std::tie(base, ext) = open();
+            open = nullptr;
+        });
+    }
+
+    RomFSDirectoryOpener open;
+    std::once_flag open_once;
+    VirtualDir base;
+    VirtualDir ext;
+};
+
+// Stands in for a file of a cached build. The source is only looked up and patched when the
+// file is first read, so using a cached build does not walk the directory trees.
+class RomFSCachedSourceFile : public VfsFile {
+public:
+    RomFSCachedSourceFile(std::shared_ptr<RomFSBuildSources> sources_, std::string path_, u64 size_,
+                          std::filesystem::path cache_path_)
+        : sources{std::move(sources_)}, path{std::move(path_)}, size{size_},
+          cache_path{std::move(cache_path_)} {}
+
+    std::string GetName() const override {
+        return path.substr(path.rfind('/') + 1);
+    }
+
+    std::size_t GetSize() const override {
+        return size;
+    }
+
+    bool Resize(std::size_t new_size) override {
+        return false;
+    }
+
+    VirtualDir GetContainingDirectory() const override {
+        return nullptr;
+    }
+
+    bool IsWritable() const override {
+        return false;
+    }
+
+    bool IsReadable() const override {
+        return true;
+    }
+
+    std::size_t Read(u8* data, std::size_t length, std::size_t offset = 0) const override {
+        const VirtualFile& source = GetSource();
+        return source != nullptr ? source->Read(data, length, offset) : 0;
+    }
+
+    std::size_t Write(const u8* data, std::size_t length, std::size_t offset = 0) override {
+        return 0;
+    }
+
+    bool Rename(std::string_view name) override {
+        return false;
+    }
+
+private:
+    const VirtualFile& GetSource() const {
+        std::call_once(source_once, [this] {
+            const VirtualDir& base = sources->Base();
+            const VirtualDir& ext = sources->Ext();
+            if (base != nullptr) {
+                source = base->GetFileRelative(path);
+            }
+            if (source != nullptr && ext != nullptr) {
+                const auto split = path.rfind('/');
+                const auto ext_dir =
+                    split == 0 ? ext : ext->GetDirectoryRelative(path.substr(0, split));
+                source = ApplyExtPatches(std::move(source), ext_dir, path.substr(split + 1));
+            }
+            if (source == nullptr || source->GetSize() != size) {
+                // A file changed without touching any timestamp that is part of the key. The
+                // offsets of every following file depend on its size, so the layout cannot be
+                // patched up here: fail the reads and let the next boot rebuild it.
+                LOG_ERROR(Loader, "RomFS build cache is stale for {}, discarding it", path);
+                Common::FS::RemoveFile(cache_path);
+                source = nullptr;
+            }
+        });
+        return source;
+    }
+
+    std::shared_ptr<RomFSBuildSources> sources;
+    std::string path;
+    u64 size;
+    std::filesystem::path cache_path;
+
+    mutable std::once_flag source_once;
+    mutable VirtualFile source;
+};
+
+static std::vector<std::pair<u64, VirtualFile>> LoadBuildCache(
+    const std::filesystem::path& cache_path, u64 cache_key,
+    const std::shared_ptr<RomFSBuildSources>& sources, RomFSBuildStats& stats) {
+    const Common::FS::IOFile file{cache_path, Common::FS::FileAccessMode::Read,
+                                  Common::FS::FileType::BinaryFile};
+    if (!file.IsOpen()) {
+        return {};
+    }
+    std::vector<u8> data(file.GetSize());
+    if (data.size() < sizeof(RomFSBuildCacheHeader) ||
+        file.ReadSpan(std::span<u8>(data)) != data.size()) {
+        return {};
+    }
+
+    RomFSBuildCacheHeader cache_header;
+    std::memcpy(&cache_header, data.data(), sizeof(cache_header));
+    if (cache_header.magic != BUILD_CACHE_MAGIC || cache_header.version != BUILD_CACHE_VERSION ||
+        cache_header.key != cache_key ||
+        cache_header.metadata_size > data.size() - sizeof(cache_header)) {
+        return {};
+    }
+    std::size_t pos = sizeof(cache_header);
+
+    std::vector<std::pair<u64, VirtualFile>> out;
+    out.reserve(cache_header.num_files + 2);
+
+    std::vector<u8> header_data(sizeof(RomFSHeader));
+    std::memcpy(header_data.data(), &cache_header.romfs_header, header_data.size());
+    out.emplace_back(0, std::make_shared<VectorVfsFile>(std::move(header_data)));
+
+    std::vector<u8> metadata(data.begin() + pos, data.begin() + pos + cache_header.metadata_size);
+    out.emplace_back(cache_header.romfs_header.dir_hash_table_ofs,
+                     std::make_shared<VectorVfsFile>(std::move(metadata)));
+    pos += cache_header.metadata_size;
+
+    for (u64 i = 0; i < cache_header.num_files; i++) {
+        RomFSBuildCacheFile entry;
+        if (data.size() - pos < sizeof(entry)) {
+            return {};
+        }
+        std::memcpy(&entry, data.data() + pos, sizeof(entry));
+        pos += sizeof(entry);
+        if (data.size() - pos < entry.path_size) {
+            return {};
+        }
+        std::string path(reinterpret_cast<const char*>(data.data() + pos), entry.path_size);
+        pos += entry.path_size;
+
+        out.emplace_back(entry.offset + ROMFS_FILEPARTITION_OFS,
+                         std::make_shared<RomFSCachedSourceFile>(sources, std::move(path),
+                                                                 entry.size, cache_path));
+    }
+
+    std::sort(out.begin(), out.end(),
+              [](const auto& a, const auto& b) { return a.first < b.first; });
+
+    stats.num_files = cache_header.num_files;
+    stats.num_dirs = cache_header.num_dirs;
+    return out;
+}
+
+static void StoreBuildCache(const std::filesystem::path& cache_path, u64 cache_key, u64 num_dirs,
+                            const RomFSHeader& romfs_header, std::span<const u8> metadata,
+                            std::span<const std::shared_ptr<RomFSBuildFileContext>> files) {
+    RomFSBuildCacheHeader cache_header{};
+    cache_header.magic = BUILD_CACHE_MAGIC;
+    cache_header.version = BUILD_CACHE_VERSION;
+    cache_header.key = cache_key;
+    cache_header.num_files = files.size();
+    cache_header.num_dirs = num_dirs;
+    cache_header.metadata_size = metadata.size();
+    cache_header.romfs_header = romfs_header;
+
+    std::vector<u8> data(sizeof(cache_header));
+    std::memcpy(data.data(), &cache_header, sizeof(cache_header));
+    data.insert(data.end(), metadata.begin(), metadata.end());
+    for (const auto& cur_file : files) {
+        const RomFSBuildCacheFile entry{
+            .offset = cur_file->offset,
+            .size = cur_file->size,
+            .path_size = cur_file->path.size(),
+        };
+        const auto* entry_bytes = reinterpret_cast<const u8*>(&entry);
+        data.insert(data.end(), entry_bytes, entry_bytes + sizeof(entry));
+        data.insert(data.end(), cur_file->path.begin(), cur_file->path.end());
+    }
+
+    if (!Common::FS::CreateParentDirs(cache_path)) {
+        return;
+    }
+    const Common::FS::IOFile file{cache_path, Common::FS::FileAccessMode::Write,
+                                  Common::FS::FileType::BinaryFile};
+    if (!file.IsOpen() || file.WriteSpan(std::span<const u8>(data)) != data.size()) {
+        LOG_WARNING(Loader, "Failed to write RomFS build cache {}",
+                    Common::FS::PathToUTF8String(cache_path));
+    }
+}
+
 static u32 romfs_calc_path_hash(u32 parent, std::string_view path, u32 start,
                                 std::size_t path_len) {
     u32 hash = parent ^ 123456789;
@@ -106,9 +363,72 @@ static u64 romfs_get_hash_table_count(u64 num_entries) {
     return count;
 }
 
-void RomFSBuildContext::VisitDirectory(VirtualDir romfs_dir, VirtualDir ext_dir,
-                                       std::shared_ptr<RomFSBuildDirectoryContext> parent) {
-    for (auto& child_romfs_file : romfs_dir->GetFiles()) {
+struct RomFSBuildContext::PendingDirectory {
+    VirtualDir romfs_dir;
+    VirtualDir ext_dir;
+    std::shared_ptr<RomFSBuildDirectoryContext> ctx;
+};
+
+void RomFSBuildContext::TraverseDirectories() {
+    std::mutex queue_lock;
+    std::condition_variable queue_cv;
+    std::deque<PendingDirectory> queue;
+    std::size_t busy_workers = 0;
+
+    queue.push_back(PendingDirectory{base, ext, root});
+
+    // Each worker lists one directory at a time and queues its subdirectories for whichever
+    // worker is free. Listing, IPS patching and size queries are done outside the lock; only
+    // adding the results to the tables is serialized.
+    const auto worker = [&] {
+        std::vector<std::shared_ptr<RomFSBuildFileContext>> dir_files;
+        std::vector<PendingDirectory> subdirs;
+
+        std::unique_lock lk{queue_lock};
+        while (true) {
+            queue_cv.wait(lk, [&] { return !queue.empty() || busy_workers == 0; });
+            if (queue.empty()) {
+                return;
+            }
+            const PendingDirectory pending = std::move(queue.front());
+            queue.pop_front();
+            busy_workers++;
+            lk.unlock();
+
+            dir_files.clear();
+            subdirs.clear();
+            VisitDirectory(pending, dir_files, subdirs);
+
+            lk.lock();
+            busy_workers--;
+            for (auto& file : dir_files) {
+                AddFile(pending.ctx, std::move(file));
+            }
+            for (auto& subdir : subdirs) {
+                AddDirectory(pending.ctx, subdir.ctx);
+                queue.push_back(std::move(subdir));
+            }
+            queue_cv.notify_all();
+        }
+    };
+
+    const std::size_t num_workers =
+        std::clamp<std::size_t>(std::thread::hardware_concurrency(), 1, MAX_TRAVERSAL_THREADS);
+    std::vector<std::jthread> helpers;
+    helpers.reserve(num_workers - 1);
+    for (std::size_t i = 1; i < num_workers; i++) {
+        helpers.emplace_back(worker);
+    }
+    worker();
+}
+
+void RomFSBuildContext::VisitDirectory(
+    const PendingDirectory& pending, std::vector<std::shared_ptr<RomFSBuildFileContext>>& out_files,
+    std::vector<PendingDirectory>& out_subdirs) {
+    const auto& parent = pending.ctx;
+    const auto& ext_dir = pending.ext_dir;
+
+    for (auto& child_romfs_file : pending.romfs_dir->GetFiles()) {
         const auto name = child_romfs_file->GetName();
         const auto child = std::make_shared<RomFSBuildFileContext>();
         // Set child's path.
@@ -123,22 +443,13 @@ void RomFSBuildContext::VisitDirectory(VirtualDir romfs_dir, VirtualDir ext_dir,
         // Sanity check on path_len
         ASSERT(child->path_len < FS_MAX_PATH);
 
-        child->source = std::move(child_romfs_file);
-
-        if (ext_dir != nullptr) {
-            if (const auto ips = ext_dir->GetFile(name + ".ips")) {
-                if (auto patched = PatchIPS(child->source, ips)) {
-                    child->source = std::move(patched);
-                }
-            }
-        }
-
+        child->source = ApplyExtPatches(std::move(child_romfs_file), ext_dir, name);
         child->size = child->source->GetSize();
 
-        AddFile(parent, std::move(child));
+        out_files.emplace_back(std::move(child));
     }
 
-    for (auto& child_romfs_dir : romfs_dir->GetSubdirectories()) {
+    for (auto& child_romfs_dir : pending.romfs_dir->GetSubdirectories()) {
         const auto name = child_romfs_dir->GetName();
         const auto child = std::make_shared<RomFSBuildDirectoryContext>();
         // Set child's path.
@@ -153,12 +464,9 @@ void RomFSBuildContext::VisitDirectory(VirtualDir romfs_dir, VirtualDir ext_dir,
         // Sanity check on path_len
         ASSERT(child->path_len < FS_MAX_PATH);
 
-        if (!AddDirectory(parent, child)) {
-            continue;
-        }
-
         auto child_ext_dir = ext_dir != nullptr ? ext_dir->GetSubdirectory(name) : nullptr;
-        this->VisitDirectory(child_romfs_dir, child_ext_dir, child);
+        out_subdirs.push_back(
+            PendingDirectory{std::move(child_romfs_dir), std::move(child_ext_dir), child});
     }
 }
 
@@ -187,19 +495,63 @@ bool RomFSBuildContext::AddFile(std::shared_ptr<RomFSBuildDirectoryContext> pare
 }
 
 RomFSBuildContext::RomFSBuildContext(VirtualDir base_, VirtualDir ext_)
-    : base(std::move(base_)), ext(std::move(ext_)) {
+    : RomFSBuildContext([base_, ext_] { return std::make_pair(base_, ext_); }) {}
+
+RomFSBuildContext::RomFSBuildContext(RomFSDirectoryOpener open_dirs)
+    : sources(std::make_shared<RomFSBuildSources>(std::move(open_dirs))) {
     root = std::make_shared<RomFSBuildDirectoryContext>();
     root->path = "\0";
     directories.emplace_back(root);
     num_dirs = 1;
     dir_table_size = 0x18;
-
-    VisitDirectory(base, ext, root);
 }
 
 RomFSBuildContext::~RomFSBuildContext() = default;
 
 std::vector<std::pair<u64, VirtualFile>> RomFSBuildContext::Build() {
+    return BuildImpl(nullptr, 0);
+}
+
+std::vector<std::pair<u64, VirtualFile>> RomFSBuildContext::Build(
+    const std::filesystem::path& cache_path, u64 cache_key) {
+    return BuildImpl(&cache_path, cache_key);
+}
+
+std::vector<std::pair<u64, VirtualFile>> RomFSBuildContext::BuildImpl(
+    const std::filesystem::path* cache_path, u64 cache_key) {
+    using Clock = std::chrono::steady_clock;
+    auto phase_start = Clock::now();
+    const auto end_phase = [&phase_start](u64& counter) {
+        const auto now = Clock::now();
+        counter += std::chrono::duration_cast<std::chrono::microseconds>(now - phase_start).count();
+        phase_start = now;
+    };
+    const auto log_stats = [this] {
+        LOG_INFO(Loader,
+                 "RomFS built: {} files, {} dirs, cache {}, traverse {} us, layout {} us, "
+                 "tables {} us, cache io {} us",
+                 stats.num_files, stats.num_dirs, stats.cache_hit ? "hit" : "miss",
+                 stats.traverse_us, stats.layout_us, stats.tables_us, stats.cache_us);
+    };
+
+    if (cache_path != nullptr) {
+        auto cached = LoadBuildCache(*cache_path, cache_key, sources, stats);
+        end_phase(stats.cache_us);
+        if (!cached.empty()) {
+            stats.cache_hit = true;
+            log_stats();
+            return cached;
+        }
+    }
+
+    base = sources->Base();
+    ext = sources->Ext();
+    if (base == nullptr) {
+        return {};
+    }
+    TraverseDirectories();
+    end_phase(stats.traverse_us);
+
     const u64 dir_hash_table_entry_count = romfs_get_hash_table_count(num_dirs);
     const u64 file_hash_table_entry_count = romfs_get_hash_table_count(num_files);
     dir_hash_table_size = 4 * dir_hash_table_entry_count;
@@ -267,6 +619,8 @@ std::vector<std::pair<u64, VirtualFile>> RomFSBuildContext::Build() {
         cur_dir->parent->child = cur_dir;
     }
 
+    end_phase(stats.layout_us);
+
     // Create output map.
     std::vector<std::pair<u64, VirtualFile>> out;
     out.reserve(num_files + 2);
@@ -340,6 +694,13 @@ std::vector<std::pair<u64, VirtualFile>> RomFSBuildContext::Build() {
                     cur_dir->path.data() + cur_dir->cur_path_ofs, name_size);
     }
 
+    end_phase(stats.tables_us);
+
+    if (cache_path != nullptr) {
+        StoreBuildCache(*cache_path, cache_key, num_dirs, header, metadata, files);
+        end_phase(stats.cache_us);
+    }
+
     // Write metadata.
     out.emplace_back(header.dir_hash_table_ofs,
                      std::make_shared<VectorVfsFile>(std::move(metadata)));
@@ -348,7 +709,68 @@ std::vector<std::pair<u64, VirtualFile>> RomFSBuildContext::Build() {
     std::sort(out.begin(), out.end(),
               [](const auto& a, const auto& b) { return a.first < b.first; });
 
+    stats.num_files = num_files;
+    stats.num_dirs = num_dirs;
+    log_stats();
     return out;
 }
 
+static void HashDirectoryTree(const VirtualDir& dir, std::string& out) {
+    for (const auto& [name, type] : dir->GetEntries()) {
+        const u64 modified = dir->GetFileTimeStamp(name).modified;
+        out += name;
+        out.push_back(type == VfsEntryType::Directory ? '/' : '\0');
+        out.append(reinterpret_cast<const char*>(&modified), sizeof(modified));
+
+        if (type == VfsEntryType::Directory) {
+            if (const auto subdir = dir->GetSubdirectory(name)) {
+                HashDirectoryTree(subdir, out);
+            }
+        }
+    }
+    out.push_back('\0');
+}
+
+u64 HashRomFSMetadata(const VirtualFile& romfs) {
+    RomFSHeader header{};
+    if (romfs == nullptr || romfs->ReadObject(&header) != sizeof(RomFSHeader)) {
+        return 0;
+    }
+
+    u64 hash = Common::CityHash64WithSeed(reinterpret_cast<const char*>(&header), sizeof(header),
+                                          romfs->GetSize());
+    const u64 metadata_end = header.file_table_ofs + header.file_table_size;
+    if (header.dir_hash_table_ofs < metadata_end && metadata_end <= romfs->GetSize()) {
+        const auto metadata = romfs->ReadBytes(metadata_end - header.dir_hash_table_ofs,
+                                               header.dir_hash_table_ofs);
+        hash = Common::CityHash64WithSeed(reinterpret_cast<const char*>(metadata.data()),
+                                          metadata.size(), hash);
+    }
+    return hash;
+}
+
+u64 HashDirectoryTimestamps(const std::vector<VirtualDir>& dirs) {
+    // Mod directories are independent trees, so each is walked on its own thread.
+    std::vector<std::future<std::string>> listings;
+    listings.reserve(dirs.size());
+    for (const auto& dir : dirs) {
+        listings.push_back(std::async(std::launch::async, [dir] {
+            std::string listing;
+            if (dir != nullptr) {
+                listing = dir->GetFullPath();
+                listing.push_back('\0');
+                HashDirectoryTree(dir, listing);
+            }
+            return listing;
+        }));
+    }
+
+    u64 hash = dirs.size();
+    for (auto& listing : listings) {
+        const std::string value = listing.get();
+        hash = Common::CityHash64WithSeed(value.data(), value.size(), hash);
+    }
+    return hash;
+}
+
 } // namespace FileSys
@@ -3,28 +3,61 @@
 
 #pragma once
 
+#include <filesystem>
+#include <functional>
 #include <map>
 #include <memory>
 #include <string>
+#include <vector>
 #include "yuzu_common/common_types.h"
 #include "core/file_sys/vfs/vfs.h"
 
 namespace FileSys {
 
+class RomFSBuildSources;
 struct RomFSBuildDirectoryContext;
 struct RomFSBuildFileContext;
 struct RomFSDirectoryEntry;
 struct RomFSFileEntry;
 
+// Time spent in each phase of a RomFS build, in microseconds.
+struct RomFSBuildStats {
+    u64 traverse_us = 0;
+    u64 layout_us = 0;
+    u64 tables_us = 0;
+    u64 cache_us = 0;
+    u64 num_files = 0;
+    u64 num_dirs = 0;
+    bool cache_hit = false;
+};
+
+// Opens the base and ext directories of a build. Only called once they are needed, which a build
+// served from its cache may never do.
+using RomFSDirectoryOpener = std::function<std::pair<VirtualDir, VirtualDir>()>;
+
 class RomFSBuildContext {
 public:
     explicit RomFSBuildContext(VirtualDir base, VirtualDir ext = nullptr);
+    explicit RomFSBuildContext(RomFSDirectoryOpener open_dirs);
     ~RomFSBuildContext();
 
     // This finalizes the context.
     std::vector<std::pair<u64, VirtualFile>> Build();
 
+    // Like Build(), but when cache_path holds a layout written for the same cache_key it is used
+    // as is and the directories are not traversed at all. Otherwise the layout is built and then
+    // written to cache_path.
+    std::vector<std::pair<u64, VirtualFile>> Build(const std::filesystem::path& cache_path,
+                                                   u64 cache_key);
+
+    const RomFSBuildStats& GetStats() const {
+        return stats;
+    }
+
 private:
+    struct PendingDirectory;
+
+    std::shared_ptr<RomFSBuildSources> sources;
     VirtualDir base;
     VirtualDir ext;
     std::shared_ptr<RomFSBuildDirectoryContext> root;
@@ -37,9 +70,14 @@ private:
     u64 dir_hash_table_size = 0;
     u64 file_hash_table_size = 0;
     u64 file_partition_size = 0;
+    RomFSBuildStats stats;
 
-    void VisitDirectory(VirtualDir filesys, VirtualDir ext_dir,
-                        std::shared_ptr<RomFSBuildDirectoryContext> parent);
+    std::vector<std::pair<u64, VirtualFile>> BuildImpl(const std::filesystem::path* cache_path,
+                                                       u64 cache_key);
+    void TraverseDirectories();
+    void VisitDirectory(const PendingDirectory& pending,
+                        std::vector<std::shared_ptr<RomFSBuildFileContext>>& out_files,
+                        std::vector<PendingDirectory>& out_subdirs);
 
     bool AddDirectory(std::shared_ptr<RomFSBuildDirectoryContext> parent_dir_ctx,
                       std::shared_ptr<RomFSBuildDirectoryContext> dir_ctx);
@@ -47,4 +85,10 @@ private:
                  std::shared_ptr<RomFSBuildFileContext> file_ctx);
 };
 
+// Identifies a packed RomFS by its size, header and metadata tables, without reading file data.
+u64 HashRomFSMetadata(const VirtualFile& romfs);
+
+// Combines the names and modification times of every entry below dirs, in order.
+u64 HashDirectoryTimestamps(const std::vector<VirtualDir>& dirs);
+
 } // namespace FileSys
@@ -0,0 +1,218 @@
+// SPDX-FileCopyrightText: Copyright 2024 yuzu Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <iterator>
+#include <latch>
+#include <mutex>
+#include <thread>
+
+#include "yuzu_common/hex_util.h"
+#include "yuzu_common/logging/log.h"
+#include "yuzu_common/swap.h"
+#include "core/crypto/sha256.h"
+#include "core/file_sys/card_image.h"
+#include "core/file_sys/integrity_verifier.h"
+#include "core/file_sys/partition_filesystem.h"
+#include "core/file_sys/vfs/vfs.h"
+#include "core/file_sys/vfs/vfs_offset.h"
+
+namespace FileSys {
+
+namespace {
+
+constexpr std::size_t ReadSize = 0x100000;
+constexpr u64 CardInitialDataRegionSize = 0x1000;
+
+bool IsContentFileName(std::string_view stem) {
+    return stem.size() == 0x20 &&
+           std::all_of(stem.begin(), stem.end(), [](char c) { return std::isxdigit(c) != 0; });
+}
+
+void CollectPartitionNcas(const VirtualFile& file, std::vector<VirtualFile>& out) {
+    PartitionFilesystem partition{file};
+    if (partition.GetStatus() != LoaderResultStatus::Success) {
+        return;
+    }
+    for (VirtualFile& nca : partition.GetFiles()) {
+        if (nca->GetExtension() == "nca") {
+            out.push_back(std::move(nca));
+        }
+    }
+}
+
+/// Returns the secure partition of a card image, which holds every NCA of the game.
+VirtualFile OpenSecurePartition(VirtualFile file) {
+    GamecardHeader header{};
+    const auto read_header = [&header](const VirtualFile& image) {
+        return image->ReadObject(&header) == sizeof(GamecardHeader) &&
+               header.magic == Common::MakeMagic('H', 'E', 'A', 'D');
+    };
+    // Dumps that include the key area store the header after it.
+    if (!read_header(file)) {
+        const std::size_t size = file->GetSize();
+        if (size < CardInitialDataRegionSize) {
+            return nullptr;
+        }
+        file = std::make_shared<OffsetVfsFile>(file, size - CardInitialDataRegionSize,
+                                               CardInitialDataRegionSize);
+        if (!read_header(file)) {
+            return nullptr;
+        }
+    }
+    if (header.hfs_offset >= file->GetSize()) {
+        return nullptr;
+    }
+
+    PartitionFilesystem root{std::make_shared<OffsetVfsFile>(
+        file, file->GetSize() - header.hfs_offset, header.hfs_offset)};
+    if (root.GetStatus() != LoaderResultStatus::Success) {
+        return nullptr;
+    }
+    return root.GetFile("secure");
+}
+
+} // namespace
+
+struct IntegrityVerifier::Job {
+    VirtualFile file;
+    Callback callback;
+    std::chrono::steady_clock::time_point start;
+    IntegrityReport report;
+};
+
+IntegrityVerifier::IntegrityVerifier(std::size_t num_workers)
+    : workers{num_workers != 0 ? num_workers
+                               : std::max<std::size_t>(std::thread::hardware_concurrency(), 1),
+              "IntegrityVerifier"} {}
+
+IntegrityVerifier::~IntegrityVerifier() {
+    Cancel();
+}
+
+void IntegrityVerifier::Submit(VirtualFile file, Callback callback) {
+    auto job = std::make_shared<Job>();
+    job->file = std::move(file);
+    job->callback = std::move(callback);
+    job->start = std::chrono::steady_clock::now();
+    job->report.path = job->file->GetFullPath();
+
+    workers.QueueWork([this, job] {
+        // Content NCAs are named after the first half of their SHA-256, meta NCAs add ".cnmt".
+        const std::string name = job->file->GetName();
+        const std::string stem = name.substr(0, name.find('.'));
+        if (!cancelled && IsContentFileName(stem)) {
+            Verify(*job, stem);
+        }
+        job->report.duration = std::chrono::steady_clock::now() - job->start;
+        if (job->callback) {
+            job->callback(job->report);
+        }
+    });
+}
+
+std::vector<IntegrityReport> IntegrityVerifier::VerifyLibrary(const VirtualDir& dir) {
+    std::vector<VirtualFile> files;
+    const auto collect = [&files](const auto& self, const VirtualDir& current) -> void {
+        for (const VirtualFile& file : current->GetFiles()) {
+            std::vector<VirtualFile> ncas = CollectNcas(file);
+            std::move(ncas.begin(), ncas.end(), std::back_inserter(files));
+        }
+        for (const VirtualDir& subdir : current->GetSubdirectories()) {
+            self(self, subdir);
+        }
+    };
+    if (dir != nullptr) {
+        collect(collect, dir);
+    }
+
+    std::vector<IntegrityReport> reports;
+    reports.reserve(files.size());
+    std::mutex reports_mutex;
+    std::latch done{static_cast<std::ptrdiff_t>(files.size())};
+    for (VirtualFile& file : files) {
+        Submit(std::move(file), [&](const IntegrityReport& report) {
+            {
+                std::scoped_lock lock{reports_mutex};
+                reports.push_back(report);
+            }
+            done.count_down();
+        });
+    }
+    done.wait();
+
+    std::sort(reports.begin(), reports.end(),
+              [](const IntegrityReport& a, const IntegrityReport& b) { return a.path < b.path; });
+    return reports;
+}
+
+void IntegrityVerifier::Cancel() {
+    cancelled = true;
+}
+
+void IntegrityVerifier::Verify(Job& job, const std::string& expected) {
+    Core::Crypto::SHA256Context context;
+    std::vector<u8> buffer(ReadSize);
+    const std::size_t size = job.file->GetSize();
+    std::size_t offset = 0;
+    while (offset < size && !cancelled) {
+        const std::size_t read = job.file->Read(buffer.data(), buffer.size(), offset);
+        if (read != std::min(buffer.size(), size - offset)) {
+            // A short read is a damaged file, the hash below will not match.
+            break;
+        }
+        context.Update({buffer.data(), read});
+        offset += read;
+    }
+    job.report.bytes_verified = offset;
+    if (cancelled) {
+        return;
+    }
+
+    const Core::Crypto::SHA256Hash hash = context.Finalize();
+    const auto name_hash = Common::HexStringToArray<0x10>(expected);
+    job.report.status = offset == size &&
+                                std::memcmp(hash.data(), name_hash.data(), name_hash.size()) == 0
+                            ? LoaderResultStatus::Success
+                            : LoaderResultStatus::ErrorIntegrityVerificationFailed;
+}
+
+std::vector<VirtualFile> CollectNcas(const VirtualFile& file) {
+    std::vector<VirtualFile> ncas;
+    if (file == nullptr) {
+        return ncas;
+    }
+    const std::string extension = file->GetExtension();
+    if (extension == "nca") {
+        ncas.push_back(file);
+    } else if (extension == "nsp") {
+        CollectPartitionNcas(file, ncas);
+    } else if (extension == "xci") {
+        if (const VirtualFile secure = OpenSecurePartition(file)) {
+            CollectPartitionNcas(secure, ncas);
+        }
+    }
+    return ncas;
+}
+
+void LogIntegrityReport(const IntegrityReport& report) {
+    const double mib = static_cast<double>(report.bytes_verified) / (1024.0 * 1024.0);
+    const auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(report.duration).count();
+
+    switch (report.status) {
+    case LoaderResultStatus::Success:
+        LOG_INFO(Loader, "Verified {}: {:.1f} MiB in {} ms", report.path, mib, ms);
+        break;
+    case LoaderResultStatus::ErrorIntegrityVerificationFailed:
+        LOG_ERROR(Loader, "Integrity check of {} failed, its content hash does not match the file "
+                  "name", report.path);
+        break;
+    default:
+        LOG_WARNING(Loader, "Integrity of {} could not be verified", report.path);
+        break;
+    }
+}
+
+} // namespace FileSys
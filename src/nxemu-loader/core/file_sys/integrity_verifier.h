@@ -0,0 +1,66 @@
+// SPDX-FileCopyrightText: Copyright 2024 yuzu Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "yuzu_common/common_types.h"
+#include "yuzu_common/thread_worker.h"
+#include "core/file_sys/vfs/vfs_types.h"
+#include <nxemu-module-spec/system_loader.h>
+
+namespace FileSys {
+
+struct IntegrityReport {
+    std::string path;
+    LoaderResultStatus status{LoaderResultStatus::ErrorIntegrityVerificationNotImplemented};
+    u64 bytes_verified{};
+    std::chrono::steady_clock::duration duration{};
+};
+
+/**
+ * Verifies NCAs against the content hash they are named after: content NCAs are stored as the
+ * first half of the SHA-256 of their data, meta NCAs add ".cnmt". Files are hashed on a pool sized
+ * to the host core count, so a library is verified in parallel and the caller never blocks.
+ *
+ * The hash trees inside an NCA need its decrypted headers, which this tree cannot read yet.
+ */
+class IntegrityVerifier {
+public:
+    using Callback = std::function<void(const IntegrityReport&)>;
+
+    explicit IntegrityVerifier(std::size_t num_workers = 0);
+    ~IntegrityVerifier();
+
+    /// Queues an NCA for verification, callback runs on a worker thread once it is done.
+    void Submit(VirtualFile file, Callback callback);
+
+    /// Verifies every NCA below dir, including the ones in NSP and XCI containers, blocking until
+    /// all of them are done. Must not be called from a callback.
+    std::vector<IntegrityReport> VerifyLibrary(const VirtualDir& dir);
+
+    /// Makes queued and running verifications finish without hashing, for a quick shutdown.
+    void Cancel();
+
+private:
+    struct Job;
+
+    void Verify(Job& job, const std::string& expected);
+
+    std::atomic<bool> cancelled{};
+    Common::ThreadWorker workers;
+};
+
+/// Returns the NCAs stored in file: the file itself for an NCA, the NCAs of an NSP or of the
+/// secure partition of an XCI, and nothing for formats without any, such as NRO.
+std::vector<VirtualFile> CollectNcas(const VirtualFile& file);
+
+void LogIntegrityReport(const IntegrityReport& report);
+
+} // namespace FileSys
@@ -6,6 +6,8 @@
 #include <cstddef>
 #include <cstring>
 
+#include "yuzu_common/cityhash.h"
+#include "yuzu_common/fs/path_util.h"
 #include "yuzu_common/hex_util.h"
 #include "yuzu_common/logging/log.h"
 #include "yuzu_common/settings.h"
@@ -16,6 +18,8 @@
 #include "core/file_sys/common_funcs.h"
 #include "core/file_sys/content_archive.h"
 #include "core/file_sys/control_metadata.h"
+#include "core/file_sys/filesystem.h"
+#include "core/file_sys/fsmitm_romfsbuild.h"
 #include "core/file_sys/ips_layer.h"
 #include "core/file_sys/patch_manager.h"
 #include "core/file_sys/registered_cache.h"
@@ -152,7 +156,85 @@ bool PatchManager::HasNSOPatch(const BuildID& build_id_, std::string_view name)
 
 static void ApplyLayeredFS(VirtualFile& romfs, u64 title_id, LoaderContentRecordType type,
                            const FileSystemController& fs_controller) {
-    UNIMPLEMENTED();
+    const auto load_dir = fs_controller.GetModificationLoadRoot(title_id);
+    const auto sdmc_load_dir = fs_controller.GetSDMCModificationLoadRoot(title_id);
+    if ((type != LoaderContentRecordType::Program && type != LoaderContentRecordType::Data &&
+         type != LoaderContentRecordType::HtmlDocument) ||
+        (load_dir == nullptr && sdmc_load_dir == nullptr)) {
+        return;
+    }
+
+    const auto& disabled = Settings::values.disabled_addons[title_id];
+    std::vector<VirtualDir> patch_dirs;
+    if (load_dir != nullptr) {
+        patch_dirs = load_dir->GetSubdirectories();
+    }
+    if (sdmc_load_dir != nullptr &&
+        std::find(disabled.cbegin(), disabled.cend(), "SDMC") == disabled.cend()) {
+        patch_dirs.push_back(sdmc_load_dir);
+    }
+    std::sort(patch_dirs.begin(), patch_dirs.end(),
+              [](const VirtualDir& l, const VirtualDir& r) { return l->GetName() < r->GetName(); });
+
+    std::vector<VirtualDir> layers;
+    std::vector<VirtualDir> layers_ext;
+    layers.reserve(patch_dirs.size() + 1);
+    layers_ext.reserve(patch_dirs.size() + 1);
+    for (const auto& subdir : patch_dirs) {
+        if (std::find(disabled.cbegin(), disabled.cend(), subdir->GetName()) != disabled.cend()) {
+            continue;
+        }
+
+        auto romfs_dir = FindSubdirectoryCaseless(subdir, "romfs");
+        if (romfs_dir != nullptr)
+            layers.emplace_back(std::move(romfs_dir));
+
+        auto ext_dir = FindSubdirectoryCaseless(subdir, "romfs_ext");
+        if (ext_dir != nullptr)
+            layers_ext.emplace_back(std::move(ext_dir));
+
+        if (type == LoaderContentRecordType::HtmlDocument) {
+            auto manual_dir = FindSubdirectoryCaseless(subdir, "manual_html");
+            if (manual_dir != nullptr)
+                layers.emplace_back(std::move(manual_dir));
+        }
+    }
+
+    // When there are no layers to apply, return early as there is no need to rebuild the RomFS
+    if (layers.empty() && layers_ext.empty()) {
+        return;
+    }
+
+    // The build cache is only valid for the same base RomFS and the same enabled mods with
+    // unchanged timestamps.
+    std::vector<VirtualDir> key_dirs = layers;
+    key_dirs.insert(key_dirs.end(), layers_ext.begin(), layers_ext.end());
+    const std::array<u64, 2> key_parts{HashRomFSMetadata(romfs), HashDirectoryTimestamps(key_dirs)};
+    const u64 cache_key =
+        Common::CityHash64(reinterpret_cast<const char*>(key_parts.data()), sizeof(key_parts));
+    const auto cache_path = Common::FS::GetYuzuPath(Common::FS::YuzuPath::CacheDir) / "romfs" /
+                            fmt::format("{:016X}_{:02X}.bin", title_id, static_cast<u8>(type));
+
+    // The base RomFS is only extracted when the layout is rebuilt or a file is read from it, a
+    // cached layout is used without it.
+    auto open_dirs = [base = romfs, layers = std::move(layers),
+                            layers_ext = std::move(layers_ext)]() mutable {
+        auto extracted = ExtractRomFS(base);
+        if (extracted == nullptr) {
+            return std::make_pair(VirtualDir{}, VirtualDir{});
+        }
+        layers.emplace_back(std::move(extracted));
+        return std::make_pair(LayeredVfsDirectory::MakeLayeredDirectory(std::move(layers)),
+                              LayeredVfsDirectory::MakeLayeredDirectory(std::move(layers_ext)));
+    };
+
+    auto packed = CreateRomFS(std::move(open_dirs), cache_path, cache_key);
+    if (packed == nullptr) {
+        return;
+    }
+
+    LOG_INFO(Loader, "    RomFS: LayeredFS patches applied successfully");
+    romfs = std::move(packed);
 }
 
 VirtualFile PatchManager::PatchRomFS(const NCA* base_nca, VirtualFile base_romfs,
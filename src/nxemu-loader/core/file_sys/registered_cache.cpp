@@ -2,13 +2,21 @@
 // SPDX-License-Identifier: GPL-2.0-or-later
 
 #include <algorithm>
+#include <atomic>
+#include <cstring>
 #include <random>
 #include <regex>
+#include <thread>
 #include "yuzu_common/yuzu_assert.h"
+#include "yuzu_common/cityhash.h"
+#include "yuzu_common/common_funcs.h"
+#include "yuzu_common/fs/file.h"
+#include "yuzu_common/fs/fs.h"
 #include "yuzu_common/fs/path_util.h"
 #include "yuzu_common/hex_util.h"
 #include "yuzu_common/logging/log.h"
 #include "yuzu_common/scope_exit.h"
+#include "core/crypto/sha256.h"
 #include "core/file_sys/card_image.h"
 #include "core/file_sys/common_funcs.h"
 #include "core/file_sys/content_archive.h"
@@ -16,6 +24,7 @@
 #include "core/file_sys/registered_cache.h"
 #include "core/file_sys/submission_package.h"
 #include "core/file_sys/vfs/vfs_concat.h"
+#include "core/file_sys/vfs/vfs_vector.h"
 #include "core/loader/loader.h"
 
 bool operator<(const ContentProviderEntry& lhs, const ContentProviderEntry& rhs) {
@@ -35,6 +44,35 @@ namespace FileSys {
 // The size of blocks to use when vfs raw copying into nand.
 constexpr size_t VFS_RC_LARGE_COPY_BLOCK = 0x400000;
 
+// Upper bound on the threads parsing NCA headers during a scan.
+constexpr size_t MAX_SCAN_THREADS = 8;
+
+constexpr u32 CONTENT_INDEX_MAGIC = Common::MakeMagic('R', 'C', 'I', 'X');
+constexpr u32 CONTENT_INDEX_VERSION = 1;
+
+// Shared by every provider so a union can tell a change of any of its slots from its own.
+std::atomic<u64> next_content_generation{1};
+
+struct ContentIndexHeader {
+    u32 magic;
+    u32 version;
+    u64 num_entries;
+};
+static_assert(sizeof(ContentIndexHeader) == 0x10, "ContentIndexHeader has incorrect size.");
+
+// Followed by path_size bytes of path and cnmt_size bytes of raw CNMT.
+struct ContentIndexEntry {
+    std::array<u8, 0x10> nca_id;
+    u64 size;
+    u64 modified;
+    u64 title_id;
+    u32 path_size;
+    u32 cnmt_size;
+    u32 is_meta;
+    u32 padding;
+};
+static_assert(sizeof(ContentIndexEntry) == 0x38, "ContentIndexEntry has incorrect size.");
+
 static bool FollowsTwoDigitDirFormat(std::string_view name) {
     static const std::regex two_digit_regex("000000[0-9A-F]{2}", std::regex_constants::ECMAScript |
                                                                      std::regex_constants::icase);
@@ -110,6 +148,14 @@ LoaderContentRecordType GetCRTypeFromNCAType(NCAContentType type) {
 
 ContentProvider::~ContentProvider() = default;
 
+u64 ContentProvider::GetGeneration() const {
+    return generation;
+}
+
+void ContentProvider::InvalidateEntries() {
+    generation = next_content_generation++;
+}
+
 bool ContentProvider::HasEntry(ContentProviderEntry entry) const {
     return HasEntry(entry.titleID, entry.type);
 }
@@ -315,6 +361,15 @@ VirtualFile RegisteredCache::OpenFileOrDirectoryConcat(const VirtualDir& open_di
 }
 
 VirtualFile RegisteredCache::GetFileAtID(NcaID id) const {
+    // NCAs found by the last scan are opened where they were found instead of probing every
+    // naming scheme.
+    if (const auto iter = nca_paths.find(id); iter != nca_paths.end()) {
+        auto file = OpenFileOrDirectoryConcat(dir, iter->second);
+        if (file != nullptr) {
+            return file;
+        }
+    }
+
     VirtualFile file;
     // Try all five relevant modes of file storage:
     // (bit 2 = uppercase/lower, bit 1 = within a two-digit dir, bit 0 = .cnmt suffix)
@@ -335,44 +390,35 @@ VirtualFile RegisteredCache::GetFileAtID(NcaID id) const {
     return file;
 }
 
-static std::optional<NcaID> CheckMapForContentRecord(const std::map<u64, CNMT>& map, u64 title_id,
-                                                     LoaderContentRecordType type) {
-    const auto cmnt_iter = map.find(title_id);
-    if (cmnt_iter == map.cend()) {
-        return std::nullopt;
-    }
-
-    const auto& cnmt = cmnt_iter->second;
-    const auto& content_records = cnmt.GetContentRecords();
-    const auto iter = std::find_if(content_records.cbegin(), content_records.cend(),
-                                   [type](const ContentRecord& rec) { return rec.type == type; });
-    if (iter == content_records.cend()) {
+std::optional<NcaID> RegisteredCache::GetNcaIDFromMetadata(u64 title_id,
+                                                           LoaderContentRecordType type) const {
+    const auto iter = record_index.find(ContentProviderEntry{title_id, type});
+    if (iter == record_index.end()) {
         return std::nullopt;
     }
-
-    return std::make_optional(iter->nca_id);
+    return iter->second;
 }
 
-std::optional<NcaID> RegisteredCache::GetNcaIDFromMetadata(u64 title_id,
-                                                           LoaderContentRecordType type) const {
-    if (type == LoaderContentRecordType::Meta && meta_id.find(title_id) != meta_id.end())
-        return meta_id.at(title_id);
-
-    const auto res1 = CheckMapForContentRecord(yuzu_meta, title_id, type);
-    if (res1)
-        return res1;
-    return CheckMapForContentRecord(meta, title_id, type);
-}
+std::vector<RegisteredCache::ScannedNca> RegisteredCache::AccumulateFiles() const {
+    std::vector<ScannedNca> ncas;
+    const auto add_nca = [this, &ncas](std::string path, std::string_view name, u64 size) {
+        const u64 modified = dir->GetFileTimeStamp(path).modified;
+        ncas.push_back(ScannedNca{
+            .id = Common::HexStringToArray<0x10, true>(name.substr(0, 0x20)),
+            .path = std::move(path),
+            .size = size,
+            .modified = modified,
+        });
+    };
 
-std::vector<NcaID> RegisteredCache::AccumulateFiles() const {
-    std::vector<NcaID> ids;
     for (const auto& d2_dir : dir->GetSubdirectories()) {
-        if (FollowsNcaIdFormat(d2_dir->GetName())) {
-            ids.push_back(Common::HexStringToArray<0x10, true>(d2_dir->GetName().substr(0, 0x20)));
+        const std::string d2_name = d2_dir->GetName();
+        if (FollowsNcaIdFormat(d2_name)) {
+            add_nca(d2_name, d2_name, 0);
             continue;
         }
 
-        if (!FollowsTwoDigitDirFormat(d2_dir->GetName()))
+        if (!FollowsTwoDigitDirFormat(d2_name))
             continue;
 
         for (const auto& nca_dir : d2_dir->GetSubdirectories()) {
@@ -380,7 +426,8 @@ std::vector<NcaID> RegisteredCache::AccumulateFiles() const {
                 continue;
             }
 
-            ids.push_back(Common::HexStringToArray<0x10, true>(nca_dir->GetName().substr(0, 0x20)));
+            const std::string name = nca_dir->GetName();
+            add_nca(fmt::format("{}/{}", d2_name, name), name, 0);
         }
 
         for (const auto& nca_file : d2_dir->GetFiles()) {
@@ -388,40 +435,206 @@ std::vector<NcaID> RegisteredCache::AccumulateFiles() const {
                 continue;
             }
 
-            ids.push_back(
-                Common::HexStringToArray<0x10, true>(nca_file->GetName().substr(0, 0x20)));
+            const std::string name = nca_file->GetName();
+            add_nca(fmt::format("{}/{}", d2_name, name), name, nca_file->GetSize());
         }
     }
 
     for (const auto& d2_file : dir->GetFiles()) {
-        if (FollowsNcaIdFormat(d2_file->GetName()))
-            ids.push_back(Common::HexStringToArray<0x10, true>(d2_file->GetName().substr(0, 0x20)));
+        const std::string name = d2_file->GetName();
+        if (FollowsNcaIdFormat(name))
+            add_nca(name, name, d2_file->GetSize());
     }
-    return ids;
+    return ncas;
 }
 
-void RegisteredCache::ProcessFiles(const std::vector<NcaID>& ids) {
-    for (const auto& id : ids) {
-        const auto file = GetFileAtID(id);
+std::optional<RegisteredCache::IndexedNca> RegisteredCache::ParseNca(
+    const ScannedNca& scanned) const {
+    const auto file = OpenFileOrDirectoryConcat(dir, scanned.path);
+    if (file == nullptr) {
+        return std::nullopt;
+    }
 
-        if (file == nullptr)
+    // Failed parses are not indexed, they are retried on the next scan in case keys were added.
+    const NCA nca(parser(file, scanned.id));
+    if (nca.GetStatus() != LoaderResultStatus::Success) {
+        return std::nullopt;
+    }
+
+    IndexedNca out{
+        .path = scanned.path,
+        .size = scanned.size,
+        .modified = scanned.modified,
+        .is_meta = false,
+        .title_id = nca.GetTitleId(),
+        .cnmt = {},
+    };
+    if (nca.GetType() != NCAContentType::Meta || nca.GetSubdirectories().empty()) {
+        return out;
+    }
+
+    const auto section0 = nca.GetSubdirectories()[0];
+    for (const auto& section0_file : section0->GetFiles()) {
+        if (section0_file->GetExtension() != "cnmt")
             continue;
-        const auto nca = std::make_shared<NCA>(parser(file, id));
-        if (nca->GetStatus() != LoaderResultStatus::Success ||
-            nca->GetType() != NCAContentType::Meta || nca->GetSubdirectories().empty()) {
+
+        out.is_meta = true;
+        out.cnmt = section0_file->ReadAllBytes();
+        break;
+    }
+    return out;
+}
+
+void RegisteredCache::ProcessFiles(const std::vector<ScannedNca>& ncas) {
+    const std::map<NcaID, IndexedNca> cached = LoadContentIndex();
+
+    // Reuse the parsed header of every NCA whose location, size and timestamp are unchanged.
+    std::vector<std::optional<IndexedNca>> results(ncas.size());
+    std::vector<std::size_t> to_parse;
+    for (std::size_t i = 0; i < ncas.size(); ++i) {
+        const ScannedNca& scanned = ncas[i];
+        const auto iter = cached.find(scanned.id);
+        if (iter != cached.end() && scanned.modified != 0 && iter->second.path == scanned.path &&
+            iter->second.size == scanned.size && iter->second.modified == scanned.modified) {
+            results[i] = iter->second;
+        } else {
+            to_parse.push_back(i);
+        }
+    }
+
+    // Parsing a header decrypts and validates the NCA, so spread the new ones over a few threads.
+    std::atomic<std::size_t> next_parse{};
+    const auto parse_worker = [&] {
+        for (std::size_t n = next_parse++; n < to_parse.size(); n = next_parse++) {
+            results[to_parse[n]] = ParseNca(ncas[to_parse[n]]);
+        }
+    };
+    const std::size_t num_threads =
+        std::min({MAX_SCAN_THREADS, std::max<std::size_t>(std::thread::hardware_concurrency(), 1),
+                  to_parse.size()});
+    {
+        std::vector<std::jthread> threads;
+        for (std::size_t i = 1; i < num_threads; ++i) {
+            threads.emplace_back(parse_worker);
+        }
+        parse_worker();
+    }
+
+    // Apply in scan order so duplicates resolve the same way a serial scan would.
+    std::map<NcaID, IndexedNca> index;
+    for (std::size_t i = 0; i < ncas.size(); ++i) {
+        if (!results[i]) {
             continue;
         }
 
-        const auto section0 = nca->GetSubdirectories()[0];
+        const IndexedNca& parsed = *results[i];
+        if (parsed.is_meta) {
+            meta.insert_or_assign(parsed.title_id,
+                                  CNMT(std::make_shared<VectorVfsFile>(parsed.cnmt)));
+            meta_id.insert_or_assign(parsed.title_id, ncas[i].id);
+        }
+        if (parsed.modified != 0) {
+            index.insert_or_assign(ncas[i].id, std::move(*results[i]));
+        }
+    }
 
-        for (const auto& section0_file : section0->GetFiles()) {
-            if (section0_file->GetExtension() != "cnmt")
-                continue;
+    LOG_DEBUG(Loader, "Scanned {} NCAs in {}, {} parsed and {} taken from the content index",
+              ncas.size(), dir->GetFullPath(), to_parse.size(), ncas.size() - to_parse.size());
+
+    if (!to_parse.empty() || index.size() != cached.size()) {
+        StoreContentIndex(index);
+    }
+}
+
+std::filesystem::path RegisteredCache::GetContentIndexPath() const {
+    const std::string full_path = dir->GetFullPath();
+    return Common::FS::GetYuzuPath(Common::FS::YuzuPath::CacheDir) / "content_index" /
+           fmt::format("{:016X}.bin", Common::CityHash64(full_path.data(), full_path.size()));
+}
 
-            meta.insert_or_assign(nca->GetTitleId(), CNMT(section0_file));
-            meta_id.insert_or_assign(nca->GetTitleId(), id);
-            break;
+std::map<NcaID, RegisteredCache::IndexedNca> RegisteredCache::LoadContentIndex() const {
+    const Common::FS::IOFile file{GetContentIndexPath(), Common::FS::FileAccessMode::Read,
+                                  Common::FS::FileType::BinaryFile};
+    if (!file.IsOpen()) {
+        return {};
+    }
+    std::vector<u8> data(file.GetSize());
+    if (data.size() < sizeof(ContentIndexHeader) ||
+        file.ReadSpan(std::span<u8>(data)) != data.size()) {
+        return {};
+    }
+
+    ContentIndexHeader header;
+    std::memcpy(&header, data.data(), sizeof(header));
+    if (header.magic != CONTENT_INDEX_MAGIC || header.version != CONTENT_INDEX_VERSION) {
+        return {};
+    }
+
+    std::map<NcaID, IndexedNca> out;
+    std::size_t pos = sizeof(header);
+    for (u64 i = 0; i < header.num_entries; ++i) {
+        ContentIndexEntry entry;
+        if (data.size() - pos < sizeof(entry)) {
+            return {};
+        }
+        std::memcpy(&entry, data.data() + pos, sizeof(entry));
+        pos += sizeof(entry);
+        if (data.size() - pos < static_cast<std::size_t>(entry.path_size) + entry.cnmt_size) {
+            return {};
         }
+
+        IndexedNca indexed{
+            .path = std::string(reinterpret_cast<const char*>(data.data() + pos), entry.path_size),
+            .size = entry.size,
+            .modified = entry.modified,
+            .is_meta = entry.is_meta != 0,
+            .title_id = entry.title_id,
+            .cnmt = {},
+        };
+        pos += entry.path_size;
+        indexed.cnmt.assign(data.begin() + pos, data.begin() + pos + entry.cnmt_size);
+        pos += entry.cnmt_size;
+
+        out.insert_or_assign(entry.nca_id, std::move(indexed));
+    }
+    return out;
+}
+
+void RegisteredCache::StoreContentIndex(const std::map<NcaID, IndexedNca>& index) const {
+    const ContentIndexHeader header{
+        .magic = CONTENT_INDEX_MAGIC,
+        .version = CONTENT_INDEX_VERSION,
+        .num_entries = index.size(),
+    };
+
+    std::vector<u8> data(sizeof(header));
+    std::memcpy(data.data(), &header, sizeof(header));
+    for (const auto& [id, indexed] : index) {
+        const ContentIndexEntry entry{
+            .nca_id = id,
+            .size = indexed.size,
+            .modified = indexed.modified,
+            .title_id = indexed.title_id,
+            .path_size = static_cast<u32>(indexed.path.size()),
+            .cnmt_size = static_cast<u32>(indexed.cnmt.size()),
+            .is_meta = indexed.is_meta ? 1U : 0U,
+            .padding = 0,
+        };
+        const auto* entry_bytes = reinterpret_cast<const u8*>(&entry);
+        data.insert(data.end(), entry_bytes, entry_bytes + sizeof(entry));
+        data.insert(data.end(), indexed.path.begin(), indexed.path.end());
+        data.insert(data.end(), indexed.cnmt.begin(), indexed.cnmt.end());
+    }
+
+    const auto index_path = GetContentIndexPath();
+    if (!Common::FS::CreateParentDirs(index_path)) {
+        return;
+    }
+    const Common::FS::IOFile file{index_path, Common::FS::FileAccessMode::Write,
+                                  Common::FS::FileType::BinaryFile};
+    if (!file.IsOpen() || file.WriteSpan(std::span<const u8>(data)) != data.size()) {
+        LOG_WARNING(Loader, "Failed to write content index {}",
+                    Common::FS::PathToUTF8String(index_path));
     }
 }
 
@@ -446,9 +659,50 @@ void RegisteredCache::Refresh() {
         return;
     }
 
-    const auto ids = AccumulateFiles();
-    ProcessFiles(ids);
+    const auto ncas = AccumulateFiles();
+    ProcessFiles(ncas);
     AccumulateYuzuMeta();
+
+    nca_paths.clear();
+    for (const auto& scanned : ncas) {
+        nca_paths.try_emplace(scanned.id, scanned.path);
+    }
+    BuildLookupIndex();
+}
+
+void RegisteredCache::BuildLookupIndex() {
+    InvalidateEntries();
+    record_index.clear();
+    entry_index.clear();
+
+    // Meta NCA ids take priority, then records from yuzu_meta, then records from installed CNMTs.
+    for (const auto& [title_id, id] : meta_id) {
+        record_index.try_emplace(ContentProviderEntry{title_id, LoaderContentRecordType::Meta}, id);
+    }
+    for (const auto* map : {&yuzu_meta, &meta}) {
+        for (const auto& [title_id, cnmt] : *map) {
+            for (const auto& rec : cnmt.GetContentRecords()) {
+                record_index.try_emplace(ContentProviderEntry{title_id, rec.type}, rec.nca_id);
+            }
+        }
+    }
+
+    const auto add_records = [this](const CNMT& cnmt) {
+        for (const auto& rec : cnmt.GetContentRecords()) {
+            if (nca_paths.contains(rec.nca_id)) {
+                entry_index.emplace_back(cnmt.GetType(),
+                                         ContentProviderEntry{cnmt.GetTitleID(), rec.type});
+            }
+        }
+    };
+    for (const auto& [title_id, cnmt] : meta) {
+        entry_index.emplace_back(cnmt.GetType(), ContentProviderEntry{cnmt.GetTitleID(),
+                                                                      EMPTY_META_CONTENT_RECORD.type});
+        add_records(cnmt);
+    }
+    for (const auto& [title_id, cnmt] : yuzu_meta) {
+        add_records(cnmt);
+    }
 }
 
 RegisteredCache::RegisteredCache(VirtualDir dir_, ContentProviderParsingFunction parsing_function)
@@ -493,48 +747,19 @@ IFileSysNCA * RegisteredCache::GetEntry(u64 title_id, LoaderContentRecordType ty
     return std::make_unique<NCA>(raw).release();
 }
 
-template <typename T>
-void RegisteredCache::IterateAllMetadata(
-    std::vector<T>& out, std::function<T(const CNMT&, const ContentRecord&)> proc,
-    std::function<bool(const CNMT&, const ContentRecord&)> filter) const {
-    for (const auto& kv : meta) {
-        const auto& cnmt = kv.second;
-        if (filter(cnmt, EMPTY_META_CONTENT_RECORD))
-            out.push_back(proc(cnmt, EMPTY_META_CONTENT_RECORD));
-        for (const auto& rec : cnmt.GetContentRecords()) {
-            if (GetFileAtID(rec.nca_id) != nullptr && filter(cnmt, rec)) {
-                out.push_back(proc(cnmt, rec));
-            }
-        }
-    }
-    for (const auto& kv : yuzu_meta) {
-        const auto& cnmt = kv.second;
-        for (const auto& rec : cnmt.GetContentRecords()) {
-            if (GetFileAtID(rec.nca_id) != nullptr && filter(cnmt, rec)) {
-                out.push_back(proc(cnmt, rec));
-            }
-        }
-    }
-}
-
 std::vector<ContentProviderEntry> RegisteredCache::ListEntriesFilter(
     std::optional<LoaderTitleType> title_type, std::optional<LoaderContentRecordType> record_type,
     std::optional<u64> title_id) const {
     std::vector<ContentProviderEntry> out;
-    IterateAllMetadata<ContentProviderEntry>(
-        out,
-        [](const CNMT& c, const ContentRecord& r) {
-            return ContentProviderEntry{c.GetTitleID(), r.type};
-        },
-        [&title_type, &record_type, &title_id](const CNMT& c, const ContentRecord& r) {
-            if (title_type && *title_type != c.GetType())
-                return false;
-            if (record_type && *record_type != r.type)
-                return false;
-            if (title_id && *title_id != c.GetTitleID())
-                return false;
-            return true;
-        });
+    for (const auto& [type, entry] : entry_index) {
+        if (title_type && *title_type != type)
+            continue;
+        if (record_type && *record_type != entry.type)
+            continue;
+        if (title_id && *title_id != entry.titleID)
+            continue;
+        out.push_back(entry);
+    }
     return out;
 }
 
@@ -685,7 +910,8 @@ InstallResult RegisteredCache::RawInstallNCA(const NCA& nca, const VfsCopyFuncti
         id = *override_id;
     } else {
         const auto& data = in->ReadBytes(0x100000);
-        UNIMPLEMENTED();
+        const auto hash = Core::Crypto::CalculateSHA256(data);
+        std::memcpy(id.data(), hash.data(), id.size());
     }
 
     std::string path = GetRelativePathFromNcaID(id, false, true, false);
@@ -742,10 +968,22 @@ ContentProviderUnion::~ContentProviderUnion() = default;
 
 void ContentProviderUnion::SetSlot(ContentProviderUnionSlot slot, ContentProvider* provider) {
     providers[slot] = provider;
+    InvalidateEntries();
 }
 
 void ContentProviderUnion::ClearSlot(ContentProviderUnionSlot slot) {
     providers[slot] = nullptr;
+    InvalidateEntries();
+}
+
+u64 ContentProviderUnion::GetGeneration() const {
+    u64 latest = ContentProvider::GetGeneration();
+    for (const auto& provider : providers) {
+        if (provider.second != nullptr) {
+            latest = std::max(latest, provider.second->GetGeneration());
+        }
+    }
+    return latest;
 }
 
 void ContentProviderUnion::Refresh() {
@@ -871,10 +1109,12 @@ ManualContentProvider::~ManualContentProvider() = default;
 void ManualContentProvider::AddEntry(LoaderTitleType title_type, LoaderContentRecordType content_type,
                                      u64 title_id, VirtualFile file) {
     entries.insert_or_assign({title_type, content_type, title_id}, file);
+    InvalidateEntries();
 }
 
 void ManualContentProvider::ClearAllEntries() {
     entries.clear();
+    InvalidateEntries();
 }
 
 void ManualContentProvider::Refresh() {}
@@ -4,9 +4,13 @@
 #pragma once
 
 #include <array>
+#include <filesystem>
 #include <functional>
+#include <map>
 #include <memory>
+#include <optional>
 #include <string>
+#include <unordered_map>
 #include <vector>
 #include <boost/container/flat_map.hpp>
 #include "yuzu_common/common_types.h"
@@ -55,6 +59,12 @@ bool operator<(const ContentProviderEntry& lhs, const ContentProviderEntry& rhs)
 bool operator==(const ContentProviderEntry& lhs, const ContentProviderEntry& rhs);
 bool operator!=(const ContentProviderEntry& lhs, const ContentProviderEntry& rhs);
 
+struct ContentProviderEntryHash {
+    std::size_t operator()(const ContentProviderEntry& entry) const noexcept {
+        return std::hash<u64>{}(entry.titleID ^ (static_cast<u64>(entry.type) << 56));
+    }
+};
+
 class ContentProvider {
 public:
     virtual ~ContentProvider();
@@ -78,6 +88,16 @@ public:
     virtual std::vector<ContentProviderEntry> ListEntriesFilter(
         std::optional<LoaderTitleType> title_type = {}, std::optional<LoaderContentRecordType> record_type = {},
         std::optional<u64> title_id = {}) const = 0;
+
+    // Changes whenever the listed entries may have changed, a list taken at the same generation
+    // is still current.
+    virtual u64 GetGeneration() const;
+
+protected:
+    void InvalidateEntries();
+
+private:
+    u64 generation{};
 };
 
 class PlaceholderCache {
@@ -170,13 +190,32 @@ public:
     bool RemoveExistingEntry(u64 title_id) const;
 
 private:
-    template <typename T>
-    void IterateAllMetadata(std::vector<T>& out,
-                            std::function<T(const CNMT&, const ContentRecord&)> proc,
-                            std::function<bool(const CNMT&, const ContentRecord&)> filter) const;
-    std::vector<NcaID> AccumulateFiles() const;
-    void ProcessFiles(const std::vector<NcaID>& ids);
+    struct ScannedNca {
+        NcaID id;
+        std::string path;
+        u64 size;
+        u64 modified;
+    };
+
+    // Result of parsing one NCA header, persisted in the content index so unchanged NCAs are not
+    // opened again on the next scan.
+    struct IndexedNca {
+        std::string path;
+        u64 size;
+        u64 modified;
+        bool is_meta;
+        u64 title_id;
+        std::vector<u8> cnmt;
+    };
+
+    std::vector<ScannedNca> AccumulateFiles() const;
+    void ProcessFiles(const std::vector<ScannedNca>& ncas);
+    std::optional<IndexedNca> ParseNca(const ScannedNca& scanned) const;
     void AccumulateYuzuMeta();
+    void BuildLookupIndex();
+    std::filesystem::path GetContentIndexPath() const;
+    std::map<NcaID, IndexedNca> LoadContentIndex() const;
+    void StoreContentIndex(const std::map<NcaID, IndexedNca>& index) const;
     std::optional<NcaID> GetNcaIDFromMetadata(u64 title_id, LoaderContentRecordType type) const;
     VirtualFile GetFileAtID(NcaID id) const;
     VirtualFile OpenFileOrDirectoryConcat(const VirtualDir& open_dir, std::string_view path) const;
@@ -193,6 +232,14 @@ private:
     std::map<u64, CNMT> meta;
     // maps tid -> meta for CNMT in yuzu_meta
     std::map<u64, CNMT> yuzu_meta;
+
+    // Lookup tables rebuilt on every refresh.
+    // maps NcaID -> path relative to dir where the scan found it
+    std::map<NcaID, std::string> nca_paths;
+    // maps (tid, record type) -> NcaID, in the priority order of GetNcaIDFromMetadata
+    std::unordered_map<ContentProviderEntry, NcaID, ContentProviderEntryHash> record_index;
+    // every entry ListEntriesFilter can return, with the title type of its CNMT
+    std::vector<std::pair<LoaderTitleType, ContentProviderEntry>> entry_index;
 };
 
 enum class ContentProviderUnionSlot {
@@ -227,6 +274,8 @@ public:
     std::optional<ContentProviderUnionSlot> GetSlotForEntry(u64 title_id,
                                                             LoaderContentRecordType type) const;
 
+    u64 GetGeneration() const override;
+
 private:
     std::map<ContentProviderUnionSlot, ContentProvider*> providers;
 };
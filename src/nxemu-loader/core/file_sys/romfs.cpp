@@ -164,4 +164,10 @@ VirtualFile CreateRomFS(VirtualDir dir, VirtualDir ext) {
     return ConcatenatedVfsFile::MakeConcatenatedFile(0, dir->GetName(), ctx.Build());
 }
 
+VirtualFile CreateRomFS(RomFSDirectoryOpener open_dirs, const std::filesystem::path& cache_path,
+                        u64 cache_key) {
+    RomFSBuildContext ctx{std::move(open_dirs)};
+    return ConcatenatedVfsFile::MakeConcatenatedFile(0, "", ctx.Build(cache_path, cache_key));
+}
+
 } // namespace FileSys
@@ -3,6 +3,8 @@
 
 #pragma once
 
+#include <filesystem>
+#include "core/file_sys/fsmitm_romfsbuild.h"
 #include "core/file_sys/vfs/vfs.h"
 
 namespace FileSys {
@@ -15,4 +17,11 @@ VirtualDir ExtractRomFS(VirtualFile file);
 // Returns nullptr on failure
 VirtualFile CreateRomFS(VirtualDir dir, VirtualDir ext = nullptr);
 
+// Like CreateRomFS, but reuses the layout stored in cache_path when it was built for the same
+// cache_key and stores the layout there otherwise. The directories are only opened once the
+// layout has to be built or a file is first read.
+// Returns nullptr on failure
+VirtualFile CreateRomFS(RomFSDirectoryOpener open_dirs, const std::filesystem::path& cache_path,
+                        u64 cache_key);
+
 } // namespace FileSys
@@ -8,6 +8,7 @@
 #include "yuzu_common/uuid.h"
 #include "core/file_sys/savedata_factory.h"
 #include "core/file_sys/vfs/vfs.h"
+#include "core/file_sys/vfs/vfs_buffered.h"
 
 namespace FileSys {
 
@@ -52,9 +53,10 @@ std::string GetFutureSaveDataPath(SaveDataSpaceId space_id, SaveDataType type, u
 
 } // Anonymous namespace
 
-SaveDataFactory::SaveDataFactory(Systemloader& loader_, ProgramId program_id_,
-                                 VirtualDir save_directory_)
-    : loader{loader_}, program_id{program_id_}, dir{std::move(save_directory_)} {
+SaveDataFactory::SaveDataFactory(Systemloader& loader_, BufferedSaveFlusher& flusher_,
+                                 ProgramId program_id_, VirtualDir save_directory_)
+    : loader{loader_}, flusher{flusher_}, program_id{program_id_},
+      dir{std::move(save_directory_)}, registry{std::make_shared<StoreRegistry>()} {
     // Delete all temporary storages
     // On hardware, it is expected that temporary storage be empty at first use.
     dir->DeleteSubdirectoryRecursive("temp");
@@ -66,7 +68,7 @@ VirtualDir SaveDataFactory::Create(SaveDataSpaceId space, const SaveDataAttribut
     const auto save_directory = GetFullPath(program_id, dir, space, meta.type, meta.program_id,
         u128{ meta.user_id[0], meta.user_id[1] }, meta.system_save_data_id);
 
-    return dir->CreateDirectoryRelative(save_directory);
+    return OpenBuffered(dir->CreateDirectoryRelative(save_directory));
 }
 
 VirtualDir SaveDataFactory::Open(SaveDataSpaceId space, const SaveDataAttribute& meta) const {
@@ -80,7 +82,7 @@ VirtualDir SaveDataFactory::Open(SaveDataSpaceId space, const SaveDataAttribute&
         return Create(space, meta);
     }
 
-    return out;
+    return OpenBuffered(std::move(out));
 }
 
 VirtualDir SaveDataFactory::GetSaveDataSpaceDirectory(SaveDataSpaceId space) const {
@@ -190,6 +192,39 @@ void SaveDataFactory::SetAutoCreate(bool state) {
     auto_create = state;
 }
 
+VirtualDir SaveDataFactory::OpenBuffered(VirtualDir save_directory) const {
+    if (save_directory == nullptr) {
+        return nullptr;
+    }
+
+    // Declared ahead of the lock, dropping the last reference runs the deleter below which takes it
+    std::shared_ptr<BufferedSaveStore> store;
+    std::string path = save_directory->GetFullPath();
+    std::scoped_lock lk{registry->mutex};
+    std::weak_ptr<BufferedSaveStore>& entry = registry->stores[path];
+    store = entry.lock();
+    if (store == nullptr) {
+        // Unregister the save when its last view is closed. The factory may be gone by then, so
+        // the deleter only holds on to the registry. A store opened again for the same path in
+        // the meantime owns the entry and keeps it.
+        const auto closed = [registry = std::weak_ptr<StoreRegistry>{registry},
+                             path](BufferedSaveStore* closed_store) {
+            if (const auto live_registry = registry.lock()) {
+                std::scoped_lock registry_lk{live_registry->mutex};
+                const auto it = live_registry->stores.find(path);
+                if (it != live_registry->stores.end() && it->second.expired()) {
+                    live_registry->stores.erase(it);
+                }
+            }
+            delete closed_store;
+        };
+        store = std::shared_ptr<BufferedSaveStore>(
+            new BufferedSaveStore(std::move(save_directory), flusher), closed);
+        entry = store;
+    }
+    return store->OpenRoot();
+}
+
 } // namespace FileSys
 
 SaveDataFactoryPtr::SaveDataFactoryPtr(std::shared_ptr<FileSys::SaveDataFactory> saveDataFactory) :
@@ -203,8 +238,12 @@ SaveDataFactoryPtr::~SaveDataFactoryPtr()
 
 IVirtualDirectory* SaveDataFactoryPtr::Open(SaveDataSpaceId space, const SaveDataAttribute& meta) const
 {
-    UNIMPLEMENTED();
-    return nullptr;
+    FileSys::VirtualDir dir = m_saveDataFactory->Open(space, meta);
+    if (dir == nullptr)
+    {
+        return nullptr;
+    }
+    return std::make_unique<VirtualDirectoryPtr>(dir).release();
 }
 
 void SaveDataFactoryPtr::Release()
@@ -3,7 +3,9 @@
 
 #pragma once
 
+#include <map>
 #include <memory>
+#include <mutex>
 #include <string>
 #include "yuzu_common/common_funcs.h"
 #include "yuzu_common/common_types.h"
@@ -20,11 +22,14 @@ constexpr const char* GetSaveDataSizeFileName() {
 
 using ProgramId = u64;
 
+class BufferedSaveFlusher;
+class BufferedSaveStore;
+
 /// File system interface to the SaveData archive
 class SaveDataFactory {
 public:
-    explicit SaveDataFactory(Systemloader & loader_, ProgramId program_id_,
-                             VirtualDir save_directory_);
+    explicit SaveDataFactory(Systemloader & loader_, BufferedSaveFlusher& flusher_,
+                             ProgramId program_id_, VirtualDir save_directory_);
     ~SaveDataFactory();
 
     VirtualDir Create(SaveDataSpaceId space, const SaveDataAttribute& meta) const;
@@ -44,10 +49,22 @@ public:
     void SetAutoCreate(bool state);
 
 private:
+    /// Returns the buffered view of save_directory, sharing uncommitted writes with any other
+    /// open instance of the same save.
+    VirtualDir OpenBuffered(VirtualDir save_directory) const;
+
     Systemloader & loader;
+    BufferedSaveFlusher& flusher;
     ProgramId program_id;
     VirtualDir dir;
     bool auto_create{true};
+
+    /// Saves with an open buffered view, an entry is erased once the last view of it is closed.
+    struct StoreRegistry {
+        std::mutex mutex;
+        std::map<std::string, std::weak_ptr<BufferedSaveStore>> stores;
+    };
+    std::shared_ptr<StoreRegistry> registry;
 };
 
 } // namespace FileSys
@@ -9,22 +9,99 @@
 #include "core/file_sys/system_archive/data/font_standard.h"
 #include "core/file_sys/system_archive/shared_font.h"
 #include "core/file_sys/vfs/vfs_vector.h"
-#include <yuzu_common/yuzu_assert.h>
+#include <yuzu_common/swap.h>
+
+#include <algorithm>
+#include <cstring>
+#include <span>
 
 namespace FileSys::SystemArchive {
 
 namespace {
 
-template <std::size_t Size>
-VirtualFile PackBFTTF(const std::array<u8, Size>& data, const std::string& name) {
-    std::vector<u32> vec(Size / sizeof(u32));
-    std::memcpy(vec.data(), data.data(), vec.size() * sizeof(u32));
+constexpr u32 EXPECTED_RESULT{0x7f9a0218}; // What we expect the decrypted bfttf first 4 bytes to be
+constexpr u32 EXPECTED_MAGIC{0x36f81a1e};  // What we expect the encrypted bfttf first 4 bytes to be
+
+// Serves the encrypted BFTTF form of a font straight from its embedded table: an 8 byte header
+// followed by the font words xored with the key. Nothing is copied when the archive is built.
+class SharedFontVfsFile : public VfsFile {
+public:
+    explicit SharedFontVfsFile(std::span<const u8> font_, std::string name_)
+        : font{font_}, name{std::move(name_)} {
+        const u32 key = Common::swap32(EXPECTED_RESULT ^ EXPECTED_MAGIC);
+        const u32 words[2]{
+            Common::swap32(EXPECTED_MAGIC),
+            Common::swap32(static_cast<u32>(font.size() / sizeof(u32) * sizeof(u32))) ^ key,
+        };
+        std::memcpy(header.data(), words, sizeof(words));
+        std::memcpy(key_bytes.data(), &key, sizeof(key));
+    }
+
+    std::string GetName() const override {
+        return name;
+    }
+
+    std::size_t GetSize() const override {
+        return font.size() + header.size();
+    }
+
+    bool Resize(std::size_t new_size) override {
+        return false;
+    }
+
+    VirtualDir GetContainingDirectory() const override {
+        return nullptr;
+    }
 
-    std::vector<u8> bfttf(Size + sizeof(u64));
+    bool IsWritable() const override {
+        return false;
+    }
 
-    size_t offset = 0;
-    UNIMPLEMENTED();
-    return std::make_shared<VectorVfsFile>(std::move(bfttf), name);
+    bool IsReadable() const override {
+        return true;
+    }
+
+    std::size_t Read(u8* data, std::size_t length, std::size_t offset) const override {
+        const std::size_t size = GetSize();
+        if (offset >= size) {
+            return 0;
+        }
+        const std::size_t read = std::min(length, size - offset);
+        // Trailing bytes that do not fill a whole word are not part of the encrypted font
+        const std::size_t font_end = header.size() + font.size() / sizeof(u32) * sizeof(u32);
+        for (std::size_t i = 0; i < read; i++) {
+            const std::size_t position = offset + i;
+            if (position < header.size()) {
+                data[i] = header[position];
+            } else if (position < font_end) {
+                const std::size_t font_offset = position - header.size();
+                data[i] = font[font_offset] ^ key_bytes[font_offset % sizeof(u32)];
+            } else {
+                data[i] = 0;
+            }
+        }
+        return read;
+    }
+
+    std::size_t Write(const u8* data, std::size_t length, std::size_t offset) override {
+        return 0;
+    }
+
+    bool Rename(std::string_view new_name) override {
+        name = new_name;
+        return true;
+    }
+
+private:
+    std::span<const u8> font;
+    std::string name;
+    std::array<u8, sizeof(u64)> header{};
+    std::array<u8, sizeof(u32)> key_bytes{};
+};
+
+template <std::size_t Size>
+VirtualFile PackBFTTF(const std::array<u8, Size>& data, const std::string& name) {
+    return std::make_shared<SharedFontVfsFile>(data, name);
 }
 
 } // Anonymous namespace
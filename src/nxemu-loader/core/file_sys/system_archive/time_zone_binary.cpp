@@ -1,86 +1,93 @@
 // SPDX-FileCopyrightText: Copyright 2019 yuzu Emulator Project
 // SPDX-License-Identifier: GPL-2.0-or-later
 
+#include <array>
+#include <span>
 #include <vector>
 
 #include "yuzu_common/swap.h"
 #include "core/file_sys/system_archive/time_zone_binary.h"
+#include "core/file_sys/vfs/vfs_compressed.h"
 #include "core/file_sys/vfs/vfs_vector.h"
 
 #include "nx_tzdb.h"
 
 namespace FileSys::SystemArchive {
 
-const static std::map<std::string, const std::map<const char*, const std::vector<u8>>&>
-    tzdb_zoneinfo_dirs = {{"Africa", NxTzdb::africa},
-                          {"America", NxTzdb::america},
-                          {"Antarctica", NxTzdb::antarctica},
-                          {"Arctic", NxTzdb::arctic},
-                          {"Asia", NxTzdb::asia},
-                          {"Atlantic", NxTzdb::atlantic},
-                          {"Australia", NxTzdb::australia},
-                          {"Brazil", NxTzdb::brazil},
-                          {"Canada", NxTzdb::canada},
-                          {"Chile", NxTzdb::chile},
-                          {"Etc", NxTzdb::etc},
-                          {"Europe", NxTzdb::europe},
-                          {"Indian", NxTzdb::indian},
-                          {"Mexico", NxTzdb::mexico},
-                          {"Pacific", NxTzdb::pacific},
-                          {"US", NxTzdb::us}};
+namespace {
 
-const static std::map<std::string, const std::map<const char*, const std::vector<u8>>&>
-    tzdb_america_dirs = {{"Argentina", NxTzdb::america_argentina},
-                         {"Indiana", NxTzdb::america_indiana},
-                         {"Kentucky", NxTzdb::america_kentucky},
-                         {"North_Dakota", NxTzdb::america_north_dakota}};
+struct TzdbDirectory {
+    std::string_view name;
+    std::span<const NxTzdb::File> files;
+    const u8* data;
+};
 
-static void GenerateFiles(std::vector<VirtualFile>& directory,
-                          const std::map<const char*, const std::vector<u8>>& files) {
-    for (const auto& [filename, data] : files) {
-        const auto data_copy{data};
-        const std::string filename_copy{filename};
-        VirtualFile file{
-            std::make_shared<VectorVfsFile>(std::move(data_copy), std::move(filename_copy))};
-        directory.push_back(file);
+// The generated tables are constant data, so these are built without any static initialization
+constexpr std::array tzdb_zoneinfo_dirs{
+    TzdbDirectory{"Africa", NxTzdb::africa, NxTzdb::africa_data},
+    TzdbDirectory{"America", NxTzdb::america, NxTzdb::america_data},
+    TzdbDirectory{"Antarctica", NxTzdb::antarctica, NxTzdb::antarctica_data},
+    TzdbDirectory{"Arctic", NxTzdb::arctic, NxTzdb::arctic_data},
+    TzdbDirectory{"Asia", NxTzdb::asia, NxTzdb::asia_data},
+    TzdbDirectory{"Atlantic", NxTzdb::atlantic, NxTzdb::atlantic_data},
+    TzdbDirectory{"Australia", NxTzdb::australia, NxTzdb::australia_data},
+    TzdbDirectory{"Brazil", NxTzdb::brazil, NxTzdb::brazil_data},
+    TzdbDirectory{"Canada", NxTzdb::canada, NxTzdb::canada_data},
+    TzdbDirectory{"Chile", NxTzdb::chile, NxTzdb::chile_data},
+    TzdbDirectory{"Etc", NxTzdb::etc, NxTzdb::etc_data},
+    TzdbDirectory{"Europe", NxTzdb::europe, NxTzdb::europe_data},
+    TzdbDirectory{"Indian", NxTzdb::indian, NxTzdb::indian_data},
+    TzdbDirectory{"Mexico", NxTzdb::mexico, NxTzdb::mexico_data},
+    TzdbDirectory{"Pacific", NxTzdb::pacific, NxTzdb::pacific_data},
+    TzdbDirectory{"US", NxTzdb::us, NxTzdb::us_data},
+};
+
+constexpr std::array tzdb_america_dirs{
+    TzdbDirectory{"Argentina", NxTzdb::america_argentina, NxTzdb::america_argentina_data},
+    TzdbDirectory{"Indiana", NxTzdb::america_indiana, NxTzdb::america_indiana_data},
+    TzdbDirectory{"Kentucky", NxTzdb::america_kentucky, NxTzdb::america_kentucky_data},
+    TzdbDirectory{"North_Dakota", NxTzdb::america_north_dakota,
+                  NxTzdb::america_north_dakota_data},
+};
+
+std::vector<VirtualFile> GenerateFiles(std::span<const NxTzdb::File> files, const u8* data) {
+    std::vector<VirtualFile> directory;
+    directory.reserve(files.size());
+    for (const NxTzdb::File& file : files) {
+        directory.push_back(std::make_shared<CompressedVfsFile>(
+            std::span<const u8>{data + file.offset, file.compressed_size}, file.size, file.name));
     }
+    return directory;
 }
 
-static std::vector<VirtualFile> GenerateZoneinfoFiles() {
-    std::vector<VirtualFile> zoneinfo_files;
-    GenerateFiles(zoneinfo_files, NxTzdb::zoneinfo);
-    return zoneinfo_files;
-}
+} // Anonymous namespace
 
 VirtualDir TimeZoneBinary() {
     std::vector<VirtualDir> america_sub_dirs;
-    for (const auto& [dir_name, files] : tzdb_america_dirs) {
-        std::vector<VirtualFile> vfs_files;
-        GenerateFiles(vfs_files, files);
+    for (const TzdbDirectory& dir : tzdb_america_dirs) {
         america_sub_dirs.push_back(std::make_shared<VectorVfsDirectory>(
-            std::move(vfs_files), std::vector<VirtualDir>{}, dir_name));
+            GenerateFiles(dir.files, dir.data), std::vector<VirtualDir>{}, std::string{dir.name}));
     }
 
     std::vector<VirtualDir> zoneinfo_sub_dirs;
-    for (const auto& [dir_name, files] : tzdb_zoneinfo_dirs) {
-        std::vector<VirtualFile> vfs_files;
-        GenerateFiles(vfs_files, files);
-        if (dir_name == "America") {
+    for (const TzdbDirectory& dir : tzdb_zoneinfo_dirs) {
+        if (dir.name == "America") {
             zoneinfo_sub_dirs.push_back(std::make_shared<VectorVfsDirectory>(
-                std::move(vfs_files), std::move(america_sub_dirs), dir_name));
+                GenerateFiles(dir.files, dir.data), std::move(america_sub_dirs),
+                std::string{dir.name}));
         } else {
             zoneinfo_sub_dirs.push_back(std::make_shared<VectorVfsDirectory>(
-                std::move(vfs_files), std::vector<VirtualDir>{}, dir_name));
+                GenerateFiles(dir.files, dir.data), std::vector<VirtualDir>{},
+                std::string{dir.name}));
         }
     }
 
     std::vector<VirtualDir> zoneinfo_dir{std::make_shared<VectorVfsDirectory>(
-        GenerateZoneinfoFiles(), std::move(zoneinfo_sub_dirs), "zoneinfo")};
-    std::vector<VirtualFile> root_files;
-    GenerateFiles(root_files, NxTzdb::base);
+        GenerateFiles(NxTzdb::zoneinfo, NxTzdb::zoneinfo_data), std::move(zoneinfo_sub_dirs),
+        "zoneinfo")};
 
-    return std::make_shared<VectorVfsDirectory>(std::move(root_files), std::move(zoneinfo_dir),
-                                                "data");
+    return std::make_shared<VectorVfsDirectory>(GenerateFiles(NxTzdb::base, NxTzdb::base_data),
+                                                std::move(zoneinfo_dir), "data");
 }
 
 } // namespace FileSys::SystemArchive
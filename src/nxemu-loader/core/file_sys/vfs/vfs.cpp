@@ -429,6 +429,10 @@ std::string VfsDirectory::GetFullPath() const {
     return GetParentDirectory()->GetFullPath() + '/' + GetName();
 }
 
+bool VfsDirectory::Commit() {
+    return true;
+}
+
 bool ReadOnlyVfsDirectory::IsWritable() const {
     return false;
 }
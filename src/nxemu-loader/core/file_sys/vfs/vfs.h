@@ -283,6 +283,10 @@ public:
 
     // Returns the full path of this directory as a string, recursively
     virtual std::string GetFullPath() const;
+
+    // Makes the writes to files in this directory tree durable. Directories that write straight
+    // through to their backing storage have nothing to do and return true.
+    virtual bool Commit();
 };
 
 // A convenience partial-implementation of VfsDirectory that stubs out methods that should only work
@@ -0,0 +1,856 @@
+// SPDX-FileCopyrightText: Copyright 2024 yuzu Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstring>
+#include <limits>
+#include <optional>
+#include <set>
+#include <span>
+#include <utility>
+#include "yuzu_common/cityhash.h"
+#include "yuzu_common/common_funcs.h"
+#include "yuzu_common/div_ceil.h"
+#include "yuzu_common/fs/path_util.h"
+#include "yuzu_common/logging/log.h"
+#include "yuzu_common/thread.h"
+#include "core/file_sys/vfs/vfs_buffered.h"
+
+namespace FileSys {
+
+struct BufferedFileState {
+    using Page = std::array<u8, BufferedSaveStore::PageSize>;
+
+    std::mutex mutex;
+    VirtualFile base;
+    std::string path;
+    std::size_t size{};
+
+    // Pages written since they were last flushed, shared with any snapshot still being flushed.
+    std::map<std::size_t, std::shared_ptr<Page>> pages;
+    std::set<std::size_t> dirty;
+    bool size_dirty{};
+
+    // Commits of this file taken so far, used to match truncates with the snapshot carrying them.
+    u64 epoch{};
+    // Smallest size the file was truncated to in each epoch that is not flushed yet.
+    std::map<u64, std::size_t> pending_truncates;
+    // Bytes from here on that are not resident read as zero, the backing file still holds the
+    // data from before an unflushed truncate.
+    std::size_t base_limit{std::numeric_limits<std::size_t>::max()};
+};
+
+struct BufferedSaveStore::FileSnapshot {
+    std::shared_ptr<BufferedFileState> state;
+    std::string path;
+    std::size_t size{};
+    u64 epoch{};
+    std::optional<std::size_t> truncate_to;
+    std::vector<std::pair<std::size_t, std::shared_ptr<const BufferedFileState::Page>>> pages;
+};
+
+struct BufferedSaveStore::CommitSnapshot {
+    std::chrono::steady_clock::time_point committed_at;
+    std::vector<FileSnapshot> files;
+};
+
+namespace {
+
+constexpr char JournalName[] = ".nxemu_save_journal";
+constexpr u32 JournalMagic = Common::MakeMagic('S', 'V', 'J', 'N');
+constexpr u32 JournalVersion = 1;
+constexpr u64 JournalNoTruncate = std::numeric_limits<u64>::max();
+
+struct JournalHeader {
+    u32 magic;
+    u32 version;
+    u64 body_size;
+    u64 body_hash;
+};
+static_assert(sizeof(JournalHeader) == 0x18, "JournalHeader has incorrect size.");
+
+using PageSpan = std::pair<std::size_t, std::span<const u8>>;
+
+template <typename T>
+void AppendValue(std::vector<u8>& out, const T& value) {
+    const auto* bytes = reinterpret_cast<const u8*>(&value);
+    out.insert(out.end(), bytes, bytes + sizeof(T));
+}
+
+template <typename T>
+bool TakeValue(std::span<const u8>& in, T& value) {
+    if (in.size() < sizeof(T)) {
+        return false;
+    }
+    std::memcpy(&value, in.data(), sizeof(T));
+    in = in.subspan(sizeof(T));
+    return true;
+}
+
+u64 ElapsedUs(std::chrono::steady_clock::time_point start) {
+    return static_cast<u64>(std::chrono::duration_cast<std::chrono::microseconds>(
+                                std::chrono::steady_clock::now() - start)
+                                .count());
+}
+
+std::string JoinPath(std::string_view parent, std::string_view name) {
+    if (parent.empty()) {
+        return std::string(name);
+    }
+    return fmt::format("{}/{}", parent, name);
+}
+
+// Paths inside a store are relative to the save root and always use '/'.
+std::string ParentPath(std::string_view path) {
+    const std::size_t separator = path.rfind('/');
+    return separator == std::string_view::npos ? std::string{}
+                                               : std::string(path.substr(0, separator));
+}
+
+bool IsSameOrChildPath(std::string_view path, std::string_view parent) {
+    return path == parent || (path.size() > parent.size() && path.starts_with(parent) &&
+                              path[parent.size()] == '/');
+}
+
+// Brings a backing file up to date with one file of a commit, adding the bytes written to
+// written. Returns false if a resize failed or a write came up short.
+bool ApplyFileUpdate(const VirtualFile& base, std::size_t size,
+                     std::optional<std::size_t> truncate_to, std::span<const PageSpan> pages,
+                     u64& written) {
+    bool applied = !truncate_to || base->Resize(*truncate_to);
+    for (const auto& [index, data] : pages) {
+        const std::size_t page_written =
+            base->Write(data.data(), data.size(), index * BufferedSaveStore::PageSize);
+        written += page_written;
+        applied = applied && page_written == data.size();
+    }
+    if (base->GetSize() != size && !base->Resize(size)) {
+        applied = false;
+    }
+    return applied;
+}
+
+} // Anonymous namespace
+
+BufferedSaveFlusher::BufferedSaveFlusher()
+    : thread{[this](std::stop_token stop_token) { ThreadLoop(stop_token); }} {}
+
+BufferedSaveFlusher::~BufferedSaveFlusher() = default;
+
+void BufferedSaveFlusher::Enqueue(std::shared_ptr<BufferedSaveStore> store) {
+    std::scoped_lock lk{queue_mutex};
+    queue.emplace_back(std::move(store));
+    queue_cv.notify_one();
+}
+
+void BufferedSaveFlusher::ThreadLoop(std::stop_token stop_token) {
+    Common::SetCurrentThreadName("SaveDataFlusher");
+
+    while (true) {
+        std::shared_ptr<BufferedSaveStore> store;
+        {
+            std::unique_lock lk{queue_mutex};
+            Common::CondvarWait(queue_cv, lk, stop_token, [this] { return !queue.empty(); });
+            // Keep draining after a stop request so no commit is lost on shutdown.
+            if (queue.empty()) {
+                return;
+            }
+            store = std::move(queue.front());
+            queue.pop_front();
+        }
+        store->FlushPending();
+    }
+}
+
+BufferedSaveStore::BufferedSaveStore(VirtualDir root_, BufferedSaveFlusher& flusher_)
+    : root{std::move(root_)}, flusher{flusher_} {
+    ReplayJournal();
+}
+
+BufferedSaveStore::~BufferedSaveStore() {
+    std::scoped_lock lk{flush_mutex};
+    FlushPendingLocked();
+
+    CommitSnapshot snapshot;
+    {
+        std::scoped_lock state_lk{state_mutex};
+        snapshot = TakeSnapshot();
+    }
+    if (!snapshot.files.empty()) {
+        LOG_WARNING(Service_FS, "Writing {} files with uncommitted changes in {}",
+                    snapshot.files.size(), root->GetFullPath());
+        FlushSnapshot(snapshot);
+    }
+    LogStats();
+}
+
+VirtualDir BufferedSaveStore::OpenRoot() {
+    return std::make_shared<BufferedVfsDirectory>(shared_from_this(), root, std::string{});
+}
+
+bool BufferedSaveStore::Commit() {
+    const auto start = std::chrono::steady_clock::now();
+    bool queued = false;
+    bool flushed = true;
+    {
+        std::scoped_lock lk{state_mutex};
+        flushed = !std::exchange(flush_failed, false);
+        CommitSnapshot snapshot = TakeSnapshot();
+        if (!snapshot.files.empty()) {
+            snapshot.committed_at = start;
+            pending_commits.emplace_back(std::move(snapshot));
+            queued = true;
+        }
+    }
+    if (queued) {
+        flusher.Enqueue(shared_from_this());
+    }
+
+    const u64 commit_us = ElapsedUs(start);
+    std::scoped_lock lk{stats_mutex};
+    stats.commits++;
+    stats.total_commit_us += commit_us;
+    stats.max_commit_us = std::max(stats.max_commit_us, commit_us);
+    return flushed;
+}
+
+void BufferedSaveStore::FlushPending() {
+    std::scoped_lock lk{flush_mutex};
+    FlushPendingLocked();
+}
+
+void BufferedSaveStore::FlushPendingLocked() {
+    while (true) {
+        CommitSnapshot snapshot;
+        {
+            std::scoped_lock lk{state_mutex};
+            if (pending_commits.empty()) {
+                return;
+            }
+            snapshot = std::move(pending_commits.front());
+            pending_commits.erase(pending_commits.begin());
+        }
+        FlushSnapshot(snapshot);
+
+        const u64 flush_us = ElapsedUs(snapshot.committed_at);
+        std::scoped_lock lk{stats_mutex};
+        stats.flushes++;
+        stats.total_flush_us += flush_us;
+        stats.max_flush_us = std::max(stats.max_flush_us, flush_us);
+    }
+}
+
+std::shared_ptr<BufferedFileState> BufferedSaveStore::GetFileState(const VirtualFile& base,
+                                                                   const std::string& path) {
+    std::scoped_lock lk{state_mutex};
+    auto [it, inserted] = files.try_emplace(path);
+    if (inserted) {
+        auto state = std::make_shared<BufferedFileState>();
+        state->base = base;
+        state->path = path;
+        state->size = base->GetSize();
+        it->second = std::move(state);
+    }
+    return it->second;
+}
+
+bool BufferedSaveStore::DeletePath(const std::string& path,
+                                   const std::function<bool()>& remove) {
+    // Flush first so the queued commits never address a file that is gone.
+    std::scoped_lock lk{flush_mutex};
+    FlushPendingLocked();
+    {
+        std::scoped_lock state_lk{state_mutex};
+        std::erase_if(files, [&path](const auto& entry) {
+            return IsSameOrChildPath(entry.first, path);
+        });
+    }
+    return remove();
+}
+
+bool BufferedSaveStore::RenamePath(const std::string& old_path, const std::string& new_path,
+                                   const std::function<bool()>& rename) {
+    std::scoped_lock lk{flush_mutex};
+    FlushPendingLocked();
+    if (!rename()) {
+        return false;
+    }
+
+    std::scoped_lock state_lk{state_mutex};
+    std::vector<std::shared_ptr<BufferedFileState>> moved;
+    for (auto it = files.begin(); it != files.end();) {
+        if (IsSameOrChildPath(it->first, old_path)) {
+            moved.push_back(std::move(it->second));
+            it = files.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    for (auto& state : moved) {
+        std::scoped_lock file_lk{state->mutex};
+        state->path = new_path + state->path.substr(old_path.size());
+        if (VirtualFile base = root->GetFileRelative(state->path); base != nullptr) {
+            state->base = std::move(base);
+        }
+        files.insert_or_assign(state->path, state);
+    }
+    return true;
+}
+
+std::size_t BufferedSaveStore::Read(BufferedFileState& state, u8* data, std::size_t length,
+                                    std::size_t offset) const {
+    std::scoped_lock lk{state.mutex};
+    if (offset >= state.size) {
+        return 0;
+    }
+    length = std::min(length, state.size - offset);
+
+    const auto read_base = [&state](u8* out, std::size_t out_length, std::size_t out_offset) {
+        std::memset(out, 0, out_length);
+        if (out_offset < state.base_limit) {
+            state.base->Read(out, std::min(out_length, state.base_limit - out_offset),
+                             out_offset);
+        }
+    };
+
+    std::size_t done = 0;
+    while (done < length) {
+        const std::size_t position = offset + done;
+        const std::size_t index = position / PageSize;
+        const std::size_t page_offset = position % PageSize;
+        std::size_t chunk = std::min(length - done, PageSize - page_offset);
+
+        if (const auto it = state.pages.find(index); it != state.pages.end()) {
+            std::memcpy(data + done, it->second->data() + page_offset, chunk);
+        } else {
+            // Read the whole run of pages that are not resident with a single backing read.
+            const auto next = state.pages.upper_bound(index);
+            const std::size_t run_end =
+                next == state.pages.end() ? length : next->first * PageSize - offset;
+            chunk = std::min(length, run_end) - done;
+            read_base(data + done, chunk, position);
+        }
+        done += chunk;
+    }
+    return length;
+}
+
+std::size_t BufferedSaveStore::Write(BufferedFileState& state, const u8* data, std::size_t length,
+                                     std::size_t offset) {
+    {
+        std::scoped_lock lk{state.mutex};
+        std::size_t done = 0;
+        while (done < length) {
+            const std::size_t position = offset + done;
+            const std::size_t index = position / PageSize;
+            const std::size_t page_offset = position % PageSize;
+            const std::size_t chunk = std::min(length - done, PageSize - page_offset);
+
+            auto& page = state.pages[index];
+            if (page == nullptr) {
+                page = std::make_shared<BufferedFileState::Page>();
+                page->fill(0);
+                const std::size_t page_start = index * PageSize;
+                if (chunk != PageSize && page_start < std::min(state.size, state.base_limit)) {
+                    state.base->Read(page->data(),
+                                     std::min({PageSize, state.size - page_start,
+                                               state.base_limit - page_start}),
+                                     page_start);
+                }
+            } else if (page.use_count() > 1) {
+                // The page belongs to a commit that is still being flushed, leave that copy alone.
+                page = std::make_shared<BufferedFileState::Page>(*page);
+            }
+            std::memcpy(page->data() + page_offset, data + done, chunk);
+            state.dirty.insert(index);
+            done += chunk;
+        }
+        if (offset + length > state.size) {
+            state.size = offset + length;
+            state.size_dirty = true;
+        }
+    }
+
+    std::scoped_lock lk{stats_mutex};
+    stats.guest_bytes_written += length;
+    return length;
+}
+
+bool BufferedSaveStore::Resize(BufferedFileState& state, std::size_t new_size) {
+    std::scoped_lock lk{state.mutex};
+    if (new_size == state.size) {
+        return true;
+    }
+
+    if (new_size < state.size) {
+        const std::size_t first_dropped = Common::DivCeil(new_size, PageSize);
+        state.pages.erase(state.pages.lower_bound(first_dropped), state.pages.end());
+        state.dirty.erase(state.dirty.lower_bound(first_dropped), state.dirty.end());
+
+        if (const std::size_t tail = new_size % PageSize; tail != 0) {
+            const std::size_t index = new_size / PageSize;
+            if (auto it = state.pages.find(index); it != state.pages.end()) {
+                if (it->second.use_count() > 1) {
+                    it->second = std::make_shared<BufferedFileState::Page>(*it->second);
+                }
+                std::fill(it->second->begin() + tail, it->second->end(), u8{0});
+                state.dirty.insert(index);
+            }
+        }
+
+        auto [it, inserted] = state.pending_truncates.try_emplace(state.epoch, new_size);
+        if (!inserted) {
+            it->second = std::min(it->second, new_size);
+        }
+        state.base_limit = std::min(state.base_limit, new_size);
+    }
+
+    state.size = new_size;
+    state.size_dirty = true;
+    return true;
+}
+
+std::size_t BufferedSaveStore::GetSize(BufferedFileState& state) const {
+    std::scoped_lock lk{state.mutex};
+    return state.size;
+}
+
+bool BufferedSaveStore::IsJournalName(std::string_view name) {
+    return name == JournalName;
+}
+
+BufferedSaveStore::CommitSnapshot BufferedSaveStore::TakeSnapshot() {
+    CommitSnapshot snapshot;
+    for (const auto& [path, state] : files) {
+        std::scoped_lock lk{state->mutex};
+        if (state->dirty.empty() && !state->size_dirty) {
+            continue;
+        }
+
+        FileSnapshot& file = snapshot.files.emplace_back();
+        file.state = state;
+        file.path = path;
+        file.size = state->size;
+        file.epoch = state->epoch;
+        if (const auto it = state->pending_truncates.find(state->epoch);
+            it != state->pending_truncates.end()) {
+            file.truncate_to = it->second;
+        }
+        file.pages.reserve(state->dirty.size());
+        for (const std::size_t index : state->dirty) {
+            file.pages.emplace_back(index, state->pages.at(index));
+        }
+
+        state->dirty.clear();
+        state->size_dirty = false;
+        state->epoch++;
+    }
+    return snapshot;
+}
+
+void BufferedSaveStore::FlushSnapshot(const CommitSnapshot& snapshot) {
+    if (!WriteJournal(snapshot)) {
+        LOG_ERROR(Service_FS, "Failed to write the save journal in {}, updating files directly",
+                  root->GetFullPath());
+    }
+
+    u64 data_bytes = 0;
+    bool all_applied = true;
+    for (const FileSnapshot& file : snapshot.files) {
+        std::vector<PageSpan> pages;
+        pages.reserve(file.pages.size());
+        for (const auto& [index, page] : file.pages) {
+            const std::size_t page_size = std::min(PageSize, file.size - index * PageSize);
+            pages.emplace_back(index, std::span<const u8>{page->data(), page_size});
+        }
+
+        VirtualFile base;
+        {
+            std::scoped_lock lk{file.state->mutex};
+            base = file.state->base;
+        }
+        const bool applied = ApplyFileUpdate(base, file.size, file.truncate_to, pages, data_bytes);
+
+        BufferedFileState& state = *file.state;
+        std::scoped_lock lk{state.mutex};
+        if (applied) {
+            // Pages nobody wrote to since the snapshot now match the backing file and can be
+            // dropped.
+            for (const auto& [index, page] : file.pages) {
+                if (const auto it = state.pages.find(index);
+                    it != state.pages.end() && it->second == page) {
+                    state.pages.erase(it);
+                }
+            }
+        } else {
+            // Keep the pages resident and hand them, and the truncate, to the next commit.
+            LOG_ERROR(Service_FS, "Failed to update {} in {}, retrying on the next commit",
+                      file.path, root->GetFullPath());
+            all_applied = false;
+            for (const auto& [index, page] : file.pages) {
+                if (state.pages.contains(index)) {
+                    state.dirty.insert(index);
+                }
+            }
+            state.size_dirty = true;
+            if (file.truncate_to) {
+                const auto [it, inserted] =
+                    state.pending_truncates.try_emplace(state.epoch, *file.truncate_to);
+                it->second = std::min(it->second, *file.truncate_to);
+            }
+        }
+        state.pending_truncates.erase(file.epoch);
+        state.base_limit = std::numeric_limits<std::size_t>::max();
+        for (const auto& [epoch, truncate_to] : state.pending_truncates) {
+            state.base_limit = std::min(state.base_limit, truncate_to);
+        }
+    }
+    if (all_applied) {
+        root->DeleteFile(JournalName);
+    } else {
+        // The journal still holds the whole commit, it is replayed if the save is reopened before
+        // the next commit goes through.
+        std::scoped_lock lk{state_mutex};
+        flush_failed = true;
+    }
+
+    std::scoped_lock lk{stats_mutex};
+    stats.data_bytes_written += data_bytes;
+}
+
+bool BufferedSaveStore::WriteJournal(const CommitSnapshot& snapshot) {
+    std::vector<u8> body;
+    for (const FileSnapshot& file : snapshot.files) {
+        AppendValue(body, static_cast<u32>(file.path.size()));
+        body.insert(body.end(), file.path.begin(), file.path.end());
+        AppendValue(body, static_cast<u64>(file.size));
+        AppendValue(body,
+                    file.truncate_to ? static_cast<u64>(*file.truncate_to) : JournalNoTruncate);
+        AppendValue(body, static_cast<u32>(file.pages.size()));
+        for (const auto& [index, page] : file.pages) {
+            const std::size_t page_size = std::min(PageSize, file.size - index * PageSize);
+            AppendValue(body, static_cast<u64>(index));
+            AppendValue(body, static_cast<u32>(page_size));
+            body.insert(body.end(), page->begin(), page->begin() + page_size);
+        }
+    }
+
+    const JournalHeader header{
+        .magic = JournalMagic,
+        .version = JournalVersion,
+        .body_size = body.size(),
+        .body_hash = Common::CityHash64(reinterpret_cast<const char*>(body.data()), body.size()),
+    };
+
+    const VirtualFile journal = root->CreateFile(JournalName);
+    if (journal == nullptr || !journal->Resize(0)) {
+        return false;
+    }
+    // The header goes first so a torn write leaves a body that fails the hash check.
+    if (journal->WriteObject(header) != sizeof(header) ||
+        journal->WriteBytes(body, sizeof(header)) != body.size()) {
+        return false;
+    }
+
+    std::scoped_lock lk{stats_mutex};
+    stats.journal_bytes_written += sizeof(header) + body.size();
+    return true;
+}
+
+void BufferedSaveStore::ReplayJournal() {
+    const VirtualFile journal = root->GetFile(JournalName);
+    if (journal == nullptr) {
+        return;
+    }
+
+    JournalHeader header{};
+    if (journal->ReadObject(&header) != sizeof(header) || header.magic != JournalMagic ||
+        header.version != JournalVersion ||
+        journal->GetSize() != sizeof(header) + header.body_size) {
+        LOG_WARNING(Service_FS, "Discarding incomplete save journal in {}", root->GetFullPath());
+        root->DeleteFile(JournalName);
+        return;
+    }
+
+    const std::vector<u8> body = journal->ReadBytes(header.body_size, sizeof(header));
+    if (body.size() != header.body_size ||
+        Common::CityHash64(reinterpret_cast<const char*>(body.data()), body.size()) !=
+            header.body_hash) {
+        LOG_WARNING(Service_FS, "Discarding corrupt save journal in {}", root->GetFullPath());
+        root->DeleteFile(JournalName);
+        return;
+    }
+
+    std::span<const u8> in{body};
+    std::size_t num_files = 0;
+    bool replayed = true;
+    while (!in.empty()) {
+        u32 path_size{};
+        u64 size{};
+        u64 truncate_to{};
+        u32 num_pages{};
+        if (!TakeValue(in, path_size) || in.size() < path_size) {
+            break;
+        }
+        const std::string path(reinterpret_cast<const char*>(in.data()), path_size);
+        in = in.subspan(path_size);
+        if (!TakeValue(in, size) || !TakeValue(in, truncate_to) || !TakeValue(in, num_pages)) {
+            break;
+        }
+
+        std::vector<PageSpan> pages;
+        pages.reserve(num_pages);
+        for (u32 i = 0; i < num_pages; i++) {
+            u64 index{};
+            u32 page_size{};
+            if (!TakeValue(in, index) || !TakeValue(in, page_size) || in.size() < page_size) {
+                break;
+            }
+            pages.emplace_back(static_cast<std::size_t>(index), in.first(page_size));
+            in = in.subspan(page_size);
+        }
+
+        const VirtualFile base = root->GetFileRelative(path);
+        if (base == nullptr) {
+            LOG_WARNING(Service_FS, "Save journal references missing file {}", path);
+            continue;
+        }
+        u64 written = 0;
+        if (!ApplyFileUpdate(base, static_cast<std::size_t>(size),
+                             truncate_to == JournalNoTruncate
+                                 ? std::nullopt
+                                 : std::optional<std::size_t>{
+                                       static_cast<std::size_t>(truncate_to)},
+                             pages, written)) {
+            LOG_ERROR(Service_FS, "Failed to replay save journal entry for {}", path);
+            replayed = false;
+        }
+        num_files++;
+    }
+
+    if (!replayed) {
+        // Leave the journal in place so the next open tries again.
+        return;
+    }
+    LOG_INFO(Service_FS, "Replayed an interrupted commit of {} files in {}", num_files,
+             root->GetFullPath());
+    root->DeleteFile(JournalName);
+}
+
+void BufferedSaveStore::LogStats() const {
+    std::scoped_lock lk{stats_mutex};
+    if (stats.commits == 0 && stats.guest_bytes_written == 0) {
+        return;
+    }
+
+    const u64 disk_bytes = stats.journal_bytes_written + stats.data_bytes_written;
+    LOG_INFO(Service_FS,
+             "Save {}: {} commits (avg {} us, max {} us), {} flushes (avg {} us, max {} us), "
+             "{} bytes written by the guest, {} to disk, write amplification {:.2f}x",
+             root->GetFullPath(), stats.commits, stats.total_commit_us / stats.commits,
+             stats.max_commit_us, stats.flushes,
+             stats.flushes == 0 ? 0 : stats.total_flush_us / stats.flushes, stats.max_flush_us,
+             stats.guest_bytes_written, disk_bytes,
+             stats.guest_bytes_written == 0
+                 ? 0.0
+                 : static_cast<double>(disk_bytes) / static_cast<double>(stats.guest_bytes_written));
+}
+
+BufferedVfsFile::BufferedVfsFile(std::shared_ptr<BufferedSaveStore> store_,
+                                 std::shared_ptr<BufferedFileState> state_)
+    : store{std::move(store_)}, state{std::move(state_)} {}
+
+BufferedVfsFile::~BufferedVfsFile() = default;
+
+std::string BufferedVfsFile::GetName() const {
+    std::scoped_lock lk{state->mutex};
+    return std::string(Common::FS::GetFilename(state->path));
+}
+
+std::size_t BufferedVfsFile::GetSize() const {
+    return store->GetSize(*state);
+}
+
+bool BufferedVfsFile::Resize(std::size_t new_size) {
+    return store->Resize(*state, new_size);
+}
+
+VirtualDir BufferedVfsFile::GetContainingDirectory() const {
+    std::scoped_lock lk{state->mutex};
+    VirtualDir parent = state->base->GetContainingDirectory();
+    if (parent == nullptr) {
+        return nullptr;
+    }
+    return std::make_shared<BufferedVfsDirectory>(store, std::move(parent),
+                                                  ParentPath(state->path));
+}
+
+bool BufferedVfsFile::IsWritable() const {
+    std::scoped_lock lk{state->mutex};
+    return state->base->IsWritable();
+}
+
+bool BufferedVfsFile::IsReadable() const {
+    std::scoped_lock lk{state->mutex};
+    return state->base->IsReadable();
+}
+
+std::size_t BufferedVfsFile::Read(u8* data, std::size_t length, std::size_t offset) const {
+    return store->Read(*state, data, length, offset);
+}
+
+std::size_t BufferedVfsFile::Write(const u8* data, std::size_t length, std::size_t offset) {
+    return store->Write(*state, data, length, offset);
+}
+
+bool BufferedVfsFile::Rename(std::string_view name) {
+    std::string old_path;
+    VirtualFile base;
+    {
+        std::scoped_lock lk{state->mutex};
+        old_path = state->path;
+        base = state->base;
+    }
+    const std::string new_path = JoinPath(ParentPath(old_path), name);
+    return store->RenamePath(old_path, new_path, [&] { return base->Rename(name); });
+}
+
+BufferedVfsDirectory::BufferedVfsDirectory(std::shared_ptr<BufferedSaveStore> store_,
+                                           VirtualDir base_, std::string path_)
+    : store{std::move(store_)}, base{std::move(base_)}, path{std::move(path_)} {}
+
+BufferedVfsDirectory::~BufferedVfsDirectory() = default;
+
+std::vector<VirtualFile> BufferedVfsDirectory::GetFiles() const {
+    std::vector<VirtualFile> out;
+    for (auto& file : base->GetFiles()) {
+        if (path.empty() && BufferedSaveStore::IsJournalName(file->GetName())) {
+            continue;
+        }
+        out.push_back(WrapFile(std::move(file)));
+    }
+    return out;
+}
+
+VirtualFile BufferedVfsDirectory::GetFile(std::string_view name) const {
+    if (path.empty() && BufferedSaveStore::IsJournalName(name)) {
+        return nullptr;
+    }
+    return WrapFile(base->GetFile(name));
+}
+
+FileTimeStampRaw BufferedVfsDirectory::GetFileTimeStamp(std::string_view file_path) const {
+    return base->GetFileTimeStamp(file_path);
+}
+
+std::vector<VirtualDir> BufferedVfsDirectory::GetSubdirectories() const {
+    std::vector<VirtualDir> out;
+    for (auto& dir : base->GetSubdirectories()) {
+        std::string dir_path = ChildPath(dir->GetName());
+        out.push_back(std::make_shared<BufferedVfsDirectory>(store, std::move(dir),
+                                                             std::move(dir_path)));
+    }
+    return out;
+}
+
+VirtualDir BufferedVfsDirectory::GetSubdirectory(std::string_view name) const {
+    VirtualDir dir = base->GetSubdirectory(name);
+    if (dir == nullptr) {
+        return nullptr;
+    }
+    return std::make_shared<BufferedVfsDirectory>(store, std::move(dir), ChildPath(name));
+}
+
+bool BufferedVfsDirectory::IsWritable() const {
+    return base->IsWritable();
+}
+
+bool BufferedVfsDirectory::IsReadable() const {
+    return base->IsReadable();
+}
+
+std::string BufferedVfsDirectory::GetName() const {
+    return base->GetName();
+}
+
+VirtualDir BufferedVfsDirectory::GetParentDirectory() const {
+    // The save root is the top of the tree handed to the guest.
+    if (path.empty()) {
+        return nullptr;
+    }
+    VirtualDir parent = base->GetParentDirectory();
+    if (parent == nullptr) {
+        return nullptr;
+    }
+    return std::make_shared<BufferedVfsDirectory>(store, std::move(parent),
+                                                  ParentPath(path));
+}
+
+VirtualDir BufferedVfsDirectory::CreateSubdirectory(std::string_view name) {
+    VirtualDir dir = base->CreateSubdirectory(name);
+    if (dir == nullptr) {
+        return nullptr;
+    }
+    return std::make_shared<BufferedVfsDirectory>(store, std::move(dir), ChildPath(name));
+}
+
+VirtualFile BufferedVfsDirectory::CreateFile(std::string_view name) {
+    if (path.empty() && BufferedSaveStore::IsJournalName(name)) {
+        return nullptr;
+    }
+    return WrapFile(base->CreateFile(name));
+}
+
+bool BufferedVfsDirectory::DeleteSubdirectory(std::string_view name) {
+    return store->DeletePath(ChildPath(name), [&] { return base->DeleteSubdirectory(name); });
+}
+
+bool BufferedVfsDirectory::DeleteSubdirectoryRecursive(std::string_view name) {
+    return store->DeletePath(ChildPath(name),
+                             [&] { return base->DeleteSubdirectoryRecursive(name); });
+}
+
+bool BufferedVfsDirectory::CleanSubdirectoryRecursive(std::string_view name) {
+    return store->DeletePath(ChildPath(name),
+                             [&] { return base->CleanSubdirectoryRecursive(name); });
+}
+
+bool BufferedVfsDirectory::DeleteFile(std::string_view name) {
+    if (path.empty() && BufferedSaveStore::IsJournalName(name)) {
+        return false;
+    }
+    return store->DeletePath(ChildPath(name), [&] { return base->DeleteFile(name); });
+}
+
+bool BufferedVfsDirectory::Rename(std::string_view name) {
+    if (path.empty()) {
+        return false;
+    }
+    std::string new_path = JoinPath(ParentPath(path), name);
+    if (!store->RenamePath(path, new_path, [&] { return base->Rename(name); })) {
+        return false;
+    }
+    path = std::move(new_path);
+    return true;
+}
+
+bool BufferedVfsDirectory::Commit() {
+    return store->Commit();
+}
+
+std::string BufferedVfsDirectory::ChildPath(std::string_view name) const {
+    return JoinPath(path, name);
+}
+
+VirtualFile BufferedVfsDirectory::WrapFile(VirtualFile file) const {
+    if (file == nullptr) {
+        return nullptr;
+    }
+    std::string file_path = ChildPath(file->GetName());
+    auto state = store->GetFileState(file, file_path);
+    return std::make_shared<BufferedVfsFile>(store, std::move(state));
+}
+
+} // namespace FileSys
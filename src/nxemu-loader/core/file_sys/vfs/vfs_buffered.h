@@ -0,0 +1,188 @@
+// SPDX-FileCopyrightText: Copyright 2024 yuzu Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "yuzu_common/common_types.h"
+#include "yuzu_common/polyfill_thread.h"
+#include "core/file_sys/vfs/vfs.h"
+
+namespace FileSys {
+
+class BufferedSaveStore;
+struct BufferedFileState;
+
+/**
+ * Background thread that makes committed save data durable. Commits only snapshot the dirty pages
+ * of a save, the journal write and the in-place update of the backing files happen here so the
+ * guest never waits on host disk I/O.
+ */
+class BufferedSaveFlusher {
+public:
+    BufferedSaveFlusher();
+    ~BufferedSaveFlusher();
+
+    BufferedSaveFlusher(const BufferedSaveFlusher&) = delete;
+    BufferedSaveFlusher& operator=(const BufferedSaveFlusher&) = delete;
+
+    /// Schedules the pending commits of store to be written out.
+    void Enqueue(std::shared_ptr<BufferedSaveStore> store);
+
+private:
+    void ThreadLoop(std::stop_token stop_token);
+
+    std::mutex queue_mutex;
+    std::condition_variable_any queue_cv;
+    std::deque<std::shared_ptr<BufferedSaveStore>> queue;
+    std::jthread thread;
+};
+
+/// Write and commit counters of a single save, logged when the save is closed.
+struct BufferedSaveStats {
+    u64 guest_bytes_written{};
+    u64 journal_bytes_written{};
+    u64 data_bytes_written{};
+    u64 commits{};
+    u64 flushes{};
+    u64 total_commit_us{};
+    u64 max_commit_us{};
+    u64 total_flush_us{};
+    u64 max_flush_us{};
+};
+
+/**
+ * Save data backend that keeps guest writes in memory until the guest commits. Every file is
+ * overlaid with the pages written since the last flush; a commit hands the dirty pages to the
+ * flusher as a copy-on-write snapshot, so later writes to the same pages clone them instead of
+ * waiting. The flusher writes each commit to a journal in the save root before updating the
+ * backing files in place, and a journal left behind by an interrupted flush is replayed when the
+ * save is next opened, so a commit is either fully applied or not at all.
+ */
+class BufferedSaveStore : public std::enable_shared_from_this<BufferedSaveStore> {
+public:
+    static constexpr std::size_t PageSize = 0x1000;
+
+    explicit BufferedSaveStore(VirtualDir root_, BufferedSaveFlusher& flusher_);
+    ~BufferedSaveStore();
+
+    /// Returns a buffered view of the save root.
+    VirtualDir OpenRoot();
+
+    /// Snapshots every dirty file and queues the snapshot to be flushed. Returns false if an
+    /// earlier flush failed to update the backing files, its data is written again with this one.
+    bool Commit();
+
+    /// Writes out every queued commit, called from the flusher thread.
+    void FlushPending();
+
+    std::shared_ptr<BufferedFileState> GetFileState(const VirtualFile& base,
+                                                    const std::string& path);
+
+    /// Drops buffered data of the entry at path (and everything below it) before deleting it.
+    bool DeletePath(const std::string& path, const std::function<bool()>& remove);
+
+    /// Moves buffered data of the entry at old_path (and everything below it) to new_path.
+    bool RenamePath(const std::string& old_path, const std::string& new_path,
+                    const std::function<bool()>& rename);
+
+    std::size_t Read(BufferedFileState& state, u8* data, std::size_t length,
+                     std::size_t offset) const;
+    std::size_t Write(BufferedFileState& state, const u8* data, std::size_t length,
+                      std::size_t offset);
+    bool Resize(BufferedFileState& state, std::size_t new_size);
+    std::size_t GetSize(BufferedFileState& state) const;
+
+    static bool IsJournalName(std::string_view name);
+
+private:
+    struct FileSnapshot;
+    struct CommitSnapshot;
+
+    CommitSnapshot TakeSnapshot();
+    void FlushSnapshot(const CommitSnapshot& snapshot);
+    void FlushPendingLocked();
+    bool WriteJournal(const CommitSnapshot& snapshot);
+    void ReplayJournal();
+    void LogStats() const;
+
+    VirtualDir root;
+    BufferedSaveFlusher& flusher;
+
+    mutable std::mutex state_mutex;
+    std::map<std::string, std::shared_ptr<BufferedFileState>, std::less<>> files;
+    std::vector<CommitSnapshot> pending_commits;
+    /// Set when a flush could not update every backing file, reported by the next commit.
+    bool flush_failed{};
+
+    /// Held while a commit is written out, and by renames and deletes so they never race a flush
+    /// still addressing the old paths.
+    std::mutex flush_mutex;
+
+    mutable std::mutex stats_mutex;
+    BufferedSaveStats stats;
+};
+
+class BufferedVfsFile : public VfsFile {
+public:
+    BufferedVfsFile(std::shared_ptr<BufferedSaveStore> store_,
+                    std::shared_ptr<BufferedFileState> state_);
+    ~BufferedVfsFile() override;
+
+    std::string GetName() const override;
+    std::size_t GetSize() const override;
+    bool Resize(std::size_t new_size) override;
+    VirtualDir GetContainingDirectory() const override;
+    bool IsWritable() const override;
+    bool IsReadable() const override;
+    std::size_t Read(u8* data, std::size_t length, std::size_t offset) const override;
+    std::size_t Write(const u8* data, std::size_t length, std::size_t offset) override;
+    bool Rename(std::string_view name) override;
+
+private:
+    std::shared_ptr<BufferedSaveStore> store;
+    std::shared_ptr<BufferedFileState> state;
+};
+
+class BufferedVfsDirectory : public VfsDirectory {
+public:
+    BufferedVfsDirectory(std::shared_ptr<BufferedSaveStore> store_, VirtualDir base_,
+                         std::string path_);
+    ~BufferedVfsDirectory() override;
+
+    std::vector<VirtualFile> GetFiles() const override;
+    VirtualFile GetFile(std::string_view name) const override;
+    FileTimeStampRaw GetFileTimeStamp(std::string_view path) const override;
+    std::vector<VirtualDir> GetSubdirectories() const override;
+    VirtualDir GetSubdirectory(std::string_view name) const override;
+    bool IsWritable() const override;
+    bool IsReadable() const override;
+    std::string GetName() const override;
+    VirtualDir GetParentDirectory() const override;
+    VirtualDir CreateSubdirectory(std::string_view name) override;
+    VirtualFile CreateFile(std::string_view name) override;
+    bool DeleteSubdirectory(std::string_view name) override;
+    bool DeleteSubdirectoryRecursive(std::string_view name) override;
+    bool CleanSubdirectoryRecursive(std::string_view name) override;
+    bool DeleteFile(std::string_view name) override;
+    bool Rename(std::string_view name) override;
+    bool Commit() override;
+
+private:
+    std::string ChildPath(std::string_view name) const;
+    VirtualFile WrapFile(VirtualFile file) const;
+
+    std::shared_ptr<BufferedSaveStore> store;
+    VirtualDir base;
+    std::string path;
+};
+
+} // namespace FileSys
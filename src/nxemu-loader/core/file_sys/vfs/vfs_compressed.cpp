@@ -0,0 +1,76 @@
+// SPDX-FileCopyrightText: Copyright 2024 yuzu Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <algorithm>
+#include <cstring>
+#include "core/file_sys/vfs/vfs_compressed.h"
+#include "yuzu_common/logging/log.h"
+#include "yuzu_common/zstd_compression.h"
+
+namespace FileSys {
+
+CompressedVfsFile::CompressedVfsFile(std::span<const u8> data_, std::size_t size_,
+                                     std::string name_, VirtualDir parent_)
+    : data{data_}, size{size_}, name{std::move(name_)}, parent{std::move(parent_)} {}
+
+CompressedVfsFile::~CompressedVfsFile() = default;
+
+std::string CompressedVfsFile::GetName() const {
+    return name;
+}
+
+std::size_t CompressedVfsFile::GetSize() const {
+    return size;
+}
+
+bool CompressedVfsFile::Resize(std::size_t new_size) {
+    return false;
+}
+
+VirtualDir CompressedVfsFile::GetContainingDirectory() const {
+    return parent;
+}
+
+bool CompressedVfsFile::IsWritable() const {
+    return false;
+}
+
+bool CompressedVfsFile::IsReadable() const {
+    return true;
+}
+
+std::size_t CompressedVfsFile::Read(u8* data_, std::size_t length, std::size_t offset) const {
+    if (offset >= size) {
+        return 0;
+    }
+    const std::span<const u8> contents = Contents();
+    const auto read = std::min(length, size - offset);
+    std::memcpy(data_, contents.data() + offset, read);
+    return read;
+}
+
+std::size_t CompressedVfsFile::Write(const u8* data_, std::size_t length, std::size_t offset) {
+    return 0;
+}
+
+bool CompressedVfsFile::Rename(std::string_view new_name) {
+    name = new_name;
+    return true;
+}
+
+std::span<const u8> CompressedVfsFile::Contents() const {
+    if (data.size() == size) {
+        return data;
+    }
+    std::call_once(decompress_once, [this] {
+        decompressed = Common::Compression::DecompressDataZSTD(data);
+        if (decompressed.size() != size) {
+            LOG_ERROR(Loader, "Failed to decompress {}, expected {} bytes but got {}", name, size,
+                      decompressed.size());
+            decompressed.resize(size);
+        }
+    });
+    return decompressed;
+}
+
+} // namespace FileSys
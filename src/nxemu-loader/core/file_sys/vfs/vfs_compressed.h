@@ -0,0 +1,44 @@
+// SPDX-FileCopyrightText: Copyright 2024 yuzu Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <mutex>
+#include <span>
+#include <string>
+#include <vector>
+#include "core/file_sys/vfs/vfs.h"
+
+namespace FileSys {
+
+// A read only VfsFile over constant data embedded in the module. The data is used in place when
+// it is stored uncompressed, otherwise it is zstd decompressed on the first read.
+class CompressedVfsFile : public VfsFile {
+public:
+    explicit CompressedVfsFile(std::span<const u8> data_, std::size_t size_, std::string name_ = "",
+                               VirtualDir parent_ = nullptr);
+    ~CompressedVfsFile() override;
+
+    std::string GetName() const override;
+    std::size_t GetSize() const override;
+    bool Resize(std::size_t new_size) override;
+    VirtualDir GetContainingDirectory() const override;
+    bool IsWritable() const override;
+    bool IsReadable() const override;
+    std::size_t Read(u8* data, std::size_t length, std::size_t offset) const override;
+    std::size_t Write(const u8* data, std::size_t length, std::size_t offset) override;
+    bool Rename(std::string_view new_name) override;
+
+private:
+    std::span<const u8> Contents() const;
+
+    std::span<const u8> data;
+    std::size_t size;
+    std::string name;
+    VirtualDir parent;
+
+    mutable std::once_flag decompress_once;
+    mutable std::vector<u8> decompressed;
+};
+
+} // namespace FileSys
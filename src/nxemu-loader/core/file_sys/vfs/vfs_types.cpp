@@ -91,6 +91,15 @@ IVirtualFile* VirtualDirectoryPtr::OpenFile(const char* path, VirtualFileOpenMod
     return nullptr;
 }
 
+bool VirtualDirectoryPtr::Commit()
+{
+    if (m_directory.get() == nullptr)
+    {
+        return false;
+    }
+    return m_directory->Commit();
+}
+
 void VirtualDirectoryPtr::Release()
 {
     delete this;
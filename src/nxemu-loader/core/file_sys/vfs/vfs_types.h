@@ -51,6 +51,7 @@ public:
     IVirtualFile * GetFile(const char * name) const override;
     IVirtualFile * GetFileRelative(const char * relative_path) const override;
     IVirtualFile * OpenFile(const char * path, VirtualFileOpenMode perms) override;
+    bool Commit() override;
     void Release() override;
 
 private:
@@ -0,0 +1,9 @@
+#pragma once
+
+namespace NXLoaderSetting
+{
+    constexpr const char * CryptoBenchmark = "nxloader:CryptoBenchmark";
+    constexpr const char * VerifyIntegrity = "nxloader:VerifyIntegrity";
+    constexpr const char * VerifyLibraryPath = "nxloader:VerifyLibraryPath";
+
+} // namespace NXLoaderSetting
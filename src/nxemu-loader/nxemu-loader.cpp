@@ -1,4 +1,5 @@
 #include "system_loader.h"
+#include "loader_settings_identifiers.h"
 #include <memory>
 #include <stdio.h>
 
@@ -38,6 +39,9 @@ int CALL ModuleInitialize(ModuleInterfaces & interfaces)
     {
         return -1;
     }
+    g_settings->SetDefaultBool(NXLoaderSetting::CryptoBenchmark, false);
+    g_settings->SetDefaultBool(NXLoaderSetting::VerifyIntegrity, false);
+    g_settings->SetDefaultString(NXLoaderSetting::VerifyLibraryPath, "");
     return 0;
 }
 
@@ -1,11 +1,19 @@
 #include "system_loader.h"
+#include "loader_settings_identifiers.h"
 #include "file_format/nro.h"
 #include "file_format/nacp.h"
 #include <fmt/core.h>
+#include <mutex>
+#include <thread>
 #include <common/path.h>
 #include <nxemu-core/settings/identifiers.h>
+#include <yuzu_common/logging/log.h>
+#include "core/crypto/aes_util.h"
+#include "core/crypto/crypto_benchmark.h"
+#include "core/crypto/sha256.h"
 #include "core/file_sys/registered_cache.h"
 #include "core/file_sys/filesystem.h"
+#include "core/file_sys/integrity_verifier.h"
 #include "core/file_sys/romfs_factory.h"
 #include "core/file_sys/vfs/vfs_real.h"
 #include "core/file_sys/vfs/vfs_types.h"
@@ -14,6 +22,16 @@
 extern IModuleSettings * g_settings;
 
 struct Systemloader::Impl {
+    struct EntriesQuery
+    {
+        std::optional<LoaderTitleType> title;
+        std::optional<LoaderContentRecordType> record;
+        std::optional<u64> id;
+        u64 generation;
+
+        bool operator==(const EntriesQuery &) const = default;
+    };
+
     explicit Impl(Systemloader & loader, ISwitchSystem& system) :
         m_loader(loader),
         m_system(system),
@@ -22,7 +40,17 @@ struct Systemloader::Impl {
     {
     }
 
+    ~Impl()
+    {
+        if (m_integrityVerifier != nullptr)
+        {
+            m_integrityVerifier->Cancel();
+        }
+    }
+
     bool LoadNRO(const char* nroFile);
+    FileSys::IntegrityVerifier & IntegrityVerifier();
+    void VerifyLibrary(const FileSys::VirtualDir & library);
 
     Systemloader & m_loader;
     ISwitchSystem & m_system;
@@ -33,6 +61,16 @@ struct Systemloader::Impl {
     FileSys::FileSystemController m_fsController;
     std::unique_ptr<Nro> m_nro;
     uint64_t m_titleID;
+    /// Result of the last GetContentProviderEntriesCount, reused by the GetContentProviderEntries
+    /// call that follows it so the filter only runs once per query. Keyed on the content
+    /// generation too, so content that changed in between is listed again
+    std::mutex m_entriesMutex;
+    std::optional<EntriesQuery> m_entriesQuery;
+    std::vector<ContentProviderEntry> m_entries;
+    /// Created on first use, verification runs on its own workers alongside emulation
+    std::once_flag m_integrityVerifierOnce;
+    std::unique_ptr<FileSys::IntegrityVerifier> m_integrityVerifier;
+    std::jthread m_libraryVerification;
 };
 
 Systemloader::Systemloader(ISwitchSystem & system) :
@@ -53,6 +91,26 @@ bool Systemloader::Initialize(void)
         impl->m_contentProvider = std::make_unique<FileSys::ContentProviderUnion>();
     }
     GetFileSystemController().CreateFactories(*GetFilesystem(), false);
+
+    LOG_INFO(Crypto, "SHA-256 backend: {}, AES backend: {}", Core::Crypto::GetSHA256BackendName(), Core::Crypto::GetAESBackendName());
+    if (g_settings->GetBool(NXLoaderSetting::CryptoBenchmark))
+    {
+        Core::Crypto::LogCryptoBenchmark();
+    }
+
+    const char * libraryPath = g_settings->GetString(NXLoaderSetting::VerifyLibraryPath);
+    if (libraryPath != nullptr && libraryPath[0] != '\0' && !impl->m_libraryVerification.joinable())
+    {
+        FileSys::VirtualDir library = impl->m_virtualFilesystem->OpenDirectory(libraryPath, VirtualFileOpenMode::Read);
+        if (library != nullptr)
+        {
+            impl->m_libraryVerification = std::jthread([this, library] { impl->VerifyLibrary(library); });
+        }
+        else
+        {
+            LOG_ERROR(Loader, "Failed to open library directory {} for verification", libraryPath);
+        }
+    }
     return true;
 }
 
@@ -84,6 +142,15 @@ bool Systemloader::LoadRom(const char * romFile)
     g_settings->SetBool(NXCoreSetting::RomLoading, false);
     if (res)
     {
+        if (g_settings->GetBool(NXLoaderSetting::VerifyIntegrity))
+        {
+            // Only the NCAs of an NSP or XCI carry content hashes, an NRO has nothing to verify
+            FileSys::VirtualFile file = impl->m_virtualFilesystem->OpenFile(romFile, VirtualFileOpenMode::Read);
+            for (FileSys::VirtualFile & nca : FileSys::CollectNcas(file))
+            {
+                impl->IntegrityVerifier().Submit(std::move(nca), FileSys::LogIntegrityReport);
+            }
+        }
         g_settings->SetString(NXCoreSetting::GameFile, romFile);
         impl->m_system.StartEmulation();
     }
@@ -142,6 +209,41 @@ bool Systemloader::Impl::LoadNRO(const char* nroFile)
     return true;
 }
 
+FileSys::IntegrityVerifier & Systemloader::Impl::IntegrityVerifier()
+{
+    std::call_once(m_integrityVerifierOnce, [this] { m_integrityVerifier = std::make_unique<FileSys::IntegrityVerifier>(); });
+    return *m_integrityVerifier;
+}
+
+void Systemloader::Impl::VerifyLibrary(const FileSys::VirtualDir & library)
+{
+    LOG_INFO(Loader, "Verifying library {}", library->GetFullPath());
+    const auto start = std::chrono::steady_clock::now();
+    const std::vector<FileSys::IntegrityReport> reports = IntegrityVerifier().VerifyLibrary(library);
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    uint64_t bytesVerified = 0;
+    size_t verified = 0, failed = 0, unverifiable = 0;
+    for (const FileSys::IntegrityReport & report : reports)
+    {
+        FileSys::LogIntegrityReport(report);
+        bytesVerified += report.bytes_verified;
+        if (report.status == LoaderResultStatus::Success)
+        {
+            verified += 1;
+        }
+        else if (report.status == LoaderResultStatus::ErrorIntegrityVerificationFailed)
+        {
+            failed += 1;
+        }
+        else
+        {
+            unverifiable += 1;
+        }
+    }
+    LOG_INFO(Loader, "Library verification finished: {} NCAs, {} good, {} failed, {} not verifiable, {:.1f} MiB/s", reports.size(), verified, failed, unverifiable, elapsed.count() > 0 ? bytesVerified / elapsed.count() / (1024.0 * 1024.0) : 0.0);
+}
+
 IFileSystemController & Systemloader::FileSystemController()
 {
     return impl->m_fsController;
@@ -156,11 +258,18 @@ IVirtualFile * Systemloader::SynthesizeSystemArchive(const uint64_t title_id)
 uint32_t Systemloader::GetContentProviderEntriesCount(bool useTitleType, LoaderTitleType titleType, bool useContentRecordType, LoaderContentRecordType contentRecordType, bool useTitleId, unsigned long long titleId)
 {
     const FileSys::ContentProviderUnion & rcu = *impl->m_contentProvider;
-    std::optional<LoaderTitleType> title = useTitleType ? std::optional<LoaderTitleType>((LoaderTitleType)titleType) : std::nullopt;
-    std::optional<LoaderContentRecordType> record = useContentRecordType ? std::optional<LoaderContentRecordType>((LoaderContentRecordType)contentRecordType) : std::nullopt;
-    std::optional<u64> id = useTitleId ? std::optional<u64>(titleId) : std::nullopt;
-    const std::vector<ContentProviderEntry> list = rcu.ListEntriesFilter(title, record, id);
-    return (uint32_t)list.size();
+    Impl::EntriesQuery query;
+    query.title = useTitleType ? std::optional<LoaderTitleType>((LoaderTitleType)titleType) : std::nullopt;
+    query.record = useContentRecordType ? std::optional<LoaderContentRecordType>((LoaderContentRecordType)contentRecordType) : std::nullopt;
+    query.id = useTitleId ? std::optional<u64>(titleId) : std::nullopt;
+    query.generation = rcu.GetGeneration();
+    std::vector<ContentProviderEntry> list = rcu.ListEntriesFilter(query.title, query.record, query.id);
+    uint32_t count = (uint32_t)list.size();
+
+    std::lock_guard<std::mutex> lock(impl->m_entriesMutex);
+    impl->m_entriesQuery = query;
+    impl->m_entries = std::move(list);
+    return count;
 }
 
 uint32_t Systemloader::GetContentProviderEntries(bool useTitleType, LoaderTitleType titleType, bool useContentRecordType, LoaderContentRecordType contentRecordType, bool useTitleId, unsigned long long titleId, ContentProviderEntry * entries, uint32_t entryCount)
@@ -170,10 +279,26 @@ uint32_t Systemloader::GetContentProviderEntries(bool useTitleType, LoaderTitleT
         return 0;
     }
     const FileSys::ContentProviderUnion& rcu = *impl->m_contentProvider;
-    std::optional<LoaderTitleType> title = useTitleType ? std::optional<LoaderTitleType>((LoaderTitleType)titleType) : std::nullopt;
-    std::optional<LoaderContentRecordType> record = useContentRecordType ? std::optional<LoaderContentRecordType>((LoaderContentRecordType)contentRecordType) : std::nullopt;
-    std::optional<u64> id = useTitleId ? std::optional<u64>(titleId) : std::nullopt;
-    const std::vector<ContentProviderEntry> list = rcu.ListEntriesFilter(title, record, id);
+    Impl::EntriesQuery query;
+    query.title = useTitleType ? std::optional<LoaderTitleType>((LoaderTitleType)titleType) : std::nullopt;
+    query.record = useContentRecordType ? std::optional<LoaderContentRecordType>((LoaderContentRecordType)contentRecordType) : std::nullopt;
+    query.id = useTitleId ? std::optional<u64>(titleId) : std::nullopt;
+    query.generation = rcu.GetGeneration();
+
+    std::vector<ContentProviderEntry> list;
+    {
+        std::lock_guard<std::mutex> lock(impl->m_entriesMutex);
+        if (impl->m_entriesQuery == query)
+        {
+            list = std::move(impl->m_entries);
+            impl->m_entriesQuery.reset();
+            impl->m_entries.clear();
+        }
+    }
+    if (list.empty())
+    {
+        list = rcu.ListEntriesFilter(query.title, query.record, query.id);
+    }
     entryCount = std::min((uint32_t)list.size(), entryCount);
     memcpy(entries, list.data(), entryCount * sizeof(ContentProviderEntry));
     return entryCount;
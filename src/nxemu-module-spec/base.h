@@ -16,10 +16,10 @@
 
 enum
 {
-    MODULE_LOADER_SPECS_VERSION = 0x0108,
-    MODULE_VIDEO_SPECS_VERSION = 0x010B,
-    MODULE_CPU_SPECS_VERSION = 0x0104,
-    MODULE_OPERATING_SYSTEM_SPECS_VERSION = 0x0109,
+    MODULE_LOADER_SPECS_VERSION = 0x010A,
+    MODULE_VIDEO_SPECS_VERSION = 0x010D,
+    MODULE_CPU_SPECS_VERSION = 0x0105,
+    MODULE_OPERATING_SYSTEM_SPECS_VERSION = 0x010C,
 };
 
 enum MODULE_TYPE : uint16_t
@@ -53,6 +53,7 @@ __interface IModuleSettings
 
     const char * GetSectionSettings(const char * section) const = 0;
     void SetSectionSettings(const char * section, const std::string & json) = 0;
+    void PatchSectionSettings(const char * section, const std::string & patch) = 0; // JSON merge patch, null removes a member
 
     void RegisterCallback(const char * setting, SettingChangeCallback callback, void * userData) = 0;
     void UnregisterCallback(const char * setting, SettingChangeCallback callback, void * userData) = 0;
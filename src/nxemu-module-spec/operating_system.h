@@ -63,13 +63,30 @@ __interface IDeviceMemory
     const uint8_t * BackingBasePointer() const = 0;
 };
 
+typedef struct
+{
+    uint64_t address;
+    uint64_t size;
+} CacheInvalidationRange;
+
 __interface ICacheInvalidator 
 {
-    virtual void OnCacheInvalidation(uint64_t address, uint32_t size) = 0;
+    // ranges are sorted by address and do not overlap or touch
+    virtual void OnCacheInvalidation(const CacheInvalidationRange * ranges, uint32_t count) = 0;
 };
 
 typedef void (*DeviceEnumCallback)(const char * device, void * userData);
 
+typedef struct
+{
+    double systemFps;      // emulated vblanks per host second
+    double gameFps;        // game frame submissions per host second
+    double emulationSpeed; // emulated time / host time, 1.0 is full speed
+    double frameTimeP50;   // host ms between vblanks over the recent frame window
+    double frameTimeP95;
+    double frameTimeP99;
+} PerformanceStats;
+
 __interface IOperatingSystem
 {
     bool Initialize() = 0;
@@ -82,6 +99,8 @@ __interface IOperatingSystem
     void GatherGPUDirtyMemory(ICacheInvalidator * invalidator) = 0;
     uint64_t GetGPUTicks() = 0;
     void GameFrameEnd() = 0;
+    void SetHostRefreshRate(uint32_t refreshRate) = 0;
+    bool GetPerformanceStats(PerformanceStats & stats) = 0;
     void AudioGetSyncIDs(uint32_t * ids, uint32_t maxCount, uint32_t * actualCount) = 0;
     void AudioGetDeviceListForSink(uint32_t sinkId, bool capture, DeviceEnumCallback callback, void * userData) = 0;
 };
@@ -161,6 +161,7 @@ __interface IVirtualDirectory
     IVirtualFile * GetFile(const char * name) const = 0;
     IVirtualFile * GetFileRelative(const char * relative_path) const = 0;
     IVirtualFile * OpenFile(const char * path, VirtualFileOpenMode perms) = 0;
+    bool Commit() = 0;
     void Release() = 0;
 };
 
@@ -42,6 +42,18 @@ __interface IChannelState
     void Release() = 0;
 };
 
+// Read-only view of the video module's physical page to device page table, so the operating
+// system can translate guest writes without calling into the video module. Entries hold the
+// device page number, unless multiMapFlag is set because the physical page is mapped at several
+// device addresses; ApplyOpOnDeviceMemoryPointer has to be used for those.
+struct DeviceMemoryReverseMap
+{
+    const uint32_t * deviceAddressTable;
+    uintptr_t physicalBase;
+    uint32_t pageBits;
+    uint32_t multiMapFlag;
+};
+
 typedef void (*DeviceMemoryOperation)(uint64_t device_address, void* user_data);
 typedef void (*HostActionCallback)(uint32_t slot, void * userData);
 
@@ -62,7 +74,8 @@ __interface IVideo
     void UpdateFramebufferLayout(uint32_t width, uint32_t height) = 0;
     IChannelState * AllocateChannel() = 0;
     void PushGPUEntries(int32_t bindId, const uint64_t * commandList, uint32_t commandListSize, const uint32_t * prefetchCommandlist, uint32_t prefetchCommandlistSize) = 0;
-    void ApplyOpOnDeviceMemoryPointer(const uint8_t * pointer, uint32_t * scratchBuffer, size_t scratchBufferSize, DeviceMemoryOperation operation, void * userData) = 0;
+    DeviceMemoryReverseMap GetDeviceMemoryReverseMap(void) = 0;
+    void ApplyOpOnDeviceMemoryPointer(const uint8_t * pointer, DeviceMemoryOperation operation, void * userData) = 0;
     RasterizerDownloadArea OnCPURead(uint64_t addr, uint64_t size) = 0;
     bool OnCPUWrite(uint64_t addr, uint64_t size) = 0;
     void DeregisterHostAction(uint32_t syncpoint_id, uint32_t handle) = 0;
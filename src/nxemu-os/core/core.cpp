@@ -1,6 +1,7 @@
 // SPDX-FileCopyrightText: 2014 Citra Emulator Project
 // SPDX-License-Identifier: GPL-2.0-or-later
 
+#include <algorithm>
 #include <array>
 #include <atomic>
 
@@ -172,6 +173,10 @@ struct System::Impl {
         return perf_stats->GetAndResetStats(core_timing.GetGlobalTimeUs());
     }
 
+    PerfStatsResults GetPerfStatsSnapshot() const {
+        return perf_stats->GetStats(core_timing.GetGlobalTimeUs());
+    }
+
     mutable std::mutex suspend_guard;
     std::atomic_bool is_paused{};
     std::atomic<bool> is_shutting_down{};
@@ -218,6 +223,7 @@ struct System::Impl {
 
     bool is_multicore{};
     bool is_async_gpu{};
+    std::atomic<u32> host_refresh_rate{60};
 
     ExecuteProgramCallback execute_program_callback;
     std::stop_source stop_event;
@@ -227,6 +233,8 @@ struct System::Impl {
 
     std::array<Core::GPUDirtyMemoryManager, Core::Hardware::NUM_CPU_CORES>
         gpu_dirty_memory_managers;
+    std::mutex gpu_dirty_ranges_mutex;
+    std::vector<CacheInvalidationRange> gpu_dirty_ranges;
 
     std::deque<std::vector<u8>> user_channel;
 };
@@ -293,9 +301,32 @@ std::span<GPUDirtyMemoryManager> System::GetGPUDirtyMemoryManager() {
 }
 
 void System::GatherGPUDirtyMemory(ICacheInvalidator * invalidator) {
+    std::scoped_lock lk{impl->gpu_dirty_ranges_mutex};
+    auto& ranges = impl->gpu_dirty_ranges;
+    ranges.clear();
     for (auto& manager : impl->gpu_dirty_memory_managers) {
-        manager.Gather(invalidator);
+        manager.Gather(ranges);
     }
+    if (ranges.empty()) {
+        return;
+    }
+
+    // Hand the video module one sorted, coalesced batch instead of a call per region.
+    std::sort(ranges.begin(), ranges.end(),
+              [](const CacheInvalidationRange& lhs, const CacheInvalidationRange& rhs) {
+                  return lhs.address < rhs.address;
+              });
+    size_t count = 0;
+    for (const CacheInvalidationRange& range : ranges) {
+        if (count != 0 && range.address <= ranges[count - 1].address + ranges[count - 1].size) {
+            CacheInvalidationRange& last = ranges[count - 1];
+            const u64 end = std::max(last.address + last.size, range.address + range.size);
+            last.size = end - last.address;
+            continue;
+        }
+        ranges[count++] = range;
+    }
+    invalidator->OnCacheInvalidation(ranges.data(), static_cast<uint32_t>(count));
 }
 
 ISwitchSystem & System::GetSwitchSystem()
@@ -399,6 +430,14 @@ const Core::SpeedLimiter& System::SpeedLimiter() const {
     return impl->speed_limiter;
 }
 
+PerfStatsResults System::GetAndResetPerfStats() {
+    return impl->GetAndResetPerfStats();
+}
+
+PerfStatsResults System::GetPerfStatsSnapshot() const {
+    return impl->GetPerfStatsSnapshot();
+}
+
 std::shared_ptr<InputCommon::InputSubsystem> & System::InputSubsystem()
 {
     return impl->input_subsystem;
@@ -519,6 +558,15 @@ bool System::IsMulticore() const {
     return impl->is_multicore;
 }
 
+void System::SetHostRefreshRate(u32 refresh_rate) {
+    impl->host_refresh_rate.store(refresh_rate != 0 ? refresh_rate : 60,
+                                  std::memory_order_relaxed);
+}
+
+u32 System::HostRefreshRate() const {
+    return impl->host_refresh_rate.load(std::memory_order_relaxed);
+}
+
 bool System::DebuggerEnabled() const {
     //return Settings::values.use_gdbstub.GetValue();
     return false;
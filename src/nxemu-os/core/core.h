@@ -237,6 +237,9 @@ public:
     /// Gets and resets core performance statistics
     [[nodiscard]] PerfStatsResults GetAndResetPerfStats();
 
+    /// Gets core performance statistics without resetting them
+    [[nodiscard]] PerfStatsResults GetPerfStatsSnapshot() const;
+
     /// Gets the physical core for the CPU core that is currently running
     [[nodiscard]] Kernel::PhysicalCore& CurrentPhysicalCore();
 
@@ -387,6 +390,12 @@ public:
     /// Tells if system is running on multicore.
     [[nodiscard]] bool IsMulticore() const;
 
+    /// Sets the refresh rate in Hz of the display the frontend presents to.
+    void SetHostRefreshRate(u32 refresh_rate);
+
+    /// Refresh rate in Hz of the host display, used by the paced presentation mode.
+    [[nodiscard]] u32 HostRefreshRate() const;
+
     /// Tells if the system debugger is enabled.
     [[nodiscard]] bool DebuggerEnabled() const;
 
@@ -147,8 +147,7 @@ private:
     }
 
     Result DoCommit() {
-        UNIMPLEMENTED();
-        R_SUCCEED();
+        R_RETURN(backend.Commit());
     }
 
     Result DoGetFreeSpaceSize(s64* out, const Path& path) {
@@ -1146,8 +1146,14 @@ Result KServerSession::ReceiveRequest(uintptr_t server_message, uintptr_t server
         }
         Core::Memory::Memory& memory{client_thread->GetOwnerProcess()->GetMemory()};
         u32* cmd_buf{reinterpret_cast<u32*>(memory.GetPointer(client_message))};
-        *out_context =
-            std::make_shared<Service::HLERequestContext>(m_kernel, memory, this, client_thread);
+        // Reuse the context from the previous request on this session when nothing else still
+        // holds it, so its buffers do not have to be reallocated.
+        auto& context = *out_context;
+        if (context == nullptr || context.use_count() != 1 ||
+            !context->ResetForNextRequest(memory, this, client_thread)) {
+            context =
+                std::make_shared<Service::HLERequestContext>(m_kernel, memory, this, client_thread);
+        }
         (*out_context)->SetSessionRequestManager(manager);
         (*out_context)->PopulateFromIncomingCommandBuffer(cmd_buf);
         // We succeeded.
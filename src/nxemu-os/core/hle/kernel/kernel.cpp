@@ -43,6 +43,7 @@
 #include "core/hle/kernel/physical_core.h"
 #include "core/hle/result.h"
 #include "core/hle/service/server_manager.h"
+#include "core/hle/service/service_executor.h"
 #include "core/hle/service/sm/sm.h"
 #include "core/memory.h"
 
@@ -187,6 +188,9 @@ struct KernelCore::Impl {
         // Ensures all servers gracefully shutdown.
         std::scoped_lock lk{server_lock};
         server_managers.clear();
+
+        // Servers wait for their in-flight requests on destruction, so the executor goes last.
+        service_executor.reset();
     }
 
     void InitializePhysicalCores() {
@@ -799,6 +803,7 @@ struct KernelCore::Impl {
 
     std::mutex server_lock;
     std::vector<std::unique_ptr<Service::ServerManager>> server_managers;
+    std::unique_ptr<Service::ServiceExecutor> service_executor;
 
     std::array<std::unique_ptr<Kernel::PhysicalCore>, Core::Hardware::NUM_CPU_CORES> cores;
 
@@ -1013,6 +1018,15 @@ void KernelCore::RunServer(std::unique_ptr<Service::ServerManager>&& server_mana
     manager->LoopProcess();
 }
 
+void KernelCore::StartServiceExecutor(size_t num_workers) {
+    impl->service_executor = std::make_unique<Service::ServiceExecutor>(*this, num_workers);
+    impl->service_executor->Start();
+}
+
+Service::ServiceExecutor* KernelCore::GetServiceExecutor() {
+    return impl->service_executor.get();
+}
+
 u32 KernelCore::CreateNewObjectID() {
     return impl->next_object_id++;
 }
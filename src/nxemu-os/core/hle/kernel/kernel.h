@@ -29,6 +29,7 @@ struct EventType;
 
 namespace Service {
 class ServerManager;
+class ServiceExecutor;
 }
 
 namespace Service::SM {
@@ -191,6 +192,12 @@ public:
     // Runs the given server manager until shutdown.
     void RunServer(std::unique_ptr<Service::ServerManager>&& server_manager);
 
+    /// Creates the shared host service executor and starts its workers.
+    void StartServiceExecutor(size_t num_workers);
+
+    /// Gets the shared host service executor, or nullptr when host services use dedicated threads.
+    Service::ServiceExecutor* GetServiceExecutor();
+
     /// Gets the current host_thread/guest_thread pointer.
     KThread* GetCurrentEmuThread() const;
 
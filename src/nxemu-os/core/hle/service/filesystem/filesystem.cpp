@@ -119,6 +119,17 @@ Result VfsDirectoryServiceWrapper::GetEntryType(FileSys::DirectoryEntryType* out
     return FileSys::ResultPathNotFound;
 }
 
+Result VfsDirectoryServiceWrapper::Commit() const
+{
+    // Buffered save data hands its dirty pages to the save flusher, every other directory writes
+    // straight through and has nothing to commit. Only a directory that is gone fails.
+    if (!backing->Commit())
+    {
+        return FileSys::ResultTargetNotFound;
+    }
+    return ResultSuccess;
+}
+
 void LoopProcess(Core::System& system) {
     auto server_manager = std::make_unique<ServerManager>(system);
 
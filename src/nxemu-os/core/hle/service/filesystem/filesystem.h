@@ -144,6 +144,12 @@ public:
      */
     Result GetEntryType(FileSys::DirectoryEntryType* out_entry_type, const std::string& path) const;
 
+    /**
+     * Make all writes to the archive durable
+     * @return Result of the operation
+     */
+    Result Commit() const;
+
 private:
     IVirtualDirectoryPtr backing;
 };
@@ -0,0 +1,61 @@
+// SPDX-FileCopyrightText: Copyright 2024 yuzu Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <vector>
+#include <boost/container/flat_map.hpp>
+#include "yuzu_common/common_types.h"
+
+namespace Service {
+
+template <typename Info>
+using HandlerMap = boost::container::flat_map<u32, Info>;
+
+template <typename Info>
+using HandlerTable = std::vector<const Info*>;
+
+/**
+ * Indexes the handlers of map directly by command id. The table is only built when the ids are
+ * compact enough that it stays small, services with a few handlers at large ids keep using the
+ * sorted map and get an empty table.
+ */
+template <typename Info>
+void BuildHandlerTable(const HandlerMap<Info>& map, HandlerTable<Info>& table) {
+    constexpr std::size_t MinTableSize = 256;
+    constexpr std::size_t MaxEntriesPerHandler = 16;
+
+    table.clear();
+    if (map.empty()) {
+        return;
+    }
+
+    const std::size_t table_size = static_cast<std::size_t>(std::prev(map.end())->first) + 1;
+    if (table_size > std::max(MinTableSize, map.size() * MaxEntriesPerHandler)) {
+        return;
+    }
+
+    // The map stores its values contiguously, so these pointers stay valid until the next insert,
+    // which rebuilds the table.
+    table.resize(table_size, nullptr);
+    for (const auto& [id, info] : map) {
+        table[id] = &info;
+    }
+}
+
+/// Returns the handler registered for command, or nullptr if there is none.
+template <typename Info>
+const Info* FindHandler(const HandlerMap<Info>& map, const HandlerTable<Info>& table,
+                        u32 command) {
+    if (!table.empty()) {
+        return command < table.size() ? table[command] : nullptr;
+    }
+
+    const auto itr = map.find(command);
+    return itr == map.end() ? nullptr : &itr->second;
+}
+
+} // namespace Service
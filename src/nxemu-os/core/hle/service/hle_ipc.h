@@ -198,6 +198,14 @@ public:
         return server_session;
     }
 
+    /**
+     * Prepares this context to receive the next request on its session, keeping the capacity of
+     * its descriptor and scratch buffers.
+     * @returns false if the context belongs to a different session or client process.
+     */
+    bool ResetForNextRequest(Core::Memory::Memory& memory_, Kernel::KServerSession* session,
+                             Kernel::KThread* thread_);
+
     /// Populates this context with data from the requesting process/thread.
     Result PopulateFromIncomingCommandBuffer(u32_le* src_cmdbuf);
 
@@ -12,8 +12,16 @@
 
 namespace Service::android {
 
-BufferItemConsumer::BufferItemConsumer(std::shared_ptr<BufferQueueConsumer> consumer_)
-    : ConsumerBase{std::move(consumer_)} {}
+BufferItemConsumer::BufferItemConsumer(std::shared_ptr<BufferQueueConsumer> consumer_,
+                                       std::function<void()> on_frame_available)
+    : ConsumerBase{std::move(consumer_)}, frame_available{std::move(on_frame_available)} {}
+
+void BufferItemConsumer::OnFrameAvailable(const BufferItem& item) {
+    ConsumerBase::OnFrameAvailable(item);
+    if (frame_available) {
+        frame_available();
+    }
+}
 
 Status BufferItemConsumer::AcquireBuffer(BufferItem* item, std::chrono::nanoseconds present_when,
                                          bool wait_for_fence) {
@@ -7,6 +7,7 @@
 #pragma once
 
 #include <chrono>
+#include <functional>
 #include <memory>
 
 #include "yuzu_common/common_types.h"
@@ -19,10 +20,16 @@ class BufferItem;
 
 class BufferItemConsumer final : public ConsumerBase {
 public:
-    explicit BufferItemConsumer(std::shared_ptr<BufferQueueConsumer> consumer);
+    explicit BufferItemConsumer(std::shared_ptr<BufferQueueConsumer> consumer,
+                                std::function<void()> on_frame_available = {});
     Status AcquireBuffer(BufferItem* item, std::chrono::nanoseconds present_when,
                          bool wait_for_fence = true);
     Status ReleaseBuffer(const BufferItem& item, const Fence& release_fence);
+
+private:
+    void OnFrameAvailable(const BufferItem& item) override;
+
+    std::function<void()> frame_available;
 };
 
 } // namespace Service::android
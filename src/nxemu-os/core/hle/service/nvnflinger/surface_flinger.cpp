@@ -53,7 +53,8 @@ void SurfaceFlinger::CreateLayer(s32 consumer_binder_id) {
         return;
     }
 
-    auto buffer_item_consumer = std::make_shared<android::BufferItemConsumer>(std::move(binder));
+    auto buffer_item_consumer = std::make_shared<android::BufferItemConsumer>(
+        std::move(binder), [this] { this->OnFrameAvailable(); });
     buffer_item_consumer->Connect(false);
 
     m_layers.layers.emplace_back(
@@ -101,6 +102,18 @@ void SurfaceFlinger::SetLayerBlending(s32 consumer_binder_id, LayerBlending blen
     }
 }
 
+void SurfaceFlinger::SetFrameAvailableCallback(std::function<void()> callback) {
+    std::scoped_lock lock{m_frame_available_mutex};
+    m_frame_available = std::move(callback);
+}
+
+void SurfaceFlinger::OnFrameAvailable() {
+    std::scoped_lock lock{m_frame_available_mutex};
+    if (m_frame_available) {
+        m_frame_available();
+    }
+}
+
 Display* SurfaceFlinger::FindDisplay(u64 display_id) {
     for (auto& display : m_displays) {
         if (display.id == display_id) {
@@ -3,6 +3,8 @@
 
 #pragma once
 
+#include <functional>
+#include <mutex>
 #include <vector>
 
 #include "yuzu_common/common_types.h"
@@ -45,7 +47,11 @@ public:
     void SetLayerVisibility(s32 consumer_binder_id, bool visible);
     void SetLayerBlending(s32 consumer_binder_id, LayerBlending blending);
 
+    /// Sets the function called whenever a layer has a new frame queued, nullptr to clear it.
+    void SetFrameAvailableCallback(std::function<void()> callback);
+
 private:
+    void OnFrameAvailable();
     Display* FindDisplay(u64 display_id);
     std::shared_ptr<Layer> FindLayer(s32 consumer_binder_id);
 
@@ -64,6 +70,9 @@ private:
     std::shared_ptr<Nvidia::Module> nvdrv;
     s32 disp_fd;
     HardwareComposer m_composer;
+
+    std::mutex m_frame_available_mutex;
+    std::function<void()> m_frame_available;
 };
 
 } // namespace Service::Nvnflinger
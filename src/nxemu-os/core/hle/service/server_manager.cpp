@@ -1,9 +1,12 @@
 // SPDX-FileCopyrightText: Copyright 2023 yuzu Emulator Project
 // SPDX-License-Identifier: GPL-2.0-or-later
 
+#include <chrono>
+
 #include "yuzu_common/scope_exit.h"
 
 #include "core/core.h"
+#include "core/hardware_properties.h"
 #include "core/hle/kernel/k_client_port.h"
 #include "core/hle/kernel/k_client_session.h"
 #include "core/hle/kernel/k_event.h"
@@ -16,6 +19,8 @@
 #include "core/hle/service/hle_ipc.h"
 #include "core/hle/service/ipc_helpers.h"
 #include "core/hle/service/server_manager.h"
+#include "core/hle/service/service.h"
+#include "core/hle/service/service_executor.h"
 #include "core/hle/service/sm/sm.h"
 
 namespace Service {
@@ -65,9 +70,24 @@ public:
         return m_context;
     }
 
+    ServiceRequestStats* GetRequestStats(ServiceExecutor& executor) {
+        if (m_stats == nullptr) {
+            std::string service_name{"Unknown"};
+            if (m_manager->HasSessionHandler()) {
+                if (auto* service =
+                        dynamic_cast<ServiceFrameworkBase*>(&m_manager->SessionHandler())) {
+                    service_name = service->GetServiceName();
+                }
+            }
+            m_stats = executor.GetRequestStats(service_name);
+        }
+        return m_stats;
+    }
+
 private:
     std::shared_ptr<SessionRequestManager> m_manager;
     std::shared_ptr<HLERequestContext> m_context;
+    ServiceRequestStats* m_stats{};
 };
 
 ServerManager::ServerManager(Core::System& system) : m_system{system}, m_selection_mutex{system} {
@@ -81,6 +101,12 @@ ServerManager::ServerManager(Core::System& system) : m_system{system}, m_selecti
     // Link to holder.
     m_wakeup_holder.emplace(std::addressof(m_wakeup_event->GetReadableEvent()));
     m_wakeup_holder->LinkToMultiWait(std::addressof(m_deferred_list));
+
+    // Servers running on host threads hand their requests to the shared executor when it is
+    // enabled. Servers on guest cores stay scheduled by the emulated kernel.
+    if (system.Kernel().GetCurrentHostThreadID() >= Core::Hardware::NUM_CPU_CORES) {
+        m_executor = system.Kernel().GetServiceExecutor();
+    }
 }
 
 ServerManager::~ServerManager() {
@@ -91,6 +117,10 @@ ServerManager::~ServerManager() {
     // Wait for processing to stop.
     m_stopped.Wait();
     m_threads.clear();
+    {
+        std::unique_lock lk{m_in_flight_mutex};
+        m_in_flight_cv.wait(lk, [this] { return m_in_flight == 0; });
+    }
 
     // Clean up ports.
     auto port_it = m_servers.begin();
@@ -235,6 +265,11 @@ Result ServerManager::ManageDeferral(Kernel::KEvent** out_event) {
 }
 
 void ServerManager::StartAdditionalHostThreads(const char* name, size_t num_threads) {
+    // Only servers whose handlers can block indefinitely (bsdsocket poll, recv and accept) ask
+    // for extra threads. Parking those on the shared executor would starve every other host
+    // service, so they keep dedicated threads.
+    m_executor = nullptr;
+
     for (size_t i = 0; i < num_threads; i++) {
         auto thread_name = fmt::format("{}:{}", name, i + 1);
         m_threads.emplace_back(m_system.Kernel().RunOnHostCoreThread(
@@ -303,9 +338,44 @@ Result ServerManager::Process(MultiWaitHolder* holder) {
     }
 }
 
+void ServerManager::Dispatch(MultiWaitHolder* holder) {
+    {
+        std::scoped_lock lk{m_in_flight_mutex};
+        m_in_flight++;
+    }
+
+    // The holder is unlinked until processing relinks it, so nothing else touches the session.
+    ServiceRequestStats* stats = nullptr;
+    if (static_cast<UserDataTag>(holder->GetUserData()) == UserDataTag::Session) {
+        stats = static_cast<Session*>(holder)->GetRequestStats(*m_executor);
+    }
+
+    const auto queued = std::chrono::steady_clock::now();
+    m_executor->Submit([this, holder, stats, queued] {
+        const auto started = std::chrono::steady_clock::now();
+        R_ASSERT(this->Process(holder));
+
+        if (stats != nullptr) {
+            const auto finished = std::chrono::steady_clock::now();
+            stats->Record(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(started - queued).count(),
+                std::chrono::duration_cast<std::chrono::nanoseconds>(finished - started).count());
+        }
+
+        std::scoped_lock lk{m_in_flight_mutex};
+        if (--m_in_flight == 0) {
+            m_in_flight_cv.notify_all();
+        }
+    });
+}
+
 bool ServerManager::WaitAndProcessImpl() {
     if (auto* signaled_holder = this->WaitSignaled(); signaled_holder != nullptr) {
-        R_ASSERT(this->Process(signaled_holder));
+        if (m_executor != nullptr) {
+            this->Dispatch(signaled_holder);
+        } else {
+            R_ASSERT(this->Process(signaled_holder));
+        }
         return true;
     } else {
         return false;
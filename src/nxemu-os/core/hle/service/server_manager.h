@@ -3,6 +3,7 @@
 
 #pragma once
 
+#include <condition_variable>
 #include <list>
 #include <mutex>
 #include <optional>
@@ -28,6 +29,7 @@ class KServerSession;
 namespace Service {
 
 class Port;
+class ServiceExecutor;
 class Session;
 
 class ServerManager {
@@ -57,6 +59,7 @@ private:
     void LinkDeferred();
     MultiWaitHolder* WaitSignaled();
     Result Process(MultiWaitHolder* holder);
+    void Dispatch(MultiWaitHolder* holder);
     bool WaitAndProcessImpl();
     Result LoopProcessImpl();
 
@@ -92,6 +95,12 @@ private:
     Common::Event m_stopped{};
     std::vector<std::jthread> m_threads{};
     std::stop_source m_stop_source{};
+
+    // Shared executor state, only used by host servers when the executor is enabled
+    ServiceExecutor* m_executor{};
+    std::mutex m_in_flight_mutex{};
+    std::condition_variable m_in_flight_cv{};
+    size_t m_in_flight{};
 };
 
 } // namespace Service
@@ -1,6 +1,8 @@
 // SPDX-FileCopyrightText: Copyright 2018 yuzu Emulator Project
 // SPDX-License-Identifier: GPL-2.0-or-later
 
+#include <algorithm>
+
 #include <fmt/format.h>
 #include "yuzu_common/yuzu_assert.h"
 #include "yuzu_common/logging/log.h"
@@ -16,21 +18,36 @@ namespace Service {
 
 /**
  * Creates a function string for logging, complete with the name (or header code, depending
- * on what's passed in) the port name, and all the cmd_buff arguments.
+ * on what's passed in) the port name, the command id and all the cmd_buff arguments.
  */
 [[maybe_unused]] static std::string MakeFunctionString(std::string_view name,
-                                                       std::string_view port_name,
+                                                       std::string_view port_name, u32 command,
                                                        const u32* cmd_buff) {
     // Number of params == bits 0-5 + bits 6-11
     int num_params = (cmd_buff[0] & 0x3F) + ((cmd_buff[0] >> 6) & 0x3F);
 
-    std::string function_string = fmt::format("function '{}': port={}", name, port_name);
+    std::string function_string =
+        fmt::format("function '{}': port={}, command={}", name, port_name, command);
     for (int i = 1; i <= num_params; ++i) {
         function_string += fmt::format(", cmd_buff[{}]=0x{:X}", i, cmd_buff[i]);
     }
     return function_string;
 }
 
+/**
+ * Creates a string listing the command ids registered for a port. Together with the function
+ * strings of the requests, a trace log holds everything nxemu-bench needs to replay dispatch.
+ */
+template <typename Map>
+[[maybe_unused]] static std::string MakeHandlersString(std::string_view port_name,
+                                                       const Map& handlers) {
+    std::string handlers_string = fmt::format("handlers: port={}, commands=", port_name);
+    for (const auto& [id, info] : handlers) {
+        handlers_string += fmt::format("{},", id);
+    }
+    return handlers_string;
+}
+
 ServiceFrameworkBase::ServiceFrameworkBase(Core::System& system_, const char* service_name_,
                                            u32 max_sessions_, InvokerFn* handler_invoker_)
     : SessionRequestHandler(system_.Kernel(), service_name_), system{system_},
@@ -47,6 +64,8 @@ void ServiceFrameworkBase::RegisterHandlersBase(const FunctionInfoBase* function
         // Usually this array is sorted by id already, so hint to insert at the end
         handlers.emplace_hint(handlers.cend(), functions[i].expected_header, functions[i]);
     }
+    BuildHandlerTable(handlers, handler_table);
+    LOG_TRACE(Service, "{}", MakeHandlersString(service_name, handlers));
 }
 
 void ServiceFrameworkBase::RegisterHandlersBaseTipc(const FunctionInfoBase* functions,
@@ -57,6 +76,7 @@ void ServiceFrameworkBase::RegisterHandlersBaseTipc(const FunctionInfoBase* func
         handlers_tipc.emplace_hint(handlers_tipc.cend(), functions[i].expected_header,
                                    functions[i]);
     }
+    BuildHandlerTable(handlers_tipc, handler_table_tipc);
 }
 
 void ServiceFrameworkBase::ReportUnimplementedFunction(HLERequestContext& ctx,
@@ -81,27 +101,27 @@ void ServiceFrameworkBase::ReportUnimplementedFunction(HLERequestContext& ctx,
 }
 
 void ServiceFrameworkBase::InvokeRequest(HLERequestContext& ctx) {
-    auto itr = handlers.find(ctx.GetCommand());
-    const FunctionInfoBase* info = itr == handlers.end() ? nullptr : &itr->second;
+    const FunctionInfoBase* info = FindHandler(handlers, handler_table, ctx.GetCommand());
     if (info == nullptr || info->handler_callback == nullptr) {
         return ReportUnimplementedFunction(ctx, info);
     }
 
-    LOG_TRACE(Service, "{}", MakeFunctionString(info->name, GetServiceName(), ctx.CommandBuffer()));
+    LOG_TRACE(Service, "{}",
+              MakeFunctionString(info->name, GetServiceName(), ctx.GetCommand(),
+                                 ctx.CommandBuffer()));
     handler_invoker(this, info->handler_callback, ctx);
 }
 
 void ServiceFrameworkBase::InvokeRequestTipc(HLERequestContext& ctx) {
-    boost::container::flat_map<u32, FunctionInfoBase>::iterator itr;
-
-    itr = handlers_tipc.find(ctx.GetCommand());
-
-    const FunctionInfoBase* info = itr == handlers_tipc.end() ? nullptr : &itr->second;
+    const FunctionInfoBase* info =
+        FindHandler(handlers_tipc, handler_table_tipc, ctx.GetCommand());
     if (info == nullptr || info->handler_callback == nullptr) {
         return ReportUnimplementedFunction(ctx, info);
     }
 
-    LOG_TRACE(Service, "{}", MakeFunctionString(info->name, GetServiceName(), ctx.CommandBuffer()));
+    LOG_TRACE(Service, "tipc {}",
+              MakeFunctionString(info->name, GetServiceName(), ctx.GetCommand(),
+                                 ctx.CommandBuffer()));
     handler_invoker(this, info->handler_callback, ctx);
 }
 
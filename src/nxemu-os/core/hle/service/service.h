@@ -6,8 +6,9 @@
 #include <cstddef>
 #include <mutex>
 #include <string>
-#include <boost/container/flat_map.hpp>
+#include <vector>
 #include "yuzu_common/common_types.h"
+#include "core/hle/service/handler_table.h"
 #include "core/hle/service/hle_ipc.h"
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -97,6 +98,9 @@ private:
                                   u32 max_sessions_, InvokerFn* handler_invoker_);
     ~ServiceFrameworkBase() override;
 
+    using HandlerMap = Service::HandlerMap<FunctionInfoBase>;
+    using HandlerTable = Service::HandlerTable<FunctionInfoBase>;
+
     void RegisterHandlersBase(const FunctionInfoBase* functions, std::size_t n);
     void RegisterHandlersBaseTipc(const FunctionInfoBase* functions, std::size_t n);
     void ReportUnimplementedFunction(HLERequestContext& ctx, const FunctionInfoBase* info);
@@ -110,8 +114,12 @@ private:
 
     /// Function used to safely up-cast pointers to the derived class before invoking a handler.
     InvokerFn* handler_invoker;
-    boost::container::flat_map<u32, FunctionInfoBase> handlers;
-    boost::container::flat_map<u32, FunctionInfoBase> handlers_tipc;
+    HandlerMap handlers;
+    HandlerMap handlers_tipc;
+
+    /// Handlers indexed directly by command id, only built when the ids are compact.
+    HandlerTable handler_table;
+    HandlerTable handler_table_tipc;
 
     /// Used to gain exclusive access to the service members, e.g. from CoreTiming thread.
     std::mutex lock_service;
@@ -0,0 +1,175 @@
+// SPDX-FileCopyrightText: Copyright 2026 yuzu Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <algorithm>
+#include <limits>
+
+#include <fmt/format.h>
+
+#include "yuzu_common/logging/log.h"
+#include "core/hardware_properties.h"
+#include "core/hle/kernel/kernel.h"
+#include "core/hle/service/service_executor.h"
+
+namespace Service {
+
+namespace {
+// Index of the executor worker running on the current thread, or SIZE_MAX for any other thread.
+thread_local size_t current_worker_index = std::numeric_limits<size_t>::max();
+} // namespace
+
+void ServiceRequestStats::Record(u64 queue_ns, u64 process_ns) {
+    requests.fetch_add(1, std::memory_order_relaxed);
+    total_queue_ns.fetch_add(queue_ns, std::memory_order_relaxed);
+    total_process_ns.fetch_add(process_ns, std::memory_order_relaxed);
+
+    u64 current_max = max_process_ns.load(std::memory_order_relaxed);
+    while (process_ns > current_max &&
+           !max_process_ns.compare_exchange_weak(current_max, process_ns,
+                                                 std::memory_order_relaxed)) {
+    }
+}
+
+ServiceExecutor::ServiceExecutor(Kernel::KernelCore& kernel, size_t num_workers)
+    : m_kernel{kernel} {
+    num_workers = std::max<size_t>(num_workers, 1);
+    m_queues.reserve(num_workers);
+    for (size_t i = 0; i < num_workers; i++) {
+        m_queues.emplace_back(std::make_unique<WorkerQueue>());
+    }
+}
+
+ServiceExecutor::~ServiceExecutor() {
+    m_stop_source.request_stop();
+    {
+        std::scoped_lock lk{m_wait_mutex};
+        m_wait_cv.notify_all();
+    }
+
+    // The main worker is the only thread that spawns helpers, so once it has exited the helper
+    // list can no longer change.
+    if (m_main_thread.joinable()) {
+        m_main_thread.join();
+    }
+    {
+        std::scoped_lock lk{m_threads_mutex};
+        m_helper_threads.clear();
+    }
+
+    LogRequestStats();
+}
+
+void ServiceExecutor::Start() {
+    m_main_thread = m_kernel.RunOnHostCoreProcess("ServiceExecutor", [this] {
+        {
+            // Helpers are created from here so that they share the executor process.
+            std::scoped_lock lk{m_threads_mutex};
+            for (size_t i = 1; i < m_queues.size() && !m_stop_source.stop_requested(); i++) {
+                m_helper_threads.emplace_back(m_kernel.RunOnHostCoreThread(
+                    fmt::format("ServiceExecutor:{}", i),
+                    [this, i] { WorkerLoop(i, m_stop_source.get_token()); }));
+            }
+        }
+        WorkerLoop(0, m_stop_source.get_token());
+    });
+}
+
+void ServiceExecutor::Submit(Task&& task) {
+    size_t index = current_worker_index;
+    if (index >= m_queues.size()) {
+        index = m_next_queue.fetch_add(1, std::memory_order_relaxed) % m_queues.size();
+    }
+
+    // Count the task before publishing it so a worker never takes it while the count is zero.
+    m_pending.fetch_add(1, std::memory_order_release);
+    {
+        std::scoped_lock lk{m_queues[index]->mutex};
+        m_queues[index]->tasks.emplace_back(std::move(task));
+    }
+
+    {
+        std::scoped_lock lk{m_wait_mutex};
+        m_wait_cv.notify_one();
+    }
+}
+
+ServiceRequestStats* ServiceExecutor::GetRequestStats(const std::string& service_name) {
+    std::scoped_lock lk{m_stats_mutex};
+    return std::addressof(m_stats[service_name]);
+}
+
+void ServiceExecutor::LogRequestStats() {
+    std::scoped_lock lk{m_stats_mutex};
+    for (const auto& [name, stats] : m_stats) {
+        const u64 requests = stats.requests.load(std::memory_order_relaxed);
+        if (requests == 0) {
+            continue;
+        }
+        LOG_INFO(Service, "{}: {} requests, avg queue {} us, avg process {} us, max process {} us",
+                 name, requests, stats.total_queue_ns.load() / requests / 1000,
+                 stats.total_process_ns.load() / requests / 1000,
+                 stats.max_process_ns.load() / 1000);
+    }
+}
+
+size_t ServiceExecutor::DefaultWorkerCount() {
+    // Leave room for the emulated CPU cores and the GPU thread.
+    constexpr size_t ReservedHostThreads = Core::Hardware::NUM_CPU_CORES + 1;
+    constexpr size_t MaxWorkers = 4;
+
+    const size_t host_threads = std::thread::hardware_concurrency();
+    if (host_threads <= ReservedHostThreads) {
+        return 1;
+    }
+    return std::min(host_threads - ReservedHostThreads, MaxWorkers);
+}
+
+void ServiceExecutor::WorkerLoop(size_t index, std::stop_token stop_token) {
+    current_worker_index = index;
+
+    while (!stop_token.stop_requested()) {
+        Task task;
+        if (TryPop(index, task) || TrySteal(index, task)) {
+            task();
+            continue;
+        }
+
+        std::unique_lock lk{m_wait_mutex};
+        Common::CondvarWait(m_wait_cv, lk, stop_token, [this] {
+            return m_pending.load(std::memory_order_acquire) != 0;
+        });
+    }
+}
+
+bool ServiceExecutor::TryPop(size_t index, Task& task) {
+    WorkerQueue& queue = *m_queues[index];
+    std::scoped_lock lk{queue.mutex};
+    if (queue.tasks.empty()) {
+        return false;
+    }
+
+    // Run our own most recent work first, it is the most likely to be cache-warm.
+    task = std::move(queue.tasks.back());
+    queue.tasks.pop_back();
+    m_pending.fetch_sub(1, std::memory_order_acq_rel);
+    return true;
+}
+
+bool ServiceExecutor::TrySteal(size_t index, Task& task) {
+    for (size_t offset = 1; offset < m_queues.size(); offset++) {
+        WorkerQueue& victim = *m_queues[(index + offset) % m_queues.size()];
+        std::scoped_lock lk{victim.mutex};
+        if (victim.tasks.empty()) {
+            continue;
+        }
+
+        // Steal the oldest work, leaving the victim its cache-warm tail.
+        task = std::move(victim.tasks.front());
+        victim.tasks.pop_front();
+        m_pending.fetch_sub(1, std::memory_order_acq_rel);
+        return true;
+    }
+    return false;
+}
+
+} // namespace Service
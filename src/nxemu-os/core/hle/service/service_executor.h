@@ -0,0 +1,103 @@
+// SPDX-FileCopyrightText: Copyright 2026 yuzu Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "yuzu_common/common_types.h"
+#include "yuzu_common/polyfill_thread.h"
+#include "yuzu_common/unique_function.h"
+
+namespace Kernel {
+class KernelCore;
+}
+
+namespace Service {
+
+/// Request latency counters for a single service, updated without locking by the worker that
+/// completed the request.
+struct ServiceRequestStats {
+    std::atomic<u64> requests{};
+    std::atomic<u64> total_queue_ns{};
+    std::atomic<u64> total_process_ns{};
+    std::atomic<u64> max_process_ns{};
+
+    void Record(u64 queue_ns, u64 process_ns);
+};
+
+/**
+ * Shared pool of host service threads. Instead of each host ServerManager processing requests on
+ * its own dedicated threads, signaled sessions are handed to this executor and run on whichever
+ * worker is free. Every worker owns a queue; idle workers steal from the others so a burst of
+ * requests on one service does not serialize behind a single thread. Servers with handlers that
+ * can block indefinitely keep their dedicated threads, see StartAdditionalHostThreads.
+ */
+class ServiceExecutor {
+public:
+    using Task = Common::UniqueFunction<void>;
+
+    explicit ServiceExecutor(Kernel::KernelCore& kernel, size_t num_workers);
+    ~ServiceExecutor();
+
+    ServiceExecutor(const ServiceExecutor&) = delete;
+    ServiceExecutor& operator=(const ServiceExecutor&) = delete;
+
+    /// Starts the worker threads inside a dedicated host process.
+    void Start();
+
+    /// Queues a task, preferring the calling worker's own queue when called from a worker.
+    void Submit(Task&& task);
+
+    /// Returns the counters for the named service, creating them on first use. The returned
+    /// pointer remains valid for the lifetime of the executor.
+    ServiceRequestStats* GetRequestStats(const std::string& service_name);
+
+    /// Writes the per-service request latency summary to the log.
+    void LogRequestStats();
+
+    size_t NumWorkers() const {
+        return m_queues.size();
+    }
+
+    /// Number of workers that fit in the host cores not already taken by the emulated CPU cores
+    /// and the GPU thread.
+    static size_t DefaultWorkerCount();
+
+private:
+    struct WorkerQueue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    void WorkerLoop(size_t index, std::stop_token stop_token);
+    bool TryPop(size_t index, Task& task);
+    bool TrySteal(size_t index, Task& task);
+
+    Kernel::KernelCore& m_kernel;
+
+    std::vector<std::unique_ptr<WorkerQueue>> m_queues;
+    std::atomic<size_t> m_next_queue{};
+    std::atomic<size_t> m_pending{};
+
+    std::mutex m_wait_mutex;
+    std::condition_variable_any m_wait_cv;
+
+    std::mutex m_threads_mutex;
+    std::stop_source m_stop_source;
+    std::jthread m_main_thread;
+    std::vector<std::jthread> m_helper_threads;
+
+    std::mutex m_stats_mutex;
+    std::unordered_map<std::string, ServiceRequestStats> m_stats;
+};
+
+} // namespace Service
@@ -3,6 +3,8 @@
 
 #include "core/hle/service/services.h"
 
+#include "yuzu_common/settings.h"
+
 #include "core/hle/service/acc/acc.h"
 #include "core/hle/service/am/am.h"
 #include "core/hle/service/aoc/addon_content_manager.h"
@@ -50,6 +52,7 @@
 #include "core/hle/service/ptm/ptm.h"
 #include "core/hle/service/ro/ro.h"
 #include "core/hle/service/service.h"
+#include "core/hle/service/service_executor.h"
 #include "core/hle/service/set/settings.h"
 #include "core/hle/service/sm/sm.h"
 #include "core/hle/service/sockets/sockets.h"
@@ -64,6 +67,11 @@ Services::Services(std::shared_ptr<SM::ServiceManager>& sm, Core::System& system
                    std::stop_token token) {
     auto& kernel = system.Kernel();
 
+    // Host servers pick up the executor when they are created, so it has to exist first.
+    if (Settings::values.use_service_executor.GetValue()) {
+        kernel.StartServiceExecutor(ServiceExecutor::DefaultWorkerCount());
+    }
+
     // clang-format off
     kernel.RunOnHostCoreProcess("audio",      [&] { Audio::LoopProcess(system); }).detach();
     kernel.RunOnHostCoreProcess("FS",         [&] { FileSystem::LoopProcess(system); }).detach();
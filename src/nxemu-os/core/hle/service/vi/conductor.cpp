@@ -1,7 +1,10 @@
 // SPDX-FileCopyrightText: Copyright 2024 yuzu Emulator Project
 // SPDX-License-Identifier: GPL-2.0-or-later
 
+#include <thread>
+
 #include "yuzu_common/yuzu_assert.h"
+#include "yuzu_common/logging/log.h"
 #include "yuzu_common/settings.h"
 #include "core/core.h"
 #include "core/core_timing.h"
@@ -12,26 +15,39 @@
 
 constexpr auto FrameNs = std::chrono::nanoseconds{1000000000 / 60};
 
+// The paced vsync thread sleeps until this close to the deadline, then yields until it is reached.
+constexpr auto PacedSpinMargin = std::chrono::microseconds{1500};
+
 namespace Service::VI {
 
 Conductor::Conductor(Core::System& system, Container& container, DisplayList& displays)
-    : m_system(system), m_container(container) {
+    : m_system(system), m_container(container),
+      m_mode(Settings::values.presentation_mode.GetValue()) {
     displays.ForEachDisplay([&](Display& display) {
         m_vsync_managers.insert({display.GetId(), VsyncManager{}});
     });
 
     if (system.IsMulticore()) {
-        m_event = Core::Timing::CreateEvent(
-            "ScreenComposition",
-            [this](s64 time,
-                   std::chrono::nanoseconds ns_late) -> std::optional<std::chrono::nanoseconds> {
-                m_signal.Set();
-                return std::chrono::nanoseconds(this->GetNextTicks());
-            });
-
-        system.CoreTiming().ScheduleLoopingEvent(FrameNs, FrameNs, m_event);
+        // Unlocked and paced vsync are driven by the vsync thread itself in host time, only
+        // the fixed mode follows emulated time.
+        if (m_mode == Settings::PresentationMode::Fixed) {
+            m_event = Core::Timing::CreateEvent(
+                "ScreenComposition",
+                [this](s64 time, std::chrono::nanoseconds ns_late)
+                    -> std::optional<std::chrono::nanoseconds> {
+                    m_signal.Set();
+                    return std::chrono::nanoseconds(this->GetNextTicks());
+                });
+
+            system.CoreTiming().ScheduleLoopingEvent(FrameNs, FrameNs, m_event);
+        }
+        m_paced_epoch = std::chrono::steady_clock::now();
         m_thread = std::jthread([this](std::stop_token token) { this->VsyncThread(token); });
     } else {
+        if (m_mode == Settings::PresentationMode::Paced) {
+            LOG_WARNING(Service_VI, "Paced presentation requires multicore, using fixed timing");
+            m_mode = Settings::PresentationMode::Fixed;
+        }
         m_event = Core::Timing::CreateEvent(
             "ScreenComposition",
             [this](s64 time,
@@ -45,7 +61,9 @@ Conductor::Conductor(Core::System& system, Container& container, DisplayList& di
 }
 
 Conductor::~Conductor() {
-    m_system.CoreTiming().UnscheduleEvent(m_event);
+    if (m_event) {
+        m_system.CoreTiming().UnscheduleEvent(m_event);
+    }
 
     if (m_system.IsMulticore()) {
         m_thread.request_stop();
@@ -65,6 +83,12 @@ void Conductor::UnlinkVsyncEvent(u64 display_id, Event* event) {
     }
 }
 
+void Conductor::OnFrameAvailable() {
+    if (m_mode == Settings::PresentationMode::Unlocked) {
+        m_signal.Set();
+    }
+}
+
 void Conductor::ProcessVsync() {
     for (auto& [display_id, manager] : m_vsync_managers) {
         m_container.ComposeOnDisplay(&m_swap_interval, &m_compose_speed_scale, display_id);
@@ -75,8 +99,21 @@ void Conductor::ProcessVsync() {
 void Conductor::VsyncThread(std::stop_token token) {
     Common::SetCurrentThreadName("VSyncThread");
 
+    auto ideal_vsync = m_paced_epoch;
     while (!token.stop_requested()) {
-        m_signal.Wait();
+        switch (m_mode) {
+        case Settings::PresentationMode::Unlocked:
+            // Compose as soon as a layer queues a new frame. Without one, keep signalling vsync
+            // at the host refresh rate for games that wait on it before presenting.
+            m_signal.WaitFor(std::chrono::nanoseconds{1000000000 / m_system.HostRefreshRate()});
+            break;
+        case Settings::PresentationMode::Paced:
+            ideal_vsync = this->WaitForPacedVsync(ideal_vsync);
+            break;
+        default:
+            m_signal.Wait();
+            break;
+        }
 
         if (m_system.IsShuttingDown()) {
             return;
@@ -86,10 +123,42 @@ void Conductor::VsyncThread(std::stop_token token) {
     }
 }
 
+std::chrono::steady_clock::time_point Conductor::WaitForPacedVsync(
+    std::chrono::steady_clock::time_point ideal_vsync) {
+    using Clock = std::chrono::steady_clock;
+
+    const auto host_period = std::chrono::nanoseconds{1000000000 / m_system.HostRefreshRate()};
+    ideal_vsync += std::chrono::nanoseconds{this->GetNextTicks()};
+
+    // After a stall, restart the timeline rather than composing a burst of frames to catch up.
+    const auto now = Clock::now();
+    if (ideal_vsync + host_period < now) {
+        ideal_vsync = now;
+    }
+
+    // Compose on the host refresh nearest to the ideal time. Over several frames this keeps the
+    // emulated frame rate while every present lands on a host refresh instead of up to a full
+    // refresh before the next one.
+    const auto refreshes = (ideal_vsync - m_paced_epoch + host_period / 2) / host_period;
+    const auto deadline = m_paced_epoch + refreshes * host_period;
+
+    if (m_signal.WaitUntil(deadline - PacedSpinMargin)) {
+        // Woken up for shutdown.
+        return ideal_vsync;
+    }
+    while (Clock::now() < deadline) {
+        std::this_thread::yield();
+    }
+    return ideal_vsync;
+}
+
 s64 Conductor::GetNextTicks() const {
     const auto& settings = Settings::values;
     auto speed_scale = 1.f;
-    if (settings.use_multi_core.GetValue()) {
+    if (m_mode == Settings::PresentationMode::Unlocked) {
+        // Single core has no vsync thread, compose as often as core timing allows.
+        speed_scale = 0.01f;
+    } else if (settings.use_multi_core.GetValue()) {
         if (settings.use_speed_limit.GetValue()) {
             // Scales the speed based on speed_limit setting on MC. SC is handled by
             // SpeedLimiter::DoSpeedLimiting.
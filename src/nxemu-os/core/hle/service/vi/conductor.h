@@ -3,11 +3,13 @@
 
 #pragma once
 
+#include <chrono>
 #include <memory>
 #include <unordered_map>
 
 #include "yuzu_common/common_types.h"
 #include "yuzu_common/polyfill_thread.h"
+#include "yuzu_common/settings_enums.h"
 #include "yuzu_common/thread.h"
 
 #include "core/hle/service/vi/vsync_manager.h"
@@ -37,14 +39,21 @@ public:
     void LinkVsyncEvent(u64 display_id, Event* event);
     void UnlinkVsyncEvent(u64 display_id, Event* event);
 
+    /// Called when a layer has a new frame queued, wakes the vsync thread in the unlocked mode.
+    void OnFrameAvailable();
+
 private:
     void ProcessVsync();
     void VsyncThread(std::stop_token token);
+    std::chrono::steady_clock::time_point WaitForPacedVsync(
+        std::chrono::steady_clock::time_point ideal_vsync);
     s64 GetNextTicks() const;
 
 private:
     Core::System& m_system;
     Container& m_container;
+    Settings::PresentationMode m_mode;
+    std::chrono::steady_clock::time_point m_paced_epoch;
     std::unordered_map<u64, VsyncManager> m_vsync_managers;
     std::shared_ptr<Core::Timing::EventType> m_event;
     Common::Event m_signal;
@@ -32,6 +32,7 @@ Container::Container(Core::System& system) {
         [&](auto& display) { m_surface_flinger->AddDisplay(display.GetId()); });
 
     m_conductor.emplace(system, *this, m_displays);
+    m_surface_flinger->SetFrameAvailableCallback([this] { m_conductor->OnFrameAvailable(); });
 }
 
 Container::~Container() {
@@ -42,6 +43,7 @@ void Container::OnTerminate() {
     std::scoped_lock lk{m_lock};
 
     m_is_shut_down = true;
+    m_surface_flinger->SetFrameAvailableCallback(nullptr);
 
     m_layers.ForEachLayer([&](auto& layer) { this->DestroyLayerLocked(layer.GetId()); });
 
@@ -823,7 +823,7 @@ struct Memory::Impl {
         context.core = system.GetCurrentHostThreadID();
         context.current_area = &rasterizer_read_areas[context.core];
         context.size = size;
-        system.GetVideo().ApplyOpOnDeviceMemoryPointer(p, scratch_buffers[context.core].data(), scratch_buffers[context.core].size(), HandleRasterizerDownloadCallback, &context);
+        ApplyOpOnDeviceMemoryPointer(p, HandleRasterizerDownloadCallback, &context);
     }
 
     struct RasterizerWriteContext {
@@ -870,7 +870,26 @@ struct Memory::Impl {
             }
         };
 
-        system.GetVideo().ApplyOpOnDeviceMemoryPointer(p, scratch_buffers[core].data(), scratch_buffers[core].size(), HandleRasterizerWriteCallback, &context);
+        ApplyOpOnDeviceMemoryPointer(p, HandleRasterizerWriteCallback, &context);
+    }
+
+    /// Calls operation for every device address the host pointer is mapped at. Pages mapped at a
+    /// single device address are translated through the video module's reverse map directly,
+    /// only multi-mapped pages need a call into the video module.
+    void ApplyOpOnDeviceMemoryPointer(const u8* p, DeviceMemoryOperation operation,
+                                      void* user_data) {
+        std::call_once(device_reverse_map_once, [this] {
+            device_reverse_map = system.GetVideo().GetDeviceMemoryReverseMap();
+        });
+        const DeviceMemoryReverseMap& map = device_reverse_map;
+        const u64 address = reinterpret_cast<uintptr_t>(p) - map.physicalBase;
+        const u32 base = map.deviceAddressTable[address >> map.pageBits];
+        if ((base & map.multiMapFlag) == 0) [[likely]] {
+            const u64 page_mask = (1ULL << map.pageBits) - 1;
+            operation((static_cast<u64>(base) << map.pageBits) + (address & page_mask), user_data);
+            return;
+        }
+        system.GetVideo().ApplyOpOnDeviceMemoryPointer(p, operation, user_data);
     }
 
     struct GPUDirtyState {
@@ -885,7 +904,8 @@ struct Memory::Impl {
     Common::PageTable* current_page_table = nullptr;
     std::array<RasterizerDownloadArea, Core::Hardware::NUM_CPU_CORES> rasterizer_read_areas{};
     std::array<GPUDirtyState, Core::Hardware::NUM_CPU_CORES> rasterizer_write_areas{};
-    std::array<Common::ScratchBuffer<u32>, Core::Hardware::NUM_CPU_CORES> scratch_buffers{};
+    DeviceMemoryReverseMap device_reverse_map{};
+    std::once_flag device_reverse_map_once;
     std::span<Core::GPUDirtyMemoryManager> gpu_dirty_managers;
     std::mutex sys_core_guard;
 
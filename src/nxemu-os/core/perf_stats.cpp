@@ -71,6 +71,11 @@ void PerfStats::EndSystemFrame() {
 
     previous_frame_length = frame_end - previous_frame_end;
     previous_frame_end = frame_end;
+
+    recent_frame_times[recent_frame_index] =
+        std::chrono::duration<double, std::milli>(previous_frame_length).count();
+    recent_frame_index = (recent_frame_index + 1) % recent_frame_times.size();
+    recent_frame_count = std::min(recent_frame_count + 1, recent_frame_times.size());
 }
 
 void PerfStats::EndGameFrame() {
@@ -93,29 +98,58 @@ PerfStatsResults PerfStats::GetAndResetStats(microseconds current_system_time_us
     std::scoped_lock lock{object_mutex};
 
     const auto now = Clock::now();
+    double current_fps;
+    const PerfStatsResults results = GetStatsLocked(now, current_system_time_us, current_fps);
+
+    // Reset counters
+    reset_point = now;
+    reset_point_system_us = current_system_time_us;
+    accumulated_frametime = Clock::duration::zero();
+    system_frames = 0;
+    game_frames.store(0, std::memory_order_relaxed);
+    previous_fps = current_fps;
+
+    return results;
+}
+
+PerfStatsResults PerfStats::GetStats(microseconds current_system_time_us) const {
+    std::scoped_lock lock{object_mutex};
+
+    double current_fps;
+    return GetStatsLocked(Clock::now(), current_system_time_us, current_fps);
+}
+
+PerfStatsResults PerfStats::GetStatsLocked(Clock::time_point now,
+                                           microseconds current_system_time_us,
+                                           double& current_fps) const {
     // Walltime elapsed since stats were reset
     const auto interval = duration_cast<DoubleSecs>(now - reset_point).count();
 
     const auto system_us_per_second = (current_system_time_us - reset_point_system_us) / interval;
     const auto current_frames = static_cast<double>(game_frames.load(std::memory_order_relaxed));
-    const auto current_fps = current_frames / interval;
-    const PerfStatsResults results{
+    current_fps = current_frames / interval;
+
+    std::array<double, FrameTimeWindow> sorted_frame_times;
+    std::copy_n(recent_frame_times.begin(), recent_frame_count, sorted_frame_times.begin());
+    std::sort(sorted_frame_times.begin(), sorted_frame_times.begin() + recent_frame_count);
+    const auto percentile = [&](double fraction) {
+        if (recent_frame_count == 0) {
+            return 0.0;
+        }
+        const auto rank = static_cast<std::size_t>(fraction * (recent_frame_count - 1) + 0.5);
+        return sorted_frame_times[rank];
+    };
+
+    return PerfStatsResults{
         .system_fps = static_cast<double>(system_frames) / interval,
         .average_game_fps = (current_fps + previous_fps) / 2.0,
         .frametime = duration_cast<DoubleSecs>(accumulated_frametime).count() /
                      static_cast<double>(system_frames),
         .emulation_speed = system_us_per_second.count() / 1'000'000.0,
+        .frametime_p50 = percentile(0.50),
+        .frametime_p95 = percentile(0.95),
+        .frametime_p99 = percentile(0.99),
     };
-
-    // Reset counters
-    reset_point = now;
-    reset_point_system_us = current_system_time_us;
-    accumulated_frametime = Clock::duration::zero();
-    system_frames = 0;
-    game_frames.store(0, std::memory_order_relaxed);
-    previous_fps = current_fps;
-
-    return results;
 }
 
 double PerfStats::GetLastFrameTimeScale() const {
@@ -127,7 +161,8 @@ double PerfStats::GetLastFrameTimeScale() const {
 
 void SpeedLimiter::DoSpeedLimiting(microseconds current_system_time_us) {
     if (Settings::values.use_multi_core.GetValue() ||
-        !Settings::values.use_speed_limit.GetValue()) {
+        !Settings::values.use_speed_limit.GetValue() ||
+        Settings::values.presentation_mode.GetValue() == Settings::PresentationMode::Unlocked) {
         return;
     }
 
@@ -21,6 +21,12 @@ struct PerfStatsResults {
     double frametime;
     /// Ratio of walltime / emulated time elapsed
     double emulation_speed;
+    /// Median walltime between system frames over the recent frame window, in milliseconds
+    double frametime_p50;
+    /// 95th percentile walltime between system frames over the recent frame window, in milliseconds
+    double frametime_p95;
+    /// 99th percentile walltime between system frames over the recent frame window, in milliseconds
+    double frametime_p99;
 };
 
 /**
@@ -40,6 +46,9 @@ public:
 
     PerfStatsResults GetAndResetStats(std::chrono::microseconds current_system_time_us);
 
+    /// Gets the statistics accumulated since the last reset without resetting them.
+    PerfStatsResults GetStats(std::chrono::microseconds current_system_time_us) const;
+
     /**
      * Returns the arithmetic mean of all frametime values stored in the performance history.
      */
@@ -52,6 +61,11 @@ public:
     double GetLastFrameTimeScale() const;
 
 private:
+    /// Computes the statistics since the last reset, object_mutex must be held.
+    PerfStatsResults GetStatsLocked(Clock::time_point now,
+                                    std::chrono::microseconds current_system_time_us,
+                                    double& current_fps) const;
+
     mutable std::mutex object_mutex;
 
     /// Title ID for the game that is running. 0 if there is no game running yet
@@ -82,6 +96,15 @@ private:
     Clock::duration previous_frame_length = Clock::duration::zero();
     /// Previously computed fps
     double previous_fps = 0;
+
+    /// Number of system frames the frame time percentiles are computed over
+    static constexpr std::size_t FrameTimeWindow = 600;
+    /// Ring buffer of the visible durations of the most recent system frames, in milliseconds
+    std::array<double, FrameTimeWindow> recent_frame_times{};
+    /// Next slot to write in recent_frame_times
+    std::size_t recent_frame_index{0};
+    /// Number of valid entries in recent_frame_times
+    std::size_t recent_frame_count{0};
 };
 
 class SpeedLimiter {
@@ -167,6 +167,27 @@ void OSManager::GameFrameEnd()
     m_coreSystem.GetPerfStats().EndGameFrame();
 }
 
+void OSManager::SetHostRefreshRate(uint32_t refreshRate)
+{
+    m_coreSystem.SetHostRefreshRate(refreshRate);
+}
+
+bool OSManager::GetPerformanceStats(PerformanceStats & stats)
+{
+    if (m_process == nullptr)
+    {
+        return false;
+    }
+    const Core::PerfStatsResults results = m_coreSystem.GetPerfStatsSnapshot();
+    stats.systemFps = results.system_fps;
+    stats.gameFps = results.average_game_fps;
+    stats.emulationSpeed = results.emulation_speed;
+    stats.frameTimeP50 = results.frametime_p50;
+    stats.frameTimeP95 = results.frametime_p95;
+    stats.frameTimeP99 = results.frametime_p99;
+    return true;
+}
+
 void OSManager::AudioGetSyncIDs(uint32_t * ids, uint32_t maxCount, uint32_t* actualCount)
 {
     std::vector<Settings::AudioEngine> sinkIds = AudioCore::Sink::GetSinkIDs();
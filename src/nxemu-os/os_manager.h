@@ -22,6 +22,8 @@ public:
     void GatherGPUDirtyMemory(ICacheInvalidator * invalidator) override;
     uint64_t GetGPUTicks() override;
     void GameFrameEnd() override;
+    void SetHostRefreshRate(uint32_t refreshRate) override;
+    bool GetPerformanceStats(PerformanceStats & stats) override;
     void AudioGetSyncIDs(uint32_t* ids, uint32_t maxCount, uint32_t* actualCount) override;
     void AudioGetDeviceListForSink(uint32_t sinkId, bool capture, DeviceEnumCallback callback, void* userData) override;
 
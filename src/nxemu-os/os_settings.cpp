@@ -1,16 +1,18 @@
 #include "os_settings.h"
 #include "os_settings_identifiers.h"
 #include <common/json.h>
+#include <common/json_stream.h>
 #include <nxemu-module-spec/base.h>
 #include <yuzu_common/settings_enums.h>
 #include <yuzu_common/settings.h>
 #include <yuzu_common/yuzu_assert.h>
+#include <string.h>
 
 extern IModuleSettings * g_settings;
 
 namespace
 {
-    enum class SettingType { String, AudioEngine, AudioMode, U8, Boolean };
+    enum class SettingType { String, AudioEngine, AudioMode, PresentationMode, U8, Boolean };
 
     class OsSetting
     {
@@ -18,6 +20,7 @@ namespace
         OsSetting(const char * id, const char * section, const char * key, Settings::SwitchableSetting<std::string> * val);
         OsSetting(const char * id, const char * section, const char * key, Settings::SwitchableSetting<Settings::AudioEngine> * val);
         OsSetting(const char * id, const char * section, const char * key, Settings::SwitchableSetting<Settings::AudioMode, true>* val);
+        OsSetting(const char * id, const char * section, const char * key, Settings::Setting<Settings::PresentationMode, false> * val);
         OsSetting(const char * id, const char * section, const char * key, Settings::SwitchableSetting<u8, true> * val);
         OsSetting(const char * id, const char * section, const char * key, Settings::Setting<bool, false> * val);
 
@@ -30,6 +33,7 @@ namespace
             Settings::SwitchableSetting<std::string> * string;
             Settings::SwitchableSetting<Settings::AudioEngine> * audioEngine;
             Settings::SwitchableSetting<Settings::AudioMode, true> * audioMode;
+            Settings::Setting<Settings::PresentationMode, false> * presentationMode;
             Settings::SwitchableSetting<u8, true> * u8;
             Settings::Setting<bool, false> * boolean;
         } setting;
@@ -42,6 +46,8 @@ namespace
         { NXOsSetting::AudioMode, "audio", "mode", &Settings::values.sound_index },
         { NXOsSetting::AudioVolume, "audio", "volume", &Settings::values.volume },
         { NXOsSetting::AudioMuted, "audio", "muted", &Settings::values.audio_muted },
+        { NXOsSetting::UseServiceExecutor, "core", "use_service_executor", &Settings::values.use_service_executor },
+        { NXOsSetting::PresentationMode, "core", "presentation_mode", &Settings::values.presentation_mode },
     };
 }
 
@@ -64,6 +70,9 @@ void OsSettingChanged(const char * setting, void * /*userData*/)
         case SettingType::AudioMode:
             osSetting.setting.audioMode->SetValue((Settings::AudioMode)g_settings->GetInt(setting));
             break;
+        case SettingType::PresentationMode:
+            osSetting.setting.presentationMode->SetValue((Settings::PresentationMode)g_settings->GetInt(setting));
+            break;
         case SettingType::U8:
             osSetting.setting.u8->SetValue(g_settings->GetInt(setting));
             break;
@@ -91,6 +100,9 @@ void SetupOsSetting(void)
         case SettingType::AudioMode:
             osSetting.setting.audioMode->SetValue(osSetting.setting.audioMode->GetDefault());
             break;
+        case SettingType::PresentationMode:
+            osSetting.setting.presentationMode->SetValue(osSetting.setting.presentationMode->GetDefault());
+            break;
         case SettingType::U8:
             osSetting.setting.u8->SetValue(osSetting.setting.u8->GetDefault());
             break;
@@ -102,20 +114,20 @@ void SetupOsSetting(void)
         }
     }
     
-    JsonValue root;
-    JsonReader reader;
-    std::string json = g_settings->GetSectionSettings("nxemu-os");
+    JsonDocument document;
+    std::string_view json = g_settings->GetSectionSettings("nxemu-os");
 
-    if (!json.empty() && reader.Parse(json.data(), json.data() + json.size(), root))
+    if (!json.empty() && document.Parse(json.data(), json.data() + json.size()))
     {
+        const JsonNode & root = document.Root();
         for (const OsSetting & osSetting : settings)
         {
-            JsonValue section = root[osSetting.json_section];
+            const JsonNode & section = root[osSetting.json_section];
             if (!section.isObject())
             {
                 continue;
             }
-            JsonValue value = section[osSetting.json_key];
+            const JsonNode & value = section[osSetting.json_key];
             switch (osSetting.settingType)
             {
             case SettingType::String:
@@ -136,6 +148,12 @@ void SetupOsSetting(void)
                     osSetting.setting.audioMode->SetValue(Settings::ToEnum<Settings::AudioMode>(value.asString()));
                 }
                 break;
+            case SettingType::PresentationMode:
+                if (value.isString())
+                {
+                    osSetting.setting.presentationMode->SetValue(Settings::ToEnum<Settings::PresentationMode>(value.asString()));
+                }
+                break;
             case SettingType::U8:
                 if (value.isInt())
                 {
@@ -170,6 +188,10 @@ void SetupOsSetting(void)
             g_settings->SetDefaultInt(osSetting.identifier, (int32_t)osSetting.setting.audioMode->GetDefault());
             g_settings->SetInt(osSetting.identifier, (int32_t)osSetting.setting.audioMode->GetValue());
             break;
+        case SettingType::PresentationMode:
+            g_settings->SetDefaultInt(osSetting.identifier, (int32_t)osSetting.setting.presentationMode->GetDefault());
+            g_settings->SetInt(osSetting.identifier, (int32_t)osSetting.setting.presentationMode->GetValue());
+            break;
         case SettingType::U8:
             g_settings->SetDefaultInt(osSetting.identifier, (int32_t)osSetting.setting.u8->GetDefault());
             g_settings->SetInt(osSetting.identifier, (int32_t)osSetting.setting.u8->GetValue());
@@ -212,6 +234,12 @@ void SaveOsSettings(void)
                 sections[osSetting.json_section][osSetting.json_key] = Settings::CanonicalizeEnum(osSetting.setting.audioMode->GetValue());
             }
             break;
+        case SettingType::PresentationMode:
+            if (osSetting.setting.presentationMode->GetValue() != osSetting.setting.presentationMode->GetDefault())
+            {
+                sections[osSetting.json_section][osSetting.json_key] = Settings::CanonicalizeEnum(osSetting.setting.presentationMode->GetValue());
+            }
+            break;
         case SettingType::U8:
             if (osSetting.setting.u8->GetValue() != osSetting.setting.u8->GetDefault())
             {
@@ -229,15 +257,7 @@ void SaveOsSettings(void)
         }
     }
 
-    JsonValue json;
-    for (SectionMap::const_iterator it = sections.begin(); it != sections.end(); ++it)
-    {
-        if (it->second.size() > 0)
-        {
-            json[it->first] = it->second;
-        }
-    }
-    g_settings->SetSectionSettings("nxemu-os", json.isNull() ? "" : JsonStyledWriter().write(json));
+    g_settings->PatchSectionSettings("nxemu-os", JsonSettingsPatch(settings, sections));
 }
 
 namespace
@@ -269,6 +289,15 @@ namespace
         setting.audioMode = val;
     }
 
+    OsSetting::OsSetting(const char * id, const char * section, const char * key, Settings::Setting<Settings::PresentationMode, false> * val) :
+        identifier(id),
+        json_section(section),
+        json_key(key),
+        settingType(SettingType::PresentationMode)
+    {
+        setting.presentationMode = val;
+    }
+
     OsSetting::OsSetting(const char * id, const char * section, const char * key, Settings::SwitchableSetting<u8, true> * val) :
         identifier(id),
         json_section(section),
@@ -8,5 +8,7 @@ namespace NXOsSetting
     constexpr const char * AudioMode = "nxos:AudioMode";
     constexpr const char * AudioVolume = "nxos:AudioVolume";
     constexpr const char * AudioMuted = "nxos:AudioMuted";
+    constexpr const char * UseServiceExecutor = "nxos:UseServiceExecutor";
+    constexpr const char * PresentationMode = "nxos:PresentationMode";
 
 } // namespace NXOsSetting
\ No newline at end of file
@@ -0,0 +1,45 @@
+#include "room_server.h"
+#include <common/path.h>
+#include <iostream>
+#include <string>
+#include <yuzu_common/logging/backend.h>
+
+int main(int argc, char ** argv)
+{
+    Path configFile = argc > 1 ? Path(argv[1]) : Path(Path::MODULE_DIRECTORY, "room-server.json");
+
+    Common::Log::Initialize();
+    Common::Log::Start();
+
+    RoomServer server;
+    if (!server.Start(configFile))
+    {
+        return 1;
+    }
+    server.RunLoadTest();
+
+    std::cout << "Commands: metrics, reload, quit" << std::endl;
+    std::string command;
+    while (std::getline(std::cin, command))
+    {
+        if (command == "quit")
+        {
+            break;
+        }
+        else if (command == "metrics")
+        {
+            server.PrintMetrics();
+        }
+        else if (command == "reload")
+        {
+            server.ReloadBanLists();
+        }
+        else if (!command.empty())
+        {
+            std::cout << "Unknown command: " << command << std::endl;
+        }
+    }
+    server.Stop();
+    Common::Log::Stop();
+    return 0;
+}
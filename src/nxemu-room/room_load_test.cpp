@@ -0,0 +1,140 @@
+#include "room_load_test.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <network/room_member.h>
+#include <string.h>
+#include <thread>
+#include <vector>
+
+namespace
+{
+struct SimulatedMember
+{
+    std::unique_ptr<Network::RoomMember> member;
+    Network::RoomMember::CallbackHandle<Network::LDNPacket> ldnHandle;
+};
+
+uint64_t NowNanoseconds(void)
+{
+    return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+double Percentile(const std::vector<uint64_t> & sorted, uint32_t percent)
+{
+    if (sorted.empty())
+    {
+        return 0.0;
+    }
+    size_t index = std::min(sorted.size() - 1, sorted.size() * percent / 100);
+    return sorted[index] / 1000000.0;
+}
+
+bool AllJoined(const std::vector<SimulatedMember> & members)
+{
+    for (const SimulatedMember & member : members)
+    {
+        Network::RoomMember::State state = member.member->GetState();
+        if (state != Network::RoomMember::State::Joined && state != Network::RoomMember::State::Moderator)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+} // namespace
+
+void RunRoomLoadTest(const RoomLoadTestConfig & config, const std::string & address, uint16_t port, const std::string & password)
+{
+    if (config.members < 2 || config.seconds == 0 || config.packetsPerSecond == 0)
+    {
+        std::cerr << "Load test needs at least 2 members, a duration and a packet rate" << std::endl;
+        return;
+    }
+
+    std::mutex latencyMutex;
+    std::vector<uint64_t> latencies;
+    latencies.reserve((size_t)config.seconds * config.packetsPerSecond);
+
+    // Each packet carries its send time, the receiver records how long the relay took
+    std::vector<SimulatedMember> members(config.members);
+    for (uint32_t i = 0; i < config.members; i++)
+    {
+        SimulatedMember & simulated = members[i];
+        simulated.member = std::make_unique<Network::RoomMember>();
+        simulated.ldnHandle = simulated.member->BindOnLdnPacketReceived([&](const Network::LDNPacket & packet)
+        {
+            uint64_t received = NowNanoseconds();
+            uint64_t sent = 0;
+            if (packet.data.size() < sizeof(sent))
+            {
+                return;
+            }
+            memcpy(&sent, packet.data.data(), sizeof(sent));
+            std::lock_guard<std::mutex> lock(latencyMutex);
+            latencies.push_back(received - sent);
+        });
+        simulated.member->Join("loadtest" + std::to_string(i), address.c_str(), port, 0, Network::NoPreferredIP, password);
+    }
+
+    std::chrono::steady_clock::time_point joinDeadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (!AllJoined(members) && std::chrono::steady_clock::now() < joinDeadline)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+
+    uint64_t sentPackets = 0;
+    double elapsedSeconds = 0.0;
+    if (AllJoined(members))
+    {
+        Network::LDNPacket packet{};
+        packet.type = Network::LDNPacketType::SyncNetwork;
+        packet.broadcast = false;
+        packet.data.resize(std::max<size_t>(config.packetSize, sizeof(uint64_t)));
+
+        // Member i sends to member i + 1, spreading the configured rate over every member
+        const std::chrono::nanoseconds interval(1000000000ull / config.packetsPerSecond);
+        const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        const std::chrono::steady_clock::time_point end = start + std::chrono::seconds(config.seconds);
+        std::chrono::steady_clock::time_point next = start;
+        while (next < end)
+        {
+            const SimulatedMember & sender = members[sentPackets % config.members];
+            const SimulatedMember & receiver = members[(sentPackets + 1) % config.members];
+            packet.local_ip = sender.member->GetFakeIpAddress();
+            packet.remote_ip = receiver.member->GetFakeIpAddress();
+            uint64_t now = NowNanoseconds();
+            memcpy(packet.data.data(), &now, sizeof(now));
+            sender.member->SendLdnPacket(packet);
+            sentPackets++;
+            next += interval;
+            std::this_thread::sleep_until(next);
+        }
+        elapsedSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        // Give packets still in flight time to arrive
+        std::this_thread::sleep_for(std::chrono::seconds(1));
+    }
+    else
+    {
+        std::cerr << "Load test: not every simulated member could join the room" << std::endl;
+    }
+
+    for (SimulatedMember & simulated : members)
+    {
+        simulated.member->Unbind(simulated.ldnHandle);
+        simulated.member->Leave();
+    }
+    if (sentPackets == 0)
+    {
+        return;
+    }
+
+    std::sort(latencies.begin(), latencies.end());
+    std::cout << "Load test: " << config.members << " members, " << sentPackets << " packets sent, " << latencies.size() << " forwarded ("
+              << (uint64_t)(latencies.size() / elapsedSeconds) << " packets/s), latency p50 " << Percentile(latencies, 50) << " ms, p99 "
+              << Percentile(latencies, 99) << " ms" << std::endl;
+}
@@ -0,0 +1,17 @@
+#pragma once
+#include <stdint.h>
+#include <string>
+
+struct RoomLoadTestConfig
+{
+    uint32_t members;
+    uint32_t seconds;
+    uint32_t packetsPerSecond;
+    uint32_t packetSize;
+};
+
+// Joins simulated members to a hosted room and has them send unicast LDN packets to each other
+// through it, then reports the packets forwarded per second and the p50 / p99 latency from send
+// to receive. The latency includes the members' own 5 ms polling, so it is an upper bound on the
+// time spent in the relay.
+void RunRoomLoadTest(const RoomLoadTestConfig & config, const std::string & address, uint16_t port, const std::string & password);
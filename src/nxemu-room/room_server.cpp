@@ -0,0 +1,250 @@
+#include "room_server.h"
+#include <common/file.h>
+#include <common/path.h>
+#include <enet/enet.h>
+#include <iostream>
+#include <network/verify_user.h>
+
+namespace
+{
+std::string GetString(const JsonValue & config, const char * key, const std::string & defaultValue = "")
+{
+    const JsonValue * value = config.Find(key);
+    return value != nullptr && value->isString() ? value->asString() : defaultValue;
+}
+
+int64_t GetInt(const JsonValue & config, const char * key, int64_t defaultValue)
+{
+    const JsonValue * value = config.Find(key);
+    return value != nullptr && value->isInt() ? value->asInt64() : defaultValue;
+}
+
+bool GetBool(const JsonValue & config, const char * key, bool defaultValue)
+{
+    const JsonValue * value = config.Find(key);
+    return value != nullptr && value->isBool() ? value->asBool() : defaultValue;
+}
+
+std::vector<std::string> GetStringList(const JsonValue & config, const char * key)
+{
+    std::vector<std::string> list;
+    const JsonValue * value = config.Find(key);
+    if (value == nullptr || !value->isArray())
+    {
+        return list;
+    }
+    for (uint32_t i = 0, n = value->size(); i < n; i++)
+    {
+        const JsonValue & item = (*value)[i];
+        if (item.isString())
+        {
+            list.push_back(item.asString());
+        }
+    }
+    return list;
+}
+} // namespace
+
+RoomServer::RoomServer() :
+    m_enetInitialized(false),
+    m_loadTest({}),
+    m_runLoadTest(false)
+{
+}
+
+RoomServer::~RoomServer()
+{
+    Stop();
+}
+
+bool RoomServer::Start(const char * configFile)
+{
+    JsonValue config;
+    if (!LoadJson(configFile, config) || !config.isObject())
+    {
+        std::cerr << "Failed to load room server config " << configFile << std::endl;
+        return false;
+    }
+    m_configDir = Path(configFile).GetDriveDirectory();
+    m_bindAddress = GetString(config, "bind_address");
+
+    const JsonValue * rooms = config.Find("rooms");
+    if (rooms == nullptr || !rooms->isArray() || rooms->size() == 0)
+    {
+        std::cerr << "No rooms configured in " << configFile << std::endl;
+        return false;
+    }
+
+    if (enet_initialize() != 0)
+    {
+        std::cerr << "Failed to initialize ENet" << std::endl;
+        return false;
+    }
+    m_enetInitialized = true;
+
+    int64_t threads = GetInt(config, "threads", 2);
+    m_eventLoop = std::make_unique<Network::RoomEventLoop>(threads > 0 ? (size_t)threads : 1);
+    for (uint32_t i = 0, n = rooms->size(); i < n; i++)
+    {
+        if (!CreateRoom((*rooms)[i], i))
+        {
+            Stop();
+            return false;
+        }
+    }
+    std::cout << "Hosting " << m_rooms.size() << " rooms on " << m_eventLoop->NumThreads() << " threads" << std::endl;
+
+    const JsonValue * loadTest = config.Find("load_test");
+    if (loadTest != nullptr && loadTest->isObject())
+    {
+        m_loadTest.members = (uint32_t)GetInt(*loadTest, "members", 8);
+        m_loadTest.seconds = (uint32_t)GetInt(*loadTest, "seconds", 10);
+        m_loadTest.packetsPerSecond = (uint32_t)GetInt(*loadTest, "packets_per_second", 2000);
+        m_loadTest.packetSize = (uint32_t)GetInt(*loadTest, "packet_size", 512);
+        m_runLoadTest = true;
+    }
+    return true;
+}
+
+void RoomServer::Stop(void)
+{
+    for (HostedRoom & hostedRoom : m_rooms)
+    {
+        if (hostedRoom.room->GetState() == Network::Room::State::Open)
+        {
+            hostedRoom.room->Destroy();
+        }
+    }
+    m_rooms.clear();
+    m_eventLoop.reset();
+    if (m_enetInitialized)
+    {
+        enet_deinitialize();
+        m_enetInitialized = false;
+    }
+}
+
+void RoomServer::ReloadBanLists(void)
+{
+    for (HostedRoom & hostedRoom : m_rooms)
+    {
+        if (hostedRoom.banListFile.empty())
+        {
+            continue;
+        }
+        Network::Room::BanList banList;
+        if (!LoadBanList(hostedRoom.banListFile, banList))
+        {
+            std::cerr << hostedRoom.name << ": failed to reload ban list " << hostedRoom.banListFile << ", keeping the current one" << std::endl;
+            continue;
+        }
+        hostedRoom.room->SetBanList(banList);
+        std::cout << hostedRoom.name << ": " << banList.first.size() << " usernames and " << banList.second.size() << " addresses banned" << std::endl;
+    }
+}
+
+void RoomServer::PrintMetrics(void) const
+{
+    for (const HostedRoom & hostedRoom : m_rooms)
+    {
+        const Network::RoomMetrics metrics = hostedRoom.room->GetMetrics();
+        std::cout << hostedRoom.name << ": members " << metrics.members << "/" << hostedRoom.room->GetRoomInformation().member_slots
+                  << ", in " << metrics.bytes_received << " bytes (" << metrics.packets_received << " packets)"
+                  << ", out " << metrics.bytes_sent << " bytes (" << metrics.packets_sent << " packets)"
+                  << ", dropped " << metrics.packets_dropped << std::endl;
+    }
+}
+
+void RoomServer::RunLoadTest(void)
+{
+    if (!m_runLoadTest || m_rooms.empty())
+    {
+        return;
+    }
+    const HostedRoom & hostedRoom = m_rooms.front();
+    std::cout << hostedRoom.name << ": running load test" << std::endl;
+    RunRoomLoadTest(m_loadTest, m_bindAddress.empty() ? "127.0.0.1" : m_bindAddress, hostedRoom.port, hostedRoom.password);
+    PrintMetrics();
+}
+
+bool RoomServer::CreateRoom(const JsonValue & config, uint32_t index)
+{
+    HostedRoom hostedRoom;
+    hostedRoom.name = GetString(config, "name");
+    if (hostedRoom.name.empty())
+    {
+        std::cerr << "Room " << index << " has no name" << std::endl;
+        return false;
+    }
+
+    Network::Room::BanList banList;
+    std::string banListFile = GetString(config, "ban_list");
+    if (!banListFile.empty())
+    {
+        hostedRoom.banListFile = (const std::string &)Path(m_configDir, banListFile.c_str());
+        if (!LoadBanList(hostedRoom.banListFile, banList))
+        {
+            std::cerr << hostedRoom.name << ": failed to load ban list " << hostedRoom.banListFile << std::endl;
+            return false;
+        }
+    }
+
+    Network::GameInfo preferredGame;
+    const JsonValue * game = config.Find("preferred_game");
+    if (game != nullptr && game->isObject())
+    {
+        preferredGame.name = GetString(*game, "name");
+        preferredGame.id = (uint64_t)GetInt(*game, "id", 0);
+    }
+
+    int64_t port = GetInt(config, "port", Network::DefaultRoomPort + index);
+    int64_t maxMembers = GetInt(config, "max_members", Network::MaxConcurrentConnections);
+    if (port <= 0 || port > 0xFFFF || maxMembers <= 0 || maxMembers > Network::MaxConcurrentConnections)
+    {
+        std::cerr << hostedRoom.name << ": invalid port or member limit" << std::endl;
+        return false;
+    }
+
+    hostedRoom.room = std::make_unique<Network::Room>();
+    hostedRoom.room->SetEventLoop(m_eventLoop.get());
+    if (!hostedRoom.room->Create(hostedRoom.name, GetString(config, "description"), m_bindAddress, (u16)port, GetString(config, "password"), (u32)maxMembers,
+                                 GetString(config, "host_username"), preferredGame, std::make_unique<Network::VerifyUser::NullBackend>(), banList, GetBool(config, "enable_mods", false)))
+    {
+        std::cerr << hostedRoom.name << ": failed to create room on port " << port << std::endl;
+        return false;
+    }
+    hostedRoom.password = GetString(config, "password");
+    hostedRoom.port = (uint16_t)port;
+    std::cout << hostedRoom.name << ": listening on port " << port << std::endl;
+    m_rooms.push_back(std::move(hostedRoom));
+    return true;
+}
+
+bool RoomServer::LoadJson(const char * fileName, JsonValue & root)
+{
+    File file;
+    if (!file.Open(fileName, IFile::modeRead))
+    {
+        return false;
+    }
+    uint32_t fileLen = (uint32_t)file.GetLength();
+    std::unique_ptr<char[]> data = std::make_unique<char[]>(fileLen);
+    if (file.Read(data.get(), fileLen) != fileLen)
+    {
+        return false;
+    }
+    JsonReader reader;
+    return reader.Parse(data.get(), data.get() + fileLen, root);
+}
+
+bool RoomServer::LoadBanList(const std::string & fileName, Network::Room::BanList & banList)
+{
+    JsonValue root;
+    if (!LoadJson(fileName.c_str(), root) || !root.isObject())
+    {
+        return false;
+    }
+    banList.first = GetStringList(root, "usernames");
+    banList.second = GetStringList(root, "ips");
+    return true;
+}
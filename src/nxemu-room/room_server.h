@@ -0,0 +1,50 @@
+#pragma once
+#include "room_load_test.h"
+#include <common/json.h>
+#include <memory>
+#include <network/room.h>
+#include <network/room_event_loop.h>
+#include <string>
+#include <vector>
+
+// Hosts every room listed in a config file from one process. The rooms share a small pool of
+// event loop threads rather than each running a thread of its own.
+class RoomServer
+{
+    struct HostedRoom
+    {
+        std::string name;
+        std::string banListFile;
+        std::string password;
+        uint16_t port;
+        std::unique_ptr<Network::Room> room;
+    };
+
+public:
+    RoomServer();
+    ~RoomServer();
+
+    bool Start(const char * configFile);
+    void Stop(void);
+    void ReloadBanLists(void);
+    void PrintMetrics(void) const;
+    void RunLoadTest(void);
+
+private:
+    RoomServer(const RoomServer &) = delete;
+    RoomServer & operator=(const RoomServer &) = delete;
+
+    bool CreateRoom(const JsonValue & config, uint32_t index);
+
+    static bool LoadJson(const char * fileName, JsonValue & root);
+    static bool LoadBanList(const std::string & fileName, Network::Room::BanList & banList);
+
+    std::string m_configDir;
+    std::string m_bindAddress;
+    std::unique_ptr<Network::RoomEventLoop> m_eventLoop;
+    std::vector<HostedRoom> m_rooms;
+    bool m_enetInitialized;
+    // Set from the optional "load_test" object of the config, run against the first room
+    RoomLoadTestConfig m_loadTest;
+    bool m_runLoadTest;
+};
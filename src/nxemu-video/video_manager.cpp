@@ -178,16 +178,23 @@ void VideoManager::MemoryUnmap(uint64_t address, uint64_t size)
 }
 
 
-void VideoManager::ApplyOpOnDeviceMemoryPointer(const uint8_t * pointer, uint32_t * scratchBuffer, size_t scratchBufferSize, DeviceMemoryOperation operation, void * userData)
+DeviceMemoryReverseMap VideoManager::GetDeviceMemoryReverseMap(void)
 {
-    Common::ScratchBuffer<u32> tempBuffer;
-    tempBuffer.resize(scratchBufferSize);
-    std::memcpy(tempBuffer.data(), scratchBuffer, scratchBufferSize * sizeof(uint32_t));
+    const Tegra::MaxwellDeviceMemoryManager & memoryManager = impl->m_host1x->MemoryManager();
+    DeviceMemoryReverseMap reverseMap = {};
+    reverseMap.deviceAddressTable = memoryManager.GetDeviceAddressTable();
+    reverseMap.physicalBase = memoryManager.GetPhysicalBase();
+    reverseMap.pageBits = (uint32_t)Tegra::MaxwellDeviceMemoryManager::DeviceAddressPageBits();
+    reverseMap.multiMapFlag = Tegra::MaxwellDeviceMemoryManager::MultiMappedFlag();
+    return reverseMap;
+}
 
-    impl->m_host1x->MemoryManager().ApplyOpOnPointer(pointer, tempBuffer, [operation, userData](DAddr address) {
+void VideoManager::ApplyOpOnDeviceMemoryPointer(const uint8_t * pointer, DeviceMemoryOperation operation, void * userData)
+{
+    thread_local Common::ScratchBuffer<u32> scratchBuffer;
+    impl->m_host1x->MemoryManager().ApplyOpOnPointer(pointer, scratchBuffer, [operation, userData](DAddr address) {
         operation(address, userData);
     });
-    std::memcpy(scratchBuffer, tempBuffer.data(), tempBuffer.size() * sizeof(uint32_t));
 }
 
 RasterizerDownloadArea VideoManager::OnCPURead(uint64_t addr, uint64_t size)
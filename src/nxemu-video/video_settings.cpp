@@ -1,10 +1,12 @@
 #include "video_settings.h"
 #include "video_settings_identifiers.h"
 #include <common/json.h>
+#include <common/json_stream.h>
 #include <nxemu-module-spec/base.h>
 #include <yuzu_common/settings_enums.h>
 #include <yuzu_common/settings.h>
 #include <yuzu_common/yuzu_assert.h>
+#include <string.h>
 
 extern IModuleSettings * g_settings;
 
@@ -68,6 +70,7 @@ namespace
         { NXVideoSetting::ShaderBackend, "video", "shader_backend", &Settings::values.shader_backend },
         { NXVideoSetting::VulkanDevice, "video", "vulkan_device", &Settings::values.vulkan_device },
         { NXVideoSetting::UseDiskPipelineCache, "video", "use_disk_shader_cache", &Settings::values.use_disk_shader_cache },
+        { NXVideoSetting::UseDiskTextureCache, "video", "use_disk_texture_cache", &Settings::values.use_disk_texture_cache },
         { NXVideoSetting::UseAsynchronousGPUEmulation, "video", "use_asynchronous_gpu_emulation", &Settings::values.use_asynchronous_gpu_emulation },
         { NXVideoSetting::AstcDecodeMode, "video", "astc_decode_mode", &Settings::values.accelerate_astc },
         { NXVideoSetting::NvdecEmulation, "video", "nvdec_emulation", &Settings::values.nvdec_emulation },
@@ -85,6 +88,7 @@ namespace
         { NXVideoSetting::UseVulkanPipelineCache, "video", "use_vulkan_driver_pipeline_cache", &Settings::values.use_vulkan_driver_pipeline_cache },
         { NXVideoSetting::SyncToFramerateOfVideoPlayback, "video", "use_video_framerate", &Settings::values.use_video_framerate },
         { NXVideoSetting::BarrierFeedbackLoops, "video", "barrier_feedback_loops", &Settings::values.barrier_feedback_loops },
+        { NXVideoSetting::VulkanParallelRecording, "video", "vulkan_parallel_recording", &Settings::values.vulkan_parallel_recording },
     };
 }
 
@@ -187,20 +191,20 @@ void SetupVideoSetting(void)
         }
     }
 
-    JsonValue root;
-    JsonReader reader;
-    std::string json = g_settings->GetSectionSettings("nxemu-video");
+    JsonDocument document;
+    std::string_view json = g_settings->GetSectionSettings("nxemu-video");
 
-    if (!json.empty() && reader.Parse(json.data(), json.data() + json.size(), root))
+    if (!json.empty() && document.Parse(json.data(), json.data() + json.size()))
     {
+        const JsonNode & root = document.Root();
         for (const VideoSetting & videoSetting : settings)
         {
-            JsonValue section = root[videoSetting.json_section];
+            const JsonNode & section = root[videoSetting.json_section];
             if (!section.isObject())
             {
                 continue;
             }
-            JsonValue value = section[videoSetting.json_key];
+            const JsonNode & value = section[videoSetting.json_key];
             switch (videoSetting.settingType)
             {
             case SettingType::Boolean:
@@ -426,15 +430,7 @@ void SaveVideoSettings(void)
         }
     }
 
-    JsonValue json;
-    for (SectionMap::const_iterator it = sections.begin(); it != sections.end(); ++it)
-    {
-        if (it->second.size() > 0)
-        {
-            json[it->first] = it->second;
-        }
-    }
-    g_settings->SetSectionSettings("nxemu-video", json.isNull() ? "" : JsonStyledWriter().write(json));
+    g_settings->PatchSectionSettings("nxemu-video", JsonSettingsPatch(settings, sections));
 }
 
 namespace
@@ -6,6 +6,7 @@ namespace NXVideoSetting
     constexpr const char * ShaderBackend = "nxvideo:ShaderBackend";
     constexpr const char * VulkanDevice = "nxvideo:VulkanDevice";
     constexpr const char * UseDiskPipelineCache = "nxvideo:UseDiskPipelineCache";
+    constexpr const char * UseDiskTextureCache = "nxvideo:UseDiskTextureCache";
     constexpr const char * UseAsynchronousGPUEmulation = "nxvideo:UseAsynchronousGPUEmulation";
     constexpr const char * AstcDecodeMode = "nxvideo:AstcDecodeMode";
     constexpr const char * NvdecEmulation = "nxvideo:NvdecEmulation";
@@ -23,5 +24,6 @@ namespace NXVideoSetting
     constexpr const char * UseVulkanPipelineCache = "nxvideo:UseVulkanPipelineCache";
     constexpr const char * SyncToFramerateOfVideoPlayback = "nxvideo:SyncToFramerateOfVideoPlayback";
     constexpr const char * BarrierFeedbackLoops = "nxvideo:BarrierFeedbackLoops";
+    constexpr const char * VulkanParallelRecording = "nxvideo:VulkanParallelRecording";
 
 } // namespace NXVideoSetting
\ No newline at end of file
@@ -113,6 +113,13 @@ bool SciterMainWindow::Show(void)
     {
         IVideo & video = system->Video();
         video.UpdateFramebufferLayout(rect.right - rect.left, rect.bottom - rect.top);
+
+        DEVMODEW displayMode = {};
+        displayMode.dmSize = sizeof(displayMode);
+        if (EnumDisplaySettingsW(nullptr, ENUM_CURRENT_SETTINGS, &displayMode) && displayMode.dmDisplayFrequency > 1)
+        {
+            system->OperatingSystem().SetHostRefreshRate(displayMode.dmDisplayFrequency);
+        }
     }
     UpdateStatusbar();
     m_sciterUI.AttachHandler(rootElement, IID_IMOUSEUPDOWNSINK, (IMouseUpDownSink*)this);
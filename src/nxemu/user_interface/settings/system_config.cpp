@@ -234,6 +234,7 @@ void SystemConfig::InitializeTranslations()
         {(uint32_t)Settings::RendererBackend::OpenGL, "OpenGL"},
         {(uint32_t)Settings::RendererBackend::Vulkan, "Vulkan"},
         {(uint32_t)Settings::RendererBackend::Null, "Null"},
+        {(uint32_t)Settings::RendererBackend::Software, "Software (CPU)"},
     }});
 
     m_settingTranslations.insert({ Settings::EnumMetadata<Settings::ShaderBackend>::Index(), {
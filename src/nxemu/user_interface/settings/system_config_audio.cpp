@@ -85,9 +85,9 @@ SystemConfigAudio::SystemConfigAudio(ISciterUI & sciterUI, HWINDOW parent, Scite
         bool checked = settings.GetBool(NXOsSetting::AudioMuted);
         element.SetState(checked ? SciterElement::STATE_CHECKED : 0, checked ? 0 : SciterElement::STATE_CHECKED, true);
     }
-    const char * audioOutputDeviceId = settings.GetString(NXOsSetting::AudioOutputDeviceId);
-    const char * audioInputDeviceId = settings.GetString(NXOsSetting::AudioInputDeviceId);
-    updateAudioDevices(audioSinkId, audioOutputDeviceId, audioInputDeviceId);
+    std::string audioOutputDeviceId = settings.GetString(NXOsSetting::AudioOutputDeviceId);
+    std::string audioInputDeviceId = settings.GetString(NXOsSetting::AudioInputDeviceId);
+    updateAudioDevices(audioSinkId, audioOutputDeviceId.c_str(), audioInputDeviceId.c_str());
     m_sciterUI.AttachHandler(page.GetElementByID("audioOutputEngine"), IID_ISTATECHANGESINK, (IStateChangeSink*)this);
     m_sciterUI.AttachHandler(page.GetElementByID("audioVolume"), IID_ISTATECHANGESINK, (IStateChangeSink*)this);
 }
@@ -163,9 +163,9 @@ bool SystemConfigAudio::OnStateChange(SCITER_ELEMENT elem, uint32_t /*eventReaso
         }
         int audioSinkId = std::stoi(value);
         SettingsStore & settings = SettingsStore::GetInstance();
-        const char * audioOutputDeviceId = settings.GetDefaultString(NXOsSetting::AudioOutputDeviceId);
-        const char * audioInputDeviceId = settings.GetDefaultString(NXOsSetting::AudioInputDeviceId);
-        updateAudioDevices(audioSinkId, audioOutputDeviceId, audioInputDeviceId);
+        std::string audioOutputDeviceId = settings.GetDefaultString(NXOsSetting::AudioOutputDeviceId);
+        std::string audioInputDeviceId = settings.GetDefaultString(NXOsSetting::AudioInputDeviceId);
+        updateAudioDevices(audioSinkId, audioOutputDeviceId.c_str(), audioInputDeviceId.c_str());
     }
     else if (m_page.GetElementByID("audioVolume") == elem)
     {
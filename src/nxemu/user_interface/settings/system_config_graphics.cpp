@@ -155,6 +155,7 @@ void SystemConfigGraphics::UpdateGraphicsAPI()
         VSyncMode.RemoveAttribute("disabled");
         break;
     case Settings::RendererBackend::Null:
+    case Settings::RendererBackend::Software:
         ShaderBackend.SetStyleAttribute("display", "none");
         VulkanDevices.SetStyleAttribute("display", "none");
         VSyncMode.SetAttribute("disabled", "");
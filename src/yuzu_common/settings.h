@@ -54,6 +54,7 @@ SETTING(AudioEngine, false);
 SETTING(bool, false);
 SETTING(int, false);
 SETTING(s32, false);
+SETTING(PresentationMode, false);
 SETTING(std::string, false);
 SETTING(std::string, false);
 SETTING(u16, false);
@@ -210,6 +211,10 @@ struct Values {
                                              true,
                                              true,
                                              &use_speed_limit};
+    Setting<bool, false> use_service_executor{linkage, false, "use_service_executor",
+                                              Category::Core};
+    Setting<PresentationMode, false> presentation_mode{linkage, PresentationMode::Fixed,
+                                                       "presentation_mode", Category::Core};
 
     // Cpu
     SwitchableSetting<CpuBackend, true> cpu_backend{linkage,
@@ -266,7 +271,7 @@ struct Values {
 
     // Renderer
     SwitchableSetting<RendererBackend, true> renderer_backend{
-        linkage, RendererBackend::OpenGL, RendererBackend::OpenGL, RendererBackend::Null,
+        linkage, RendererBackend::OpenGL, RendererBackend::OpenGL, RendererBackend::Software,
         "backend", Category::Renderer};
     SwitchableSetting<ShaderBackend, true> shader_backend{
         linkage,          ShaderBackend::Glsl, ShaderBackend::Glsl,        ShaderBackend::SpirV,
@@ -276,6 +281,8 @@ struct Values {
 
     SwitchableSetting<bool> use_disk_shader_cache{linkage, true, "use_disk_shader_cache",
                                                   Category::Renderer};
+    SwitchableSetting<bool> use_disk_texture_cache{linkage, true, "use_disk_texture_cache",
+                                                   Category::Renderer};
     SwitchableSetting<bool> use_asynchronous_gpu_emulation{
         linkage, true, "use_asynchronous_gpu_emulation", Category::Renderer};
     SwitchableSetting<AstcDecodeMode, true> accelerate_astc{linkage,
@@ -425,6 +432,8 @@ struct Values {
                                                 Category::RendererAdvanced};
     SwitchableSetting<bool> barrier_feedback_loops{linkage, true, "barrier_feedback_loops",
                                                    Category::RendererAdvanced};
+    SwitchableSetting<bool> vulkan_parallel_recording{linkage, false, "vulkan_parallel_recording",
+                                                      Category::RendererAdvanced};
 
     Setting<bool> renderer_debug{linkage, false, "debug", Category::RendererDebug};
     Setting<bool> renderer_shader_feedback{linkage, false, "shader_feedback",
@@ -122,9 +122,11 @@ ENUM(AstcRecompression, Uncompressed, Bc1, Bc3);
 
 ENUM(VSyncMode, Immediate, Mailbox, Fifo, FifoRelaxed);
 
+ENUM(PresentationMode, Fixed, Unlocked, Paced);
+
 ENUM(VramUsageMode, Conservative, Aggressive);
 
-ENUM(RendererBackend, OpenGL, Vulkan, Null);
+ENUM(RendererBackend, OpenGL, Vulkan, Null, Software);
 
 ENUM(ShaderBackend, Glsl, Glasm, SpirV);
 
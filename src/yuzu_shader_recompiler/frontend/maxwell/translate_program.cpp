@@ -2,6 +2,7 @@
 // SPDX-License-Identifier: GPL-2.0-or-later
 
 #include <algorithm>
+#include <chrono>
 #include <memory>
 #include <vector>
 #include <queue>
@@ -19,6 +20,17 @@
 
 namespace Shader::Maxwell {
 namespace {
+template <typename Pass>
+void RunPass(PassTimings* timings, std::string_view name, Pass&& pass) {
+    if (!timings) {
+        pass();
+        return;
+    }
+    const auto start{std::chrono::steady_clock::now()};
+    pass();
+    timings->Add(name, std::chrono::steady_clock::now() - start);
+}
+
 IR::BlockList GenerateBlocks(const IR::AbstractSyntaxList& syntax_list) {
     size_t num_syntax_blocks{};
     for (const auto& node : syntax_list) {
@@ -237,12 +249,25 @@ void LowerGeometryPassthrough(const IR::Program& program, const HostTranslateInf
 
 } // Anonymous namespace
 
+void PassTimings::Add(std::string_view pass, std::chrono::nanoseconds time) {
+    const auto it{
+        std::ranges::find_if(passes, [pass](const auto& entry) { return entry.first == pass; })};
+    if (it != passes.end()) {
+        it->second += time;
+    } else {
+        passes.emplace_back(pass, time);
+    }
+}
+
 IR::Program TranslateProgram(ObjectPool<IR::Inst>& inst_pool, ObjectPool<IR::Block>& block_pool,
-                             Environment& env, Flow::CFG& cfg, const HostTranslateInfo& host_info) {
+                             Environment& env, Flow::CFG& cfg, const HostTranslateInfo& host_info,
+                             PassTimings* timings) {
     IR::Program program;
-    program.syntax_list = BuildASL(inst_pool, block_pool, env, cfg, host_info);
-    program.blocks = GenerateBlocks(program.syntax_list);
-    program.post_order_blocks = PostOrder(program.syntax_list.front());
+    RunPass(timings, "BuildASL", [&] {
+        program.syntax_list = BuildASL(inst_pool, block_pool, env, cfg, host_info);
+        program.blocks = GenerateBlocks(program.syntax_list);
+        program.post_order_blocks = PostOrder(program.syntax_list.front());
+    });
     program.stage = env.ShaderStage();
     program.local_memory_size = env.LocalMemorySize();
     switch (program.stage) {
@@ -281,36 +306,41 @@ IR::Program TranslateProgram(ObjectPool<IR::Inst>& inst_pool, ObjectPool<IR::Blo
 
     // Replace instructions before the SSA rewrite
     if (!host_info.support_float64) {
-        Optimization::LowerFp64ToFp32(program);
+        RunPass(timings, "LowerFp64ToFp32", [&] { Optimization::LowerFp64ToFp32(program); });
     }
     if (!host_info.support_float16) {
-        Optimization::LowerFp16ToFp32(program);
+        RunPass(timings, "LowerFp16ToFp32", [&] { Optimization::LowerFp16ToFp32(program); });
     }
     if (!host_info.support_int64) {
-        Optimization::LowerInt64ToInt32(program);
+        RunPass(timings, "LowerInt64ToInt32", [&] { Optimization::LowerInt64ToInt32(program); });
     }
     if (!host_info.support_conditional_barrier) {
-        Optimization::ConditionalBarrierPass(program);
+        RunPass(timings, "ConditionalBarrierPass",
+                [&] { Optimization::ConditionalBarrierPass(program); });
     }
-    Optimization::SsaRewritePass(program);
+    RunPass(timings, "SsaRewritePass", [&] { Optimization::SsaRewritePass(program); });
 
-    Optimization::ConstantPropagationPass(env, program);
+    RunPass(timings, "ConstantPropagationPass",
+            [&] { Optimization::ConstantPropagationPass(env, program); });
 
-    Optimization::PositionPass(env, program);
+    RunPass(timings, "PositionPass", [&] { Optimization::PositionPass(env, program); });
 
-    Optimization::GlobalMemoryToStorageBufferPass(program, host_info);
-    Optimization::TexturePass(env, program, host_info);
+    RunPass(timings, "GlobalMemoryToStorageBufferPass",
+            [&] { Optimization::GlobalMemoryToStorageBufferPass(program, host_info); });
+    RunPass(timings, "TexturePass", [&] { Optimization::TexturePass(env, program, host_info); });
 
     if (Settings::values.resolution_info.active) {
-        Optimization::RescalingPass(program);
+        RunPass(timings, "RescalingPass", [&] { Optimization::RescalingPass(program); });
     }
-    Optimization::DeadCodeEliminationPass(program);
+    RunPass(timings, "DeadCodeEliminationPass",
+            [&] { Optimization::DeadCodeEliminationPass(program); });
     if (Settings::values.renderer_debug) {
-        Optimization::VerificationPass(program);
+        RunPass(timings, "VerificationPass", [&] { Optimization::VerificationPass(program); });
     }
-    Optimization::CollectShaderInfoPass(env, program);
-    Optimization::LayerPass(program, host_info);
-    Optimization::VendorWorkaroundPass(program);
+    RunPass(timings, "CollectShaderInfoPass",
+            [&] { Optimization::CollectShaderInfoPass(env, program); });
+    RunPass(timings, "LayerPass", [&] { Optimization::LayerPass(program, host_info); });
+    RunPass(timings, "VendorWorkaroundPass", [&] { Optimization::VendorWorkaroundPass(program); });
 
     CollectInterpolationInfo(env, program);
     AddNVNStorageBuffers(program);
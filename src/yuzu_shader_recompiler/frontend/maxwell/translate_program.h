@@ -3,6 +3,11 @@
 
 #pragma once
 
+#include <chrono>
+#include <string_view>
+#include <utility>
+#include <vector>
+
 #include "yuzu_shader_recompiler/environment.h"
 #include "yuzu_shader_recompiler/frontend/ir/basic_block.h"
 #include "yuzu_shader_recompiler/frontend/ir/program.h"
@@ -16,9 +21,17 @@ struct HostTranslateInfo;
 
 namespace Shader::Maxwell {
 
+/// Time spent in each pass of TranslateProgram, accumulated over the programs it is passed to.
+struct PassTimings {
+    void Add(std::string_view pass, std::chrono::nanoseconds time);
+
+    std::vector<std::pair<std::string_view, std::chrono::nanoseconds>> passes;
+};
+
 [[nodiscard]] IR::Program TranslateProgram(ObjectPool<IR::Inst>& inst_pool,
                                            ObjectPool<IR::Block>& block_pool, Environment& env,
-                                           Flow::CFG& cfg, const HostTranslateInfo& host_info);
+                                           Flow::CFG& cfg, const HostTranslateInfo& host_info,
+                                           PassTimings* timings = nullptr);
 
 [[nodiscard]] IR::Program MergeDualVertexPrograms(IR::Program& vertex_a, IR::Program& vertex_b,
                                                   Environment& env_vertex_b);
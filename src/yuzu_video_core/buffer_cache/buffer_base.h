@@ -12,6 +12,7 @@
 #include "yuzu_common/common_funcs.h"
 #include "yuzu_common/common_types.h"
 #include "yuzu_video_core/buffer_cache/word_manager.h"
+#include "yuzu_video_core/residency_manager.h"
 
 namespace VideoCommon {
 
@@ -111,6 +112,11 @@ public:
         lru_id = lru_id_;
     }
 
+    /// Returns the access history used to rank the buffer for eviction
+    [[nodiscard]] ResidencyInfo& Residency() noexcept {
+        return residency;
+    }
+
     size_t SizeBytes() const {
         return size_bytes;
     }
@@ -121,6 +127,7 @@ private:
     int stream_score = 0;
     size_t lru_id = SIZE_MAX;
     size_t size_bytes = 0;
+    ResidencyInfo residency;
 };
 
 } // namespace VideoCommon
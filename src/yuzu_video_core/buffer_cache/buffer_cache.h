@@ -17,31 +17,14 @@ namespace VideoCommon {
 using Core::DEVICE_PAGESIZE;
 
 template <class P>
-BufferCache<P>::BufferCache(Tegra::MaxwellDeviceMemoryManager& device_memory_, Runtime& runtime_)
-    : runtime{runtime_}, device_memory{device_memory_}, memory_tracker{device_memory} {
+BufferCache<P>::BufferCache(Tegra::MaxwellDeviceMemoryManager& device_memory_, Runtime& runtime_,
+                            ResidencyManager& residency_)
+    : runtime{runtime_}, device_memory{device_memory_}, residency{residency_},
+      memory_tracker{device_memory} {
     // Ensure the first slot is used for the null buffer
     void(slot_buffers.insert(runtime, NullBufferParams{}));
     gpu_modified_ranges.Clear();
     inline_buffer_id = NULL_BUFFER_ID;
-
-    if (!runtime.CanReportMemoryUsage()) {
-        minimum_memory = DEFAULT_EXPECTED_MEMORY;
-        critical_memory = DEFAULT_CRITICAL_MEMORY;
-        return;
-    }
-
-    const s64 device_local_memory = static_cast<s64>(runtime.GetDeviceLocalMemory());
-    const s64 min_spacing_expected = device_local_memory - 1_GiB;
-    const s64 min_spacing_critical = device_local_memory - 512_MiB;
-    const s64 mem_threshold = std::min(device_local_memory, TARGET_THRESHOLD);
-    const s64 min_vacancy_expected = (6 * mem_threshold) / 10;
-    const s64 min_vacancy_critical = (2 * mem_threshold) / 10;
-    minimum_memory = static_cast<u64>(
-        std::max(std::min(device_local_memory - min_vacancy_expected, min_spacing_expected),
-                 DEFAULT_EXPECTED_MEMORY));
-    critical_memory = static_cast<u64>(
-        std::max(std::min(device_local_memory - min_vacancy_critical, min_spacing_critical),
-                 DEFAULT_CRITICAL_MEMORY));
 }
 
 template <class P>
@@ -49,17 +32,22 @@ BufferCache<P>::~BufferCache() = default;
 
 template <class P>
 void BufferCache<P>::RunGarbageCollector() {
-    const bool aggressive_gc = total_used_memory >= critical_memory;
+    const bool aggressive_gc = residency.GetPressure() == ResidencyManager::Pressure::Critical;
     const u64 ticks_to_destroy = aggressive_gc ? 60 : 120;
     int num_iterations = aggressive_gc ? 64 : 32;
     const auto clean_up = [this, &num_iterations](BufferId buffer_id) {
-        if (num_iterations == 0) {
+        if (num_iterations == 0 || !residency.CanEvict()) {
             return true;
         }
         --num_iterations;
         auto& buffer = slot_buffers[buffer_id];
+        if (!residency.ShouldEvict(buffer.Residency())) {
+            return false;
+        }
+        const u64 evicted_bytes = Common::AlignUp(buffer.SizeBytes(), 1024);
         DownloadBufferMemory(buffer);
         DeleteBuffer(buffer_id);
+        residency.RecordEviction(ResidencyManager::Category::Buffer, evicted_bytes);
         return false;
     };
     lru_cache.ForEachItemBelow(frame_tick - ticks_to_destroy, clean_up);
@@ -90,16 +78,21 @@ void BufferCache<P>::TickFrame() {
     const bool skip_preferred = hits * 256 < shots * 251;
     channel_state->uniform_buffer_skip_cache_size = skip_preferred ? DEFAULT_SKIP_CACHE_SIZE : 0;
 
-    // If we can obtain the memory info, use it instead of the estimate.
-    if (runtime.CanReportMemoryUsage()) {
-        total_used_memory = runtime.GetDeviceMemoryUsage();
-    }
-    if (total_used_memory >= minimum_memory) {
+    if (residency.GetPressure() >= ResidencyManager::Pressure::High) {
         RunGarbageCollector();
     }
     ++frame_tick;
     delayed_destruction_ring.Tick();
 
+    if (download_statistics.flushes != 0 || download_statistics.async_bytes != 0) {
+        LOG_DEBUG(HW_GPU,
+                  "Buffer downloads: {} flushes downloaded {} bytes for {} bytes read by the "
+                  "CPU, {} bytes downloaded asynchronously",
+                  download_statistics.flushes, download_statistics.flushed_bytes,
+                  download_statistics.read_bytes, download_statistics.async_bytes);
+    }
+    download_statistics = {};
+
     for (auto& buffer : async_buffers_death_ring) {
         runtime.FreeDeferredStagingBuffer(buffer);
     }
@@ -169,9 +162,15 @@ std::optional<RasterizerDownloadArea> BufferCache<P>::GetFlushArea(DAddr device_
 
 template <class P>
 void BufferCache<P>::DownloadMemory(DAddr device_addr, u64 size) {
+    u64 downloaded_bytes = 0;
     ForEachBufferInRange(device_addr, size, [&](BufferId, Buffer& buffer) {
-        DownloadBufferMemory(buffer, device_addr, size);
+        downloaded_bytes += DownloadBufferMemory(buffer, device_addr, size);
     });
+    if (downloaded_bytes != 0) {
+        ++download_statistics.flushes;
+        download_statistics.read_bytes += size;
+        download_statistics.flushed_bytes += downloaded_bytes;
+    }
 }
 
 template <class P>
@@ -600,6 +599,7 @@ void BufferCache<P>::CommitAsyncFlushesHigh() {
         buffer.MarkUsage(copy.src_offset, copy.size);
         runtime.CopyBuffer(download_staging.buffer, buffer, copies, false);
         normalized_copies.push_back(second_copy);
+        download_statistics.async_bytes += copy.size;
     }
     runtime.PostCopyBarrier();
     pending_downloads.emplace_back(std::move(normalized_copies));
@@ -1418,11 +1418,13 @@ template <bool insert>
 void BufferCache<P>::ChangeRegister(BufferId buffer_id) {
     Buffer& buffer = slot_buffers[buffer_id];
     const auto size = buffer.SizeBytes();
+    const s64 tracked_size = static_cast<s64>(Common::AlignUp(size, 1024));
     if (insert) {
-        total_used_memory += Common::AlignUp(size, 1024);
+        residency.Track(ResidencyManager::Category::Buffer, tracked_size);
         buffer.setLRUID(lru_cache.Insert(buffer_id, frame_tick));
+        buffer.Residency().Touch(frame_tick);
     } else {
-        total_used_memory -= Common::AlignUp(size, 1024);
+        residency.Track(ResidencyManager::Category::Buffer, -tracked_size);
         lru_cache.Free(buffer.getLRUID());
     }
     const DAddr device_addr_begin = buffer.CpuAddr();
@@ -1442,6 +1444,7 @@ template <class P>
 void BufferCache<P>::TouchBuffer(Buffer& buffer, BufferId buffer_id) noexcept {
     if (buffer_id != NULL_BUFFER_ID) {
         lru_cache.Touch(buffer.getLRUID(), frame_tick);
+        buffer.Residency().Touch(frame_tick);
     }
 }
 
@@ -1574,9 +1577,10 @@ void BufferCache<P>::DownloadBufferMemory(Buffer& buffer) {
 }
 
 template <class P>
-void BufferCache<P>::DownloadBufferMemory(Buffer& buffer, DAddr device_addr, u64 size) {
+u64 BufferCache<P>::DownloadBufferMemory(Buffer& buffer, DAddr device_addr, u64 size) {
     boost::container::small_vector<BufferCopy, 1> copies;
     u64 total_size_bytes = 0;
+    u64 downloaded_bytes = 0;
     u64 largest_copy = 0;
     memory_tracker.ForEachDownloadRangeAndClear(
         device_addr, size, [&](u64 device_addr_out, u64 range_size) {
@@ -1593,6 +1597,7 @@ void BufferCache<P>::DownloadBufferMemory(Buffer& buffer, DAddr device_addr, u64
                 constexpr u64 align = 64ULL;
                 constexpr u64 mask = ~(align - 1ULL);
                 total_size_bytes += (new_size + align - 1) & mask;
+                downloaded_bytes += new_size;
                 largest_copy = std::max(largest_copy, new_size);
             };
 
@@ -1601,7 +1606,7 @@ void BufferCache<P>::DownloadBufferMemory(Buffer& buffer, DAddr device_addr, u64
             gpu_modified_ranges.Subtract(device_addr_out, range_size);
         });
     if (total_size_bytes == 0) {
-        return;
+        return 0;
     }
     MICROPROFILE_SCOPE(GPU_DownloadMemory);
 
@@ -1631,6 +1636,7 @@ void BufferCache<P>::DownloadBufferMemory(Buffer& buffer, DAddr device_addr, u64
             device_memory.WriteBlockUnsafe(copy_device_addr, immediate_buffer.data(), copy.size);
         }
     }
+    return downloaded_bytes;
 }
 
 template <class P>
@@ -30,6 +30,7 @@
 #include "yuzu_video_core/engines/kepler_compute.h"
 #include "yuzu_video_core/engines/maxwell_3d.h"
 #include "yuzu_video_core/memory_manager.h"
+#include "yuzu_video_core/residency_manager.h"
 #include "yuzu_video_core/surface.h"
 #include "yuzu_video_core/texture_cache/types.h"
 
@@ -170,9 +171,6 @@ class BufferCache : public VideoCommon::ChannelSetupCaches<BufferCacheChannelInf
     static constexpr bool SEPARATE_IMAGE_BUFFERS_BINDINGS = P::SEPARATE_IMAGE_BUFFER_BINDINGS;
     static constexpr bool USE_MEMORY_MAPS_FOR_UPLOADS = P::USE_MEMORY_MAPS_FOR_UPLOADS;
 
-    static constexpr s64 DEFAULT_EXPECTED_MEMORY = 512_MiB;
-    static constexpr s64 DEFAULT_CRITICAL_MEMORY = 1_GiB;
-    static constexpr s64 TARGET_THRESHOLD = 4_GiB;
 
     // Debug Flags.
 
@@ -193,7 +191,8 @@ class BufferCache : public VideoCommon::ChannelSetupCaches<BufferCacheChannelInf
     };
 
 public:
-    explicit BufferCache(Tegra::MaxwellDeviceMemoryManager& device_memory_, Runtime& runtime_);
+    explicit BufferCache(Tegra::MaxwellDeviceMemoryManager& device_memory_, Runtime& runtime_,
+                         ResidencyManager& residency_);
 
     ~BufferCache();
 
@@ -424,7 +423,8 @@ private:
 
     void DownloadBufferMemory(Buffer& buffer_id);
 
-    void DownloadBufferMemory(Buffer& buffer_id, DAddr device_addr, u64 size);
+    /// Downloads the GPU modified bytes of a buffer range, returns the number of bytes downloaded
+    u64 DownloadBufferMemory(Buffer& buffer_id, DAddr device_addr, u64 size);
 
     void DeleteBuffer(BufferId buffer_id, bool do_not_mark = false);
 
@@ -445,7 +445,16 @@ private:
     void InlineMemoryImplementation(DAddr dest_address, size_t copy_size,
                                     std::span<const u8> inlined_buffer);
 
+    /// GPU to CPU traffic since the last frame
+    struct DownloadStatistics {
+        u64 flushes;       ///< Flushes that had to download memory
+        u64 read_bytes;    ///< Bytes requested by those flushes
+        u64 flushed_bytes; ///< Bytes downloaded by those flushes
+        u64 async_bytes;   ///< Bytes downloaded by asynchronous flushes
+    };
+
     Tegra::MaxwellDeviceMemoryManager& device_memory;
+    ResidencyManager& residency;
 
     Common::SlotVector<Buffer> slot_buffers;
     DelayedDestructionRing<Buffer, 8> delayed_destruction_ring;
@@ -458,6 +467,7 @@ private:
     Common::RangeSet<DAddr> uncommitted_gpu_modified_ranges;
     Common::RangeSet<DAddr> gpu_modified_ranges;
     std::deque<Common::RangeSet<DAddr>> committed_gpu_modified_ranges;
+    DownloadStatistics download_statistics{};
 
     // Async Buffers
     Common::OverlapRangeSet<DAddr> async_downloads;
@@ -476,9 +486,6 @@ private:
     };
     Common::LeastRecentlyUsedCache<LRUItemParams> lru_cache;
     u64 frame_tick = 0;
-    u64 total_used_memory = 0;
-    u64 minimum_memory = 0;
-    u64 critical_memory = 0;
     BufferId inline_buffer_id;
 
     std::array<BufferId, ((1ULL << 34) >> CACHING_PAGEBITS)> page_table;
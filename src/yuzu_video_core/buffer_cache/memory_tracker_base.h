@@ -92,7 +92,7 @@ public:
                            });
     }
 
-    /// Mark region as modified from the host GPU
+    /// Mark region as modified from the host GPU, precise to BYTES_PER_GRANULE bytes
     void MarkRegionAsGpuModified(VAddr dirty_cpu_addr, u64 query_size) noexcept {
         IteratePages<true>(dirty_cpu_addr, query_size,
                            [](Manager* manager, u64 offset, size_t size) {
@@ -163,7 +163,8 @@ public:
                            });
     }
 
-    /// Call 'func' for each GPU modified range and unmark those pages as GPU modified
+    /// Call 'func' for each GPU modified range and unmark those bytes as GPU modified.
+    /// GPU modifications are tracked in granules of BYTES_PER_GRANULE bytes.
     template <typename Func>
     void ForEachDownloadRange(VAddr query_cpu_range, u64 query_size, bool clear, Func&& func) {
         IteratePages<false>(query_cpu_range, query_size,
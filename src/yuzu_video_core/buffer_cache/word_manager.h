@@ -20,6 +20,9 @@ namespace VideoCommon {
 constexpr u64 PAGES_PER_WORD = 64;
 constexpr u64 BYTES_PER_PAGE = Core::DEVICE_PAGESIZE;
 constexpr u64 BYTES_PER_WORD = PAGES_PER_WORD * BYTES_PER_PAGE;
+constexpr u64 BYTES_PER_GRANULE = 64;
+constexpr u64 GRANULES_PER_PAGE = BYTES_PER_PAGE / BYTES_PER_GRANULE;
+static_assert(GRANULES_PER_PAGE == 64, "The GPU modified granules of a page must fit in a word");
 
 enum class Type {
     CPU,
@@ -57,19 +60,22 @@ struct Words {
             cached_cpu.stack.fill(0);
             untracked.stack.fill(~u64{0});
             preflushable.stack.fill(0);
+            gpu_granules.stack.fill(0);
         } else {
             // Share allocation between CPU and GPU pages and set their default values
-            u64* const alloc = new u64[num_words * 5];
+            u64* const alloc = new u64[num_words * (5 + PAGES_PER_WORD)];
             cpu.heap = alloc;
             gpu.heap = alloc + num_words;
             cached_cpu.heap = alloc + num_words * 2;
             untracked.heap = alloc + num_words * 3;
             preflushable.heap = alloc + num_words * 4;
+            gpu_granules.heap = alloc + num_words * 5;
             std::fill_n(cpu.heap, num_words, ~u64{0});
             std::fill_n(gpu.heap, num_words, 0);
             std::fill_n(cached_cpu.heap, num_words, 0);
             std::fill_n(untracked.heap, num_words, ~u64{0});
             std::fill_n(preflushable.heap, num_words, 0);
+            std::fill_n(gpu_granules.heap, num_words * PAGES_PER_WORD, 0);
         }
         // Clean up tailing bits
         const u64 last_word_size = size_bytes % BYTES_PER_WORD;
@@ -93,13 +99,15 @@ struct Words {
         cached_cpu = rhs.cached_cpu;
         untracked = rhs.untracked;
         preflushable = rhs.preflushable;
+        gpu_granules = rhs.gpu_granules;
         rhs.cpu.heap = nullptr;
         return *this;
     }
 
     Words(Words&& rhs) noexcept
         : size_bytes{rhs.size_bytes}, num_words{rhs.num_words}, cpu{rhs.cpu}, gpu{rhs.gpu},
-          cached_cpu{rhs.cached_cpu}, untracked{rhs.untracked}, preflushable{rhs.preflushable} {
+          cached_cpu{rhs.cached_cpu}, untracked{rhs.untracked}, preflushable{rhs.preflushable},
+          gpu_granules{rhs.gpu_granules} {
         rhs.cpu.heap = nullptr;
     }
 
@@ -154,6 +162,16 @@ struct Words {
         }
     }
 
+    /// Returns the GPU modified granules, one word per page
+    std::span<u64> GpuGranules() noexcept {
+        return std::span<u64>(gpu_granules.Pointer(IsShort()), num_words * PAGES_PER_WORD);
+    }
+
+    /// Returns the GPU modified granules, one word per page
+    std::span<const u64> GpuGranules() const noexcept {
+        return std::span<const u64>(gpu_granules.Pointer(IsShort()), num_words * PAGES_PER_WORD);
+    }
+
     u64 size_bytes = 0;
     size_t num_words = 0;
     WordsArray<stack_words> cpu;
@@ -161,6 +179,7 @@ struct Words {
     WordsArray<stack_words> cached_cpu;
     WordsArray<stack_words> untracked;
     WordsArray<stack_words> preflushable;
+    WordsArray<stack_words * PAGES_PER_WORD> gpu_granules; ///< GPU modified bytes within a page
 };
 
 template <class DeviceTracker, size_t stack_words = 1>
@@ -194,6 +213,15 @@ public:
         return std::make_pair(word_number, amount_pages / BYTES_PER_PAGE);
     }
 
+    /// Returns the mask of the granules of a page overlapping [begin, end), rounded outwards
+    static u64 GranuleMask(size_t page, size_t begin, size_t end) {
+        const size_t page_begin = page * BYTES_PER_PAGE;
+        const size_t local_begin = std::max(begin, page_begin) - page_begin;
+        const size_t local_end = std::min(end, page_begin + BYTES_PER_PAGE) - page_begin;
+        return ExtractBits(~u64{0}, local_begin / BYTES_PER_GRANULE,
+                           Common::DivCeil(local_end, BYTES_PER_GRANULE));
+    }
+
     template <typename Func>
     void IterateWords(size_t offset, size_t size, Func&& func) const {
         using FuncReturn = std::invoke_result_t<Func, std::size_t, u64>;
@@ -254,6 +282,9 @@ public:
         [[maybe_unused]] std::span<u64> untracked_words = words.template Span<Type::Untracked>();
         [[maybe_unused]] std::span<u64> cached_words = words.template Span<Type::CachedCPU>();
         IterateWords(dirty_addr - cpu_addr, size, [&](size_t index, u64 mask) {
+            if constexpr (type == Type::GPU) {
+                mask = ChangeGranules<enable>(index, mask, dirty_addr - cpu_addr, size);
+            }
             if constexpr (type == Type::CPU || type == Type::CachedCPU) {
                 NotifyRasterizer<!enable>(index, untracked_words[index], mask);
             }
@@ -289,6 +320,10 @@ public:
     template <Type type, bool clear, typename Func>
     void ForEachModifiedRange(VAddr query_cpu_range, s64 size, Func&& func) {
         static_assert(type != Type::Untracked);
+        if constexpr (type == Type::GPU) {
+            ForEachGpuModifiedRange<clear>(query_cpu_range, size, func);
+            return;
+        }
 
         std::span<u64> state_words = words.template Span<type>();
         [[maybe_unused]] std::span<u64> untracked_words = words.template Span<Type::Untracked>();
@@ -302,9 +337,6 @@ public:
                  (pending_pointer - pending_offset) * BYTES_PER_PAGE);
         };
         IterateWords(offset, size, [&](size_t index, u64 mask) {
-            if constexpr (type == Type::GPU) {
-                mask &= ~untracked_words[index];
-            }
             const u64 word = state_words[index] & mask;
             if constexpr (clear) {
                 if constexpr (type == Type::CPU || type == Type::CachedCPU) {
@@ -432,6 +464,95 @@ public:
     }
 
 private:
+    /**
+     * Mark or unmark the GPU modified granules of the pages of a word overlapping a range
+     *
+     * @param word_index Index of the word holding the pages
+     * @param mask       Pages of the word overlapping the range
+     * @param offset     Offset in bytes from the start of the buffer
+     * @param size       Size in bytes of the range
+     *
+     * @returns Mask of the pages that have to change their GPU modified state
+     */
+    template <bool enable>
+    u64 ChangeGranules(size_t word_index, u64 mask, u64 offset, u64 size) noexcept {
+        const std::span<u64> granules = words.GpuGranules();
+        u64 changed = 0;
+        IteratePages(mask, [&](size_t pages_offset, size_t pages_size) {
+            for (size_t bit = pages_offset; bit < pages_offset + pages_size; ++bit) {
+                const size_t page = word_index * PAGES_PER_WORD + bit;
+                const u64 granule_mask = GranuleMask(page, offset, offset + size);
+                if constexpr (enable) {
+                    granules[page] |= granule_mask;
+                } else {
+                    granules[page] &= ~granule_mask;
+                    if (granules[page] != 0) {
+                        // Other bytes of the page are still modified
+                        continue;
+                    }
+                }
+                changed |= u64{1} << bit;
+            }
+        });
+        return changed;
+    }
+
+    /**
+     * ForEachModifiedRange for GPU modifications, reporting the modified granules instead of
+     * whole pages. Contiguous granules are merged across pages.
+     */
+    template <bool clear, typename Func>
+    void ForEachGpuModifiedRange(VAddr query_cpu_range, s64 size, Func&& func) {
+        const std::span<u64> state_words = words.template Span<Type::GPU>();
+        const std::span<const u64> untracked_words = words.template Span<Type::Untracked>();
+        const std::span<u64> granules = words.GpuGranules();
+        const size_t offset = query_cpu_range - cpu_addr;
+        const size_t end = offset + static_cast<size_t>(size);
+        bool pending = false;
+        size_t pending_offset{};
+        size_t pending_pointer{};
+        const auto release = [&]() {
+            func(cpu_addr + pending_offset * BYTES_PER_GRANULE,
+                 (pending_pointer - pending_offset) * BYTES_PER_GRANULE);
+        };
+        IterateWords(offset, size, [&](size_t index, u64 mask) {
+            const u64 word = state_words[index] & mask & ~untracked_words[index];
+            IteratePages(word, [&](size_t pages_offset, size_t pages_size) {
+                for (size_t bit = pages_offset; bit < pages_offset + pages_size; ++bit) {
+                    const size_t page = index * PAGES_PER_WORD + bit;
+                    const u64 granule_word = granules[page] & GranuleMask(page, offset, end);
+                    if constexpr (clear) {
+                        granules[page] &= ~granule_word;
+                        if (granules[page] == 0) {
+                            state_words[index] &= ~(u64{1} << bit);
+                        }
+                    }
+                    const size_t base_offset = page * GRANULES_PER_PAGE;
+                    IteratePages(granule_word, [&](size_t granules_offset, size_t granules_size) {
+                        const auto reset = [&]() {
+                            pending_offset = base_offset + granules_offset;
+                            pending_pointer = base_offset + granules_offset + granules_size;
+                        };
+                        if (!pending) {
+                            reset();
+                            pending = true;
+                            return;
+                        }
+                        if (pending_pointer == base_offset + granules_offset) {
+                            pending_pointer += granules_size;
+                            return;
+                        }
+                        release();
+                        reset();
+                    });
+                }
+            });
+        });
+        if (pending) {
+            release();
+        }
+    }
+
     template <Type type>
     u64* Array() noexcept {
         if constexpr (type == Type::CPU) {
@@ -55,6 +55,12 @@ public:
         TrackContinuityImpl(address, virtual_address, size, asid);
     }
 
+    /// Returns a counter incremented after device pages are mapped or unmapped, host pointers
+    /// resolved from device addresses stay valid while it doesn't change.
+    [[nodiscard]] u64 MapGeneration() const noexcept {
+        return map_generation.load(std::memory_order_acquire);
+    }
+
     // Write / Read
     template <typename T>
     T* GetPointer(DAddr address);
@@ -83,6 +89,24 @@ public:
         ApplyOpOnPAddr(address, buffer, operation);
     }
 
+    /// Physical page to device page table. Shared read-only with the OS module, which translates
+    /// singly mapped pages itself and only calls ApplyOpOnPointer for multi-mapped ones.
+    const u32* GetDeviceAddressTable() const {
+        return compressed_device_addr.data();
+    }
+
+    uintptr_t GetPhysicalBase() const {
+        return physical_base;
+    }
+
+    static constexpr size_t DeviceAddressPageBits() {
+        return page_bits;
+    }
+
+    static constexpr u32 MultiMappedFlag() {
+        return MULTI_FLAG;
+    }
+
     PAddr GetPhysicalRawAddressFromDAddr(DAddr address) const {
         PAddr subbits = static_cast<PAddr>(address & page_mask);
         auto paddr = compressed_physical_ptr[(address >> page_bits)];
@@ -208,6 +232,7 @@ private:
     std::unique_ptr<CachedPages> cached_pages;
     Common::RangeMutex counter_guard;
     std::mutex mapping_guard;
+    std::atomic<u64> map_generation{};
 };
 
 } // namespace Core
@@ -1,7 +1,10 @@
 // SPDX-FileCopyrightText: Copyright 2018 yuzu Emulator Project
 // SPDX-License-Identifier: GPL-2.0-or-later
 
+#include <algorithm>
+
 #include "yuzu_common/cityhash.h"
+#include "yuzu_common/literals.h"
 #include "yuzu_common/microprofile.h"
 #include "yuzu_common/settings.h"
 #include "core/core.h"
@@ -13,9 +16,16 @@
 
 namespace Tegra {
 
+using namespace Common::Literals;
+
 constexpr u32 MacroRegistersStart = 0xE00;
 constexpr u32 ComputeInline = 0x6D;
 
+// Following segments resolved along with the current one, games usually lay out the segments of
+// a submission one after another in the same pushbuffer
+constexpr std::size_t PrefetchSegments = 16;
+constexpr u64 PrefetchWindowSize = 1_MiB;
+
 DmaPusher::DmaPusher(GPU& gpu_, MemoryManager& memory_manager_, Control::ChannelState& channel_state_)
     : gpu{gpu_}, memory_manager{memory_manager_}, puller{gpu_, memory_manager_, *this, channel_state_} {}
 
@@ -61,6 +71,10 @@ bool DmaPusher::Step() {
         ProcessCommands(command_list.prefetch_command_list);
         dma_pushbuffer.pop();
     } else {
+        // Resolve the segment before the command list can be popped
+        const std::span<const CommandHeader> prefetched{
+            prefetch_enabled ? Prefetch(command_list, dma_pushbuffer_subindex)
+                             : std::span<const CommandHeader>{}};
         const CommandListHeader command_list_header{
             command_list.command_lists[dma_pushbuffer_subindex++]};
         dma_state.dma_get = command_list_header.addr;
@@ -83,6 +97,11 @@ bool DmaPusher::Step() {
             }
         }
         const auto safe_process = [&] {
+            if (!prefetched.empty()) {
+                memory_manager.FlushRegion(dma_state.dma_get, prefetched.size_bytes());
+                ProcessCommands(prefetched);
+                return;
+            }
             Tegra::Memory::GpuGuestMemory<Tegra::CommandHeader,
                                           Tegra::Memory::GuestMemoryFlags::SafeRead>
                 headers(memory_manager, dma_state.dma_get, command_list_header.size,
@@ -90,6 +109,10 @@ bool DmaPusher::Step() {
             ProcessCommands(headers);
         };
         const auto unsafe_process = [&] {
+            if (!prefetched.empty()) {
+                ProcessCommands(prefetched);
+                return;
+            }
             Tegra::Memory::GpuGuestMemory<Tegra::CommandHeader,
                                           Tegra::Memory::GuestMemoryFlags::UnsafeRead>
                 headers(memory_manager, dma_state.dma_get, command_list_header.size,
@@ -114,6 +137,54 @@ bool DmaPusher::Step() {
     return true;
 }
 
+std::span<const CommandHeader> DmaPusher::Prefetch(const CommandList& command_list,
+                                                   std::size_t subindex) {
+    const CommandListHeader& header{command_list.command_lists[subindex]};
+    const GPUVAddr begin{header.addr};
+    const GPUVAddr end{begin + header.size * sizeof(u32)};
+    if (begin == end) {
+        return {};
+    }
+    const u64 map_generation{memory_manager.MapGeneration()};
+    if (!prefetch.host_ptr || prefetch.map_generation != map_generation ||
+        begin < prefetch.begin || end > prefetch.end) {
+        // Extend the window over the following segments so they are read without a lookup
+        GPUVAddr window_end{end};
+        const std::size_t last{
+            std::min(subindex + PrefetchSegments, command_list.command_lists.size())};
+        for (std::size_t index = subindex + 1; index < last; ++index) {
+            const CommandListHeader& next{command_list.command_lists[index]};
+            const GPUVAddr next_end{next.addr + next.size * sizeof(u32)};
+            if (next.addr < begin || next_end - begin > PrefetchWindowSize) {
+                break;
+            }
+            window_end = std::max(window_end, next_end);
+        }
+        std::size_t window_size{memory_manager.MaxContinuousRange(begin, window_end - begin)};
+        const u8* host_ptr{nullptr};
+        if (window_size >= end - begin) {
+            host_ptr = memory_manager.GetSpan(begin, window_size);
+            if (!host_ptr) {
+                // The pages are contiguous on the GPU but not on the host, try the segment alone
+                window_size = end - begin;
+                host_ptr = memory_manager.GetSpan(begin, window_size);
+            }
+        }
+        if (!host_ptr) {
+            prefetch = {};
+            return {};
+        }
+        prefetch = PrefetchWindow{
+            .begin = begin,
+            .end = begin + window_size,
+            .host_ptr = host_ptr,
+            .map_generation = map_generation,
+        };
+    }
+    return {reinterpret_cast<const CommandHeader*>(prefetch.host_ptr + (begin - prefetch.begin)),
+            header.size};
+}
+
 void DmaPusher::ProcessCommands(std::span<const CommandHeader> commands) {
     for (std::size_t index = 0; index < commands.size();) {
         const CommandHeader& command_header = commands[index];
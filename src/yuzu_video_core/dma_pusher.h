@@ -129,6 +129,13 @@ public:
 
     void DispatchCalls();
 
+    /// Reads segments in place from host memory when they are contiguous, on by default. The DMA
+    /// benchmark turns it off to compare against reading every segment through a copy.
+    void SetPrefetchEnabled(bool enabled) {
+        prefetch_enabled = enabled;
+        prefetch = {};
+    }
+
     void BindSubchannel(Engines::EngineInterface* engine, u32 subchannel_id,
                         Engines::EngineTypes engine_type) {
         subchannels[subchannel_id] = engine;
@@ -141,6 +148,12 @@ private:
     static constexpr u32 non_puller_methods = 0x40;
     static constexpr u32 max_subchannels = 8;
     bool Step();
+
+    /// Returns the commands of a segment read in place from host memory, resolving the host
+    /// pointer of the following segments along with it. Empty when the segment isn't contiguous.
+    std::span<const CommandHeader> Prefetch(const CommandList& command_list,
+                                            std::size_t subindex);
+
     void ProcessCommands(std::span<const CommandHeader> commands);
 
     void SetState(const CommandHeader& command_header);
@@ -165,9 +178,21 @@ private:
         bool is_last_call;
     };
 
+    /// Host memory backing the segments being processed, valid until the GPU address space is
+    /// remapped.
+    struct PrefetchWindow {
+        GPUVAddr begin;
+        GPUVAddr end;
+        const u8* host_ptr;
+        u64 map_generation;
+    };
+
     DmaState dma_state{};
     bool dma_increment_once{};
 
+    PrefetchWindow prefetch{};
+    bool prefetch_enabled{true};
+
     const bool ib_enable{true}; ///< IB mode enabled
 
     std::array<Engines::EngineInterface*, max_subchannels> subchannels{};
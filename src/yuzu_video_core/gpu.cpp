@@ -358,9 +358,22 @@ struct GPU::Impl :
         return out;
     }
 
-    void OnCacheInvalidation(uint64_t address, uint32_t size)
+    void OnCacheInvalidation(const CacheInvalidationRange * ranges, uint32_t count)
     {
-        rasterizer->OnCacheInvalidation(address, size);
+        invalidation_sequences.clear();
+        invalidation_sequences.reserve(count);
+        for (uint32_t i = 0; i < count; i++)
+        {
+            if (ranges[i].address == 0 || ranges[i].size == 0)
+            {
+                continue;
+            }
+            invalidation_sequences.emplace_back(ranges[i].address, static_cast<std::size_t>(ranges[i].size));
+        }
+        if (!invalidation_sequences.empty())
+        {
+            rasterizer->OnCacheInvalidation(invalidation_sequences);
+        }
     }
 
     ISwitchSystem& m_system;
@@ -368,6 +381,7 @@ struct GPU::Impl :
     Host1x::Host1x & host1x;
 
     std::map<u32, std::unique_ptr<Tegra::CDmaPusher>> cdma_pushers;
+    std::vector<std::pair<DAddr, std::size_t>> invalidation_sequences;
     std::unique_ptr<VideoCore::RendererBase> renderer;
     VideoCore::RasterizerInterface* rasterizer = nullptr;
     const bool use_nvdec;
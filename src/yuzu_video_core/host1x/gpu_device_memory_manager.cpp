@@ -249,6 +249,7 @@ namespace Core {
         if (track) {
             TrackContinuityImpl(address, virtual_address, size, asid);
         }
+        map_generation.fetch_add(1, std::memory_order_release);
     }
 
     template <typename Traits>
@@ -277,6 +278,7 @@ namespace Core {
                     compressed_device_addr[phys_addr - 1] = new_start | MULTI_FLAG;
                 }
         }
+        map_generation.fetch_add(1, std::memory_order_release);
     }
     template <typename Traits>
     void DeviceMemoryManager<Traits>::TrackContinuityImpl(DAddr address, VAddr virtual_address,
@@ -181,17 +181,19 @@ void MemoryManager::BindRasterizer(VideoCore::RasterizerInterface* rasterizer_)
 
 GPUVAddr MemoryManager::Map(GPUVAddr gpu_addr, DAddr dev_addr, std::size_t size, PTEKind kind,
                             bool is_big_pages) {
-    if (is_big_pages) [[likely]] {
-        return BigPageTableOp<EntryType::Mapped>(gpu_addr, dev_addr, size, kind);
-    }
-    return PageTableOp<EntryType::Mapped>(gpu_addr, dev_addr, size, kind);
+    const GPUVAddr result{
+        is_big_pages ? BigPageTableOp<EntryType::Mapped>(gpu_addr, dev_addr, size, kind)
+                     : PageTableOp<EntryType::Mapped>(gpu_addr, dev_addr, size, kind)};
+    map_generation.fetch_add(1, std::memory_order_release);
+    return result;
 }
 
 GPUVAddr MemoryManager::MapSparse(GPUVAddr gpu_addr, std::size_t size, bool is_big_pages) {
-    if (is_big_pages) [[likely]] {
-        return BigPageTableOp<EntryType::Reserved>(gpu_addr, 0, size, PTEKind::INVALID);
-    }
-    return PageTableOp<EntryType::Reserved>(gpu_addr, 0, size, PTEKind::INVALID);
+    const GPUVAddr result{
+        is_big_pages ? BigPageTableOp<EntryType::Reserved>(gpu_addr, 0, size, PTEKind::INVALID)
+                     : PageTableOp<EntryType::Reserved>(gpu_addr, 0, size, PTEKind::INVALID)};
+    map_generation.fetch_add(1, std::memory_order_release);
+    return result;
 }
 
 void MemoryManager::Unmap(GPUVAddr gpu_addr, std::size_t size) {
@@ -207,6 +209,7 @@ void MemoryManager::Unmap(GPUVAddr gpu_addr, std::size_t size) {
 
     BigPageTableOp<EntryType::Free>(gpu_addr, 0, size, PTEKind::INVALID);
     PageTableOp<EntryType::Free>(gpu_addr, 0, size, PTEKind::INVALID);
+    map_generation.fetch_add(1, std::memory_order_release);
 }
 
 std::optional<DAddr> MemoryManager::GpuToCpuAddress(GPUVAddr gpu_addr) const {
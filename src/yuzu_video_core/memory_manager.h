@@ -160,6 +160,13 @@ public:
     const u8* GetSpan(const GPUVAddr src_addr, const std::size_t size) const;
     u8* GetSpan(const GPUVAddr src_addr, const std::size_t size);
 
+    /// Returns a counter that grows every time pages of this address space or the device pages
+    /// behind them are mapped or unmapped, host pointers resolved from this address space stay
+    /// valid while it doesn't change. Both counters are bumped after the page tables are written.
+    [[nodiscard]] u64 MapGeneration() const noexcept {
+        return map_generation.load(std::memory_order_acquire) + memory.MapGeneration();
+    }
+
 private:
     template <bool is_big_pages, typename FuncMapped, typename FuncReserved, typename FuncUnmapped>
     inline void MemoryOperation(GPUVAddr gpu_src_addr, std::size_t size, FuncMapped&& func_mapped,
@@ -243,6 +250,8 @@ private:
 
     mutable std::mutex guard;
 
+    std::atomic<u64> map_generation{};
+
     static constexpr size_t continuous_bits = 64;
 
     const size_t unique_identifier;
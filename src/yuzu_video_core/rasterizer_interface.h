@@ -107,6 +107,13 @@ public:
     /// Notify rasterizer that any caches of the specified region are desync with guest
     virtual void OnCacheInvalidation(PAddr addr, u64 size) = 0;
 
+    /// Same as OnCacheInvalidation for a batch of regions, taking each cache lock once
+    virtual void OnCacheInvalidation(std::span<const std::pair<DAddr, std::size_t>> sequences) {
+        for (const auto& [addr, size] : sequences) {
+            OnCacheInvalidation(addr, size);
+        }
+    }
+
     virtual bool OnCPUWrite(PAddr addr, u64 size) = 0;
 
     /// Sync memory between guest and host.
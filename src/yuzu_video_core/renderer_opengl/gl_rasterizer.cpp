@@ -76,9 +76,11 @@ RasterizerOpenGL::RasterizerOpenGL(Core::Frontend::EmuWindow& emu_window_, Tegra
     : gpu(gpu_), device_memory(device_memory_), device(device_), program_manager(program_manager_),
       state_tracker(state_tracker_),
       texture_cache_runtime(device, program_manager, state_tracker, staging_buffer_pool),
-      texture_cache(texture_cache_runtime, device_memory_),
+      residency(texture_cache_runtime.GetDeviceLocalMemory(),
+                TextureCacheParams::HAS_DEVICE_MEMORY_INFO, false),
+      texture_cache(texture_cache_runtime, device_memory_, residency),
       buffer_cache_runtime(device, staging_buffer_pool),
-      buffer_cache(device_memory_, buffer_cache_runtime),
+      buffer_cache(device_memory_, buffer_cache_runtime, residency),
       shader_cache(device_memory_, emu_window_, device, texture_cache, buffer_cache,
                    program_manager, state_tracker, gpu.ShaderNotify()),
       query_cache(*this, device_memory_), accelerate_dma(buffer_cache, texture_cache),
@@ -563,6 +565,26 @@ void RasterizerOpenGL::InvalidateRegion(DAddr addr, u64 size, VideoCommon::Cache
     }
 }
 
+void RasterizerOpenGL::InnerInvalidation(std::span<const std::pair<DAddr, std::size_t>> sequences) {
+    MICROPROFILE_SCOPE(OpenGL_CacheManagement);
+    {
+        std::scoped_lock lock{texture_cache.mutex};
+        for (const auto& [addr, size] : sequences) {
+            texture_cache.WriteMemory(addr, size);
+        }
+    }
+    {
+        std::scoped_lock lock{buffer_cache.mutex};
+        for (const auto& [addr, size] : sequences) {
+            buffer_cache.WriteMemory(addr, size);
+        }
+    }
+    for (const auto& [addr, size] : sequences) {
+        shader_cache.InvalidateRegion(addr, size);
+        query_cache.InvalidateRegion(addr, size);
+    }
+}
+
 bool RasterizerOpenGL::OnCPUWrite(DAddr addr, u64 size) {
     MICROPROFILE_SCOPE(OpenGL_CacheManagement);
     if (addr == 0 || size == 0) {
@@ -602,6 +624,26 @@ void RasterizerOpenGL::OnCacheInvalidation(DAddr addr, u64 size) {
     shader_cache.InvalidateRegion(addr, size);
 }
 
+void RasterizerOpenGL::OnCacheInvalidation(
+    std::span<const std::pair<DAddr, std::size_t>> sequences) {
+    MICROPROFILE_SCOPE(OpenGL_CacheManagement);
+    {
+        std::scoped_lock lock{texture_cache.mutex};
+        for (const auto& [addr, size] : sequences) {
+            texture_cache.WriteMemory(addr, size);
+        }
+    }
+    {
+        std::scoped_lock lock{buffer_cache.mutex};
+        for (const auto& [addr, size] : sequences) {
+            buffer_cache.WriteMemory(addr, size);
+        }
+    }
+    for (const auto& [addr, size] : sequences) {
+        shader_cache.InvalidateRegion(addr, size);
+    }
+}
+
 void RasterizerOpenGL::InvalidateGPUCache() {
     gpu.InvalidateGPUCache();
 }
@@ -688,6 +730,12 @@ void RasterizerOpenGL::TickFrame() {
     num_queued_commands = 0;
 
     fence_manager.TickFrame();
+    // If we can obtain the memory info, use it instead of the estimate. It has to be reported
+    // before the budget of the frame is computed.
+    if (texture_cache_runtime.CanReportMemoryUsage()) {
+        residency.SetReportedUsage(texture_cache_runtime.GetDeviceMemoryUsage());
+    }
+    residency.TickFrame();
     {
         std::scoped_lock lock{texture_cache.mutex};
         texture_cache.TickFrame();
@@ -99,7 +99,9 @@ public:
     RasterizerDownloadArea GetFlushArea(PAddr addr, u64 size) override;
     void InvalidateRegion(DAddr addr, u64 size,
                           VideoCommon::CacheType which = VideoCommon::CacheType::All) override;
+    void InnerInvalidation(std::span<const std::pair<DAddr, std::size_t>> sequences) override;
     void OnCacheInvalidation(PAddr addr, u64 size) override;
+    void OnCacheInvalidation(std::span<const std::pair<DAddr, std::size_t>> sequences) override;
     bool OnCPUWrite(PAddr addr, u64 size) override;
     void InvalidateGPUCache() override;
     void UnmapMemory(DAddr addr, u64 size) override;
@@ -245,6 +247,7 @@ private:
 
     StagingBufferPool staging_buffer_pool;
     TextureCacheRuntime texture_cache_runtime;
+    VideoCommon::ResidencyManager residency;
     TextureCache texture_cache;
     BufferCacheRuntime buffer_cache_runtime;
     BufferCache buffer_cache;
@@ -0,0 +1,200 @@
+// SPDX-FileCopyrightText: Copyright 2024 yuzu Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+#include <algorithm>
+#include <cmath>
+
+#include "frontend/emu_window.h"
+#include "frontend/graphics_context.h"
+#include "yuzu_common/logging/log.h"
+#include "yuzu_video_core/capture.h"
+#include "yuzu_video_core/gpu.h"
+#include "yuzu_video_core/renderer_software/renderer_software.h"
+#include "yuzu_video_core/renderer_software/sw_format.h"
+#include "yuzu_video_core/textures/decoders.h"
+
+namespace Software {
+namespace {
+using VideoCore::Capture::LinearHeight;
+using VideoCore::Capture::LinearWidth;
+
+/// The framebuffer config does not carry the block height, nvdisp buffers are always allocated
+/// with 16 GOBs per block like the OpenGL and Vulkan presenters assume.
+constexpr u32 FRAMEBUFFER_BLOCK_HEIGHT_LOG2 = 4;
+
+u8 ToUnorm8(f32 value) noexcept {
+    return static_cast<u8>(std::lround(std::clamp(value, 0.0f, 1.0f) * 255.0f));
+}
+
+u32 PackBGRA(const Vec4& color) noexcept {
+    return static_cast<u32>(ToUnorm8(color[2])) | (static_cast<u32>(ToUnorm8(color[1])) << 8) |
+           (static_cast<u32>(ToUnorm8(color[0])) << 16) |
+           (static_cast<u32>(ToUnorm8(color[3])) << 24);
+}
+
+/// Nearest neighbour scale of a B8G8R8A8 image
+void ScaleImage(const u32* src, u32 src_width, u32 src_height, u32* dst, u32 dst_width,
+                u32 dst_height, u32 dst_stride) {
+    for (u32 y = 0; y < dst_height; ++y) {
+        const u32 src_y{static_cast<u32>(static_cast<u64>(y) * src_height / dst_height)};
+        for (u32 x = 0; x < dst_width; ++x) {
+            const u32 src_x{static_cast<u32>(static_cast<u64>(x) * src_width / dst_width)};
+            dst[static_cast<size_t>(y) * dst_stride + x] =
+                src[static_cast<size_t>(src_y) * src_width + src_x];
+        }
+    }
+}
+} // Anonymous namespace
+
+RendererSoftware::RendererSoftware(Core::Frontend::EmuWindow& emu_window,
+                                   Tegra::MaxwellDeviceMemoryManager& device_memory_,
+                                   Tegra::GPU& gpu_,
+                                   std::unique_ptr<Core::Frontend::GraphicsContext> context_)
+    : RendererBase(emu_window, std::move(context_)), device_memory{device_memory_}, gpu{gpu_},
+      rasterizer(gpu_, device_memory_),
+      frame(static_cast<size_t>(LinearWidth) * LinearHeight, 0xff000000) {
+    LOG_INFO(Render_Software, "Rendering on the CPU");
+}
+
+RendererSoftware::~RendererSoftware() = default;
+
+void RendererSoftware::Composite(std::span<const Tegra::FramebufferConfig> framebuffers) {
+    if (framebuffers.empty()) {
+        return;
+    }
+    // Write back everything rendered this frame before reading the framebuffers
+    rasterizer.FlushAll();
+
+    std::ranges::fill(frame, 0xff000000);
+    for (const Tegra::FramebufferConfig& framebuffer : framebuffers) {
+        DrawLayer(framebuffer);
+    }
+    RenderScreenshot();
+    Present();
+
+    gpu.RendererFrameEndNotify();
+    render_window.OnFrameDisplayed();
+}
+
+void RendererSoftware::DrawLayer(const Tegra::FramebufferConfig& framebuffer) {
+    using namespace VideoCore::Surface;
+    const PixelFormat format{PixelFormatFromGPUPixelFormat(framebuffer.pixel_format)};
+    if (!IsReadableFormat(format) || framebuffer.width == 0 || framebuffer.height == 0) {
+        return;
+    }
+    const u8* const host_ptr{
+        device_memory.GetPointer<u8>(framebuffer.address + framebuffer.offset)};
+    if (!host_ptr) {
+        return;
+    }
+    const u32 bytes_per_pixel{BytesPerBlock(format)};
+    const u64 tiled_size{Tegra::Texture::CalculateSize(true, bytes_per_pixel, framebuffer.stride,
+                                                       framebuffer.height, 1,
+                                                       FRAMEBUFFER_BLOCK_HEIGHT_LOG2, 0)};
+    layer_pixels.resize(static_cast<size_t>(framebuffer.stride) * framebuffer.height *
+                        bytes_per_pixel);
+    Tegra::Texture::UnswizzleTexture(layer_pixels, std::span(host_ptr, tiled_size),
+                                     bytes_per_pixel, framebuffer.width, framebuffer.height, 1,
+                                     FRAMEBUFFER_BLOCK_HEIGHT_LOG2, 0);
+
+    const Common::Rectangle<f32> crop{
+        Tegra::NormalizeCrop(framebuffer, framebuffer.width, framebuffer.height)};
+    const f32 width{static_cast<f32>(framebuffer.width)};
+    const f32 height{static_cast<f32>(framebuffer.height)};
+    for (u32 y = 0; y < LinearHeight; ++y) {
+        const f32 v{crop.top + (crop.bottom - crop.top) * (static_cast<f32>(y) + 0.5f) /
+                                   static_cast<f32>(LinearHeight)};
+        const u32 src_y{std::min(static_cast<u32>(std::max(v * height, 0.0f)),
+                                 framebuffer.height - 1)};
+        for (u32 x = 0; x < LinearWidth; ++x) {
+            const f32 u{crop.left + (crop.right - crop.left) * (static_cast<f32>(x) + 0.5f) /
+                                        static_cast<f32>(LinearWidth)};
+            const u32 src_x{std::min(static_cast<u32>(std::max(u * width, 0.0f)),
+                                     framebuffer.width - 1)};
+            const size_t offset{(static_cast<size_t>(src_y) * framebuffer.width + src_x) *
+                                bytes_per_pixel};
+            Vec4 color{ReadTexel(format, layer_pixels.data() + offset)};
+            u32& dst{frame[static_cast<size_t>(y) * LinearWidth + x]};
+            switch (framebuffer.blending) {
+            case Tegra::BlendMode::Opaque:
+                color[3] = 1.0f;
+                break;
+            case Tegra::BlendMode::Premultiplied:
+            case Tegra::BlendMode::Coverage: {
+                const f32 alpha{color[3]};
+                const bool premultiplied{framebuffer.blending == Tegra::BlendMode::Premultiplied};
+                for (size_t c = 0; c < 3; ++c) {
+                    const f32 previous{static_cast<f32>((dst >> (16 - c * 8)) & 0xff) / 255.0f};
+                    color[c] = (premultiplied ? color[c] : color[c] * alpha) +
+                               previous * (1.0f - alpha);
+                }
+                color[3] = 1.0f;
+                break;
+            }
+            }
+            dst = PackBGRA(color);
+        }
+    }
+}
+
+void RendererSoftware::RenderScreenshot() {
+    if (!renderer_settings.screenshot_requested) {
+        return;
+    }
+    const Layout::FramebufferLayout& layout{renderer_settings.screenshot_framebuffer_layout};
+    u32* const bits{static_cast<u32*>(renderer_settings.screenshot_bits)};
+    std::fill_n(bits, static_cast<size_t>(layout.width) * layout.height, 0xff000000);
+    const u32 screen_width{std::min(layout.screen.GetWidth(), layout.width)};
+    const u32 screen_height{std::min(layout.screen.GetHeight(), layout.height)};
+    ScaleImage(frame.data(), LinearWidth, LinearHeight,
+               bits + static_cast<size_t>(layout.screen.top) * layout.width + layout.screen.left,
+               screen_width, screen_height, layout.width);
+    renderer_settings.screenshot_complete_callback(true);
+    renderer_settings.screenshot_requested = false;
+}
+
+void RendererSoftware::Present() {
+#ifdef _WIN32
+    const auto& window_info{render_window.GetWindowInfo()};
+    if (window_info.type != Core::Frontend::WindowSystemType::Windows ||
+        !window_info.render_surface) {
+        return;
+    }
+    const HWND hwnd{static_cast<HWND>(window_info.render_surface)};
+    const Layout::FramebufferLayout& layout{render_window.GetFramebufferLayout()};
+    const HDC hdc{GetDC(hwnd)};
+    if (!hdc) {
+        return;
+    }
+    BITMAPINFO bitmap_info{};
+    bitmap_info.bmiHeader.biSize = sizeof(bitmap_info.bmiHeader);
+    bitmap_info.bmiHeader.biWidth = static_cast<LONG>(LinearWidth);
+    // Negative heights describe top-down bitmaps
+    bitmap_info.bmiHeader.biHeight = -static_cast<LONG>(LinearHeight);
+    bitmap_info.bmiHeader.biPlanes = 1;
+    bitmap_info.bmiHeader.biBitCount = 32;
+    bitmap_info.bmiHeader.biCompression = BI_RGB;
+    SetStretchBltMode(hdc, COLORONCOLOR);
+    StretchDIBits(hdc, static_cast<int>(layout.screen.left), static_cast<int>(layout.screen.top),
+                  static_cast<int>(layout.screen.GetWidth()),
+                  static_cast<int>(layout.screen.GetHeight()), 0, 0,
+                  static_cast<int>(LinearWidth), static_cast<int>(LinearHeight), frame.data(),
+                  &bitmap_info, DIB_RGB_COLORS, SRCCOPY);
+    ReleaseDC(hwnd, hdc);
+#endif
+}
+
+std::vector<u8> RendererSoftware::GetAppletCaptureBuffer() {
+    using namespace VideoCore::Capture;
+    std::vector<u8> out(TiledSize);
+    Tegra::Texture::SwizzleTexture(
+        out, std::span(reinterpret_cast<const u8*>(frame.data()), frame.size() * sizeof(u32)),
+        BytesPerPixel, LinearWidth, LinearHeight, LinearDepth, BlockHeight, BlockDepth);
+    return out;
+}
+
+} // namespace Software
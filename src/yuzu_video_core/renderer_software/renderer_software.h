@@ -0,0 +1,56 @@
+// SPDX-FileCopyrightText: Copyright 2024 yuzu Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "yuzu_video_core/renderer_base.h"
+#include "yuzu_video_core/renderer_software/sw_rasterizer.h"
+
+namespace Software {
+
+/// Renderer drawing on the CPU, for hosts without a usable GPU.
+///
+/// Presented frames are composed on the CPU and blitted to the window with the platform's 2D
+/// API, on platforms without one the renderer runs headless.
+class RendererSoftware final : public VideoCore::RendererBase {
+public:
+    explicit RendererSoftware(Core::Frontend::EmuWindow& emu_window,
+                              Tegra::MaxwellDeviceMemoryManager& device_memory, Tegra::GPU& gpu,
+                              std::unique_ptr<Core::Frontend::GraphicsContext> context);
+    ~RendererSoftware() override;
+
+    void Composite(std::span<const Tegra::FramebufferConfig> framebuffers) override;
+
+    std::vector<u8> GetAppletCaptureBuffer() override;
+
+    VideoCore::RasterizerInterface* ReadRasterizer() override {
+        return &rasterizer;
+    }
+
+    [[nodiscard]] std::string GetDeviceVendor() const override {
+        return "Software";
+    }
+
+private:
+    /// Draws a guest framebuffer over the composed frame.
+    void DrawLayer(const Tegra::FramebufferConfig& framebuffer);
+
+    /// Writes the composed frame to the pending screenshot, if any.
+    void RenderScreenshot();
+
+    /// Blits the composed frame to the window.
+    void Present();
+
+    Tegra::MaxwellDeviceMemoryManager& device_memory;
+    Tegra::GPU& gpu;
+    RasterizerSoftware rasterizer;
+
+    std::vector<u32> frame;       ///< Composed frame as B8G8R8A8, sized as the capture layout
+    std::vector<u8> layer_pixels; ///< Unswizzled pixels of the layer being drawn
+};
+
+} // namespace Software
@@ -0,0 +1,561 @@
+// SPDX-FileCopyrightText: Copyright 2024 yuzu Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#include "yuzu_common/bit_cast.h"
+#include "yuzu_video_core/renderer_software/sw_format.h"
+
+namespace Software {
+namespace {
+using VideoCore::Surface::PixelFormat;
+
+template <typename T>
+T Load(const u8* texel, size_t index = 0) {
+    T value;
+    std::memcpy(&value, texel + index * sizeof(T), sizeof(T));
+    return value;
+}
+
+template <typename T>
+void Store(u8* texel, T value, size_t index = 0) {
+    std::memcpy(texel + index * sizeof(T), &value, sizeof(T));
+}
+
+f32 SrgbToLinear(f32 value) {
+    return value <= 0.04045f ? value / 12.92f : std::pow((value + 0.055f) / 1.055f, 2.4f);
+}
+
+f32 LinearToSrgb(f32 value) {
+    return value <= 0.0031308f ? value * 12.92f : 1.055f * std::pow(value, 1.0f / 2.4f) - 0.055f;
+}
+
+const std::array<f32, 256>& SrgbTable() {
+    static const std::array<f32, 256> table{[] {
+        std::array<f32, 256> result{};
+        for (size_t index = 0; index < result.size(); ++index) {
+            result[index] = SrgbToLinear(static_cast<f32>(index) / 255.0f);
+        }
+        return result;
+    }()};
+    return table;
+}
+
+f32 Unorm(u32 value, u32 max) {
+    return static_cast<f32>(value) / static_cast<f32>(max);
+}
+
+f32 Snorm(s32 value, s32 max) {
+    return std::max(static_cast<f32>(value) / static_cast<f32>(max), -1.0f);
+}
+
+u32 ToUnorm(f32 value, u32 max) {
+    if (!(value > 0.0f)) {
+        return 0;
+    }
+    return static_cast<u32>(std::min(value, 1.0f) * static_cast<f32>(max) + 0.5f);
+}
+
+s32 ToSnorm(f32 value, s32 max) {
+    const f32 clamped{std::clamp(std::isnan(value) ? 0.0f : value, -1.0f, 1.0f)};
+    return static_cast<s32>(std::round(clamped * static_cast<f32>(max)));
+}
+
+f32 Bits(u32 value) {
+    return Common::BitCast<f32>(value);
+}
+
+u32 Raw(f32 value) {
+    return Common::BitCast<u32>(value);
+}
+
+/// Unpacks the unsigned small floats of B10G11R11, they share the exponent layout of halves
+f32 SmallFloatToFloat(u32 value, u32 mantissa_bits) {
+    const u32 half{(value << (10 - mantissa_bits)) & 0x7fff};
+    return HalfToFloat(static_cast<u16>(half));
+}
+
+u32 FloatToSmallFloat(f32 value, u32 mantissa_bits) {
+    if (!(value > 0.0f)) {
+        return 0;
+    }
+    const u32 half{FloatToHalf(value)};
+    return (half & 0x7fff) >> (10 - mantissa_bits);
+}
+
+Vec4 ReadRGBA8(const u8* texel, bool srgb) {
+    if (srgb) {
+        const auto& table{SrgbTable()};
+        return {table[texel[0]], table[texel[1]], table[texel[2]], Unorm(texel[3], 255)};
+    }
+    return {Unorm(texel[0], 255), Unorm(texel[1], 255), Unorm(texel[2], 255),
+            Unorm(texel[3], 255)};
+}
+
+void WriteRGBA8(u8* texel, const Vec4& color, bool srgb) {
+    for (size_t i = 0; i < 3; ++i) {
+        const f32 value{srgb ? LinearToSrgb(std::clamp(color[i], 0.0f, 1.0f)) : color[i]};
+        texel[i] = static_cast<u8>(ToUnorm(value, 255));
+    }
+    texel[3] = static_cast<u8>(ToUnorm(color[3], 255));
+}
+} // Anonymous namespace
+
+bool IsReadableFormat(PixelFormat format) noexcept {
+    if (VideoCore::Surface::IsPixelFormatASTC(format) ||
+        VideoCore::Surface::IsPixelFormatBCn(format)) {
+        return true;
+    }
+    return IsWritableFormat(format) || IsDepthFormat(format) ||
+           format == PixelFormat::E5B9G9R9_FLOAT || format == PixelFormat::R32G32B32_FLOAT ||
+           format == PixelFormat::R16G16B16X16_FLOAT;
+}
+
+bool IsWritableFormat(PixelFormat format) noexcept {
+    switch (format) {
+    case PixelFormat::A8B8G8R8_UNORM:
+    case PixelFormat::A8B8G8R8_SNORM:
+    case PixelFormat::A8B8G8R8_SINT:
+    case PixelFormat::A8B8G8R8_UINT:
+    case PixelFormat::A8B8G8R8_SRGB:
+    case PixelFormat::B8G8R8A8_UNORM:
+    case PixelFormat::B8G8R8A8_SRGB:
+    case PixelFormat::R5G6B5_UNORM:
+    case PixelFormat::B5G6R5_UNORM:
+    case PixelFormat::A2B10G10R10_UNORM:
+    case PixelFormat::A2B10G10R10_UINT:
+    case PixelFormat::B10G11R11_FLOAT:
+    case PixelFormat::R8_UNORM:
+    case PixelFormat::R8_SNORM:
+    case PixelFormat::R8_SINT:
+    case PixelFormat::R8_UINT:
+    case PixelFormat::R8G8_UNORM:
+    case PixelFormat::R8G8_SNORM:
+    case PixelFormat::R8G8_SINT:
+    case PixelFormat::R8G8_UINT:
+    case PixelFormat::R16_FLOAT:
+    case PixelFormat::R16_UNORM:
+    case PixelFormat::R16_SNORM:
+    case PixelFormat::R16_UINT:
+    case PixelFormat::R16_SINT:
+    case PixelFormat::R16G16_FLOAT:
+    case PixelFormat::R16G16_UNORM:
+    case PixelFormat::R16G16_SNORM:
+    case PixelFormat::R16G16_UINT:
+    case PixelFormat::R16G16_SINT:
+    case PixelFormat::R16G16B16A16_FLOAT:
+    case PixelFormat::R16G16B16A16_UNORM:
+    case PixelFormat::R16G16B16A16_SNORM:
+    case PixelFormat::R16G16B16A16_UINT:
+    case PixelFormat::R16G16B16A16_SINT:
+    case PixelFormat::R32_FLOAT:
+    case PixelFormat::R32_UINT:
+    case PixelFormat::R32_SINT:
+    case PixelFormat::R32G32_FLOAT:
+    case PixelFormat::R32G32_UINT:
+    case PixelFormat::R32G32_SINT:
+    case PixelFormat::R32G32B32A32_FLOAT:
+    case PixelFormat::R32G32B32A32_UINT:
+    case PixelFormat::R32G32B32A32_SINT:
+        return true;
+    default:
+        return false;
+    }
+}
+
+bool IsDepthFormat(PixelFormat format) noexcept {
+    switch (format) {
+    case PixelFormat::D32_FLOAT:
+    case PixelFormat::D16_UNORM:
+    case PixelFormat::X8_D24_UNORM:
+    case PixelFormat::D24_UNORM_S8_UINT:
+    case PixelFormat::S8_UINT_D24_UNORM:
+    case PixelFormat::D32_FLOAT_S8_UINT:
+        return true;
+    default:
+        return false;
+    }
+}
+
+PixelFormat DecodedFormat(PixelFormat format) noexcept {
+    switch (format) {
+    case PixelFormat::BC4_UNORM:
+        return PixelFormat::R8_UNORM;
+    case PixelFormat::BC4_SNORM:
+        return PixelFormat::R8_SNORM;
+    case PixelFormat::BC5_UNORM:
+        return PixelFormat::R8G8_UNORM;
+    case PixelFormat::BC5_SNORM:
+        return PixelFormat::R8G8_SNORM;
+    case PixelFormat::BC6H_UFLOAT:
+    case PixelFormat::BC6H_SFLOAT:
+        return PixelFormat::R16G16B16A16_FLOAT;
+    default:
+        break;
+    }
+    if (VideoCore::Surface::IsPixelFormatASTC(format) ||
+        VideoCore::Surface::IsPixelFormatBCn(format)) {
+        return VideoCore::Surface::IsPixelFormatSRGB(format) ? PixelFormat::A8B8G8R8_SRGB
+                                                              : PixelFormat::A8B8G8R8_UNORM;
+    }
+    return format;
+}
+
+Vec4 ReadTexel(PixelFormat format, const u8* texel) noexcept {
+    switch (format) {
+    case PixelFormat::A8B8G8R8_UNORM:
+        return ReadRGBA8(texel, false);
+    case PixelFormat::A8B8G8R8_SRGB:
+        return ReadRGBA8(texel, true);
+    case PixelFormat::B8G8R8A8_UNORM:
+    case PixelFormat::B8G8R8A8_SRGB: {
+        const std::array<u8, 4> swapped{texel[2], texel[1], texel[0], texel[3]};
+        return ReadRGBA8(swapped.data(), format == PixelFormat::B8G8R8A8_SRGB);
+    }
+    case PixelFormat::A8B8G8R8_SNORM:
+        return {Snorm(Load<s8>(texel, 0), 127), Snorm(Load<s8>(texel, 1), 127),
+                Snorm(Load<s8>(texel, 2), 127), Snorm(Load<s8>(texel, 3), 127)};
+    case PixelFormat::A8B8G8R8_SINT:
+        return {Bits(Load<s8>(texel, 0)), Bits(Load<s8>(texel, 1)), Bits(Load<s8>(texel, 2)),
+                Bits(Load<s8>(texel, 3))};
+    case PixelFormat::A8B8G8R8_UINT:
+        return {Bits(texel[0]), Bits(texel[1]), Bits(texel[2]), Bits(texel[3])};
+    case PixelFormat::R5G6B5_UNORM: {
+        const u16 value{Load<u16>(texel)};
+        return {Unorm(value & 0x1f, 31), Unorm((value >> 5) & 0x3f, 63),
+                Unorm(value >> 11, 31), 1.0f};
+    }
+    case PixelFormat::B5G6R5_UNORM: {
+        const u16 value{Load<u16>(texel)};
+        return {Unorm(value >> 11, 31), Unorm((value >> 5) & 0x3f, 63),
+                Unorm(value & 0x1f, 31), 1.0f};
+    }
+    case PixelFormat::A2B10G10R10_UNORM: {
+        const u32 value{Load<u32>(texel)};
+        return {Unorm(value & 0x3ff, 1023), Unorm((value >> 10) & 0x3ff, 1023),
+                Unorm((value >> 20) & 0x3ff, 1023), Unorm(value >> 30, 3)};
+    }
+    case PixelFormat::A2B10G10R10_UINT: {
+        const u32 value{Load<u32>(texel)};
+        return {Bits(value & 0x3ff), Bits((value >> 10) & 0x3ff), Bits((value >> 20) & 0x3ff),
+                Bits(value >> 30)};
+    }
+    case PixelFormat::B10G11R11_FLOAT: {
+        const u32 value{Load<u32>(texel)};
+        return {SmallFloatToFloat(value & 0x7ff, 6), SmallFloatToFloat((value >> 11) & 0x7ff, 6),
+                SmallFloatToFloat(value >> 22, 5), 1.0f};
+    }
+    case PixelFormat::E5B9G9R9_FLOAT: {
+        const u32 value{Load<u32>(texel)};
+        const f32 scale{std::ldexp(1.0f, static_cast<s32>(value >> 27) - 15 - 9)};
+        return {static_cast<f32>(value & 0x1ff) * scale,
+                static_cast<f32>((value >> 9) & 0x1ff) * scale,
+                static_cast<f32>((value >> 18) & 0x1ff) * scale, 1.0f};
+    }
+    case PixelFormat::R8_UNORM:
+        return {Unorm(texel[0], 255), 0.0f, 0.0f, 1.0f};
+    case PixelFormat::R8_SNORM:
+        return {Snorm(Load<s8>(texel), 127), 0.0f, 0.0f, 1.0f};
+    case PixelFormat::R8_SINT:
+        return {Bits(Load<s8>(texel)), 0.0f, 0.0f, Bits(1)};
+    case PixelFormat::R8_UINT:
+        return {Bits(texel[0]), 0.0f, 0.0f, Bits(1)};
+    case PixelFormat::R8G8_UNORM:
+        return {Unorm(texel[0], 255), Unorm(texel[1], 255), 0.0f, 1.0f};
+    case PixelFormat::R8G8_SNORM:
+        return {Snorm(Load<s8>(texel, 0), 127), Snorm(Load<s8>(texel, 1), 127), 0.0f, 1.0f};
+    case PixelFormat::R8G8_SINT:
+        return {Bits(Load<s8>(texel, 0)), Bits(Load<s8>(texel, 1)), 0.0f, Bits(1)};
+    case PixelFormat::R8G8_UINT:
+        return {Bits(texel[0]), Bits(texel[1]), 0.0f, Bits(1)};
+    case PixelFormat::R16_FLOAT:
+        return {HalfToFloat(Load<u16>(texel)), 0.0f, 0.0f, 1.0f};
+    case PixelFormat::R16_UNORM:
+        return {Unorm(Load<u16>(texel), 65535), 0.0f, 0.0f, 1.0f};
+    case PixelFormat::R16_SNORM:
+        return {Snorm(Load<s16>(texel), 32767), 0.0f, 0.0f, 1.0f};
+    case PixelFormat::R16_UINT:
+        return {Bits(Load<u16>(texel)), 0.0f, 0.0f, Bits(1)};
+    case PixelFormat::R16_SINT:
+        return {Bits(Load<s16>(texel)), 0.0f, 0.0f, Bits(1)};
+    case PixelFormat::R16G16_FLOAT:
+        return {HalfToFloat(Load<u16>(texel, 0)), HalfToFloat(Load<u16>(texel, 1)), 0.0f, 1.0f};
+    case PixelFormat::R16G16_UNORM:
+        return {Unorm(Load<u16>(texel, 0), 65535), Unorm(Load<u16>(texel, 1), 65535), 0.0f,
+                1.0f};
+    case PixelFormat::R16G16_SNORM:
+        return {Snorm(Load<s16>(texel, 0), 32767), Snorm(Load<s16>(texel, 1), 32767), 0.0f,
+                1.0f};
+    case PixelFormat::R16G16_UINT:
+        return {Bits(Load<u16>(texel, 0)), Bits(Load<u16>(texel, 1)), 0.0f, Bits(1)};
+    case PixelFormat::R16G16_SINT:
+        return {Bits(Load<s16>(texel, 0)), Bits(Load<s16>(texel, 1)), 0.0f, Bits(1)};
+    case PixelFormat::R16G16B16A16_FLOAT:
+    case PixelFormat::R16G16B16X16_FLOAT:
+        return {HalfToFloat(Load<u16>(texel, 0)), HalfToFloat(Load<u16>(texel, 1)),
+                HalfToFloat(Load<u16>(texel, 2)),
+                format == PixelFormat::R16G16B16X16_FLOAT ? 1.0f
+                                                          : HalfToFloat(Load<u16>(texel, 3))};
+    case PixelFormat::R16G16B16A16_UNORM:
+        return {Unorm(Load<u16>(texel, 0), 65535), Unorm(Load<u16>(texel, 1), 65535),
+                Unorm(Load<u16>(texel, 2), 65535), Unorm(Load<u16>(texel, 3), 65535)};
+    case PixelFormat::R16G16B16A16_SNORM:
+        return {Snorm(Load<s16>(texel, 0), 32767), Snorm(Load<s16>(texel, 1), 32767),
+                Snorm(Load<s16>(texel, 2), 32767), Snorm(Load<s16>(texel, 3), 32767)};
+    case PixelFormat::R16G16B16A16_UINT:
+        return {Bits(Load<u16>(texel, 0)), Bits(Load<u16>(texel, 1)), Bits(Load<u16>(texel, 2)),
+                Bits(Load<u16>(texel, 3))};
+    case PixelFormat::R16G16B16A16_SINT:
+        return {Bits(Load<s16>(texel, 0)), Bits(Load<s16>(texel, 1)), Bits(Load<s16>(texel, 2)),
+                Bits(Load<s16>(texel, 3))};
+    case PixelFormat::R32_FLOAT:
+        return {Load<f32>(texel), 0.0f, 0.0f, 1.0f};
+    case PixelFormat::R32_UINT:
+    case PixelFormat::R32_SINT:
+        return {Bits(Load<u32>(texel)), 0.0f, 0.0f, Bits(1)};
+    case PixelFormat::R32G32_FLOAT:
+        return {Load<f32>(texel, 0), Load<f32>(texel, 1), 0.0f, 1.0f};
+    case PixelFormat::R32G32_UINT:
+    case PixelFormat::R32G32_SINT:
+        return {Bits(Load<u32>(texel, 0)), Bits(Load<u32>(texel, 1)), 0.0f, Bits(1)};
+    case PixelFormat::R32G32B32_FLOAT:
+        return {Load<f32>(texel, 0), Load<f32>(texel, 1), Load<f32>(texel, 2), 1.0f};
+    case PixelFormat::R32G32B32A32_FLOAT:
+        return {Load<f32>(texel, 0), Load<f32>(texel, 1), Load<f32>(texel, 2),
+                Load<f32>(texel, 3)};
+    case PixelFormat::R32G32B32A32_UINT:
+    case PixelFormat::R32G32B32A32_SINT:
+        return {Bits(Load<u32>(texel, 0)), Bits(Load<u32>(texel, 1)), Bits(Load<u32>(texel, 2)),
+                Bits(Load<u32>(texel, 3))};
+    default:
+        if (IsDepthFormat(format)) {
+            return {ReadDepth(format, texel), 0.0f, 0.0f, 1.0f};
+        }
+        return {};
+    }
+}
+
+void WriteTexel(PixelFormat format, const Vec4& color, u8* texel) noexcept {
+    switch (format) {
+    case PixelFormat::A8B8G8R8_UNORM:
+        WriteRGBA8(texel, color, false);
+        break;
+    case PixelFormat::A8B8G8R8_SRGB:
+        WriteRGBA8(texel, color, true);
+        break;
+    case PixelFormat::B8G8R8A8_UNORM:
+    case PixelFormat::B8G8R8A8_SRGB:
+        WriteRGBA8(texel, {color[2], color[1], color[0], color[3]},
+                   format == PixelFormat::B8G8R8A8_SRGB);
+        break;
+    case PixelFormat::A8B8G8R8_SNORM:
+        for (size_t i = 0; i < 4; ++i) {
+            Store<s8>(texel, static_cast<s8>(ToSnorm(color[i], 127)), i);
+        }
+        break;
+    case PixelFormat::A8B8G8R8_SINT:
+    case PixelFormat::A8B8G8R8_UINT:
+        for (size_t i = 0; i < 4; ++i) {
+            texel[i] = static_cast<u8>(Raw(color[i]));
+        }
+        break;
+    case PixelFormat::R5G6B5_UNORM:
+        Store<u16>(texel, static_cast<u16>(ToUnorm(color[0], 31) | ToUnorm(color[1], 63) << 5 |
+                                           ToUnorm(color[2], 31) << 11));
+        break;
+    case PixelFormat::B5G6R5_UNORM:
+        Store<u16>(texel, static_cast<u16>(ToUnorm(color[2], 31) | ToUnorm(color[1], 63) << 5 |
+                                           ToUnorm(color[0], 31) << 11));
+        break;
+    case PixelFormat::A2B10G10R10_UNORM:
+        Store<u32>(texel, ToUnorm(color[0], 1023) | ToUnorm(color[1], 1023) << 10 |
+                              ToUnorm(color[2], 1023) << 20 | ToUnorm(color[3], 3) << 30);
+        break;
+    case PixelFormat::A2B10G10R10_UINT:
+        Store<u32>(texel, (Raw(color[0]) & 0x3ff) | (Raw(color[1]) & 0x3ff) << 10 |
+                              (Raw(color[2]) & 0x3ff) << 20 | (Raw(color[3]) & 3) << 30);
+        break;
+    case PixelFormat::B10G11R11_FLOAT:
+        Store<u32>(texel, FloatToSmallFloat(color[0], 6) | FloatToSmallFloat(color[1], 6) << 11 |
+                              FloatToSmallFloat(color[2], 5) << 22);
+        break;
+    case PixelFormat::R8_UNORM:
+    case PixelFormat::R8G8_UNORM:
+        for (size_t i = 0; i < (format == PixelFormat::R8_UNORM ? 1 : 2); ++i) {
+            texel[i] = static_cast<u8>(ToUnorm(color[i], 255));
+        }
+        break;
+    case PixelFormat::R8_SNORM:
+    case PixelFormat::R8G8_SNORM:
+        for (size_t i = 0; i < (format == PixelFormat::R8_SNORM ? 1 : 2); ++i) {
+            Store<s8>(texel, static_cast<s8>(ToSnorm(color[i], 127)), i);
+        }
+        break;
+    case PixelFormat::R8_SINT:
+    case PixelFormat::R8_UINT:
+        texel[0] = static_cast<u8>(Raw(color[0]));
+        break;
+    case PixelFormat::R8G8_SINT:
+    case PixelFormat::R8G8_UINT:
+        texel[0] = static_cast<u8>(Raw(color[0]));
+        texel[1] = static_cast<u8>(Raw(color[1]));
+        break;
+    case PixelFormat::R16_FLOAT:
+    case PixelFormat::R16G16_FLOAT:
+    case PixelFormat::R16G16B16A16_FLOAT: {
+        const size_t count{format == PixelFormat::R16_FLOAT     ? 1U
+                           : format == PixelFormat::R16G16_FLOAT ? 2U
+                                                                 : 4U};
+        for (size_t i = 0; i < count; ++i) {
+            Store<u16>(texel, FloatToHalf(color[i]), i);
+        }
+        break;
+    }
+    case PixelFormat::R16_UNORM:
+    case PixelFormat::R16G16_UNORM:
+    case PixelFormat::R16G16B16A16_UNORM: {
+        const size_t count{format == PixelFormat::R16_UNORM     ? 1U
+                           : format == PixelFormat::R16G16_UNORM ? 2U
+                                                                 : 4U};
+        for (size_t i = 0; i < count; ++i) {
+            Store<u16>(texel, static_cast<u16>(ToUnorm(color[i], 65535)), i);
+        }
+        break;
+    }
+    case PixelFormat::R16_SNORM:
+    case PixelFormat::R16G16_SNORM:
+    case PixelFormat::R16G16B16A16_SNORM: {
+        const size_t count{format == PixelFormat::R16_SNORM     ? 1U
+                           : format == PixelFormat::R16G16_SNORM ? 2U
+                                                                 : 4U};
+        for (size_t i = 0; i < count; ++i) {
+            Store<s16>(texel, static_cast<s16>(ToSnorm(color[i], 32767)), i);
+        }
+        break;
+    }
+    case PixelFormat::R16_UINT:
+    case PixelFormat::R16_SINT:
+    case PixelFormat::R16G16_UINT:
+    case PixelFormat::R16G16_SINT:
+    case PixelFormat::R16G16B16A16_UINT:
+    case PixelFormat::R16G16B16A16_SINT: {
+        const size_t size{VideoCore::Surface::BytesPerBlock(format)};
+        for (size_t i = 0; i < size / sizeof(u16); ++i) {
+            Store<u16>(texel, static_cast<u16>(Raw(color[i])), i);
+        }
+        break;
+    }
+    case PixelFormat::R32_FLOAT:
+    case PixelFormat::R32G32_FLOAT:
+    case PixelFormat::R32G32B32A32_FLOAT:
+    case PixelFormat::R32_UINT:
+    case PixelFormat::R32_SINT:
+    case PixelFormat::R32G32_UINT:
+    case PixelFormat::R32G32_SINT:
+    case PixelFormat::R32G32B32A32_UINT:
+    case PixelFormat::R32G32B32A32_SINT:
+        std::memcpy(texel, color.data(), VideoCore::Surface::BytesPerBlock(format));
+        break;
+    default:
+        break;
+    }
+}
+
+f32 ReadDepth(PixelFormat format, const u8* texel) noexcept {
+    switch (format) {
+    case PixelFormat::D32_FLOAT:
+    case PixelFormat::D32_FLOAT_S8_UINT:
+        return Load<f32>(texel);
+    case PixelFormat::D16_UNORM:
+        return Unorm(Load<u16>(texel), 0xffff);
+    case PixelFormat::X8_D24_UNORM:
+    case PixelFormat::D24_UNORM_S8_UINT:
+        return Unorm(Load<u32>(texel) & 0xffffff, 0xffffff);
+    case PixelFormat::S8_UINT_D24_UNORM:
+        return Unorm(Load<u32>(texel) >> 8, 0xffffff);
+    default:
+        return 0.0f;
+    }
+}
+
+void WriteDepth(PixelFormat format, f32 depth, u8* texel) noexcept {
+    switch (format) {
+    case PixelFormat::D32_FLOAT:
+    case PixelFormat::D32_FLOAT_S8_UINT:
+        Store<f32>(texel, depth);
+        break;
+    case PixelFormat::D16_UNORM:
+        Store<u16>(texel, static_cast<u16>(ToUnorm(depth, 0xffff)));
+        break;
+    case PixelFormat::X8_D24_UNORM:
+    case PixelFormat::D24_UNORM_S8_UINT:
+        Store<u32>(texel, (Load<u32>(texel) & 0xff000000) | ToUnorm(depth, 0xffffff));
+        break;
+    case PixelFormat::S8_UINT_D24_UNORM:
+        Store<u32>(texel, (Load<u32>(texel) & 0xff) | ToUnorm(depth, 0xffffff) << 8);
+        break;
+    default:
+        break;
+    }
+}
+
+void WriteStencil(PixelFormat format, u8 stencil, u8* texel) noexcept {
+    switch (format) {
+    case PixelFormat::D24_UNORM_S8_UINT:
+        texel[3] = stencil;
+        break;
+    case PixelFormat::S8_UINT_D24_UNORM:
+        texel[0] = stencil;
+        break;
+    case PixelFormat::D32_FLOAT_S8_UINT:
+        texel[4] = stencil;
+        break;
+    default:
+        break;
+    }
+}
+
+f32 HalfToFloat(u16 value) noexcept {
+    const u32 sign{static_cast<u32>(value & 0x8000) << 16};
+    const u32 exponent{(value >> 10) & 0x1fU};
+    const u32 mantissa{value & 0x3ffU};
+    if (exponent == 0) {
+        const f32 result{std::ldexp(static_cast<f32>(mantissa), -24)};
+        return sign != 0 ? -result : result;
+    }
+    if (exponent == 0x1f) {
+        return Common::BitCast<f32>(sign | 0x7f800000U | (mantissa << 13));
+    }
+    return Common::BitCast<f32>(sign | ((exponent + 112) << 23) | (mantissa << 13));
+}
+
+u16 FloatToHalf(f32 value) noexcept {
+    const u32 bits{Common::BitCast<u32>(value)};
+    const u32 sign{(bits >> 16) & 0x8000U};
+    const u32 exponent{(bits >> 23) & 0xffU};
+    const u32 mantissa{bits & 0x7fffffU};
+    if (exponent == 0xff) {
+        return static_cast<u16>(sign | 0x7c00U | (mantissa != 0 ? 0x200U : 0U));
+    }
+    const s32 half_exponent{static_cast<s32>(exponent) - 127 + 15};
+    if (half_exponent >= 0x1f) {
+        return static_cast<u16>(sign | 0x7c00U);
+    }
+    if (half_exponent <= 0) {
+        if (half_exponent < -10) {
+            return static_cast<u16>(sign);
+        }
+        const u32 full_mantissa{mantissa | 0x800000U};
+        const u32 shift{static_cast<u32>(14 - half_exponent)};
+        const u32 round{(full_mantissa >> (shift - 1)) & 1U};
+        return static_cast<u16>(sign | ((full_mantissa >> shift) + round));
+    }
+    // Rounding may carry into the exponent, which is the correctly rounded result
+    const u32 round{(mantissa >> 12) & 1U};
+    return static_cast<u16>((sign | (static_cast<u32>(half_exponent) << 10) | (mantissa >> 13)) +
+                            round);
+}
+
+} // namespace Software
@@ -0,0 +1,44 @@
+// SPDX-FileCopyrightText: Copyright 2024 yuzu Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <array>
+
+#include "yuzu_common/common_types.h"
+#include "yuzu_video_core/surface.h"
+
+namespace Software {
+
+using Vec4 = std::array<f32, 4>;
+
+/// Returns true when texels of the format can be read by the software rasterizer.
+[[nodiscard]] bool IsReadableFormat(VideoCore::Surface::PixelFormat format) noexcept;
+
+/// Returns true when the format can be used as a color render target.
+[[nodiscard]] bool IsWritableFormat(VideoCore::Surface::PixelFormat format) noexcept;
+
+/// Returns true when the format can be used as a depth render target.
+[[nodiscard]] bool IsDepthFormat(VideoCore::Surface::PixelFormat format) noexcept;
+
+/// Format compressed textures are decoded to, the format itself for uncompressed ones.
+[[nodiscard]] VideoCore::Surface::PixelFormat DecodedFormat(
+    VideoCore::Surface::PixelFormat format) noexcept;
+
+/// Reads a texel as RGBA, integer formats return the raw bits of each component.
+[[nodiscard]] Vec4 ReadTexel(VideoCore::Surface::PixelFormat format, const u8* texel) noexcept;
+
+/// Writes an RGBA color to a texel, integer formats take the raw bits of each component.
+void WriteTexel(VideoCore::Surface::PixelFormat format, const Vec4& color, u8* texel) noexcept;
+
+[[nodiscard]] f32 ReadDepth(VideoCore::Surface::PixelFormat format, const u8* texel) noexcept;
+
+void WriteDepth(VideoCore::Surface::PixelFormat format, f32 depth, u8* texel) noexcept;
+
+void WriteStencil(VideoCore::Surface::PixelFormat format, u8 stencil, u8* texel) noexcept;
+
+[[nodiscard]] f32 HalfToFloat(u16 value) noexcept;
+
+[[nodiscard]] u16 FloatToHalf(f32 value) noexcept;
+
+} // namespace Software
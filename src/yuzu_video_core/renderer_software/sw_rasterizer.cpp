@@ -0,0 +1,1620 @@
+// SPDX-FileCopyrightText: Copyright 2024 yuzu Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <thread>
+#include <unordered_map>
+
+#include <boost/container/static_vector.hpp>
+
+#include "yuzu_common/alignment.h"
+#include "yuzu_common/bit_cast.h"
+#include "yuzu_common/logging/log.h"
+#include "yuzu_video_core/control/channel_state.h"
+#include "yuzu_video_core/engines/draw_manager.h"
+#include "yuzu_video_core/engines/maxwell_3d.h"
+#include "yuzu_video_core/gpu.h"
+#include "yuzu_video_core/host1x/host1x.h"
+#include "yuzu_video_core/memory_manager.h"
+#include "yuzu_video_core/renderer_software/sw_format.h"
+#include "yuzu_video_core/renderer_software/sw_rasterizer.h"
+#include "yuzu_video_core/surface.h"
+#include "yuzu_video_core/texture_cache/image_info.h"
+#include "yuzu_video_core/textures/texture.h"
+
+namespace Software {
+namespace {
+namespace IR = Shader::IR;
+using Maxwell = Tegra::Engines::Maxwell3D::Regs;
+using VideoCore::Surface::PixelFormat;
+
+constexpr u32 TILE_SIZE = 64;
+constexpr size_t VERTEX_CHUNK_SIZE = 256;
+constexpr size_t VERTEX_STAGE = 0;
+constexpr size_t FRAGMENT_STAGE = 4;
+constexpr f32 GUARD_BAND = 16.0f;
+constexpr f32 MIN_W = 1e-6f;
+
+f32 F(u32 value) noexcept {
+    return Common::BitCast<f32>(value);
+}
+
+u32 U(f32 value) noexcept {
+    return Common::BitCast<u32>(value);
+}
+
+size_t Attr(IR::Attribute attribute) noexcept {
+    return static_cast<size_t>(attribute);
+}
+
+/// Attributes interpolated from the vertex to the fragment stage
+bool IsVarying(size_t attribute) noexcept {
+    if (attribute < Attr(IR::Attribute::Generic0X) ||
+        attribute >= Attr(IR::Attribute::ViewportMask)) {
+        return false;
+    }
+    return (attribute < Attr(IR::Attribute::ClipDistance0) ||
+            attribute > Attr(IR::Attribute::PointSpriteT)) &&
+           attribute != Attr(IR::Attribute::TessellationEvaluationPointU) &&
+           attribute != Attr(IR::Attribute::TessellationEvaluationPointV) &&
+           attribute != Attr(IR::Attribute::InstanceId) &&
+           attribute != Attr(IR::Attribute::VertexId);
+}
+
+bool IsTriangleTopology(Maxwell::PrimitiveTopology topology) noexcept {
+    switch (topology) {
+    case Maxwell::PrimitiveTopology::Triangles:
+    case Maxwell::PrimitiveTopology::TriangleStrip:
+    case Maxwell::PrimitiveTopology::TriangleFan:
+    case Maxwell::PrimitiveTopology::Quads:
+    case Maxwell::PrimitiveTopology::QuadStrip:
+    case Maxwell::PrimitiveTopology::Polygon:
+        return true;
+    default:
+        return false;
+    }
+}
+
+bool Compare(Maxwell::ComparisonOp op, f32 value, f32 reference) noexcept {
+    switch (op) {
+    case Maxwell::ComparisonOp::Never_D3D:
+    case Maxwell::ComparisonOp::Never_GL:
+        return false;
+    case Maxwell::ComparisonOp::Less_D3D:
+    case Maxwell::ComparisonOp::Less_GL:
+        return value < reference;
+    case Maxwell::ComparisonOp::Equal_D3D:
+    case Maxwell::ComparisonOp::Equal_GL:
+        return value == reference;
+    case Maxwell::ComparisonOp::LessEqual_D3D:
+    case Maxwell::ComparisonOp::LessEqual_GL:
+        return value <= reference;
+    case Maxwell::ComparisonOp::Greater_D3D:
+    case Maxwell::ComparisonOp::Greater_GL:
+        return value > reference;
+    case Maxwell::ComparisonOp::NotEqual_D3D:
+    case Maxwell::ComparisonOp::NotEqual_GL:
+        return value != reference;
+    case Maxwell::ComparisonOp::GreaterEqual_D3D:
+    case Maxwell::ComparisonOp::GreaterEqual_GL:
+        return value >= reference;
+    case Maxwell::ComparisonOp::Always_D3D:
+    case Maxwell::ComparisonOp::Always_GL:
+    default:
+        return true;
+    }
+}
+
+/// Decodes a vertex attribute to the raw bits of each component seen by the shader
+std::array<u32, 4> DecodeAttribute(const Maxwell::VertexAttribute& attribute, const u8* data) {
+    using Size = Maxwell::VertexAttribute::Size;
+    using Type = Maxwell::VertexAttribute::Type;
+    const Type type{attribute.type};
+    const bool is_integer{type == Type::SInt || type == Type::UInt};
+    std::array<u32, 4> result{0, 0, 0, is_integer ? 1U : U(1.0f)};
+
+    std::array<u32, 4> bits{};
+    std::array<u32, 4> widths{};
+    u32 count{};
+    const auto load{[&](u32 width, u32 num_components) {
+        count = num_components;
+        for (u32 i = 0; i < num_components; ++i) {
+            widths[i] = width;
+            const u32 bytes{width / 8};
+            std::memcpy(&bits[i], data + i * bytes, bytes);
+        }
+    }};
+    switch (attribute.size) {
+    case Size::Size_R32_G32_B32_A32:
+        load(32, 4);
+        break;
+    case Size::Size_R32_G32_B32:
+        load(32, 3);
+        break;
+    case Size::Size_R32_G32:
+        load(32, 2);
+        break;
+    case Size::Size_R32:
+        load(32, 1);
+        break;
+    case Size::Size_R16_G16_B16_A16:
+        load(16, 4);
+        break;
+    case Size::Size_R16_G16_B16:
+        load(16, 3);
+        break;
+    case Size::Size_R16_G16:
+        load(16, 2);
+        break;
+    case Size::Size_R16:
+        load(16, 1);
+        break;
+    case Size::Size_R8_G8_B8_A8:
+    case Size::Size_X8_B8_G8_R8:
+        load(8, 4);
+        break;
+    case Size::Size_R8_G8_B8:
+        load(8, 3);
+        break;
+    case Size::Size_R8_G8:
+    case Size::Size_G8_R8:
+        load(8, 2);
+        break;
+    case Size::Size_R8:
+    case Size::Size_A8:
+        load(8, 1);
+        break;
+    case Size::Size_A2_B10_G10_R10: {
+        u32 packed;
+        std::memcpy(&packed, data, sizeof(packed));
+        bits = {packed & 0x3ff, (packed >> 10) & 0x3ff, (packed >> 20) & 0x3ff, packed >> 30};
+        widths = {10, 10, 10, 2};
+        count = 4;
+        break;
+    }
+    case Size::Size_B10_G11_R11: {
+        u32 packed;
+        std::memcpy(&packed, data, sizeof(packed));
+        // Unsigned floats share the exponent bias of halves, the mantissa is shifted in place
+        result[0] = U(HalfToFloat(static_cast<u16>((packed & 0x7ff) << 4)));
+        result[1] = U(HalfToFloat(static_cast<u16>(((packed >> 11) & 0x7ff) << 4)));
+        result[2] = U(HalfToFloat(static_cast<u16>(((packed >> 22) & 0x3ff) << 5)));
+        return result;
+    }
+    default:
+        return result;
+    }
+    for (u32 i = 0; i < count; ++i) {
+        const u32 width{widths[i]};
+        const u32 max_value{width >= 32 ? ~0U : (1U << width) - 1};
+        const u32 value{bits[i] & max_value};
+        const s32 signed_value{width >= 32 ? static_cast<s32>(value)
+                                           : static_cast<s32>(value << (32 - width)) >>
+                                                 (32 - width)};
+        switch (type) {
+        case Type::SNorm:
+            result[i] = U(std::max(static_cast<f32>(signed_value) /
+                                       static_cast<f32>(max_value >> 1),
+                                   -1.0f));
+            break;
+        case Type::UNorm:
+            result[i] = U(static_cast<f32>(value) / static_cast<f32>(max_value));
+            break;
+        case Type::SInt:
+            result[i] = static_cast<u32>(signed_value);
+            break;
+        case Type::UInt:
+            result[i] = value;
+            break;
+        case Type::SScaled:
+            result[i] = U(static_cast<f32>(signed_value));
+            break;
+        case Type::UScaled:
+            result[i] = U(static_cast<f32>(value));
+            break;
+        case Type::Float:
+            result[i] = width == 16 ? U(HalfToFloat(static_cast<u16>(value))) : value;
+            break;
+        default:
+            break;
+        }
+    }
+    if (attribute.bgra != 0) {
+        std::swap(result[0], result[2]);
+    }
+    return result;
+}
+
+f32 BlendFactor(Maxwell::Blend::Factor factor, size_t component, const Vec4& src,
+                const Vec4& src1, const Vec4& dst, const Vec4& constant) noexcept {
+    using Factor = Maxwell::Blend::Factor;
+    switch (factor) {
+    case Factor::Zero_D3D:
+    case Factor::Zero_GL:
+        return 0.0f;
+    case Factor::One_D3D:
+    case Factor::One_GL:
+        return 1.0f;
+    case Factor::SourceColor_D3D:
+    case Factor::SourceColor_GL:
+        return src[component];
+    case Factor::OneMinusSourceColor_D3D:
+    case Factor::OneMinusSourceColor_GL:
+        return 1.0f - src[component];
+    case Factor::SourceAlpha_D3D:
+    case Factor::SourceAlpha_GL:
+        return src[3];
+    case Factor::OneMinusSourceAlpha_D3D:
+    case Factor::OneMinusSourceAlpha_GL:
+        return 1.0f - src[3];
+    case Factor::DestAlpha_D3D:
+    case Factor::DestAlpha_GL:
+        return dst[3];
+    case Factor::OneMinusDestAlpha_D3D:
+    case Factor::OneMinusDestAlpha_GL:
+        return 1.0f - dst[3];
+    case Factor::DestColor_D3D:
+    case Factor::DestColor_GL:
+        return dst[component];
+    case Factor::OneMinusDestColor_D3D:
+    case Factor::OneMinusDestColor_GL:
+        return 1.0f - dst[component];
+    case Factor::SourceAlphaSaturate_D3D:
+    case Factor::SourceAlphaSaturate_GL:
+        return component == 3 ? 1.0f : std::min(src[3], 1.0f - dst[3]);
+    case Factor::BothSourceAlpha_D3D:
+        return src[3];
+    case Factor::OneMinusBothSourceAlpha_D3D:
+        return 1.0f - src[3];
+    case Factor::BlendFactor_D3D:
+    case Factor::ConstantColor_GL:
+        return constant[component];
+    case Factor::OneMinusBlendFactor_D3D:
+    case Factor::OneMinusConstantColor_GL:
+        return 1.0f - constant[component];
+    case Factor::ConstantAlpha_GL:
+        return constant[3];
+    case Factor::OneMinusConstantAlpha_GL:
+        return 1.0f - constant[3];
+    case Factor::Source1Color_D3D:
+    case Factor::Source1Color_GL:
+        return src1[component];
+    case Factor::OneMinusSource1Color_D3D:
+    case Factor::OneMinusSource1Color_GL:
+        return 1.0f - src1[component];
+    case Factor::Source1Alpha_D3D:
+    case Factor::Source1Alpha_GL:
+        return src1[3];
+    case Factor::OneMinusSource1Alpha_D3D:
+    case Factor::OneMinusSource1Alpha_GL:
+        return 1.0f - src1[3];
+    default:
+        return 1.0f;
+    }
+}
+
+f32 BlendEquation(Maxwell::Blend::Equation equation, f32 src, f32 src_factor, f32 dst,
+                  f32 dst_factor) noexcept {
+    using Equation = Maxwell::Blend::Equation;
+    switch (equation) {
+    case Equation::Subtract_D3D:
+    case Equation::Subtract_GL:
+        return src * src_factor - dst * dst_factor;
+    case Equation::ReverseSubtract_D3D:
+    case Equation::ReverseSubtract_GL:
+        return dst * dst_factor - src * src_factor;
+    case Equation::Min_D3D:
+    case Equation::Min_GL:
+        return std::min(src, dst);
+    case Equation::Max_D3D:
+    case Equation::Max_GL:
+        return std::max(src, dst);
+    case Equation::Add_D3D:
+    case Equation::Add_GL:
+    default:
+        return src * src_factor + dst * dst_factor;
+    }
+}
+
+struct BlendState {
+    bool enable{};
+    bool separate_alpha{};
+    Maxwell::Blend::Equation color_op{};
+    Maxwell::Blend::Factor color_source{};
+    Maxwell::Blend::Factor color_dest{};
+    Maxwell::Blend::Equation alpha_op{};
+    Maxwell::Blend::Factor alpha_source{};
+    Maxwell::Blend::Factor alpha_dest{};
+};
+
+BlendState MakeBlendState(const Maxwell& regs, size_t index) noexcept {
+    if (regs.blend_per_target_enabled != 0) {
+        const auto& blend{regs.blend_per_target[index]};
+        return {
+            .enable = regs.blend.enable[index] != 0,
+            .separate_alpha = blend.separate_alpha != 0,
+            .color_op = blend.color_op,
+            .color_source = blend.color_source,
+            .color_dest = blend.color_dest,
+            .alpha_op = blend.alpha_op,
+            .alpha_source = blend.alpha_source,
+            .alpha_dest = blend.alpha_dest,
+        };
+    }
+    return {
+        .enable = regs.blend.enable[index] != 0,
+        .separate_alpha = regs.blend.separate_alpha != 0,
+        .color_op = regs.blend.color_op,
+        .color_source = regs.blend.color_source,
+        .color_dest = regs.blend.color_dest,
+        .alpha_op = regs.blend.alpha_op,
+        .alpha_source = regs.blend.alpha_source,
+        .alpha_dest = regs.blend.alpha_dest,
+    };
+}
+
+struct Rect {
+    s32 min_x;
+    s32 min_y;
+    s32 max_x; ///< Exclusive
+    s32 max_y; ///< Exclusive
+};
+
+/// Scissor of the first viewport in framebuffer coordinates, mirroring the Vulkan backend
+Rect ScissorRect(const Maxwell& regs, u32 width, u32 height) noexcept {
+    Rect rect{0, 0, static_cast<s32>(width), static_cast<s32>(height)};
+    const auto& scissor{regs.scissor_test[0]};
+    if (scissor.enable == 0) {
+        return rect;
+    }
+    const bool lower_left{regs.window_origin.mode != Maxwell::WindowOrigin::Mode::UpperLeft};
+    const s32 clip_height{static_cast<s32>(regs.surface_clip.height.Value())};
+    const s32 min_y{lower_left ? clip_height - static_cast<s32>(scissor.max_y.Value())
+                               : static_cast<s32>(scissor.min_y.Value())};
+    const s32 max_y{lower_left ? clip_height - static_cast<s32>(scissor.min_y.Value())
+                               : static_cast<s32>(scissor.max_y.Value())};
+    rect.min_x = std::max(rect.min_x, static_cast<s32>(scissor.min_x.Value()));
+    rect.max_x = std::min(rect.max_x, static_cast<s32>(scissor.max_x.Value()));
+    rect.min_y = std::max(rect.min_y, min_y);
+    rect.max_y = std::min(rect.max_y, max_y);
+    return rect;
+}
+
+struct Viewport {
+    f32 x;
+    f32 y;
+    f32 width;
+    f32 height;
+    f32 translate_z;
+    f32 scale_z;
+};
+
+/// Viewport of the first viewport transform, flipped the same way as the Vulkan backend
+Viewport MakeViewport(const Maxwell& regs) noexcept {
+    const auto& src{regs.viewport_transform[0]};
+    Viewport viewport{
+        .x = src.translate_x - src.scale_x,
+        .y = src.translate_y - src.scale_y,
+        .width = src.scale_x * 2.0f,
+        .height = src.scale_y * 2.0f,
+        .translate_z = src.translate_z,
+        .scale_z = src.scale_z,
+    };
+    if (regs.window_origin.mode != Maxwell::WindowOrigin::Mode::UpperLeft) {
+        viewport.y += static_cast<f32>(regs.surface_clip.height);
+        viewport.height = -viewport.height;
+    }
+    if (src.swizzle.y == Maxwell::ViewportSwizzle::NegativeY) {
+        viewport.y += viewport.height;
+        viewport.height = -viewport.height;
+    }
+    return viewport;
+}
+} // Anonymous namespace
+
+struct StageResources {
+    std::array<std::vector<u8>, Shader::Info::MAX_CBUFS> cbufs;
+    std::vector<StorageBinding> storage_buffers;
+    std::vector<BoundTexture> textures;
+    std::vector<std::shared_ptr<const Texture>> texture_refs;
+    ShaderResources resources;
+};
+
+struct ColorTarget {
+    Surface* surface{};
+    PixelFormat format{};
+    BlendState blend;
+    std::array<bool, 4> mask{};
+    bool is_integer{};
+};
+
+struct VertexStream {
+    std::vector<u8> data;
+    u64 begin{}; ///< Offset of the first byte read from the stream
+    u32 stride{};
+    u32 divisor{}; ///< Instance divisor, zero for streams indexed by vertex
+};
+
+struct ScreenVertex {
+    f32 x;
+    f32 y;
+    f32 z;
+    f32 inv_w;
+    u32 varyings; ///< Offset of the varyings of the vertex
+};
+
+struct Triangle {
+    std::array<u32, 3> vertices;
+    std::array<f32, 3> a; ///< Edge equation terms, edge i is opposite to vertex i
+    std::array<f32, 3> b;
+    std::array<f32, 3> c;
+    std::array<bool, 3> inclusive; ///< Pixels exactly on the edge are covered
+    f32 inv_area;
+    Rect bounds;
+    bool front_facing;
+};
+
+struct DrawState {
+    const GraphicsPrograms* programs{};
+    Maxwell::PrimitiveTopology topology{};
+    std::array<StageResources, 2> stages;
+
+    // Vertex input
+    std::array<VertexStream, Maxwell::NumVertexArrays> streams;
+    std::vector<u32> elements;        ///< Shaded vertex of each element of the draw, ~0 restarts
+    std::vector<u32> vertex_ids;      ///< Vertex index of each shaded vertex
+    u32 num_instances{};
+    u32 base_instance{};
+    u32 base_vertex{};
+
+    // Vertex output
+    std::vector<size_t> varying_attributes;
+    std::vector<Shader::Interpolation> varying_interpolation;
+    std::vector<Vec4> positions;
+    std::vector<f32> vertex_varyings;
+
+    // Setup
+    Viewport viewport{};
+    Rect render_area{};
+    std::vector<ScreenVertex> screen_vertices;
+    std::vector<f32> screen_varyings;
+    std::vector<Triangle> triangles;
+    u32 tiles_x{};
+    u32 tiles_y{};
+    std::vector<std::vector<u32>> bins;
+
+    // Output merger
+    std::array<ColorTarget, Maxwell::NumRenderTargets> color_targets;
+    u32 num_color_targets{};
+    Surface* depth_surface{};
+    bool depth_test{};
+    bool depth_write{};
+    Maxwell::ComparisonOp depth_func{};
+    bool alpha_test{};
+    Maxwell::ComparisonOp alpha_func{};
+    f32 alpha_ref{};
+    Vec4 blend_color{};
+};
+
+RasterizerSoftware::RasterizerSoftware(Tegra::GPU& gpu_,
+                                       Tegra::MaxwellDeviceMemoryManager& device_memory_)
+    : gpu{gpu_}, device_memory{device_memory_}, shader_cache{device_memory_},
+      num_workers{std::max(std::thread::hardware_concurrency(), 2U) - 1},
+      workers{num_workers, "SwRasterizer"} {}
+
+RasterizerSoftware::~RasterizerSoftware() = default;
+
+void RasterizerSoftware::RunParallel(size_t count, const std::function<void(size_t)>& task) {
+    if (count == 0) {
+        return;
+    }
+    std::atomic<size_t> next{};
+    const auto run{[&] {
+        for (size_t index = next++; index < count; index = next++) {
+            task(index);
+        }
+    }};
+    const size_t num_helpers{std::min(num_workers, count - 1)};
+    for (size_t helper = 0; helper < num_helpers; ++helper) {
+        workers.QueueWork(run);
+    }
+    run();
+    workers.WaitForRequests();
+}
+
+void RasterizerSoftware::ReadConstantBuffers(DrawState& state, size_t stage_index,
+                                             const ShaderProgram& program) {
+    const size_t stage{stage_index == 0 ? VERTEX_STAGE : FRAGMENT_STAGE};
+    const auto& cbufs{maxwell3d->state.shader_stages[stage].const_buffers};
+    const Shader::Info& info{program.Info()};
+    StageResources& resources{state.stages[stage_index]};
+    for (size_t index = 0; index < Shader::Info::MAX_CBUFS; ++index) {
+        if (((info.constant_buffer_mask >> index) & 1) == 0 || !cbufs[index].enabled) {
+            continue;
+        }
+        resources.cbufs[index].resize(cbufs[index].size);
+        gpu_memory->ReadBlock(cbufs[index].address, resources.cbufs[index].data(),
+                              cbufs[index].size);
+        resources.resources.cbufs[index] = resources.cbufs[index];
+    }
+}
+
+void RasterizerSoftware::BindResources(DrawState& state, size_t stage_index,
+                                       const ShaderProgram& program) {
+    const auto& regs{maxwell3d->regs};
+    const Shader::Info& info{program.Info()};
+    StageResources& resources{state.stages[stage_index]};
+    const auto read_cbuf{[&](u32 index, u32 offset, auto& value) {
+        const auto& cbuf{resources.cbufs[index]};
+        value = {};
+        if (offset + sizeof(value) <= cbuf.size()) {
+            std::memcpy(&value, cbuf.data() + offset, sizeof(value));
+        }
+    }};
+    for (const Shader::StorageBufferDescriptor& desc : info.storage_buffers_descriptors) {
+        u64 gpu_addr;
+        u32 size;
+        read_cbuf(desc.cbuf_index, desc.cbuf_offset, gpu_addr);
+        read_cbuf(desc.cbuf_index, desc.cbuf_offset + 8, size);
+        // Storage offsets are relative to the address aligned down by the translator
+        const GPUVAddr aligned_addr{Common::AlignDown(gpu_addr, 16)};
+        const u32 aligned_size{size != 0 ? size + static_cast<u32>(gpu_addr - aligned_addr) : 0};
+        resources.storage_buffers.push_back({
+            .gpu_addr = aligned_addr,
+            .size = aligned_size,
+        });
+        // The interpreter accesses storage buffers directly, write back rendered surfaces first
+        if (const auto device_addr{gpu_memory->GpuToCpuAddress(aligned_addr, aligned_size)}) {
+            surface_cache.FlushRegion(*device_addr, aligned_size);
+        }
+    }
+    const bool via_header_index{regs.sampler_binding == Maxwell::SamplerBinding::ViaHeaderBinding};
+    for (const Shader::TextureDescriptor& desc : info.texture_descriptors) {
+        for (u32 index = 0; index < desc.count; ++index) {
+            const u32 index_offset{index << desc.size_shift};
+            u32 raw;
+            read_cbuf(desc.cbuf_index, desc.cbuf_offset + index_offset, raw);
+            if (desc.has_secondary) {
+                u32 secondary;
+                read_cbuf(desc.secondary_cbuf_index, desc.secondary_cbuf_offset + index_offset,
+                          secondary);
+                raw = (raw << desc.shift_left) | (secondary << desc.secondary_shift_left);
+            }
+            const auto [tic_id, tsc_id] = Tegra::Texture::TexturePair(raw, via_header_index);
+            Tegra::Texture::TICEntry tic;
+            Tegra::Texture::TSCEntry tsc;
+            gpu_memory->ReadBlockUnsafe(regs.tex_header.Address() + tic_id * sizeof(tic), &tic,
+                                        sizeof(tic));
+            gpu_memory->ReadBlockUnsafe(regs.tex_sampler.Address() + tsc_id * sizeof(tsc), &tsc,
+                                        sizeof(tsc));
+            // Surfaces rendered to are written back before the texture reads guest memory
+            std::shared_ptr<const Texture> texture{texture_cache.Get(
+                *gpu_memory, tic,
+                [this](DAddr addr, u64 size) { surface_cache.FlushRegion(addr, size); })};
+            resources.textures.push_back({texture.get(), Sampler{tsc}});
+            resources.texture_refs.push_back(std::move(texture));
+        }
+    }
+    resources.resources.textures = resources.textures;
+    resources.resources.storage_buffers = resources.storage_buffers;
+    resources.resources.gpu_memory = gpu_memory;
+    resources.resources.render_area = {static_cast<f32>(state.render_area.max_x),
+                                       static_cast<f32>(state.render_area.max_y)};
+    resources.resources.y_negate =
+        regs.window_origin.mode != Maxwell::WindowOrigin::Mode::UpperLeft;
+}
+
+void RasterizerSoftware::FetchVertices(DrawState& state, bool is_indexed, u32 instance_count) {
+    const auto& regs{maxwell3d->regs};
+    const auto& draw_state{maxwell3d->draw_manager->GetDrawState()};
+    const Shader::Info& info{state.programs->vertex->Info()};
+
+    state.num_instances = std::max(instance_count, 1U);
+    state.base_instance = draw_state.base_instance;
+    state.base_vertex = is_indexed ? draw_state.base_index : 0;
+
+    // Elements of the draw, indexed draws only shade each referenced vertex once
+    const u32 count{is_indexed ? draw_state.index_buffer.count : draw_state.vertex_buffer.count};
+    state.elements.resize(count);
+    if (is_indexed) {
+        const u32 index_size{draw_state.index_buffer.FormatSizeInBytes()};
+        const size_t first_byte{static_cast<size_t>(draw_state.index_buffer.first) * index_size};
+        std::vector<u8> indices(static_cast<size_t>(count) * index_size);
+        if (!draw_state.inline_index_draw_indexes.empty()) {
+            const auto& inline_indices{draw_state.inline_index_draw_indexes};
+            const size_t available{inline_indices.size() - std::min(first_byte,
+                                                                     inline_indices.size())};
+            std::memcpy(indices.data(), inline_indices.data() + std::min(first_byte,
+                                                                         inline_indices.size()),
+                        std::min(available, indices.size()));
+        } else {
+            gpu_memory->ReadBlock(draw_state.index_buffer.StartAddress() + first_byte,
+                                  indices.data(), indices.size());
+        }
+        const bool restart_enabled{regs.primitive_restart.enabled != 0};
+        std::unordered_map<u32, u32> slots;
+        for (u32 element = 0; element < count; ++element) {
+            u32 index{};
+            std::memcpy(&index, indices.data() + static_cast<size_t>(element) * index_size,
+                        index_size);
+            if (restart_enabled && index == regs.primitive_restart.index) {
+                state.elements[element] = ~0U;
+                continue;
+            }
+            const u32 vertex_id{index + state.base_vertex};
+            const auto [it, is_new] =
+                slots.try_emplace(vertex_id, static_cast<u32>(state.vertex_ids.size()));
+            if (is_new) {
+                state.vertex_ids.push_back(vertex_id);
+            }
+            state.elements[element] = it->second;
+        }
+    } else {
+        state.vertex_ids.resize(count);
+        for (u32 element = 0; element < count; ++element) {
+            state.elements[element] = element;
+            state.vertex_ids[element] = draw_state.vertex_buffer.first + element;
+        }
+    }
+    if (state.vertex_ids.empty()) {
+        return;
+    }
+
+    // Read the range of each stream used by the draw
+    const auto [min_vertex, max_vertex] = std::ranges::minmax(state.vertex_ids);
+    std::array<u32, Maxwell::NumVertexArrays> stream_end{};
+    for (size_t index = 0; index < Maxwell::NumVertexAttributes; ++index) {
+        const auto& attribute{regs.vertex_attrib_format[index]};
+        if (!info.loads.Generic(index) || attribute.constant != 0 ||
+            attribute.size == Maxwell::VertexAttribute::Size::Invalid) {
+            continue;
+        }
+        u32& end{stream_end[attribute.buffer]};
+        end = std::max(end, static_cast<u32>(attribute.offset) + attribute.SizeInBytes());
+    }
+    for (size_t index = 0; index < Maxwell::NumVertexArrays; ++index) {
+        const auto& stream{regs.vertex_streams[index]};
+        if (stream_end[index] == 0 || !stream.IsEnabled()) {
+            continue;
+        }
+        VertexStream& data{state.streams[index]};
+        const bool is_instanced{regs.vertex_stream_instances.IsInstancingEnabled(index)};
+        data.stride = stream.stride;
+        data.divisor = is_instanced ? std::max(stream.frequency, 1U) : 0;
+        const u32 first{is_instanced ? state.base_instance : min_vertex};
+        const u32 last{is_instanced ? state.base_instance +
+                                          (state.num_instances - 1) / data.divisor
+                                    : max_vertex};
+        data.begin = static_cast<u64>(first) * data.stride;
+        const u64 end{static_cast<u64>(last) * data.stride + stream_end[index]};
+        const GPUVAddr limit{regs.vertex_stream_limits[index].Address() + 1};
+        const u64 stream_size{limit > stream.Address() ? limit - stream.Address() : 0};
+        if (data.begin >= std::min(end, stream_size)) {
+            continue;
+        }
+        data.data.resize(std::min(end, stream_size) - data.begin);
+        gpu_memory->ReadBlock(stream.Address() + data.begin, data.data.data(), data.data.size());
+    }
+}
+
+void RasterizerSoftware::ShadeVertices(DrawState& state) {
+    const auto& regs{maxwell3d->regs};
+    const ShaderProgram& program{*state.programs->vertex};
+    const Shader::Info& info{program.Info()};
+    const size_t num_vertices{state.vertex_ids.size()};
+    const size_t num_shaded{num_vertices * state.num_instances};
+    const size_t num_varyings{state.varying_attributes.size()};
+    state.positions.resize(num_shaded);
+    state.vertex_varyings.resize(num_shaded * num_varyings);
+
+    const ShaderResources& resources{state.stages[0].resources};
+    const auto start{std::chrono::steady_clock::now()};
+    const size_t num_chunks{(num_shaded + VERTEX_CHUNK_SIZE - 1) / VERTEX_CHUNK_SIZE};
+    RunParallel(num_chunks, [&](size_t chunk) {
+        ShaderProgram::Context ctx{program.MakeContext()};
+        const auto invocation{std::make_unique<Invocation>()};
+        const size_t end{std::min((chunk + 1) * VERTEX_CHUNK_SIZE, num_shaded)};
+        for (size_t shaded = chunk * VERTEX_CHUNK_SIZE; shaded < end; ++shaded) {
+            const u32 instance{static_cast<u32>(shaded / num_vertices)};
+            const u32 vertex_id{state.vertex_ids[shaded % num_vertices]};
+            auto& inputs{invocation->inputs};
+            for (size_t index = 0; index < Maxwell::NumVertexAttributes; ++index) {
+                if (!info.loads.Generic(index)) {
+                    continue;
+                }
+                const auto& attribute{regs.vertex_attrib_format[index]};
+                std::array<u32, 4> value{0, 0, 0, U(1.0f)};
+                const VertexStream& stream{state.streams[attribute.buffer]};
+                if (attribute.constant == 0 && !stream.data.empty()) {
+                    const u32 element{stream.divisor != 0
+                                          ? state.base_instance + instance / stream.divisor
+                                          : vertex_id};
+                    const u64 offset{static_cast<u64>(element) * stream.stride + attribute.offset -
+                                     stream.begin};
+                    if (offset + attribute.SizeInBytes() <= stream.data.size()) {
+                        value = DecodeAttribute(attribute, stream.data.data() + offset);
+                    }
+                }
+                for (size_t component = 0; component < 4; ++component) {
+                    inputs[Attr(IR::Attribute::Generic0X) + index * 4 + component] =
+                        F(value[component]);
+                }
+            }
+            inputs[Attr(IR::Attribute::VertexId)] = F(vertex_id);
+            inputs[Attr(IR::Attribute::InstanceId)] = F(state.base_instance + instance);
+            inputs[Attr(IR::Attribute::BaseVertex)] = F(state.base_vertex);
+            inputs[Attr(IR::Attribute::BaseInstance)] = F(state.base_instance);
+            inputs[Attr(IR::Attribute::DrawID)] = F(0);
+            invocation->outputs.fill(0.0f);
+            invocation->demoted = false;
+
+            program.Execute(ctx, *invocation, resources);
+
+            const auto& outputs{invocation->outputs};
+            state.positions[shaded] = {outputs[Attr(IR::Attribute::PositionX)],
+                                       outputs[Attr(IR::Attribute::PositionY)],
+                                       outputs[Attr(IR::Attribute::PositionZ)],
+                                       outputs[Attr(IR::Attribute::PositionW)]};
+            f32* const varyings{state.vertex_varyings.data() + shaded * num_varyings};
+            for (size_t index = 0; index < num_varyings; ++index) {
+                varyings[index] = outputs[state.varying_attributes[index]];
+            }
+        }
+    });
+    const auto elapsed{std::chrono::steady_clock::now() - start};
+    timings.vertex_nanoseconds +=
+        std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+}
+
+void RasterizerSoftware::AssembleTriangles(DrawState& state) {
+    const auto& regs{maxwell3d->regs};
+    const size_t num_vertices{state.vertex_ids.size()};
+    const size_t num_varyings{state.varying_attributes.size()};
+    const Viewport& viewport{state.viewport};
+
+    bool front_ccw{regs.gl_front_face == Maxwell::FrontFace::CounterClockWise};
+    if (regs.window_origin.flip_y != 0) {
+        front_ccw = !front_ccw;
+    }
+    const bool cull_front{regs.gl_cull_test_enabled != 0 &&
+                          regs.gl_cull_face != Maxwell::CullFace::Back};
+    const bool cull_back{regs.gl_cull_test_enabled != 0 &&
+                         regs.gl_cull_face != Maxwell::CullFace::Front};
+    const f32 near_scale{regs.depth_mode == Maxwell::DepthMode::MinusOneToOne ? 1.0f : 0.0f};
+
+    struct ClipVertex {
+        Vec4 position;
+        std::array<f32, 3> weights; ///< Barycentric weights of the vertex in the source triangle
+    };
+    using Polygon = boost::container::static_vector<ClipVertex, 12>;
+    // Planes in clip space, a vertex is inside when the dot product is positive
+    const std::array<Vec4, 7> planes{{
+        {0.0f, 0.0f, 1.0f, near_scale},
+        {0.0f, 0.0f, -1.0f, 1.0f},
+        {1.0f, 0.0f, 0.0f, GUARD_BAND},
+        {-1.0f, 0.0f, 0.0f, GUARD_BAND},
+        {0.0f, 1.0f, 0.0f, GUARD_BAND},
+        {0.0f, -1.0f, 0.0f, GUARD_BAND},
+        {0.0f, 0.0f, 0.0f, 1.0f},
+    }};
+    const auto distance{[&](const Vec4& plane, const Vec4& position, size_t index) {
+        const f32 dot{plane[0] * position[0] + plane[1] * position[1] + plane[2] * position[2] +
+                      plane[3] * position[3]};
+        // The last plane keeps w away from zero
+        return index == planes.size() - 1 ? dot - MIN_W : dot;
+    }};
+
+    std::vector<u32> projected(state.positions.size(), ~0U);
+    const auto project{[&](const Vec4& position, const f32* varyings) {
+        const f32 inv_w{1.0f / position[3]};
+        const u32 index{static_cast<u32>(state.screen_vertices.size())};
+        state.screen_vertices.push_back({
+            .x = viewport.x + viewport.width * 0.5f * (position[0] * inv_w + 1.0f),
+            .y = viewport.y + viewport.height * 0.5f * (position[1] * inv_w + 1.0f),
+            .z = viewport.translate_z + viewport.scale_z * position[2] * inv_w,
+            .inv_w = inv_w,
+            .varyings = static_cast<u32>(state.screen_varyings.size()),
+        });
+        state.screen_varyings.insert(state.screen_varyings.end(), varyings,
+                                     varyings + num_varyings);
+        return index;
+    }};
+    const auto setup{[&](u32 i0, u32 i1, u32 i2) {
+        std::array<u32, 3> vertices{i0, i1, i2};
+        const auto vertex{[&](size_t index) -> const ScreenVertex& {
+            return state.screen_vertices[vertices[index]];
+        }};
+        // Signed area following the Vulkan definition, positive is counter-clockwise
+        const f32 area{-0.5f * ((vertex(0).x * vertex(1).y - vertex(1).x * vertex(0).y) +
+                                (vertex(1).x * vertex(2).y - vertex(2).x * vertex(1).y) +
+                                (vertex(2).x * vertex(0).y - vertex(0).x * vertex(2).y))};
+        if (area == 0.0f || !std::isfinite(area)) {
+            return;
+        }
+        const bool front_facing{(area > 0.0f) == front_ccw};
+        if ((front_facing && cull_front) || (!front_facing && cull_back)) {
+            return;
+        }
+        Triangle triangle{};
+        // Edge equations are positive inside the triangle regardless of its winding
+        const f32 sign{area > 0.0f ? -1.0f : 1.0f};
+        for (size_t edge = 0; edge < 3; ++edge) {
+            const ScreenVertex& from{vertex((edge + 1) % 3)};
+            const ScreenVertex& to{vertex((edge + 2) % 3)};
+            const f32 dx{to.x - from.x};
+            const f32 dy{to.y - from.y};
+            triangle.a[edge] = -dy * sign;
+            triangle.b[edge] = dx * sign;
+            triangle.c[edge] = (dy * from.x - dx * from.y) * sign;
+            // Ties are broken by the edge direction so shared edges are only covered once
+            triangle.inclusive[edge] = triangle.a[edge] > 0.0f ||
+                                       (triangle.a[edge] == 0.0f && triangle.b[edge] > 0.0f);
+        }
+        const f32 total{triangle.a[0] * vertex(0).x + triangle.b[0] * vertex(0).y +
+                        triangle.c[0]};
+        if (total <= 0.0f) {
+            return;
+        }
+        triangle.inv_area = 1.0f / total;
+        triangle.vertices = vertices;
+        triangle.front_facing = front_facing;
+        const auto [min_x, max_x] = std::minmax({vertex(0).x, vertex(1).x, vertex(2).x});
+        const auto [min_y, max_y] = std::minmax({vertex(0).y, vertex(1).y, vertex(2).y});
+        const Rect& area_rect{state.render_area};
+        triangle.bounds = {
+            .min_x = std::max(area_rect.min_x, static_cast<s32>(std::floor(min_x))),
+            .min_y = std::max(area_rect.min_y, static_cast<s32>(std::floor(min_y))),
+            .max_x = std::min(area_rect.max_x, static_cast<s32>(std::ceil(max_x)) + 1),
+            .max_y = std::min(area_rect.max_y, static_cast<s32>(std::ceil(max_y)) + 1),
+        };
+        if (triangle.bounds.min_x >= triangle.bounds.max_x ||
+            triangle.bounds.min_y >= triangle.bounds.max_y) {
+            return;
+        }
+        state.triangles.push_back(triangle);
+    }};
+    std::vector<f32> clipped_varyings(num_varyings);
+    const auto triangle{[&](u32 instance, u32 e0, u32 e1, u32 e2) {
+        if (e0 == ~0U || e1 == ~0U || e2 == ~0U) {
+            return;
+        }
+        const std::array<size_t, 3> shaded{instance * num_vertices + e0,
+                                           instance * num_vertices + e1,
+                                           instance * num_vertices + e2};
+        u32 outside_mask{};
+        for (size_t index = 0; index < 3; ++index) {
+            const Vec4& position{state.positions[shaded[index]]};
+            for (size_t plane = 0; plane < planes.size(); ++plane) {
+                if (distance(planes[plane], position, plane) < 0.0f) {
+                    outside_mask |= 1U << plane;
+                }
+            }
+        }
+        if (outside_mask == 0) {
+            std::array<u32, 3> screen;
+            for (size_t index = 0; index < 3; ++index) {
+                u32& cached{projected[shaded[index]]};
+                if (cached == ~0U) {
+                    cached = project(state.positions[shaded[index]],
+                                     state.vertex_varyings.data() + shaded[index] * num_varyings);
+                }
+                screen[index] = cached;
+            }
+            setup(screen[0], screen[1], screen[2]);
+            return;
+        }
+        // Sutherland-Hodgman against the planes the triangle crosses
+        Polygon polygon{
+            {state.positions[shaded[0]], {1.0f, 0.0f, 0.0f}},
+            {state.positions[shaded[1]], {0.0f, 1.0f, 0.0f}},
+            {state.positions[shaded[2]], {0.0f, 0.0f, 1.0f}},
+        };
+        for (size_t plane = 0; plane < planes.size() && !polygon.empty(); ++plane) {
+            if (((outside_mask >> plane) & 1) == 0) {
+                continue;
+            }
+            Polygon result;
+            for (size_t index = 0; index < polygon.size(); ++index) {
+                const ClipVertex& current{polygon[index]};
+                const ClipVertex& next{polygon[(index + 1) % polygon.size()]};
+                const f32 d0{distance(planes[plane], current.position, plane)};
+                const f32 d1{distance(planes[plane], next.position, plane)};
+                if (d0 >= 0.0f) {
+                    result.push_back(current);
+                }
+                if ((d0 >= 0.0f) != (d1 >= 0.0f) && result.size() < result.capacity()) {
+                    const f32 t{d0 / (d0 - d1)};
+                    ClipVertex& vertex{result.emplace_back()};
+                    for (size_t i = 0; i < 4; ++i) {
+                        vertex.position[i] =
+                            current.position[i] + t * (next.position[i] - current.position[i]);
+                    }
+                    for (size_t i = 0; i < 3; ++i) {
+                        vertex.weights[i] =
+                            current.weights[i] + t * (next.weights[i] - current.weights[i]);
+                    }
+                }
+            }
+            polygon = result;
+        }
+        if (polygon.size() < 3) {
+            return;
+        }
+        boost::container::static_vector<u32, 12> screen;
+        for (const ClipVertex& vertex : polygon) {
+            for (size_t index = 0; index < num_varyings; ++index) {
+                f32 value{};
+                for (size_t i = 0; i < 3; ++i) {
+                    value += vertex.weights[i] *
+                             state.vertex_varyings[shaded[i] * num_varyings + index];
+                }
+                clipped_varyings[index] = value;
+            }
+            screen.push_back(project(vertex.position, clipped_varyings.data()));
+        }
+        for (size_t index = 1; index + 1 < screen.size(); ++index) {
+            setup(screen[0], screen[index], screen[index + 1]);
+        }
+    }};
+
+    const std::vector<u32>& elements{state.elements};
+    for (u32 instance = 0; instance < state.num_instances; ++instance) {
+        // Primitive restart splits the elements in separate strips and fans
+        size_t begin{};
+        while (begin < elements.size()) {
+            size_t end{begin};
+            while (end < elements.size() && elements[end] != ~0U) {
+                ++end;
+            }
+            const size_t count{end - begin};
+            const u32* const e{elements.data() + begin};
+            switch (state.topology) {
+            case Maxwell::PrimitiveTopology::Triangles:
+                for (size_t i = 0; i + 2 < count; i += 3) {
+                    triangle(instance, e[i], e[i + 1], e[i + 2]);
+                }
+                break;
+            case Maxwell::PrimitiveTopology::TriangleStrip:
+                for (size_t i = 0; i + 2 < count; ++i) {
+                    if (i % 2 == 0) {
+                        triangle(instance, e[i], e[i + 1], e[i + 2]);
+                    } else {
+                        triangle(instance, e[i + 1], e[i], e[i + 2]);
+                    }
+                }
+                break;
+            case Maxwell::PrimitiveTopology::TriangleFan:
+            case Maxwell::PrimitiveTopology::Polygon:
+                for (size_t i = 1; i + 1 < count; ++i) {
+                    triangle(instance, e[0], e[i], e[i + 1]);
+                }
+                break;
+            case Maxwell::PrimitiveTopology::Quads:
+                for (size_t i = 0; i + 3 < count; i += 4) {
+                    triangle(instance, e[i], e[i + 1], e[i + 2]);
+                    triangle(instance, e[i], e[i + 2], e[i + 3]);
+                }
+                break;
+            case Maxwell::PrimitiveTopology::QuadStrip:
+                for (size_t i = 0; i + 3 < count; i += 2) {
+                    triangle(instance, e[i], e[i + 1], e[i + 3]);
+                    triangle(instance, e[i], e[i + 3], e[i + 2]);
+                }
+                break;
+            default:
+                break;
+            }
+            begin = end + 1;
+        }
+    }
+}
+
+void RasterizerSoftware::RasterizeTiles(DrawState& state) {
+    const Rect& area{state.render_area};
+    state.tiles_x = (static_cast<u32>(area.max_x) + TILE_SIZE - 1) / TILE_SIZE;
+    state.tiles_y = (static_cast<u32>(area.max_y) + TILE_SIZE - 1) / TILE_SIZE;
+    state.bins.resize(static_cast<size_t>(state.tiles_x) * state.tiles_y);
+    for (u32 index = 0; index < static_cast<u32>(state.triangles.size()); ++index) {
+        const Rect& bounds{state.triangles[index].bounds};
+        const u32 tile_min_x{static_cast<u32>(bounds.min_x) / TILE_SIZE};
+        const u32 tile_min_y{static_cast<u32>(bounds.min_y) / TILE_SIZE};
+        const u32 tile_max_x{static_cast<u32>(bounds.max_x - 1) / TILE_SIZE};
+        const u32 tile_max_y{static_cast<u32>(bounds.max_y - 1) / TILE_SIZE};
+        for (u32 tile_y = tile_min_y; tile_y <= tile_max_y; ++tile_y) {
+            for (u32 tile_x = tile_min_x; tile_x <= tile_max_x; ++tile_x) {
+                state.bins[tile_y * state.tiles_x + tile_x].push_back(index);
+            }
+        }
+    }
+    std::vector<size_t> active_tiles;
+    for (size_t tile = 0; tile < state.bins.size(); ++tile) {
+        if (!state.bins[tile].empty()) {
+            active_tiles.push_back(tile);
+        }
+    }
+    RunParallel(active_tiles.size(), [&](size_t index) {
+        const auto start{std::chrono::steady_clock::now()};
+        RasterizeTile(state, active_tiles[index]);
+        const auto elapsed{std::chrono::steady_clock::now() - start};
+        const u64 nanoseconds{static_cast<u64>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count())};
+        timings.tile_nanoseconds += nanoseconds;
+        u64 max_nanoseconds{timings.max_tile_nanoseconds.load(std::memory_order_relaxed)};
+        while (nanoseconds > max_nanoseconds &&
+               !timings.max_tile_nanoseconds.compare_exchange_weak(max_nanoseconds, nanoseconds)) {
+        }
+    });
+    timings.tiles += active_tiles.size();
+    timings.triangles += state.triangles.size();
+}
+
+void RasterizerSoftware::RasterizeTile(const DrawState& state, size_t tile_index) {
+    const ShaderProgram* const fragment{state.programs->fragment.get()};
+    const Shader::Info* const info{fragment ? &fragment->Info() : nullptr};
+    const bool late_depth{info && info->stores_frag_depth};
+    const size_t num_varyings{state.varying_attributes.size()};
+
+    std::optional<ShaderProgram::Context> ctx;
+    std::unique_ptr<Invocation> invocation;
+    if (fragment) {
+        ctx.emplace(fragment->MakeContext());
+        invocation = std::make_unique<Invocation>();
+    }
+    const s32 tile_x{static_cast<s32>((tile_index % state.tiles_x) * TILE_SIZE)};
+    const s32 tile_y{static_cast<s32>((tile_index / state.tiles_x) * TILE_SIZE)};
+
+    const auto shade{[&](const Triangle& triangle, s32 x, s32 y, const std::array<f32, 3>& l) {
+        const ScreenVertex& v0{state.screen_vertices[triangle.vertices[0]]};
+        const ScreenVertex& v1{state.screen_vertices[triangle.vertices[1]]};
+        const ScreenVertex& v2{state.screen_vertices[triangle.vertices[2]]};
+        const f32 z{std::clamp(l[0] * v0.z + l[1] * v1.z + l[2] * v2.z, 0.0f, 1.0f)};
+        u8* const depth_texel{state.depth_surface ? state.depth_surface->Texel(x, y) : nullptr};
+        const PixelFormat depth_format{state.depth_surface ? state.depth_surface->info.format
+                                                           : PixelFormat::Invalid};
+        if (depth_texel && state.depth_test && !late_depth &&
+            !Compare(state.depth_func, z, ReadDepth(depth_format, depth_texel))) {
+            return;
+        }
+        f32 depth{z};
+        if (fragment) {
+            const f32 inv_w{l[0] * v0.inv_w + l[1] * v1.inv_w + l[2] * v2.inv_w};
+            const std::array<f32, 3> p{l[0] * v0.inv_w / inv_w, l[1] * v1.inv_w / inv_w,
+                                       l[2] * v2.inv_w / inv_w};
+            auto& inputs{invocation->inputs};
+            inputs[Attr(IR::Attribute::PositionX)] = static_cast<f32>(x) + 0.5f;
+            inputs[Attr(IR::Attribute::PositionY)] = static_cast<f32>(y) + 0.5f;
+            inputs[Attr(IR::Attribute::PositionZ)] = z;
+            inputs[Attr(IR::Attribute::PositionW)] = inv_w;
+            inputs[Attr(IR::Attribute::FrontFace)] = F(triangle.front_facing ? ~0U : 0U);
+            const f32* const a0{state.screen_varyings.data() + v0.varyings};
+            const f32* const a1{state.screen_varyings.data() + v1.varyings};
+            const f32* const a2{state.screen_varyings.data() + v2.varyings};
+            for (size_t index = 0; index < num_varyings; ++index) {
+                f32 value;
+                switch (state.varying_interpolation[index]) {
+                case Shader::Interpolation::Flat:
+                    value = a0[index];
+                    break;
+                case Shader::Interpolation::NoPerspective:
+                    value = l[0] * a0[index] + l[1] * a1[index] + l[2] * a2[index];
+                    break;
+                case Shader::Interpolation::Smooth:
+                default:
+                    value = p[0] * a0[index] + p[1] * a1[index] + p[2] * a2[index];
+                    break;
+                }
+                inputs[state.varying_attributes[index]] = value;
+            }
+            invocation->frag_color = {};
+            invocation->frag_depth = z;
+            invocation->demoted = false;
+            fragment->Execute(*ctx, *invocation, state.stages[1].resources);
+            if (invocation->demoted) {
+                return;
+            }
+            if (state.alpha_test &&
+                !Compare(state.alpha_func, invocation->frag_color[0][3], state.alpha_ref)) {
+                return;
+            }
+            depth = std::clamp(invocation->frag_depth, 0.0f, 1.0f);
+        }
+        if (depth_texel && state.depth_test && late_depth &&
+            !Compare(state.depth_func, depth, ReadDepth(depth_format, depth_texel))) {
+            return;
+        }
+        if (depth_texel && state.depth_write) {
+            WriteDepth(depth_format, depth, depth_texel);
+        }
+        if (!fragment) {
+            return;
+        }
+        for (size_t index = 0; index < state.num_color_targets; ++index) {
+            const ColorTarget& target{state.color_targets[index]};
+            if (!target.surface || !info->stores_frag_color[index]) {
+                continue;
+            }
+            u8* const texel{target.surface->Texel(x, y)};
+            const Vec4& src{invocation->frag_color[index]};
+            Vec4 color{src};
+            const bool write_all{target.mask[0] && target.mask[1] && target.mask[2] &&
+                                 target.mask[3]};
+            if ((target.blend.enable && !target.is_integer) || !write_all) {
+                const Vec4 dst{ReadTexel(target.format, texel)};
+                if (target.blend.enable && !target.is_integer) {
+                    const BlendState& blend{target.blend};
+                    const Vec4& src1{invocation->frag_color[1]};
+                    for (size_t c = 0; c < 4; ++c) {
+                        const bool is_alpha{c == 3 && blend.separate_alpha};
+                        const auto op{is_alpha ? blend.alpha_op : blend.color_op};
+                        const auto sf{is_alpha ? blend.alpha_source : blend.color_source};
+                        const auto df{is_alpha ? blend.alpha_dest : blend.color_dest};
+                        color[c] = BlendEquation(
+                            op, src[c], BlendFactor(sf, c, src, src1, dst, state.blend_color),
+                            dst[c], BlendFactor(df, c, src, src1, dst, state.blend_color));
+                    }
+                }
+                for (size_t c = 0; c < 4; ++c) {
+                    if (!target.mask[c]) {
+                        color[c] = dst[c];
+                    }
+                }
+            }
+            WriteTexel(target.format, color, texel);
+        }
+    }};
+
+    for (const u32 triangle_index : state.bins[tile_index]) {
+        const Triangle& triangle{state.triangles[triangle_index]};
+        const s32 min_x{std::max(triangle.bounds.min_x, tile_x)};
+        const s32 min_y{std::max(triangle.bounds.min_y, tile_y)};
+        const s32 max_x{std::min(triangle.bounds.max_x, tile_x + static_cast<s32>(TILE_SIZE))};
+        const s32 max_y{std::min(triangle.bounds.max_y, tile_y + static_cast<s32>(TILE_SIZE))};
+        // Pixels are walked in 2x2 quads, the edge functions of a quad are evaluated together
+        for (s32 y = min_y & ~1; y < max_y; y += 2) {
+            for (s32 x = min_x & ~1; x < max_x; x += 2) {
+                std::array<f32, 4> px{x + 0.5f, x + 1.5f, x + 0.5f, x + 1.5f};
+                std::array<f32, 4> py{y + 0.5f, y + 0.5f, y + 1.5f, y + 1.5f};
+                std::array<std::array<f32, 4>, 3> edges;
+                for (size_t edge = 0; edge < 3; ++edge) {
+                    for (size_t i = 0; i < 4; ++i) {
+                        edges[edge][i] =
+                            triangle.a[edge] * px[i] + triangle.b[edge] * py[i] + triangle.c[edge];
+                    }
+                }
+                for (size_t i = 0; i < 4; ++i) {
+                    const s32 pixel_x{x + static_cast<s32>(i & 1)};
+                    const s32 pixel_y{y + static_cast<s32>(i >> 1)};
+                    if (pixel_x < min_x || pixel_x >= max_x || pixel_y < min_y ||
+                        pixel_y >= max_y) {
+                        continue;
+                    }
+                    bool covered{true};
+                    for (size_t edge = 0; edge < 3; ++edge) {
+                        const f32 value{edges[edge][i]};
+                        covered &= value > 0.0f || (value == 0.0f && triangle.inclusive[edge]);
+                    }
+                    if (!covered) {
+                        continue;
+                    }
+                    const std::array<f32, 3> l{edges[0][i] * triangle.inv_area,
+                                               edges[1][i] * triangle.inv_area,
+                                               edges[2][i] * triangle.inv_area};
+                    shade(triangle, pixel_x, pixel_y, l);
+                }
+            }
+        }
+    }
+}
+
+void RasterizerSoftware::Draw(bool is_indexed, u32 instance_count) {
+    const GraphicsPrograms* const programs{shader_cache.CurrentPrograms()};
+    if (!programs || !programs->is_supported) {
+        if (!has_warned_programs) {
+            LOG_WARNING(Render_Software, "Skipping draws with unsupported shader programs");
+            has_warned_programs = true;
+        }
+        return;
+    }
+    const auto& regs{maxwell3d->regs};
+    const auto& draw_state{maxwell3d->draw_manager->GetDrawState()};
+    if (!IsTriangleTopology(draw_state.topology)) {
+        if (!has_warned_topology) {
+            LOG_WARNING(Render_Software, "Skipping draws with unsupported topology {}",
+                        static_cast<u32>(draw_state.topology));
+            has_warned_topology = true;
+        }
+        return;
+    }
+    ++timings.draws;
+
+    DrawState state;
+    state.programs = programs;
+    state.topology = draw_state.topology;
+    state.viewport = MakeViewport(regs);
+    if (programs->fragment) {
+        const Shader::Info& info{programs->fragment->Info()};
+        for (size_t attribute = 0; attribute < NUM_ATTRIBUTES; ++attribute) {
+            const bool is_generic{attribute >= Attr(IR::Attribute::Generic0X) &&
+                                  attribute < Attr(IR::Attribute::ColorFrontDiffuseR)};
+            if (!IsVarying(attribute) ||
+                !(info.loads.mask[attribute] || (is_generic && info.loads_indexed_attributes))) {
+                continue;
+            }
+            state.varying_attributes.push_back(attribute);
+            state.varying_interpolation.push_back(
+                is_generic ? info.interpolation[(attribute - Attr(IR::Attribute::Generic0X)) / 4]
+                           : Shader::Interpolation::Smooth);
+        }
+    }
+    // Guest memory is read before the surface lock is taken, reads flush rendered surfaces
+    FetchVertices(state, is_indexed, instance_count);
+    if (state.vertex_ids.empty()) {
+        return;
+    }
+    ReadConstantBuffers(state, 0, *programs->vertex);
+    if (programs->fragment) {
+        ReadConstantBuffers(state, 1, *programs->fragment);
+    }
+
+    std::scoped_lock lock{surface_cache.mutex};
+    u32 width{std::numeric_limits<u32>::max()};
+    u32 height{std::numeric_limits<u32>::max()};
+    state.num_color_targets = std::min<u32>(regs.rt_control.count, Maxwell::NumRenderTargets);
+    for (u32 index = 0; index < state.num_color_targets; ++index) {
+        const auto& rt{regs.rt[regs.rt_control.Map(index)]};
+        if (rt.Address() == 0 || rt.format == Tegra::RenderTargetFormat::NONE) {
+            continue;
+        }
+        const VideoCommon::ImageInfo info(rt, regs.anti_alias_samples_mode);
+        Surface* const surface{surface_cache.Get(*gpu_memory, rt.Address(), info, true)};
+        if (!surface) {
+            continue;
+        }
+        const auto& mask{regs.color_mask[regs.color_mask_common != 0 ? 0 : index]};
+        ColorTarget& target{state.color_targets[index]};
+        target.surface = surface;
+        target.format = surface->info.format;
+        target.blend = MakeBlendState(regs, index);
+        target.mask = {mask.R != 0, mask.G != 0, mask.B != 0, mask.A != 0};
+        target.is_integer = VideoCore::Surface::IsPixelFormatInteger(target.format);
+        width = std::min(width, surface->width);
+        height = std::min(height, surface->height);
+    }
+    if (regs.zeta_enable != 0 && regs.zeta.Address() != 0) {
+        const VideoCommon::ImageInfo info(regs.zeta, regs.zeta_size, regs.anti_alias_samples_mode);
+        state.depth_surface = surface_cache.Get(*gpu_memory, regs.zeta.Address(), info, true);
+        if (state.depth_surface) {
+            width = std::min(width, state.depth_surface->width);
+            height = std::min(height, state.depth_surface->height);
+        }
+    }
+    if (width == std::numeric_limits<u32>::max()) {
+        return;
+    }
+    state.render_area = ScissorRect(regs, width, height);
+    if (state.render_area.min_x >= state.render_area.max_x ||
+        state.render_area.min_y >= state.render_area.max_y) {
+        return;
+    }
+    state.depth_test = regs.depth_test_enable != 0;
+    state.depth_write = regs.depth_test_enable != 0 && regs.depth_write_enabled != 0;
+    state.depth_func = regs.depth_test_func;
+    state.alpha_test = regs.alpha_test_enabled != 0;
+    state.alpha_func = regs.alpha_test_func;
+    state.alpha_ref = regs.alpha_test_ref;
+    state.blend_color = {regs.blend_color.r, regs.blend_color.g, regs.blend_color.b,
+                         regs.blend_color.a};
+
+    BindResources(state, 0, *programs->vertex);
+    if (programs->fragment) {
+        BindResources(state, 1, *programs->fragment);
+    }
+    ShadeVertices(state);
+    AssembleTriangles(state);
+    if (state.triangles.empty()) {
+        return;
+    }
+    for (u32 index = 0; index < state.num_color_targets; ++index) {
+        if (state.color_targets[index].surface) {
+            surface_cache.MarkDirty(*state.color_targets[index].surface);
+        }
+    }
+    if (state.depth_surface && state.depth_write) {
+        surface_cache.MarkDirty(*state.depth_surface);
+    }
+    RasterizeTiles(state);
+}
+
+void RasterizerSoftware::DrawTexture() {
+    if (!has_warned_draw_texture) {
+        LOG_WARNING(Render_Software, "DrawTexture is not implemented");
+        has_warned_draw_texture = true;
+    }
+}
+
+void RasterizerSoftware::Clear(u32 layer_count) {
+    const auto& regs{maxwell3d->regs};
+    const bool use_color{regs.clear_surface.R || regs.clear_surface.G || regs.clear_surface.B ||
+                         regs.clear_surface.A};
+    const bool use_depth{regs.clear_surface.Z != 0};
+    const bool use_stencil{regs.clear_surface.S != 0};
+    if (!use_color && !use_depth && !use_stencil) {
+        return;
+    }
+    gpu_memory->FlushCaching();
+
+    std::scoped_lock lock{surface_cache.mutex};
+    const auto clear_surface{[&](Surface& surface, const std::function<void(u8*)>& clear_texel) {
+        Rect rect{0, 0, static_cast<s32>(surface.width), static_cast<s32>(surface.height)};
+        if (regs.clear_control.use_scissor != 0) {
+            rect = ScissorRect(regs, surface.width, surface.height);
+        }
+        if (rect.min_x >= rect.max_x || rect.min_y >= rect.max_y) {
+            return;
+        }
+        for (s32 y = rect.min_y; y < rect.max_y; ++y) {
+            for (s32 x = rect.min_x; x < rect.max_x; ++x) {
+                clear_texel(surface.Texel(x, y));
+            }
+        }
+        surface_cache.MarkDirty(surface);
+    }};
+    const bool full_clear{regs.clear_control.use_scissor == 0 || regs.scissor_test[0].enable == 0};
+
+    if (use_color) {
+        const auto& rt{regs.rt[regs.clear_surface.RT]};
+        if (rt.Address() != 0 && rt.format != Tegra::RenderTargetFormat::NONE) {
+            const VideoCommon::ImageInfo info(rt, regs.anti_alias_samples_mode);
+            const bool all_components{regs.clear_surface.R && regs.clear_surface.G &&
+                                      regs.clear_surface.B && regs.clear_surface.A};
+            Surface* const surface{surface_cache.Get(*gpu_memory, rt.Address(), info,
+                                                     !(full_clear && all_components))};
+            if (surface) {
+                const PixelFormat format{surface->info.format};
+                Vec4 clear_color{regs.clear_color};
+                if (VideoCore::Surface::IsPixelFormatInteger(format)) {
+                    const bool is_signed{VideoCore::Surface::IsPixelFormatSignedInteger(format)};
+                    for (f32& component : clear_color) {
+                        component = F(is_signed ? static_cast<u32>(static_cast<s32>(component))
+                                                : static_cast<u32>(component));
+                    }
+                }
+                const std::array<bool, 4> mask{
+                    regs.clear_surface.R != 0, regs.clear_surface.G != 0,
+                    regs.clear_surface.B != 0, regs.clear_surface.A != 0};
+                clear_surface(*surface, [&](u8* texel) {
+                    Vec4 color{clear_color};
+                    if (!all_components) {
+                        const Vec4 dst{ReadTexel(format, texel)};
+                        for (size_t c = 0; c < 4; ++c) {
+                            color[c] = mask[c] ? color[c] : dst[c];
+                        }
+                    }
+                    WriteTexel(format, color, texel);
+                });
+            }
+        }
+    }
+    if ((use_depth || use_stencil) && regs.zeta_enable != 0 && regs.zeta.Address() != 0) {
+        const VideoCommon::ImageInfo info(regs.zeta, regs.zeta_size, regs.anti_alias_samples_mode);
+        const bool has_stencil{
+            VideoCore::Surface::GetFormatType(info.format) ==
+            VideoCore::Surface::SurfaceType::DepthStencil};
+        const bool overwrite{full_clear && use_depth && (use_stencil || !has_stencil)};
+        Surface* const surface{surface_cache.Get(*gpu_memory, regs.zeta.Address(), info,
+                                                 !overwrite)};
+        if (surface) {
+            const PixelFormat format{surface->info.format};
+            const u8 stencil{static_cast<u8>(regs.clear_stencil)};
+            clear_surface(*surface, [&](u8* texel) {
+                if (use_depth) {
+                    WriteDepth(format, regs.clear_depth, texel);
+                }
+                if (use_stencil) {
+                    WriteStencil(format, stencil, texel);
+                }
+            });
+        }
+    }
+}
+
+void RasterizerSoftware::DispatchCompute() {
+    if (!has_warned_compute) {
+        LOG_WARNING(Render_Software, "Compute dispatches are not implemented");
+        has_warned_compute = true;
+    }
+}
+
+void RasterizerSoftware::ResetCounter(VideoCommon::QueryType type) {}
+
+void RasterizerSoftware::Query(GPUVAddr gpu_addr, VideoCommon::QueryType type,
+                               VideoCommon::QueryPropertiesFlags flags, u32 payload,
+                               u32 subreport) {
+    if (!gpu_memory) {
+        return;
+    }
+    if (True(flags & VideoCommon::QueryPropertiesFlags::HasTimeout)) {
+        u64 ticks = gpu.GetTicks();
+        gpu_memory->Write<u64>(gpu_addr + 8, ticks);
+        gpu_memory->Write<u64>(gpu_addr, static_cast<u64>(payload));
+    } else {
+        gpu_memory->Write<u32>(gpu_addr, payload);
+    }
+}
+
+void RasterizerSoftware::BindGraphicsUniformBuffer(size_t stage, u32 index, GPUVAddr gpu_addr,
+                                                   u32 size) {}
+
+void RasterizerSoftware::DisableGraphicsUniformBuffer(size_t stage, u32 index) {}
+
+void RasterizerSoftware::FlushAll() {
+    std::scoped_lock lock{surface_cache.mutex};
+    surface_cache.FlushAll();
+}
+
+void RasterizerSoftware::FlushRegion(DAddr addr, u64 size, VideoCommon::CacheType which) {
+    if (False(which & VideoCommon::CacheType::TextureCache)) {
+        return;
+    }
+    std::scoped_lock lock{surface_cache.mutex};
+    surface_cache.FlushRegion(addr, size);
+}
+
+bool RasterizerSoftware::MustFlushRegion(DAddr addr, u64 size, VideoCommon::CacheType which) {
+    if (False(which & VideoCommon::CacheType::TextureCache)) {
+        return false;
+    }
+    std::scoped_lock lock{surface_cache.mutex};
+    return surface_cache.MustFlush(addr, size);
+}
+
+void RasterizerSoftware::InvalidateRegion(DAddr addr, u64 size, VideoCommon::CacheType which) {
+    if (True(which & VideoCommon::CacheType::TextureCache)) {
+        std::scoped_lock lock{surface_cache.mutex};
+        surface_cache.Invalidate(addr, size);
+        texture_cache.Invalidate(addr, size);
+    }
+    if (True(which & VideoCommon::CacheType::ShaderCache)) {
+        shader_cache.InvalidateRegion(addr, size);
+    }
+}
+
+void RasterizerSoftware::OnCacheInvalidation(DAddr addr, u64 size) {
+    {
+        std::scoped_lock lock{surface_cache.mutex};
+        surface_cache.Invalidate(addr, size);
+        texture_cache.Invalidate(addr, size);
+    }
+    shader_cache.OnCacheInvalidation(addr, size);
+}
+
+bool RasterizerSoftware::OnCPUWrite(DAddr addr, u64 size) {
+    {
+        std::scoped_lock lock{surface_cache.mutex};
+        if (surface_cache.MustFlush(addr, size)) {
+            return true;
+        }
+        surface_cache.Invalidate(addr, size);
+        texture_cache.Invalidate(addr, size);
+    }
+    shader_cache.OnCacheInvalidation(addr, size);
+    return false;
+}
+
+RasterizerDownloadArea RasterizerSoftware::GetFlushArea(DAddr addr, u64 size) {
+    RasterizerDownloadArea new_area{
+        .startAddress = Common::AlignDown(addr, Core::DEVICE_PAGESIZE),
+        .endAddress = Common::AlignUp(addr + size, Core::DEVICE_PAGESIZE),
+        .preemtive = true,
+    };
+    return new_area;
+}
+
+void RasterizerSoftware::InvalidateGPUCache() {
+    shader_cache.SyncGuestHost();
+}
+
+void RasterizerSoftware::UnmapMemory(DAddr addr, u64 size) {
+    {
+        std::scoped_lock lock{surface_cache.mutex};
+        surface_cache.Invalidate(addr, size);
+        texture_cache.Invalidate(addr, size);
+    }
+    shader_cache.OnCacheInvalidation(addr, size);
+}
+
+void RasterizerSoftware::ModifyGPUMemory(size_t as_id, GPUVAddr addr, u64 size) {
+    std::scoped_lock lock{surface_cache.mutex};
+    surface_cache.InvalidateGpu(addr, size);
+    texture_cache.InvalidateGpu(addr, size);
+}
+
+void RasterizerSoftware::SignalFence(std::function<void()>&& func) {
+    func();
+}
+
+void RasterizerSoftware::SyncOperation(std::function<void()>&& func) {
+    func();
+}
+
+void RasterizerSoftware::SignalSyncPoint(u32 value) {
+    auto& syncpoint_manager = gpu.Host1x().GetSyncpointManager();
+    syncpoint_manager.IncrementGuest(value);
+    syncpoint_manager.IncrementHost(value);
+}
+
+void RasterizerSoftware::SignalReference() {}
+
+void RasterizerSoftware::ReleaseFences(bool) {}
+
+void RasterizerSoftware::FlushAndInvalidateRegion(DAddr addr, u64 size,
+                                                  VideoCommon::CacheType which) {
+    FlushRegion(addr, size, which);
+    InvalidateRegion(addr, size, which);
+}
+
+void RasterizerSoftware::WaitForIdle() {}
+
+void RasterizerSoftware::FragmentBarrier() {}
+
+void RasterizerSoftware::TiledCacheBarrier() {}
+
+void RasterizerSoftware::FlushCommands() {}
+
+void RasterizerSoftware::TickFrame() {
+    const u64 tiles{timings.tiles.exchange(0)};
+    const u64 tile_nanoseconds{timings.tile_nanoseconds.exchange(0)};
+    LOG_DEBUG(Render_Software,
+              "{} draws, {} triangles, vertices {} us, {} tiles in {} us (average {} us, "
+              "slowest {} us)",
+              timings.draws.exchange(0), timings.triangles.exchange(0),
+              timings.vertex_nanoseconds.exchange(0) / 1000, tiles, tile_nanoseconds / 1000,
+              tiles != 0 ? tile_nanoseconds / tiles / 1000 : 0,
+              timings.max_tile_nanoseconds.exchange(0) / 1000);
+    texture_cache.TickFrame();
+}
+
+bool RasterizerSoftware::AccelerateSurfaceCopy(const Tegra::Engines::Fermi2D::Surface& src,
+                                               const Tegra::Engines::Fermi2D::Surface& dst,
+                                               const Tegra::Engines::Fermi2D::Config& copy_config) {
+    return false;
+}
+
+Tegra::Engines::AccelerateDMAInterface& RasterizerSoftware::AccessAccelerateDMA() {
+    return accelerate_dma;
+}
+
+void RasterizerSoftware::AccelerateInlineToMemory(GPUVAddr address, size_t copy_size,
+                                                  std::span<const u8> memory) {
+    const std::optional<DAddr> device_addr{gpu_memory->GpuToCpuAddress(address, copy_size)};
+    if (device_addr) {
+        FlushRegion(*device_addr, copy_size);
+    }
+    gpu_memory->WriteBlockUnsafe(address, memory.data(), copy_size);
+    if (device_addr) {
+        InvalidateRegion(*device_addr, copy_size);
+    }
+}
+
+void RasterizerSoftware::LoadDiskResources(u64 title_id, std::stop_token stop_loading,
+                                           const VideoCore::DiskResourceLoadCallback& callback) {}
+
+void RasterizerSoftware::InitializeChannel(Tegra::Control::ChannelState& channel) {
+    CreateChannel(channel);
+    shader_cache.CreateChannel(channel);
+}
+
+void RasterizerSoftware::BindChannel(Tegra::Control::ChannelState& channel) {
+    BindToChannel(channel.bind_id);
+    shader_cache.BindToChannel(channel.bind_id);
+}
+
+void RasterizerSoftware::ReleaseChannel(s32 channel_id) {
+    EraseChannel(channel_id);
+    shader_cache.EraseChannel(channel_id);
+}
+
+} // namespace Software
@@ -0,0 +1,150 @@
+// SPDX-FileCopyrightText: Copyright 2024 yuzu Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "yuzu_common/common_types.h"
+#include "yuzu_common/thread_worker.h"
+#include "yuzu_video_core/control/channel_state_cache.h"
+#include "yuzu_video_core/engines/maxwell_dma.h"
+#include "yuzu_video_core/host1x/gpu_device_memory_manager.h"
+#include "yuzu_video_core/rasterizer_interface.h"
+#include "yuzu_video_core/renderer_software/sw_shader_cache.h"
+#include "yuzu_video_core/renderer_software/sw_surface_cache.h"
+#include "yuzu_video_core/renderer_software/sw_texture.h"
+
+namespace Tegra {
+class GPU;
+}
+
+namespace Software {
+
+struct DrawState;
+
+class AccelerateDMA : public Tegra::Engines::AccelerateDMAInterface {
+public:
+    bool BufferCopy(GPUVAddr start_address, GPUVAddr end_address, u64 amount) override {
+        return false;
+    }
+    bool BufferClear(GPUVAddr src_address, u64 amount, u32 value) override {
+        return false;
+    }
+    bool ImageToBuffer(const Tegra::DMA::ImageCopy& copy_info, const Tegra::DMA::ImageOperand& src,
+                       const Tegra::DMA::BufferOperand& dst) override {
+        return false;
+    }
+    bool BufferToImage(const Tegra::DMA::ImageCopy& copy_info, const Tegra::DMA::BufferOperand& src,
+                       const Tegra::DMA::ImageOperand& dst) override {
+        return false;
+    }
+};
+
+/// Rasterizer running the guest shaders on the CPU.
+///
+/// Vertices are shaded in parallel chunks, triangles are clipped and set up on the GPU thread and
+/// binned into screen tiles. Tiles are rasterized in parallel, each of them is only touched by a
+/// single worker so no synchronization is needed between fragments of a draw.
+class RasterizerSoftware final : public VideoCore::RasterizerInterface,
+                                 protected VideoCommon::ChannelSetupCaches<VideoCommon::ChannelInfo> {
+public:
+    explicit RasterizerSoftware(Tegra::GPU& gpu, Tegra::MaxwellDeviceMemoryManager& device_memory);
+    ~RasterizerSoftware() override;
+
+    void Draw(bool is_indexed, u32 instance_count) override;
+    void DrawTexture() override;
+    void Clear(u32 layer_count) override;
+    void DispatchCompute() override;
+    void ResetCounter(VideoCommon::QueryType type) override;
+    void Query(GPUVAddr gpu_addr, VideoCommon::QueryType type,
+               VideoCommon::QueryPropertiesFlags flags, u32 payload, u32 subreport) override;
+    void BindGraphicsUniformBuffer(size_t stage, u32 index, GPUVAddr gpu_addr, u32 size) override;
+    void DisableGraphicsUniformBuffer(size_t stage, u32 index) override;
+    void FlushAll() override;
+    void FlushRegion(DAddr addr, u64 size,
+                     VideoCommon::CacheType which = VideoCommon::CacheType::All) override;
+    bool MustFlushRegion(DAddr addr, u64 size,
+                         VideoCommon::CacheType which = VideoCommon::CacheType::All) override;
+    void InvalidateRegion(DAddr addr, u64 size,
+                          VideoCommon::CacheType which = VideoCommon::CacheType::All) override;
+    void OnCacheInvalidation(DAddr addr, u64 size) override;
+    bool OnCPUWrite(DAddr addr, u64 size) override;
+    RasterizerDownloadArea GetFlushArea(DAddr addr, u64 size) override;
+    void InvalidateGPUCache() override;
+    void UnmapMemory(DAddr addr, u64 size) override;
+    void ModifyGPUMemory(size_t as_id, GPUVAddr addr, u64 size) override;
+    void SignalFence(std::function<void()>&& func) override;
+    void SyncOperation(std::function<void()>&& func) override;
+    void SignalSyncPoint(u32 value) override;
+    void SignalReference() override;
+    void ReleaseFences(bool force) override;
+    void FlushAndInvalidateRegion(
+        DAddr addr, u64 size, VideoCommon::CacheType which = VideoCommon::CacheType::All) override;
+    void WaitForIdle() override;
+    void FragmentBarrier() override;
+    void TiledCacheBarrier() override;
+    void FlushCommands() override;
+    void TickFrame() override;
+    bool AccelerateSurfaceCopy(const Tegra::Engines::Fermi2D::Surface& src,
+                               const Tegra::Engines::Fermi2D::Surface& dst,
+                               const Tegra::Engines::Fermi2D::Config& copy_config) override;
+    Tegra::Engines::AccelerateDMAInterface& AccessAccelerateDMA() override;
+    void AccelerateInlineToMemory(GPUVAddr address, size_t copy_size,
+                                  std::span<const u8> memory) override;
+    void LoadDiskResources(u64 title_id, std::stop_token stop_loading,
+                           const VideoCore::DiskResourceLoadCallback& callback) override;
+    void InitializeChannel(Tegra::Control::ChannelState& channel) override;
+    void BindChannel(Tegra::Control::ChannelState& channel) override;
+    void ReleaseChannel(s32 channel_id) override;
+
+private:
+    /// Time spent rasterizing tiles since the last frame, reported at the end of each frame
+    struct TileTimings {
+        std::atomic<u64> draws{};
+        std::atomic<u64> triangles{};
+        std::atomic<u64> tiles{};
+        std::atomic<u64> tile_nanoseconds{};
+        std::atomic<u64> max_tile_nanoseconds{};
+        std::atomic<u64> vertex_nanoseconds{};
+    };
+
+    /// Runs a task for each index in [0, count) on the workers and the calling thread.
+    void RunParallel(size_t count, const std::function<void(size_t)>& task);
+
+    /// Reads the constant buffers of a stage, must be called without the surface lock held.
+    void ReadConstantBuffers(DrawState& state, size_t stage_index, const ShaderProgram& program);
+
+    /// Binds the storage buffers and textures of a stage, the surface lock must be held.
+    void BindResources(DrawState& state, size_t stage_index, const ShaderProgram& program);
+
+    /// Reads the indices and vertex streams, must be called without the surface lock held.
+    void FetchVertices(DrawState& state, bool is_indexed, u32 instance_count);
+
+    void ShadeVertices(DrawState& state);
+
+    void AssembleTriangles(DrawState& state);
+
+    void RasterizeTiles(DrawState& state);
+
+    void RasterizeTile(const DrawState& state, size_t tile_index);
+
+    Tegra::GPU& gpu;
+    Tegra::MaxwellDeviceMemoryManager& device_memory;
+    AccelerateDMA accelerate_dma;
+    TextureCache texture_cache{device_memory};
+    SurfaceCache surface_cache{texture_cache, device_memory};
+    ShaderCache shader_cache;
+    size_t num_workers;
+    Common::ThreadWorker workers;
+    TileTimings timings;
+    bool has_warned_topology{};
+    bool has_warned_programs{};
+    bool has_warned_draw_texture{};
+    bool has_warned_compute{};
+};
+
+} // namespace Software
@@ -0,0 +1,1312 @@
+// SPDX-FileCopyrightText: Copyright 2024 yuzu Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <map>
+#include <unordered_map>
+
+#include "yuzu_common/bit_cast.h"
+#include "yuzu_common/logging/log.h"
+#include "yuzu_shader_recompiler/frontend/ir/abstract_syntax_list.h"
+#include "yuzu_shader_recompiler/frontend/ir/basic_block.h"
+#include "yuzu_shader_recompiler/frontend/ir/modifiers.h"
+#include "yuzu_shader_recompiler/frontend/ir/program.h"
+#include "yuzu_shader_recompiler/frontend/ir/value.h"
+#include "yuzu_video_core/memory_manager.h"
+#include "yuzu_video_core/renderer_software/sw_shader.h"
+
+namespace Software {
+namespace {
+namespace IR = Shader::IR;
+using IR::Opcode;
+
+/// Backward jumps an invocation can take before its loops are forcibly exited
+constexpr u32 LOOP_SAFETY_JUMPS = 0x2000;
+
+constexpr std::array<f32, 4> FSWZ_A{-1.0f, 1.0f, -1.0f, 0.0f};
+constexpr std::array<f32, 4> FSWZ_B{-1.0f, -1.0f, 1.0f, -1.0f};
+
+f32 F(u32 value) noexcept {
+    return Common::BitCast<f32>(value);
+}
+
+u32 U(f32 value) noexcept {
+    return Common::BitCast<u32>(value);
+}
+
+s32 S(u32 value) noexcept {
+    return static_cast<s32>(value);
+}
+
+u32 B(bool value) noexcept {
+    return value ? 1U : 0U;
+}
+
+template <typename T>
+u32 ConvertToInt(f32 value) noexcept {
+    if (std::isnan(value)) {
+        return 0;
+    }
+    constexpr f32 min{static_cast<f32>(std::numeric_limits<T>::min())};
+    constexpr f32 max{static_cast<f32>(std::numeric_limits<T>::max())};
+    if (value <= min) {
+        return static_cast<u32>(std::numeric_limits<T>::min());
+    }
+    if (value >= max) {
+        return static_cast<u32>(std::numeric_limits<T>::max());
+    }
+    return static_cast<u32>(static_cast<T>(value));
+}
+
+u32 BitFieldMask(u32 count) noexcept {
+    return count >= 32 ? ~0U : (1U << count) - 1;
+}
+
+bool IsImageOpcode(Opcode opcode) noexcept {
+    switch (opcode) {
+    case Opcode::ImageSampleImplicitLod:
+    case Opcode::ImageSampleExplicitLod:
+    case Opcode::ImageSampleDrefImplicitLod:
+    case Opcode::ImageSampleDrefExplicitLod:
+    case Opcode::ImageGather:
+    case Opcode::ImageGatherDref:
+    case Opcode::ImageFetch:
+    case Opcode::ImageQueryDimensions:
+    case Opcode::ImageQueryLod:
+    case Opcode::ImageGradient:
+        return true;
+    default:
+        return false;
+    }
+}
+
+bool IsSupportedOpcode(Opcode opcode) noexcept {
+    if (IsImageOpcode(opcode)) {
+        return true;
+    }
+    switch (opcode) {
+    case Opcode::ConditionRef:
+    case Opcode::DemoteToHelperInvocation:
+    case Opcode::GetCbufU8:
+    case Opcode::GetCbufS8:
+    case Opcode::GetCbufU16:
+    case Opcode::GetCbufS16:
+    case Opcode::GetCbufU32:
+    case Opcode::GetCbufF32:
+    case Opcode::GetCbufU32x2:
+    case Opcode::GetAttribute:
+    case Opcode::GetAttributeU32:
+    case Opcode::SetAttribute:
+    case Opcode::GetAttributeIndexed:
+    case Opcode::SetAttributeIndexed:
+    case Opcode::SetFragColor:
+    case Opcode::SetFragDepth:
+    case Opcode::WorkgroupId:
+    case Opcode::LocalInvocationId:
+    case Opcode::InvocationId:
+    case Opcode::InvocationInfo:
+    case Opcode::SampleId:
+    case Opcode::IsHelperInvocation:
+    case Opcode::YDirection:
+    case Opcode::ResolutionDownFactor:
+    case Opcode::RenderArea:
+    case Opcode::UndefU1:
+    case Opcode::UndefU8:
+    case Opcode::UndefU16:
+    case Opcode::UndefU32:
+    case Opcode::LoadLocal:
+    case Opcode::WriteLocal:
+    case Opcode::LoadStorageU8:
+    case Opcode::LoadStorageS8:
+    case Opcode::LoadStorageU16:
+    case Opcode::LoadStorageS16:
+    case Opcode::LoadStorage32:
+    case Opcode::LoadStorage64:
+    case Opcode::LoadStorage128:
+    case Opcode::WriteStorageU8:
+    case Opcode::WriteStorageS8:
+    case Opcode::WriteStorageU16:
+    case Opcode::WriteStorageS16:
+    case Opcode::WriteStorage32:
+    case Opcode::WriteStorage64:
+    case Opcode::WriteStorage128:
+    case Opcode::CompositeConstructU32x2:
+    case Opcode::CompositeConstructU32x3:
+    case Opcode::CompositeConstructU32x4:
+    case Opcode::CompositeExtractU32x2:
+    case Opcode::CompositeExtractU32x3:
+    case Opcode::CompositeExtractU32x4:
+    case Opcode::CompositeInsertU32x2:
+    case Opcode::CompositeInsertU32x3:
+    case Opcode::CompositeInsertU32x4:
+    case Opcode::CompositeConstructF32x2:
+    case Opcode::CompositeConstructF32x3:
+    case Opcode::CompositeConstructF32x4:
+    case Opcode::CompositeExtractF32x2:
+    case Opcode::CompositeExtractF32x3:
+    case Opcode::CompositeExtractF32x4:
+    case Opcode::CompositeInsertF32x2:
+    case Opcode::CompositeInsertF32x3:
+    case Opcode::CompositeInsertF32x4:
+    case Opcode::SelectU1:
+    case Opcode::SelectU8:
+    case Opcode::SelectU16:
+    case Opcode::SelectU32:
+    case Opcode::SelectF32:
+    case Opcode::BitCastU32F32:
+    case Opcode::BitCastF32U32:
+    case Opcode::PackUint2x32:
+    case Opcode::UnpackUint2x32:
+    case Opcode::PackHalf2x16:
+    case Opcode::UnpackHalf2x16:
+    case Opcode::GetSparseFromOp:
+    case Opcode::GetInBoundsFromOp:
+    case Opcode::FPAbs32:
+    case Opcode::FPAdd32:
+    case Opcode::FPFma32:
+    case Opcode::FPMax32:
+    case Opcode::FPMin32:
+    case Opcode::FPMul32:
+    case Opcode::FPNeg32:
+    case Opcode::FPRecip32:
+    case Opcode::FPRecipSqrt32:
+    case Opcode::FPSqrt:
+    case Opcode::FPSin:
+    case Opcode::FPExp2:
+    case Opcode::FPCos:
+    case Opcode::FPLog2:
+    case Opcode::FPSaturate32:
+    case Opcode::FPClamp32:
+    case Opcode::FPRoundEven32:
+    case Opcode::FPFloor32:
+    case Opcode::FPCeil32:
+    case Opcode::FPTrunc32:
+    case Opcode::FPOrdEqual32:
+    case Opcode::FPUnordEqual32:
+    case Opcode::FPOrdNotEqual32:
+    case Opcode::FPUnordNotEqual32:
+    case Opcode::FPOrdLessThan32:
+    case Opcode::FPUnordLessThan32:
+    case Opcode::FPOrdGreaterThan32:
+    case Opcode::FPUnordGreaterThan32:
+    case Opcode::FPOrdLessThanEqual32:
+    case Opcode::FPUnordLessThanEqual32:
+    case Opcode::FPOrdGreaterThanEqual32:
+    case Opcode::FPUnordGreaterThanEqual32:
+    case Opcode::FPIsNan32:
+    case Opcode::IAdd32:
+    case Opcode::ISub32:
+    case Opcode::IMul32:
+    case Opcode::SDiv32:
+    case Opcode::UDiv32:
+    case Opcode::INeg32:
+    case Opcode::IAbs32:
+    case Opcode::ShiftLeftLogical32:
+    case Opcode::ShiftRightLogical32:
+    case Opcode::ShiftRightArithmetic32:
+    case Opcode::BitwiseAnd32:
+    case Opcode::BitwiseOr32:
+    case Opcode::BitwiseXor32:
+    case Opcode::BitFieldInsert:
+    case Opcode::BitFieldSExtract:
+    case Opcode::BitFieldUExtract:
+    case Opcode::BitReverse32:
+    case Opcode::BitCount32:
+    case Opcode::BitwiseNot32:
+    case Opcode::FindSMsb32:
+    case Opcode::FindUMsb32:
+    case Opcode::SMin32:
+    case Opcode::UMin32:
+    case Opcode::SMax32:
+    case Opcode::UMax32:
+    case Opcode::SClamp32:
+    case Opcode::UClamp32:
+    case Opcode::SLessThan:
+    case Opcode::ULessThan:
+    case Opcode::IEqual:
+    case Opcode::SLessThanEqual:
+    case Opcode::ULessThanEqual:
+    case Opcode::SGreaterThan:
+    case Opcode::UGreaterThan:
+    case Opcode::INotEqual:
+    case Opcode::SGreaterThanEqual:
+    case Opcode::UGreaterThanEqual:
+    case Opcode::LogicalOr:
+    case Opcode::LogicalAnd:
+    case Opcode::LogicalXor:
+    case Opcode::LogicalNot:
+    case Opcode::ConvertS16F32:
+    case Opcode::ConvertS32F32:
+    case Opcode::ConvertU16F32:
+    case Opcode::ConvertU32F32:
+    case Opcode::ConvertF32S8:
+    case Opcode::ConvertF32S16:
+    case Opcode::ConvertF32S32:
+    case Opcode::ConvertF32U8:
+    case Opcode::ConvertF32U16:
+    case Opcode::ConvertF32U32:
+    case Opcode::IsTextureScaled:
+    case Opcode::IsImageScaled:
+    case Opcode::LaneId:
+    case Opcode::VoteAll:
+    case Opcode::VoteAny:
+    case Opcode::VoteEqual:
+    case Opcode::SubgroupBallot:
+    case Opcode::SubgroupEqMask:
+    case Opcode::SubgroupLtMask:
+    case Opcode::SubgroupLeMask:
+    case Opcode::SubgroupGtMask:
+    case Opcode::SubgroupGeMask:
+    case Opcode::ShuffleIndex:
+    case Opcode::ShuffleUp:
+    case Opcode::ShuffleDown:
+    case Opcode::ShuffleButterfly:
+    case Opcode::FSwizzleAdd:
+    case Opcode::DPdxFine:
+    case Opcode::DPdyFine:
+    case Opcode::DPdxCoarse:
+    case Opcode::DPdyCoarse:
+        return true;
+    default:
+        return false;
+    }
+}
+
+/// Instructions that have no effect on a single invocation run by the interpreter
+bool IsNoOpcode(Opcode opcode) noexcept {
+    switch (opcode) {
+    case Opcode::Phi:
+    case Opcode::Identity:
+    case Opcode::Void:
+    case Opcode::Reference:
+    case Opcode::Prologue:
+    case Opcode::Epilogue:
+    case Opcode::Join:
+    case Opcode::Barrier:
+    case Opcode::WorkgroupMemoryBarrier:
+    case Opcode::DeviceMemoryBarrier:
+    case Opcode::SetSampleMask:
+    case Opcode::GetZeroFromOp:
+    case Opcode::GetSignFromOp:
+    case Opcode::GetCarryFromOp:
+    case Opcode::GetOverflowFromOp:
+        return true;
+    default:
+        return false;
+    }
+}
+
+struct TextureCoords {
+    std::array<f32, 3> uvw{};
+    s32 layer{};
+};
+
+TextureCoords ResolveCoords(Shader::TextureType type, const ShaderProgram::Register& coords) {
+    const auto layer{[](u32 value) { return static_cast<s32>(std::round(F(value))); }};
+    switch (type) {
+    case Shader::TextureType::Color1D:
+        return {{F(coords[0]), 0.0f, 0.0f}, 0};
+    case Shader::TextureType::ColorArray1D:
+        return {{F(coords[0]), 0.0f, 0.0f}, layer(coords[1])};
+    case Shader::TextureType::ColorArray2D:
+        return {{F(coords[0]), F(coords[1]), 0.0f}, layer(coords[2])};
+    case Shader::TextureType::Color3D:
+        return {{F(coords[0]), F(coords[1]), F(coords[2])}, 0};
+    case Shader::TextureType::ColorCube:
+    case Shader::TextureType::ColorArrayCube: {
+        const CubeCoords cube{Texture::ProjectCube(F(coords[0]), F(coords[1]), F(coords[2]))};
+        const s32 cube_layer{type == Shader::TextureType::ColorArrayCube ? layer(coords[3]) : 0};
+        return {{cube.u, cube.v, 0.0f}, cube_layer * 6 + cube.face};
+    }
+    case Shader::TextureType::Color2D:
+    case Shader::TextureType::Color2DRect:
+    default:
+        return {{F(coords[0]), F(coords[1]), 0.0f}, 0};
+    }
+}
+} // Anonymous namespace
+
+struct ShaderProgram::CompileState {
+    std::unordered_map<const IR::Inst*, u32> registers;
+    std::unordered_map<const IR::Block*, u32> blocks;
+    std::map<Register, u32> constants;
+};
+
+ShaderProgram::ShaderProgram(IR::Program& program) : info{program.info}, stage{program.stage} {
+    if (!info.texture_buffer_descriptors.empty() || !info.image_buffer_descriptors.empty() ||
+        !info.image_descriptors.empty()) {
+        LOG_WARNING(Render_Software, "Shaders with texture buffers or images are not supported");
+        is_supported = false;
+        return;
+    }
+    Compile(program);
+}
+
+ShaderProgram::Context ShaderProgram::MakeContext() const {
+    Context ctx;
+    ctx.registers.resize(num_registers);
+    for (const auto& [index, value] : constants) {
+        ctx.registers[index] = value;
+    }
+    size_t max_phis{};
+    for (const auto& phis : block_phis) {
+        max_phis = std::max(max_phis, phis.size());
+    }
+    ctx.phi_values.resize(max_phis);
+    ctx.local_memory.resize(local_memory_words);
+    return ctx;
+}
+
+void ShaderProgram::Compile(IR::Program& program) {
+    CompileState state;
+    u32 texture_offset{};
+    for (const Shader::TextureDescriptor& desc : info.texture_descriptors) {
+        texture_offsets.push_back(texture_offset);
+        texture_offset += desc.count;
+    }
+    local_memory_words = (program.local_memory_size + 3) / 4;
+
+    for (size_t index = 0; index < program.blocks.size(); ++index) {
+        state.blocks.emplace(program.blocks[index], static_cast<u32>(index));
+    }
+    for (IR::Block* const block : program.blocks) {
+        for (IR::Inst& inst : block->Instructions()) {
+            if (inst.GetOpcode() != Opcode::Identity && inst.Type() != IR::Type::Void) {
+                state.registers.emplace(&inst, num_registers++);
+            }
+        }
+    }
+    block_phis.resize(program.blocks.size());
+    for (size_t index = 0; index < program.blocks.size(); ++index) {
+        for (IR::Inst& inst : program.blocks[index]->Instructions()) {
+            if (inst.GetOpcode() != Opcode::Phi) {
+                break;
+            }
+            Phi& phi{block_phis[index].emplace_back()};
+            phi.dest = state.registers.at(&inst);
+            for (size_t arg = 0; arg < inst.NumArgs(); ++arg) {
+                phi.sources.emplace_back(state.blocks.at(inst.PhiBlock(arg)),
+                                         Operand(state, inst.Arg(arg)));
+            }
+        }
+    }
+
+    struct LoopScope {
+        u32 start;
+        const IR::Block* merge;
+        std::vector<size_t> breaks;
+    };
+    std::vector<size_t> if_stack;
+    std::vector<LoopScope> loop_stack;
+    for (const IR::AbstractSyntaxNode& node : program.syntax_list) {
+        switch (node.type) {
+        case IR::AbstractSyntaxNode::Type::Block:
+            ops.push_back({.type = OpType::Enter, .flags = state.blocks.at(node.data.block)});
+            for (IR::Inst& inst : node.data.block->Instructions()) {
+                CompileInst(state, inst);
+            }
+            break;
+        case IR::AbstractSyntaxNode::Type::If:
+            if_stack.push_back(ops.size());
+            ops.push_back({
+                .type = OpType::JumpIfNot,
+                .args = {Operand(state, node.data.if_node.cond)},
+            });
+            break;
+        case IR::AbstractSyntaxNode::Type::EndIf:
+            ops[if_stack.back()].flags = static_cast<u32>(ops.size());
+            if_stack.pop_back();
+            break;
+        case IR::AbstractSyntaxNode::Type::Loop:
+            loop_stack.push_back({static_cast<u32>(ops.size()), node.data.loop.merge, {}});
+            break;
+        case IR::AbstractSyntaxNode::Type::Repeat: {
+            const LoopScope scope{std::move(loop_stack.back())};
+            loop_stack.pop_back();
+            ops.push_back({
+                .type = OpType::JumpIf,
+                .flags = scope.start,
+                .args = {Operand(state, node.data.repeat.cond)},
+            });
+            for (const size_t break_op : scope.breaks) {
+                ops[break_op].flags = static_cast<u32>(ops.size());
+            }
+            break;
+        }
+        case IR::AbstractSyntaxNode::Type::Break: {
+            const auto scope{std::find_if(loop_stack.rbegin(), loop_stack.rend(), [&](auto& loop) {
+                return loop.merge == node.data.break_node.merge;
+            })};
+            if (scope == loop_stack.rend()) {
+                is_supported = false;
+                break;
+            }
+            scope->breaks.push_back(ops.size());
+            ops.push_back({
+                .type = OpType::JumpIf,
+                .args = {Operand(state, node.data.break_node.cond)},
+            });
+            break;
+        }
+        case IR::AbstractSyntaxNode::Type::Return:
+        case IR::AbstractSyntaxNode::Type::Unreachable:
+            ops.push_back({.type = OpType::Return});
+            break;
+        }
+    }
+    ops.push_back({.type = OpType::Return});
+}
+
+void ShaderProgram::CompileInst(CompileState& state, IR::Inst& inst) {
+    const Opcode opcode{inst.GetOpcode()};
+    if (IsNoOpcode(opcode)) {
+        return;
+    }
+    if (!IsSupportedOpcode(opcode) || inst.NumArgs() > 5) {
+        LOG_WARNING(Render_Software, "Unsupported shader instruction {}", opcode);
+        is_supported = false;
+        return;
+    }
+    Op op{
+        .type = OpType::Inst,
+        .opcode = opcode,
+    };
+    if (inst.Type() != IR::Type::Void) {
+        op.dest = state.registers.at(&inst);
+    }
+    for (size_t arg = 0; arg < inst.NumArgs(); ++arg) {
+        op.args[arg] = Operand(state, inst.Arg(arg));
+    }
+    if (IsImageOpcode(opcode)) {
+        op.flags = inst.Flags<IR::TextureInstInfo>().raw;
+    } else if (opcode == Opcode::FPMul32 || opcode == Opcode::FPFma32) {
+        op.flags = B(inst.Flags<IR::FpControl>().fmz_mode == IR::FmzMode::FMZ);
+    }
+    if (inst.HasAssociatedPseudoOperation()) {
+        static constexpr std::array pseudo_opcodes{
+            Opcode::GetZeroFromOp,
+            Opcode::GetSignFromOp,
+            Opcode::GetCarryFromOp,
+            Opcode::GetOverflowFromOp,
+        };
+        for (size_t index = 0; index < pseudo_opcodes.size(); ++index) {
+            const IR::Inst* const pseudo{inst.GetAssociatedPseudoOperation(pseudo_opcodes[index])};
+            if (pseudo) {
+                op.pseudo[index] = state.registers.at(pseudo);
+            }
+        }
+    }
+    ops.push_back(op);
+}
+
+u32 ShaderProgram::Operand(CompileState& state, const IR::Value& value) {
+    if (value.IsEmpty()) {
+        return 0;
+    }
+    if (!value.IsImmediate()) {
+        const auto it{state.registers.find(value.InstRecursive())};
+        if (it == state.registers.end()) {
+            is_supported = false;
+            return 0;
+        }
+        return it->second;
+    }
+    const IR::Value imm{value.Resolve()};
+    Register reg{};
+    switch (imm.Type()) {
+    case IR::Type::U1:
+        reg[0] = B(imm.U1());
+        break;
+    case IR::Type::U8:
+        reg[0] = imm.U8();
+        break;
+    case IR::Type::U16:
+        reg[0] = imm.U16();
+        break;
+    case IR::Type::U32:
+        reg[0] = imm.U32();
+        break;
+    case IR::Type::F32:
+        reg[0] = U(imm.F32());
+        break;
+    case IR::Type::U64:
+        reg[0] = static_cast<u32>(imm.U64());
+        reg[1] = static_cast<u32>(imm.U64() >> 32);
+        break;
+    case IR::Type::Attribute:
+        reg[0] = static_cast<u32>(imm.Attribute());
+        break;
+    default:
+        LOG_WARNING(Render_Software, "Unsupported immediate type {}", imm.Type());
+        is_supported = false;
+        break;
+    }
+    return Constant(state, reg);
+}
+
+u32 ShaderProgram::Constant(CompileState& state, const Register& value) {
+    const auto [it, is_new] = state.constants.try_emplace(value, num_registers);
+    if (is_new) {
+        constants.emplace_back(num_registers, value);
+        ++num_registers;
+    }
+    return it->second;
+}
+
+void ShaderProgram::Execute(Context& ctx, Invocation& invocation,
+                            const ShaderResources& resources) const {
+    std::vector<Register>& regs{ctx.registers};
+    u32 previous_block{~0U};
+    u32 jumps_left{LOOP_SAFETY_JUMPS};
+    size_t pc{};
+    while (pc < ops.size()) {
+        const Op& op{ops[pc++]};
+        switch (op.type) {
+        case OpType::Inst:
+            ExecuteInst(op, ctx, invocation, resources);
+            if (invocation.demoted) {
+                return;
+            }
+            break;
+        case OpType::Enter: {
+            // Phi nodes of a block are a parallel copy, read every source before writing
+            const std::vector<Phi>& phis{block_phis[op.flags]};
+            for (size_t index = 0; index < phis.size(); ++index) {
+                const auto& sources{phis[index].sources};
+                const auto source{std::ranges::find(sources, previous_block,
+                                                    &std::pair<u32, u32>::first)};
+                ctx.phi_values[index] = source != sources.end() ? regs[source->second] : Register{};
+            }
+            for (size_t index = 0; index < phis.size(); ++index) {
+                regs[phis[index].dest] = ctx.phi_values[index];
+            }
+            previous_block = op.flags;
+            break;
+        }
+        case OpType::Jump:
+            pc = op.flags;
+            break;
+        case OpType::JumpIf:
+        case OpType::JumpIfNot: {
+            const bool condition{regs[op.args[0]][0] != 0};
+            if (condition != (op.type == OpType::JumpIf)) {
+                break;
+            }
+            if (op.flags < pc) {
+                if (jumps_left == 0) {
+                    break;
+                }
+                --jumps_left;
+            }
+            pc = op.flags;
+            break;
+        }
+        case OpType::Return:
+            return;
+        }
+    }
+}
+
+void ShaderProgram::ExecuteInst(const Op& op, Context& ctx, Invocation& invocation,
+                                const ShaderResources& resources) const {
+    std::vector<Register>& regs{ctx.registers};
+    const Register& a{regs[op.args[0]]};
+    const Register& b{regs[op.args[1]]};
+    const Register& c{regs[op.args[2]]};
+    Register& dest{regs[op.dest]};
+
+    const auto read_cbuf{[&](size_t offset, size_t size) -> u32 {
+        const u32 binding{a[0]};
+        if (binding >= resources.cbufs.size()) {
+            return 0;
+        }
+        const std::span<const u8> cbuf{resources.cbufs[binding]};
+        u32 value{};
+        if (offset + size <= cbuf.size()) {
+            std::memcpy(&value, cbuf.data() + offset, size);
+        }
+        return value;
+    }};
+    const auto storage_address{[&](size_t size) -> std::optional<GPUVAddr> {
+        const u32 binding{a[0]};
+        const u32 offset{b[0]};
+        if (binding >= resources.storage_buffers.size() ||
+            static_cast<u64>(offset) + size > resources.storage_buffers[binding].size) {
+            return std::nullopt;
+        }
+        return resources.storage_buffers[binding].gpu_addr + offset;
+    }};
+    const auto load_storage{[&](size_t size) {
+        Register value{};
+        if (const auto address{storage_address(size)}) {
+            resources.gpu_memory->ReadBlockUnsafe(*address, value.data(), size);
+        }
+        return value;
+    }};
+    const auto write_storage{[&](size_t size) {
+        if (const auto address{storage_address(size)}) {
+            resources.gpu_memory->WriteBlockUnsafe(*address, c.data(), size);
+        }
+    }};
+
+    switch (op.opcode) {
+    case Opcode::ConditionRef:
+    case Opcode::BitCastU32F32:
+    case Opcode::BitCastF32U32:
+    case Opcode::PackUint2x32:
+    case Opcode::UnpackUint2x32:
+        dest = a;
+        break;
+    case Opcode::DemoteToHelperInvocation:
+        invocation.demoted = true;
+        break;
+    case Opcode::GetCbufU8:
+        dest[0] = read_cbuf(b[0], 1);
+        break;
+    case Opcode::GetCbufS8:
+        dest[0] = static_cast<u32>(static_cast<s8>(read_cbuf(b[0], 1)));
+        break;
+    case Opcode::GetCbufU16:
+        dest[0] = read_cbuf(b[0], 2);
+        break;
+    case Opcode::GetCbufS16:
+        dest[0] = static_cast<u32>(static_cast<s16>(read_cbuf(b[0], 2)));
+        break;
+    case Opcode::GetCbufU32:
+    case Opcode::GetCbufF32:
+        dest[0] = read_cbuf(b[0], 4);
+        break;
+    case Opcode::GetCbufU32x2:
+        dest[0] = read_cbuf(b[0], 4);
+        dest[1] = read_cbuf(static_cast<size_t>(b[0]) + 4, 4);
+        break;
+    case Opcode::GetAttribute:
+    case Opcode::GetAttributeU32:
+        dest[0] = a[0] < NUM_ATTRIBUTES ? U(invocation.inputs[a[0]]) : 0;
+        break;
+    case Opcode::SetAttribute:
+        if (a[0] < NUM_ATTRIBUTES) {
+            invocation.outputs[a[0]] = F(b[0]);
+        }
+        break;
+    case Opcode::GetAttributeIndexed:
+        dest[0] = a[0] / 4 < NUM_ATTRIBUTES ? U(invocation.inputs[a[0] / 4]) : 0;
+        break;
+    case Opcode::SetAttributeIndexed:
+        if (a[0] / 4 < NUM_ATTRIBUTES) {
+            invocation.outputs[a[0] / 4] = F(b[0]);
+        }
+        break;
+    case Opcode::SetFragColor:
+        invocation.frag_color[a[0] & 7][b[0] & 3] = F(c[0]);
+        break;
+    case Opcode::SetFragDepth:
+        invocation.frag_depth = F(a[0]);
+        break;
+    case Opcode::WorkgroupId:
+    case Opcode::LocalInvocationId:
+    case Opcode::InvocationId:
+    case Opcode::SampleId:
+    case Opcode::IsHelperInvocation:
+    case Opcode::UndefU1:
+    case Opcode::UndefU8:
+    case Opcode::UndefU16:
+    case Opcode::UndefU32:
+    case Opcode::IsTextureScaled:
+    case Opcode::IsImageScaled:
+    case Opcode::LaneId:
+    case Opcode::SubgroupLtMask:
+    case Opcode::DPdxFine:
+    case Opcode::DPdyFine:
+    case Opcode::DPdxCoarse:
+    case Opcode::DPdyCoarse:
+        dest = {};
+        break;
+    case Opcode::InvocationInfo:
+        dest[0] = 0x00ff0000U;
+        break;
+    case Opcode::YDirection:
+        dest[0] = U(resources.y_negate ? -1.0f : 1.0f);
+        break;
+    case Opcode::ResolutionDownFactor:
+        dest[0] = U(1.0f);
+        break;
+    case Opcode::RenderArea:
+        dest = {U(resources.render_area[0]), U(resources.render_area[1]), 0, 0};
+        break;
+    case Opcode::LoadLocal:
+        dest[0] = a[0] < ctx.local_memory.size() ? ctx.local_memory[a[0]] : 0;
+        break;
+    case Opcode::WriteLocal:
+        if (a[0] < ctx.local_memory.size()) {
+            ctx.local_memory[a[0]] = b[0];
+        }
+        break;
+    case Opcode::LoadStorageU8:
+        dest[0] = load_storage(1)[0] & 0xff;
+        break;
+    case Opcode::LoadStorageS8:
+        dest[0] = static_cast<u32>(static_cast<s8>(load_storage(1)[0]));
+        break;
+    case Opcode::LoadStorageU16:
+        dest[0] = load_storage(2)[0] & 0xffff;
+        break;
+    case Opcode::LoadStorageS16:
+        dest[0] = static_cast<u32>(static_cast<s16>(load_storage(2)[0]));
+        break;
+    case Opcode::LoadStorage32:
+        dest = load_storage(4);
+        break;
+    case Opcode::LoadStorage64:
+        dest = load_storage(8);
+        break;
+    case Opcode::LoadStorage128:
+        dest = load_storage(16);
+        break;
+    case Opcode::WriteStorageU8:
+    case Opcode::WriteStorageS8:
+        write_storage(1);
+        break;
+    case Opcode::WriteStorageU16:
+    case Opcode::WriteStorageS16:
+        write_storage(2);
+        break;
+    case Opcode::WriteStorage32:
+        write_storage(4);
+        break;
+    case Opcode::WriteStorage64:
+        write_storage(8);
+        break;
+    case Opcode::WriteStorage128:
+        write_storage(16);
+        break;
+    case Opcode::CompositeConstructU32x2:
+    case Opcode::CompositeConstructF32x2:
+        dest = {a[0], b[0], 0, 0};
+        break;
+    case Opcode::CompositeConstructU32x3:
+    case Opcode::CompositeConstructF32x3:
+        dest = {a[0], b[0], c[0], 0};
+        break;
+    case Opcode::CompositeConstructU32x4:
+    case Opcode::CompositeConstructF32x4:
+        dest = {a[0], b[0], c[0], regs[op.args[3]][0]};
+        break;
+    case Opcode::CompositeExtractU32x2:
+    case Opcode::CompositeExtractU32x3:
+    case Opcode::CompositeExtractU32x4:
+    case Opcode::CompositeExtractF32x2:
+    case Opcode::CompositeExtractF32x3:
+    case Opcode::CompositeExtractF32x4:
+        dest[0] = a[b[0] & 3];
+        break;
+    case Opcode::CompositeInsertU32x2:
+    case Opcode::CompositeInsertU32x3:
+    case Opcode::CompositeInsertU32x4:
+    case Opcode::CompositeInsertF32x2:
+    case Opcode::CompositeInsertF32x3:
+    case Opcode::CompositeInsertF32x4: {
+        Register result{a};
+        result[c[0] & 3] = b[0];
+        dest = result;
+        break;
+    }
+    case Opcode::SelectU1:
+    case Opcode::SelectU8:
+    case Opcode::SelectU16:
+    case Opcode::SelectU32:
+    case Opcode::SelectF32:
+        dest = a[0] != 0 ? b : c;
+        break;
+    case Opcode::PackHalf2x16:
+        dest[0] = static_cast<u32>(FloatToHalf(F(a[0]))) |
+                  static_cast<u32>(FloatToHalf(F(a[1]))) << 16;
+        break;
+    case Opcode::UnpackHalf2x16: {
+        const u32 value{a[0]};
+        dest = {U(HalfToFloat(static_cast<u16>(value))),
+                U(HalfToFloat(static_cast<u16>(value >> 16))), 0, 0};
+        break;
+    }
+    case Opcode::GetSparseFromOp:
+    case Opcode::GetInBoundsFromOp:
+    case Opcode::VoteEqual:
+    case Opcode::SubgroupEqMask:
+    case Opcode::SubgroupLeMask:
+        dest[0] = 1;
+        break;
+    case Opcode::FPAbs32:
+        dest[0] = U(std::abs(F(a[0])));
+        break;
+    case Opcode::FPAdd32:
+        dest[0] = U(F(a[0]) + F(b[0]));
+        break;
+    case Opcode::FPFma32:
+        if (op.flags != 0 && (F(a[0]) == 0.0f || F(b[0]) == 0.0f)) {
+            dest[0] = U(0.0f + F(c[0]));
+        } else {
+            dest[0] = U(std::fma(F(a[0]), F(b[0]), F(c[0])));
+        }
+        break;
+    case Opcode::FPMul32:
+        if (op.flags != 0 && (F(a[0]) == 0.0f || F(b[0]) == 0.0f)) {
+            dest[0] = U(0.0f);
+        } else {
+            dest[0] = U(F(a[0]) * F(b[0]));
+        }
+        break;
+    case Opcode::FPMax32:
+        dest[0] = U(std::fmax(F(a[0]), F(b[0])));
+        break;
+    case Opcode::FPMin32:
+        dest[0] = U(std::fmin(F(a[0]), F(b[0])));
+        break;
+    case Opcode::FPNeg32:
+        dest[0] = a[0] ^ 0x80000000U;
+        break;
+    case Opcode::FPRecip32:
+        dest[0] = U(1.0f / F(a[0]));
+        break;
+    case Opcode::FPRecipSqrt32:
+        dest[0] = U(1.0f / std::sqrt(F(a[0])));
+        break;
+    case Opcode::FPSqrt:
+        dest[0] = U(std::sqrt(F(a[0])));
+        break;
+    case Opcode::FPSin:
+        dest[0] = U(std::sin(F(a[0])));
+        break;
+    case Opcode::FPExp2:
+        dest[0] = U(std::exp2(F(a[0])));
+        break;
+    case Opcode::FPCos:
+        dest[0] = U(std::cos(F(a[0])));
+        break;
+    case Opcode::FPLog2:
+        dest[0] = U(std::log2(F(a[0])));
+        break;
+    case Opcode::FPSaturate32:
+        dest[0] = U(std::fmin(std::fmax(F(a[0]), 0.0f), 1.0f));
+        break;
+    case Opcode::FPClamp32:
+        dest[0] = U(std::fmin(std::fmax(F(a[0]), F(b[0])), F(c[0])));
+        break;
+    case Opcode::FPRoundEven32:
+        dest[0] = U(std::nearbyint(F(a[0])));
+        break;
+    case Opcode::FPFloor32:
+        dest[0] = U(std::floor(F(a[0])));
+        break;
+    case Opcode::FPCeil32:
+        dest[0] = U(std::ceil(F(a[0])));
+        break;
+    case Opcode::FPTrunc32:
+        dest[0] = U(std::trunc(F(a[0])));
+        break;
+    case Opcode::FPOrdEqual32:
+        dest[0] = B(F(a[0]) == F(b[0]));
+        break;
+    case Opcode::FPUnordEqual32:
+        dest[0] = B(!(F(a[0]) != F(b[0])) || std::isunordered(F(a[0]), F(b[0])));
+        break;
+    case Opcode::FPOrdNotEqual32:
+        dest[0] = B(F(a[0]) != F(b[0]) && !std::isunordered(F(a[0]), F(b[0])));
+        break;
+    case Opcode::FPUnordNotEqual32:
+        dest[0] = B(F(a[0]) != F(b[0]));
+        break;
+    case Opcode::FPOrdLessThan32:
+        dest[0] = B(F(a[0]) < F(b[0]));
+        break;
+    case Opcode::FPUnordLessThan32:
+        dest[0] = B(!(F(a[0]) >= F(b[0])));
+        break;
+    case Opcode::FPOrdGreaterThan32:
+        dest[0] = B(F(a[0]) > F(b[0]));
+        break;
+    case Opcode::FPUnordGreaterThan32:
+        dest[0] = B(!(F(a[0]) <= F(b[0])));
+        break;
+    case Opcode::FPOrdLessThanEqual32:
+        dest[0] = B(F(a[0]) <= F(b[0]));
+        break;
+    case Opcode::FPUnordLessThanEqual32:
+        dest[0] = B(!(F(a[0]) > F(b[0])));
+        break;
+    case Opcode::FPOrdGreaterThanEqual32:
+        dest[0] = B(F(a[0]) >= F(b[0]));
+        break;
+    case Opcode::FPUnordGreaterThanEqual32:
+        dest[0] = B(!(F(a[0]) < F(b[0])));
+        break;
+    case Opcode::FPIsNan32:
+        dest[0] = B(std::isnan(F(a[0])));
+        break;
+    case Opcode::IAdd32: {
+        const u32 result{a[0] + b[0]};
+        if (op.pseudo[2] != 0) {
+            regs[op.pseudo[2]][0] = B(result < a[0]);
+        }
+        if (op.pseudo[3] != 0) {
+            regs[op.pseudo[3]][0] = ((a[0] ^ result) & (b[0] ^ result)) >> 31;
+        }
+        dest[0] = result;
+        break;
+    }
+    case Opcode::ISub32:
+        dest[0] = a[0] - b[0];
+        break;
+    case Opcode::IMul32:
+        dest[0] = a[0] * b[0];
+        break;
+    case Opcode::SDiv32:
+        if (b[0] == 0) {
+            dest[0] = ~0U;
+        } else if (S(a[0]) == std::numeric_limits<s32>::min() && S(b[0]) == -1) {
+            dest[0] = a[0];
+        } else {
+            dest[0] = static_cast<u32>(S(a[0]) / S(b[0]));
+        }
+        break;
+    case Opcode::UDiv32:
+        dest[0] = b[0] == 0 ? ~0U : a[0] / b[0];
+        break;
+    case Opcode::INeg32:
+        dest[0] = 0U - a[0];
+        break;
+    case Opcode::IAbs32:
+        dest[0] = S(a[0]) < 0 ? 0U - a[0] : a[0];
+        break;
+    case Opcode::ShiftLeftLogical32:
+        dest[0] = b[0] >= 32 ? 0 : a[0] << b[0];
+        break;
+    case Opcode::ShiftRightLogical32:
+        dest[0] = b[0] >= 32 ? 0 : a[0] >> b[0];
+        break;
+    case Opcode::ShiftRightArithmetic32:
+        dest[0] = static_cast<u32>(S(a[0]) >> std::min(b[0], 31U));
+        break;
+    case Opcode::BitwiseAnd32:
+        dest[0] = a[0] & b[0];
+        break;
+    case Opcode::BitwiseOr32:
+        dest[0] = a[0] | b[0];
+        break;
+    case Opcode::BitwiseXor32:
+        dest[0] = a[0] ^ b[0];
+        break;
+    case Opcode::BitwiseNot32:
+        dest[0] = ~a[0];
+        break;
+    case Opcode::BitFieldInsert: {
+        const u32 offset{c[0]};
+        const u32 count{regs[op.args[3]][0]};
+        if (count == 0 || offset >= 32) {
+            dest[0] = a[0];
+            break;
+        }
+        const u32 mask{BitFieldMask(count) << offset};
+        dest[0] = (a[0] & ~mask) | ((b[0] << offset) & mask);
+        break;
+    }
+    case Opcode::BitFieldUExtract: {
+        const u32 offset{b[0]};
+        const u32 count{c[0]};
+        dest[0] = count == 0 || offset >= 32 ? 0 : (a[0] >> offset) & BitFieldMask(count);
+        break;
+    }
+    case Opcode::BitFieldSExtract: {
+        const u32 offset{b[0]};
+        const u32 count{std::min(c[0], 32U - std::min(offset, 32U))};
+        if (count == 0) {
+            dest[0] = 0;
+            break;
+        }
+        const u32 shifted{a[0] << (32 - count - offset)};
+        dest[0] = static_cast<u32>(S(shifted) >> (32 - count));
+        break;
+    }
+    case Opcode::BitReverse32: {
+        u32 value{a[0]};
+        u32 result{};
+        for (u32 bit = 0; bit < 32; ++bit) {
+            result = (result << 1) | (value & 1);
+            value >>= 1;
+        }
+        dest[0] = result;
+        break;
+    }
+    case Opcode::BitCount32:
+        dest[0] = static_cast<u32>(std::popcount(a[0]));
+        break;
+    case Opcode::FindSMsb32: {
+        const u32 value{S(a[0]) < 0 ? ~a[0] : a[0]};
+        dest[0] = value == 0 ? ~0U : 31U - static_cast<u32>(std::countl_zero(value));
+        break;
+    }
+    case Opcode::FindUMsb32:
+        dest[0] = a[0] == 0 ? ~0U : 31U - static_cast<u32>(std::countl_zero(a[0]));
+        break;
+    case Opcode::SMin32:
+        dest[0] = static_cast<u32>(std::min(S(a[0]), S(b[0])));
+        break;
+    case Opcode::UMin32:
+        dest[0] = std::min(a[0], b[0]);
+        break;
+    case Opcode::SMax32:
+        dest[0] = static_cast<u32>(std::max(S(a[0]), S(b[0])));
+        break;
+    case Opcode::UMax32:
+        dest[0] = std::max(a[0], b[0]);
+        break;
+    case Opcode::SClamp32:
+        dest[0] = static_cast<u32>(std::min(std::max(S(a[0]), S(b[0])), S(c[0])));
+        break;
+    case Opcode::UClamp32:
+        dest[0] = std::min(std::max(a[0], b[0]), c[0]);
+        break;
+    case Opcode::SLessThan:
+        dest[0] = B(S(a[0]) < S(b[0]));
+        break;
+    case Opcode::ULessThan:
+        dest[0] = B(a[0] < b[0]);
+        break;
+    case Opcode::IEqual:
+        dest[0] = B(a[0] == b[0]);
+        break;
+    case Opcode::SLessThanEqual:
+        dest[0] = B(S(a[0]) <= S(b[0]));
+        break;
+    case Opcode::ULessThanEqual:
+        dest[0] = B(a[0] <= b[0]);
+        break;
+    case Opcode::SGreaterThan:
+        dest[0] = B(S(a[0]) > S(b[0]));
+        break;
+    case Opcode::UGreaterThan:
+        dest[0] = B(a[0] > b[0]);
+        break;
+    case Opcode::INotEqual:
+        dest[0] = B(a[0] != b[0]);
+        break;
+    case Opcode::SGreaterThanEqual:
+        dest[0] = B(S(a[0]) >= S(b[0]));
+        break;
+    case Opcode::UGreaterThanEqual:
+        dest[0] = B(a[0] >= b[0]);
+        break;
+    case Opcode::LogicalOr:
+        dest[0] = B(a[0] != 0 || b[0] != 0);
+        break;
+    case Opcode::LogicalAnd:
+        dest[0] = B(a[0] != 0 && b[0] != 0);
+        break;
+    case Opcode::LogicalXor:
+        dest[0] = B((a[0] != 0) != (b[0] != 0));
+        break;
+    case Opcode::LogicalNot:
+        dest[0] = B(a[0] == 0);
+        break;
+    case Opcode::ConvertS16F32:
+        dest[0] = ConvertToInt<s16>(F(a[0]));
+        break;
+    case Opcode::ConvertS32F32:
+        dest[0] = ConvertToInt<s32>(F(a[0]));
+        break;
+    case Opcode::ConvertU16F32:
+        dest[0] = ConvertToInt<u16>(F(a[0]));
+        break;
+    case Opcode::ConvertU32F32:
+        dest[0] = ConvertToInt<u32>(F(a[0]));
+        break;
+    case Opcode::ConvertF32S8:
+        dest[0] = U(static_cast<f32>(static_cast<s8>(a[0])));
+        break;
+    case Opcode::ConvertF32S16:
+        dest[0] = U(static_cast<f32>(static_cast<s16>(a[0])));
+        break;
+    case Opcode::ConvertF32S32:
+        dest[0] = U(static_cast<f32>(S(a[0])));
+        break;
+    case Opcode::ConvertF32U8:
+        dest[0] = U(static_cast<f32>(a[0] & 0xff));
+        break;
+    case Opcode::ConvertF32U16:
+        dest[0] = U(static_cast<f32>(a[0] & 0xffff));
+        break;
+    case Opcode::ConvertF32U32:
+        dest[0] = U(static_cast<f32>(a[0]));
+        break;
+    case Opcode::VoteAll:
+    case Opcode::VoteAny:
+        dest[0] = B(a[0] != 0);
+        break;
+    case Opcode::SubgroupBallot:
+        dest = {B(a[0] != 0), 0, 0, 0};
+        break;
+    case Opcode::SubgroupGtMask:
+        dest[0] = ~1U;
+        break;
+    case Opcode::SubgroupGeMask:
+        dest[0] = ~0U;
+        break;
+    case Opcode::ShuffleIndex:
+    case Opcode::ShuffleUp:
+    case Opcode::ShuffleDown:
+    case Opcode::ShuffleButterfly:
+        dest[0] = a[0];
+        break;
+    case Opcode::FSwizzleAdd: {
+        // Invocations are run one at a time, they always see themselves as the first lane
+        const u32 mask{c[0] & 3};
+        dest[0] = U(F(a[0]) * FSWZ_A[mask] + F(b[0]) * FSWZ_B[mask]);
+        break;
+    }
+    default:
+        if (IsImageOpcode(op.opcode)) {
+            ExecuteImage(op, ctx, resources);
+        }
+        break;
+    }
+    if (op.pseudo[0] != 0) {
+        regs[op.pseudo[0]][0] = B(dest[0] == 0);
+    }
+    if (op.pseudo[1] != 0) {
+        regs[op.pseudo[1]][0] = B(S(dest[0]) < 0);
+    }
+}
+
+void ShaderProgram::ExecuteImage(const Op& op, Context& ctx,
+                                 const ShaderResources& resources) const {
+    std::vector<Register>& regs{ctx.registers};
+    Register& dest{regs[op.dest]};
+    IR::TextureInstInfo tex_info{};
+    tex_info.raw = op.flags;
+
+    const u32 descriptor{tex_info.descriptor_index};
+    if (descriptor >= texture_offsets.size()) {
+        dest = {};
+        return;
+    }
+    const u32 array_index{info.texture_descriptors[descriptor].count > 1 ? regs[op.args[0]][0]
+                                                                          : 0U};
+    const size_t index{static_cast<size_t>(texture_offsets[descriptor]) + array_index};
+    if (index >= resources.textures.size() || !resources.textures[index].texture) {
+        dest = {};
+        return;
+    }
+    const BoundTexture& bound{resources.textures[index]};
+    const Texture& texture{*bound.texture};
+    const Shader::TextureType type{tex_info.type};
+    const Register& coords{regs[op.args[1]]};
+    const auto offsets{[&](u32 arg) {
+        const Register& offset{regs[op.args[arg]]};
+        return std::array<s32, 3>{S(offset[0]), S(offset[1]), S(offset[2])};
+    }};
+
+    switch (op.opcode) {
+    case Opcode::ImageSampleImplicitLod:
+    case Opcode::ImageSampleExplicitLod:
+    case Opcode::ImageGradient: {
+        const TextureCoords resolved{ResolveCoords(type, coords)};
+        const Vec4 color{texture.Sample(bound.sampler, resolved.uvw, resolved.layer, offsets(3))};
+        dest = {U(color[0]), U(color[1]), U(color[2]), U(color[3])};
+        break;
+    }
+    case Opcode::ImageSampleDrefImplicitLod:
+    case Opcode::ImageSampleDrefExplicitLod: {
+        const TextureCoords resolved{ResolveCoords(type, coords)};
+        const auto offset{offsets(4)};
+        const f32 reference{F(regs[op.args[2]][0])};
+        dest[0] = U(texture.SampleCompare(bound.sampler, {resolved.uvw[0], resolved.uvw[1]},
+                                          resolved.layer, {offset[0], offset[1]}, reference));
+        break;
+    }
+    case Opcode::ImageGather: {
+        const TextureCoords resolved{ResolveCoords(type, coords)};
+        const auto offset{offsets(2)};
+        const Vec4 color{texture.Gather(bound.sampler, {resolved.uvw[0], resolved.uvw[1]},
+                                        resolved.layer, {offset[0], offset[1]},
+                                        tex_info.gather_component)};
+        dest = {U(color[0]), U(color[1]), U(color[2]), U(color[3])};
+        break;
+    }
+    case Opcode::ImageGatherDref: {
+        const TextureCoords resolved{ResolveCoords(type, coords)};
+        const auto offset{offsets(2)};
+        const f32 reference{F(regs[op.args[4]][0])};
+        const Vec4 color{texture.GatherCompare(bound.sampler, {resolved.uvw[0], resolved.uvw[1]},
+                                               resolved.layer, {offset[0], offset[1]},
+                                               reference)};
+        dest = {U(color[0]), U(color[1]), U(color[2]), U(color[3])};
+        break;
+    }
+    case Opcode::ImageFetch: {
+        const auto offset{offsets(2)};
+        s32 x{S(coords[0]) + offset[0]};
+        s32 y{};
+        s32 z{};
+        s32 layer{};
+        switch (type) {
+        case Shader::TextureType::Color1D:
+            break;
+        case Shader::TextureType::ColorArray1D:
+            layer = S(coords[1]);
+            break;
+        case Shader::TextureType::ColorArray2D:
+            y = S(coords[1]) + offset[1];
+            layer = S(coords[2]);
+            break;
+        case Shader::TextureType::Color3D:
+            y = S(coords[1]) + offset[1];
+            z = S(coords[2]) + offset[2];
+            break;
+        default:
+            y = S(coords[1]) + offset[1];
+            break;
+        }
+        const Vec4 color{texture.Fetch(x, y, z, layer)};
+        dest = {U(color[0]), U(color[1]), U(color[2]), U(color[3])};
+        break;
+    }
+    case Opcode::ImageQueryDimensions: {
+        const u32 lod{regs[op.args[1]][0]};
+        const bool skip_mips{regs[op.args[2]][0] != 0};
+        const u32 width{std::max(texture.Width() >> std::min(lod, 31U), 1U)};
+        const u32 height{std::max(texture.Height() >> std::min(lod, 31U), 1U)};
+        const u32 depth{std::max(texture.Depth() >> std::min(lod, 31U), 1U)};
+        const u32 levels{skip_mips ? 0U : texture.Levels()};
+        switch (type) {
+        case Shader::TextureType::Color1D:
+            dest = {width, 0, 0, levels};
+            break;
+        case Shader::TextureType::ColorArray1D:
+            dest = {width, texture.Layers(), 0, levels};
+            break;
+        case Shader::TextureType::ColorArray2D:
+            dest = {width, height, texture.Layers(), levels};
+            break;
+        case Shader::TextureType::ColorArrayCube:
+            dest = {width, height, texture.Layers() / 6, levels};
+            break;
+        case Shader::TextureType::Color3D:
+            dest = {width, height, depth, levels};
+            break;
+        default:
+            dest = {width, height, 0, levels};
+            break;
+        }
+        break;
+    }
+    case Opcode::ImageQueryLod:
+    default:
+        dest = {};
+        break;
+    }
+}
+
+} // namespace Software
@@ -0,0 +1,146 @@
+// SPDX-FileCopyrightText: Copyright 2024 yuzu Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <array>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include "yuzu_common/common_types.h"
+#include "yuzu_shader_recompiler/frontend/ir/opcodes.h"
+#include "yuzu_shader_recompiler/shader_info.h"
+#include "yuzu_shader_recompiler/stage.h"
+#include "yuzu_video_core/renderer_software/sw_format.h"
+#include "yuzu_video_core/renderer_software/sw_texture.h"
+
+namespace Shader::IR {
+class Inst;
+struct Program;
+class Value;
+} // namespace Shader::IR
+
+namespace Tegra {
+class MemoryManager;
+}
+
+namespace Software {
+
+/// Number of attribute slots of an invocation, indexed by IR::Attribute
+constexpr size_t NUM_ATTRIBUTES = 260;
+
+struct BoundTexture {
+    const Texture* texture{};
+    Sampler sampler;
+};
+
+struct StorageBinding {
+    GPUVAddr gpu_addr{};
+    u32 size{};
+};
+
+/// Resources bound to a shader stage for a draw.
+struct ShaderResources {
+    std::array<std::span<const u8>, Shader::Info::MAX_CBUFS> cbufs{};
+    std::span<const BoundTexture> textures;
+    std::span<const StorageBinding> storage_buffers;
+    Tegra::MemoryManager* gpu_memory{};
+    std::array<f32, 2> render_area{};
+    bool y_negate{};
+};
+
+/// Inputs and outputs of a single shader invocation.
+struct Invocation {
+    std::array<f32, NUM_ATTRIBUTES> inputs{};
+    std::array<f32, NUM_ATTRIBUTES> outputs{};
+    std::array<Vec4, 8> frag_color{};
+    f32 frag_depth{};
+    bool demoted{};
+};
+
+/// Shader program compiled from the IR to a flat list of operations run by an interpreter.
+///
+/// Every IR value lives in a four component register, immediates are preloaded in registers of
+/// their own when a context is created. Structured control flow is lowered to jumps and phi nodes
+/// are resolved when their block is entered, using the block the interpreter came from.
+class ShaderProgram {
+public:
+    using Register = std::array<u32, 4>;
+
+    /// Per thread state of the interpreter, reused between invocations.
+    struct Context {
+        std::vector<Register> registers;
+        std::vector<Register> phi_values;
+        std::vector<u32> local_memory;
+    };
+
+    explicit ShaderProgram(Shader::IR::Program& program);
+
+    [[nodiscard]] bool IsSupported() const noexcept {
+        return is_supported;
+    }
+
+    [[nodiscard]] const Shader::Info& Info() const noexcept {
+        return info;
+    }
+
+    [[nodiscard]] Shader::Stage Stage() const noexcept {
+        return stage;
+    }
+
+    [[nodiscard]] Context MakeContext() const;
+
+    void Execute(Context& ctx, Invocation& invocation, const ShaderResources& resources) const;
+
+private:
+    enum class OpType : u8 {
+        Inst,
+        Enter,
+        Jump,
+        JumpIf,
+        JumpIfNot,
+        Return,
+    };
+
+    struct Op {
+        OpType type{};
+        Shader::IR::Opcode opcode{};
+        u32 flags{};  ///< Texture instruction info or jump target
+        u32 dest{};
+        std::array<u32, 5> args{};
+        std::array<u32, 4> pseudo{}; ///< Zero, sign, carry and overflow results
+    };
+
+    struct Phi {
+        u32 dest;
+        std::vector<std::pair<u32, u32>> sources; ///< Predecessor block and source register
+    };
+
+    struct CompileState;
+
+    void Compile(Shader::IR::Program& program);
+
+    void CompileInst(CompileState& state, Shader::IR::Inst& inst);
+
+    [[nodiscard]] u32 Operand(CompileState& state, const Shader::IR::Value& value);
+
+    [[nodiscard]] u32 Constant(CompileState& state, const Register& value);
+
+    void ExecuteInst(const Op& op, Context& ctx, Invocation& invocation,
+                     const ShaderResources& resources) const;
+
+    void ExecuteImage(const Op& op, Context& ctx, const ShaderResources& resources) const;
+
+    std::vector<Op> ops;
+    std::vector<std::vector<Phi>> block_phis;
+    std::vector<std::pair<u32, Register>> constants;
+    std::vector<u32> texture_offsets;
+    u32 num_registers{1};
+    u32 local_memory_words{};
+    Shader::Info info;
+    Shader::Stage stage{};
+    bool is_supported{true};
+};
+
+} // namespace Software
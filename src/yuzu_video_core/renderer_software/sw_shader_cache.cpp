@@ -0,0 +1,107 @@
+// SPDX-FileCopyrightText: Copyright 2024 yuzu Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <algorithm>
+
+#include "yuzu_common/cityhash.h"
+#include "yuzu_common/logging/log.h"
+#include "yuzu_shader_recompiler/environment.h"
+#include "yuzu_shader_recompiler/exception.h"
+#include "yuzu_shader_recompiler/frontend/maxwell/translate_program.h"
+#include "yuzu_shader_recompiler/program_header.h"
+#include "yuzu_video_core/engines/maxwell_3d.h"
+#include "yuzu_video_core/renderer_software/sw_shader_cache.h"
+
+namespace Software {
+namespace {
+using Maxwell = Tegra::Engines::Maxwell3D::Regs;
+using Shader::Maxwell::MergeDualVertexPrograms;
+using Shader::Maxwell::TranslateProgram;
+
+constexpr size_t VERTEX_A = static_cast<size_t>(Maxwell::ShaderType::VertexA);
+constexpr size_t VERTEX_B = static_cast<size_t>(Maxwell::ShaderType::VertexB);
+constexpr size_t PIXEL = static_cast<size_t>(Maxwell::ShaderType::Pixel);
+} // Anonymous namespace
+
+size_t ShaderCache::HashesHash::operator()(const std::array<u64, 6>& hashes) const noexcept {
+    return static_cast<size_t>(
+        Common::CityHash64(reinterpret_cast<const char*>(hashes.data()), sizeof(hashes)));
+}
+
+ShaderCache::ShaderCache(Tegra::MaxwellDeviceMemoryManager& device_memory_)
+    : VideoCommon::ShaderCache{device_memory_} {
+    // The interpreter lowers everything to 32-bit registers
+    host_info = Shader::HostTranslateInfo{
+        .support_float64 = false,
+        .support_float16 = false,
+        .support_int64 = false,
+        .needs_demote_reorder = false,
+        .support_snorm_render_buffer = true,
+        .support_viewport_index_layer = true,
+        .min_ssbo_alignment = 16,
+        .support_geometry_shader_passthrough = false,
+        .support_conditional_barrier = true,
+    };
+}
+
+ShaderCache::~ShaderCache() = default;
+
+const GraphicsPrograms* ShaderCache::CurrentPrograms() {
+    if (!RefreshStages(unique_hashes)) {
+        return nullptr;
+    }
+    auto [it, is_new] = programs.try_emplace(unique_hashes);
+    if (is_new) {
+        it->second = CreatePrograms(unique_hashes);
+    }
+    return it->second.get();
+}
+
+std::unique_ptr<GraphicsPrograms> ShaderCache::CreatePrograms(
+    const std::array<u64, 6>& hashes) try {
+    auto result{std::make_unique<GraphicsPrograms>()};
+    for (size_t index = VERTEX_B + 1; index < PIXEL; ++index) {
+        if (hashes[index] != 0) {
+            LOG_WARNING(Render_Software, "Tessellation and geometry stages are not supported");
+            return result;
+        }
+    }
+    GraphicsEnvironments environments;
+    GetGraphicsEnvironments(environments, hashes);
+
+    std::array<Shader::Environment*, 6> envs{};
+    for (size_t index = 0, env_index = 0; index < envs.size(); ++index) {
+        if (hashes[index] != 0) {
+            envs[index] = environments.env_ptrs[env_index++];
+        }
+    }
+    inst_pool.ReleaseContents();
+    block_pool.ReleaseContents();
+    flow_block_pool.ReleaseContents();
+
+    const auto translate{[this](Shader::Environment& env, size_t index) {
+        const u32 cfg_offset{static_cast<u32>(env.StartAddress() + sizeof(Shader::ProgramHeader))};
+        Shader::Maxwell::Flow::CFG cfg(env, flow_block_pool, cfg_offset, index == VERTEX_A);
+        return TranslateProgram(inst_pool, block_pool, env, cfg, host_info);
+    }};
+    if (envs[VERTEX_B]) {
+        Shader::IR::Program vertex{translate(*envs[VERTEX_B], VERTEX_B)};
+        if (envs[VERTEX_A]) {
+            Shader::IR::Program vertex_a{translate(*envs[VERTEX_A], VERTEX_A)};
+            vertex = MergeDualVertexPrograms(vertex_a, vertex, *envs[VERTEX_B]);
+        }
+        result->vertex = std::make_unique<ShaderProgram>(vertex);
+    }
+    if (envs[PIXEL]) {
+        Shader::IR::Program fragment{translate(*envs[PIXEL], PIXEL)};
+        result->fragment = std::make_unique<ShaderProgram>(fragment);
+    }
+    result->is_supported = result->vertex && result->vertex->IsSupported() &&
+                           (!result->fragment || result->fragment->IsSupported());
+    return result;
+} catch (const Shader::Exception& exception) {
+    LOG_ERROR(Render_Software, "{}", exception.what());
+    return std::make_unique<GraphicsPrograms>();
+}
+
+} // namespace Software
@@ -0,0 +1,52 @@
+// SPDX-FileCopyrightText: Copyright 2024 yuzu Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <array>
+#include <memory>
+#include <unordered_map>
+
+#include "yuzu_common/common_types.h"
+#include "yuzu_shader_recompiler/frontend/ir/basic_block.h"
+#include "yuzu_shader_recompiler/frontend/maxwell/control_flow.h"
+#include "yuzu_shader_recompiler/host_translate_info.h"
+#include "yuzu_shader_recompiler/object_pool.h"
+#include "yuzu_video_core/renderer_software/sw_shader.h"
+#include "yuzu_video_core/shader_cache.h"
+
+namespace Software {
+
+/// Vertex and fragment programs of a draw.
+struct GraphicsPrograms {
+    std::unique_ptr<ShaderProgram> vertex;
+    std::unique_ptr<ShaderProgram> fragment;
+    bool is_supported{};
+};
+
+class ShaderCache : public VideoCommon::ShaderCache {
+public:
+    explicit ShaderCache(Tegra::MaxwellDeviceMemoryManager& device_memory);
+    ~ShaderCache();
+
+    /// Returns the programs of the bound graphics stages, nullptr when they can not be read.
+    [[nodiscard]] const GraphicsPrograms* CurrentPrograms();
+
+private:
+    struct HashesHash {
+        size_t operator()(const std::array<u64, 6>& hashes) const noexcept;
+    };
+
+    [[nodiscard]] std::unique_ptr<GraphicsPrograms> CreatePrograms(
+        const std::array<u64, 6>& unique_hashes);
+
+    Shader::ObjectPool<Shader::IR::Inst> inst_pool{8192};
+    Shader::ObjectPool<Shader::IR::Block> block_pool{32};
+    Shader::ObjectPool<Shader::Maxwell::Flow::Block> flow_block_pool{32};
+    Shader::HostTranslateInfo host_info;
+
+    std::array<u64, 6> unique_hashes{};
+    std::unordered_map<std::array<u64, 6>, std::unique_ptr<GraphicsPrograms>, HashesHash> programs;
+};
+
+} // namespace Software
@@ -0,0 +1,181 @@
+// SPDX-FileCopyrightText: Copyright 2024 yuzu Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <algorithm>
+
+#include "yuzu_common/logging/log.h"
+#include "yuzu_video_core/memory_manager.h"
+#include "yuzu_video_core/renderer_software/sw_format.h"
+#include "yuzu_video_core/renderer_software/sw_surface_cache.h"
+#include "yuzu_video_core/renderer_software/sw_texture.h"
+#include "yuzu_video_core/surface.h"
+#include "yuzu_video_core/texture_cache/util.h"
+
+namespace Software {
+namespace {
+bool IsSameSurface(const Surface& surface, GPUVAddr gpu_addr,
+                   const VideoCommon::ImageInfo& info) noexcept {
+    return surface.gpu_addr == gpu_addr && surface.info.format == info.format &&
+           surface.info.type == info.type && surface.info.size == info.size &&
+           (info.type == VideoCommon::ImageType::Linear ? surface.info.pitch == info.pitch
+                                                        : surface.info.block == info.block);
+}
+} // Anonymous namespace
+
+SurfaceCache::SurfaceCache(TextureCache& texture_cache_,
+                           Tegra::MaxwellDeviceMemoryManager& device_memory_)
+    : texture_cache{texture_cache_}, device_memory{device_memory_} {}
+
+SurfaceCache::~SurfaceCache() {
+    for (const auto& surface : surfaces) {
+        UntrackSurface(*surface);
+    }
+}
+
+Surface* SurfaceCache::Get(Tegra::MemoryManager& gpu_memory, GPUVAddr gpu_addr,
+                           const VideoCommon::ImageInfo& guest_info, bool load) {
+    if (guest_info.num_samples != 1 || guest_info.type == VideoCommon::ImageType::e3D ||
+        (!IsWritableFormat(guest_info.format) && !IsDepthFormat(guest_info.format))) {
+        return nullptr;
+    }
+    // Only the first layer of layered render targets is rendered to
+    VideoCommon::ImageInfo info{guest_info};
+    info.resources.layers = 1;
+    info.resources.levels = 1;
+
+    const auto it{std::ranges::find_if(surfaces, [&](const std::unique_ptr<Surface>& surface) {
+        return surface->gpu_memory == &gpu_memory && IsSameSurface(*surface, gpu_addr, info);
+    })};
+    Surface* surface{};
+    if (it != surfaces.end()) {
+        surface = it->get();
+    } else {
+        const u64 guest_size{VideoCommon::CalculateGuestSizeInBytes(info)};
+        const auto device_addr{gpu_memory.GpuToCpuAddress(gpu_addr, guest_size)};
+        if (!device_addr) {
+            return nullptr;
+        }
+        // Surfaces aliasing the new one are written back and dropped
+        std::erase_if(surfaces, [&](const std::unique_ptr<Surface>& other) {
+            if (!other->Overlaps(*device_addr, guest_size)) {
+                return false;
+            }
+            Flush(*other);
+            UntrackSurface(*other);
+            return true;
+        });
+        const auto copies{VideoCommon::FullDownloadCopies(info)};
+        auto& new_surface{surfaces.emplace_back(std::make_unique<Surface>())};
+        new_surface->info = info;
+        new_surface->copy = copies.front();
+        new_surface->gpu_memory = &gpu_memory;
+        new_surface->gpu_addr = gpu_addr;
+        new_surface->device_addr = *device_addr;
+        new_surface->guest_size = guest_size;
+        new_surface->width = info.size.width;
+        new_surface->height = info.size.height;
+        new_surface->row_length = new_surface->copy.buffer_row_length;
+        new_surface->bytes_per_texel = VideoCore::Surface::BytesPerBlock(info.format);
+        new_surface->data.resize(new_surface->copy.buffer_size);
+        new_surface->needs_reload = true;
+        surface = new_surface.get();
+    }
+    if (surface->needs_reload) {
+        if (load) {
+            Load(*surface);
+        }
+        surface->needs_reload = false;
+    }
+    TrackSurface(*surface);
+    return surface;
+}
+
+void SurfaceCache::MarkDirty(Surface& surface) {
+    if (surface.is_dirty) {
+        return;
+    }
+    surface.is_dirty = true;
+    texture_cache.Invalidate(surface.device_addr, surface.guest_size);
+}
+
+void SurfaceCache::FlushRegion(DAddr addr, u64 size) {
+    for (const auto& surface : surfaces) {
+        if (surface->is_dirty && surface->Overlaps(addr, size)) {
+            Flush(*surface);
+        }
+    }
+}
+
+bool SurfaceCache::MustFlush(DAddr addr, u64 size) const {
+    return std::ranges::any_of(surfaces, [&](const std::unique_ptr<Surface>& surface) {
+        return surface->is_dirty && surface->Overlaps(addr, size);
+    });
+}
+
+void SurfaceCache::Invalidate(DAddr addr, u64 size) {
+    for (const auto& surface : surfaces) {
+        if (surface->Overlaps(addr, size)) {
+            // Further writes can not make it any more stale, stop trapping them until reloaded
+            surface->is_dirty = false;
+            surface->needs_reload = true;
+            UntrackSurface(*surface);
+        }
+    }
+}
+
+void SurfaceCache::InvalidateGpu(GPUVAddr addr, u64 size) {
+    std::erase_if(surfaces, [&](const std::unique_ptr<Surface>& surface) {
+        if (surface->gpu_addr >= addr + size || addr >= surface->gpu_addr + surface->guest_size) {
+            return false;
+        }
+        UntrackSurface(*surface);
+        return true;
+    });
+}
+
+void SurfaceCache::FlushAll() {
+    for (const auto& surface : surfaces) {
+        if (surface->is_dirty) {
+            Flush(*surface);
+        }
+    }
+}
+
+void SurfaceCache::Load(Surface& surface) {
+    guest_buffer.resize_destructive(surface.guest_size);
+    surface.gpu_memory->ReadBlockUnsafe(surface.gpu_addr, guest_buffer.data(), surface.guest_size);
+    const auto copies{VideoCommon::UnswizzleImage(*surface.gpu_memory, surface.gpu_addr,
+                                                  surface.info, guest_buffer, surface.data)};
+    if (copies.empty() || copies.front().buffer_row_length != surface.row_length) {
+        LOG_WARNING(Render_Software, "Unexpected layout loading surface at 0x{:x}",
+                    surface.gpu_addr);
+    }
+}
+
+void SurfaceCache::TrackSurface(Surface& surface) {
+    if (surface.is_tracked) {
+        return;
+    }
+    surface.is_tracked = true;
+    device_memory.UpdatePagesCachedCount(surface.device_addr, surface.guest_size, 1);
+}
+
+void SurfaceCache::UntrackSurface(Surface& surface) {
+    if (!surface.is_tracked) {
+        return;
+    }
+    surface.is_tracked = false;
+    device_memory.UpdatePagesCachedCount(surface.device_addr, surface.guest_size, -1);
+}
+
+void SurfaceCache::Flush(Surface& surface) {
+    if (!surface.is_dirty) {
+        return;
+    }
+    const std::array copies{surface.copy};
+    VideoCommon::SwizzleImage(*surface.gpu_memory, surface.gpu_addr, surface.info, copies,
+                              surface.data, swizzle_buffer);
+    surface.is_dirty = false;
+}
+
+} // namespace Software
@@ -0,0 +1,103 @@
+// SPDX-FileCopyrightText: Copyright 2024 yuzu Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "yuzu_common/common_types.h"
+#include "yuzu_common/scratch_buffer.h"
+#include "yuzu_video_core/host1x/gpu_device_memory_manager.h"
+#include "yuzu_video_core/texture_cache/image_info.h"
+#include "yuzu_video_core/texture_cache/types.h"
+
+namespace Tegra {
+class MemoryManager;
+}
+
+namespace Software {
+
+class TextureCache;
+
+/// Linear host copy of a render target. Draws render to the copy, it is written back to guest
+/// memory when the region is flushed.
+struct Surface {
+    [[nodiscard]] bool Overlaps(DAddr addr, u64 size) const noexcept {
+        return addr < device_addr + guest_size && device_addr < addr + size;
+    }
+
+    [[nodiscard]] u8* Texel(u32 x, u32 y) noexcept {
+        return data.data() + (static_cast<size_t>(y) * row_length + x) * bytes_per_texel;
+    }
+
+    VideoCommon::ImageInfo info;
+    VideoCommon::BufferImageCopy copy;
+    Tegra::MemoryManager* gpu_memory{};
+    GPUVAddr gpu_addr{};
+    DAddr device_addr{};
+    u64 guest_size{};
+    u32 width{};
+    u32 height{};
+    u32 row_length{};
+    u32 bytes_per_texel{};
+    std::vector<u8> data;
+    bool is_dirty{};     ///< Host copy has been rendered to and not written back
+    bool needs_reload{}; ///< Guest memory has been modified since the host copy was loaded
+    bool is_tracked{};   ///< Guest CPU accesses to its pages reach the rasterizer
+};
+
+/// Tracks the render targets of the software rasterizer.
+/// The pages of a surface are tracked while its host copy is current, so guest CPU reads flush it
+/// and guest CPU writes invalidate it, the same way VideoCommon::TextureCache tracks images.
+/// The mutex has to be held while any of the methods are called or surfaces are accessed.
+class SurfaceCache {
+public:
+    explicit SurfaceCache(TextureCache& texture_cache,
+                          Tegra::MaxwellDeviceMemoryManager& device_memory);
+    ~SurfaceCache();
+
+    /// Returns the surface of a render target, nullptr when it can not be rendered to.
+    /// @param load False when the caller overwrites the whole surface and its contents can be
+    ///             left stale
+    [[nodiscard]] Surface* Get(Tegra::MemoryManager& gpu_memory, GPUVAddr gpu_addr,
+                               const VideoCommon::ImageInfo& info, bool load);
+
+    /// Marks a surface as rendered to, textures sampling its memory are invalidated.
+    void MarkDirty(Surface& surface);
+
+    /// Writes back the surfaces overlapping a device memory region.
+    void FlushRegion(DAddr addr, u64 size);
+
+    /// Returns true when a surface overlapping the region has to be written back.
+    [[nodiscard]] bool MustFlush(DAddr addr, u64 size) const;
+
+    /// Reloads the surfaces overlapping the region the next time they are used.
+    void Invalidate(DAddr addr, u64 size);
+
+    /// Drops the surfaces in a remapped GPU memory region without writing them back.
+    void InvalidateGpu(GPUVAddr addr, u64 size);
+
+    /// Writes back all the surfaces that have been rendered to.
+    void FlushAll();
+
+    std::mutex mutex;
+
+private:
+    void Load(Surface& surface);
+
+    void Flush(Surface& surface);
+
+    void TrackSurface(Surface& surface);
+
+    void UntrackSurface(Surface& surface);
+
+    TextureCache& texture_cache;
+    Tegra::MaxwellDeviceMemoryManager& device_memory;
+    std::vector<std::unique_ptr<Surface>> surfaces;
+    Common::ScratchBuffer<u8> guest_buffer;
+    Common::ScratchBuffer<u8> swizzle_buffer;
+};
+
+} // namespace Software
@@ -0,0 +1,421 @@
+// SPDX-FileCopyrightText: Copyright 2024 yuzu Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <algorithm>
+#include <cmath>
+
+#include "yuzu_common/bit_cast.h"
+#include "yuzu_common/cityhash.h"
+#include "yuzu_common/literals.h"
+#include "yuzu_video_core/memory_manager.h"
+#include "yuzu_video_core/renderer_software/sw_texture.h"
+#include "yuzu_video_core/surface.h"
+#include "yuzu_video_core/texture_cache/decode_bc.h"
+#include "yuzu_video_core/texture_cache/image_info.h"
+#include "yuzu_video_core/texture_cache/util.h"
+#include "yuzu_video_core/textures/astc.h"
+
+namespace Software {
+namespace {
+using namespace Common::Literals;
+using Tegra::Texture::DepthCompareFunc;
+using Tegra::Texture::SwizzleSource;
+using Tegra::Texture::TextureFilter;
+using Tegra::Texture::WrapMode;
+using VideoCore::Surface::PixelFormat;
+
+/// Decoded textures kept alive between frames before unused ones are released
+constexpr size_t TEXTURE_MEMORY_BUDGET = 512_MiB;
+
+/// Wraps an integer texel coordinate, returns -1 when the border color has to be used
+s32 WrapCoord(WrapMode mode, s32 coord, s32 size) noexcept {
+    switch (mode) {
+    case WrapMode::Wrap: {
+        const s32 wrapped{coord % size};
+        return wrapped < 0 ? wrapped + size : wrapped;
+    }
+    case WrapMode::Mirror: {
+        const s32 period{size * 2};
+        s32 wrapped{coord % period};
+        if (wrapped < 0) {
+            wrapped += period;
+        }
+        return wrapped >= size ? period - 1 - wrapped : wrapped;
+    }
+    case WrapMode::MirrorOnceClampToEdge:
+    case WrapMode::MirrorOnceClampOGL:
+        return std::clamp(coord < 0 ? -1 - coord : coord, 0, size - 1);
+    case WrapMode::MirrorOnceBorder: {
+        const s32 mirrored{coord < 0 ? -1 - coord : coord};
+        return mirrored >= size ? -1 : mirrored;
+    }
+    case WrapMode::Border:
+        return coord < 0 || coord >= size ? -1 : coord;
+    case WrapMode::ClampToEdge:
+    case WrapMode::Clamp:
+    default:
+        return std::clamp(coord, 0, size - 1);
+    }
+}
+
+bool Compare(DepthCompareFunc func, f32 reference, f32 value) noexcept {
+    switch (func) {
+    case DepthCompareFunc::Never:
+        return false;
+    case DepthCompareFunc::Less:
+        return reference < value;
+    case DepthCompareFunc::Equal:
+        return reference == value;
+    case DepthCompareFunc::LessEqual:
+        return reference <= value;
+    case DepthCompareFunc::Greater:
+        return reference > value;
+    case DepthCompareFunc::NotEqual:
+        return reference != value;
+    case DepthCompareFunc::GreaterEqual:
+        return reference >= value;
+    case DepthCompareFunc::Always:
+    default:
+        return true;
+    }
+}
+
+Vec4 Lerp(const Vec4& a, const Vec4& b, f32 t) noexcept {
+    return {a[0] + (b[0] - a[0]) * t, a[1] + (b[1] - a[1]) * t, a[2] + (b[2] - a[2]) * t,
+            a[3] + (b[3] - a[3]) * t};
+}
+} // Anonymous namespace
+
+Sampler::Sampler(const Tegra::Texture::TSCEntry& tsc) noexcept
+    : wrap{tsc.wrap_u.Value(), tsc.wrap_v.Value(), tsc.wrap_p.Value()},
+      compare_func{tsc.depth_compare_enabled != 0 ? tsc.depth_compare_func.Value()
+                                                  : DepthCompareFunc::Always},
+      linear{tsc.mag_filter == TextureFilter::Linear || tsc.min_filter == TextureFilter::Linear},
+      border_color{tsc.BorderColor()} {}
+
+Texture::Texture(Tegra::MemoryManager& gpu_memory, const Tegra::Texture::TICEntry& tic,
+                 const FlushCallback& flush_region) {
+    const VideoCommon::ImageInfo info{tic};
+    if (info.type == VideoCommon::ImageType::Buffer || info.num_samples != 1) {
+        return;
+    }
+    const GPUVAddr gpu_addr{tic.Address()};
+    guest_size = VideoCommon::CalculateGuestSizeInBytes(info);
+    const auto cpu_addr{gpu_memory.GpuToCpuAddress(gpu_addr, guest_size)};
+    if (!cpu_addr) {
+        return;
+    }
+    const PixelFormat guest_format{info.format};
+    format = DecodedFormat(guest_format);
+    if (!IsReadableFormat(format)) {
+        return;
+    }
+    device_addr = *cpu_addr;
+    swizzle = {tic.x_source.Value(), tic.y_source.Value(), tic.z_source.Value(),
+               tic.w_source.Value()};
+    width = info.size.width;
+    height = info.size.height;
+    depth = info.size.depth;
+    layers = static_cast<u32>(info.resources.layers);
+    levels = static_cast<u32>(info.resources.levels);
+    normalized_coords = tic.normalized_coords != 0;
+    is_integer = VideoCore::Surface::IsPixelFormatInteger(format);
+    is_depth = IsDepthFormat(format);
+    bytes_per_texel = VideoCore::Surface::BytesPerBlock(format);
+
+    flush_region(device_addr, guest_size);
+    std::vector<u8> guest(guest_size);
+    gpu_memory.ReadBlockUnsafe(gpu_addr, guest.data(), guest.size());
+    std::vector<u8> unswizzled(VideoCommon::CalculateUnswizzledSizeBytes(info));
+    auto copies{VideoCommon::UnswizzleImage(gpu_memory, gpu_addr, info, guest, unswizzled)};
+    if (copies.empty()) {
+        return;
+    }
+    // Only the base level is kept, the following levels are stored after it
+    VideoCommon::BufferImageCopy& copy{copies.front()};
+    if (VideoCore::Surface::IsPixelFormatASTC(guest_format)) {
+        const auto [block_width, block_height] = VideoCore::Surface::GetASTCBlockSize(guest_format);
+        data.resize(static_cast<size_t>(width) * height * depth * layers * bytes_per_texel);
+        Tegra::Texture::ASTC::Decompress(unswizzled, width, height, layers * depth, block_width,
+                                         block_height, data);
+        row_length = width;
+        image_height = height;
+    } else if (VideoCore::Surface::IsPixelFormatBCn(guest_format)) {
+        data.resize(static_cast<size_t>(width) * height * depth * layers * bytes_per_texel);
+        VideoCommon::DecompressBCn(unswizzled, data, copy, guest_format);
+        row_length = width;
+        image_height = height;
+    } else {
+        unswizzled.resize(copy.buffer_size);
+        data = std::move(unswizzled);
+        row_length = copy.buffer_row_length;
+        image_height = copy.buffer_image_height;
+    }
+    if (data.size() < static_cast<size_t>(row_length) * image_height * depth * layers *
+                          bytes_per_texel) {
+        data.clear();
+    }
+}
+
+Vec4 Texture::Fetch(s32 x, s32 y, s32 z, s32 layer) const noexcept {
+    if (x < 0 || y < 0 || z < 0 || layer < 0 || x >= static_cast<s32>(width) ||
+        y >= static_cast<s32>(height) || z >= static_cast<s32>(depth) ||
+        layer >= static_cast<s32>(layers)) {
+        return {};
+    }
+    return ReadSwizzled(x, y, z, layer);
+}
+
+Vec4 Texture::Sample(const Sampler& sampler, const std::array<f32, 3>& coords, s32 layer,
+                     const std::array<s32, 3>& offset) const noexcept {
+    s32 z{};
+    if (depth > 1) {
+        const f32 w{normalized_coords ? coords[2] * static_cast<f32>(depth) : coords[2]};
+        z = WrapCoord(sampler.wrap[2], static_cast<s32>(std::floor(w)) + offset[2],
+                      static_cast<s32>(depth));
+        if (z < 0) {
+            return Swizzle(sampler.border_color);
+        }
+    }
+    if (!sampler.linear || is_integer) {
+        const f32 u{normalized_coords ? coords[0] * static_cast<f32>(width) : coords[0]};
+        const f32 v{normalized_coords ? coords[1] * static_cast<f32>(height) : coords[1]};
+        return ReadWrapped(sampler, static_cast<s32>(std::floor(u)) + offset[0],
+                           static_cast<s32>(std::floor(v)) + offset[1], z, layer);
+    }
+    const Footprint fp{BilinearFootprint(sampler, {coords[0], coords[1]}, {offset[0], offset[1]})};
+    const Vec4 top{Lerp(ReadWrapped(sampler, fp.x[0], fp.y[0], z, layer),
+                        ReadWrapped(sampler, fp.x[1], fp.y[0], z, layer), fp.fraction_x)};
+    if (height == 1) {
+        return top;
+    }
+    const Vec4 bottom{Lerp(ReadWrapped(sampler, fp.x[0], fp.y[1], z, layer),
+                           ReadWrapped(sampler, fp.x[1], fp.y[1], z, layer), fp.fraction_x)};
+    return Lerp(top, bottom, fp.fraction_y);
+}
+
+f32 Texture::SampleCompare(const Sampler& sampler, const std::array<f32, 2>& coords, s32 layer,
+                           const std::array<s32, 2>& offset, f32 reference) const noexcept {
+    if (!sampler.linear) {
+        const f32 u{normalized_coords ? coords[0] * static_cast<f32>(width) : coords[0]};
+        const f32 v{normalized_coords ? coords[1] * static_cast<f32>(height) : coords[1]};
+        return CompareWrapped(sampler, static_cast<s32>(std::floor(u)) + offset[0],
+                              static_cast<s32>(std::floor(v)) + offset[1], layer, reference);
+    }
+    const Footprint fp{BilinearFootprint(sampler, coords, offset)};
+    const f32 top_left{CompareWrapped(sampler, fp.x[0], fp.y[0], layer, reference)};
+    const f32 top_right{CompareWrapped(sampler, fp.x[1], fp.y[0], layer, reference)};
+    const f32 bottom_left{CompareWrapped(sampler, fp.x[0], fp.y[1], layer, reference)};
+    const f32 bottom_right{CompareWrapped(sampler, fp.x[1], fp.y[1], layer, reference)};
+    const f32 top{top_left + (top_right - top_left) * fp.fraction_x};
+    const f32 bottom{bottom_left + (bottom_right - bottom_left) * fp.fraction_x};
+    return top + (bottom - top) * fp.fraction_y;
+}
+
+Vec4 Texture::Gather(const Sampler& sampler, const std::array<f32, 2>& coords, s32 layer,
+                     const std::array<s32, 2>& offset, u32 component) const noexcept {
+    const Footprint fp{BilinearFootprint(sampler, coords, offset)};
+    const size_t index{std::min<size_t>(component, 3)};
+    return {ReadWrapped(sampler, fp.x[0], fp.y[1], 0, layer)[index],
+            ReadWrapped(sampler, fp.x[1], fp.y[1], 0, layer)[index],
+            ReadWrapped(sampler, fp.x[1], fp.y[0], 0, layer)[index],
+            ReadWrapped(sampler, fp.x[0], fp.y[0], 0, layer)[index]};
+}
+
+Vec4 Texture::GatherCompare(const Sampler& sampler, const std::array<f32, 2>& coords, s32 layer,
+                            const std::array<s32, 2>& offset, f32 reference) const noexcept {
+    const Footprint fp{BilinearFootprint(sampler, coords, offset)};
+    return {CompareWrapped(sampler, fp.x[0], fp.y[1], layer, reference),
+            CompareWrapped(sampler, fp.x[1], fp.y[1], layer, reference),
+            CompareWrapped(sampler, fp.x[1], fp.y[0], layer, reference),
+            CompareWrapped(sampler, fp.x[0], fp.y[0], layer, reference)};
+}
+
+CubeCoords Texture::ProjectCube(f32 x, f32 y, f32 z) noexcept {
+    const f32 abs_x{std::abs(x)};
+    const f32 abs_y{std::abs(y)};
+    const f32 abs_z{std::abs(z)};
+    f32 major{};
+    f32 s{};
+    f32 t{};
+    s32 face{};
+    if (abs_x >= abs_y && abs_x >= abs_z) {
+        face = x >= 0.0f ? 0 : 1;
+        major = abs_x;
+        s = x >= 0.0f ? -z : z;
+        t = -y;
+    } else if (abs_y >= abs_z) {
+        face = y >= 0.0f ? 2 : 3;
+        major = abs_y;
+        s = x;
+        t = y >= 0.0f ? z : -z;
+    } else {
+        face = z >= 0.0f ? 4 : 5;
+        major = abs_z;
+        s = z >= 0.0f ? x : -x;
+        t = -y;
+    }
+    if (major == 0.0f) {
+        return {0.5f, 0.5f, face};
+    }
+    return {(s / major + 1.0f) * 0.5f, (t / major + 1.0f) * 0.5f, face};
+}
+
+Texture::Footprint Texture::BilinearFootprint(const Sampler& sampler,
+                                              const std::array<f32, 2>& coords,
+                                              const std::array<s32, 2>& offset) const noexcept {
+    const f32 u{(normalized_coords ? coords[0] * static_cast<f32>(width) : coords[0]) - 0.5f};
+    const f32 v{(normalized_coords ? coords[1] * static_cast<f32>(height) : coords[1]) - 0.5f};
+    const f32 floor_u{std::floor(u)};
+    const f32 floor_v{std::floor(v)};
+    const s32 x{static_cast<s32>(floor_u) + offset[0]};
+    const s32 y{static_cast<s32>(floor_v) + offset[1]};
+    return {
+        .x = {x, x + 1},
+        .y = {y, y + 1},
+        .fraction_x = u - floor_u,
+        .fraction_y = v - floor_v,
+    };
+}
+
+const u8* Texture::TexelPointer(s32 x, s32 y, s32 z, s32 layer) const noexcept {
+    const size_t slice{static_cast<size_t>(layer) * depth + static_cast<size_t>(z)};
+    const size_t row{slice * image_height + static_cast<size_t>(y)};
+    return data.data() + (row * row_length + static_cast<size_t>(x)) * bytes_per_texel;
+}
+
+Vec4 Texture::ReadSwizzled(s32 x, s32 y, s32 z, s32 layer) const noexcept {
+    return Swizzle(ReadTexel(format, TexelPointer(x, y, z, layer)));
+}
+
+Vec4 Texture::ReadWrapped(const Sampler& sampler, s32 x, s32 y, s32 z,
+                          s32 layer) const noexcept {
+    const s32 wrapped_x{WrapCoord(sampler.wrap[0], x, static_cast<s32>(width))};
+    const s32 wrapped_y{WrapCoord(sampler.wrap[1], y, static_cast<s32>(height))};
+    if (wrapped_x < 0 || wrapped_y < 0) {
+        return Swizzle(sampler.border_color);
+    }
+    const s32 clamped_layer{std::clamp(layer, 0, static_cast<s32>(layers) - 1)};
+    return ReadSwizzled(wrapped_x, wrapped_y, z, clamped_layer);
+}
+
+f32 Texture::CompareWrapped(const Sampler& sampler, s32 x, s32 y, s32 layer,
+                            f32 reference) const noexcept {
+    const s32 wrapped_x{WrapCoord(sampler.wrap[0], x, static_cast<s32>(width))};
+    const s32 wrapped_y{WrapCoord(sampler.wrap[1], y, static_cast<s32>(height))};
+    f32 value{};
+    if (wrapped_x < 0 || wrapped_y < 0) {
+        value = sampler.border_color[0];
+    } else {
+        const s32 clamped_layer{std::clamp(layer, 0, static_cast<s32>(layers) - 1)};
+        const u8* const texel{TexelPointer(wrapped_x, wrapped_y, 0, clamped_layer)};
+        value = is_depth ? ReadDepth(format, texel) : ReadTexel(format, texel)[0];
+    }
+    return Compare(sampler.compare_func, reference, value) ? 1.0f : 0.0f;
+}
+
+Vec4 Texture::Swizzle(const Vec4& color) const noexcept {
+    Vec4 result;
+    for (size_t i = 0; i < result.size(); ++i) {
+        switch (swizzle[i]) {
+        case SwizzleSource::R:
+        case SwizzleSource::G:
+        case SwizzleSource::B:
+        case SwizzleSource::A: {
+            const size_t component{static_cast<size_t>(swizzle[i]) -
+                                   static_cast<size_t>(SwizzleSource::R)};
+            result[i] = color[component];
+            break;
+        }
+        case SwizzleSource::OneInt:
+            result[i] = Common::BitCast<f32>(1U);
+            break;
+        case SwizzleSource::OneFloat:
+            result[i] = 1.0f;
+            break;
+        case SwizzleSource::Zero:
+        default:
+            result[i] = 0.0f;
+            break;
+        }
+    }
+    return result;
+}
+
+TextureCache::TextureCache(Tegra::MaxwellDeviceMemoryManager& device_memory_)
+    : device_memory{device_memory_} {}
+
+TextureCache::~TextureCache() {
+    for (const auto& [tic, texture] : cache) {
+        Track(*texture, -1);
+    }
+}
+
+std::shared_ptr<const Texture> TextureCache::Get(Tegra::MemoryManager& gpu_memory,
+                                                 const Tegra::Texture::TICEntry& tic,
+                                                 const FlushCallback& flush_region) {
+    std::scoped_lock lock{mutex};
+    auto [it, is_new] = cache.try_emplace(tic);
+    if (is_new) {
+        it->second = std::make_shared<Texture>(gpu_memory, tic, flush_region);
+        host_memory += it->second->HostSize();
+        Track(*it->second, 1);
+    }
+    if (!it->second->IsValid()) {
+        return nullptr;
+    }
+    return it->second;
+}
+
+void TextureCache::Invalidate(DAddr addr, u64 size) {
+    std::scoped_lock lock{mutex};
+    std::erase_if(cache, [&](const auto& pair) {
+        if (!pair.second->IsValid() || !pair.second->Overlaps(addr, size)) {
+            return false;
+        }
+        host_memory -= pair.second->HostSize();
+        Track(*pair.second, -1);
+        return true;
+    });
+}
+
+void TextureCache::InvalidateGpu(GPUVAddr addr, u64 size) {
+    std::scoped_lock lock{mutex};
+    std::erase_if(cache, [&](const auto& pair) {
+        const GPUVAddr tic_addr{pair.first.Address()};
+        if (!pair.second->IsValid() || tic_addr >= addr + size ||
+            addr >= tic_addr + pair.second->GuestSize()) {
+            return false;
+        }
+        host_memory -= pair.second->HostSize();
+        Track(*pair.second, -1);
+        return true;
+    });
+}
+
+void TextureCache::TickFrame() {
+    std::scoped_lock lock{mutex};
+    // Textures that failed to decode are retried, their memory may have been mapped since
+    const bool over_budget{host_memory > TEXTURE_MEMORY_BUDGET};
+    std::erase_if(cache, [&](const auto& pair) {
+        if (pair.second->IsValid() && (!over_budget || pair.second.use_count() != 1)) {
+            return false;
+        }
+        host_memory -= pair.second->HostSize();
+        Track(*pair.second, -1);
+        return true;
+    });
+}
+
+void TextureCache::Track(const Texture& texture, s32 delta) {
+    // Textures that failed to decode hold no host copy to keep in sync
+    if (texture.IsValid()) {
+        device_memory.UpdatePagesCachedCount(texture.DeviceAddr(), texture.GuestSize(), delta);
+    }
+}
+
+size_t TextureCache::TICHash::operator()(const Tegra::Texture::TICEntry& tic) const noexcept {
+    return Common::CityHash64(reinterpret_cast<const char*>(tic.raw.data()), sizeof(tic.raw));
+}
+
+} // namespace Software
@@ -0,0 +1,194 @@
+// SPDX-FileCopyrightText: Copyright 2024 yuzu Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <array>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "yuzu_common/common_types.h"
+#include "yuzu_video_core/host1x/gpu_device_memory_manager.h"
+#include "yuzu_video_core/renderer_software/sw_format.h"
+#include "yuzu_video_core/textures/texture.h"
+
+namespace Tegra {
+class MemoryManager;
+}
+
+namespace Software {
+
+/// Writes back the host copies of a device memory region before it is read.
+using FlushCallback = std::function<void(DAddr addr, u64 size)>;
+
+/// Sampling state decoded from a TSC entry.
+struct Sampler {
+    Sampler() = default;
+    explicit Sampler(const Tegra::Texture::TSCEntry& tsc) noexcept;
+
+    std::array<Tegra::Texture::WrapMode, 3> wrap{Tegra::Texture::WrapMode::ClampToEdge,
+                                                 Tegra::Texture::WrapMode::ClampToEdge,
+                                                 Tegra::Texture::WrapMode::ClampToEdge};
+    Tegra::Texture::DepthCompareFunc compare_func{Tegra::Texture::DepthCompareFunc::Always};
+    bool linear{};
+    Vec4 border_color{};
+};
+
+/// Cube map coordinates projected on a face.
+struct CubeCoords {
+    f32 u;
+    f32 v;
+    s32 face;
+};
+
+/// Guest texture decoded to a linear host copy. Only the base level is decoded, sampling always
+/// happens on it regardless of the level of detail requested by the shader.
+class Texture {
+public:
+    explicit Texture(Tegra::MemoryManager& gpu_memory, const Tegra::Texture::TICEntry& tic,
+                     const FlushCallback& flush_region);
+
+    [[nodiscard]] bool IsValid() const noexcept {
+        return !data.empty();
+    }
+
+    [[nodiscard]] bool Overlaps(DAddr addr, u64 size) const noexcept {
+        return addr < device_addr + guest_size && device_addr < addr + size;
+    }
+
+    [[nodiscard]] DAddr DeviceAddr() const noexcept {
+        return device_addr;
+    }
+
+    [[nodiscard]] u64 GuestSize() const noexcept {
+        return guest_size;
+    }
+
+    [[nodiscard]] size_t HostSize() const noexcept {
+        return data.size();
+    }
+
+    [[nodiscard]] u32 Width() const noexcept {
+        return width;
+    }
+
+    [[nodiscard]] u32 Height() const noexcept {
+        return height;
+    }
+
+    [[nodiscard]] u32 Depth() const noexcept {
+        return depth;
+    }
+
+    [[nodiscard]] u32 Layers() const noexcept {
+        return layers;
+    }
+
+    [[nodiscard]] u32 Levels() const noexcept {
+        return levels;
+    }
+
+    /// Reads a texel with integer coordinates, out of bounds reads return zero.
+    [[nodiscard]] Vec4 Fetch(s32 x, s32 y, s32 z, s32 layer) const noexcept;
+
+    /// Samples the texture with the filtering and wrapping of the sampler.
+    [[nodiscard]] Vec4 Sample(const Sampler& sampler, const std::array<f32, 3>& coords, s32 layer,
+                              const std::array<s32, 3>& offset) const noexcept;
+
+    /// Samples the texture comparing each texel against a reference depth.
+    [[nodiscard]] f32 SampleCompare(const Sampler& sampler, const std::array<f32, 2>& coords,
+                                    s32 layer, const std::array<s32, 2>& offset,
+                                    f32 reference) const noexcept;
+
+    /// Gathers a component of the four texels a bilinear sample would use.
+    [[nodiscard]] Vec4 Gather(const Sampler& sampler, const std::array<f32, 2>& coords, s32 layer,
+                              const std::array<s32, 2>& offset, u32 component) const noexcept;
+
+    /// Gathers the comparison result of the four texels a bilinear sample would use.
+    [[nodiscard]] Vec4 GatherCompare(const Sampler& sampler, const std::array<f32, 2>& coords,
+                                     s32 layer, const std::array<s32, 2>& offset,
+                                     f32 reference) const noexcept;
+
+    [[nodiscard]] static CubeCoords ProjectCube(f32 x, f32 y, f32 z) noexcept;
+
+private:
+    struct Footprint {
+        std::array<s32, 2> x;
+        std::array<s32, 2> y;
+        f32 fraction_x;
+        f32 fraction_y;
+    };
+
+    [[nodiscard]] Footprint BilinearFootprint(const Sampler& sampler,
+                                              const std::array<f32, 2>& coords,
+                                              const std::array<s32, 2>& offset) const noexcept;
+
+    [[nodiscard]] const u8* TexelPointer(s32 x, s32 y, s32 z, s32 layer) const noexcept;
+
+    [[nodiscard]] Vec4 ReadSwizzled(s32 x, s32 y, s32 z, s32 layer) const noexcept;
+
+    /// Reads a texel through the sampler, wrapped coordinates out of bounds read the border color.
+    [[nodiscard]] Vec4 ReadWrapped(const Sampler& sampler, s32 x, s32 y, s32 z,
+                                   s32 layer) const noexcept;
+
+    [[nodiscard]] f32 CompareWrapped(const Sampler& sampler, s32 x, s32 y, s32 layer,
+                                     f32 reference) const noexcept;
+
+    [[nodiscard]] Vec4 Swizzle(const Vec4& color) const noexcept;
+
+    std::vector<u8> data;
+    VideoCore::Surface::PixelFormat format{};
+    std::array<Tegra::Texture::SwizzleSource, 4> swizzle{};
+    DAddr device_addr{};
+    u64 guest_size{};
+    u32 width{1};
+    u32 height{1};
+    u32 depth{1};
+    u32 layers{1};
+    u32 levels{1};
+    u32 row_length{1};
+    u32 image_height{1};
+    u32 bytes_per_texel{};
+    bool normalized_coords{};
+    bool is_integer{};
+    bool is_depth{};
+};
+
+/// Caches decoded textures by their TIC entry. The pages of every cached texture are tracked, so
+/// guest CPU writes reach Invalidate and drop the textures decoded from the old contents.
+class TextureCache {
+public:
+    explicit TextureCache(Tegra::MaxwellDeviceMemoryManager& device_memory);
+    ~TextureCache();
+
+    /// Returns the decoded texture of a TIC entry, nullptr when it can not be decoded.
+    [[nodiscard]] std::shared_ptr<const Texture> Get(Tegra::MemoryManager& gpu_memory,
+                                                     const Tegra::Texture::TICEntry& tic,
+                                                     const FlushCallback& flush_region);
+
+    /// Removes the textures overlapping a device memory region.
+    void Invalidate(DAddr addr, u64 size);
+
+    /// Removes the textures whose TIC points into a remapped GPU memory region.
+    void InvalidateGpu(GPUVAddr addr, u64 size);
+
+    /// Releases the textures not used by a draw when the cache grows over its budget.
+    void TickFrame();
+
+private:
+    struct TICHash {
+        size_t operator()(const Tegra::Texture::TICEntry& tic) const noexcept;
+    };
+
+    void Track(const Texture& texture, s32 delta);
+
+    Tegra::MaxwellDeviceMemoryManager& device_memory;
+    std::mutex mutex;
+    std::unordered_map<Tegra::Texture::TICEntry, std::shared_ptr<Texture>, TICHash> cache;
+    size_t host_memory{};
+};
+
+} // namespace Software
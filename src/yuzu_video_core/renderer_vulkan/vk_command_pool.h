@@ -16,7 +16,8 @@ class MasterSemaphore;
 
 class CommandPool final : public ResourcePool {
 public:
-    explicit CommandPool(MasterSemaphore& master_semaphore_, const Device& device_);
+    explicit CommandPool(MasterSemaphore& master_semaphore_, const Device& device_,
+                         VkCommandBufferLevel level_ = VK_COMMAND_BUFFER_LEVEL_PRIMARY);
     ~CommandPool() override;
 
     void Allocate(size_t begin, size_t end) override;
@@ -27,6 +28,7 @@ private:
     struct Pool;
 
     const Device& device;
+    VkCommandBufferLevel level;
     std::vector<Pool> pools;
 };
 
@@ -7,7 +7,9 @@
 #include <array>
 #include <atomic>
 #include <condition_variable>
+#include <memory>
 #include <mutex>
+#include <span>
 #include <type_traits>
 
 #include "yuzu_common/thread_worker.h"
@@ -59,6 +61,7 @@ struct hash<Vulkan::GraphicsPipelineCacheKey> {
 namespace Vulkan {
 
 class Device;
+class PipelineLibrary;
 class PipelineStatistics;
 class RenderPassCache;
 class RescalingPushConstant;
@@ -75,8 +78,11 @@ public:
         const Device& device, DescriptorPool& descriptor_pool,
         GuestDescriptorQueue& guest_descriptor_queue, Common::ThreadWorker* worker_thread,
         PipelineStatistics* pipeline_statistics, RenderPassCache& render_pass_cache,
-        const GraphicsPipelineCacheKey& key, std::array<vk::ShaderModule, NUM_STAGES> stages,
-        const std::array<const Shader::Info*, NUM_STAGES>& infos);
+        PipelineLibrary& pipeline_library, const GraphicsPipelineCacheKey& key,
+        std::array<vk::ShaderModule, NUM_STAGES> stages,
+        const std::array<const Shader::Info*, NUM_STAGES>& infos,
+        const std::array<u64, NUM_STAGES>& code_hashes, bool defer_compile = false);
+    ~GraphicsPipeline();
 
     GraphicsPipeline& operator=(GraphicsPipeline&&) noexcept = delete;
     GraphicsPipeline(GraphicsPipeline&&) noexcept = delete;
@@ -103,6 +109,12 @@ public:
         return is_built.load(std::memory_order::relaxed);
     }
 
+    /// Returns true when the pipeline was not built because its library parts were missing and
+    /// the compilation was deferred, the pipeline has to be discarded.
+    [[nodiscard]] bool IsDeferred() const noexcept {
+        return is_deferred;
+    }
+
     template <typename Spec>
     static auto MakeConfigureSpecFunc() {
         return [](GraphicsPipeline* pl, bool is_indexed) { pl->ConfigureImpl<Spec>(is_indexed); };
@@ -114,13 +126,21 @@ public:
     }
 
 private:
+    struct Description;
+
     template <typename Spec>
     void ConfigureImpl(bool is_indexed);
 
     void ConfigureDraw(const RescalingPushConstant& rescaling,
                        const RenderAreaPushConstant& render_are);
 
-    void MakePipeline(VkRenderPass render_pass);
+    void MakePipeline(Common::ThreadWorker* worker_thread);
+
+    [[nodiscard]] bool HasLibraryParts() const;
+
+    [[nodiscard]] vk::Pipeline LinkLibraries(std::span<const VkPipeline> libraries,
+                                             VkPipelineCreateFlags flags,
+                                             VkRenderPass render_pass) const;
 
     void Validate();
 
@@ -131,6 +151,7 @@ private:
     TextureCache& texture_cache;
     BufferCache& buffer_cache;
     vk::PipelineCache& pipeline_cache;
+    PipelineLibrary& pipeline_library;
     Scheduler& scheduler;
     GuestDescriptorQueue& guest_descriptor_queue;
 
@@ -140,6 +161,7 @@ private:
     std::vector<GraphicsPipeline*> transitions;
 
     std::array<vk::ShaderModule, NUM_STAGES> spv_modules;
+    std::array<u64, NUM_STAGES> code_hashes;
 
     std::array<Shader::Info, NUM_STAGES> stage_infos;
     std::array<u32, 5> enabled_uniform_buffer_masks{};
@@ -151,10 +173,16 @@ private:
     vk::PipelineLayout pipeline_layout;
     vk::DescriptorUpdateTemplate descriptor_update_template;
     vk::Pipeline pipeline;
+    vk::Pipeline optimized_pipeline;
+    std::atomic<VkPipeline> bound_pipeline{};
+
+    /// Create info state, only kept until the pipeline has been built.
+    std::unique_ptr<Description> description;
 
     std::condition_variable build_condvar;
     std::mutex build_mutex;
     std::atomic_bool is_built{false};
+    bool is_deferred{false};
     bool uses_push_descriptor{false};
 };
 
@@ -2,17 +2,25 @@
 // SPDX-License-Identifier: GPL-2.0-or-later
 
 #include <algorithm>
+#include <chrono>
 #include <cstddef>
+#include <exception>
 #include <fstream>
+#include <latch>
 #include <memory>
+#include <optional>
+#include <span>
 #include <thread>
 #include <vector>
 
+#include <boost/container/static_vector.hpp>
+
 #include "yuzu_common/bit_cast.h"
 #include "yuzu_common/cityhash.h"
 #include "yuzu_common/fs/fs.h"
 #include "yuzu_common/fs/path_util.h"
 #include "yuzu_common/microprofile.h"
+#include "yuzu_common/scope_exit.h"
 #include "yuzu_common/thread_worker.h"
 #include "core/core.h"
 #include "yuzu_shader_recompiler/backend/spirv/emit_spirv.h"
@@ -54,6 +62,8 @@ using VideoCommon::GenericEnvironment;
 using VideoCommon::GraphicsEnvironment;
 
 constexpr u32 CACHE_VERSION = 11;
+// Pipelines allowed in flight per worker before new ones are skipped with asynchronous shaders
+constexpr size_t COMPILE_BUDGET_PER_WORKER = 2;
 constexpr std::array<char, 8> VULKAN_CACHE_MAGIC_NUMBER{'y', 'u', 'z', 'u', 'v', 'k', 'c', 'h'};
 
 template <typename Container>
@@ -278,8 +288,28 @@ size_t GetTotalPipelineWorkers() {
 #endif
 }
 
+size_t GetPipelineWorkers(const Device& device) {
+    return device.HasBrokenParallelShaderCompiling() ? 1ULL : GetTotalPipelineWorkers();
+}
+
 } // Anonymous namespace
 
+std::unique_ptr<ShaderPools> ShaderPoolsCache::Acquire() {
+    std::scoped_lock lock{mutex};
+    if (free_pools.empty()) {
+        return std::make_unique<ShaderPools>();
+    }
+    std::unique_ptr<ShaderPools> pools{std::move(free_pools.back())};
+    free_pools.pop_back();
+    return pools;
+}
+
+void ShaderPoolsCache::Release(std::unique_ptr<ShaderPools> pools) {
+    pools->ReleaseContents();
+    std::scoped_lock lock{mutex};
+    free_pools.push_back(std::move(pools));
+}
+
 size_t ComputePipelineCacheKey::Hash() const noexcept {
     const u64 hash = Common::CityHash64(reinterpret_cast<const char*>(this), sizeof *this);
     return static_cast<size_t>(hash);
@@ -310,8 +340,11 @@ PipelineCache::PipelineCache(Tegra::MaxwellDeviceMemoryManager& device_memory_,
       texture_cache{texture_cache_}, shader_notify{shader_notify_},
       use_asynchronous_shaders{Settings::values.use_asynchronous_shaders.GetValue()},
       use_vulkan_pipeline_cache{Settings::values.use_vulkan_driver_pipeline_cache.GetValue()},
-      workers(device.HasBrokenParallelShaderCompiling() ? 1ULL : GetTotalPipelineWorkers(),
-              "VkPipelineBuilder"),
+      pipeline_library(device, GetPipelineWorkers(device) * COMPILE_BUDGET_PER_WORKER),
+      translation_workers(
+          std::min<size_t>(GetTotalPipelineWorkers(), Maxwell::MaxShaderProgram - 1),
+          "VkShaderTranslator"),
+      workers(GetPipelineWorkers(device), "VkPipelineBuilder"),
       serialization_thread(1, "VkPipelineSerialization") {
     const auto& float_control{device.FloatControlProperties()};
     const VkDriverId driver_id{device.GetDriverID()};
@@ -412,6 +445,7 @@ PipelineCache::PipelineCache(Tegra::MaxwellDeviceMemoryManager& device_memory_,
 }
 
 PipelineCache::~PipelineCache() {
+    stage_cache.Report();
     if (use_vulkan_pipeline_cache && !vulkan_pipeline_cache_filename.empty()) {
         SerializeVulkanPipelineCache(vulkan_pipeline_cache_filename, vulkan_pipeline_cache,
                                      CACHE_VERSION);
@@ -564,13 +598,28 @@ void PipelineCache::LoadDiskResources(u64 title_id, std::stop_token stop_loading
     if (state.statistics) {
         state.statistics->Report();
     }
+    stage_cache.Report();
 }
 
 GraphicsPipeline* PipelineCache::CurrentGraphicsPipelineSlowPath() {
     const auto [pair, is_new]{graphics_cache.try_emplace(graphics_key)};
     auto& pipeline{pair->second};
     if (is_new) {
-        pipeline = CreateGraphicsPipeline();
+        // When the compile queue is over budget, try again the next time this state is drawn.
+        // A pipeline whose library parts are all compiled is only a fast link and never skipped,
+        // which is only known once its shaders are translated.
+        const bool over_budget{!pipeline_library.CanQueueCompile() && CanSkipDraw()};
+        if (over_budget && !pipeline_library.IsEnabled()) {
+            graphics_cache.erase(pair);
+            pipeline_library.MarkDrawSkipped();
+            return nullptr;
+        }
+        pipeline = CreateGraphicsPipeline(over_budget);
+        if (pipeline && pipeline->IsDeferred()) {
+            graphics_cache.erase(pair);
+            pipeline_library.MarkDrawSkipped();
+            return nullptr;
+        }
     }
     if (!pipeline) {
         return nullptr;
@@ -582,39 +631,179 @@ GraphicsPipeline* PipelineCache::CurrentGraphicsPipelineSlowPath() {
     return BuiltPipeline(current_pipeline);
 }
 
-GraphicsPipeline* PipelineCache::BuiltPipeline(GraphicsPipeline* pipeline) const noexcept {
+GraphicsPipeline* PipelineCache::BuiltPipeline(GraphicsPipeline* pipeline) noexcept {
     if (pipeline->IsBuilt()) {
         return pipeline;
     }
-    if (!use_asynchronous_shaders) {
+    if (!CanSkipDraw()) {
         return pipeline;
     }
+    pipeline_library.MarkDrawSkipped();
+    return nullptr;
+}
+
+bool PipelineCache::CanSkipDraw() const noexcept {
+    if (!use_asynchronous_shaders) {
+        return false;
+    }
     // If something is using depth, we can assume that games are not rendering anything which
     // will be used one time.
     if (maxwell3d->regs.zeta_enable) {
-        return nullptr;
+        return true;
     }
     // If games are using a small index count, we can assume these are full screen quads.
     // Usually these shaders are only used once for building textures so we can assume they
     // can't be built async
     const auto& draw_state = maxwell3d->draw_manager->GetDrawState();
     if (draw_state.index_buffer.count <= 6 || draw_state.vertex_buffer.count <= 6) {
-        return pipeline;
+        return false;
     }
-    return nullptr;
+    return true;
+}
+
+void PipelineCache::TickFrame() {
+    pipeline_library.TickFrame();
 }
 
 std::unique_ptr<GraphicsPipeline> PipelineCache::CreateGraphicsPipeline(
     ShaderPools& pools, const GraphicsPipelineCacheKey& key,
     std::span<Shader::Environment* const> envs, PipelineStatistics* statistics,
-    bool build_in_parallel) try {
+    bool build_in_parallel, bool defer_compile) try {
     auto hash = key.Hash();
     LOG_INFO(Render_Vulkan, "0x{:016x}", hash);
-    size_t env_index{0};
     std::array<Shader::IR::Program, Maxwell::MaxShaderProgram> programs;
     const bool uses_vertex_a{key.unique_hashes[0] != 0};
     const bool uses_vertex_b{key.unique_hashes[1] != 0};
 
+    std::array<Shader::Environment*, Maxwell::MaxShaderProgram> stage_envs{};
+    for (size_t index = 0, env_index = 0; index < Maxwell::MaxShaderProgram; ++index) {
+        if (key.unique_hashes[index] != 0) {
+            stage_envs[index] = envs[env_index++];
+        }
+    }
+    Shader::Maxwell::PassTimings timings;
+    std::array<VideoCommon::ShaderStageCache::ProgramPtr, Maxwell::MaxShaderProgram> cached{};
+    std::array<bool, Maxwell::MaxShaderProgram> is_translated{};
+
+    // Pools leased to stages translated on other threads, the programs live in them until the
+    // pipeline is built
+    boost::container::static_vector<std::unique_ptr<ShaderPools>, Maxwell::MaxShaderProgram>
+        leased_pools;
+    SCOPE_EXIT {
+        for (auto& leased : leased_pools) {
+            shader_pools_cache.Release(std::move(leased));
+        }
+    };
+
+    const auto program_key{[&key, uses_vertex_a](size_t index) {
+        return VideoCommon::ShaderStageCache::ProgramKey{
+            .unique_hash = key.unique_hashes[index],
+            .vertex_a_hash = index == 1 && uses_vertex_a ? key.unique_hashes[0] : 0,
+            .index = index,
+        };
+    }};
+    const auto translate_program{[this](Shader::Environment& env, size_t index,
+                                        ShaderPools& stage_pools,
+                                        Shader::Maxwell::PassTimings& stage_timings) {
+        const auto cfg_start{std::chrono::steady_clock::now()};
+        const u32 cfg_offset{static_cast<u32>(env.StartAddress() + sizeof(Shader::ProgramHeader))};
+        Shader::Maxwell::Flow::CFG cfg(env, stage_pools.flow_block, cfg_offset, index == 0);
+        stage_timings.Add("CFG", std::chrono::steady_clock::now() - cfg_start);
+        return TranslateProgram(stage_pools.inst, stage_pools.block, env, cfg, host_info,
+                                &stage_timings);
+    }};
+    const auto translate{[&](std::span<const size_t> indices) {
+        // VertexA is translated on its own and merged into VertexB once both are done
+        boost::container::static_vector<size_t, Maxwell::MaxShaderProgram> units;
+        for (const size_t index : indices) {
+            if (index == 1 && uses_vertex_a) {
+                units.push_back(0);
+            }
+            units.push_back(index);
+        }
+        if (units.empty()) {
+            return;
+        }
+        std::array<VideoCommon::EnvironmentQueries, Maxwell::MaxShaderProgram> queries;
+        std::array<std::optional<VideoCommon::RecordingEnvironment>, Maxwell::MaxShaderProgram>
+            recording_envs;
+        std::array<Shader::IR::Program, Maxwell::MaxShaderProgram> translated;
+        std::array<Shader::Maxwell::PassTimings, Maxwell::MaxShaderProgram> unit_timings;
+        std::array<std::exception_ptr, Maxwell::MaxShaderProgram> exceptions;
+        for (const size_t unit : units) {
+            recording_envs[unit].emplace(*stage_envs[unit], queries[unit]);
+        }
+        // Other stages go to the translation workers on pools of their own, the first one is
+        // translated on this thread while they run
+        std::latch done{static_cast<std::ptrdiff_t>(units.size() - 1)};
+        for (const size_t unit : std::span(units).subspan(1)) {
+            ShaderPools* const unit_pools{
+                leased_pools.emplace_back(shader_pools_cache.Acquire()).get()};
+            translation_workers.QueueWork([&, unit, unit_pools] {
+                try {
+                    translated[unit] = translate_program(*recording_envs[unit], unit, *unit_pools,
+                                                         unit_timings[unit]);
+                } catch (...) {
+                    exceptions[unit] = std::current_exception();
+                }
+                done.count_down();
+            });
+        }
+        try {
+            const size_t unit{units.front()};
+            translated[unit] =
+                translate_program(*recording_envs[unit], unit, pools, unit_timings[unit]);
+        } catch (...) {
+            exceptions[units.front()] = std::current_exception();
+        }
+        done.wait();
+
+        for (const size_t unit : units) {
+            if (exceptions[unit]) {
+                std::rethrow_exception(exceptions[unit]);
+            }
+            for (const auto& [pass, time] : unit_timings[unit].passes) {
+                timings.Add(pass, time);
+            }
+        }
+        for (const size_t index : indices) {
+            if (index == 1 && uses_vertex_a) {
+                // VertexB path when VertexA is present.
+                programs[0] = std::move(translated[0]);
+                programs[index] =
+                    MergeDualVertexPrograms(programs[0], translated[index], *recording_envs[index]);
+                is_translated[0] = true;
+            } else {
+                // Normal path
+                programs[index] = std::move(translated[index]);
+            }
+            if (!cached[index]) {
+                cached[index] = stage_cache.AddProgram(
+                    program_key(index), programs[index], std::move(queries[index]),
+                    index == 1 && uses_vertex_a ? std::move(queries[0])
+                                                : VideoCommon::EnvironmentQueries{});
+            }
+            is_translated[index] = true;
+        }
+    }};
+
+    boost::container::static_vector<size_t, Maxwell::MaxShaderProgram> untranslated;
+    for (size_t index = 0; index < Maxwell::MaxShaderProgram; ++index) {
+        if (key.unique_hashes[index] == 0 || (index == 0 && uses_vertex_a && uses_vertex_b)) {
+            // VertexA is only translated to be merged into VertexB
+            continue;
+        }
+        Shader::Environment* const vertex_a_env{index == 1 && uses_vertex_a ? stage_envs[0]
+                                                                             : nullptr};
+        cached[index] =
+            stage_cache.FindProgram(program_key(index), *stage_envs[index], vertex_a_env);
+        if (!cached[index] || cached[index]->requires_layer_emulation) {
+            // Layer emulation generates a passthrough from the program, it has to be translated
+            untranslated.push_back(index);
+        }
+    }
+    translate(untranslated);
+
     // Layer passthrough generation for devices without VK_EXT_shader_viewport_index_layer
     Shader::IR::Program* layer_source_program{};
 
@@ -625,28 +814,20 @@ std::unique_ptr<GraphicsPipeline> PipelineCache::CreateGraphicsPipeline(
             auto topology = MaxwellToOutputTopology(key.state.topology);
             programs[index] = GenerateGeometryPassthrough(pools.inst, pools.block, host_info,
                                                           *layer_source_program, topology);
+            is_translated[index] = true;
             continue;
         }
         if (key.unique_hashes[index] == 0) {
             continue;
         }
-        Shader::Environment& env{*envs[env_index]};
-        ++env_index;
-
-        const u32 cfg_offset{static_cast<u32>(env.StartAddress() + sizeof(Shader::ProgramHeader))};
-        Shader::Maxwell::Flow::CFG cfg(env, pools.flow_block, cfg_offset, index == 0);
-        if (!uses_vertex_a || index != 1) {
-            // Normal path
-            programs[index] = TranslateProgram(pools.inst, pools.block, env, cfg, host_info);
-        } else {
-            // VertexB path when VertexA is present.
-            auto& program_va{programs[0]};
-            auto program_vb{TranslateProgram(pools.inst, pools.block, env, cfg, host_info)};
-            programs[index] = MergeDualVertexPrograms(program_va, program_vb, env);
+        if (cached[index] && !is_translated[index]) {
+            programs[index].stage = cached[index]->stage;
+            programs[index].output_topology = cached[index]->output_topology;
+            programs[index].is_geometry_passthrough = cached[index]->is_geometry_passthrough;
         }
 
         if (Settings::values.dump_shaders) {
-            env.Dump(hash, key.unique_hashes[index]);
+            stage_envs[index]->Dump(hash, key.unique_hashes[index]);
         }
 
         if (programs[index].info.requires_layer_emulation) {
@@ -655,6 +836,7 @@ std::unique_ptr<GraphicsPipeline> PipelineCache::CreateGraphicsPipeline(
     }
     std::array<const Shader::Info*, Maxwell::MaxShaderStage> infos{};
     std::array<vk::ShaderModule, Maxwell::MaxShaderStage> modules;
+    std::array<u64, Maxwell::MaxShaderStage> code_hashes{};
 
     const Shader::IR::Program* previous_stage{};
     Shader::Backend::Bindings binding;
@@ -672,21 +854,49 @@ std::unique_ptr<GraphicsPipeline> PipelineCache::CreateGraphicsPipeline(
         infos[stage_index] = &program.info;
 
         const auto runtime_info{MakeRuntimeInfo(programs, key, program, previous_stage)};
-        ConvertLegacyToGeneric(program, runtime_info);
-        const std::vector<u32> code{EmitSPIRV(profile, runtime_info, program, binding)};
+        // The generated layer passthrough has no guest program to key the stage on
+        const bool is_cacheable{cached[index] != nullptr && !is_emulated_stage};
+        std::string stage_key;
+        VideoCommon::ShaderStageCache::StagePtr cached_stage;
+        if (is_cacheable) {
+            stage_key = VideoCommon::ShaderStageCache::StageKey(*cached[index], runtime_info,
+                                                                binding);
+            cached_stage = stage_cache.FindStage(stage_key);
+        }
+        std::vector<u32> emitted_code;
+        if (cached_stage) {
+            program.info = cached_stage->info;
+            binding = cached_stage->bindings;
+        } else {
+            if (!is_translated[index]) {
+                translate(std::array{index});
+            }
+            const auto emit_start{std::chrono::steady_clock::now()};
+            ConvertLegacyToGeneric(program, runtime_info);
+            emitted_code = EmitSPIRV(profile, runtime_info, program, binding);
+            timings.Add("EmitSPIRV", std::chrono::steady_clock::now() - emit_start);
+            if (is_cacheable) {
+                stage_cache.AddStage(std::move(stage_key), emitted_code, program.info, binding);
+            }
+        }
+        const std::span<const u32> code{cached_stage ? std::span<const u32>{cached_stage->code}
+                                                     : std::span<const u32>{emitted_code}};
         device.SaveShader(code);
         modules[stage_index] = BuildShader(device, code);
+        code_hashes[stage_index] = Common::CityHash64(reinterpret_cast<const char*>(code.data()),
+                                                      code.size_bytes());
         if (device.HasDebuggingToolAttached()) {
             const std::string name{fmt::format("Shader {:016x}", key.unique_hashes[index])};
             modules[stage_index].SetObjectNameEXT(name.c_str());
         }
         previous_stage = &program;
     }
+    stage_cache.AddTimings(timings);
     Common::ThreadWorker* const thread_worker{build_in_parallel ? &workers : nullptr};
     return std::make_unique<GraphicsPipeline>(
         scheduler, buffer_cache, texture_cache, vulkan_pipeline_cache, &shader_notify, device,
-        descriptor_pool, guest_descriptor_queue, thread_worker, statistics, render_pass_cache, key,
-        std::move(modules), infos);
+        descriptor_pool, guest_descriptor_queue, thread_worker, statistics, render_pass_cache,
+        pipeline_library, key, std::move(modules), infos, code_hashes, defer_compile);
 
 } catch (const Shader::Exception& exception) {
     auto hash = key.Hash();
@@ -706,14 +916,14 @@ std::unique_ptr<GraphicsPipeline> PipelineCache::CreateGraphicsPipeline(
     return nullptr;
 }
 
-std::unique_ptr<GraphicsPipeline> PipelineCache::CreateGraphicsPipeline() {
+std::unique_ptr<GraphicsPipeline> PipelineCache::CreateGraphicsPipeline(bool defer_compile) {
     GraphicsEnvironments environments;
     GetGraphicsEnvironments(environments, graphics_key.unique_hashes);
 
     main_pools.ReleaseContents();
-    auto pipeline{
-        CreateGraphicsPipeline(main_pools, graphics_key, environments.Span(), nullptr, true)};
-    if (!pipeline || pipeline_cache_filename.empty()) {
+    auto pipeline{CreateGraphicsPipeline(main_pools, graphics_key, environments.Span(), nullptr,
+                                         true, defer_compile)};
+    if (!pipeline || pipeline->IsDeferred() || pipeline_cache_filename.empty()) {
         return pipeline;
     }
     serialization_thread.QueueWork([this, key = graphics_key, envs = std::move(environments.envs)] {
@@ -7,6 +7,7 @@
 #include <cstddef>
 #include <filesystem>
 #include <memory>
+#include <mutex>
 #include <type_traits>
 #include <unordered_map>
 #include <vector>
@@ -25,8 +26,10 @@
 #include "yuzu_video_core/renderer_vulkan/vk_buffer_cache.h"
 #include "yuzu_video_core/renderer_vulkan/vk_compute_pipeline.h"
 #include "yuzu_video_core/renderer_vulkan/vk_graphics_pipeline.h"
+#include "yuzu_video_core/renderer_vulkan/vk_pipeline_library.h"
 #include "yuzu_video_core/renderer_vulkan/vk_texture_cache.h"
 #include "yuzu_video_core/shader_cache.h"
+#include "yuzu_video_core/shader_stage_cache.h"
 
 namespace Core {
 class System;
@@ -97,6 +100,18 @@ struct ShaderPools {
     Shader::ObjectPool<Shader::Maxwell::Flow::Block> flow_block{32};
 };
 
+/// Recycles the shader pools of stages translated concurrently to the rest of their pipeline.
+class ShaderPoolsCache {
+public:
+    [[nodiscard]] std::unique_ptr<ShaderPools> Acquire();
+
+    void Release(std::unique_ptr<ShaderPools> pools);
+
+private:
+    std::mutex mutex;
+    std::vector<std::unique_ptr<ShaderPools>> free_pools;
+};
+
 class PipelineCache : public VideoCommon::ShaderCache {
 public:
     explicit PipelineCache(Tegra::MaxwellDeviceMemoryManager& device_memory_, const Device& device,
@@ -113,17 +128,22 @@ public:
     void LoadDiskResources(u64 title_id, std::stop_token stop_loading,
                            const VideoCore::DiskResourceLoadCallback& callback);
 
+    /// Reports the compile queue depth and the draws skipped waiting on pipelines this frame.
+    void TickFrame();
+
 private:
     [[nodiscard]] GraphicsPipeline* CurrentGraphicsPipelineSlowPath();
 
-    [[nodiscard]] GraphicsPipeline* BuiltPipeline(GraphicsPipeline* pipeline) const noexcept;
+    [[nodiscard]] GraphicsPipeline* BuiltPipeline(GraphicsPipeline* pipeline) noexcept;
 
-    std::unique_ptr<GraphicsPipeline> CreateGraphicsPipeline();
+    [[nodiscard]] bool CanSkipDraw() const noexcept;
+
+    std::unique_ptr<GraphicsPipeline> CreateGraphicsPipeline(bool defer_compile);
 
     std::unique_ptr<GraphicsPipeline> CreateGraphicsPipeline(
         ShaderPools& pools, const GraphicsPipelineCacheKey& key,
         std::span<Shader::Environment* const> envs, PipelineStatistics* statistics,
-        bool build_in_parallel);
+        bool build_in_parallel, bool defer_compile = false);
 
     std::unique_ptr<ComputePipeline> CreateComputePipeline(const ComputePipelineCacheKey& key,
                                                            const ShaderInfo* shader);
@@ -158,6 +178,8 @@ private:
     std::unordered_map<GraphicsPipelineCacheKey, std::unique_ptr<GraphicsPipeline>> graphics_cache;
 
     ShaderPools main_pools;
+    ShaderPoolsCache shader_pools_cache;
+    VideoCommon::ShaderStageCache stage_cache;
 
     Shader::Profile profile;
     Shader::HostTranslateInfo host_info;
@@ -167,6 +189,11 @@ private:
     std::filesystem::path vulkan_pipeline_cache_filename;
     vk::PipelineCache vulkan_pipeline_cache;
 
+    // Declared after the pipelines so the library parts go before the layouts they were built with
+    PipelineLibrary pipeline_library;
+
+    // Declared before the pipeline workers, their builds wait on stage translations queued here
+    Common::ThreadWorker translation_workers;
     Common::ThreadWorker workers;
     Common::ThreadWorker serialization_thread;
     DynamicFeatures dynamic_features;
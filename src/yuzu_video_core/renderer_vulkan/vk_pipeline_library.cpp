@@ -0,0 +1,108 @@
+// SPDX-FileCopyrightText: Copyright 2024 yuzu Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <algorithm>
+#include <vector>
+
+#include "yuzu_common/logging/log.h"
+#include "yuzu_video_core/renderer_vulkan/vk_pipeline_library.h"
+#include "yuzu_video_core/vulkan_common/vulkan_device.h"
+
+namespace Vulkan {
+namespace {
+/// Parts kept before unreferenced ones are evicted, a few times the shader sets of a large game.
+constexpr size_t MAX_PARTS = 8192;
+/// Eviction goes below the cap so it does not run again on the next frame.
+constexpr size_t EVICT_TARGET = MAX_PARTS * 3 / 4;
+/// Share of the compile budget given to optimized relinks.
+constexpr size_t RELINK_BUDGET_DIVISOR = 4;
+} // Anonymous namespace
+
+PipelineLibrary::PipelineLibrary(const Device& device, size_t compile_budget_)
+    : enabled{device.IsExtGraphicsPipelineLibrarySupported()}, compile_budget{compile_budget_},
+      relink_budget{std::max<size_t>(compile_budget_ / RELINK_BUDGET_DIVISOR, 1)} {
+    if (enabled) {
+        LOG_INFO(Render_Vulkan, "Linking graphics pipelines from pipeline libraries");
+    }
+}
+
+PipelineLibrary::~PipelineLibrary() = default;
+
+bool PipelineLibrary::Contains(const std::string& key) const {
+    std::scoped_lock lock{mutex};
+    const auto it{parts.find(key)};
+    if (it == parts.end() || !it->second->is_built.load(std::memory_order::acquire)) {
+        return false;
+    }
+    it->second->last_used_frame.store(current_frame.load(std::memory_order::relaxed),
+                                      std::memory_order::relaxed);
+    return true;
+}
+
+PipelineLibrary::PartRef PipelineLibrary::GetOrCreate(
+    const std::string& key, const std::function<vk::Pipeline()>& create) {
+    std::shared_ptr<Entry> entry;
+    {
+        std::scoped_lock lock{mutex};
+        auto& slot{parts[key]};
+        if (!slot) {
+            slot = std::make_shared<Entry>();
+        }
+        entry = slot;
+    }
+    entry->last_used_frame.store(current_frame.load(std::memory_order::relaxed),
+                                 std::memory_order::relaxed);
+    std::call_once(entry->once, [&entry, &create] {
+        entry->pipeline = create();
+        entry->is_built.store(true, std::memory_order::release);
+    });
+    const vk::Pipeline* const pipeline{&entry->pipeline};
+    return PartRef{std::move(entry), pipeline};
+}
+
+void PipelineLibrary::TickFrame() {
+    draws_skipped_last_frame = draws_skipped.exchange(0, std::memory_order::relaxed);
+    const size_t depth{CompileQueueDepth()};
+    if (draws_skipped_last_frame != 0 || depth != 0) {
+        LOG_DEBUG(Render_Vulkan, "Pipeline compile queue depth={}, draws skipped={}", depth,
+                  draws_skipped_last_frame);
+    }
+    current_frame.fetch_add(1, std::memory_order::relaxed);
+    EvictUnusedParts();
+}
+
+void PipelineLibrary::EvictUnusedParts() {
+    // Destroyed outside the lock, the map only hands out new references while holding it.
+    std::vector<std::shared_ptr<Entry>> evicted;
+    {
+        std::scoped_lock lock{mutex};
+        if (parts.size() <= MAX_PARTS) {
+            return;
+        }
+        using Iterator = decltype(parts)::iterator;
+        std::vector<Iterator> candidates;
+        for (auto it = parts.begin(); it != parts.end(); ++it) {
+            if (it->second.use_count() == 1 &&
+                it->second->is_built.load(std::memory_order::acquire)) {
+                candidates.push_back(it);
+            }
+        }
+        const size_t count{std::min(candidates.size(), parts.size() - EVICT_TARGET)};
+        std::ranges::nth_element(candidates, candidates.begin() + count, {}, [](Iterator it) {
+            return it->second->last_used_frame.load(std::memory_order::relaxed);
+        });
+        evicted.reserve(count);
+        for (size_t i = 0; i < count; ++i) {
+            evicted.push_back(std::move(candidates[i]->second));
+            parts.erase(candidates[i]);
+        }
+    }
+    LOG_DEBUG(Render_Vulkan, "Evicted {} unused pipeline library parts", evicted.size());
+}
+
+size_t PipelineLibrary::NumParts() const {
+    std::scoped_lock lock{mutex};
+    return parts.size();
+}
+
+} // namespace Vulkan
@@ -0,0 +1,142 @@
+// SPDX-FileCopyrightText: Copyright 2024 yuzu Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+
+#include "yuzu_common/common_types.h"
+#include "yuzu_video_core/vulkan_common/vulkan_wrapper.h"
+
+namespace Vulkan {
+
+class Device;
+
+/// Appends the object representation of a plain create info structure to a library part key.
+template <typename T>
+void AppendLibraryKey(std::string& key, const T& value) {
+    static_assert(std::is_trivially_copyable_v<T>);
+    key.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+/// Appends the element count and every element of a range to a library part key.
+template <typename Range>
+void AppendLibraryKeyRange(std::string& key, const Range& range) {
+    AppendLibraryKey(key, static_cast<u32>(std::size(range)));
+    for (const auto& value : range) {
+        AppendLibraryKey(key, value);
+    }
+}
+
+/// Shares VK_EXT_graphics_pipeline_library parts between graphics pipelines and keeps the
+/// accounting of background pipeline compilation.
+///
+/// Parts are keyed by the create info state they were built from, so every pipeline variant of a
+/// shader set that only differs in vertex input or output state reuses the compiled shader parts
+/// and only pays for a fast link.
+///
+/// Linked pipelines do not depend on their parts, so once the part count goes over a cap the least
+/// recently used parts that no link holds on to are destroyed. A later variant of the same shader
+/// set compiles them again.
+class PipelineLibrary {
+public:
+    /// Keeps a part alive while pipelines are linked from it.
+    using PartRef = std::shared_ptr<const vk::Pipeline>;
+
+    explicit PipelineLibrary(const Device& device, size_t compile_budget);
+    ~PipelineLibrary();
+
+    PipelineLibrary(const PipelineLibrary&) = delete;
+    PipelineLibrary& operator=(const PipelineLibrary&) = delete;
+
+    /// Returns true when graphics pipelines are linked from library parts.
+    [[nodiscard]] bool IsEnabled() const noexcept {
+        return enabled;
+    }
+
+    /// Returns true when a part for the key has already been compiled.
+    [[nodiscard]] bool Contains(const std::string& key) const;
+
+    /// Returns the part for the key, compiling it with create on first use. Concurrent callers
+    /// for the same key wait for a single compilation. The part is not evicted while the returned
+    /// reference is held.
+    PartRef GetOrCreate(const std::string& key, const std::function<vk::Pipeline()>& create);
+
+    /// Returns true when another pipeline compilation can be queued without exceeding the budget.
+    [[nodiscard]] bool CanQueueCompile() const noexcept {
+        return queue_depth.load(std::memory_order::relaxed) < compile_budget;
+    }
+
+    void MarkCompileQueued() noexcept {
+        ++queue_depth;
+    }
+
+    void MarkCompileDone() noexcept {
+        --queue_depth;
+    }
+
+    /// Returns true when an optimized relink of a fast linked pipeline can be queued. Relinks only
+    /// make working pipelines faster, so they have a smaller budget of their own and yield to
+    /// compilations that draws are waiting on.
+    [[nodiscard]] bool CanQueueRelink() const noexcept {
+        return relink_depth.load(std::memory_order::relaxed) < relink_budget &&
+               queue_depth.load(std::memory_order::relaxed) < compile_budget / 2;
+    }
+
+    void MarkRelinkQueued() noexcept {
+        ++relink_depth;
+    }
+
+    void MarkRelinkDone() noexcept {
+        --relink_depth;
+    }
+
+    void MarkDrawSkipped() noexcept {
+        ++draws_skipped;
+    }
+
+    /// Closes the statistics of the current frame and evicts parts over the cap.
+    void TickFrame();
+
+    [[nodiscard]] size_t CompileQueueDepth() const noexcept {
+        return queue_depth.load(std::memory_order::relaxed);
+    }
+
+    [[nodiscard]] u64 DrawsSkippedLastFrame() const noexcept {
+        return draws_skipped_last_frame;
+    }
+
+    [[nodiscard]] size_t NumParts() const;
+
+private:
+    struct Entry {
+        std::once_flag once;
+        vk::Pipeline pipeline;
+        std::atomic_bool is_built{false};
+        std::atomic<u64> last_used_frame{};
+    };
+
+    void EvictUnusedParts();
+
+    bool enabled{};
+    size_t compile_budget{};
+    size_t relink_budget{};
+
+    mutable std::mutex mutex;
+    std::unordered_map<std::string, std::shared_ptr<Entry>> parts;
+
+    std::atomic<u64> current_frame{};
+    std::atomic_size_t queue_depth{};
+    std::atomic_size_t relink_depth{};
+    std::atomic<u64> draws_skipped{};
+    u64 draws_skipped_last_frame{};
+};
+
+} // namespace Vulkan
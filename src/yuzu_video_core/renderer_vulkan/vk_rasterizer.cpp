@@ -187,10 +187,12 @@ RasterizerVulkan::RasterizerVulkan(Core::Frontend::EmuWindow& emu_window_, Tegra
       texture_cache_runtime{
           device,     scheduler,         memory_allocator, staging_pool,
           blit_image, render_pass_cache, descriptor_pool,  compute_pass_descriptor_queue},
-      texture_cache(texture_cache_runtime, device_memory),
+      residency(device.GetDeviceLocalMemory(), TextureCacheParams::HAS_DEVICE_MEMORY_INFO,
+                device.HasUnifiedMemory()),
+      texture_cache(texture_cache_runtime, device_memory, residency),
       buffer_cache_runtime(device, memory_allocator, scheduler, staging_pool,
                            guest_descriptor_queue, compute_pass_descriptor_queue, descriptor_pool),
-      buffer_cache(device_memory, buffer_cache_runtime),
+      buffer_cache(device_memory, buffer_cache_runtime, residency),
       query_cache_runtime(this, device_memory, buffer_cache, device, memory_allocator, scheduler,
                           staging_pool, compute_pass_descriptor_queue, descriptor_pool),
       query_cache(gpu, *this, device_memory, query_cache_runtime),
@@ -669,6 +671,25 @@ void RasterizerVulkan::OnCacheInvalidation(DAddr addr, u64 size) {
     pipeline_cache.InvalidateRegion(addr, size);
 }
 
+void RasterizerVulkan::OnCacheInvalidation(
+    std::span<const std::pair<DAddr, std::size_t>> sequences) {
+    {
+        std::scoped_lock lock{texture_cache.mutex};
+        for (const auto& [addr, size] : sequences) {
+            texture_cache.WriteMemory(addr, size);
+        }
+    }
+    {
+        std::scoped_lock lock{buffer_cache.mutex};
+        for (const auto& [addr, size] : sequences) {
+            buffer_cache.WriteMemory(addr, size);
+        }
+    }
+    for (const auto& [addr, size] : sequences) {
+        pipeline_cache.InvalidateRegion(addr, size);
+    }
+}
+
 void RasterizerVulkan::InvalidateGPUCache() {
     gpu.InvalidateGPUCache();
 }
@@ -762,10 +783,18 @@ void RasterizerVulkan::FlushCommands() {
 
 void RasterizerVulkan::TickFrame() {
     draw_counter = 0;
+    scheduler.TickFrame();
     guest_descriptor_queue.TickFrame();
     compute_pass_descriptor_queue.TickFrame();
     fence_manager.TickFrame();
     staging_pool.TickFrame();
+    pipeline_cache.TickFrame();
+    // If we can obtain the memory info, use it instead of the estimate. It has to be reported
+    // before the budget of the frame is computed.
+    if (texture_cache_runtime.CanReportMemoryUsage()) {
+        residency.SetReportedUsage(texture_cache_runtime.GetDeviceMemoryUsage());
+    }
+    residency.TickFrame();
     {
         std::scoped_lock lock{texture_cache.mutex};
         texture_cache.TickFrame();
@@ -859,6 +888,7 @@ void RasterizerVulkan::FlushWork() {
     if (draw_counter < DRAWS_TO_DISPATCH) {
         // Send recorded tasks to the worker thread
         scheduler.DispatchWork();
+        scheduler.MarkDrawBoundary();
         return;
     }
     // Otherwise (every certain number of draws) flush execution.
@@ -1,6 +1,8 @@
 // SPDX-FileCopyrightText: Copyright 2019 yuzu Emulator Project
 // SPDX-License-Identifier: GPL-2.0-or-later
 
+#include <algorithm>
+#include <chrono>
 #include <memory>
 #include <mutex>
 #include <thread>
@@ -8,7 +10,9 @@
 
 #include "yuzu_video_core/renderer_vulkan/vk_query_cache.h"
 
+#include "yuzu_common/logging/log.h"
 #include "yuzu_common/microprofile.h"
+#include "yuzu_common/settings.h"
 #include "yuzu_common/thread.h"
 #include "yuzu_video_core/renderer_vulkan/vk_command_pool.h"
 #include "yuzu_video_core/renderer_vulkan/vk_master_semaphore.h"
@@ -22,6 +26,70 @@ namespace Vulkan {
 
 MICROPROFILE_DECLARE(Vulkan_WaitForWorker);
 
+namespace {
+/// Number of draw boundaries (8 draws each) recorded into a render pass before it is sharded
+constexpr u32 BOUNDARIES_PER_SHARD = 8;
+
+size_t NumRecorders() {
+    return std::clamp<size_t>(std::thread::hardware_concurrency() / 4, 1, 4);
+}
+
+u64 NanosecondsSince(std::chrono::steady_clock::time_point start) {
+    const auto elapsed{std::chrono::steady_clock::now() - start};
+    return static_cast<u64>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+}
+
+void RecordBeginRenderPass(vk::CommandBuffer cmdbuf, VkRenderPass renderpass,
+                           VkFramebuffer framebuffer, VkExtent2D render_area,
+                           VkSubpassContents contents) {
+    const VkRenderPassBeginInfo renderpass_bi{
+        .sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO,
+        .pNext = nullptr,
+        .renderPass = renderpass,
+        .framebuffer = framebuffer,
+        .renderArea =
+            {
+                .offset = {.x = 0, .y = 0},
+                .extent = render_area,
+            },
+        .clearValueCount = 0,
+        .pClearValues = nullptr,
+    };
+    cmdbuf.BeginRenderPass(renderpass_bi, contents);
+}
+
+void RecordEndRenderPass(vk::CommandBuffer cmdbuf, u32 num_images,
+                         const std::array<VkImage, 9>& images,
+                         const std::array<VkImageSubresourceRange, 9>& ranges) {
+    std::array<VkImageMemoryBarrier, 9> barriers;
+    for (size_t i = 0; i < num_images; ++i) {
+        barriers[i] = VkImageMemoryBarrier{
+            .sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
+            .pNext = nullptr,
+            .srcAccessMask =
+                VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT,
+            .dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT |
+                             VK_ACCESS_COLOR_ATTACHMENT_READ_BIT |
+                             VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT |
+                             VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT |
+                             VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT,
+            .oldLayout = VK_IMAGE_LAYOUT_GENERAL,
+            .newLayout = VK_IMAGE_LAYOUT_GENERAL,
+            .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+            .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+            .image = images[i],
+            .subresourceRange = ranges[i],
+        };
+    }
+    cmdbuf.EndRenderPass();
+    cmdbuf.PipelineBarrier(VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT |
+                               VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT |
+                               VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+                           VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, 0, nullptr, nullptr,
+                           vk::Span(barriers.data(), num_images));
+}
+} // Anonymous namespace
+
 void Scheduler::CommandChunk::ExecuteAll(vk::CommandBuffer cmdbuf,
                                          vk::CommandBuffer upload_cmdbuf) {
     auto command = first;
@@ -43,10 +111,21 @@ Scheduler::Scheduler(const Device& device_, StateTracker& state_tracker_)
       command_pool{std::make_unique<CommandPool>(*master_semaphore, device)} {
     AcquireNewChunk();
     AllocateWorkerCommandBuffer();
+    if (Settings::values.vulkan_parallel_recording.GetValue()) {
+        recorders = std::make_unique<RecorderWorker>(NumRecorders(), "VulkanRecorder", [this] {
+            return std::make_unique<CommandPool>(*master_semaphore, device,
+                                                 VK_COMMAND_BUFFER_LEVEL_SECONDARY);
+        });
+    }
     worker_thread = std::jthread([this](std::stop_token token) { WorkerThread(token); });
 }
 
-Scheduler::~Scheduler() = default;
+Scheduler::~Scheduler() {
+    // Let the recorder of an open shard finish so its thread can be joined
+    if (shard) {
+        CloseShard();
+    }
+}
 
 u64 Scheduler::Flush(VkSemaphore signal_semaphore, VkSemaphore wait_semaphore) {
     // When flushing, we only send data to the worker thread; no waiting is necessary.
@@ -67,25 +146,34 @@ void Scheduler::WaitWorker() {
     MICROPROFILE_SCOPE(Vulkan_WaitForWorker);
     DispatchWork();
 
-    // Ensure the queue is drained.
-    {
-        std::unique_lock ql{queue_mutex};
-        event_cv.wait(ql, [this] { return work_queue.empty(); });
+    // Wait for the recorder of the open shard to catch up with the dispatched chunks.
+    if (shard) {
+        const u64 pushed_chunks = shard->pushed_chunks;
+        u64 recorded_chunks{};
+        while ((recorded_chunks = shard->recorded_chunks.load(std::memory_order_acquire)) <
+               pushed_chunks) {
+            shard->recorded_chunks.wait(recorded_chunks, std::memory_order_acquire);
+        }
     }
 
-    // Now wait for execution to finish.
-    std::scoped_lock el{execution_mutex};
+    // Now wait for the worker to execute everything dispatched to it.
+    u64 completed{};
+    while ((completed = completed_work.load(std::memory_order_acquire)) < dispatched_work) {
+        completed_work.wait(completed, std::memory_order_acquire);
+    }
 }
 
 void Scheduler::DispatchWork() {
     if (chunk->Empty()) {
         return;
     }
-    {
-        std::scoped_lock ql{queue_mutex};
-        work_queue.push(std::move(chunk));
+    if (shard) {
+        // Chunks recorded inside a shard go straight to its recorder
+        shard->stream.EmplaceWait(std::move(chunk));
+        ++shard->pushed_chunks;
+    } else {
+        PushWork(WorkItem{.chunk = std::move(chunk)});
     }
-    event_cv.notify_all();
     AcquireNewChunk();
 }
 
@@ -104,20 +192,8 @@ void Scheduler::RequestRenderpass(const Framebuffer* framebuffer) {
     state.render_area = render_area;
 
     Record([renderpass, framebuffer_handle, render_area](vk::CommandBuffer cmdbuf) {
-        const VkRenderPassBeginInfo renderpass_bi{
-            .sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO,
-            .pNext = nullptr,
-            .renderPass = renderpass,
-            .framebuffer = framebuffer_handle,
-            .renderArea =
-                {
-                    .offset = {.x = 0, .y = 0},
-                    .extent = render_area,
-                },
-            .clearValueCount = 0,
-            .pClearValues = nullptr,
-        };
-        cmdbuf.BeginRenderPass(renderpass_bi, VK_SUBPASS_CONTENTS_INLINE);
+        RecordBeginRenderPass(cmdbuf, renderpass, framebuffer_handle, render_area,
+                              VK_SUBPASS_CONTENTS_INLINE);
     });
     num_renderpass_images = framebuffer->NumImages();
     renderpass_images = framebuffer->Images();
@@ -145,57 +221,186 @@ bool Scheduler::UpdateRescaling(bool is_rescaling) {
     return true;
 }
 
-void Scheduler::WorkerThread(std::stop_token stop_token) {
-    Common::SetCurrentThreadName("VulkanWorker");
-
-    const auto TryPopQueue{[this](auto& work) -> bool {
-        if (work_queue.empty()) {
-            return false;
-        }
-
-        work = std::move(work_queue.front());
-        work_queue.pop();
-        event_cv.notify_all();
-        return true;
-    }};
+void Scheduler::MarkDrawBoundary() {
+    if (!recorders || !state.renderpass) {
+        return;
+    }
+    if (++draw_boundaries < BOUNDARIES_PER_SHARD) {
+        return;
+    }
+    draw_boundaries = 0;
 
-    while (!stop_token.stop_requested()) {
-        std::unique_ptr<CommandChunk> work;
+    // Queries can't stay active across render pass instances recorded in different command
+    // buffers, close them before restarting the render pass.
+    query_cache->NotifySegment(false);
+    if (shard) {
+        CloseShard();
+    } else {
+        Record([num_images = num_renderpass_images, images = renderpass_images,
+                ranges = renderpass_image_ranges](vk::CommandBuffer cmdbuf) {
+            RecordEndRenderPass(cmdbuf, num_images, images, ranges);
+        });
+    }
+    OpenShard();
+    query_cache->NotifySegment(true);
+}
 
-        {
-            std::unique_lock lk{queue_mutex};
+void Scheduler::TickFrame() {
+    LOG_DEBUG(Render_Vulkan,
+              "Worker recorded for {} us, {} submits in {} us, idle for {} us, {} shards",
+              timings.record_nanoseconds.exchange(0) / 1000, timings.submits.exchange(0),
+              timings.submit_nanoseconds.exchange(0) / 1000,
+              timings.idle_nanoseconds.exchange(0) / 1000, timings.shards.exchange(0));
+}
 
-            // Wait for work.
-            Common::CondvarWait(event_cv, lk, stop_token, [&] { return TryPopQueue(work); });
+void Scheduler::WorkerThread(std::stop_token stop_token) {
+    Common::SetCurrentThreadName("VulkanWorker");
 
-            // If we've been asked to stop, we're done.
-            if (stop_token.stop_requested()) {
-                return;
-            }
+    while (!stop_token.stop_requested()) {
+        WorkItem work;
 
-            // Exchange lock ownership so that we take the execution lock before
-            // the queue lock goes out of scope. This allows us to force execution
-            // to complete in the next step.
-            std::exchange(lk, std::unique_lock{execution_mutex});
+        // Wait for work.
+        const auto idle_start{std::chrono::steady_clock::now()};
+        work_queue.PopWait(work, stop_token);
 
-            // Perform the work, tracking whether the chunk was a submission
-            // before executing.
-            const bool has_submit = work->HasSubmit();
-            work->ExecuteAll(current_cmdbuf, current_upload_cmdbuf);
+        // If we've been asked to stop, we're done.
+        if (stop_token.stop_requested()) {
+            return;
+        }
+        timings.idle_nanoseconds += NanosecondsSince(idle_start);
+
+        if (work.shard) {
+            ExecuteShard(*work.shard);
+        } else {
+            // Perform the work, tracking whether the chunk was a submission before executing.
+            const bool has_submit = work.chunk->HasSubmit();
+            const auto record_start{std::chrono::steady_clock::now()};
+            worker_submit_nanoseconds = 0;
+            work.chunk->ExecuteAll(current_cmdbuf, current_upload_cmdbuf);
+            const u64 record_nanoseconds{NanosecondsSince(record_start)};
+            timings.record_nanoseconds += record_nanoseconds - worker_submit_nanoseconds;
 
             // If the chunk was a submission, reallocate the command buffer.
             if (has_submit) {
                 AllocateWorkerCommandBuffer();
             }
+
+            // Recycle the chunk back to the reserve, it is released when the reserve is full.
+            chunk_reserve.TryEmplace(std::move(work.chunk));
         }
 
-        {
-            std::scoped_lock rl{reserve_mutex};
+        completed_work.fetch_add(1, std::memory_order_release);
+        completed_work.notify_all();
+    }
+}
+
+void Scheduler::ExecuteShard(Shard& work) {
+    const auto idle_start{std::chrono::steady_clock::now()};
+    work.is_recorded.wait(false, std::memory_order_acquire);
+    timings.idle_nanoseconds += NanosecondsSince(idle_start);
 
-            // Recycle the chunk back to the reserve.
-            chunk_reserve.emplace_back(std::move(work));
+    current_upload_cmdbuf.ExecuteCommands(*work.upload_cmdbuf);
+    RecordBeginRenderPass(current_cmdbuf, work.renderpass, work.framebuffer, work.render_area,
+                          VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS);
+    current_cmdbuf.ExecuteCommands(*work.cmdbuf);
+    RecordEndRenderPass(current_cmdbuf, work.num_images, work.images, work.image_ranges);
+
+    for (std::unique_ptr<CommandChunk>& used_chunk : work.used_chunks) {
+        chunk_reserve.TryEmplace(std::move(used_chunk));
+    }
+}
+
+void Scheduler::RecordShard(Shard& work, CommandPool& pool) {
+    const VkCommandBufferInheritanceInfo renderpass_ii{
+        .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO,
+        .pNext = nullptr,
+        .renderPass = work.renderpass,
+        .subpass = 0,
+        .framebuffer = work.framebuffer,
+        .occlusionQueryEnable = VK_FALSE,
+        .queryFlags = 0,
+        .pipelineStatistics = 0,
+    };
+    const VkCommandBufferInheritanceInfo upload_ii{
+        .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO,
+        .pNext = nullptr,
+        .renderPass = nullptr,
+        .subpass = 0,
+        .framebuffer = nullptr,
+        .occlusionQueryEnable = VK_FALSE,
+        .queryFlags = 0,
+        .pipelineStatistics = 0,
+    };
+    work.cmdbuf = vk::CommandBuffer(pool.Commit(), device.GetDispatchLoader());
+    work.cmdbuf.Begin({
+        .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
+        .pNext = nullptr,
+        .flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT |
+                 VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT,
+        .pInheritanceInfo = &renderpass_ii,
+    });
+    work.upload_cmdbuf = vk::CommandBuffer(pool.Commit(), device.GetDispatchLoader());
+    work.upload_cmdbuf.Begin({
+        .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
+        .pNext = nullptr,
+        .flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT,
+        .pInheritanceInfo = &upload_ii,
+    });
+
+    while (true) {
+        std::unique_ptr<CommandChunk> recorded_chunk;
+        work.stream.PopWait(recorded_chunk);
+        if (!recorded_chunk) {
+            break;
         }
+        const auto record_start{std::chrono::steady_clock::now()};
+        recorded_chunk->ExecuteAll(work.cmdbuf, work.upload_cmdbuf);
+        timings.record_nanoseconds += NanosecondsSince(record_start);
+
+        work.used_chunks.push_back(std::move(recorded_chunk));
+        work.recorded_chunks.fetch_add(1, std::memory_order_release);
+        work.recorded_chunks.notify_all();
     }
+    work.upload_cmdbuf.End();
+    work.cmdbuf.End();
+
+    work.is_recorded.store(true, std::memory_order_release);
+    work.is_recorded.notify_all();
+}
+
+void Scheduler::OpenShard() {
+    // Everything recorded so far is executed inline by the primary worker
+    DispatchWork();
+
+    shard = std::make_shared<Shard>();
+    shard->renderpass = state.renderpass;
+    shard->framebuffer = state.framebuffer;
+    shard->render_area = state.render_area;
+    shard->num_images = num_renderpass_images;
+    shard->images = renderpass_images;
+    shard->image_ranges = renderpass_image_ranges;
+    recorders->QueueWork([this, work = shard](std::unique_ptr<CommandPool>* pool) {
+        RecordShard(*work, **pool);
+    });
+    ++timings.shards;
+
+    // Secondary command buffers don't inherit any state
+    InvalidateState();
+}
+
+void Scheduler::CloseShard() {
+    DispatchWork();
+    shard->stream.EmplaceWait(nullptr);
+    PushWork(WorkItem{.shard = std::move(shard)});
+    shard = nullptr;
+
+    // Command buffer state is undefined after executing the shard
+    InvalidateState();
+}
+
+void Scheduler::PushWork(WorkItem&& item) {
+    ++dispatched_work;
+    work_queue.EmplaceWait(std::move(item));
 }
 
 void Scheduler::AllocateWorkerCommandBuffer() {
@@ -237,6 +442,7 @@ u64 Scheduler::SubmitExecution(VkSemaphore signal_semaphore, VkSemaphore wait_se
             on_submit();
         }
 
+        const auto submit_start{std::chrono::steady_clock::now()};
         std::scoped_lock lock{submit_mutex};
         switch (const VkResult result = master_semaphore->SubmitQueue(
                     cmdbuf, upload_cmdbuf, signal_semaphore, wait_semaphore, signal_value)) {
@@ -249,6 +455,9 @@ u64 Scheduler::SubmitExecution(VkSemaphore signal_semaphore, VkSemaphore wait_se
             vk::Check(result);
             break;
         }
+        worker_submit_nanoseconds = NanosecondsSince(submit_start);
+        timings.submit_nanoseconds += worker_submit_nanoseconds;
+        ++timings.submits;
     });
     chunk->MarkSubmit();
     DispatchWork();
@@ -285,56 +494,35 @@ void Scheduler::EndPendingOperations() {
     // query_cache->DisableStreams();
 #endif
     query_cache->NotifySegment(false);
-    EndRenderPass();
+    EndRenderPass(false);
 }
 
-void Scheduler::EndRenderPass() {
+void Scheduler::EndRenderPass(bool resume_queries) {
     if (!state.renderpass) {
         return;
     }
-    Record([num_images = num_renderpass_images, images = renderpass_images,
-            ranges = renderpass_image_ranges](vk::CommandBuffer cmdbuf) {
-        std::array<VkImageMemoryBarrier, 9> barriers;
-        for (size_t i = 0; i < num_images; ++i) {
-            barriers[i] = VkImageMemoryBarrier{
-                .sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
-                .pNext = nullptr,
-                .srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT |
-                                 VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT,
-                .dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT |
-                                 VK_ACCESS_COLOR_ATTACHMENT_READ_BIT |
-                                 VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT |
-                                 VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT |
-                                 VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT,
-                .oldLayout = VK_IMAGE_LAYOUT_GENERAL,
-                .newLayout = VK_IMAGE_LAYOUT_GENERAL,
-                .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
-                .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
-                .image = images[i],
-                .subresourceRange = ranges[i],
-            };
+    draw_boundaries = 0;
+    if (shard) {
+        // Queries begun in the shard have to end in its command buffer
+        query_cache->NotifySegment(false);
+        CloseShard();
+        if (resume_queries) {
+            query_cache->NotifySegment(true);
         }
-        cmdbuf.EndRenderPass();
-        cmdbuf.PipelineBarrier(VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT |
-                                   VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT |
-                                   VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
-                               VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, 0, nullptr, nullptr,
-                               vk::Span(barriers.data(), num_images));
-    });
+    } else {
+        Record([num_images = num_renderpass_images, images = renderpass_images,
+                ranges = renderpass_image_ranges](vk::CommandBuffer cmdbuf) {
+            RecordEndRenderPass(cmdbuf, num_images, images, ranges);
+        });
+    }
     state.renderpass = nullptr;
     num_renderpass_images = 0;
 }
 
 void Scheduler::AcquireNewChunk() {
-    std::scoped_lock rl{reserve_mutex};
-
-    if (chunk_reserve.empty()) {
-        // If we don't have anything reserved, we need to make a new chunk.
+    // If we don't have anything reserved, we need to make a new chunk.
+    if (!chunk_reserve.TryPop(chunk)) {
         chunk = std::make_unique<CommandChunk>();
-    } else {
-        // Otherwise, we can just take from the reserve.
-        chunk = std::move(chunk_reserve.back());
-        chunk_reserve.pop_back();
     }
 }
 
@@ -3,17 +3,20 @@
 
 #pragma once
 
-#include <condition_variable>
+#include <atomic>
 #include <cstddef>
 #include <functional>
 #include <memory>
+#include <mutex>
 #include <thread>
 #include <utility>
-#include <queue>
+#include <vector>
 
 #include "yuzu_common/alignment.h"
+#include "yuzu_common/bounded_threadsafe_queue.h"
 #include "yuzu_common/common_types.h"
 #include "yuzu_common/polyfill_thread.h"
+#include "yuzu_common/thread_worker.h"
 #include "yuzu_video_core/renderer_vulkan/vk_master_semaphore.h"
 #include "yuzu_video_core/vulkan_common/vulkan_wrapper.h"
 
@@ -68,6 +71,13 @@ public:
     /// Invalidates current command buffer state except for render passes
     void InvalidateState();
 
+    /// Notifies that a batch of draws has been recorded. Long render passes are split here into
+    /// shards recorded in parallel when parallel recording is enabled.
+    void MarkDrawBoundary();
+
+    /// Reports and resets the recording metrics of the last frame.
+    void TickFrame();
+
     /// Assigns the query cache.
     void SetQueryCache(VideoCommon::QueryCacheBase<QueryCacheParams>& query_cache_) {
         query_cache = &query_cache_;
@@ -215,8 +225,58 @@ private:
         bool rescaling_defined = false;
     };
 
+    /// Render pass instance recorded into secondary command buffers by a recorder thread while
+    /// the GPU thread keeps recording. The primary worker executes it once it has been closed.
+    struct Shard {
+        VkRenderPass renderpass = nullptr;
+        VkFramebuffer framebuffer = nullptr;
+        VkExtent2D render_area = {0, 0};
+        u32 num_images = 0;
+        std::array<VkImage, 9> images{};
+        std::array<VkImageSubresourceRange, 9> image_ranges{};
+
+        /// Chunks to record, a null chunk closes the shard.
+        Common::SPSCQueue<std::unique_ptr<CommandChunk>, 0x40> stream;
+        /// Chunks already recorded, recycled by the primary worker.
+        std::vector<std::unique_ptr<CommandChunk>> used_chunks;
+
+        vk::CommandBuffer cmdbuf;
+        vk::CommandBuffer upload_cmdbuf;
+
+        u64 pushed_chunks = 0;
+        std::atomic<u64> recorded_chunks{};
+        std::atomic<bool> is_recorded{};
+    };
+
+    /// Work executed in order by the primary worker, either a chunk or a closed shard.
+    struct WorkItem {
+        std::unique_ptr<CommandChunk> chunk;
+        std::shared_ptr<Shard> shard;
+    };
+
+    /// Time spent by the workers since the last frame.
+    struct RecordTimings {
+        std::atomic<u64> record_nanoseconds{};
+        std::atomic<u64> submit_nanoseconds{};
+        std::atomic<u64> idle_nanoseconds{};
+        std::atomic<u64> submits{};
+        std::atomic<u64> shards{};
+    };
+
+    using RecorderWorker = Common::StatefulThreadWorker<std::unique_ptr<CommandPool>>;
+
     void WorkerThread(std::stop_token stop_token);
 
+    void ExecuteShard(Shard& work);
+
+    void RecordShard(Shard& work, CommandPool& pool);
+
+    void OpenShard();
+
+    void CloseShard();
+
+    void PushWork(WorkItem&& item);
+
     void AllocateWorkerCommandBuffer();
 
     u64 SubmitExecution(VkSemaphore signal_semaphore, VkSemaphore wait_semaphore);
@@ -225,7 +285,9 @@ private:
 
     void EndPendingOperations();
 
-    void EndRenderPass();
+    /// Ends the current render pass, queries paused to close a shard are resumed unless the
+    /// render pass ends for a submission.
+    void EndRenderPass(bool resume_queries = true);
 
     void AcquireNewChunk();
 
@@ -249,12 +311,17 @@ private:
     std::array<VkImage, 9> renderpass_images{};
     std::array<VkImageSubresourceRange, 9> renderpass_image_ranges{};
 
-    std::queue<std::unique_ptr<CommandChunk>> work_queue;
-    std::vector<std::unique_ptr<CommandChunk>> chunk_reserve;
-    std::mutex execution_mutex;
-    std::mutex reserve_mutex;
-    std::mutex queue_mutex;
-    std::condition_variable_any event_cv;
+    std::shared_ptr<Shard> shard;
+    u32 draw_boundaries = 0;
+
+    RecordTimings timings;
+    u64 worker_submit_nanoseconds = 0;
+
+    Common::SPSCQueue<WorkItem> work_queue;
+    Common::SPSCQueue<std::unique_ptr<CommandChunk>, 0x100> chunk_reserve;
+    u64 dispatched_work = 0;
+    std::atomic<u64> completed_work{};
+    std::unique_ptr<RecorderWorker> recorders;
     std::jthread worker_thread;
 };
 
@@ -0,0 +1,172 @@
+// SPDX-FileCopyrightText: Copyright 2024 yuzu Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
+#include <limits>
+
+#include "yuzu_common/literals.h"
+#include "yuzu_common/logging/log.h"
+#include "yuzu_video_core/residency_manager.h"
+
+namespace VideoCommon {
+namespace {
+using namespace Common::Literals;
+
+constexpr s64 TARGET_THRESHOLD = 4_GiB;
+constexpr s64 DEFAULT_EXPECTED_MEMORY = 1_GiB + 125_MiB;
+constexpr s64 DEFAULT_CRITICAL_MEMORY = 1_GiB + 625_MiB;
+/// Smallest eviction budget handed out in a frame with pressure
+constexpr s64 MIN_EVICTION_BUDGET = 16_MiB;
+/// System memory left to other processes before unified memory devices are considered critical
+constexpr u64 MIN_AVAILABLE_SYSTEM_MEMORY = 1_GiB;
+
+u64 GetAvailableSystemMemory() {
+#ifdef _WIN32
+    MEMORYSTATUSEX status{};
+    status.dwLength = sizeof(status);
+    if (!GlobalMemoryStatusEx(&status)) {
+        return std::numeric_limits<u64>::max();
+    }
+    return status.ullAvailPhys;
+#else
+    const long pages = sysconf(_SC_AVPHYS_PAGES);
+    const long page_size = sysconf(_SC_PAGESIZE);
+    if (pages < 0 || page_size < 0) {
+        return std::numeric_limits<u64>::max();
+    }
+    return static_cast<u64>(pages) * static_cast<u64>(page_size);
+#endif
+}
+} // Anonymous namespace
+
+ResidencyManager::ResidencyManager(u64 device_local_memory_, bool has_device_memory_info,
+                                   bool is_unified_memory_)
+    : is_unified_memory{is_unified_memory_} {
+    if (!has_device_memory_info) {
+        expected_memory = DEFAULT_EXPECTED_MEMORY + 512_MiB;
+        critical_memory = DEFAULT_CRITICAL_MEMORY + 1_GiB;
+        minimum_memory = 0;
+        return;
+    }
+    const s64 device_local_memory = static_cast<s64>(device_local_memory_);
+    const s64 min_spacing_expected = device_local_memory - 1_GiB;
+    const s64 min_spacing_critical = device_local_memory - 512_MiB;
+    const s64 mem_threshold = std::min(device_local_memory, TARGET_THRESHOLD);
+    const s64 min_vacancy_expected = (6 * mem_threshold) / 10;
+    const s64 min_vacancy_critical = (2 * mem_threshold) / 10;
+    expected_memory = static_cast<u64>(
+        std::max(std::min(device_local_memory - min_vacancy_expected, min_spacing_expected),
+                 DEFAULT_EXPECTED_MEMORY));
+    critical_memory = static_cast<u64>(
+        std::max(std::min(device_local_memory - min_vacancy_critical, min_spacing_critical),
+                 DEFAULT_CRITICAL_MEMORY));
+    minimum_memory = static_cast<u64>(std::max<s64>((device_local_memory - mem_threshold) / 2, 0));
+}
+
+void ResidencyManager::Track(Category category, s64 bytes) noexcept {
+    usage[static_cast<size_t>(category)].fetch_add(static_cast<u64>(bytes),
+                                                   std::memory_order::relaxed);
+}
+
+void ResidencyManager::SetReportedUsage(u64 bytes) noexcept {
+    tracked_usage_at_report.store(TrackedUsage(), std::memory_order::relaxed);
+    reported_usage.store(bytes, std::memory_order::relaxed);
+    has_reported_usage.store(true, std::memory_order::relaxed);
+}
+
+void ResidencyManager::TickFrame() {
+    if (is_unified_memory) {
+        // Resources compete with the rest of the system for memory on these devices
+        is_system_memory_low.store(GetAvailableSystemMemory() < MIN_AVAILABLE_SYSTEM_MEMORY,
+                                   std::memory_order::relaxed);
+    }
+    const u64 total{TotalUsage()};
+    const Pressure pressure{GetPressure()};
+    s64 budget{};
+    switch (pressure) {
+    case Pressure::None:
+        break;
+    case Pressure::Low:
+    case Pressure::High: {
+        const u64 target{pressure == Pressure::High ? expected_memory : minimum_memory};
+        const s64 excess{static_cast<s64>(total - std::min(total, target))};
+        budget = std::max(excess / static_cast<s64>(EVICTION_SPREAD_FRAMES), MIN_EVICTION_BUDGET);
+        break;
+    }
+    case Pressure::Critical:
+        budget = std::numeric_limits<s64>::max();
+        break;
+    }
+    eviction_budget.store(budget, std::memory_order::relaxed);
+
+    u64 num_evictions{};
+    for (const auto& count : evictions) {
+        num_evictions += count.load(std::memory_order::relaxed);
+    }
+    if (num_evictions != last_num_evictions) {
+        LOG_DEBUG(HW_GPU,
+                  "Residency: images={} MiB, buffers={} MiB, total={} MiB, evictions={}/{}",
+                  Usage(Category::Image) / 1_MiB, Usage(Category::Buffer) / 1_MiB, total / 1_MiB,
+                  EvictionCount(Category::Image), EvictionCount(Category::Buffer));
+        last_num_evictions = num_evictions;
+    }
+}
+
+ResidencyManager::Pressure ResidencyManager::GetPressure() const noexcept {
+    const u64 total{TotalUsage()};
+    if (total >= critical_memory || is_system_memory_low.load(std::memory_order::relaxed)) {
+        return Pressure::Critical;
+    }
+    if (total >= expected_memory) {
+        return Pressure::High;
+    }
+    if (total > minimum_memory) {
+        return Pressure::Low;
+    }
+    return Pressure::None;
+}
+
+bool ResidencyManager::CanEvict() const noexcept {
+    return eviction_budget.load(std::memory_order::relaxed) > 0;
+}
+
+bool ResidencyManager::ShouldEvict(ResidencyInfo& info) const noexcept {
+    if (GetPressure() == Pressure::Critical || info.uses < FREQUENT_USES) {
+        return true;
+    }
+    info.uses /= 2;
+    return false;
+}
+
+void ResidencyManager::RecordEviction(Category category, u64 bytes) noexcept {
+    const size_t index{static_cast<size_t>(category)};
+    evictions[index].fetch_add(1, std::memory_order::relaxed);
+    evicted_bytes[index].fetch_add(bytes, std::memory_order::relaxed);
+    eviction_budget.fetch_sub(static_cast<s64>(bytes), std::memory_order::relaxed);
+}
+
+u64 ResidencyManager::TotalUsage() const noexcept {
+    const u64 tracked{TrackedUsage()};
+    if (!has_reported_usage.load(std::memory_order::relaxed)) {
+        return tracked;
+    }
+    // Apply what was allocated and freed since the report, evictions have to lower the pressure
+    // before the driver reports again
+    const u64 reported{reported_usage.load(std::memory_order::relaxed)};
+    const u64 tracked_at_report{tracked_usage_at_report.load(std::memory_order::relaxed)};
+    if (tracked >= tracked_at_report) {
+        return reported + (tracked - tracked_at_report);
+    }
+    return reported - std::min(reported, tracked_at_report - tracked);
+}
+
+u64 ResidencyManager::TrackedUsage() const noexcept {
+    return Usage(Category::Image) + Usage(Category::Buffer);
+}
+
+} // namespace VideoCommon
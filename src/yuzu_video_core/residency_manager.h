@@ -0,0 +1,117 @@
+// SPDX-FileCopyrightText: Copyright 2024 yuzu Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+
+#include "yuzu_common/common_types.h"
+
+namespace VideoCommon {
+
+/// Access history of a cached resource used to rank it as an eviction candidate.
+struct ResidencyInfo {
+    static constexpr u32 MAX_USES = 64;
+
+    /// Counts the frames the resource has been used in, once per frame.
+    void Touch(u64 frame_tick) noexcept {
+        if (frame_tick != last_frame) {
+            last_frame = frame_tick;
+            uses = std::min(uses + 1, MAX_USES);
+        }
+    }
+
+    u64 last_frame = ~0ULL;
+    u32 uses = 0;
+};
+
+/// Shares a single device memory budget between the texture and buffer caches.
+///
+/// Both caches report the memory they allocate and free, the manager derives the memory pressure
+/// from the total and hands out a per frame eviction budget so reclaiming memory is spread over
+/// several frames instead of happening in a single garbage collection spike.
+class ResidencyManager {
+public:
+    enum class Category : u32 {
+        Image,
+        Buffer,
+    };
+    static constexpr size_t NUM_CATEGORIES = 2;
+
+    enum class Pressure : u32 {
+        None,     ///< Below the minimum, nothing has to be evicted
+        Low,      ///< Old resources can be evicted
+        High,     ///< Resources with pending downloads can be evicted
+        Critical, ///< Anything that is not in use can be evicted
+    };
+
+    /// @param device_local_memory Memory the device can use for resources
+    /// @param has_device_memory_info True when device_local_memory is known
+    /// @param is_unified_memory True when the device allocates from system memory
+    explicit ResidencyManager(u64 device_local_memory, bool has_device_memory_info,
+                              bool is_unified_memory);
+
+    /// Accounts bytes allocated (positive) or freed (negative) by a cache.
+    void Track(Category category, s64 bytes) noexcept;
+
+    /// Replaces the estimated total with the usage reported by the driver, allocations and frees
+    /// tracked after the report are applied on top of it until the next report.
+    void SetReportedUsage(u64 bytes) noexcept;
+
+    /// Computes the pressure and the eviction budget of the next frame.
+    void TickFrame();
+
+    [[nodiscard]] Pressure GetPressure() const noexcept;
+
+    /// Returns true when eviction budget is left for this frame.
+    [[nodiscard]] bool CanEvict() const noexcept;
+
+    /// Returns true when the resource should be evicted under the current pressure. Frequently
+    /// used resources survive and have their history decayed instead, unless pressure is critical.
+    [[nodiscard]] bool ShouldEvict(ResidencyInfo& info) const noexcept;
+
+    /// Accounts an eviction against the budget of the frame.
+    void RecordEviction(Category category, u64 bytes) noexcept;
+
+    [[nodiscard]] u64 TotalUsage() const noexcept;
+
+    [[nodiscard]] u64 Usage(Category category) const noexcept {
+        return usage[static_cast<size_t>(category)].load(std::memory_order::relaxed);
+    }
+
+    [[nodiscard]] u64 EvictionCount(Category category) const noexcept {
+        return evictions[static_cast<size_t>(category)].load(std::memory_order::relaxed);
+    }
+
+    [[nodiscard]] u64 EvictedBytes(Category category) const noexcept {
+        return evicted_bytes[static_cast<size_t>(category)].load(std::memory_order::relaxed);
+    }
+
+private:
+    /// Number of frames a memory excess is reclaimed over when pressure is not critical
+    static constexpr u64 EVICTION_SPREAD_FRAMES = 8;
+    /// Uses above which a resource gets a second chance before being evicted
+    static constexpr u32 FREQUENT_USES = 8;
+
+    /// Returns the sum of the allocations tracked by the caches.
+    [[nodiscard]] u64 TrackedUsage() const noexcept;
+
+    u64 minimum_memory{};
+    u64 expected_memory{};
+    u64 critical_memory{};
+    bool is_unified_memory{};
+
+    std::array<std::atomic<u64>, NUM_CATEGORIES> usage{};
+    std::array<std::atomic<u64>, NUM_CATEGORIES> evictions{};
+    std::array<std::atomic<u64>, NUM_CATEGORIES> evicted_bytes{};
+    std::atomic<u64> reported_usage{};
+    std::atomic<u64> tracked_usage_at_report{};
+    std::atomic_bool has_reported_usage{};
+    std::atomic_bool is_system_memory_low{};
+    std::atomic<s64> eviction_budget{};
+    u64 last_num_evictions{};
+};
+
+} // namespace VideoCommon
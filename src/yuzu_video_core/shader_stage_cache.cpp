@@ -0,0 +1,341 @@
+// SPDX-FileCopyrightText: Copyright 2024 yuzu Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <algorithm>
+#include <array>
+#include <bitset>
+#include <chrono>
+#include <type_traits>
+
+#include "yuzu_common/cityhash.h"
+#include "yuzu_common/logging/log.h"
+#include "yuzu_shader_recompiler/exception.h"
+#include "yuzu_video_core/shader_stage_cache.h"
+
+namespace VideoCommon {
+namespace {
+template <typename T>
+void AppendKey(std::string& key, const T& value) {
+    static_assert(std::is_trivially_copyable_v<T>);
+    key.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+template <size_t N>
+void AppendKey(std::string& key, const std::bitset<N>& bits) {
+    for (size_t word = 0; word < N; word += 64) {
+        u64 value{};
+        for (size_t bit = word; bit < std::min(word + 64, N); ++bit) {
+            value |= static_cast<u64>(bits[bit]) << (bit - word);
+        }
+        AppendKey(key, value);
+    }
+}
+
+template <typename T>
+void AppendKey(std::string& key, const std::optional<T>& value) {
+    AppendKey(key, value.has_value());
+    if (value) {
+        AppendKey(key, *value);
+    }
+}
+
+double Percent(u64 hits, u64 misses) {
+    const u64 total{hits + misses};
+    return total == 0 ? 0.0 : static_cast<double>(hits) * 100.0 / static_cast<double>(total);
+}
+} // Anonymous namespace
+
+void EnvironmentQueries::Record(Type type, u32 first, u32 second, u64 result) {
+    const auto it{std::ranges::find_if(queries, [&](const Query& query) {
+        return query.type == type && query.first == first && query.second == second;
+    })};
+    if (it == queries.end()) {
+        queries.push_back({type, first, second, result});
+    }
+}
+
+void EnvironmentQueries::RecordInstruction(u32 address) {
+    read_lowest = std::min(read_lowest, address);
+    read_highest = std::max(read_highest, address);
+}
+
+bool EnvironmentQueries::Matches(Shader::Environment& env) const try {
+    if (read_lowest <= read_highest) {
+        // Touch the bounds of the translated code so the environment tracks the same read range
+        // it would have after building the control flow graph
+        static_cast<void>(env.ReadInstruction(read_lowest));
+        static_cast<void>(env.ReadInstruction(read_highest));
+    }
+    return std::ranges::all_of(queries, [&env](const Query& query) {
+        switch (query.type) {
+        case Type::CbufValue:
+            return env.ReadCbufValue(query.first, query.second) == query.result;
+        case Type::TextureType:
+            return static_cast<u64>(env.ReadTextureType(query.first)) == query.result;
+        case Type::TexturePixelFormat:
+            return static_cast<u64>(env.ReadTexturePixelFormat(query.first)) == query.result;
+        case Type::TexturePixelFormatInteger:
+            return static_cast<u64>(env.IsTexturePixelFormatInteger(query.first)) == query.result;
+        case Type::ViewportTransformState:
+            return env.ReadViewportTransformState() == query.result;
+        case Type::TextureBoundBuffer:
+            return env.TextureBoundBuffer() == query.result;
+        case Type::HLEMacroState:
+            return static_cast<u64>(env.HasHLEMacroState()) == query.result;
+        case Type::ReplaceConstBuffer: {
+            const auto replace{env.GetReplaceConstBuffer(query.first, query.second)};
+            return (replace ? static_cast<u64>(*replace) : ~0ULL) == query.result;
+        }
+        }
+        return false;
+    });
+} catch (const Shader::Exception& exception) {
+    // The environment can not answer a recorded query, e.g. the code moved out of its bounds
+    LOG_DEBUG(Shader, "Cached program does not match: {}", exception.what());
+    return false;
+}
+
+RecordingEnvironment::RecordingEnvironment(Shader::Environment& env_, EnvironmentQueries& queries_)
+    : env{env_}, queries{queries_} {
+    sph = env.SPH();
+    gp_passthrough_mask = env.GpPassthroughMask();
+    stage = env.ShaderStage();
+    start_address = env.StartAddress();
+    is_proprietary_driver = env.IsProprietaryDriver();
+}
+
+u64 RecordingEnvironment::ReadInstruction(u32 address) {
+    queries.RecordInstruction(address);
+    return env.ReadInstruction(address);
+}
+
+u32 RecordingEnvironment::ReadCbufValue(u32 cbuf_index, u32 cbuf_offset) {
+    const u32 value{env.ReadCbufValue(cbuf_index, cbuf_offset)};
+    queries.Record(EnvironmentQueries::Type::CbufValue, cbuf_index, cbuf_offset, value);
+    return value;
+}
+
+Shader::TextureType RecordingEnvironment::ReadTextureType(u32 raw_handle) {
+    const Shader::TextureType type{env.ReadTextureType(raw_handle)};
+    queries.Record(EnvironmentQueries::Type::TextureType, raw_handle, 0, static_cast<u64>(type));
+    return type;
+}
+
+Shader::TexturePixelFormat RecordingEnvironment::ReadTexturePixelFormat(u32 raw_handle) {
+    const Shader::TexturePixelFormat format{env.ReadTexturePixelFormat(raw_handle)};
+    queries.Record(EnvironmentQueries::Type::TexturePixelFormat, raw_handle, 0,
+                   static_cast<u64>(format));
+    return format;
+}
+
+bool RecordingEnvironment::IsTexturePixelFormatInteger(u32 raw_handle) {
+    const bool is_integer{env.IsTexturePixelFormatInteger(raw_handle)};
+    queries.Record(EnvironmentQueries::Type::TexturePixelFormatInteger, raw_handle, 0,
+                   is_integer ? 1 : 0);
+    return is_integer;
+}
+
+u32 RecordingEnvironment::ReadViewportTransformState() {
+    const u32 state{env.ReadViewportTransformState()};
+    queries.Record(EnvironmentQueries::Type::ViewportTransformState, 0, 0, state);
+    return state;
+}
+
+u32 RecordingEnvironment::TextureBoundBuffer() const {
+    const u32 buffer{env.TextureBoundBuffer()};
+    queries.Record(EnvironmentQueries::Type::TextureBoundBuffer, 0, 0, buffer);
+    return buffer;
+}
+
+u32 RecordingEnvironment::LocalMemorySize() const {
+    return env.LocalMemorySize();
+}
+
+u32 RecordingEnvironment::SharedMemorySize() const {
+    return env.SharedMemorySize();
+}
+
+std::array<u32, 3> RecordingEnvironment::WorkgroupSize() const {
+    return env.WorkgroupSize();
+}
+
+bool RecordingEnvironment::HasHLEMacroState() const {
+    const bool has_state{env.HasHLEMacroState()};
+    queries.Record(EnvironmentQueries::Type::HLEMacroState, 0, 0, has_state ? 1 : 0);
+    return has_state;
+}
+
+std::optional<Shader::ReplaceConstant> RecordingEnvironment::GetReplaceConstBuffer(u32 bank,
+                                                                                  u32 offset) {
+    const auto replace{env.GetReplaceConstBuffer(bank, offset)};
+    queries.Record(EnvironmentQueries::Type::ReplaceConstBuffer, bank, offset,
+                   replace ? static_cast<u64>(*replace) : ~0ULL);
+    return replace;
+}
+
+void RecordingEnvironment::Dump(u64 pipeline_hash, u64 shader_hash) {
+    env.Dump(pipeline_hash, shader_hash);
+}
+
+size_t ShaderStageCache::ProgramKeyHash::operator()(const ProgramKey& key) const noexcept {
+    const std::array<u64, 3> data{key.unique_hash, key.vertex_a_hash, key.index};
+    return static_cast<size_t>(
+        Common::CityHash64(reinterpret_cast<const char*>(data.data()), sizeof(data)));
+}
+
+ShaderStageCache::ProgramPtr ShaderStageCache::FindProgram(const ProgramKey& key,
+                                                           Shader::Environment& env,
+                                                           Shader::Environment* vertex_a_env) {
+    std::vector<ProgramPtr> candidates;
+    {
+        std::scoped_lock lock{mutex};
+        const auto it{programs.find(key)};
+        if (it != programs.end()) {
+            candidates = it->second.variants;
+            program_lru.splice(program_lru.begin(), program_lru, it->second.lru);
+        }
+    }
+    // Environments read guest memory, match them without holding the lock
+    const auto it{std::ranges::find_if(candidates, [&](const ProgramPtr& program) {
+        return program->queries.Matches(env) &&
+               (!vertex_a_env || program->vertex_a_queries.Matches(*vertex_a_env));
+    })};
+    ProgramPtr result{it != candidates.end() ? *it : nullptr};
+
+    std::scoped_lock lock{mutex};
+    ++(result ? program_hits : program_misses);
+    return result;
+}
+
+ShaderStageCache::ProgramPtr ShaderStageCache::AddProgram(const ProgramKey& key,
+                                                          const Shader::IR::Program& program,
+                                                          EnvironmentQueries queries,
+                                                          EnvironmentQueries vertex_a_queries) {
+    auto entry{std::make_shared<Program>(Program{
+        .id = 0,
+        .stage = program.stage,
+        .output_topology = program.output_topology,
+        .is_geometry_passthrough = program.is_geometry_passthrough,
+        .requires_layer_emulation = program.info.requires_layer_emulation,
+        .queries = std::move(queries),
+        .vertex_a_queries = std::move(vertex_a_queries),
+    })};
+    std::scoped_lock lock{mutex};
+    entry->id = next_program_id++;
+
+    const auto [it, is_new] = programs.try_emplace(key);
+    if (is_new) {
+        program_lru.push_front(&it->first);
+        it->second.lru = program_lru.begin();
+    } else {
+        program_lru.splice(program_lru.begin(), program_lru, it->second.lru);
+    }
+    it->second.variants.push_back(entry);
+    EvictPrograms();
+    return entry;
+}
+
+std::string ShaderStageCache::StageKey(const Program& program,
+                                       const Shader::RuntimeInfo& runtime_info,
+                                       const Shader::Backend::Bindings& bindings) {
+    std::string key;
+    key.reserve(256);
+    AppendKey(key, program.id);
+    AppendKey(key, bindings);
+    AppendKey(key, runtime_info.generic_input_types);
+    AppendKey(key, runtime_info.previous_stage_stores.mask);
+    AppendKey(key, runtime_info.previous_stage_legacy_stores_mapping.size());
+    for (const auto& [legacy, generic] : runtime_info.previous_stage_legacy_stores_mapping) {
+        AppendKey(key, legacy);
+        AppendKey(key, generic);
+    }
+    AppendKey(key, runtime_info.convert_depth_mode);
+    AppendKey(key, runtime_info.force_early_z);
+    AppendKey(key, runtime_info.tess_primitive);
+    AppendKey(key, runtime_info.tess_spacing);
+    AppendKey(key, runtime_info.tess_clockwise);
+    AppendKey(key, runtime_info.input_topology);
+    AppendKey(key, runtime_info.fixed_state_point_size);
+    AppendKey(key, runtime_info.alpha_test_func);
+    AppendKey(key, runtime_info.alpha_test_reference);
+    AppendKey(key, runtime_info.y_negate);
+    AppendKey(key, runtime_info.glasm_use_storage_buffers);
+    AppendKey(key, runtime_info.xfb_count);
+    for (u32 index = 0; index < runtime_info.xfb_count; ++index) {
+        AppendKey(key, runtime_info.xfb_varyings[index]);
+    }
+    return key;
+}
+
+ShaderStageCache::StagePtr ShaderStageCache::FindStage(const std::string& key) {
+    std::scoped_lock lock{mutex};
+    const auto it{stages.find(key)};
+    if (it == stages.end()) {
+        ++stage_misses;
+        return nullptr;
+    }
+    ++stage_hits;
+    stage_lru.splice(stage_lru.begin(), stage_lru, it->second.lru);
+    return it->second.stage;
+}
+
+void ShaderStageCache::AddStage(std::string key, std::span<const u32> code,
+                                const Shader::Info& info,
+                                const Shader::Backend::Bindings& bindings) {
+    auto entry{std::make_shared<Stage>(Stage{
+        .code = std::vector<u32>(code.begin(), code.end()),
+        .info = info,
+        .bindings = bindings,
+    })};
+    std::scoped_lock lock{mutex};
+    const auto [it, is_new] = stages.try_emplace(std::move(key));
+    if (!is_new) {
+        return;
+    }
+    stage_lru.push_front(&it->first);
+    it->second = StageEntry{
+        .stage = std::move(entry),
+        .lru = stage_lru.begin(),
+    };
+    EvictStages();
+}
+
+void ShaderStageCache::EvictPrograms() {
+    // Program ids are never reused, so stages of an evicted program can no longer be hit and
+    // age out of the stage cache on their own
+    while (programs.size() > MAX_PROGRAM_KEYS) {
+        programs.erase(programs.find(*program_lru.back()));
+        program_lru.pop_back();
+    }
+}
+
+void ShaderStageCache::EvictStages() {
+    while (stages.size() > MAX_STAGES) {
+        stages.erase(stages.find(*stage_lru.back()));
+        stage_lru.pop_back();
+    }
+}
+
+void ShaderStageCache::AddTimings(const Shader::Maxwell::PassTimings& pass_timings) {
+    std::scoped_lock lock{mutex};
+    for (const auto& [pass, time] : pass_timings.passes) {
+        timings.Add(pass, time);
+    }
+}
+
+void ShaderStageCache::Report() const {
+    std::scoped_lock lock{mutex};
+    if (program_hits + program_misses == 0) {
+        return;
+    }
+    LOG_INFO(Shader, "Program cache: {} hits, {} misses ({:.1f}% hit rate)", program_hits,
+             program_misses, Percent(program_hits, program_misses));
+    LOG_INFO(Shader, "Stage cache: {} hits, {} misses ({:.1f}% hit rate)", stage_hits,
+             stage_misses, Percent(stage_hits, stage_misses));
+    for (const auto& [pass, time] : timings.passes) {
+        LOG_INFO(Shader, "{}: {:.2f} ms", pass,
+                 std::chrono::duration<double, std::milli>(time).count());
+    }
+}
+
+} // namespace VideoCommon
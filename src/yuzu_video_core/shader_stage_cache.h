@@ -0,0 +1,196 @@
+// SPDX-FileCopyrightText: Copyright 2024 yuzu Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <limits>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "yuzu_common/common_types.h"
+#include "yuzu_shader_recompiler/backend/bindings.h"
+#include "yuzu_shader_recompiler/environment.h"
+#include "yuzu_shader_recompiler/frontend/ir/program.h"
+#include "yuzu_shader_recompiler/frontend/maxwell/translate_program.h"
+#include "yuzu_shader_recompiler/runtime_info.h"
+#include "yuzu_shader_recompiler/shader_info.h"
+
+namespace VideoCommon {
+
+/// State queries a program made to its environment while it was translated.
+class EnvironmentQueries {
+public:
+    enum class Type : u32 {
+        CbufValue,
+        TextureType,
+        TexturePixelFormat,
+        TexturePixelFormatInteger,
+        ViewportTransformState,
+        TextureBoundBuffer,
+        HLEMacroState,
+        ReplaceConstBuffer,
+    };
+
+    void Record(Type type, u32 first, u32 second, u64 result);
+
+    void RecordInstruction(u32 address);
+
+    /// Returns true when the environment answers every recorded query the same way.
+    [[nodiscard]] bool Matches(Shader::Environment& env) const;
+
+private:
+    struct Query {
+        Type type;
+        u32 first;
+        u32 second;
+        u64 result;
+    };
+
+    std::vector<Query> queries;
+    u32 read_lowest{std::numeric_limits<u32>::max()};
+    u32 read_highest{};
+};
+
+/// Environment forwarding to another one that records the state queries made through it.
+class RecordingEnvironment final : public Shader::Environment {
+public:
+    explicit RecordingEnvironment(Shader::Environment& env_, EnvironmentQueries& queries_);
+
+    u64 ReadInstruction(u32 address) override;
+
+    u32 ReadCbufValue(u32 cbuf_index, u32 cbuf_offset) override;
+
+    Shader::TextureType ReadTextureType(u32 raw_handle) override;
+
+    Shader::TexturePixelFormat ReadTexturePixelFormat(u32 raw_handle) override;
+
+    bool IsTexturePixelFormatInteger(u32 raw_handle) override;
+
+    u32 ReadViewportTransformState() override;
+
+    u32 TextureBoundBuffer() const override;
+
+    u32 LocalMemorySize() const override;
+
+    u32 SharedMemorySize() const override;
+
+    std::array<u32, 3> WorkgroupSize() const override;
+
+    bool HasHLEMacroState() const override;
+
+    std::optional<Shader::ReplaceConstant> GetReplaceConstBuffer(u32 bank, u32 offset) override;
+
+    void Dump(u64 pipeline_hash, u64 shader_hash) override;
+
+private:
+    Shader::Environment& env;
+    EnvironmentQueries& queries;
+};
+
+/// In memory cache of translated programs and the code emitted for them.
+///
+/// Programs are looked up by their unique hash and validated against the state queries made
+/// while translating them, a hit provides what is needed to build the runtime info of a stage
+/// without running the frontend. Stages are keyed by program, runtime info and the bindings
+/// used by the previous stages, a hit provides the emitted code and final shader info.
+///
+/// Both are capped, the least recently used entries are evicted first. Entries are shared with
+/// the pipelines being built from them, so evicting one never frees it from under a build.
+class ShaderStageCache {
+public:
+    /// Identifies a guest program, a VertexB merged with VertexA also includes the VertexA hash.
+    struct ProgramKey {
+        u64 unique_hash;
+        u64 vertex_a_hash;
+        size_t index;
+
+        bool operator==(const ProgramKey&) const noexcept = default;
+    };
+
+    struct ProgramKeyHash {
+        size_t operator()(const ProgramKey& key) const noexcept;
+    };
+
+    /// Frontend results of a program needed to build the runtime info of its stages.
+    struct Program {
+        u64 id;
+        Shader::Stage stage;
+        Shader::OutputTopology output_topology;
+        bool is_geometry_passthrough;
+        bool requires_layer_emulation;
+        EnvironmentQueries queries;
+        EnvironmentQueries vertex_a_queries;
+    };
+
+    struct Stage {
+        std::vector<u32> code;
+        Shader::Info info;
+        Shader::Backend::Bindings bindings;
+    };
+
+    using ProgramPtr = std::shared_ptr<const Program>;
+    using StagePtr = std::shared_ptr<const Stage>;
+
+    /// Returns the translation of a program matching the current environments, if any.
+    [[nodiscard]] ProgramPtr FindProgram(const ProgramKey& key, Shader::Environment& env,
+                                         Shader::Environment* vertex_a_env);
+
+    ProgramPtr AddProgram(const ProgramKey& key, const Shader::IR::Program& program,
+                          EnvironmentQueries queries, EnvironmentQueries vertex_a_queries);
+
+    [[nodiscard]] static std::string StageKey(const Program& program,
+                                              const Shader::RuntimeInfo& runtime_info,
+                                              const Shader::Backend::Bindings& bindings);
+
+    [[nodiscard]] StagePtr FindStage(const std::string& key);
+
+    void AddStage(std::string key, std::span<const u32> code, const Shader::Info& info,
+                  const Shader::Backend::Bindings& bindings);
+
+    /// Accumulates the time spent in each pass of a pipeline translation.
+    void AddTimings(const Shader::Maxwell::PassTimings& pass_timings);
+
+    /// Logs the hit rates and the time spent in each translation pass.
+    void Report() const;
+
+private:
+    /// Program keys kept, each holds the few variants of a guest program seen so far
+    static constexpr size_t MAX_PROGRAM_KEYS = 8192;
+    /// Stages kept, each holds the emitted code of a stage, tens of KiB for large shaders
+    static constexpr size_t MAX_STAGES = 2048;
+
+    struct ProgramEntry {
+        std::vector<ProgramPtr> variants;
+        std::list<const ProgramKey*>::iterator lru;
+    };
+
+    struct StageEntry {
+        StagePtr stage;
+        std::list<const std::string*>::iterator lru;
+    };
+
+    void EvictPrograms();
+    void EvictStages();
+
+    mutable std::mutex mutex;
+    std::unordered_map<ProgramKey, ProgramEntry, ProgramKeyHash> programs;
+    std::unordered_map<std::string, StageEntry> stages;
+    /// Keys of the entries above, the most recently used first
+    std::list<const ProgramKey*> program_lru;
+    std::list<const std::string*> stage_lru;
+    u64 next_program_id{};
+
+    u64 program_hits{};
+    u64 program_misses{};
+    u64 stage_hits{};
+    u64 stage_misses{};
+    Shader::Maxwell::PassTimings timings;
+};
+
+} // namespace VideoCommon
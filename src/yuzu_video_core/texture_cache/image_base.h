@@ -10,6 +10,7 @@
 
 #include "yuzu_common/common_funcs.h"
 #include "yuzu_common/common_types.h"
+#include "yuzu_video_core/residency_manager.h"
 #include "yuzu_video_core/texture_cache/image_info.h"
 #include "yuzu_video_core/texture_cache/image_view_info.h"
 #include "yuzu_video_core/texture_cache/types.h"
@@ -103,6 +104,7 @@ struct ImageBase {
 
     u64 modification_tick = 0;
     size_t lru_index = SIZE_MAX;
+    ResidencyInfo residency;
 
     std::array<u32, MAX_MIP_LEVELS> mip_level_offsets{};
 
@@ -13,6 +13,7 @@
 #include <unordered_set>
 #include <vector>
 #include <boost/container/small_vector.hpp>
+#include <tsl/robin_map.h>
 #include <queue>
 
 #include "yuzu_common/common_types.h"
@@ -27,12 +28,14 @@
 #include "yuzu_video_core/control/channel_state_cache.h"
 #include "yuzu_video_core/delayed_destruction_ring.h"
 #include "yuzu_video_core/engines/fermi_2d.h"
+#include "yuzu_video_core/residency_manager.h"
 #include "yuzu_video_core/surface.h"
 #include "yuzu_video_core/texture_cache/descriptor_table.h"
 #include "yuzu_video_core/texture_cache/image_base.h"
 #include "yuzu_video_core/texture_cache/image_info.h"
 #include "yuzu_video_core/texture_cache/image_view_base.h"
 #include "yuzu_video_core/texture_cache/render_targets.h"
+#include "yuzu_video_core/texture_cache/transcode_cache.h"
 #include "yuzu_video_core/texture_cache/types.h"
 #include "yuzu_video_core/textures/texture.h"
 
@@ -63,7 +66,12 @@ struct AsyncDecodeContext {
     std::atomic_bool complete;
 };
 
-using TextureCacheGPUMap = std::unordered_map<u64, std::vector<ImageId>, Common::IdentityHash<u64>>;
+/// Page tables are probed for every bound texture, so they use open addressing with the ids of the
+/// few images overlapping a page stored inline.
+using TextureCachePageImages = boost::container::small_vector<ImageId, 4>;
+using TextureCachePageMaps = boost::container::small_vector<ImageMapId, 4>;
+using TextureCacheGPUMap = tsl::robin_map<u64, TextureCachePageImages, Common::IdentityHash<u64>>;
+using TextureCacheCPUMap = tsl::robin_map<u64, TextureCachePageMaps, Common::IdentityHash<u64>>;
 
 class TextureCacheChannelInfo : public ChannelInfo {
 public:
@@ -82,8 +90,8 @@ public:
     std::vector<SamplerId> compute_sampler_ids;
     std::vector<ImageViewId> compute_image_view_ids;
 
-    std::unordered_map<TICEntry, ImageViewId> image_views;
-    std::unordered_map<TSCEntry, SamplerId> samplers;
+    tsl::robin_map<TICEntry, ImageViewId> image_views;
+    tsl::robin_map<TSCEntry, SamplerId> samplers;
 
     TextureCacheGPUMap* gpu_page_table;
     TextureCacheGPUMap* sparse_page_table;
@@ -107,9 +115,6 @@ class TextureCache : public VideoCommon::ChannelSetupCaches<TextureCacheChannelI
 
     static constexpr size_t UNSET_CHANNEL{std::numeric_limits<size_t>::max()};
 
-    static constexpr s64 TARGET_THRESHOLD = 4_GiB;
-    static constexpr s64 DEFAULT_EXPECTED_MEMORY = 1_GiB + 125_MiB;
-    static constexpr s64 DEFAULT_CRITICAL_MEMORY = 1_GiB + 625_MiB;
     static constexpr size_t GC_EMERGENCY_COUNTS = 2;
 
     using Runtime = typename P::Runtime;
@@ -129,7 +134,7 @@ class TextureCache : public VideoCommon::ChannelSetupCaches<TextureCacheChannelI
     };
 
 public:
-    explicit TextureCache(Runtime&, Tegra::MaxwellDeviceMemoryManager&);
+    explicit TextureCache(Runtime&, Tegra::MaxwellDeviceMemoryManager&, ResidencyManager&);
 
     /// Notify the cache that a new frame has been queued
     void TickFrame();
@@ -419,29 +424,29 @@ private:
     bool ScaleDown(Image& image);
     u64 GetScaledImageSizeBytes(const ImageBase& image);
 
+    /// Returns the estimated device memory used by an image without its scaled copy
+    u64 GetImageSizeBytes(const ImageBase& image);
+
     void QueueAsyncDecode(Image& image, ImageId image_id);
     void TickAsyncDecode();
 
     Runtime& runtime;
 
     Tegra::MaxwellDeviceMemoryManager& device_memory;
+    ResidencyManager& residency;
     std::deque<TextureCacheGPUMap> gpu_page_table_storage;
 
     RenderTargets render_targets;
 
-    std::unordered_map<RenderTargets, FramebufferId> framebuffers;
+    tsl::robin_map<RenderTargets, FramebufferId> framebuffers;
 
-    std::unordered_map<u64, std::vector<ImageMapId>, Common::IdentityHash<u64>> page_table;
+    TextureCacheCPUMap page_table;
     std::unordered_map<ImageId, boost::container::small_vector<ImageViewId, 16>> sparse_views;
 
     DAddr virtual_invalid_space{};
 
     bool has_deleted_images = false;
     bool is_rescaling = false;
-    u64 total_used_memory = 0;
-    u64 minimum_memory;
-    u64 expected_memory;
-    u64 critical_memory;
 
     struct BufferDownload {
         GPUVAddr address;
@@ -489,6 +494,7 @@ private:
     u64 modification_tick = 0;
     u64 frame_tick = 0;
 
+    TranscodeCache transcode_cache;
     Common::ThreadWorker texture_decode_worker{1, "TextureDecoder"};
     std::vector<std::unique_ptr<AsyncDecodeContext>> async_decodes;
 
@@ -0,0 +1,324 @@
+// SPDX-FileCopyrightText: Copyright 2024 yuzu Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <chrono>
+#include <cstring>
+#include <string>
+#include <system_error>
+
+#include <fmt/format.h>
+
+#include "yuzu_common/cityhash.h"
+#include "yuzu_common/fs/file.h"
+#include "yuzu_common/fs/fs.h"
+#include "yuzu_common/fs/path_util.h"
+#include "yuzu_common/literals.h"
+#include "yuzu_common/logging/log.h"
+#include "yuzu_common/settings.h"
+#include "yuzu_common/zstd_compression.h"
+#include "yuzu_video_core/texture_cache/image_info.h"
+#include "yuzu_video_core/texture_cache/transcode_cache.h"
+#include "yuzu_video_core/texture_cache/util.h"
+
+namespace VideoCommon {
+namespace {
+using namespace Common::Literals;
+
+constexpr size_t MEMORY_BUDGET = 256_MiB;
+constexpr u64 DISK_BUDGET = 2_GiB;
+constexpr u32 FILE_MAGIC = 0x43545854; // "TXTC"
+constexpr u32 FILE_VERSION = 1;
+constexpr u64 MAX_COPIES = 64;
+
+struct FileHeader {
+    u32 magic;
+    u32 version;
+    u64 decode_nanoseconds;
+    u64 data_size;
+    u64 num_copies;
+};
+
+u128 MakeKey(std::span<const u8> input, const ImageInfo& info) {
+    // Everything besides the guest blocks that changes the converted data
+    const std::array<u32, 9> layout{
+        static_cast<u32>(info.format),
+        static_cast<u32>(info.type),
+        info.size.width,
+        info.size.height,
+        info.size.depth,
+        static_cast<u32>(info.resources.levels),
+        static_cast<u32>(info.resources.layers),
+        static_cast<u32>(Settings::values.astc_recompression.GetValue()),
+        FILE_VERSION,
+    };
+    const u128 seed{
+        Common::CityHash128(reinterpret_cast<const char*>(layout.data()), sizeof(layout))};
+    return Common::CityHash128WithSeed(reinterpret_cast<const char*>(input.data()), input.size(),
+                                       seed);
+}
+
+bool ParseKey(const std::string& name, u128& key) {
+    if (name.size() != 32) {
+        return false;
+    }
+    const char* const begin{name.data()};
+    return std::from_chars(begin, begin + 16, key[1], 16).ec == std::errc{} &&
+           std::from_chars(begin + 16, begin + 32, key[0], 16).ec == std::errc{};
+}
+} // Anonymous namespace
+
+TranscodeCache::TranscodeCache() {
+    if (Settings::values.use_disk_texture_cache.GetValue()) {
+        ScanDisk();
+    }
+}
+
+TranscodeCache::~TranscodeCache() = default;
+
+void TranscodeCache::Convert(std::span<const u8> input, const ImageInfo& info,
+                             std::span<u8> output, std::span<BufferImageCopy> copies) {
+    const u128 key{MakeKey(input, info)};
+    if (const std::shared_ptr<const Entry> entry{Find(key)};
+        entry && entry->data.size() <= output.size() && entry->copies.size() == copies.size()) {
+        std::memcpy(output.data(), entry->data.data(), entry->data.size());
+        std::ranges::copy(entry->copies, copies.begin());
+
+        ++statistics.hits;
+        statistics.bytes_saved += entry->data.size();
+        statistics.nanoseconds_saved += entry->decode_nanoseconds;
+        return;
+    }
+    ++statistics.misses;
+
+    const auto decode_start{std::chrono::steady_clock::now()};
+    const size_t output_size{ConvertImage(input, info, output, copies)};
+    const auto elapsed{std::chrono::steady_clock::now() - decode_start};
+    const u64 decode_nanoseconds{static_cast<u64>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count())};
+    statistics.decode_nanoseconds += decode_nanoseconds;
+
+    auto entry{std::make_shared<Entry>()};
+    entry->data.assign(output.begin(), output.begin() + output_size);
+    entry->copies.assign(copies.begin(), copies.end());
+    entry->decode_nanoseconds = decode_nanoseconds;
+    QueueDiskWrite(key, entry);
+    InsertMemory(key, std::move(entry));
+}
+
+void TranscodeCache::TickFrame() {
+    const u64 hits{statistics.hits.exchange(0)};
+    const u64 misses{statistics.misses.exchange(0)};
+    const u64 disk_hits{statistics.disk_hits.exchange(0)};
+    const u64 bytes_saved{statistics.bytes_saved.exchange(0)};
+    const u64 nanoseconds_saved{statistics.nanoseconds_saved.exchange(0)};
+    const u64 decode_nanoseconds{statistics.decode_nanoseconds.exchange(0)};
+    if (hits == 0 && misses == 0) {
+        return;
+    }
+    LOG_DEBUG(HW_GPU,
+              "Transcode cache: {} hits ({} from disk), {} misses, {}% hit rate, saved {} KiB "
+              "and {} us of decoding, decoded for {} us",
+              hits, disk_hits, misses, hits * 100 / (hits + misses), bytes_saved / 1_KiB,
+              nanoseconds_saved / 1000, decode_nanoseconds / 1000);
+}
+
+std::shared_ptr<const TranscodeCache::Entry> TranscodeCache::Find(const u128& key) {
+    {
+        std::scoped_lock lock{mutex};
+        if (const auto it = memory_entries.find(key); it != memory_entries.end()) {
+            lru.splice(lru.begin(), lru, it->second);
+            return it->second->second;
+        }
+        const auto it = disk_entries.find(key);
+        if (it == disk_entries.end()) {
+            return nullptr;
+        }
+        disk_lru.splice(disk_lru.begin(), disk_lru, it->second.lru_it);
+    }
+    std::shared_ptr<const Entry> entry{LoadEntry(key)};
+    if (!entry) {
+        LOG_WARNING(HW_GPU, "Discarding invalid transcoded texture {:016x}{:016x}", key[1],
+                    key[0]);
+        std::filesystem::path path;
+        {
+            std::scoped_lock lock{mutex};
+            if (!disk_entries.contains(key)) {
+                // Evicted by the writer while it was being read
+                return nullptr;
+            }
+            path = EraseDiskEntry(key);
+        }
+        Common::FS::RemoveFile(path);
+        return nullptr;
+    }
+    // Later sessions order the files by their write time, refresh it so hits are kept longer
+    std::error_code error;
+    std::filesystem::last_write_time(EntryPath(key), std::filesystem::file_time_type::clock::now(),
+                                     error);
+    ++statistics.disk_hits;
+    InsertMemory(key, entry);
+    return entry;
+}
+
+void TranscodeCache::InsertMemory(const u128& key, std::shared_ptr<const Entry> entry) {
+    const size_t size{entry->data.size()};
+    if (size > MEMORY_BUDGET / 8) {
+        // Huge images would flush most of the cache, they are only kept on disk
+        return;
+    }
+    std::scoped_lock lock{mutex};
+    if (memory_entries.contains(key)) {
+        // Decoded concurrently by the GPU thread and the decode worker
+        return;
+    }
+    lru.emplace_front(key, std::move(entry));
+    memory_entries.emplace(key, lru.begin());
+    memory_bytes += size;
+    while (memory_bytes > MEMORY_BUDGET) {
+        const auto& [old_key, old_entry] = lru.back();
+        memory_bytes -= old_entry->data.size();
+        memory_entries.erase(old_key);
+        lru.pop_back();
+    }
+}
+
+void TranscodeCache::QueueDiskWrite(const u128& key, std::shared_ptr<const Entry> entry) {
+    if (!use_disk) {
+        return;
+    }
+    disk_writer.QueueWork([this, key, entry = std::move(entry)] {
+        const std::vector<u8> compressed{
+            Common::Compression::CompressDataZSTDDefault(entry->data.data(), entry->data.size())};
+        const u64 file_size{sizeof(FileHeader) + entry->copies.size() * sizeof(BufferImageCopy) +
+                            compressed.size()};
+        std::vector<std::filesystem::path> evicted;
+        {
+            std::scoped_lock lock{mutex};
+            if (disk_entries.contains(key) || file_size > DISK_BUDGET) {
+                return;
+            }
+            while (disk_bytes + file_size > DISK_BUDGET && !disk_lru.empty()) {
+                evicted.push_back(EraseDiskEntry(disk_lru.back()));
+            }
+        }
+        if (!evicted.empty()) {
+            LOG_DEBUG(HW_GPU, "Evicting {} transcoded textures from disk", evicted.size());
+            for (const std::filesystem::path& old_path : evicted) {
+                Common::FS::RemoveFile(old_path);
+            }
+        }
+        const FileHeader header{
+            .magic = FILE_MAGIC,
+            .version = FILE_VERSION,
+            .decode_nanoseconds = entry->decode_nanoseconds,
+            .data_size = entry->data.size(),
+            .num_copies = entry->copies.size(),
+        };
+        const std::filesystem::path path{EntryPath(key)};
+        {
+            Common::FS::IOFile file{path, Common::FS::FileAccessMode::Write,
+                                    Common::FS::FileType::BinaryFile};
+            if (!file.IsOpen() || !file.WriteObject(header) ||
+                file.WriteSpan(std::span<const BufferImageCopy>{entry->copies}) !=
+                    entry->copies.size() ||
+                file.WriteSpan(std::span<const u8>{compressed}) != compressed.size()) {
+                LOG_ERROR(HW_GPU, "Failed to write transcoded texture {:016x}{:016x}", key[1],
+                          key[0]);
+                file.Close();
+                Common::FS::RemoveFile(path);
+                return;
+            }
+        }
+        std::scoped_lock lock{mutex};
+        disk_lru.push_front(key);
+        disk_entries.emplace(key, DiskEntry{file_size, disk_lru.begin()});
+        disk_bytes += file_size;
+    });
+}
+
+std::filesystem::path TranscodeCache::EraseDiskEntry(u128 key) {
+    const auto it = disk_entries.find(key);
+    disk_bytes -= it->second.file_size;
+    disk_lru.erase(it->second.lru_it);
+    disk_entries.erase(it);
+    return EntryPath(key);
+}
+
+std::filesystem::path TranscodeCache::EntryPath(const u128& key) const {
+    return disk_dir / fmt::format("{:016x}{:016x}.bin", key[1], key[0]);
+}
+
+std::shared_ptr<const TranscodeCache::Entry> TranscodeCache::LoadEntry(const u128& key) const {
+    const Common::FS::IOFile file{EntryPath(key), Common::FS::FileAccessMode::Read,
+                                  Common::FS::FileType::BinaryFile};
+    FileHeader header{};
+    if (!file.IsOpen() || !file.ReadObject(header) || header.magic != FILE_MAGIC ||
+        header.version != FILE_VERSION || header.num_copies > MAX_COPIES) {
+        return nullptr;
+    }
+    const u64 file_size{file.GetSize()};
+    const u64 copies_size{header.num_copies * sizeof(BufferImageCopy)};
+    if (file_size < sizeof(FileHeader) + copies_size) {
+        return nullptr;
+    }
+    auto entry{std::make_shared<Entry>()};
+    entry->decode_nanoseconds = header.decode_nanoseconds;
+    entry->copies.resize(header.num_copies);
+    std::vector<u8> compressed(file_size - sizeof(FileHeader) - copies_size);
+    if (file.ReadSpan(std::span{entry->copies}) != entry->copies.size() ||
+        file.ReadSpan(std::span{compressed}) != compressed.size()) {
+        return nullptr;
+    }
+    entry->data = Common::Compression::DecompressDataZSTD(compressed);
+    if (entry->data.size() != header.data_size) {
+        return nullptr;
+    }
+    return entry;
+}
+
+void TranscodeCache::ScanDisk() {
+    disk_dir = Common::FS::GetYuzuPath(Common::FS::YuzuPath::CacheDir) / "texture_transcode";
+    if (!Common::FS::CreateDirs(disk_dir)) {
+        LOG_ERROR(Common_Filesystem, "Failed to create the texture transcode cache directory");
+        return;
+    }
+    struct ScannedFile {
+        std::filesystem::file_time_type write_time;
+        u128 key;
+        u64 file_size;
+    };
+    std::vector<ScannedFile> files;
+    Common::FS::IterateDirEntries(
+        disk_dir,
+        [&files](const std::filesystem::directory_entry& dir_entry) {
+            u128 key{};
+            if (!ParseKey(dir_entry.path().stem().string(), key)) {
+                return true;
+            }
+            std::error_code size_error;
+            std::error_code time_error;
+            const u64 file_size{dir_entry.file_size(size_error)};
+            const auto write_time{dir_entry.last_write_time(time_error)};
+            if (!size_error && !time_error) {
+                files.push_back({write_time, key, file_size});
+            }
+            return true;
+        },
+        Common::FS::DirEntryFilter::File);
+
+    // Oldest files first, so the most recently written ones end up in front of the LRU list
+    std::ranges::sort(files, {}, &ScannedFile::write_time);
+    for (const ScannedFile& file : files) {
+        disk_lru.push_front(file.key);
+        disk_entries.emplace(file.key, DiskEntry{file.file_size, disk_lru.begin()});
+        disk_bytes += file.file_size;
+    }
+    use_disk = true;
+    LOG_INFO(HW_GPU, "Found {} transcoded textures ({} MiB) on disk", disk_entries.size(),
+             disk_bytes / 1_MiB);
+}
+
+} // namespace VideoCommon
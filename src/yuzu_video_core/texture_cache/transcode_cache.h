@@ -0,0 +1,110 @@
+// SPDX-FileCopyrightText: Copyright 2024 yuzu Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <atomic>
+#include <filesystem>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+#include "yuzu_common/common_types.h"
+#include "yuzu_common/thread_worker.h"
+#include "yuzu_video_core/texture_cache/types.h"
+
+namespace VideoCommon {
+
+struct ImageInfo;
+
+/// Content addressed cache of images converted on the CPU (ASTC and BCn decodes).
+///
+/// Entries are keyed by a hash of the unswizzled guest blocks, the image layout and the output
+/// format, so images uploaded again after being evicted skip the decode. Recently used entries
+/// are kept in memory and every entry is written to disk to be reused in later sessions, the
+/// least recently used files are removed when the disk tier is full.
+class TranscodeCache {
+public:
+    explicit TranscodeCache();
+    ~TranscodeCache();
+
+    TranscodeCache(const TranscodeCache&) = delete;
+    TranscodeCache& operator=(const TranscodeCache&) = delete;
+
+    /// Converts an image like ConvertImage, copying it from the cache when the blocks are known.
+    /// Thread safe, images are decoded from the GPU thread and the texture decode worker.
+    void Convert(std::span<const u8> input, const ImageInfo& info, std::span<u8> output,
+                 std::span<BufferImageCopy> copies);
+
+    /// Reports and resets the statistics of the last frame.
+    void TickFrame();
+
+private:
+    struct Entry {
+        std::vector<u8> data;
+        std::vector<BufferImageCopy> copies;
+        u64 decode_nanoseconds;
+    };
+
+    struct KeyHash {
+        size_t operator()(const u128& key) const noexcept {
+            return static_cast<size_t>(key[0]);
+        }
+    };
+
+    /// Statistics since the last frame.
+    struct Statistics {
+        std::atomic<u64> hits{};
+        std::atomic<u64> disk_hits{};
+        std::atomic<u64> misses{};
+        std::atomic<u64> bytes_saved{};
+        std::atomic<u64> nanoseconds_saved{};
+        std::atomic<u64> decode_nanoseconds{};
+    };
+
+    using EntryList = std::list<std::pair<u128, std::shared_ptr<const Entry>>>;
+    using DiskList = std::list<u128>;
+
+    struct DiskEntry {
+        u64 file_size;
+        DiskList::iterator lru_it;
+    };
+
+    /// Returns the entry of a key from memory or disk, nullptr when it isn't cached.
+    std::shared_ptr<const Entry> Find(const u128& key);
+
+    /// Adds an entry to the memory tier, evicting the least recently used entries.
+    void InsertMemory(const u128& key, std::shared_ptr<const Entry> entry);
+
+    /// Queues an entry to be written to the disk tier, evicting the least recently used files.
+    void QueueDiskWrite(const u128& key, std::shared_ptr<const Entry> entry);
+
+    /// Forgets a disk entry, the mutex must be held. Returns the path of its file.
+    std::filesystem::path EraseDiskEntry(u128 key);
+
+    [[nodiscard]] std::filesystem::path EntryPath(const u128& key) const;
+
+    [[nodiscard]] std::shared_ptr<const Entry> LoadEntry(const u128& key) const;
+
+    void ScanDisk();
+
+    std::mutex mutex;
+    EntryList lru;
+    std::unordered_map<u128, EntryList::iterator, KeyHash> memory_entries;
+    size_t memory_bytes = 0;
+
+    std::filesystem::path disk_dir;
+    DiskList disk_lru;
+    std::unordered_map<u128, DiskEntry, KeyHash> disk_entries;
+    u64 disk_bytes = 0;
+    bool use_disk = false;
+
+    Statistics statistics;
+
+    Common::ThreadWorker disk_writer{1, "TranscodeCacheWriter"};
+};
+
+} // namespace VideoCommon
@@ -11,6 +11,7 @@
 #include "yuzu_video_core/renderer_base.h"
 #include "yuzu_video_core/renderer_null/renderer_null.h"
 #include "yuzu_video_core/renderer_opengl/renderer_opengl.h"
+#include "yuzu_video_core/renderer_software/renderer_software.h"
 #include "yuzu_video_core/renderer_vulkan/renderer_vulkan.h"
 #include "yuzu_video_core/video_core.h"
 
@@ -28,6 +29,8 @@ std::unique_ptr<VideoCore::RendererBase> CreateRenderer(
         return std::make_unique<Vulkan::RendererVulkan>(emu_window, device_memory, gpu, std::move(context));
     case Settings::RendererBackend::Null:
         return std::make_unique<Null::RendererNull>(emu_window, gpu, std::move(context));
+    case Settings::RendererBackend::Software:
+        return std::make_unique<Software::RendererSoftware>(emu_window, device_memory, gpu, std::move(context));
     default:
         return nullptr;
     }